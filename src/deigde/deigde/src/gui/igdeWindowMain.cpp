@@ -112,6 +112,7 @@
 #include <dragengine/filesystem/dePathList.h>
 #include <dragengine/filesystem/deCollectDirectorySearchVisitor.h>
 #include <dragengine/filesystem/deCollectFileSearchVisitor.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerConsoleColor.h>
 #include <dragengine/logger/deLoggerFile.h>
 #include <dragengine/logger/deLoggerChain.h>
@@ -1639,7 +1640,12 @@ void igdeWindowMain::pInitLogger(){
 		
 		deLoggerReference loggerFile;
 		loggerFile.TakeOver( new deLoggerFile( fileWriter ) );
-		loggerChain.AddLogger( loggerFile );
+		
+		// write the log file using a background thread so logging threads do not
+		// wait for disk I/O
+		deLoggerReference loggerAsync;
+		loggerAsync.TakeOver( new deLoggerAsync( loggerFile ) );
+		loggerChain.AddLogger( loggerAsync );
 	}
 	
 	// set the logger
@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "projTaskDistribute.h"
+#include "projTaskDistributeFile.h"
 #include "../project.h"
 #include "../gui/projWindowMain.h"
 #include "../project/projProject.h"
@@ -45,6 +46,7 @@
 #include <dragengine/common/utils/decDateTime.h>
 #include <dragengine/common/xmlparser/decXmlWriter.h>
 #include <dragengine/deEngine.h>
+#include <dragengine/parallel/deParallelProcessing.h>
 #include <dragengine/systems/deModuleSystem.h>
 #include <dragengine/systems/modules/deLoadableModule.h>
 #include <dragengine/filesystem/deVFSDiskDirectory.h>
@@ -55,12 +57,27 @@
 #include <dragengine/resources/image/deImage.h>
 #include <dragengine/resources/image/deImageManager.h>
 #include <dragengine/resources/image/deImageReference.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
 
 
 
-// Callbacks
-//////////////
+// Definitions
+////////////////
+
+// files larger than this size in bytes are streamed on the main thread
+#define DISTRIBUTE_STREAM_FILE_SIZE 16777216
+
+// maximum size in bytes of files queued for processing by parallel tasks
+#define DISTRIBUTE_MAX_QUEUED_SIZE 67108864
+
+// maximum number of files queued for processing by parallel tasks
+#define DISTRIBUTE_MAX_QUEUED_FILES 64
 
+// file extensions of already compressed formats. deflating them wastes time for nothing
+static const char * const vIncompressibleExtensions[] = {
+	".png", ".jpg", ".jpeg", ".webp", ".ogg", ".oga", ".ogv", ".webm",
+	".mp3", ".mp4", ".zip", ".delga", ".gz", ".bz2", ".xz", ".7z" };
+static const int vIncompressibleExtensionCount = sizeof( vIncompressibleExtensions ) / sizeof( const char* );
 
 
 
@@ -139,6 +156,10 @@ pDelgaPosition( 0 ),
 pDelgaDirectoryCount( 0 ),
 pDelgaFileCount( 0 ),
 
+pPreviousZipFile( NULL ),
+
+pQueuedSize( 0 ),
+
 pReadBuffer( NULL ),
 pReadBufferSize( 1024 * 8 ) // 8k
 {
@@ -146,7 +167,9 @@ pReadBufferSize( 1024 * 8 ) // 8k
 }
 
 projTaskDistribute::~projTaskDistribute(){
+	pCancelQueuedFiles();
 	pCloseDelgaWriter();
+	pRestorePreviousDelga();
 	if( pReadBuffer ){
 		delete [] pReadBuffer;
 	}
@@ -176,10 +199,13 @@ bool projTaskDistribute::Step(){
 		}
 		
 		// all files processed
+		pWriteAllFiles();
+		
 		pUsedFileExtensions += pProfile.GetRequiredExtensions();
 		
 		pWriteGameXml();
 		pCloseDelgaWriter();
+		pClosePreviousDelga();
 		pState = esFinished;
 		SetMessage( "Finished" );
 		
@@ -297,6 +323,9 @@ void projTaskDistribute::pCreateDelgaWriter(){
 	
 	path.RemoveLastComponent(); // parent directory
 	
+	// move previous delga file out of the way to reuse entries
+	pOpenPreviousDelga();
+	
 	deVFSContainerReference parentDir;
 	parentDir.TakeOver( new deVFSDiskDirectory( path ) );
 	
@@ -327,6 +356,78 @@ void projTaskDistribute::pCloseDelgaWriter(){
 	pDelgaWriter = NULL;
 }
 
+void projTaskDistribute::pOpenPreviousDelga(){
+	pPreviousDelgaPath = pDelgaPath + ".previous";
+	remove( pPreviousDelgaPath );
+	
+	if( rename( pDelgaPath, pPreviousDelgaPath ) != 0 ){
+		pPreviousDelgaPath.Empty(); // no previous delga file
+		return;
+	}
+	
+	pPreviousZipFile = unzOpen( pPreviousDelgaPath );
+	if( ! pPreviousZipFile ){
+		return; // not a valid delga file. rebuild all entries
+	}
+	
+	// collect entries with the information required to reuse them
+	deObjectReference entry;
+	unz_file_info info;
+	char filename[ 1024 ];
+	int result = unzGoToFirstFile( pPreviousZipFile );
+	
+	while( result == UNZ_OK ){
+		if( unzGetCurrentFileInfo( pPreviousZipFile, &info, filename,
+		sizeof( filename ), NULL, 0, NULL, 0 ) != UNZ_OK ){
+			break;
+		}
+		
+		// only plain stored or deflated entries with names fitting into the buffer
+		if( info.size_filename < sizeof( filename ) && ( info.flag & 1 ) == 0
+		&& ( info.compression_method == 0 || info.compression_method == Z_DEFLATED ) ){
+			entry.TakeOver( new cPreviousEntry );
+			cPreviousEntry &previousEntry = *( ( cPreviousEntry* )( deObject* )entry );
+			
+			if( unzGetFilePos( pPreviousZipFile, &previousEntry.position ) == UNZ_OK ){
+				previousEntry.crc = info.crc;
+				previousEntry.size = info.uncompressed_size;
+				pPreviousEntries.SetAt( filename, entry );
+			}
+		}
+		
+		result = unzGoToNextFile( pPreviousZipFile );
+	}
+}
+
+void projTaskDistribute::pClosePreviousDelga(){
+	if( pPreviousZipFile ){
+		unzClose( pPreviousZipFile );
+		pPreviousZipFile = NULL;
+	}
+	pPreviousEntries.RemoveAll();
+	
+	if( ! pPreviousDelgaPath.IsEmpty() ){
+		remove( pPreviousDelgaPath );
+		pPreviousDelgaPath.Empty();
+	}
+}
+
+void projTaskDistribute::pRestorePreviousDelga(){
+	// distributing failed or has been cancelled. replace the incomplete delga file with
+	// the previous one if present
+	if( pPreviousZipFile ){
+		unzClose( pPreviousZipFile );
+		pPreviousZipFile = NULL;
+	}
+	pPreviousEntries.RemoveAll();
+	
+	if( ! pPreviousDelgaPath.IsEmpty() ){
+		remove( pDelgaPath );
+		rename( pPreviousDelgaPath, pDelgaPath );
+		pPreviousDelgaPath.Empty();
+	}
+}
+
 void projTaskDistribute::pScanDirectory( const decPath &path ){
 	cProcessDirectory *directory = NULL;
 	bool ignore = false;
@@ -421,6 +522,8 @@ void projTaskDistribute::pProcessFiles(){
 		}
 		
 	}
+	
+	pWriteFinishedFiles();
 }
 
 void projTaskDistribute::pProcessFile( const decPath &path ){
@@ -446,13 +549,141 @@ void projTaskDistribute::pProcessFile( const decPath &path ){
 	// count file
 	pDelgaFileCount++;
 	
-	// for the time being simply copy the file
 	pAddUsedFileExtension( path );
-	pZipBeginFile( path );
+	
+	const bool compress = pIsCompressible( path );
+	
+	if( pVFS->GetFileSize( path ) <= DISTRIBUTE_STREAM_FILE_SIZE ){
+		pQueueFile( path, compress );
+		return;
+	}
+	
+	// large file. stream it after all queued files to keep the order
+	pWriteAllFiles();
+	pZipBeginFile( path, compress );
 	pCopyFile( path );
 	pZipCloseFile();
 }
 
+bool projTaskDistribute::pIsCompressible( const decPath &path ) const{
+	const decString &title = path.GetLastComponent();
+	const int delimiter = title.FindReverse( '.' );
+	if( delimiter == -1 ){
+		return true;
+	}
+	
+	const decString extension( title.GetMiddle( delimiter ).GetLower() );
+	int i;
+	for( i=0; i<vIncompressibleExtensionCount; i++ ){
+		if( extension == vIncompressibleExtensions[ i ] ){
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+void projTaskDistribute::pQueueFile( const decPath &path, bool compress ){
+	// write finished files until there is room in the queue
+	while( pQueuedFiles.GetCount() >= DISTRIBUTE_MAX_QUEUED_FILES
+	|| pQueuedSize >= DISTRIBUTE_MAX_QUEUED_SIZE ){
+		pWriteNextFile( true );
+	}
+	
+	// read file content. the VFS is not accessed by the parallel tasks
+	decMemoryFileReference content;
+	content.TakeOver( new decMemoryFile( path.GetPathUnix() ) );
+	content->SetModificationTime( pVFS->GetFileModificationTime( path ) );
+	
+	{
+	decBaseFileReaderReference reader;
+	reader.TakeOver( pVFS->OpenFileForReading( path ) );
+	
+	const int size = reader->GetLength();
+	content->Resize( size );
+	if( size > 0 ){
+		reader->Read( content->GetPointer(), size );
+	}
+	}
+	
+	deThreadSafeObjectReference task;
+	task.TakeOver( new projTaskDistributeFile( content, compress ) );
+	projTaskDistributeFile &fileTask = *( ( projTaskDistributeFile* )( deThreadSafeObject* )task );
+	
+	deObject *object;
+	if( pPreviousEntries.GetAt( path.GetPathUnix().GetMiddle( 1 ), &object ) ){
+		const cPreviousEntry &previousEntry = *( ( cPreviousEntry* )object );
+		if( previousEntry.size == ( unsigned long )content->GetLength() ){
+			fileTask.SetPrevious( previousEntry.crc );
+		}
+	}
+	
+	pQueuedFiles.Add( task );
+	pQueuedSize += content->GetLength();
+	
+	deParallelProcessing &parallelProcessing = pWindowMain.GetEnvironment().
+		GetEngineController()->GetEngine()->GetParallelProcessing();
+	
+	if( parallelProcessing.GetCoreCount() > 1 && ! parallelProcessing.GetPaused() ){
+		fileTask.SetQueued( true );
+		parallelProcessing.AddTask( &fileTask );
+		
+	}else{
+		fileTask.Process();
+	}
+}
+
+bool projTaskDistribute::pWriteNextFile( bool wait ){
+	if( pQueuedFiles.GetCount() == 0 ){
+		return false;
+	}
+	
+	projTaskDistributeFile &task = *( ( projTaskDistributeFile* )pQueuedFiles.GetAt( 0 ) );
+	
+	if( task.GetQueued() ){
+		if( ! task.GetFinished() && ! wait ){
+			return false;
+		}
+		
+		pWindowMain.GetEnvironment().GetEngineController()->GetEngine()
+			->GetParallelProcessing().WaitForTask( &task );
+		task.SetQueued( false );
+		
+		if( task.GetFailed() ){
+			task.Process(); // process again to report the problem
+		}
+	}
+	
+	pZipWriteTaskFile( task );
+	
+	pQueuedSize -= task.GetContent()->GetLength();
+	pQueuedFiles.RemoveFrom( 0 );
+	return true;
+}
+
+void projTaskDistribute::pWriteFinishedFiles(){
+	while( pWriteNextFile( false ) );
+}
+
+void projTaskDistribute::pWriteAllFiles(){
+	while( pWriteNextFile( true ) );
+}
+
+void projTaskDistribute::pCancelQueuedFiles(){
+	const int count = pQueuedFiles.GetCount();
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		projTaskDistributeFile &task = *( ( projTaskDistributeFile* )pQueuedFiles.GetAt( i ) );
+		if( task.GetQueued() ){
+			task.Cancel();
+		}
+	}
+	
+	pQueuedFiles.RemoveAll();
+	pQueuedSize = 0;
+}
+
 void projTaskDistribute::pCopyFile( const decPath &path ){
 	decBaseFileReaderReference reader;
 	reader.TakeOver( pVFS->OpenFileForReading( path ) );
@@ -470,10 +701,9 @@ void projTaskDistribute::pCopyFile( const decPath &path ){
 	}
 }
 
-void projTaskDistribute::pZipBeginFile( const decPath &path ){
-	const decDateTime modtime( pVFS->GetFileModificationTime( path ) );
+void projTaskDistribute::pInitZipFileInfo( zip_fileinfo &info, TIME_SYSTEM modificationTime ) const{
+	const decDateTime modtime( modificationTime );
 	
-	zip_fileinfo info;
 	memset( &info, 0, sizeof( info ) );
 	
 	info.tmz_date.tm_year = modtime.GetYear();
@@ -485,10 +715,15 @@ void projTaskDistribute::pZipBeginFile( const decPath &path ){
 	info.dosDate = 0; // use tmz_date
 	info.internal_fa = 0; // no idea what this is
 	info.external_fa = 0; // no idea what this is
+}
+
+void projTaskDistribute::pZipBeginFile( const decPath &path, bool compress ){
+	zip_fileinfo info;
+	pInitZipFileInfo( info, pVFS->GetFileModificationTime( path ) );
 	
 	// NOTE: path contains '/' as prefix. delga files require path without prefix
 	if( zipOpenNewFileInZip( pZipFile, path.GetPathUnix().GetMiddle( 1 ), &info,
-	NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_DEFAULT_COMPRESSION ) != ZIP_OK ){
+	NULL, 0, NULL, 0, NULL, compress ? Z_DEFLATED : 0, Z_DEFAULT_COMPRESSION ) != ZIP_OK ){
 		DETHROW( deeInvalidParam );
 	}
 }
@@ -514,20 +749,8 @@ void projTaskDistribute::pZipCloseFile(){
 }
 
 void projTaskDistribute::pZipWriteMemoryFile( const decMemoryFile &memoryFile ){
-	const decDateTime modtime( memoryFile.GetModificationTime() );
-	
 	zip_fileinfo info;
-	memset( &info, 0, sizeof( info ) );
-	
-	info.tmz_date.tm_year = modtime.GetYear();
-	info.tmz_date.tm_mon = modtime.GetMonth();
-	info.tmz_date.tm_mday = modtime.GetDay() + 1; // zip uses 1 as first day of month
-	info.tmz_date.tm_hour = modtime.GetHour();
-	info.tmz_date.tm_min = modtime.GetMinute();
-	info.tmz_date.tm_sec = modtime.GetSecond();
-	info.dosDate = 0; // use tmz_date
-	info.internal_fa = 0; // no idea what this is
-	info.external_fa = 0; // no idea what this is
+	pInitZipFileInfo( info, memoryFile.GetModificationTime() );
 	
 	// NOTE: path contains '/' as prefix. delga files require path without prefix
 	if( zipOpenNewFileInZip( pZipFile, memoryFile.GetFilename().GetMiddle( 1 ), &info,
@@ -547,6 +770,78 @@ void projTaskDistribute::pZipWriteMemoryFile( const decMemoryFile &memoryFile ){
 	}
 }
 
+void projTaskDistribute::pZipWriteTaskFile( const projTaskDistributeFile &task ){
+	if( task.GetReusePrevious() ){
+		pZipCopyPreviousFile( task );
+		return;
+	}
+	
+	const decMemoryFile &content = *task.GetContent();
+	const decMemoryFile &data = task.GetCompressed() ? *task.GetCompressed() : content;
+	
+	zip_fileinfo info;
+	pInitZipFileInfo( info, content.GetModificationTime() );
+	
+	// data is already deflated if required. write it raw
+	if( zipOpenNewFileInZip2( pZipFile, content.GetFilename().GetMiddle( 1 ), &info,
+	NULL, 0, NULL, 0, NULL, task.GetMethod(), Z_DEFAULT_COMPRESSION, 1 ) != ZIP_OK ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pZipWriteFile( data.GetPointer(), data.GetLength() );
+	
+	if( zipCloseFileInZipRaw( pZipFile, content.GetLength(), task.GetCrc() ) != ZIP_OK ){
+		DETHROW( deeInvalidParam );
+	}
+}
+
+void projTaskDistribute::pZipCopyPreviousFile( const projTaskDistributeFile &task ){
+	const decMemoryFile &content = *task.GetContent();
+	const decString filename( content.GetFilename().GetMiddle( 1 ) );
+	const cPreviousEntry &previousEntry = *( ( cPreviousEntry* )pPreviousEntries.GetAt( filename ) );
+	
+	unz_file_pos position = previousEntry.position;
+	if( unzGoToFilePos( pPreviousZipFile, &position ) != UNZ_OK ){
+		DETHROW_INFO( deeReadFile, pPreviousDelgaPath );
+	}
+	
+	int method, level;
+	if( unzOpenCurrentFile2( pPreviousZipFile, &method, &level, 1 ) != UNZ_OK ){
+		DETHROW_INFO( deeReadFile, pPreviousDelgaPath );
+	}
+	
+	try{
+		zip_fileinfo info;
+		pInitZipFileInfo( info, content.GetModificationTime() );
+		
+		if( zipOpenNewFileInZip2( pZipFile, filename, &info, NULL, 0, NULL, 0,
+		NULL, method, level, 1 ) != ZIP_OK ){
+			DETHROW( deeInvalidParam );
+		}
+		
+		while( true ){
+			const int readBytes = unzReadCurrentFile( pPreviousZipFile, pReadBuffer, pReadBufferSize );
+			if( readBytes < 0 ){
+				DETHROW_INFO( deeReadFile, pPreviousDelgaPath );
+			}
+			if( readBytes == 0 ){
+				break;
+			}
+			pZipWriteFile( pReadBuffer, readBytes );
+		}
+		
+		if( zipCloseFileInZipRaw( pZipFile, previousEntry.size, previousEntry.crc ) != ZIP_OK ){
+			DETHROW( deeInvalidParam );
+		}
+		
+		unzCloseCurrentFile( pPreviousZipFile );
+		
+	}catch( const deException & ){
+		unzCloseCurrentFile( pPreviousZipFile );
+		throw;
+	}
+}
+
 void projTaskDistribute::pCloseDirectory(){
 	if( pStackDirectories.GetCount() == 0 ){
 		DETHROW( deeInvalidAction );
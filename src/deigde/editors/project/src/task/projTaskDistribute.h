@@ -23,20 +23,25 @@
 #define _PROJTASKDISTRIBUTE_H_
 
 #include "zip.h"
+#include "unzip.h"
 
 #include <deigde/gui/igdeStepableTask.h>
 
 #include <dragengine/deObject.h>
+#include <dragengine/common/collection/decObjectDictionary.h>
 #include <dragengine/common/collection/decObjectList.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
 #include <dragengine/common/file/decPath.h>
 #include <dragengine/common/file/decBaseFileWriterReference.h>
 #include <dragengine/common/string/decStringSet.h>
+#include <dragengine/common/utils/decDateTime.h>
 #include <dragengine/filesystem/dePathList.h>
 #include <dragengine/filesystem/deVirtualFileSystemReference.h>
 
 class projWindowMain;
 class projProject;
 class projProfile;
+class projTaskDistributeFile;
 
 class decMemoryFile;
 class decXmlWriter;
@@ -44,6 +49,11 @@ class decXmlWriter;
 
 /**
  * \brief Distribute game task.
+ * 
+ * Files are read on the main thread and deflated by parallel tasks. Finished files are
+ * written into the delga file in the order they have been read. Files with extensions
+ * known to be incompressible are stored. Entries of the previous delga file with the
+ * same filename, size and CRC are copied without deflating them again.
  */
 class projTaskDistribute : public igdeStepableTask{
 private:
@@ -57,6 +67,13 @@ private:
 		bool hasCountedDir;
 	};
 	
+	class cPreviousEntry : public deObject{
+	public:
+		unz_file_pos position;
+		unsigned long crc;
+		unsigned long size;
+	};
+	
 	enum eStates{
 		esInitial,
 		esProcessFiles,
@@ -85,6 +102,13 @@ private:
 	int pDelgaDirectoryCount;
 	int pDelgaFileCount;
 	
+	decString pPreviousDelgaPath;
+	unzFile pPreviousZipFile;
+	decObjectDictionary pPreviousEntries;
+	
+	decThreadSafeObjectOrderedSet pQueuedFiles;
+	long pQueuedSize;
+	
 	char *pReadBuffer;
 	const int pReadBufferSize;
 	
@@ -158,14 +182,26 @@ private:
 	void pBuildExcludeBaseGameDefPath();
 	void pCreateDelgaWriter();
 	void pCloseDelgaWriter();
+	void pOpenPreviousDelga();
+	void pClosePreviousDelga();
+	void pRestorePreviousDelga();
 	void pScanDirectory( const decPath &path );
 	void pProcessFiles();
 	void pProcessFile( const decPath &path );
+	bool pIsCompressible( const decPath &path ) const;
+	void pQueueFile( const decPath &path, bool compress );
+	bool pWriteNextFile( bool wait );
+	void pWriteFinishedFiles();
+	void pWriteAllFiles();
+	void pCancelQueuedFiles();
 	void pCopyFile( const decPath &path );
-	void pZipBeginFile( const decPath &path );
+	void pInitZipFileInfo( zip_fileinfo &info, TIME_SYSTEM modificationTime ) const;
+	void pZipBeginFile( const decPath &path, bool compress );
 	void pZipWriteFile( const void *buffer, long size );
 	void pZipCloseFile();
 	void pZipWriteMemoryFile( const decMemoryFile &memoryFile );
+	void pZipWriteTaskFile( const projTaskDistributeFile &task );
+	void pZipCopyPreviousFile( const projTaskDistributeFile &task );
 	void pCloseDirectory();
 	void pAddUsedFileExtension( const decPath &path );
 	void pWriteGameXml();
@@ -0,0 +1,178 @@
+/* 
+ * Drag[en]gine IGDE Project Editor
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include "projTaskDistributeFile.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decMemoryFile.h>
+
+
+
+// Class projTaskDistributeFile
+/////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+projTaskDistributeFile::projTaskDistributeFile( decMemoryFile *content, bool compress ) :
+deParallelTask( NULL ),
+pContent( content ),
+pCompress( compress ),
+pHasPrevious( false ),
+pPreviousCrc( 0 ),
+pQueued( false ),
+pCrc( 0 ),
+pMethod( 0 ),
+pReusePrevious( false ),
+pFailed( false )
+{
+	if( ! content ){
+		DETHROW( deeInvalidParam );
+	}
+}
+
+projTaskDistributeFile::~projTaskDistributeFile(){
+}
+
+
+
+// Management
+///////////////
+
+void projTaskDistributeFile::SetPrevious( unsigned long crc ){
+	pHasPrevious = true;
+	pPreviousCrc = crc;
+}
+
+void projTaskDistributeFile::SetQueued( bool queued ){
+	pQueued = queued;
+}
+
+void projTaskDistributeFile::Process(){
+	const int length = pContent->GetLength();
+	
+	pCrc = crc32( 0L, Z_NULL, 0 );
+	if( length > 0 ){
+		pCrc = crc32( pCrc, ( const Bytef* )pContent->GetPointer(), ( uInt )length );
+	}
+	
+	pReusePrevious = pHasPrevious && pCrc == pPreviousCrc;
+	pMethod = 0;
+	pCompressed = NULL;
+	
+	if( pReusePrevious || ! pCompress || length == 0 ){
+		return;
+	}
+	
+	pDeflate();
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void projTaskDistributeFile::Run(){
+	if( IsCancelled() ){
+		return;
+	}
+	
+	try{
+		Process();
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void projTaskDistributeFile::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString projTaskDistributeFile::GetDebugName() const{
+	return "ProjectDistributeFile";
+}
+
+decString projTaskDistributeFile::GetDebugDetails() const{
+	decString details;
+	details.Format( "%s (%d bytes)", pContent->GetFilename().GetString(), pContent->GetLength() );
+	return details;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void projTaskDistributeFile::pDeflate(){
+	// zip files store raw deflate streams without zlib header
+	z_stream stream;
+	memset( &stream, 0, sizeof( stream ) );
+	
+	if( deflateInit2( &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+	8, Z_DEFAULT_STRATEGY ) != Z_OK ){
+		DETHROW( deeOutOfMemory );
+	}
+	
+	const int length = pContent->GetLength();
+	decMemoryFileReference compressed;
+	int compressedLength = 0;
+	
+	try{
+		compressed.TakeOver( new decMemoryFile( pContent->GetFilename() ) );
+		compressed->Resize( ( int )deflateBound( &stream, ( uLong )length ) );
+		
+		stream.next_in = ( Bytef* )pContent->GetPointer();
+		stream.avail_in = ( uInt )length;
+		stream.next_out = ( Bytef* )compressed->GetPointer();
+		stream.avail_out = ( uInt )compressed->GetLength();
+		
+		if( deflate( &stream, Z_FINISH ) != Z_STREAM_END ){
+			DETHROW( deeInvalidAction );
+		}
+		
+		compressedLength = ( int )stream.total_out;
+		deflateEnd( &stream );
+		
+	}catch( const deException & ){
+		deflateEnd( &stream );
+		throw;
+	}
+	
+	// store content if deflating does not reduce the size
+	if( compressedLength >= length ){
+		return;
+	}
+	
+	compressed->Resize( compressedLength );
+	pCompressed = compressed;
+	pMethod = Z_DEFLATED;
+}
@@ -0,0 +1,147 @@
+/* 
+ * Drag[en]gine IGDE Project Editor
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _PROJTASKDISTRIBUTEFILE_H_
+#define _PROJTASKDISTRIBUTEFILE_H_
+
+#include <dragengine/common/file/decMemoryFileReference.h>
+#include <dragengine/parallel/deParallelTask.h>
+
+class decMemoryFile;
+
+
+
+/**
+ * \brief Parallel task preparing a file for writing into the delga file.
+ * 
+ * Calculates the CRC of the file content and deflates it. If the file extension is known
+ * to be incompressible or deflating does not reduce the size the content is stored. If
+ * the previous delga file contains an entry with the same size and CRC it is reused
+ * without deflating the content again.
+ * 
+ * Tasks are written into the delga file in the order they have been created once finished.
+ */
+class projTaskDistributeFile : public deParallelTask{
+private:
+	decMemoryFileReference pContent;
+	bool pCompress;
+	bool pHasPrevious;
+	unsigned long pPreviousCrc;
+	bool pQueued;
+	
+	unsigned long pCrc;
+	int pMethod;
+	decMemoryFileReference pCompressed;
+	bool pReusePrevious;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create task.
+	 * \param[in] content Memory file with filename and modification time of the file.
+	 * \param[in] compress Deflate file content.
+	 */
+	projTaskDistributeFile( decMemoryFile *content, bool compress );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~projTaskDistributeFile();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief File content. */
+	inline decMemoryFile *GetContent() const{ return pContent; }
+	
+	/** \brief Deflate file content. */
+	inline bool GetCompress() const{ return pCompress; }
+	
+	/** \brief Set CRC of entry with the same filename and size in the previous delga file. */
+	void SetPrevious( unsigned long crc );
+	
+	/** \brief Task has been added to parallel processing. */
+	inline bool GetQueued() const{ return pQueued; }
+	
+	/** \brief Set if task has been added to parallel processing. */
+	void SetQueued( bool queued );
+	
+	
+	
+	/** \brief CRC of file content. */
+	inline unsigned long GetCrc() const{ return pCrc; }
+	
+	/** \brief Zip compression method. 0 if stored or Z_DEFLATED if deflated. */
+	inline int GetMethod() const{ return pMethod; }
+	
+	/** \brief Deflated content or NULL if stored. */
+	inline decMemoryFile *GetCompressed() const{ return pCompressed; }
+	
+	/** \brief Reuse entry from previous delga file. */
+	inline bool GetReusePrevious() const{ return pReusePrevious; }
+	
+	/** \brief Processing failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	
+	/**
+	 * \brief Process file.
+	 * 
+	 * Called by Run(). Call directly if the task has not been queued or failed. In contrary
+	 * to Run() exceptions are not caught.
+	 */
+	void Process();
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+	
+	
+	
+private:
+	void pDeflate();
+};
+
+#endif
@@ -60,6 +60,7 @@
 #include <dragengine/filesystem/deVFSContainerReference.h>
 #include <dragengine/filesystem/deVFSDiskDirectory.h>
 #include <dragengine/filesystem/deVirtualFileSystem.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerFile.h>
 #include <dragengine/logger/deLoggerConsoleColor.h>
 
@@ -410,7 +411,11 @@ void projTestRunProcess::pCreateLogger(){
 	container.TakeOver( new deVFSDiskDirectory( diskPath ) );
 	writer.TakeOver( container->OpenFileForWriting( filePath ) );
 	
-	pLogger.TakeOver( new deLoggerFile( writer ) );
+	deLoggerReference loggerFile;
+	loggerFile.TakeOver( new deLoggerFile( writer ) );
+	
+	// write the log file using a background thread so logging threads do not wait for disk I/O
+	pLogger.TakeOver( new deLoggerAsync( loggerFile ) );
 }
 
 void projTestRunProcess::pRunGame(){
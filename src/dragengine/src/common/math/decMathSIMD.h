@@ -0,0 +1,49 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DECMATHSIMD_H_
+#define _DECMATHSIMD_H_
+
+/**
+ * \file decMathSIMD.h
+ * \brief SIMD selection for math classes.
+ * 
+ * Defines DE_MATH_SSE if SSE intrinsics are available or DE_MATH_NEON if NEON intrinsics
+ * are available. If none is defined the scalar implementations are used. Define
+ * DE_MATH_NO_SIMD while compiling the engine to force the scalar implementations.
+ * 
+ * The SIMD implementations use the same order of operations as the scalar ones. Results
+ * are identical on SSE and within floating point tolerance on NEON.
+ * 
+ * For use inside math source files only.
+ */
+
+#ifndef DE_MATH_NO_SIMD
+#	if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#		include <xmmintrin.h>
+#		define DE_MATH_SSE 1
+#	elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#		include <arm_neon.h>
+#		define DE_MATH_NEON 1
+#	endif
+#endif
+
+#endif
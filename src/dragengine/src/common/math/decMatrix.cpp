@@ -24,10 +24,57 @@
 #include <string.h>
 
 #include "decMath.h"
+#include "decMathSIMD.h"
 #include "../exceptions.h"
 
 
 
+// SIMD helpers
+/////////////////
+
+// rows combined with the same order of operations as the scalar implementation:
+// ( ( row1 * f[0] + row2 * f[1] ) + row3 * f[2] ) + row4 * f[3]
+#ifdef DE_MATH_SSE
+static inline __m128 decMatrixCombine( const __m128 &row1, const __m128 &row2,
+const __m128 &row3, const __m128 &row4, const float *f ){
+	return _mm_add_ps( _mm_add_ps( _mm_add_ps(
+		_mm_mul_ps( row1, _mm_set1_ps( f[ 0 ] ) ),
+		_mm_mul_ps( row2, _mm_set1_ps( f[ 1 ] ) ) ),
+		_mm_mul_ps( row3, _mm_set1_ps( f[ 2 ] ) ) ),
+		_mm_mul_ps( row4, _mm_set1_ps( f[ 3 ] ) ) );
+}
+
+static inline __m128 decMatrixQuickCombine( const __m128 &row1, const __m128 &row2,
+const __m128 &row3, const float *f ){
+	return _mm_add_ps( _mm_add_ps( _mm_add_ps(
+		_mm_mul_ps( row1, _mm_set1_ps( f[ 0 ] ) ),
+		_mm_mul_ps( row2, _mm_set1_ps( f[ 1 ] ) ) ),
+		_mm_mul_ps( row3, _mm_set1_ps( f[ 2 ] ) ) ),
+		_mm_set_ps( f[ 3 ], 0.0f, 0.0f, 0.0f ) );
+}
+
+#elif defined( DE_MATH_NEON )
+static inline float32x4_t decMatrixCombine( const float32x4_t &row1, const float32x4_t &row2,
+const float32x4_t &row3, const float32x4_t &row4, const float *f ){
+	return vaddq_f32( vaddq_f32( vaddq_f32(
+		vmulq_n_f32( row1, f[ 0 ] ),
+		vmulq_n_f32( row2, f[ 1 ] ) ),
+		vmulq_n_f32( row3, f[ 2 ] ) ),
+		vmulq_n_f32( row4, f[ 3 ] ) );
+}
+
+static inline float32x4_t decMatrixQuickCombine( const float32x4_t &row1,
+const float32x4_t &row2, const float32x4_t &row3, const float *f ){
+	return vaddq_f32( vaddq_f32( vaddq_f32(
+		vmulq_n_f32( row1, f[ 0 ] ),
+		vmulq_n_f32( row2, f[ 1 ] ) ),
+		vmulq_n_f32( row3, f[ 2 ] ) ),
+		vsetq_lane_f32( f[ 3 ], vdupq_n_f32( 0.0f ), 3 ) );
+}
+#endif
+
+
+
 // Class decMatrix
 ///////////////////
 
@@ -789,6 +836,68 @@ void decMatrix::Transform( decVector4 &result, float x, float y, float z, float
 	result.w = a41 * x + a42 * y + a43 * z + a44 * w;
 }
 
+void decMatrix::Transform( const decVector *source, decVector *destination, int count ) const{
+	if( count < 0 || ( count > 0 && ( ! source || ! destination ) ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	int i;
+	
+	#ifdef DE_MATH_SSE
+	const __m128 column1 = _mm_set_ps( 0.0f, a31, a21, a11 );
+	const __m128 column2 = _mm_set_ps( 0.0f, a32, a22, a12 );
+	const __m128 column3 = _mm_set_ps( 0.0f, a33, a23, a13 );
+	const __m128 column4 = _mm_set_ps( 0.0f, a34, a24, a14 );
+	
+	for( i=0; i<count; i++ ){
+		const decVector &vector = source[ i ];
+		const __m128 result = _mm_add_ps( _mm_add_ps( _mm_add_ps(
+			_mm_mul_ps( column1, _mm_set1_ps( vector.x ) ),
+			_mm_mul_ps( column2, _mm_set1_ps( vector.y ) ) ),
+			_mm_mul_ps( column3, _mm_set1_ps( vector.z ) ) ),
+			column4 );
+		
+		// store only three floats. destination can be source
+		decVector &transformed = destination[ i ];
+		_mm_storel_pi( ( __m64* )&transformed.x, result );
+		_mm_store_ss( &transformed.z, _mm_movehl_ps( result, result ) );
+	}
+	
+	#elif defined( DE_MATH_NEON )
+	const float columns[ 16 ] = {
+		a11, a21, a31, 0.0f,
+		a12, a22, a32, 0.0f,
+		a13, a23, a33, 0.0f,
+		a14, a24, a34, 0.0f };
+	const float32x4_t column1 = vld1q_f32( columns );
+	const float32x4_t column2 = vld1q_f32( columns + 4 );
+	const float32x4_t column3 = vld1q_f32( columns + 8 );
+	const float32x4_t column4 = vld1q_f32( columns + 12 );
+	
+	for( i=0; i<count; i++ ){
+		const decVector &vector = source[ i ];
+		const float32x4_t result = vaddq_f32( vaddq_f32( vaddq_f32(
+			vmulq_n_f32( column1, vector.x ),
+			vmulq_n_f32( column2, vector.y ) ),
+			vmulq_n_f32( column3, vector.z ) ),
+			column4 );
+		
+		// store only three floats. destination can be source
+		decVector &transformed = destination[ i ];
+		vst1_f32( &transformed.x, vget_low_f32( result ) );
+		vst1q_lane_f32( &transformed.z, result, 2 );
+	}
+	
+	#else
+	for( i=0; i<count; i++ ){
+		const decVector vector( source[ i ] );
+		destination[ i ].x = a11 * vector.x + a12 * vector.y + a13 * vector.z + a14;
+		destination[ i ].y = a21 * vector.x + a22 * vector.y + a23 * vector.z + a24;
+		destination[ i ].z = a31 * vector.x + a32 * vector.y + a33 * vector.z + a34;
+	}
+	#endif
+}
+
 decMatrix decMatrix::GetRotationMatrix() const{
 	decMatrix m;
 	
@@ -855,6 +964,25 @@ bool decMatrix::IsEqualTo( const decMatrix &matrix, float threshold ) const{
 decMatrix decMatrix::QuickMultiply( const decMatrix &m ) const{
 	decMatrix n;
 	
+	#ifdef DE_MATH_SSE
+	const __m128 row1 = _mm_loadu_ps( &a11 );
+	const __m128 row2 = _mm_loadu_ps( &a21 );
+	const __m128 row3 = _mm_loadu_ps( &a31 );
+	
+	_mm_storeu_ps( &n.a11, decMatrixQuickCombine( row1, row2, row3, &m.a11 ) );
+	_mm_storeu_ps( &n.a21, decMatrixQuickCombine( row1, row2, row3, &m.a21 ) );
+	_mm_storeu_ps( &n.a31, decMatrixQuickCombine( row1, row2, row3, &m.a31 ) );
+	
+	#elif defined( DE_MATH_NEON )
+	const float32x4_t row1 = vld1q_f32( &a11 );
+	const float32x4_t row2 = vld1q_f32( &a21 );
+	const float32x4_t row3 = vld1q_f32( &a31 );
+	
+	vst1q_f32( &n.a11, decMatrixQuickCombine( row1, row2, row3, &m.a11 ) );
+	vst1q_f32( &n.a21, decMatrixQuickCombine( row1, row2, row3, &m.a21 ) );
+	vst1q_f32( &n.a31, decMatrixQuickCombine( row1, row2, row3, &m.a31 ) );
+	
+	#else
 	n.a11 = a11 * m.a11 + a21 * m.a12 + a31 * m.a13;
 	n.a12 = a12 * m.a11 + a22 * m.a12 + a32 * m.a13;
 	n.a13 = a13 * m.a11 + a23 * m.a12 + a33 * m.a13;
@@ -867,6 +995,8 @@ decMatrix decMatrix::QuickMultiply( const decMatrix &m ) const{
 	n.a32 = a12 * m.a31 + a22 * m.a32 + a32 * m.a33;
 	n.a33 = a13 * m.a31 + a23 * m.a32 + a33 * m.a33;
 	n.a34 = a14 * m.a31 + a24 * m.a32 + a34 * m.a33 + m.a34;
+	#endif
+	
 	n.a41 = 0.0f;
 	n.a42 = 0.0f;
 	n.a43 = 0.0f;
@@ -1014,6 +1144,29 @@ decMatrix &decMatrix::operator/=( float k ){
 }
 
 decMatrix &decMatrix::operator*=( const decMatrix &m ){
+	#ifdef DE_MATH_SSE
+	const __m128 row1 = _mm_loadu_ps( &a11 );
+	const __m128 row2 = _mm_loadu_ps( &a21 );
+	const __m128 row3 = _mm_loadu_ps( &a31 );
+	const __m128 row4 = _mm_loadu_ps( &a41 );
+	
+	_mm_storeu_ps( &a11, decMatrixCombine( row1, row2, row3, row4, &m.a11 ) );
+	_mm_storeu_ps( &a21, decMatrixCombine( row1, row2, row3, row4, &m.a21 ) );
+	_mm_storeu_ps( &a31, decMatrixCombine( row1, row2, row3, row4, &m.a31 ) );
+	_mm_storeu_ps( &a41, decMatrixCombine( row1, row2, row3, row4, &m.a41 ) );
+	
+	#elif defined( DE_MATH_NEON )
+	const float32x4_t row1 = vld1q_f32( &a11 );
+	const float32x4_t row2 = vld1q_f32( &a21 );
+	const float32x4_t row3 = vld1q_f32( &a31 );
+	const float32x4_t row4 = vld1q_f32( &a41 );
+	
+	vst1q_f32( &a11, decMatrixCombine( row1, row2, row3, row4, &m.a11 ) );
+	vst1q_f32( &a21, decMatrixCombine( row1, row2, row3, row4, &m.a21 ) );
+	vst1q_f32( &a31, decMatrixCombine( row1, row2, row3, row4, &m.a31 ) );
+	vst1q_f32( &a41, decMatrixCombine( row1, row2, row3, row4, &m.a41 ) );
+	
+	#else
 	const float t11 = a11 * m.a11 + a21 * m.a12 + a31 * m.a13 + a41 * m.a14;
 	const float t12 = a12 * m.a11 + a22 * m.a12 + a32 * m.a13 + a42 * m.a14;
 	const float t13 = a13 * m.a11 + a23 * m.a12 + a33 * m.a13 + a43 * m.a14;
@@ -1035,6 +1188,7 @@ decMatrix &decMatrix::operator*=( const decMatrix &m ){
 	a21 = t21; a22 = t22; a23 = t23; a24 = t24;
 	a31 = t31; a32 = t32; a33 = t33; a34 = t34;
 	a41 = t41; a42 = t42; a43 = t43; a44 = t44;
+	#endif
 	
 	return *this;
 }
@@ -1090,6 +1244,29 @@ decMatrix decMatrix::operator/( float k ) const{
 decMatrix decMatrix::operator*( const decMatrix &m ) const{
 	decMatrix n;
 	
+	#ifdef DE_MATH_SSE
+	const __m128 row1 = _mm_loadu_ps( &a11 );
+	const __m128 row2 = _mm_loadu_ps( &a21 );
+	const __m128 row3 = _mm_loadu_ps( &a31 );
+	const __m128 row4 = _mm_loadu_ps( &a41 );
+	
+	_mm_storeu_ps( &n.a11, decMatrixCombine( row1, row2, row3, row4, &m.a11 ) );
+	_mm_storeu_ps( &n.a21, decMatrixCombine( row1, row2, row3, row4, &m.a21 ) );
+	_mm_storeu_ps( &n.a31, decMatrixCombine( row1, row2, row3, row4, &m.a31 ) );
+	_mm_storeu_ps( &n.a41, decMatrixCombine( row1, row2, row3, row4, &m.a41 ) );
+	
+	#elif defined( DE_MATH_NEON )
+	const float32x4_t row1 = vld1q_f32( &a11 );
+	const float32x4_t row2 = vld1q_f32( &a21 );
+	const float32x4_t row3 = vld1q_f32( &a31 );
+	const float32x4_t row4 = vld1q_f32( &a41 );
+	
+	vst1q_f32( &n.a11, decMatrixCombine( row1, row2, row3, row4, &m.a11 ) );
+	vst1q_f32( &n.a21, decMatrixCombine( row1, row2, row3, row4, &m.a21 ) );
+	vst1q_f32( &n.a31, decMatrixCombine( row1, row2, row3, row4, &m.a31 ) );
+	vst1q_f32( &n.a41, decMatrixCombine( row1, row2, row3, row4, &m.a41 ) );
+	
+	#else
 	n.a11 = a11 * m.a11 + a21 * m.a12 + a31 * m.a13 + a41 * m.a14;
 	n.a12 = a12 * m.a11 + a22 * m.a12 + a32 * m.a13 + a42 * m.a14;
 	n.a13 = a13 * m.a11 + a23 * m.a12 + a33 * m.a13 + a43 * m.a14;
@@ -1106,6 +1283,7 @@ decMatrix decMatrix::operator*( const decMatrix &m ) const{
 	n.a42 = a12 * m.a41 + a22 * m.a42 + a32 * m.a43 + a42 * m.a44;
 	n.a43 = a13 * m.a41 + a23 * m.a42 + a33 * m.a43 + a43 * m.a44;
 	n.a44 = a14 * m.a41 + a24 * m.a42 + a34 * m.a43 + a44 * m.a44;
+	#endif
 	
 	return n;
 }
@@ -549,6 +549,18 @@ public:
 	/** \brief Transforma vector. */
 	void Transform( decVector4 &result, float x, float y, float z, float w ) const;
 	
+	/**
+	 * \brief Transform array of vectors.
+	 * 
+	 * Same as transforming each vector using operator*(const decVector&) but faster for
+	 * large arrays. Source and destination can be the same array.
+	 * 
+	 * \param[in] source Vectors to transform.
+	 * \param[out] destination Transformed vectors. Has to hold count vectors.
+	 * \param[in] count Number of vectors.
+	 */
+	void Transform( const decVector *source, decVector *destination, int count ) const;
+	
 	/**
 	 * \brief Rotation part of the matrix.
 	 * 
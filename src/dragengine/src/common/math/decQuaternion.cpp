@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "decMath.h"
+#include "decMathSIMD.h"
 #include "../exceptions.h"
 
 
@@ -207,7 +208,24 @@ decQuaternion decQuaternion::Slerp( const decQuaternion &other, float factor ) c
 		scale1 = factor;
 	}
 	
+	#ifdef DE_MATH_SSE
+	decQuaternion result;
+	_mm_storeu_ps( &result.x, _mm_add_ps(
+		_mm_mul_ps( _mm_loadu_ps( &x ), _mm_set1_ps( scale0 ) ),
+		_mm_mul_ps( _mm_set_ps( qw, qz, qy, qx ), _mm_set1_ps( scale1 ) ) ) );
+	return result;
+	
+	#elif defined( DE_MATH_NEON )
+	const float other4[ 4 ] = { qx, qy, qz, qw };
+	decQuaternion result;
+	vst1q_f32( &result.x, vaddq_f32(
+		vmulq_n_f32( vld1q_f32( &x ), scale0 ),
+		vmulq_n_f32( vld1q_f32( other4 ), scale1 ) ) );
+	return result;
+	
+	#else
 	return decQuaternion( x * scale0 + qx * scale1, y * scale0 + qy * scale1, z * scale0 + qz * scale1, w * scale0 + qw * scale1 );
+	#endif
 }
 
 bool decQuaternion::IsEqualTo( const decQuaternion &q, float threshold ) const{
@@ -415,6 +433,10 @@ decQuaternion &decQuaternion::operator*=( float k ){
 }
 
 decQuaternion &decQuaternion::operator*=( const decQuaternion &q ){
+	#if defined( DE_MATH_SSE ) || defined( DE_MATH_NEON )
+	*this = *this * q;
+	
+	#else
 	const float nx = q.x * w + q.y * z - q.z * y + q.w * x;
 	const float ny = -q.x * z + q.y * w + q.z * x + q.w * y;
 	const float nz = q.x * y - q.y * x + q.z * w + q.w * z;
@@ -424,6 +446,7 @@ decQuaternion &decQuaternion::operator*=( const decQuaternion &q ){
 	y = ny;
 	z = nz;
 	w = nw;
+	#endif
 	
 	return *this;
 }
@@ -454,11 +477,47 @@ decQuaternion decQuaternion::operator*( float k ) const{
 }
 
 decQuaternion decQuaternion::operator*( const decQuaternion &q ) const{
+	// lanes use the same order of operations as the scalar implementation. negating
+	// factors by multiplying with -1 is exact
+	#ifdef DE_MATH_SSE
+	const __m128 t = _mm_loadu_ps( &x );
+	
+	decQuaternion result;
+	_mm_storeu_ps( &result.x, _mm_add_ps( _mm_add_ps( _mm_add_ps(
+		_mm_mul_ps( _mm_mul_ps( _mm_shuffle_ps( t, t, _MM_SHUFFLE( 0, 1, 2, 3 ) ),
+			_mm_set_ps( -1.0f, 1.0f, -1.0f, 1.0f ) ), _mm_set1_ps( q.x ) ),
+		_mm_mul_ps( _mm_mul_ps( _mm_shuffle_ps( t, t, _MM_SHUFFLE( 1, 0, 3, 2 ) ),
+			_mm_set_ps( -1.0f, -1.0f, 1.0f, 1.0f ) ), _mm_set1_ps( q.y ) ) ),
+		_mm_mul_ps( _mm_mul_ps( _mm_shuffle_ps( t, t, _MM_SHUFFLE( 2, 3, 0, 1 ) ),
+			_mm_set_ps( -1.0f, 1.0f, 1.0f, -1.0f ) ), _mm_set1_ps( q.z ) ) ),
+		_mm_mul_ps( t, _mm_set1_ps( q.w ) ) ) );
+	return result;
+	
+	#elif defined( DE_MATH_NEON )
+	static const float signs1[ 4 ] = { 1.0f, -1.0f, 1.0f, -1.0f };
+	static const float signs2[ 4 ] = { 1.0f, 1.0f, -1.0f, -1.0f };
+	static const float signs3[ 4 ] = { -1.0f, 1.0f, 1.0f, -1.0f };
+	
+	const float32x4_t t = vld1q_f32( &x );
+	const float32x4_t zwxy = vextq_f32( t, t, 2 );
+	const float32x4_t wzyx = vrev64q_f32( zwxy );
+	const float32x4_t yxwz = vrev64q_f32( t );
+	
+	decQuaternion result;
+	vst1q_f32( &result.x, vaddq_f32( vaddq_f32( vaddq_f32(
+		vmulq_n_f32( vmulq_f32( wzyx, vld1q_f32( signs1 ) ), q.x ),
+		vmulq_n_f32( vmulq_f32( zwxy, vld1q_f32( signs2 ) ), q.y ) ),
+		vmulq_n_f32( vmulq_f32( yxwz, vld1q_f32( signs3 ) ), q.z ) ),
+		vmulq_n_f32( t, q.w ) ) );
+	return result;
+	
+	#else
 	return decQuaternion(
 			q.x * w + q.y * z - q.z * y + q.w * x,
 		-q.x * z + q.y * w + q.z * x + q.w * y,
 			q.x * y - q.y * x + q.z * w + q.w * z,
 		-q.x * x - q.y * y - q.z * z + q.w * w );
+	#endif
 }
 
 decQuaternion decQuaternion::operator/( float k ) const{
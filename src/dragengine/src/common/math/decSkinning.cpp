@@ -0,0 +1,434 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <string.h>
+
+#if defined( __AVX__ )
+#	include <immintrin.h>
+#elif defined( __SSE__ ) || defined( _M_X64 )
+#	include <xmmintrin.h>
+#	define DECSKINNING_SSE 1
+#endif
+
+#include "decSkinning.h"
+#include "../exceptions.h"
+
+
+
+// Class decSkinning
+//////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+decSkinning::decSkinning() :
+pPositionX( NULL ),
+pPositionY( NULL ),
+pPositionZ( NULL ),
+pWeightSets( NULL ),
+pIndices( NULL ),
+pVertexCount( 0 ),
+pRuns( NULL ),
+pRunCount( 0 ),
+pWeightSetCount( 0 ),
+pPrepared( false ){
+}
+
+decSkinning::~decSkinning(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void decSkinning::SetVertexCount( int count ){
+	if( count < 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pCleanUp();
+	pPositionX = NULL;
+	pPositionY = NULL;
+	pPositionZ = NULL;
+	pWeightSets = NULL;
+	pIndices = NULL;
+	pVertexCount = 0;
+	pRuns = NULL;
+	pRunCount = 0;
+	pWeightSetCount = 0;
+	pPrepared = false;
+	
+	if( count == 0 ){
+		return;
+	}
+	
+	try{
+		pPositionX = new float[ count ];
+		pPositionY = new float[ count ];
+		pPositionZ = new float[ count ];
+		pWeightSets = new int[ count ];
+		pIndices = new int[ count ];
+		
+	}catch( const deException & ){
+		pCleanUp();
+		pPositionX = NULL;
+		pPositionY = NULL;
+		pPositionZ = NULL;
+		pWeightSets = NULL;
+		pIndices = NULL;
+		throw;
+	}
+	
+	memset( pPositionX, 0, sizeof( float ) * count );
+	memset( pPositionY, 0, sizeof( float ) * count );
+	memset( pPositionZ, 0, sizeof( float ) * count );
+	
+	int i;
+	for( i=0; i<count; i++ ){
+		pWeightSets[ i ] = -1;
+		pIndices[ i ] = i;
+	}
+	
+	pVertexCount = count;
+}
+
+void decSkinning::SetVertexAt( int index, const decVector &position, int weightSet ){
+	if( pPrepared || index < 0 || index >= pVertexCount || weightSet < -1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPositionX[ index ] = position.x;
+	pPositionY[ index ] = position.y;
+	pPositionZ[ index ] = position.z;
+	pWeightSets[ index ] = weightSet;
+}
+
+void decSkinning::Prepare(){
+	if( pPrepared ){
+		return;
+	}
+	
+	int i;
+	
+	pWeightSetCount = 0;
+	for( i=0; i<pVertexCount; i++ ){
+		if( pWeightSets[ i ] >= pWeightSetCount ){
+			pWeightSetCount = pWeightSets[ i ] + 1;
+		}
+	}
+	
+	// counting sort by weight set. bucket 0 holds vertices without weight set
+	const int bucketCount = pWeightSetCount + 1;
+	int *buckets = NULL;
+	float *sortedX = NULL;
+	float *sortedY = NULL;
+	float *sortedZ = NULL;
+	int *sortedIndices = NULL;
+	sRun *runs = NULL;
+	
+	try{
+		buckets = new int[ bucketCount + 1 ];
+		memset( buckets, 0, sizeof( int ) * ( bucketCount + 1 ) );
+		
+		for( i=0; i<pVertexCount; i++ ){
+			buckets[ pWeightSets[ i ] + 2 ]++;
+		}
+		
+		int runCount = 0;
+		for( i=1; i<=bucketCount; i++ ){
+			if( buckets[ i ] > 0 ){
+				runCount++;
+			}
+			buckets[ i ] += buckets[ i - 1 ];
+		}
+		
+		if( pVertexCount > 0 ){
+			sortedX = new float[ pVertexCount ];
+			sortedY = new float[ pVertexCount ];
+			sortedZ = new float[ pVertexCount ];
+			sortedIndices = new int[ pVertexCount ];
+		}
+		if( runCount > 0 ){
+			runs = new sRun[ runCount ];
+		}
+		
+		for( i=0; i<pVertexCount; i++ ){
+			const int target = buckets[ pWeightSets[ i ] + 1 ]++;
+			sortedX[ target ] = pPositionX[ i ];
+			sortedY[ target ] = pPositionY[ i ];
+			sortedZ[ target ] = pPositionZ[ i ];
+			sortedIndices[ target ] = i;
+		}
+		
+		// buckets now hold the end of each weight set
+		int first = 0;
+		runCount = 0;
+		for( i=0; i<bucketCount; i++ ){
+			const int count = buckets[ i ] - first;
+			if( count > 0 ){
+				runs[ runCount ].weightSet = i - 1;
+				runs[ runCount ].first = first;
+				runs[ runCount ].count = count;
+				runCount++;
+			}
+			first = buckets[ i ];
+		}
+		
+		delete [] buckets;
+		buckets = NULL;
+		
+		if( pPositionX ){
+			delete [] pPositionX;
+		}
+		if( pPositionY ){
+			delete [] pPositionY;
+		}
+		if( pPositionZ ){
+			delete [] pPositionZ;
+		}
+		if( pIndices ){
+			delete [] pIndices;
+		}
+		
+		pPositionX = sortedX;
+		pPositionY = sortedY;
+		pPositionZ = sortedZ;
+		pIndices = sortedIndices;
+		pRuns = runs;
+		pRunCount = runCount;
+		
+	}catch( const deException & ){
+		if( runs ){
+			delete [] runs;
+		}
+		if( sortedIndices ){
+			delete [] sortedIndices;
+		}
+		if( sortedZ ){
+			delete [] sortedZ;
+		}
+		if( sortedY ){
+			delete [] sortedY;
+		}
+		if( sortedX ){
+			delete [] sortedX;
+		}
+		if( buckets ){
+			delete [] buckets;
+		}
+		throw;
+	}
+	
+	pPrepared = true;
+}
+
+const decSkinning::sRun &decSkinning::GetRunAt( int index ) const{
+	if( index < 0 || index >= pRunCount ){
+		DETHROW( deeInvalidParam );
+	}
+	return pRuns[ index ];
+}
+
+
+
+void decSkinning::Transform( const float *matrices, int matrixStride,
+float *positions, int positionStride ) const{
+	Transform( matrices, matrixStride, positions, positionStride, 0, pVertexCount );
+}
+
+void decSkinning::Transform( const float *matrices, int matrixStride, float *positions,
+int positionStride, int first, int count ) const{
+	if( ! pPrepared ){
+		DETHROW( deeInvalidAction );
+	}
+	if( first < 0 || count < 0 || first + count > pVertexCount ){
+		DETHROW( deeInvalidParam );
+	}
+	if( count == 0 ){
+		return;
+	}
+	if( ! positions || positionStride < 3 ){
+		DETHROW( deeInvalidParam );
+	}
+	if( pWeightSetCount > 0 && ( ! matrices || matrixStride < 12 ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	// find run containing first sorted vertex
+	int lower = 0;
+	int upper = pRunCount - 1;
+	while( lower < upper ){
+		const int middle = ( lower + upper + 1 ) / 2;
+		if( pRuns[ middle ].first <= first ){
+			lower = middle;
+			
+		}else{
+			upper = middle - 1;
+		}
+	}
+	
+	const int last = first + count;
+	int runIndex;
+	
+	for( runIndex=lower; runIndex<pRunCount && first<last; runIndex++ ){
+		const sRun &run = pRuns[ runIndex ];
+		const int runEnd = decMath::min( run.first + run.count, last );
+		
+		if( run.weightSet == -1 ){
+			pCopyRun( first, runEnd - first, positions, positionStride );
+			
+		}else{
+			pTransformRun( matrices + matrixStride * run.weightSet,
+				first, runEnd - first, positions, positionStride );
+		}
+		
+		first = runEnd;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void decSkinning::pCleanUp(){
+	if( pRuns ){
+		delete [] pRuns;
+	}
+	if( pIndices ){
+		delete [] pIndices;
+	}
+	if( pWeightSets ){
+		delete [] pWeightSets;
+	}
+	if( pPositionZ ){
+		delete [] pPositionZ;
+	}
+	if( pPositionY ){
+		delete [] pPositionY;
+	}
+	if( pPositionX ){
+		delete [] pPositionX;
+	}
+}
+
+void decSkinning::pTransformRun( const float *matrix, int first, int count,
+float *positions, int positionStride ) const{
+	const float * const x = pPositionX + first;
+	const float * const y = pPositionY + first;
+	const float * const z = pPositionZ + first;
+	const int * const indices = pIndices + first;
+	int i = 0;
+	
+#if defined( __AVX__ )
+	const __m256 m11 = _mm256_set1_ps( matrix[ 0 ] );
+	const __m256 m12 = _mm256_set1_ps( matrix[ 1 ] );
+	const __m256 m13 = _mm256_set1_ps( matrix[ 2 ] );
+	const __m256 m14 = _mm256_set1_ps( matrix[ 3 ] );
+	const __m256 m21 = _mm256_set1_ps( matrix[ 4 ] );
+	const __m256 m22 = _mm256_set1_ps( matrix[ 5 ] );
+	const __m256 m23 = _mm256_set1_ps( matrix[ 6 ] );
+	const __m256 m24 = _mm256_set1_ps( matrix[ 7 ] );
+	const __m256 m31 = _mm256_set1_ps( matrix[ 8 ] );
+	const __m256 m32 = _mm256_set1_ps( matrix[ 9 ] );
+	const __m256 m33 = _mm256_set1_ps( matrix[ 10 ] );
+	const __m256 m34 = _mm256_set1_ps( matrix[ 11 ] );
+	float rx[ 8 ], ry[ 8 ], rz[ 8 ];
+	int j;
+	
+	for( ; i+8<=count; i+=8 ){
+		const __m256 vx = _mm256_loadu_ps( x + i );
+		const __m256 vy = _mm256_loadu_ps( y + i );
+		const __m256 vz = _mm256_loadu_ps( z + i );
+		
+		_mm256_storeu_ps( rx, _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m11, vx ),
+			_mm256_mul_ps( m12, vy ) ), _mm256_add_ps( _mm256_mul_ps( m13, vz ), m14 ) ) );
+		_mm256_storeu_ps( ry, _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m21, vx ),
+			_mm256_mul_ps( m22, vy ) ), _mm256_add_ps( _mm256_mul_ps( m23, vz ), m24 ) ) );
+		_mm256_storeu_ps( rz, _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( m31, vx ),
+			_mm256_mul_ps( m32, vy ) ), _mm256_add_ps( _mm256_mul_ps( m33, vz ), m34 ) ) );
+		
+		for( j=0; j<8; j++ ){
+			float * const position = positions + positionStride * indices[ i + j ];
+			position[ 0 ] = rx[ j ];
+			position[ 1 ] = ry[ j ];
+			position[ 2 ] = rz[ j ];
+		}
+	}
+	
+#elif defined( DECSKINNING_SSE )
+	const __m128 m11 = _mm_set1_ps( matrix[ 0 ] );
+	const __m128 m12 = _mm_set1_ps( matrix[ 1 ] );
+	const __m128 m13 = _mm_set1_ps( matrix[ 2 ] );
+	const __m128 m14 = _mm_set1_ps( matrix[ 3 ] );
+	const __m128 m21 = _mm_set1_ps( matrix[ 4 ] );
+	const __m128 m22 = _mm_set1_ps( matrix[ 5 ] );
+	const __m128 m23 = _mm_set1_ps( matrix[ 6 ] );
+	const __m128 m24 = _mm_set1_ps( matrix[ 7 ] );
+	const __m128 m31 = _mm_set1_ps( matrix[ 8 ] );
+	const __m128 m32 = _mm_set1_ps( matrix[ 9 ] );
+	const __m128 m33 = _mm_set1_ps( matrix[ 10 ] );
+	const __m128 m34 = _mm_set1_ps( matrix[ 11 ] );
+	float rx[ 4 ], ry[ 4 ], rz[ 4 ];
+	int j;
+	
+	for( ; i+4<=count; i+=4 ){
+		const __m128 vx = _mm_loadu_ps( x + i );
+		const __m128 vy = _mm_loadu_ps( y + i );
+		const __m128 vz = _mm_loadu_ps( z + i );
+		
+		_mm_storeu_ps( rx, _mm_add_ps( _mm_add_ps( _mm_mul_ps( m11, vx ), _mm_mul_ps( m12, vy ) ),
+			_mm_add_ps( _mm_mul_ps( m13, vz ), m14 ) ) );
+		_mm_storeu_ps( ry, _mm_add_ps( _mm_add_ps( _mm_mul_ps( m21, vx ), _mm_mul_ps( m22, vy ) ),
+			_mm_add_ps( _mm_mul_ps( m23, vz ), m24 ) ) );
+		_mm_storeu_ps( rz, _mm_add_ps( _mm_add_ps( _mm_mul_ps( m31, vx ), _mm_mul_ps( m32, vy ) ),
+			_mm_add_ps( _mm_mul_ps( m33, vz ), m34 ) ) );
+		
+		for( j=0; j<4; j++ ){
+			float * const position = positions + positionStride * indices[ i + j ];
+			position[ 0 ] = rx[ j ];
+			position[ 1 ] = ry[ j ];
+			position[ 2 ] = rz[ j ];
+		}
+	}
+#endif
+	
+	// scalar fallback and remaining vertices
+	for( ; i<count; i++ ){
+		float * const position = positions + positionStride * indices[ i ];
+		position[ 0 ] = matrix[ 0 ] * x[ i ] + matrix[ 1 ] * y[ i ] + matrix[ 2 ] * z[ i ] + matrix[ 3 ];
+		position[ 1 ] = matrix[ 4 ] * x[ i ] + matrix[ 5 ] * y[ i ] + matrix[ 6 ] * z[ i ] + matrix[ 7 ];
+		position[ 2 ] = matrix[ 8 ] * x[ i ] + matrix[ 9 ] * y[ i ] + matrix[ 10 ] * z[ i ] + matrix[ 11 ];
+	}
+}
+
+void decSkinning::pCopyRun( int first, int count, float *positions, int positionStride ) const{
+	int i;
+	
+	for( i=first; i<first+count; i++ ){
+		float * const position = positions + positionStride * pIndices[ i ];
+		position[ 0 ] = pPositionX[ i ];
+		position[ 1 ] = pPositionY[ i ];
+		position[ 2 ] = pPositionZ[ i ];
+	}
+}
@@ -0,0 +1,155 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DECSKINNING_H_
+#define _DECSKINNING_H_
+
+#include "decMath.h"
+
+
+/**
+ * \brief CPU skinning kernel.
+ *
+ * Transforms rest positions of vertices by weight matrices. Vertices are added using
+ * SetVertexAt() and sorted by weight set once using Prepare(). Transform() then loads
+ * every weight matrix once for the entire run of vertices using it and streams the
+ * rest positions linearly. Runs are processed eight vertices at a time if AVX is
+ * available, four vertices at a time if SSE is available and one vertex at a time
+ * otherwise. Vertices without weight set are copied.
+ *
+ * Weight matrices are 3x4 row major float matrices with a configurable stride in floats.
+ * This matches decMatrix using a stride of 16 as well as packed 3x4 matrices using a
+ * stride of 12. Output positions are written as three floats with a configurable stride
+ * in floats at the index the vertex has been added with.
+ *
+ * Transform() is thread safe after Prepare() has been called. The sorted vertices can be
+ * split into disjoint ranges transformed in parallel.
+ */
+class decSkinning{
+public:
+	/** \brief Run of sorted vertices using the same weight set. */
+	struct sRun{
+		/** \brief Weight set or -1 if not weighted. */
+		int weightSet;
+		
+		/** \brief Index of first sorted vertex. */
+		int first;
+		
+		/** \brief Number of vertices. */
+		int count;
+	};
+	
+	
+	
+private:
+	float *pPositionX;
+	float *pPositionY;
+	float *pPositionZ;
+	int *pWeightSets;
+	int *pIndices;
+	int pVertexCount;
+	
+	sRun *pRuns;
+	int pRunCount;
+	int pWeightSetCount;
+	bool pPrepared;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create skinning kernel without vertices. */
+	decSkinning();
+	
+	/** \brief Clean up skinning kernel. */
+	~decSkinning();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of vertices. */
+	inline int GetVertexCount() const{ return pVertexCount; }
+	
+	/**
+	 * \brief Set number of vertices.
+	 *
+	 * All vertices are set to position zero without weight set.
+	 */
+	void SetVertexCount( int count );
+	
+	/**
+	 * \brief Set vertex.
+	 * \param[in] index Index of vertex.
+	 * \param[in] position Rest position.
+	 * \param[in] weightSet Weight set or -1 if not weighted.
+	 */
+	void SetVertexAt( int index, const decVector &position, int weightSet );
+	
+	/** \brief Sort vertices by weight set. Call after all vertices have been set. */
+	void Prepare();
+	
+	/** \brief Vertices have been prepared. */
+	inline bool GetPrepared() const{ return pPrepared; }
+	
+	/** \brief Number of weight matrices required by Transform(). */
+	inline int GetWeightSetCount() const{ return pWeightSetCount; }
+	
+	/** \brief Number of runs. */
+	inline int GetRunCount() const{ return pRunCount; }
+	
+	/** \brief Run at index. */
+	const sRun &GetRunAt( int index ) const;
+	
+	
+	
+	/**
+	 * \brief Transform all vertices.
+	 * \param[in] matrices First float of first weight matrix.
+	 * \param[in] matrixStride Distance between weight matrices in floats. At least 12.
+	 * \param[out] positions First float of first output position.
+	 * \param[in] positionStride Distance between output positions in floats. At least 3.
+	 * \throws deeInvalidAction Prepare() has not been called.
+	 */
+	void Transform( const float *matrices, int matrixStride, float *positions, int positionStride ) const;
+	
+	/**
+	 * \brief Transform range of sorted vertices.
+	 *
+	 * Same as Transform(const float*,int,float*,int) but transforms only count sorted
+	 * vertices starting with first. Use to split the work into chunks.
+	 */
+	void Transform( const float *matrices, int matrixStride, float *positions,
+		int positionStride, int first, int count ) const;
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+	void pTransformRun( const float *matrix, int first, int count,
+		float *positions, int positionStride ) const;
+	void pCopyRun( int first, int count, float *positions, int positionStride ) const;
+};
+
+#endif
@@ -292,6 +292,8 @@ deEngine::deEngine( deOS *os, deVirtualFileSystem *fileSystem ){
 	// resource managers
 	pResMgrs = NULL;
 	pParallelProcessing = NULL;
+	pParallelWorldUpdate = false;
+	pLogWorldPeerUpdateTimes = false;
 	pResLoader = NULL;
 	
 	// files
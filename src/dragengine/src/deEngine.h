@@ -143,6 +143,8 @@ private:
 	deModuleSystem *pModSys;
 	deBaseSystem **pSystems;
 	deParallelProcessing *pParallelProcessing;
+	bool pParallelWorldUpdate;
+	bool pLogWorldPeerUpdateTimes;
 	deResourceLoader *pResLoader;
 	
 	// resource managers
@@ -327,6 +329,27 @@ public:
 	inline deParallelProcessing &GetParallelProcessing(){ return *pParallelProcessing; }
 	inline const deParallelProcessing &GetParallelProcessing() const{ return *pParallelProcessing; }
 	
+	/**
+	 * \brief Update world peers supporting it in parallel.
+	 * 
+	 * If enabled deWorld::Update() runs world peers supporting parallel updates as parallel
+	 * tasks while the other peers are updated. Disabled by default.
+	 */
+	inline bool GetParallelWorldUpdate() const{ return pParallelWorldUpdate; }
+	
+	/** \brief Set if world peers supporting it are updated in parallel. */
+	inline void SetParallelWorldUpdate( bool parallelWorldUpdate ){ pParallelWorldUpdate = parallelWorldUpdate; }
+	
+	/**
+	 * \brief Log time each world peer took after each call to deWorld::Update().
+	 * 
+	 * For debugging only. Disabled by default.
+	 */
+	inline bool GetLogWorldPeerUpdateTimes() const{ return pLogWorldPeerUpdateTimes; }
+	
+	/** \brief Set if time each world peer took is logged after each call to deWorld::Update(). */
+	inline void SetLogWorldPeerUpdateTimes( bool logWorldPeerUpdateTimes ){ pLogWorldPeerUpdateTimes = logWorldPeerUpdateTimes; }
+	
 	/** \brief Resource loader. */
 	inline deResourceLoader *GetResourceLoader() const{ return pResLoader; }
 	
@@ -0,0 +1,305 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "deLoggerAsync.h"
+#include "deLoggerAsyncThread.h"
+#include "deLoggerFile.h"
+#include "../common/exceptions.h"
+#include "../common/string/decString.h"
+#include "../common/string/decStringList.h"
+#include "../threading/deMutexGuard.h"
+
+#if defined OS_BEOS && ! defined va_copy
+#define va_copy __va_copy
+#endif
+
+
+
+// Definitions
+////////////////
+
+// size of stack buffer used to format messages. longer messages use a heap string
+#define FORMAT_BUFFER_SIZE 512
+
+
+
+// Class deLoggerAsync
+////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deLoggerAsync::deLoggerAsync( deLogger *logger ) :
+pLogger( NULL ),
+pLoggerFile( NULL ),
+pThread( NULL )
+{
+	if( ! logger ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pLogger = logger;
+	logger->AddReference();
+	
+	// file logger flushes once per drained batch instead of once per message
+	pLoggerFile = dynamic_cast<deLoggerFile*>( logger );
+	if( pLoggerFile ){
+		pLoggerFile->SetFlushEachMessage( false );
+	}
+	
+	try{
+		pThread = new deLoggerAsyncThread( *this, pSemaphore );
+		pThread->Start();
+		
+	}catch( const deException & ){
+		if( pThread ){
+			delete pThread;
+		}
+		if( pLoggerFile ){
+			pLoggerFile->SetFlushEachMessage( true );
+		}
+		pLogger->FreeReference();
+		throw;
+	}
+}
+
+deLoggerAsync::~deLoggerAsync(){
+	if( pThread ){
+		pThread->RequestExit();
+		pSemaphore.Signal();
+		pThread->WaitForExit();
+		delete pThread;
+	}
+	
+	DrainQueue();
+	
+	if( pLoggerFile ){
+		pLoggerFile->SetFlushEachMessage( true );
+	}
+	if( pLogger ){
+		pLogger->FreeReference();
+	}
+}
+
+
+
+// Management
+///////////////
+
+void deLoggerAsync::Flush(){
+	DrainQueue();
+}
+
+void deLoggerAsync::DrainQueue(){
+	deMutexGuard lock( pMutexDrain );
+	sMessage *message = ( sMessage* )pQueue.TakeAll();
+	if( ! message ){
+		return;
+	}
+	
+	while( message ){
+		sMessage * const next = ( sMessage* )message->next;
+		
+		try{
+			switch( message->type ){
+			case emtInfo:
+				pLogger->LogInfo( message->source, message->message );
+				break;
+				
+			case emtWarn:
+				pLogger->LogWarn( message->source, message->message );
+				break;
+				
+			case emtError:
+				pLogger->LogError( message->source, message->message );
+				break;
+			}
+			
+		}catch( const deException & ){
+			// nowhere left to log to. drop the message
+		}
+		
+		free( message );
+		message = next;
+	}
+	
+	// file logger does not flush each message while used by us
+	if( pLoggerFile ){
+		try{
+			pLoggerFile->Flush();
+			
+		}catch( const deException & ){
+		}
+	}
+}
+
+
+
+void deLoggerAsync::LogInfo( const char *source, const char *message ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPush( emtInfo, source, message, strlen( message ) );
+}
+
+void deLoggerAsync::LogInfoFormat( const char *source, const char *message, ... ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	va_list list;
+	va_start( list, message );
+	pPushFormat( emtInfo, source, message, list );
+	va_end( list );
+}
+
+void deLoggerAsync::LogInfoFormatUsing( const char *source, const char *message, va_list args ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPushFormat( emtInfo, source, message, args );
+}
+
+void deLoggerAsync::LogWarn( const char *source, const char *message ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPush( emtWarn, source, message, strlen( message ) );
+}
+
+void deLoggerAsync::LogWarnFormat( const char *source, const char *message, ... ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	va_list list;
+	va_start( list, message );
+	pPushFormat( emtWarn, source, message, list );
+	va_end( list );
+}
+
+void deLoggerAsync::LogWarnFormatUsing( const char *source, const char *message, va_list args ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPushFormat( emtWarn, source, message, args );
+}
+
+void deLoggerAsync::LogError( const char *source, const char *message ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPush( emtError, source, message, strlen( message ) );
+	DrainQueue();
+}
+
+void deLoggerAsync::LogErrorFormat( const char *source, const char *message, ... ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	va_list list;
+	va_start( list, message );
+	pPushFormat( emtError, source, message, list );
+	va_end( list );
+	DrainQueue();
+}
+
+void deLoggerAsync::LogErrorFormatUsing( const char *source, const char *message, va_list args ){
+	if( ! source || ! message ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPushFormat( emtError, source, message, args );
+	DrainQueue();
+}
+
+void deLoggerAsync::LogException( const char *source, const deException &exception ){
+	if( ! source ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const decStringList output = exception.FormatOutput();
+	const int count = output.GetCount();
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		const decString &line = output.GetAt( i );
+		pPush( emtError, source, line.GetString(), line.GetLength() );
+	}
+	
+	DrainQueue();
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deLoggerAsync::pPush( eMessageTypes type, const char *source, const char *message, int length ){
+	// source and message are stored in the same allocation as the message structure
+	const int sourceLength = strlen( source );
+	sMessage * const entry = ( sMessage* )malloc( sizeof( sMessage ) + sourceLength + length + 2 );
+	if( ! entry ){
+		DETHROW( deeOutOfMemory );
+	}
+	
+	entry->type = type;
+	entry->source = ( char* )( entry + 1 );
+	memcpy( entry->source, source, sourceLength );
+	entry->source[ sourceLength ] = 0;
+	entry->message = entry->source + sourceLength + 1;
+	memcpy( entry->message, message, length );
+	entry->message[ length ] = 0;
+	
+	// the writer thread has only to be woken up if the queue has been empty
+	if( pQueue.Push( entry ) ){
+		pSemaphore.Signal();
+	}
+}
+
+void deLoggerAsync::pPushFormat( eMessageTypes type, const char *source, const char *format, va_list args ){
+	char buffer[ FORMAT_BUFFER_SIZE ];
+	va_list copyArgs;
+	
+	va_copy( copyArgs, args );
+	const int length = vsnprintf( buffer, FORMAT_BUFFER_SIZE, format, copyArgs );
+	va_end( copyArgs );
+	
+	if( length >= 0 && length < FORMAT_BUFFER_SIZE ){
+		pPush( type, source, buffer, length );
+		
+	}else{
+		decString string;
+		string.FormatUsing( format, args );
+		pPush( type, source, string.GetString(), string.GetLength() );
+	}
+}
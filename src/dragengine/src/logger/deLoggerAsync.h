@@ -0,0 +1,185 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DELOGGERASYNC_H_
+#define _DELOGGERASYNC_H_
+
+#include "deLogger.h"
+#include "../threading/deLockFreeQueue.h"
+#include "../threading/deMutex.h"
+#include "../threading/deSemaphore.h"
+
+class deLoggerAsyncThread;
+class deLoggerFile;
+
+
+/**
+ * \brief Logs asynchronously to another logger.
+ * 
+ * Logging threads format the message on their own stack and push it onto a
+ * deLockFreeQueue. A background writer thread drains the queue in batches and
+ * forwards the messages in the order they have been logged to the target logger. The
+ * logging threads thus never wait for disk or console I/O done by the target logger.
+ * 
+ * Error messages and exceptions drain the queue synchronously before returning. This
+ * ensures messages logged right before a crash are written. Flush() can be used to
+ * drain the queue explicitly. Forwarding to a deLoggerFile flushes the file once per
+ * drained batch instead of once per message.
+ * 
+ * \note Logger is thread safe.
+ */
+class deLoggerAsync : public deLogger{
+public:
+	/** \brief Message types. */
+	enum eMessageTypes{
+		/** \brief Information. */
+		emtInfo,
+		
+		/** \brief Warning. */
+		emtWarn,
+		
+		/** \brief Error. */
+		emtError
+	};
+	
+	/** \brief Queued message. */
+	struct sMessage : public deLockFreeQueue::sEntry{
+		/** \brief Message type. */
+		eMessageTypes type;
+		
+		/** \brief Source stored after the message structure. */
+		char *source;
+		
+		/** \brief Message stored after the source. */
+		char *message;
+	};
+	
+	
+	
+private:
+	deLogger *pLogger;
+	deLoggerFile *pLoggerFile;
+	
+	deLockFreeQueue pQueue;
+	deMutex pMutexDrain;
+	deSemaphore pSemaphore;
+	
+	deLoggerAsyncThread *pThread;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create asynchronous logger.
+	 * 
+	 * If \em logger is a deLoggerFile flushing each message is disabled while in use.
+	 * Written messages are flushed once after each drained batch instead.
+	 * 
+	 * \param[in] logger Logger to forward messages to.
+	 * \throws deeInvalidParam \em logger is NULL.
+	 */
+	deLoggerAsync( deLogger *logger );
+	
+protected:
+	/**
+	 * \brief Clean up asynchronous logger.
+	 * 
+	 * Stops the writer thread and writes all pending messages.
+	 * 
+	 * \note Subclasses should set their destructor protected too to avoid users
+	 * accidently deleting a reference counted object through the object
+	 * pointer. Only FreeReference() is allowed to delete the object.
+	 */
+	virtual ~deLoggerAsync();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Logger messages are forwarded to. */
+	inline deLogger *GetLogger() const{ return pLogger; }
+	
+	/** \brief Write all pending messages before returning. */
+	void Flush();
+	
+	/**
+	 * \brief Write pending messages.
+	 * \warning For use by the writer thread only.
+	 */
+	void DrainQueue();
+	
+	
+	
+	/** \brief Log information message. */
+	virtual void LogInfo( const char *source, const char *message );
+	
+	/** \brief Log formatted information message. */
+	virtual void LogInfoFormat( const char *source, const char *message, ... )
+		#ifdef __GNUC__
+		__attribute__ ((format (printf, 3, 4)))
+		#endif
+		;
+	
+	/** \brief Log formatted information message. */
+	virtual void LogInfoFormatUsing( const char *source, const char *message, va_list args );
+	
+	/** \brief Log warning message. */
+	virtual void LogWarn( const char *source, const char *message );
+	
+	/** \brief Log formatted warning message. */
+	virtual void LogWarnFormat( const char *source, const char *message, ... )
+		#ifdef __GNUC__
+		__attribute__ ((format (printf, 3, 4)))
+		#endif
+		;
+	
+	/** \brief Log formatted warning message. */
+	virtual void LogWarnFormatUsing( const char *source, const char *message, va_list args );
+	
+	/** \brief Log error message and write all pending messages. */
+	virtual void LogError( const char *source, const char *message );
+	
+	/** \brief Log formatted error message and write all pending messages. */
+	virtual void LogErrorFormat( const char *source, const char *message, ... )
+		#ifdef __GNUC__
+		__attribute__ ((format (printf, 3, 4)))
+		#endif
+		;
+	
+	/** \brief Log formatted error message and write all pending messages. */
+	virtual void LogErrorFormatUsing( const char *source, const char *message, va_list args );
+	
+	/** \brief Log exception error message and write all pending messages. */
+	virtual void LogException( const char *source, const deException &exception );
+	/*@}*/
+	
+	
+	
+private:
+	void pPush( eMessageTypes type, const char *source, const char *message, int length );
+	void pPushFormat( eMessageTypes type, const char *source, const char *format, va_list args );
+};
+
+#endif
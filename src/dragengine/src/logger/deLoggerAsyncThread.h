@@ -0,0 +1,73 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DELOGGERASYNCTHREAD_H_
+#define _DELOGGERASYNCTHREAD_H_
+
+#include "../threading/deMutex.h"
+#include "../threading/deThread.h"
+
+class deLoggerAsync;
+class deSemaphore;
+
+
+/**
+ * \brief Writer thread of asynchronous logger.
+ * 
+ * Waits for messages to be queued and drains the queue of the logger.
+ */
+class deLoggerAsyncThread : public deThread{
+private:
+	deLoggerAsync &pLogger;
+	deSemaphore &pSemaphore;
+	
+	deMutex pMutexExit;
+	bool pExitThread;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create writer thread.
+	 * \param[in] logger Logger to drain.
+	 * \param[in] semaphore Semaphore signaled if messages are pending.
+	 */
+	deLoggerAsyncThread( deLoggerAsync &logger, deSemaphore &semaphore );
+	
+	/** \brief Clean up writer thread. */
+	virtual ~deLoggerAsyncThread();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Request the thread to exit. Caller has to signal the semaphore afterwards. */
+	void RequestExit();
+	
+	/** \brief Run function of the thread. */
+	virtual void Run();
+	/*@}*/
+};
+
+#endif
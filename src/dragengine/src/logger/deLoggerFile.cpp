@@ -28,6 +28,7 @@
 #include "../common/file/decBaseFileWriter.h"
 #include "../common/exceptions.h"
 #include "../common/string/decString.h"
+#include "../threading/deMutexGuard.h"
 
 
 
@@ -38,7 +39,8 @@
 ////////////////////////////
 
 deLoggerFile::deLoggerFile( decBaseFileWriter *writer ) :
-pWriter( NULL )
+pWriter( NULL ),
+pFlushEachMessage( true )
 {
 	if( ! writer ){
 		DETHROW( deeInvalidParam );
@@ -59,6 +61,18 @@ deLoggerFile::~deLoggerFile(){
 // Management
 ///////////////
 
+void deLoggerFile::SetFlushEachMessage( bool flushEachMessage ){
+	deMutexGuard lock( pMutex );
+	pFlushEachMessage = flushEachMessage;
+}
+
+void deLoggerFile::Flush(){
+	deMutexGuard lock( pMutex );
+	fflush( NULL );
+}
+
+
+
 void deLoggerFile::LogInfo( const char *source, const char *message ){
 	if( ! source || ! message ){
 		DETHROW( deeInvalidParam );
@@ -78,7 +92,9 @@ void deLoggerFile::LogInfo( const char *source, const char *message ){
 	
 	try{
 		pWriter->Write( string.GetString(), string.GetLength() );
-		fflush( NULL );
+		if( pFlushEachMessage ){
+			fflush( NULL );
+		}
 		
 		pMutex.Unlock();
 		
@@ -107,7 +123,9 @@ void deLoggerFile::LogWarn( const char *source, const char *message ){
 	
 	try{
 		pWriter->Write( string.GetString(), string.GetLength() );
-		fflush( NULL );
+		if( pFlushEachMessage ){
+			fflush( NULL );
+		}
 		
 		pMutex.Unlock();
 		
@@ -136,7 +154,9 @@ void deLoggerFile::LogError( const char *source, const char *message ){
 	
 	try{
 		pWriter->Write( string.GetString(), string.GetLength() );
-		fflush( NULL );
+		if( pFlushEachMessage ){
+			fflush( NULL );
+		}
 		
 		pMutex.Unlock();
 		
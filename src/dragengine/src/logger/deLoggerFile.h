@@ -36,13 +36,16 @@ class decBaseFileWriter;
  * the file logger is freed.
  * 
  * \note Logger console is thread safe. To avoid torn logs the entire text line is
- * formated in memory and send as one write call then fflush is called.
+ * formated in memory and send as one write call then fflush is called unless
+ * flushing each message is disabled. deLoggerAsync disables it and calls Flush()
+ * once per batch of written messages.
  * Be careful with the use of the file writer outside the logger. deObject
  * reference counting is not thread safe.
  */
 class deLoggerFile : public deLogger{
 private:
 	decBaseFileWriter *pWriter;
+	bool pFlushEachMessage;
 	deMutex pMutex;
 	
 	
@@ -71,6 +74,19 @@ public:
 	/** \brief File writer. */
 	inline decBaseFileWriter *GetWriter() const{ return pWriter; }
 	
+	/** \brief Flush after writing each message. */
+	inline bool GetFlushEachMessage() const{ return pFlushEachMessage; }
+	
+	/**
+	 * \brief Set if flush is called after writing each message.
+	 * 
+	 * If disabled Flush() has to be called after writing a batch of messages.
+	 */
+	void SetFlushEachMessage( bool flushEachMessage );
+	
+	/** \brief Flush written messages. */
+	void Flush();
+	
 	
 	
 	/** \brief Log information message. */
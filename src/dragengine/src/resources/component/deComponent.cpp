@@ -75,6 +75,8 @@ pVisible( true ),
 pHintMovement( emhStationary ),
 
 pBones( NULL ),
+pBoneOrder( NULL ),
+pBoneUpdated( NULL ),
 pBoneCount( 0 ),
 
 pBonesDirty( true ),
@@ -683,17 +685,7 @@ void deComponent::PrepareMatrix(){
 
 void deComponent::PrepareBones(){
 	WaitAnimatorTaskFinished();
-	
-	if( ! pBonesDirty ){
-		return;
-	}
-	
-	int i;
-	for( i=0; i<pBoneCount; i++ ){
-		pUpdateBoneAt( i );
-	}
-	
-	pBonesDirty = false;
+	pPrepareBones();
 }
 
 
@@ -831,11 +823,42 @@ void deComponent::pCleanUp(){
 	if( pTextures ){
 		delete [] pTextures;
 	}
+	if( pBoneUpdated ){
+		delete [] pBoneUpdated;
+	}
+	if( pBoneOrder ){
+		delete [] pBoneOrder;
+	}
 	if( pBones ){
 		delete [] pBones;
 	}
 }
 
+void deComponent::pPrepareBones(){
+	if( ! pBonesDirty ){
+		return;
+	}
+	
+	// bones are visited parent first. a bone is updated if its state changed or if the
+	// parent bone has been updated. unchanged subtrees keep their matrices
+	int i;
+	for( i=0; i<pBoneCount; i++ ){
+		const int index = pBoneOrder[ i ];
+		const deComponentBone &bone = pBones[ index ];
+		const int parent = bone.GetParentBone();
+		
+		if( bone.GetDirtyMatrix() || ( parent != -1 && pBoneUpdated[ parent ] ) ){
+			pUpdateBoneAt( index );
+			pBoneUpdated[ index ] = true;
+			
+		}else{
+			pBoneUpdated[ index ] = false;
+		}
+	}
+	
+	pBonesDirty = false;
+}
+
 void deComponent::pUpdateBoneAt( int bone ){
 	deComponentBone &cbone = pBones[ bone ];
 	
@@ -847,7 +870,7 @@ void deComponent::pUpdateBoneAt( int bone ){
 		matrix = matrix.QuickMultiply( pBones[ cbone.GetParentBone() ].GetMatrix() );
 	}
 	
-	cbone.SetMatrix( matrix );
+	cbone.UpdateMatrix( matrix );
 }
 
 void deComponent::pChangeModel( deModel *model ){
@@ -887,6 +910,9 @@ void deComponent::pChangeRig( deRig *rig ){
 	
 	// create new bones array
 	deComponentBone *bones = NULL;
+	int *boneOrder = NULL;
+	bool *boneUpdated = NULL;
+	int *boneDepth = NULL;
 	int i, boneCount = 0;
 	
 	if( rig ){
@@ -894,14 +920,55 @@ void deComponent::pChangeRig( deRig *rig ){
 			boneCount = rig->GetBoneCount();
 			if( boneCount > 0 ){
 				bones = new deComponentBone[ boneCount ];
+				boneOrder = new int[ boneCount ];
+				boneUpdated = new bool[ boneCount ];
+				boneDepth = new int[ boneCount ];
+				
+				int maxDepth = 0;
+				
 				for( i=0; i<boneCount; i++ ){
 					const deRigBone &bone = rig->GetBoneAt( i );
 					bones[ i ].SetParentBone( bone.GetParent() );
 					bones[ i ].SetOriginalMatrix( bone.GetPosition(), bone.GetRotation() );
+					boneUpdated[ i ] = false;
+					
+					int depth = 0;
+					int parent = bone.GetParent();
+					while( parent != -1 && depth < boneCount ){
+						parent = rig->GetBoneAt( parent ).GetParent();
+						depth++;
+					}
+					boneDepth[ i ] = depth;
+					if( depth > maxDepth ){
+						maxDepth = depth;
+					}
 				}
+				
+				// sort bones by depth to get a parent first update order. bones with the
+				// same depth keep their rig order
+				int next = 0, depth;
+				for( depth=0; depth<=maxDepth; depth++ ){
+					for( i=0; i<boneCount; i++ ){
+						if( boneDepth[ i ] == depth ){
+							boneOrder[ next++ ] = i;
+						}
+					}
+				}
+				
+				delete [] boneDepth;
+				boneDepth = NULL;
 			}
 			
 		}catch( const deException & ){
+			if( boneDepth ){
+				delete [] boneDepth;
+			}
+			if( boneUpdated ){
+				delete [] boneUpdated;
+			}
+			if( boneOrder ){
+				delete [] boneOrder;
+			}
 			if( bones ){
 				delete [] bones;
 			}
@@ -909,10 +976,18 @@ void deComponent::pChangeRig( deRig *rig ){
 		}
 	}
 	
+	if( pBoneUpdated ){
+		delete [] pBoneUpdated;
+	}
+	if( pBoneOrder ){
+		delete [] pBoneOrder;
+	}
 	if( pBones ){
 		delete [] pBones;
 	}
 	pBones = bones;
+	pBoneOrder = boneOrder;
+	pBoneUpdated = boneUpdated;
 	pBoneCount = boneCount;
 	
 	pRig = rig;
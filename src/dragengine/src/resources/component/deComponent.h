@@ -92,6 +92,8 @@ private:
 	decLayerMask pLayerMask;
 	
 	deComponentBone *pBones;
+	int *pBoneOrder;
+	bool *pBoneUpdated;
 	int pBoneCount;
 	
 	bool pBonesDirty;
@@ -284,9 +286,17 @@ public:
 	/** \brief Prepare matrices. */
 	void PrepareMatrix();
 	
-	/** \brief Prepare bone matrices. */
+	/**
+	 * \brief Prepare bone matrices.
+	 * 
+	 * Bones are updated in parent first order. Only bones with dirty matrix and their
+	 * child bones are updated.
+	 */
 	void PrepareBones();
 	
+	/** \brief Bone matrices have to be prepared. */
+	inline bool GetBonesDirty() const{ return pBonesDirty; }
+	
 	/*@}*/
 	
 	
@@ -449,7 +459,10 @@ public:
 	
 	
 private:
+	friend class deComponentBonesTask;
+	
 	void pCleanUp();
+	void pPrepareBones();
 	void pUpdateBoneAt( int bone );
 	void pChangeModel( deModel *model );
 	void pChangeRig( deRig *rig );
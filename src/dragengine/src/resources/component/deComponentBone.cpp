@@ -37,7 +37,8 @@
 deComponentBone::deComponentBone() :
 pParentBone( 0 ),
 pScale( 1.0f, 1.0f, 1.0f ),
-pDirtyInvMatrix( true ){
+pDirtyInvMatrix( true ),
+pDirtyMatrix( true ){
 }
 
 deComponentBone::~deComponentBone(){
@@ -49,20 +50,37 @@ deComponentBone::~deComponentBone(){
 ///////////////
 
 void deComponentBone::SetPosition( const decVector &position ){
-	pPosition = position;
+	if( position.x != pPosition.x || position.y != pPosition.y || position.z != pPosition.z ){
+		pPosition = position;
+		pDirtyMatrix = true;
+	}
 }
 
 void deComponentBone::SetRotation( const decQuaternion &rotation ){
-	pRotation = rotation;
+	if( rotation.x != pRotation.x || rotation.y != pRotation.y
+	|| rotation.z != pRotation.z || rotation.w != pRotation.w ){
+		pRotation = rotation;
+		pDirtyMatrix = true;
+	}
 }
 
 void deComponentBone::SetScale( const decVector &scale ){
-	pScale = scale;
+	if( scale.x != pScale.x || scale.y != pScale.y || scale.z != pScale.z ){
+		pScale = scale;
+		pDirtyMatrix = true;
+	}
 }
 
 void deComponentBone::SetMatrix( const decMatrix &matrix ){
 	pMatrix = matrix;
 	pDirtyInvMatrix = true;
+	pDirtyMatrix = true;
+}
+
+void deComponentBone::UpdateMatrix( const decMatrix &matrix ){
+	pMatrix = matrix;
+	pDirtyInvMatrix = true;
+	pDirtyMatrix = false;
 }
 
 const decMatrix &deComponentBone::GetInverseMatrix(){
@@ -77,8 +95,10 @@ const decMatrix &deComponentBone::GetInverseMatrix(){
 void deComponentBone::SetOriginalMatrix( const decVector &position, const decVector &rotation ){
 	pOrgMatrix.SetRT( rotation, position );
 	pInvOrgMatrix = pOrgMatrix.Invert();
+	pDirtyMatrix = true;
 }
 
 void deComponentBone::SetParentBone( int parentBone ){
 	pParentBone = parentBone;
+	pDirtyMatrix = true;
 }
@@ -46,6 +46,7 @@ private:
 	decMatrix pMatrix;
 	decMatrix pInvMatrix;
 	bool pDirtyInvMatrix;
+	bool pDirtyMatrix;
 	
 	
 	
@@ -104,6 +105,20 @@ public:
 	 */
 	const decMatrix &GetInverseMatrix();
 	
+	/**
+	 * \brief Matrix has to be calculated from the bone state.
+	 * 
+	 * Set if position, rotation, scale, original matrix or parent bone changed or the
+	 * matrix has been set using SetMatrix(). Cleared by UpdateMatrix().
+	 */
+	inline bool GetDirtyMatrix() const{ return pDirtyMatrix; }
+	
+	/**
+	 * \brief Set matrix calculated from the bone state.
+	 * \warning For internal use only. Used by deComponent::PrepareBones().
+	 */
+	void UpdateMatrix( const decMatrix &matrix );
+	
 	/** \brief Original matrix relative to the rig bone parent. */
 	inline const decMatrix &GetOriginalMatrix() const{ return pOrgMatrix; }
 	
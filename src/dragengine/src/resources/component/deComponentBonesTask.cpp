@@ -0,0 +1,103 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "deComponent.h"
+#include "deComponentBonesTask.h"
+#include "../../common/exceptions.h"
+
+
+
+// Class deComponentBonesTask
+///////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+deComponentBonesTask::deComponentBonesTask() :
+deParallelTask( NULL ),
+pBoneCount( 0 ),
+pFailed( false ){
+}
+
+deComponentBonesTask::~deComponentBonesTask(){
+}
+
+
+
+// Management
+///////////////
+
+int deComponentBonesTask::GetComponentCount() const{
+	return pComponents.GetCount();
+}
+
+deComponent *deComponentBonesTask::GetComponentAt( int index ) const{
+	return ( deComponent* )pComponents.GetAt( index );
+}
+
+void deComponentBonesTask::AddComponent( deComponent *component ){
+	if( ! component ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pComponents.Add( component );
+	pBoneCount += component->GetBoneCount();
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void deComponentBonesTask::Run(){
+	// animator tasks have been waited for by the caller. PrepareBones() can not be used
+	// since waiting for tasks is only allowed on the main thread
+	try{
+		const int count = pComponents.GetCount();
+		int i;
+		for( i=0; i<count; i++ ){
+			( ( deComponent* )pComponents.GetAt( i ) )->pPrepareBones();
+		}
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void deComponentBonesTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString deComponentBonesTask::GetDebugName() const{
+	return "ComponentBones";
+}
+
+decString deComponentBonesTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "components=%d bones=%d", pComponents.GetCount(), pBoneCount );
+	return details;
+}
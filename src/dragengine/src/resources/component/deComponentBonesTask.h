@@ -0,0 +1,103 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DECOMPONENTBONESTASK_H_
+#define _DECOMPONENTBONESTASK_H_
+
+#include "../../common/collection/decPointerList.h"
+#include "../../parallel/deParallelTask.h"
+
+class deComponent;
+
+
+
+/**
+ * \brief Parallel task preparing bones of components.
+ * 
+ * Used by deWorld to prepare the bones of components in parallel before peers access
+ * them. Components are grouped by rig so a task works on the same rig data. Animator
+ * tasks of the components have to be finished before the task is added. If an exception
+ * is thrown the task is marked failed and the caller has to prepare the bones.
+ */
+class deComponentBonesTask : public deParallelTask{
+private:
+	decPointerList pComponents;
+	int pBoneCount;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create task. */
+	deComponentBonesTask();
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~deComponentBonesTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of components. */
+	int GetComponentCount() const;
+	
+	/** \brief Component at index. */
+	deComponent *GetComponentAt( int index ) const;
+	
+	/** \brief Add component. Component has to stay valid until the task finished. */
+	void AddComponent( deComponent *component );
+	
+	/** \brief Number of bones of all components. */
+	inline int GetBoneCount() const{ return pBoneCount; }
+	
+	/** \brief Preparing bones failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
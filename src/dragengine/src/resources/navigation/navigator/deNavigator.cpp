@@ -25,6 +25,7 @@
 
 #include "deNavigator.h"
 #include "deNavigatorPath.h"
+#include "deNavigatorPathQuery.h"
 #include "deNavigatorManager.h"
 #include "deNavigatorType.h"
 #include "../space/deNavigationSpace.h"
@@ -297,6 +298,25 @@ void deNavigator::FindPath( deNavigatorPath &path, const decDVector &start, cons
 	}
 }
 
+void deNavigator::FindPathAsync( deNavigatorPathQuery *query ){
+	if( ! query ){
+		DETHROW( deeNullPointer );
+	}
+	if( query->GetState() == deNavigatorPathQuery::esPending ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	query->SetState( deNavigatorPathQuery::esPending );
+	
+	if( pPeerAI ){
+		pPeerAI->FindPathAsync( *query );
+		
+	}else{
+		query->GetPath().RemoveAll();
+		query->SetState( deNavigatorPathQuery::esFinished );
+	}
+}
+
 
 
 // Testing
@@ -31,6 +31,7 @@ class deBaseAINavigator;
 class deNavigatorManager;
 class deNavigatorType;
 class deNavigatorPath;
+class deNavigatorPathQuery;
 class deWorld;
 
 
@@ -180,6 +181,19 @@ public:
 	 * \param[in] goal Goal position of path.
 	 */
 	void FindPath( deNavigatorPath &path, const decDVector &start, const decDVector &goal );
+	
+	/**
+	 * \brief Find path asynchronously.
+	 * 
+	 * Submits query to the AI module. The query state is set to pending. The AI module
+	 * processes pending queries in batches and stores the result in the query, usually
+	 * during one of the next frame updates. Check the query state to know when the path
+	 * is valid. Without AI peer the query finishes immediately with an empty path.
+	 * 
+	 * \throws deeNullPointer \em query is NULL.
+	 * \throws deeInvalidParam \em query is pending.
+	 */
+	void FindPathAsync( deNavigatorPathQuery *query );
 	/*@}*/
 	
 	
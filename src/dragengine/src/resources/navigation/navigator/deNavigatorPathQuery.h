@@ -0,0 +1,129 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DENAVIGATORPATHQUERY_H_
+#define _DENAVIGATORPATHQUERY_H_
+
+#include "deNavigatorPath.h"
+#include "../../../deObject.h"
+#include "../../../common/math/decMath.h"
+
+
+/**
+ * \brief Navigator path query.
+ * 
+ * Finds a path asynchronously using deNavigator::FindPathAsync(). The AI module processes
+ * the query in the background and stores the result once finished. This is usually during
+ * one of the next frame updates. Check GetState() to know when the path is valid.
+ * 
+ * The query can be reused after it finished or has been cancelled. Submitting a pending
+ * query again throws an exception.
+ */
+class deNavigatorPathQuery : public deObject{
+public:
+	/** \brief Query state. */
+	enum eStates{
+		/** \brief Query has not been submitted yet. */
+		esIdle,
+		
+		/** \brief Query has been submitted and is waiting for the result. */
+		esPending,
+		
+		/** \brief Query finished. Path is valid. */
+		esFinished,
+		
+		/** \brief Query has been cancelled. */
+		esCancelled
+	};
+	
+	
+	
+private:
+	decDVector pStart;
+	decDVector pGoal;
+	deNavigatorPath pPath;
+	eStates pState;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create navigator path query. */
+	deNavigatorPathQuery( const decDVector &start, const decDVector &goal );
+	
+protected:
+	/**
+	 * \brief Clean up navigator path query.
+	 * \note Subclasses should set their destructor protected too to avoid users
+	 * accidently deleting a reference counted object through the object
+	 * pointer. Only FreeReference() is allowed to delete the object.
+	 */
+	virtual ~deNavigatorPathQuery();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Start position. */
+	inline const decDVector &GetStart() const{ return pStart; }
+	
+	/**
+	 * \brief Set start position.
+	 * \throws deeInvalidAction Query is pending.
+	 */
+	void SetStart( const decDVector &start );
+	
+	/** \brief Goal position. */
+	inline const decDVector &GetGoal() const{ return pGoal; }
+	
+	/**
+	 * \brief Set goal position.
+	 * \throws deeInvalidAction Query is pending.
+	 */
+	void SetGoal( const decDVector &goal );
+	
+	/** \brief Path. Valid only if state is esFinished. */
+	inline deNavigatorPath &GetPath(){ return pPath; }
+	inline const deNavigatorPath &GetPath() const{ return pPath; }
+	
+	/** \brief State. */
+	inline eStates GetState() const{ return pState; }
+	
+	/**
+	 * \brief Set state.
+	 * \note For use by deNavigator and the AI module only.
+	 */
+	void SetState( eStates state );
+	
+	/**
+	 * \brief Cancel query if pending.
+	 * 
+	 * The AI module drops the query the next time it processes queries. The path is
+	 * not modified anymore.
+	 */
+	void Cancel();
+	/*@}*/
+};
+
+#endif
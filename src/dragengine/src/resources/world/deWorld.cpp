@@ -25,10 +25,12 @@
 
 #include "deWorld.h"
 #include "deWorldManager.h"
+#include "deWorldPeerUpdateTask.h"
 #include "../billboard/deBillboard.h"
 #include "../camera/deCamera.h"
 #include "../collider/deCollider.h"
 #include "../component/deComponent.h"
+#include "../component/deComponentBonesTask.h"
 #include "../debug/deDebugDrawer.h"
 #include "../forcefield/deForceField.h"
 #include "../light/deLight.h"
@@ -49,6 +51,12 @@
 #include "../probe/deEnvMapProbe.h"
 #include "../../deEngine.h"
 #include "../../common/exceptions.h"
+#include "../../common/collection/decPointerList.h"
+#include "../../common/collection/decThreadSafeObjectOrderedSet.h"
+#include "../../common/utils/decTimer.h"
+#include "../../logger/deLogger.h"
+#include "../../parallel/deParallelProcessing.h"
+#include "../../threading/deThreadSafeObjectReference.h"
 #include "../../systems/modules/ai/deBaseAIWorld.h"
 #include "../../systems/modules/audio/deBaseAudioWorld.h"
 #include "../../systems/modules/graphic/deBaseGraphicWorld.h"
@@ -57,6 +65,21 @@
 
 
 
+// Definitions
+////////////////
+
+// minimum number of dirty component bones to prepare bones in parallel
+#define PARALLEL_COMPONENT_BONE_COUNT 512
+
+// sort components by rig to group them into tasks
+static int fCompareComponentRig( const void *a, const void *b ){
+	const deRig * const rigA = ( *( ( deComponent * const * )a ) )->GetRig();
+	const deRig * const rigB = ( *( ( deComponent * const * )b ) )->GetRig();
+	return rigA < rigB ? -1 : ( rigA > rigB ? 1 : 0 );
+}
+
+
+
 // Class deWorld
 //////////////////
 
@@ -159,7 +182,12 @@ pPeerGraphic ( NULL ),
 pPeerPhysics ( NULL ),
 pPeerAudio ( NULL ),
 pPeerNetwork ( NULL ),
-pPeerAI( NULL ){
+pPeerAI( NULL )
+{
+	int i;
+	for( i=0; i<=eptAI; i++ ){
+		pPeerUpdateTimes[ i ] = 0.0f;
+	}
 }
 
 deWorld::~deWorld(){
@@ -202,52 +230,75 @@ void deWorld::Clear(){
 	RemoveAllSkies();
 }
 
-// #define DO_SPECIAL_DEBUG
-#ifdef DO_SPECIAL_DEBUG
-	#include "../../common/utils/decTimer.h"
-	#include "../../logger/deLogger.h"
-	static decTimer timer;
-#endif
 void deWorld::Update( float elapsed ){
-	#ifdef DO_SPECIAL_DEBUG
-	unsigned int elapsedGra = 0;
-	unsigned int elapsedPhy = 0;
-	unsigned int elapsedAud = 0;
-	unsigned int elapsedAI = 0;
-	timer.Reset();
-	#endif
+	pPrepareComponentBones();
+	
+	// peers supporting it are updated using parallel tasks if enabled in the engine. the
+	// other peers are updated in the regular order meanwhile. parallel processing is paused
+	// if the engine is in progress of being stopped. update all peers directly in this case
+	deParallelProcessing &parallelProcessing = GetEngine()->GetParallelProcessing();
+	const bool useTasks = GetEngine()->GetParallelWorldUpdate()
+		&& parallelProcessing.GetCoreCount() > 1 && ! parallelProcessing.GetPaused();
+	decThreadSafeObjectOrderedSet tasks;
+	deThreadSafeObjectReference task;
+	bool parallelPeers[ eptAI + 1 ];
+	int i;
+	
+	for( i=0; i<=eptAI; i++ ){
+		parallelPeers[ i ] = useTasks && pSupportsParallelUpdate( ( ePeerTypes )i );
+	}
+	
+	try{
+		for( i=0; i<=eptAI; i++ ){
+			if( parallelPeers[ i ] ){
+				task.TakeOver( new deWorldPeerUpdateTask( *this, ( ePeerTypes )i, elapsed ) );
+				tasks.Add( task );
+				parallelProcessing.AddTask( ( deWorldPeerUpdateTask* )( deThreadSafeObject* )task );
+			}
+		}
+		
+		for( i=0; i<=eptAI; i++ ){
+			if( ! parallelPeers[ i ] ){
+				pUpdatePeer( ( ePeerTypes )i, elapsed );
+			}
+		}
+		
+	}catch( const deException & ){
+		const int count = tasks.GetCount();
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( deWorldPeerUpdateTask* )tasks.GetAt( i ) );
+		}
+		throw;
+	}
 	
-	if( pPeerGraphic ){
-		pPeerGraphic->Update( elapsed );
-		#ifdef DO_SPECIAL_DEBUG
-		elapsedGra = ( unsigned int )( (double)timer.GetElapsedTime() * 1e6 );
-		#endif
+	const int count = tasks.GetCount();
+	for( i=0; i<count; i++ ){
+		parallelProcessing.WaitForTask( ( deWorldPeerUpdateTask* )tasks.GetAt( i ) );
 	}
-	if( pPeerPhysics ){
-		pPeerPhysics->Update( elapsed );
-		#ifdef DO_SPECIAL_DEBUG
-		elapsedPhy = ( unsigned int )( (double)timer.GetElapsedTime() * 1e6 );
-		#endif
+	
+	// failed tasks logged the exception already. updating the peer again is not possible
+	// since the peer is potentially left partially updated
+	for( i=0; i<count; i++ ){
+		if( ( ( deWorldPeerUpdateTask* )tasks.GetAt( i ) )->GetFailed() ){
+			DETHROW_INFO( deeInvalidAction, "parallel world peer update failed" );
+		}
 	}
-	if( pPeerAudio ){
-		pPeerAudio->Update( elapsed );
-		#ifdef DO_SPECIAL_DEBUG
-		elapsedAud = ( unsigned int )( (double)timer.GetElapsedTime() * 1e6 );
-		#endif
+	
+	if( GetEngine()->GetLogWorldPeerUpdateTimes() ){
+		GetEngine()->GetLogger()->LogInfoFormat( "Dragengine",
+			"deWorld Update: Graphic %iys Physics %iys Audio %iys AI %iys",
+			( int )( pPeerUpdateTimes[ eptGraphic ] * 1e6f ),
+			( int )( pPeerUpdateTimes[ eptPhysics ] * 1e6f ),
+			( int )( pPeerUpdateTimes[ eptAudio ] * 1e6f ),
+			( int )( pPeerUpdateTimes[ eptAI ] * 1e6f ) );
 	}
-	if( pPeerAI ){
-		pPeerAI->Update( elapsed );
-		#ifdef DO_SPECIAL_DEBUG
-		elapsedAI = ( unsigned int )( (double)timer.GetElapsedTime() * 1e6 );
-		#endif
+}
+
+float deWorld::GetPeerUpdateTime( ePeerTypes peer ) const{
+	if( peer < eptGraphic || peer > eptAI ){
+		DETHROW( deeInvalidParam );
 	}
-	
-	#ifdef DO_SPECIAL_DEBUG
-	GetEngine()->GetLogger()->LogInfoFormat( "Dragengine", "deWorld Update Gra %iys", elapsedGra );
-	GetEngine()->GetLogger()->LogInfoFormat( "Dragengine", "deWorld Update Phy %iys", elapsedPhy );
-	GetEngine()->GetLogger()->LogInfoFormat( "Dragengine", "deWorld Update Aud %iys", elapsedAud );
-	GetEngine()->GetLogger()->LogInfoFormat( "Dragengine", "deWorld Update AI %iys", elapsedAI );
-	#endif
+	return pPeerUpdateTimes[ peer ];
 }
 
 void deWorld::ProcessPhysics( float elapsed ){
@@ -2052,6 +2103,154 @@ void deWorld::pCleanUp(){
 
 
 
+void deWorld::pPrepareComponentBones(){
+	// prepare bones of components with dirty bones in parallel before the peers access
+	// them. components using the same rig are put into the same task. if not worth the
+	// effort peers prepare bones on demand like before
+	deParallelProcessing &parallelProcessing = GetEngine()->GetParallelProcessing();
+	if( parallelProcessing.GetCoreCount() < 2 || parallelProcessing.GetPaused() ){
+		return;
+	}
+	
+	decPointerList components;
+	int boneCount = 0;
+	
+	deComponent *component = pComponentRoot;
+	while( component ){
+		if( component->GetBoneCount() > 0 && component->GetBonesDirty() ){
+			components.Add( component );
+			boneCount += component->GetBoneCount();
+		}
+		component = component->GetLLWorldNext();
+	}
+	
+	if( boneCount < PARALLEL_COMPONENT_BONE_COUNT ){
+		return;
+	}
+	
+	const int taskBoneCount = decMath::max( PARALLEL_COMPONENT_BONE_COUNT / 2,
+		boneCount / ( parallelProcessing.GetCoreCount() * 2 ) );
+	const int componentCount = components.GetCount();
+	decThreadSafeObjectOrderedSet tasks;
+	deThreadSafeObjectReference task;
+	deComponent **sorted = NULL;
+	int i, j;
+	
+	try{
+		// components with the same rig end up next to each other
+		sorted = new deComponent*[ componentCount ];
+		for( i=0; i<componentCount; i++ ){
+			sorted[ i ] = ( deComponent* )components.GetAt( i );
+		}
+		qsort( sorted, componentCount, sizeof( deComponent* ), fCompareComponentRig );
+		
+		for( i=0; i<componentCount; i++ ){
+			if( ! task ){
+				task.TakeOver( new deComponentBonesTask );
+			}
+			
+			// wait for running animator tasks only for components actually batched
+			sorted[ i ]->WaitAnimatorTaskFinished();
+			
+			deComponentBonesTask &bonesTask = *( ( deComponentBonesTask* )( deThreadSafeObject* )task );
+			bonesTask.AddComponent( sorted[ i ] );
+			
+			if( bonesTask.GetBoneCount() >= taskBoneCount ){
+				tasks.Add( task );
+				parallelProcessing.AddTask( &bonesTask );
+				task = NULL;
+			}
+		}
+		
+		if( task ){
+			tasks.Add( task );
+			parallelProcessing.AddTask( ( deComponentBonesTask* )( deThreadSafeObject* )task );
+			task = NULL;
+		}
+		
+		delete [] sorted;
+		sorted = NULL;
+		
+	}catch( const deException & ){
+		if( sorted ){
+			delete [] sorted;
+		}
+		
+		const int count = tasks.GetCount();
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( deComponentBonesTask* )tasks.GetAt( i ) );
+		}
+		throw;
+	}
+	
+	const int count = tasks.GetCount();
+	for( i=0; i<count; i++ ){
+		parallelProcessing.WaitForTask( ( deComponentBonesTask* )tasks.GetAt( i ) );
+	}
+	
+	for( i=0; i<count; i++ ){
+		const deComponentBonesTask &bonesTask = *( ( deComponentBonesTask* )tasks.GetAt( i ) );
+		if( ! bonesTask.GetFailed() ){
+			continue;
+		}
+		
+		const int taskComponentCount = bonesTask.GetComponentCount();
+		for( j=0; j<taskComponentCount; j++ ){
+			bonesTask.GetComponentAt( j )->PrepareBones();
+		}
+	}
+}
+
+void deWorld::pUpdatePeer( ePeerTypes peer, float elapsed ){
+	decTimer timer;
+	
+	switch( peer ){
+	case eptGraphic:
+		if( pPeerGraphic ){
+			pPeerGraphic->Update( elapsed );
+		}
+		break;
+		
+	case eptPhysics:
+		if( pPeerPhysics ){
+			pPeerPhysics->Update( elapsed );
+		}
+		break;
+		
+	case eptAudio:
+		if( pPeerAudio ){
+			pPeerAudio->Update( elapsed );
+		}
+		break;
+		
+	case eptAI:
+		if( pPeerAI ){
+			pPeerAI->Update( elapsed );
+		}
+		break;
+	}
+	
+	pPeerUpdateTimes[ peer ] = timer.GetElapsedTime();
+}
+
+bool deWorld::pSupportsParallelUpdate( ePeerTypes peer ) const{
+	switch( peer ){
+	case eptGraphic:
+		return pPeerGraphic && pPeerGraphic->SupportsParallelUpdate();
+		
+	case eptPhysics:
+		return pPeerPhysics && pPeerPhysics->SupportsParallelUpdate();
+		
+	case eptAudio:
+		return pPeerAudio && pPeerAudio->SupportsParallelUpdate();
+		
+	case eptAI:
+		return pPeerAI && pPeerAI->SupportsParallelUpdate();
+	}
+	
+	return false;
+}
+
 void deWorld::pNotifyPhysicsChanged(){
 	if( pPeerPhysics ){
 		pPeerPhysics->PhysicsChanged();
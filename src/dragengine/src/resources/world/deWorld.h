@@ -67,6 +67,24 @@ class deBaseAIWorld;
  * able to do collision detection and physical responses to them.
  */
 class deWorld : public deResource{
+public:
+	/** \brief World peer types. */
+	enum ePeerTypes{
+		/** \brief Graphic peer. */
+		eptGraphic,
+		
+		/** \brief Physics peer. */
+		eptPhysics,
+		
+		/** \brief Audio peer. */
+		eptAudio,
+		
+		/** \brief AI peer. */
+		eptAI
+	};
+	
+	
+	
 private:
 	deHeightTerrain *pHeightTerrain;
 	decDVector pSize;
@@ -168,6 +186,8 @@ private:
 	deBaseNetworkWorld *pPeerNetwork;
 	deBaseAIWorld *pPeerAI;
 	
+	float pPeerUpdateTimes[ eptAI + 1 ];
+	
 	
 	
 public:
@@ -238,10 +258,20 @@ public:
 	 * This is to avoid slowing the engine down if a huge amount of
 	 * objects are in the world.
 	 * 
+	 * If parallel world updates are enabled in the engine peers supporting parallel
+	 * updates are updated using parallel tasks while the other peers are updated.
+	 * Returns after all peers finished updating. Peers returning true from
+	 * SupportsParallelUpdate() have their Update() called from a parallel task. While
+	 * updating they must not access engine resources modified by the other world peers
+	 * nor add or wait for parallel tasks. Peers do not support parallel updates by default.
+	 * 
 	 * \param elapsed Seconds elapsed since the last update
 	 */
 	void Update( float elapsed );
 	
+	/** \brief Time in seconds the peer took during the last call to Update(). */
+	float GetPeerUpdateTime( ePeerTypes peer ) const;
+	
 	/**
 	 * \brief Process physics simulation using the physics module.
 	 * 
@@ -938,8 +968,13 @@ public:
 	
 private:
 	void pCleanUp();
+	void pPrepareComponentBones();
+	void pUpdatePeer( ePeerTypes peer, float elapsed );
+	bool pSupportsParallelUpdate( ePeerTypes peer ) const;
 	void pNotifyPhysicsChanged();
 	void pNotifyLightingChanged();
+	
+	friend class deWorldPeerUpdateTask;
 };
 
 #endif
@@ -0,0 +1,82 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "deWorldPeerUpdateTask.h"
+#include "../../deEngine.h"
+#include "../../common/exceptions.h"
+#include "../../logger/deLogger.h"
+
+
+
+// Class deWorldPeerUpdateTask
+////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+deWorldPeerUpdateTask::deWorldPeerUpdateTask( deWorld &world, deWorld::ePeerTypes peer, float elapsed ) :
+deParallelTask( NULL ),
+pWorld( world ),
+pPeer( peer ),
+pElapsed( elapsed ),
+pFailed( false ){
+}
+
+deWorldPeerUpdateTask::~deWorldPeerUpdateTask(){
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void deWorldPeerUpdateTask::Run(){
+	// loggers are thread safe. the exception is logged here since it can not be rethrown
+	// across threads. the world fails the update after all tasks finished
+	try{
+		pWorld.pUpdatePeer( pPeer, pElapsed );
+		
+	}catch( const deException &e ){
+		pWorld.GetEngine()->GetLogger()->LogException( "Dragengine", e );
+		pFailed = true;
+	}
+}
+
+void deWorldPeerUpdateTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString deWorldPeerUpdateTask::GetDebugName() const{
+	return "WorldPeerUpdate";
+}
+
+decString deWorldPeerUpdateTask::GetDebugDetails() const{
+	static const char * const peerNames[] = { "graphic", "physics", "audio", "ai" };
+	decString details;
+	details.Format( "peer=%s elapsed=%g", peerNames[ pPeer ], pElapsed );
+	return details;
+}
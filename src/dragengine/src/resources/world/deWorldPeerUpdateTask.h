@@ -0,0 +1,96 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEWORLDPEERUPDATETASK_H_
+#define _DEWORLDPEERUPDATETASK_H_
+
+#include "deWorld.h"
+#include "../../parallel/deParallelTask.h"
+
+
+
+/**
+ * \brief Parallel task updating a world peer.
+ * 
+ * Used by deWorld::Update() for world peers supporting parallel updates. If an exception
+ * is thrown it is logged and the task is marked failed.
+ */
+class deWorldPeerUpdateTask : public deParallelTask{
+private:
+	deWorld &pWorld;
+	deWorld::ePeerTypes pPeer;
+	float pElapsed;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create task.
+	 * \param[in] world World to update peer of. Has to stay valid until the task finished.
+	 * \param[in] peer Peer to update.
+	 * \param[in] elapsed Elapsed time in seconds.
+	 */
+	deWorldPeerUpdateTask( deWorld &world, deWorld::ePeerTypes peer, float elapsed );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~deWorldPeerUpdateTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Peer to update. */
+	inline deWorld::ePeerTypes GetPeer() const{ return pPeer; }
+	
+	/** \brief Updating failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "deBaseAINavigator.h"
 #include "../../../resources/navigation/navigator/deNavigatorPath.h"
+#include "../../../resources/navigation/navigator/deNavigatorPathQuery.h"
 
 
 // Class deBaseAINavigator
@@ -72,6 +73,11 @@ const decDVector &goal ){
 	path.RemoveAll();
 }
 
+void deBaseAINavigator::FindPathAsync( deNavigatorPathQuery &query ){
+	FindPath( query.GetPath(), query.GetStart(), query.GetGoal() );
+	query.SetState( deNavigatorPathQuery::esFinished );
+}
+
 bool deBaseAINavigator::PathCollideRay( const deNavigatorPath &path, deCollider &collider,
 int &hitAfterPoint, float &hitDistance ){
 	return false;
@@ -26,6 +26,7 @@
 
 class deCollider;
 class deNavigatorPath;
+class deNavigatorPathQuery;
 
 
 
@@ -106,6 +107,19 @@ public:
 	 */
 	virtual void FindPath( deNavigatorPath &path, const decDVector &start, const decDVector &goal );
 	
+	/**
+	 * \brief Find path asynchronously.
+	 * 
+	 * Query is in pending state. Once finished store the path in the query and set the
+	 * query state to finished. Queries cancelled while pending have to be dropped without
+	 * modifying them. The query is only allowed to be accessed from the main thread.
+	 * 
+	 * Default implementation calls FindPath() and finishes the query immediately.
+	 * 
+	 * \param[in] query Query to process.
+	 */
+	virtual void FindPathAsync( deNavigatorPathQuery &query );
+	
 	/**
 	 * \brief Test path for collision using ray test.
 	 * 
@@ -43,6 +43,10 @@ deBaseAIWorld::~deBaseAIWorld(){
 void deBaseAIWorld::Update( float elapsed ){
 }
 
+bool deBaseAIWorld::SupportsParallelUpdate() const{
+	return false;
+}
+
 
 
 void deBaseAIWorld::NavigationSpaceAdded( deNavigationSpace *navspace ){
@@ -49,6 +49,9 @@ public:
 	/** \brief Update world. */
 	virtual void Update( float elapsed );
 	
+	/** \brief Update() can run in parallel to other world peers. See deWorld::Update(). */
+	virtual bool SupportsParallelUpdate() const;
+	
 	/** \brief Navigation space has been added. */
 	virtual void NavigationSpaceAdded( deNavigationSpace *navspace );
 	
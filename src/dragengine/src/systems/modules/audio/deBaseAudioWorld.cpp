@@ -40,6 +40,10 @@ deBaseAudioWorld::~deBaseAudioWorld(){
 void deBaseAudioWorld::Update( float elapsed ){
 }
 
+bool deBaseAudioWorld::SupportsParallelUpdate() const{
+	return false;
+}
+
 void deBaseAudioWorld::SizeChanged(){
 }
 
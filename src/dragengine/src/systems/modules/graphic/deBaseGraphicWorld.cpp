@@ -40,6 +40,10 @@ deBaseGraphicWorld::~deBaseGraphicWorld(){
 void deBaseGraphicWorld::Update( float elapsed ){
 }
 
+bool deBaseGraphicWorld::SupportsParallelUpdate() const{
+	return false;
+}
+
 void deBaseGraphicWorld::SizeChanged(){
 }
 
@@ -43,6 +43,10 @@ deBasePhysicsWorld::~deBasePhysicsWorld(){
 void deBasePhysicsWorld::Update( float elapsed ){
 }
 
+bool deBasePhysicsWorld::SupportsParallelUpdate() const{
+	return false;
+}
+
 void deBasePhysicsWorld::ProcessPhysics( float elapsed ){
 }
 
@@ -65,6 +65,9 @@ public:
 	 */
 	virtual void Update( float elapsed );
 	
+	/** \brief Update() can run in parallel to other world peers. See deWorld::Update(). */
+	virtual bool SupportsParallelUpdate() const;
+	
 	/**
 	 * \brief Process physics simulation using the physics module.
 	 * 
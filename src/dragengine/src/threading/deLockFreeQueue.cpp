@@ -0,0 +1,110 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdlib.h>
+
+#include "deLockFreeQueue.h"
+#include "../common/exceptions.h"
+
+
+
+// Definitions
+////////////////
+
+// use lock-free operations if the compiler provides atomic builtins
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define DELOCKFREEQUEUE_ATOMIC 1
+#endif
+
+
+
+// Class deLockFreeQueue
+//////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deLockFreeQueue::deLockFreeQueue() :
+pHead( NULL ){
+}
+
+deLockFreeQueue::~deLockFreeQueue(){
+}
+
+
+
+// Management
+///////////////
+
+bool deLockFreeQueue::Push( sEntry *entry ){
+	return PushList( entry, entry );
+}
+
+bool deLockFreeQueue::PushList( sEntry *first, sEntry *last ){
+	if( ! first || ! last ){
+		DETHROW( deeNullPointer );
+	}
+	
+	sEntry *head;
+	
+#ifdef DELOCKFREEQUEUE_ATOMIC
+	do{
+		head = pHead;
+		last->next = head;
+	}while( __sync_val_compare_and_swap( &pHead, head, first ) != head );
+	
+#else
+	pMutex.Lock();
+	head = pHead;
+	last->next = head;
+	pHead = first;
+	pMutex.Unlock();
+#endif
+	
+	return ! head;
+}
+
+deLockFreeQueue::sEntry *deLockFreeQueue::TakeAll(){
+	sEntry *head;
+	
+#ifdef DELOCKFREEQUEUE_ATOMIC
+	do{
+		head = pHead;
+	}while( head && __sync_val_compare_and_swap( &pHead, head, ( sEntry* )NULL ) != head );
+	
+#else
+	pMutex.Lock();
+	head = pHead;
+	pHead = NULL;
+	pMutex.Unlock();
+#endif
+	
+	// entries are linked in reverse order. reverse them to return them in push order
+	sEntry *ordered = NULL;
+	while( head ){
+		sEntry * const next = head->next;
+		head->next = ordered;
+		ordered = head;
+		head = next;
+	}
+	
+	return ordered;
+}
@@ -0,0 +1,110 @@
+/* 
+ * Drag[en]gine Game Engine
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DELOCKFREEQUEUE_H_
+#define _DELOCKFREEQUEUE_H_
+
+#include "deMutex.h"
+
+
+/**
+ * \brief Lock-free multiple producer queue.
+ * 
+ * Intrusive queue of entries pushed by any number of threads and taken all at once by a
+ * single consumer thread. Pushing prepends the entry to a linked list using an atomic
+ * compare and swap. Taking swaps the list with an empty one and reverses it to return
+ * the entries in the order they have been pushed. Since entries are never removed one
+ * by one the queue does not suffer from the ABA problem.
+ * 
+ * Structures stored in the queue have to derive from sEntry. The queue does not own
+ * the entries.
+ * 
+ * \note Uses a mutex instead if the compiler does not support atomic compare and swap
+ * builtins.
+ */
+class deLockFreeQueue{
+public:
+	/** \brief Queue entry. */
+	struct sEntry{
+		/** \brief Next entry. */
+		sEntry *next;
+	};
+	
+	
+	
+private:
+	sEntry * volatile pHead;
+	deMutex pMutex;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create empty queue. */
+	deLockFreeQueue();
+	
+	/** \brief Clean up queue. Entries still in the queue are not freed. */
+	~deLockFreeQueue();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Push entry.
+	 * \returns true if the queue has been empty before.
+	 * \throws deeNullPointer \em entry is NULL.
+	 */
+	bool Push( sEntry *entry );
+	
+	/**
+	 * \brief Push linked list of entries.
+	 * 
+	 * \em last has to be reachable from \em first. TakeAll() returns the entries of the
+	 * list in reverse order. Use this for lists where the order does not matter like
+	 * pools of entries.
+	 * 
+	 * \returns true if the queue has been empty before.
+	 * \throws deeNullPointer \em first or \em last is NULL.
+	 */
+	bool PushList( sEntry *first, sEntry *last );
+	
+	/**
+	 * \brief Take all entries.
+	 * \returns Linked list of entries in the order they have been pushed or NULL if empty.
+	 */
+	sEntry *TakeAll();
+	
+	/**
+	 * \brief Most recently pushed entry or NULL if empty.
+	 * 
+	 * Entries are linked in reverse push order. Entries pushed concurrently are not
+	 * visible in the returned list.
+	 * 
+	 * \warning Call only from the thread taking entries.
+	 */
+	inline sEntry *GetHead() const{ return pHead; }
+	/*@}*/
+};
+
+#endif
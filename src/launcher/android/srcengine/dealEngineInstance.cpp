@@ -38,6 +38,7 @@
 #include <dragengine/filesystem/deVFSDiskDirectory.h>
 #include <dragengine/filesystem/deVFSRedirect.h>
 #include <dragengine/logger/deLogger.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerConsole.h>
 #include <dragengine/logger/deLoggerFile.h>
 #include <dragengine/resources/loader/deResourceLoader.h>
@@ -933,6 +934,7 @@ void dealEngineInstance::pCreateLogger( const char *logfile ){
 		diskPath.RemoveLastComponent();
 		
 		deVFSDiskDirectory *diskDir = NULL;
+		deLogger *loggerFile = NULL;
 		
 		try{
 			diskDir = new deVFSDiskDirectory( diskPath );
@@ -944,12 +946,21 @@ void dealEngineInstance::pCreateLogger( const char *logfile ){
 				fileWriter = diskDir->OpenFileForWriting( filePath );
 			}
 			
-			pLogger = new deLoggerFile( fileWriter );
+			loggerFile = new deLoggerFile( fileWriter );
+			
+			// write the log file using a background thread so logging threads do not
+			// wait for disk I/O
+			pLogger = new deLoggerAsync( loggerFile );
+			loggerFile->FreeReference();
+			loggerFile = NULL;
 			fileWriter->FreeReference();
 			
 			diskDir->FreeReference();
 			
 		}catch( const deException & ){
+			if( loggerFile ){
+				loggerFile->FreeReference();
+			}
 			if( fileWriter ){
 				fileWriter->FreeReference();
 			}
@@ -104,6 +104,8 @@ declRunGame::declRunGame( declLauncher *launcher ) :
 pLauncher( launcher ),
 pUseConsole( false ),
 pLogAllToConsole( false ),
+pParallelWorldUpdate( false ),
+pLogWorldPeerUpdateTimes( false ),
 pGame( NULL ),
 pProfile( NULL ),
 pModuleParameters( NULL ),
@@ -146,6 +148,8 @@ void declRunGame::PrintSyntax(){
 	printf( "      -d, --debug             Display all debug information in the console not just the log file.\n" );
 	printf( "      -P, --patch <id|alias>  Use patch with identifier instead of latest. Use empty string to run unpatched.\n" );
 	printf( "      --mparam module:param=value     Set module parameter before running the game.\n" );
+	printf( "      --parallel-world-update         Update world peers supporting it in parallel.\n" );
+	printf( "      --log-world-update-times        Log time each world peer takes to update.\n" );
 	printf( "   <game>                Identifier of the game to run.\n" );
 	printf( "   -f <game.delga>       DELGA file to run.\n" );
 	printf( "   --file <game.delga>   DELGA file to run.\n" );
@@ -201,6 +205,12 @@ bool declRunGame::ParseArguments(){
 		}else if( utf8Argument == "--debug" ){
 			pLogAllToConsole = true;
 			
+		}else if( utf8Argument == "--parallel-world-update" ){
+			pParallelWorldUpdate = true;
+			
+		}else if( utf8Argument == "--log-world-update-times" ){
+			pLogWorldPeerUpdateTimes = true;
+			
 		}else if( utf8Argument == "--file" ){
 			argumentIndex++;
 			
@@ -960,6 +970,13 @@ void declRunGame::Run(){
 		logger.LogInfoFormat( LOGSOURCE, "Passing game arguments '%s'",
 			pRunArguments.GetString() );
 		engine.GetArguments()->AddArgsSplit( pRunArguments );
+		
+		if( pParallelWorldUpdate ){
+			logger.LogInfo( LOGSOURCE, "Using parallel world update" );
+		}
+		engine.SetParallelWorldUpdate( pParallelWorldUpdate );
+		engine.SetLogWorldPeerUpdateTimes( pLogWorldPeerUpdateTimes );
+		
 		InitVFS();
 		
 		deImageReference icon;
@@ -47,6 +47,8 @@ private:
 	decString pProfileName;
 	bool pUseConsole;
 	bool pLogAllToConsole;
+	bool pParallelWorldUpdate;
+	bool pLogWorldPeerUpdateTimes;
 	
 	declGame *pGame;
 	declGameProfile *pProfile;
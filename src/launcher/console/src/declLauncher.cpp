@@ -38,6 +38,7 @@
 #include <dragengine/filesystem/deVFSDiskDirectory.h>
 #include <dragengine/filesystem/deVirtualFileSystem.h>
 #include <dragengine/logger/deLogger.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerConsoleColor.h>
 #include <dragengine/logger/deLoggerChain.h>
 #include <dragengine/logger/deLoggerFile.h>
@@ -260,8 +261,12 @@ void declLauncher::pInitLogger(){
 	writer.TakeOver( pFileSystem->OpenFileForWriting(
 		decPath::CreatePathUnix( "/logs/delauncher-console.log" ) ) );
 	
+	deLoggerReference loggerFileSync;
+	loggerFileSync.TakeOver( new deLoggerFile( writer ) );
+	
+	// write the log file using a background thread so logging threads do not wait for disk I/O
 	deLoggerReference loggerFile;
-	loggerFile.TakeOver( new deLoggerFile( writer ) );
+	loggerFile.TakeOver( new deLoggerAsync( loggerFileSync ) );
 	
 	loggerLauncherError.AddLogger( loggerFile );
 	loggerLauncherWarn.AddLogger( loggerFile );
@@ -42,6 +42,7 @@
 #include <dragengine/filesystem/deVFSDiskDirectory.h>
 #include <dragengine/filesystem/deVirtualFileSystem.h>
 #include <dragengine/logger/deLogger.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerConsoleColor.h>
 #include <dragengine/logger/deLoggerChain.h>
 #include <dragengine/logger/deLoggerFile.h>
@@ -578,6 +579,7 @@ void deglLauncher::pInitLogger(){
 	decBaseFileWriter *fileWriter = NULL;
 	deLoggerChain *loggerChain = NULL;
 	deLoggerFile *loggerFile = NULL;
+	deLoggerAsync *loggerAsync = NULL;
 	
 	bool useConsole = false; //true;
 	bool useFile = true;
@@ -622,10 +624,16 @@ void deglLauncher::pInitLogger(){
 			fileWriter->FreeReference();
 			fileWriter = NULL;
 			
-			loggerChain->AddLogger( loggerFile );
-			
+			// write the log file using a background thread so logging threads do not
+			// wait for disk I/O
+			loggerAsync = new deLoggerAsync( loggerFile );
 			loggerFile->FreeReference();
 			loggerFile = NULL;
+			
+			loggerChain->AddLogger( loggerAsync );
+			
+			loggerAsync->FreeReference();
+			loggerAsync = NULL;
 		}
 		
 		// set the logger
@@ -641,6 +649,9 @@ void deglLauncher::pInitLogger(){
 		if( loggerChain ){
 			loggerChain->FreeReference();
 		}
+		if( loggerAsync ){
+			loggerAsync->FreeReference();
+		}
 		if( loggerFile ){
 			loggerFile->FreeReference();
 		}
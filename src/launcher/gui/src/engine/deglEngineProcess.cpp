@@ -63,6 +63,7 @@
 #include <dragengine/filesystem/deVirtualFileSystem.h>
 #include <dragengine/filesystem/deVirtualFileSystemReference.h>
 #include <dragengine/filesystem/deCollectFileSearchVisitor.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerFile.h>
 #include <dragengine/logger/deLoggerChain.h>
 #include <dragengine/logger/deLoggerConsoleColor.h>
@@ -1553,6 +1554,7 @@ void deglEngineProcess::pCreateLogger( const char *logfile ){
 		diskPath.RemoveLastComponent();
 		
 		deVFSDiskDirectory *diskDir = NULL;
+		deLogger *loggerFile = NULL;
 		
 		try{
 			diskDir = new deVFSDiskDirectory( diskPath );
@@ -1566,12 +1568,19 @@ void deglEngineProcess::pCreateLogger( const char *logfile ){
 			*/
 			fileWriter = diskDir->OpenFileForWriting( filePath );
 			
-			pLogger = new deLoggerFile( fileWriter );
+			// engine and modules log from many threads. write the log file using a
+			// background thread so logging threads do not wait for disk I/O
+			loggerFile = new deLoggerFile( fileWriter );
+			pLogger = new deLoggerAsync( loggerFile );
+			loggerFile->FreeReference();
 			fileWriter->FreeReference();
 			
 			diskDir->FreeReference();
 			
 		}catch( const deException & ){
+			if( loggerFile ){
+				loggerFile->FreeReference();
+			}
 			if( fileWriter ){
 				fileWriter->FreeReference();
 			}
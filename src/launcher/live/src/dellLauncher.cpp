@@ -31,6 +31,7 @@
 #include <dragengine/filesystem/deVFSDiskDirectory.h>
 #include <dragengine/filesystem/deVFSContainerReference.h>
 #include <dragengine/filesystem/deVirtualFileSystem.h>
+#include <dragengine/logger/deLoggerAsync.h>
 #include <dragengine/logger/deLoggerConsoleColor.h>
 #include <dragengine/logger/deLoggerFile.h>
 #include <dragengine/common/string/decString.h>
@@ -121,7 +122,12 @@ void dellLauncher::pInitVFS(){
 void dellLauncher::pInitLogger(){
 	decBaseFileWriterReference fileWriter;
 	fileWriter.TakeOver( pFileSystem->OpenFileForWriting( decPath::CreatePathUnix( "/logs/launcher.log" ) ) );
-	pLogger.TakeOver( new deLoggerFile( fileWriter ) );
+	
+	deLoggerReference loggerFile;
+	loggerFile.TakeOver( new deLoggerFile( fileWriter ) );
+	
+	// write the log file using a background thread so logging threads do not wait for disk I/O
+	pLogger.TakeOver( new deLoggerAsync( loggerFile ) );
 }
 
 void dellLauncher::pUpdateEnvironment(){
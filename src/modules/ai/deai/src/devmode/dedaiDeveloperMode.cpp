@@ -25,6 +25,7 @@
 
 #include "dedaiDeveloperMode.h"
 #include "../deDEAIModule.h"
+#include "../navigation/pathfinding/query/dedaiPathQueryBenchmark.h"
 
 #include <dragengine/deEngine.h>
 #include <dragengine/common/string/unicode/decUnicodeString.h>
@@ -106,6 +107,10 @@ bool dedaiDeveloperMode::ExecuteCommand( const decUnicodeArgumentList &command,
 		}else if( command.MatchesArgumentAt( 0, "dm_quick_debug" ) ){
 			pCmdQuickDebug( command, answer );
 			return true;
+			
+		}else if( command.MatchesArgumentAt( 0, "dm_path_query_benchmark" ) ){
+			pCmdPathQueryBenchmark( command, answer );
+			return true;
 		}
 	}
 	
@@ -132,6 +137,7 @@ void dedaiDeveloperMode::pCmdHelp( const decUnicodeArgumentList &command, decUni
 	answer.AppendFromUTF8( "dm_show_path [1|0] => Dispaly navigator path.\n" );
 	answer.AppendFromUTF8( "dm_show_path_faces [1|0] => Dispaly navigator path faces.\n" );
 	answer.AppendFromUTF8( "dm_quick_debug [number] => Quick debug.\n" );
+	answer.AppendFromUTF8( "dm_path_query_benchmark [queries] [gridSize] => Benchmark asynchronous path queries.\n" );
 }
 
 void dedaiDeveloperMode::pCmdEnable( const decUnicodeArgumentList &command, decUnicodeString &answer ){
@@ -243,3 +249,21 @@ void dedaiDeveloperMode::pCmdQuickDebug( const decUnicodeArgumentList &command,
 	text.Format( "dm_quick_debug = %i\n", pQuickDebug );
 	answer.AppendFromUTF8( text );
 }
+
+void dedaiDeveloperMode::pCmdPathQueryBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	int queryCount = 5000;
+	int gridSize = 100;
+	
+	if( command.GetArgumentCount() > 1 ){
+		queryCount = decMath::max( command.GetArgumentAt( 1 )->ToInt(), 1 );
+	}
+	if( command.GetArgumentCount() > 2 ){
+		gridSize = decMath::max( command.GetArgumentAt( 2 )->ToInt(), 2 );
+	}
+	
+	dedaiPathQueryBenchmark benchmark( pDEAI );
+	decString text;
+	benchmark.Run( queryCount, gridSize, text );
+	pDEAI.LogInfo( text.GetString() );
+	answer.AppendFromUTF8( text );
+}
@@ -128,6 +128,7 @@ private:
 	void pCmdShowPathFaces( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	
 	void pCmdQuickDebug( const decUnicodeArgumentList &command, decUnicodeString &answer );
+	void pCmdPathQueryBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer );
 };
 
 #endif
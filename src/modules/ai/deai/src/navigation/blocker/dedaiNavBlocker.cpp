@@ -63,6 +63,7 @@ pParentWorld( NULL ),
 pDirtyMatrix( true ),
 pDirtyExtends( true ),
 pDirtyShape( true ),
+pHasBlockingExtends( false ),
 
 pLayer( NULL ),
 
@@ -254,35 +255,6 @@ void dedaiNavBlocker::PositionChanged(){
 	if( pDebugDrawer ){
 		pDebugDrawer->SetPosition( pNavBlocker.GetPosition() );
 	}
-	
-	// TODO
-	// for each navigation space:
-	//    if navigation space matches type and layer of blocker:
-	//       blockerChanged( blockerOldAABBMin, blockerOldAABBMax )
-	//       blockerChanged( blockerNewAABBMin, blockerNewAABBMax )
-	// 
-	// navigation space :: blockerChanged( minAABB, maxAABB ):
-	// for each face:
-	//    face overlaps AABB:
-	//       mark face dirty for blocker recalculation
-	//       remove all generated blocker faces for this face
-	// 
-	// navigation space :: update:
-	// if dirtyBlockerFaces:
-	//    for each blocker:
-	//       if blocker overlaps navigation space:
-	//          blockerShapeList.extend( blocker.shapes )
-	//    for each face:
-	//       if face is blockerDirty:
-	//          generate blocker faces for face. for this take the
-	//          face and send it through all blockerShapeList.
-	// 
-	// all generated vertices, edges, corners and faces are added
-	// to the navigation mesh. after the initial generation process
-	// the vertex, edge, corner and face count is stored. any vertex
-	// corner, edge and face beyond this value is a dynamic blocker
-	// vertex, corner, edge, face. this way all blocker data can be
-	// deleted by just going back to the saved counts
 }
 
 void dedaiNavBlocker::OrientationChanged(){
@@ -421,8 +393,20 @@ void dedaiNavBlocker::pUpdateConvexVolumeList(){
 
 void dedaiNavBlocker::pInvalidateLayerBlocking(){
 	if( ! pLayer ){
+		pHasBlockingExtends = false;
 		return;
 	}
 	
-	pLayer->InvalidateBlocking( pNavBlocker.GetSpaceType(), GetMinimumExtends(), GetMaximumExtends() );
+	// blocking has to be updated also where the blocker has been located the last time.
+	// navigation meshes update only faces inside the invalidated boxes
+	const deNavigationSpace::eSpaceTypes spaceType = pNavBlocker.GetSpaceType();
+	
+	if( pHasBlockingExtends ){
+		pLayer->InvalidateBlocking( spaceType, pBlockingMinExtends, pBlockingMaxExtends );
+	}
+	
+	pBlockingMinExtends = GetMinimumExtends();
+	pBlockingMaxExtends = GetMaximumExtends();
+	pHasBlockingExtends = true;
+	pLayer->InvalidateBlocking( spaceType, pBlockingMinExtends, pBlockingMaxExtends );
 }
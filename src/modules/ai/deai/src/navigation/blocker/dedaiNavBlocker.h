@@ -54,6 +54,10 @@ private:
 	bool pDirtyExtends;
 	bool pDirtyShape;
 	
+	decDVector pBlockingMinExtends;
+	decDVector pBlockingMaxExtends;
+	bool pHasBlockingExtends;
+	
 	dedaiLayer *pLayer;
 	
 	decConvexVolumeList pConvexVolumeList;
@@ -27,6 +27,11 @@
 #include "costs/dedaiCostTable.h"
 #include "pathfinding/dedaiPathFinderNavGrid.h"
 #include "pathfinding/dedaiPathFinderNavMesh.h"
+#include "pathfinding/graph/dedaiPathGraph.h"
+#include "pathfinding/graph/dedaiPathGraphSearch.h"
+#include "pathfinding/query/dedaiPathQuery.h"
+#include "pathfinding/query/dedaiPathQueryCosts.h"
+#include "pathfinding/query/dedaiPathQueryManager.h"
 #include "dedaiPathCollisionListener.h"
 #include "spaces/mesh/dedaiSpaceMeshFace.h"
 #include "spaces/mesh/dedaiSpaceMesh.h"
@@ -48,6 +53,7 @@
 #include <dragengine/resources/debug/deDebugDrawerShapeFace.h>
 #include <dragengine/resources/navigation/navigator/deNavigator.h>
 #include <dragengine/resources/navigation/navigator/deNavigatorPath.h>
+#include <dragengine/resources/navigation/navigator/deNavigatorPathQuery.h>
 #include <dragengine/resources/navigation/navigator/deNavigatorType.h>
 #include <dragengine/resources/navigation/space/deNavigationSpace.h>
 #include <dragengine/resources/world/deWorld.h>
@@ -150,9 +156,17 @@ void dedaiNavigator::Prepare(){
 	if( pDirtyTypeMappings ){
 		pUpdateTypeMappings();
 		pDirtyTypeMappings = false;
+		pPathQueryCosts = NULL;
 	}
 }
 
+dedaiPathQueryCosts *dedaiNavigator::GetPathQueryCosts(){
+	if( ! pPathQueryCosts ){
+		pPathQueryCosts.TakeOver( new dedaiPathQueryCosts( *this ) );
+	}
+	return ( dedaiPathQueryCosts* )( deThreadSafeObject* )pPathQueryCosts;
+}
+
 
 
 void dedaiNavigator::UpdateDDSPath(){
@@ -317,6 +331,7 @@ void dedaiNavigator::LayerChanged(){
 	}
 	
 	pLayer = pParentWorld->GetLayer( pNavigator.GetLayer() );
+	pPathQueryCosts = NULL;
 	
 	pDevModeMarkLayerDirty();
 }
@@ -326,15 +341,18 @@ void dedaiNavigator::SpaceTypeChanged(){
 }
 
 void dedaiNavigator::CostsChanged(){
+	pPathQueryCosts = NULL;
 	pDevModeMarkLayerDirty();
 }
 
 void dedaiNavigator::TypesChanged(){
 	pDirtyTypeMappings = true;
+	pPathQueryCosts = NULL;
 	pDevModeMarkLayerDirty();
 }
 
 void dedaiNavigator::ParametersChanged(){
+	pPathQueryCosts = NULL;
 }
 
 
@@ -372,6 +390,39 @@ void dedaiNavigator::FindPath( deNavigatorPath &path, const decDVector &start, c
 		}
 		
 	}else if( pNavigator.GetSpaceType() == deNavigationSpace::estMesh ){
+		// large layers use the hierarchical search on the layer path graph like asynchronous
+		// queries do. the developer mode path faces require the navigation mesh path finder
+		dedaiPathGraph * const graph = pDDSPathFaces ? NULL : pLayer->GetPathGraph();
+		
+		if( graph && graph->GetFaceCount() >= pParentWorld->GetPathQueryManager().GetClusterFaceCount() ){
+			dedaiPathQueryCosts &costs = *GetPathQueryCosts();
+			const double maxDistance = ( double )costs.GetMaxOutsideDistance();
+			double distance;
+			int goalFace = -1;
+			
+			const int startFace = graph->GetFaceClosestTo( start, maxDistance, distance );
+			if( startFace != -1 ){
+				goalFace = graph->GetFaceClosestTo( goal, maxDistance, distance );
+			}
+			
+			if( startFace == -1 || goalFace == -1 || startFace == goalFace ){
+				path.Add( goal );
+				
+			}else{
+				dedaiPathGraphSearch search;
+				search.SetGraph( graph );
+				search.FindCorridor( costs, graph->GetClusters( &costs ), startFace, goalFace );
+				search.FindPoints( start, goal, path );
+			}
+			
+			if( pDDSPath ){
+				pDebugDrawer->SetPosition( start );
+				UpdateDDSPathShape( path );
+				pDebugDrawer->NotifyShapeContentChanged();
+			}
+			return;
+		}
+		
 		dedaiPathFinderNavMesh pathfinder;
 		pathfinder.SetWorld( pParentWorld );
 		pathfinder.SetNavigator( this );
@@ -402,6 +453,30 @@ void dedaiNavigator::FindPath( deNavigatorPath &path, const decDVector &start, c
 	}
 }
 
+void dedaiNavigator::FindPathAsync( deNavigatorPathQuery &query ){
+	if( ! pParentWorld ){
+		query.GetPath().RemoveAll();
+		query.SetState( deNavigatorPathQuery::esFinished );
+		return;
+	}
+	
+	if( pNavigator.GetSpaceType() != deNavigationSpace::estMesh ){
+		FindPath( query.GetPath(), query.GetStart(), query.GetGoal() );
+		query.SetState( deNavigatorPathQuery::esFinished );
+		return;
+	}
+	
+	Prepare();
+	
+	deThreadSafeObjectReference pathQuery;
+	pathQuery.TakeOver( new dedaiPathQuery( query.GetStart(), query.GetGoal() ) );
+	
+	dedaiPathQuery * const moduleQuery = ( dedaiPathQuery* )( deThreadSafeObject* )pathQuery;
+	moduleQuery->SetLayer( pLayer );
+	moduleQuery->SetCosts( GetPathQueryCosts() );
+	pParentWorld->GetPathQueryManager().AddQuery( moduleQuery, &query );
+}
+
 void dedaiNavigator::CostTableDefinitionChanged(){
 	pDirtyTypeMappings = true;
 }
@@ -24,16 +24,19 @@
 
 #include <dragengine/systems/modules/ai/deBaseAINavigator.h>
 #include <dragengine/common/math/decMath.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
 
 class deDEAIModule;
 class dedaiCostTable;
 class dedaiLayer;
 class dedaiPathFinderNavMesh;
+class dedaiPathQueryCosts;
 class dedaiWorld;
 
 class deDebugDrawer;
 class deDebugDrawerShape;
 class deNavigator;
+class deNavigatorPathQuery;
 class deNavigatorType;
 
 
@@ -54,6 +57,8 @@ private:
 	
 	dedaiLayer *pLayer;
 	
+	deThreadSafeObjectReference pPathQueryCosts;
+	
 	deDebugDrawer *pDebugDrawer;
 	deDebugDrawerShape *pDDSPath;
 	deDebugDrawerShape *pDDSPathFaces;
@@ -118,6 +123,15 @@ public:
 	/** \brief Number of type mappings. */
 	inline int GetTypeMappingCount() const{ return pTypeMappingCount; }
 	
+	/**
+	 * \brief Cost parameters for path queries.
+	 * 
+	 * Created on demand and kept until costs, types or parameters change.
+	 * 
+	 * \warning Navigator has to be prepared.
+	 */
+	dedaiPathQueryCosts *GetPathQueryCosts();
+	
 	
 	
 	/** \brief Debug drawer shape for the path or NULL if not existing. */
@@ -204,12 +218,29 @@ public:
 	 * 
 	 * Replaces path with found path. If path can not be found the path is empty.
 	 * 
+	 * Navigation mesh layers with at least dedaiPathQueryManager::GetClusterFaceCount()
+	 * faces are searched hierarchically using the layer path graph clusters.
+	 * 
 	 * \param[out] path Path to update.
 	 * \param[in] start Start position of path.
 	 * \param[in] goal Goal position of path.
 	 */
 	virtual void FindPath( deNavigatorPath &path, const decDVector &start, const decDVector &goal );
 	
+	/**
+	 * \brief Find path asynchronously.
+	 * 
+	 * Adds a path query bound to \em query to the path query manager of the parent world.
+	 * The query is processed in a batch together with all other queries of the frame using
+	 * parallel tasks. The result is stored in \em query during the next frame update after
+	 * the tasks finished.
+	 * 
+	 * Grid navigation spaces are not supported by the path graph. For these the query is
+	 * processed synchronously using FindPath(). Without parent world the query finishes
+	 * with an empty path.
+	 */
+	virtual void FindPathAsync( deNavigatorPathQuery &query );
+	
 	/**
 	 * \brief Test path for collision using ray test.
 	 * 
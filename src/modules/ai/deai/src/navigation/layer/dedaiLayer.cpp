@@ -30,6 +30,7 @@
 #include "../spaces/dedaiSpace.h"
 #include "../spaces/grid/dedaiSpaceGrid.h"
 #include "../spaces/mesh/dedaiSpaceMesh.h"
+#include "../pathfinding/graph/dedaiPathGraph.h"
 #include "../blocker/dedaiNavBlocker.h"
 #include "../dedaiNavSpace.h"
 #include "../../world/dedaiWorld.h"
@@ -37,12 +38,20 @@
 #include "../../devmode/dedaiDeveloperMode.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decPointerList.h>
 #include <dragengine/resources/world/deWorld.h>
 #include <dragengine/resources/navigation/navigator/deNavigator.h>
 #include <dragengine/resources/navigation/blocker/deNavigationBlocker.h>
 
 
 
+// Definitions
+////////////////
+
+#define MAX_DIRTY_BOXES		32
+
+
+
 // Class dedaiLayer
 /////////////////////
 
@@ -52,11 +61,17 @@
 dedaiLayer::dedaiLayer( dedaiWorld &world, int layer ) :
 pWorld( world ),
 pLayer( layer ),
-pDirty( true )
+pDirty( true ),
+pDirtyBoxes( NULL ),
+pDirtyBoxCount( 0 ),
+pDirtyAll( true )
 {
 }
 
 dedaiLayer::~dedaiLayer(){
+	if( pDirtyBoxes ){
+		delete [] pDirtyBoxes;
+	}
 }
 
 
@@ -75,6 +90,12 @@ void dedaiLayer::Prepare(){
 		return;
 	}
 	
+	// keep the outdated graph. the next graph reuses its clusters outside the dirty boxes
+	if( pPathGraph ){
+		pOutdatedPathGraph = pPathGraph;
+		pPathGraph = NULL;
+	}
+	
 	pUpdateCostTable();
 	pNavSpacesPrepare();
 	pNavSpacesPrepareLinks();
@@ -87,6 +108,72 @@ void dedaiLayer::Prepare(){
 
 void dedaiLayer::MarkDirty(){
 	pDirty = true;
+	pDirtyAll = true;
+}
+
+
+
+dedaiPathGraph *dedaiLayer::GetPathGraph(){
+	Prepare();
+	
+	if( pPathGraph ){
+		return ( dedaiPathGraph* )( deThreadSafeObject* )pPathGraph;
+	}
+	
+	decPointerList meshes;
+	
+	// height terrain navspaces
+	const dedaiHeightTerrain * const heightTerrain = pWorld.GetHeightTerrain();
+	if( heightTerrain ){
+		const int sectorCount = heightTerrain->GetSectorCount();
+		int i, j;
+		
+		for( i=0; i<sectorCount; i++ ){
+			dedaiHeightTerrainSector &sector = *heightTerrain->GetSectorAt( i );
+			const int navSpaceCount = sector.GetNavSpaceCount();
+			for( j=0; j<navSpaceCount; j++ ){
+				dedaiSpace &space = *sector.GetNavSpaceAt( j )->GetSpace();
+				if( space.GetLayer() == this && space.GetMesh() ){
+					meshes.Add( space.GetMesh() );
+				}
+			}
+		}
+	}
+	
+	// navigation spaces
+	deNavigationSpace *engNavSpace = pWorld.GetWorld().GetRootNavigationSpace();
+	while( engNavSpace ){
+		dedaiNavSpace * const navspace = ( dedaiNavSpace* )engNavSpace->GetPeerAI();
+		if( navspace ){
+			dedaiSpace &space = *navspace->GetSpace();
+			if( space.GetLayer() == this && space.GetMesh() ){
+				meshes.Add( space.GetMesh() );
+			}
+		}
+		engNavSpace = engNavSpace->GetLLWorldNext();
+	}
+	
+	pPathGraph.TakeOver( new dedaiPathGraph );
+	dedaiPathGraph * const graph = ( dedaiPathGraph* )( deThreadSafeObject* )pPathGraph;
+	
+	try{
+		graph->InitFromMeshes( meshes );
+		
+		if( ! pDirtyAll ){
+			graph->SetPreviousGraph( ( dedaiPathGraph* )( deThreadSafeObject* )pOutdatedPathGraph,
+				pDirtyBoxes, pDirtyBoxCount );
+		}
+		
+	}catch( const deException & ){
+		pPathGraph = NULL;
+		throw;
+	}
+	
+	pOutdatedPathGraph = NULL;
+	pDirtyBoxCount = 0;
+	pDirtyAll = false;
+	
+	return graph;
 }
 
 
@@ -374,6 +461,7 @@ void dedaiLayer::InvalidateBlocking(){
 	
 	// update require
 	pDirty = true;
+	pDirtyAll = true;
 }
 
 void dedaiLayer::InvalidateBlocking( deNavigationSpace::eSpaceTypes type ){
@@ -418,6 +506,7 @@ void dedaiLayer::InvalidateBlocking( deNavigationSpace::eSpaceTypes type ){
 	
 	// update require
 	pDirty = true;
+	pDirtyAll = true;
 }
 
 void dedaiLayer::InvalidateBlocking( deNavigationSpace::eSpaceTypes type,
@@ -442,7 +531,7 @@ const decDVector &boxMin, const decDVector &boxMax ){
 				const decDVector &targetMinExtend = space.GetMinimumExtends();
 				const decDVector &targetMaxExtend = space.GetMaximumExtends();
 				if( targetMaxExtend >= boxMin && targetMinExtend <= boxMax ){
-					space.InvalidateBlocking();
+					space.InvalidateBlocking( boxMin, boxMax );
 				}
 			}
 		}
@@ -466,7 +555,7 @@ const decDVector &boxMin, const decDVector &boxMax ){
 		const decDVector &targetMinExtend = space.GetMinimumExtends();
 		const decDVector &targetMaxExtend = space.GetMaximumExtends();
 		if( targetMaxExtend >= boxMin && targetMinExtend <= boxMax ){
-			space.InvalidateBlocking();
+			space.InvalidateBlocking( boxMin, boxMax );
 		}
 		
 		engNavSpace = engNavSpace->GetLLWorldNext();
@@ -476,6 +565,7 @@ const decDVector &boxMin, const decDVector &boxMax ){
 	
 	// update require
 	pDirty = true;
+	pAddDirtyBox( boxMin, boxMax );
 }
 
 
@@ -522,6 +612,7 @@ void dedaiLayer::InvalidateLinks(){
 	
 	// update require
 	pDirty = true;
+	pDirtyAll = true;
 }
 
 void dedaiLayer::InvalidateLinks( deNavigationSpace::eSpaceTypes type ){
@@ -566,6 +657,7 @@ void dedaiLayer::InvalidateLinks( deNavigationSpace::eSpaceTypes type ){
 	
 	// update require
 	pDirty = true;
+	pDirtyAll = true;
 }
 
 void dedaiLayer::InvalidateLinks( deNavigationSpace::eSpaceTypes type,
@@ -624,6 +716,7 @@ const decDVector &boxMin, const decDVector &boxMax ){
 	
 	// update require
 	pDirty = true;
+	pAddDirtyBox( boxMin, boxMax );
 }
 
 
@@ -733,3 +826,28 @@ void dedaiLayer::pNavigatorsPrepare(){
 		navigator = navigator->GetLLWorldNext();
 	}
 }
+
+void dedaiLayer::pAddDirtyBox( const decDVector &boxMin, const decDVector &boxMax ){
+	if( pDirtyAll ){
+		return;
+	}
+	
+	if( ! pDirtyBoxes ){
+		pDirtyBoxes = new decDVector[ MAX_DIRTY_BOXES * 2 ];
+	}
+	
+	// too many changes at once. merge them into one box. this invalidates more clusters
+	// than necessary but keeps testing clusters against the boxes fast
+	if( pDirtyBoxCount == MAX_DIRTY_BOXES ){
+		int i;
+		for( i=1; i<pDirtyBoxCount; i++ ){
+			pDirtyBoxes[ 0 ].SetSmallest( pDirtyBoxes[ i * 2 ] );
+			pDirtyBoxes[ 1 ].SetLargest( pDirtyBoxes[ i * 2 + 1 ] );
+		}
+		pDirtyBoxCount = 1;
+	}
+	
+	pDirtyBoxes[ pDirtyBoxCount * 2 ] = boxMin;
+	pDirtyBoxes[ pDirtyBoxCount * 2 + 1 ] = boxMax;
+	pDirtyBoxCount++;
+}
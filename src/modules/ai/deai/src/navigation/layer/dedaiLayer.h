@@ -27,7 +27,9 @@
 #include <dragengine/deObject.h>
 #include <dragengine/common/math/decMath.h>
 #include <dragengine/resources/navigation/space/deNavigationSpace.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
 
+class dedaiPathGraph;
 class dedaiSpaceMeshFace;
 class dedaiSpaceGridVertex;
 class dedaiWorld;
@@ -46,6 +48,12 @@ private:
 	
 	bool pDirty;
 	
+	deThreadSafeObjectReference pPathGraph;
+	deThreadSafeObjectReference pOutdatedPathGraph;
+	decDVector *pDirtyBoxes;
+	int pDirtyBoxCount;
+	bool pDirtyAll;
+	
 	
 	
 public:
@@ -92,6 +100,19 @@ public:
 	
 	
 	
+	/**
+	 * \brief Path graph snapshot of all navigation meshes in the layer.
+	 * 
+	 * Prepares the layer and creates the graph if not existing. The graph is dropped if the
+	 * layer becomes dirty. Parallel tasks hold a reference to the graph they work on.
+	 * 
+	 * If only areas of the layer have been invalidated since the last graph has been built
+	 * the new graph reuses the clusters of the last graph outside these areas.
+	 */
+	dedaiPathGraph *GetPathGraph();
+	
+	
+	
 	/** \brief Navigation grid vertex closest to a given position. */
 	dedaiSpaceGridVertex *GetGridVertexClosestTo( const decDVector &position, float &distance );
 	
@@ -143,6 +164,7 @@ private:
 	void pNavSpacesPrepare();
 	void pNavSpacesPrepareLinks();
 	void pNavigatorsPrepare();
+	void pAddDirtyBox( const decDVector &boxMin, const decDVector &boxMax );
 };
 
 #endif
@@ -0,0 +1,662 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dedaiPathGraph.h"
+#include "dedaiPathGraphClusters.h"
+#include "../../spaces/dedaiSpace.h"
+#include "../../spaces/mesh/dedaiSpaceMesh.h"
+#include "../../spaces/mesh/dedaiSpaceMeshCorner.h"
+#include "../../spaces/mesh/dedaiSpaceMeshEdge.h"
+#include "../../spaces/mesh/dedaiSpaceMeshFace.h"
+#include "../../spaces/mesh/dedaiSpaceMeshLink.h"
+#include "../query/dedaiPathQueryCosts.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decPointerList.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+
+
+// Definitions
+////////////////
+
+#define CLUSTER_SIZE		64
+#define MAX_CLUSTER_COSTS	4
+
+
+
+// Class dedaiPathGraph
+/////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathGraph::dedaiPathGraph() :
+pVertices( NULL ),
+pVertexCount( 0 ),
+pVertexSize( 0 ),
+
+pFaces( NULL ),
+pFaceCount( 0 ),
+pFaceSize( 0 ),
+
+pLinks( NULL ),
+pLinkCount( 0 ),
+pLinkSize( 0 ),
+
+pGridCellSize( 1.0 ),
+pGridSizeX( 0 ),
+pGridSizeY( 0 ),
+pGridSizeZ( 0 ),
+pGridCells( NULL ),
+pGridFaces( NULL ),
+
+pDirtyBoxes( NULL ),
+pDirtyBoxCount( 0 ){
+}
+
+dedaiPathGraph::~dedaiPathGraph(){
+	pDropPreviousGraph();
+	
+	if( pGridFaces ){
+		delete [] pGridFaces;
+	}
+	if( pGridCells ){
+		delete [] pGridCells;
+	}
+	if( pLinks ){
+		delete [] pLinks;
+	}
+	if( pFaces ){
+		delete [] pFaces;
+	}
+	if( pVertices ){
+		delete [] pVertices;
+	}
+}
+
+
+
+// Management
+///////////////
+
+int dedaiPathGraph::AddVertex( const decDVector &position ){
+	if( pVertexCount == pVertexSize ){
+		const int newSize = pVertexSize * 3 / 2 + 64;
+		decDVector * const newArray = new decDVector[ newSize ];
+		if( pVertices ){
+			memcpy( newArray, pVertices, sizeof( decDVector ) * pVertexCount );
+			delete [] pVertices;
+		}
+		pVertices = newArray;
+		pVertexSize = newSize;
+	}
+	
+	pVertices[ pVertexCount ] = position;
+	return pVertexCount++;
+}
+
+int dedaiPathGraph::AddFace( int firstVertex, int vertexCount, int costType ){
+	if( firstVertex < 0 || vertexCount < 3 || firstVertex + vertexCount > pVertexCount ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	if( pFaceCount == pFaceSize ){
+		const int newSize = pFaceSize * 3 / 2 + 64;
+		sFace * const newArray = new sFace[ newSize ];
+		if( pFaces ){
+			memcpy( newArray, pFaces, sizeof( sFace ) * pFaceCount );
+			delete [] pFaces;
+		}
+		pFaces = newArray;
+		pFaceSize = newSize;
+	}
+	
+	sFace &face = pFaces[ pFaceCount ];
+	const decDVector * const vertices = pVertices + firstVertex;
+	int i;
+	
+	face.firstVertex = firstVertex;
+	face.vertexCount = vertexCount;
+	face.firstLink = pLinkCount;
+	face.linkCount = 0;
+	face.costType = costType;
+	
+	face.center.SetZero();
+	face.minExtend = vertices[ 0 ];
+	face.maxExtend = vertices[ 0 ];
+	for( i=0; i<vertexCount; i++ ){
+		face.center += vertices[ i ];
+		face.minExtend.SetSmallest( vertices[ i ] );
+		face.maxExtend.SetLargest( vertices[ i ] );
+	}
+	face.center /= ( double )vertexCount;
+	
+	// newell normal. robust against co-linear corners in convex faces with many corners
+	face.normal.SetZero();
+	for( i=0; i<vertexCount; i++ ){
+		face.normal += ( vertices[ i ] - face.center ) % ( vertices[ ( i + 1 ) % vertexCount ] - face.center );
+	}
+	const double length = face.normal.Length();
+	if( length > DOUBLE_SAFE_EPSILON ){
+		face.normal /= length;
+		
+	}else{
+		face.normal.Set( 0.0, 1.0, 0.0 );
+	}
+	
+	return pFaceCount++;
+}
+
+void dedaiPathGraph::AddLink( int face, int neighborFace, int vertex1, int vertex2 ){
+	if( face < 0 || face >= pFaceCount || neighborFace < 0 || neighborFace >= pFaceCount
+	|| vertex1 < 0 || vertex1 >= pVertexCount || vertex2 < 0 || vertex2 >= pVertexCount ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	sFace &sourceFace = pFaces[ face ];
+	if( sourceFace.linkCount == 0 ){
+		sourceFace.firstLink = pLinkCount;
+		
+	}else if( sourceFace.firstLink + sourceFace.linkCount != pLinkCount ){
+		DETHROW( deeInvalidParam ); // links of a face have to be added all at once
+	}
+	
+	if( pLinkCount == pLinkSize ){
+		const int newSize = pLinkSize * 3 / 2 + 64;
+		sLink * const newArray = new sLink[ newSize ];
+		if( pLinks ){
+			memcpy( newArray, pLinks, sizeof( sLink ) * pLinkCount );
+			delete [] pLinks;
+		}
+		pLinks = newArray;
+		pLinkSize = newSize;
+	}
+	
+	// orient portal. right vertex rotated towards left vertex around the face normal is
+	// a positive rotation as seen from the face center
+	const decDVector &center = sourceFace.center;
+	const double orientation = sourceFace.normal *
+		( ( pVertices[ vertex1 ] - center ) % ( pVertices[ vertex2 ] - center ) );
+		
+	sLink &link = pLinks[ pLinkCount++ ];
+	link.face = neighborFace;
+	if( orientation > 0.0 ){
+		link.vertexRight = vertex1;
+		link.vertexLeft = vertex2;
+		
+	}else{
+		link.vertexRight = vertex2;
+		link.vertexLeft = vertex1;
+	}
+	
+	sourceFace.linkCount++;
+}
+
+void dedaiPathGraph::InitFromMeshes( const decPointerList &meshes ){
+	const int meshCount = meshes.GetCount();
+	int **faceMaps = NULL;
+	int *vertexBases = NULL;
+	int i;
+	
+	if( meshCount == 0 ){
+		BuildLookupGrid();
+		return;
+	}
+	
+	try{
+		faceMaps = new int*[ meshCount ];
+		for( i=0; i<meshCount; i++ ){
+			faceMaps[ i ] = NULL;
+		}
+		vertexBases = new int[ meshCount ];
+		
+		// add faces first. links can cross navigation meshes and need all faces present
+		for( i=0; i<meshCount; i++ ){
+			dedaiSpaceMesh &mesh = *( ( dedaiSpaceMesh* )meshes.GetAt( i ) );
+			
+			if( mesh.GetFaceCount() > 0 ){
+				faceMaps[ i ] = new int[ mesh.GetFaceCount() ];
+			}
+			vertexBases[ i ] = pVertexCount;
+			pAddMeshFaces( mesh, faceMaps[ i ] );
+		}
+		
+		for( i=0; i<meshCount; i++ ){
+			pAddMeshLinks( *( ( dedaiSpaceMesh* )meshes.GetAt( i ) ), meshes, faceMaps, vertexBases );
+		}
+		
+		for( i=0; i<meshCount; i++ ){
+			if( faceMaps[ i ] ){
+				delete [] faceMaps[ i ];
+			}
+		}
+		delete [] faceMaps;
+		delete [] vertexBases;
+		
+	}catch( const deException & ){
+		if( faceMaps ){
+			for( i=0; i<meshCount; i++ ){
+				if( faceMaps[ i ] ){
+					delete [] faceMaps[ i ];
+				}
+			}
+			delete [] faceMaps;
+		}
+		if( vertexBases ){
+			delete [] vertexBases;
+		}
+		throw;
+	}
+	
+	BuildLookupGrid();
+}
+
+void dedaiPathGraph::BuildLookupGrid(){
+	if( pGridFaces ){
+		delete [] pGridFaces;
+		pGridFaces = NULL;
+	}
+	if( pGridCells ){
+		delete [] pGridCells;
+		pGridCells = NULL;
+	}
+	pGridSizeX = 0;
+	pGridSizeY = 0;
+	pGridSizeZ = 0;
+	
+	if( pFaceCount == 0 ){
+		return;
+	}
+	
+	// cell size is twice the average face size. this keeps the number of faces per cell
+	// small while faces do not overlap too many cells
+	decDVector minExtend( pFaces[ 0 ].minExtend );
+	decDVector maxExtend( pFaces[ 0 ].maxExtend );
+	double averageSize = 0.0;
+	int i, x, y, z;
+	
+	for( i=0; i<pFaceCount; i++ ){
+		const sFace &face = pFaces[ i ];
+		const decDVector size( face.maxExtend - face.minExtend );
+		averageSize += decMath::max( size.x, size.y, size.z );
+		minExtend.SetSmallest( face.minExtend );
+		maxExtend.SetLargest( face.maxExtend );
+	}
+	
+	pGridCellSize = decMath::max( averageSize / ( double )pFaceCount * 2.0, 0.1 );
+	
+	const decDVector gridSize( maxExtend - minExtend );
+	const double maxCellCount = ( double )( pFaceCount * 4 + 64 );
+	while( true ){
+		const double cellCount = ( floor( gridSize.x / pGridCellSize ) + 1.0 )
+			* ( floor( gridSize.y / pGridCellSize ) + 1.0 )
+			* ( floor( gridSize.z / pGridCellSize ) + 1.0 );
+		if( cellCount <= maxCellCount ){
+			break;
+		}
+		pGridCellSize *= 1.5;
+	}
+	
+	pGridOrigin = minExtend;
+	pGridSizeX = ( int )floor( gridSize.x / pGridCellSize ) + 1;
+	pGridSizeY = ( int )floor( gridSize.y / pGridCellSize ) + 1;
+	pGridSizeZ = ( int )floor( gridSize.z / pGridCellSize ) + 1;
+	
+	// count faces per cell then fill them in. pGridCells[cell] is the first entry in
+	// pGridFaces and pGridCells[cell+1] the entry after the last one
+	const int cellCount = pGridSizeX * pGridSizeY * pGridSizeZ;
+	pGridCells = new int[ cellCount + 1 ];
+	memset( pGridCells, 0, sizeof( int ) * ( cellCount + 1 ) );
+	
+	for( i=0; i<pFaceCount; i++ ){
+		const sFace &face = pFaces[ i ];
+		const int fromX = pGridIndex( face.minExtend.x, pGridOrigin.x, pGridSizeX );
+		const int fromY = pGridIndex( face.minExtend.y, pGridOrigin.y, pGridSizeY );
+		const int fromZ = pGridIndex( face.minExtend.z, pGridOrigin.z, pGridSizeZ );
+		const int toX = pGridIndex( face.maxExtend.x, pGridOrigin.x, pGridSizeX );
+		const int toY = pGridIndex( face.maxExtend.y, pGridOrigin.y, pGridSizeY );
+		const int toZ = pGridIndex( face.maxExtend.z, pGridOrigin.z, pGridSizeZ );
+		
+		for( z=fromZ; z<=toZ; z++ ){
+			for( y=fromY; y<=toY; y++ ){
+				for( x=fromX; x<=toX; x++ ){
+					pGridCells[ ( z * pGridSizeY + y ) * pGridSizeX + x + 1 ]++;
+				}
+			}
+		}
+	}
+	
+	for( i=0; i<cellCount; i++ ){
+		pGridCells[ i + 1 ] += pGridCells[ i ];
+	}
+	
+	pGridFaces = new int[ pGridCells[ cellCount ] ];
+	
+	int * const fillCounts = new int[ cellCount ];
+	memset( fillCounts, 0, sizeof( int ) * cellCount );
+	
+	for( i=0; i<pFaceCount; i++ ){
+		const sFace &face = pFaces[ i ];
+		const int fromX = pGridIndex( face.minExtend.x, pGridOrigin.x, pGridSizeX );
+		const int fromY = pGridIndex( face.minExtend.y, pGridOrigin.y, pGridSizeY );
+		const int fromZ = pGridIndex( face.minExtend.z, pGridOrigin.z, pGridSizeZ );
+		const int toX = pGridIndex( face.maxExtend.x, pGridOrigin.x, pGridSizeX );
+		const int toY = pGridIndex( face.maxExtend.y, pGridOrigin.y, pGridSizeY );
+		const int toZ = pGridIndex( face.maxExtend.z, pGridOrigin.z, pGridSizeZ );
+		
+		for( z=fromZ; z<=toZ; z++ ){
+			for( y=fromY; y<=toY; y++ ){
+				for( x=fromX; x<=toX; x++ ){
+					const int cell = ( z * pGridSizeY + y ) * pGridSizeX + x;
+					pGridFaces[ pGridCells[ cell ] + fillCounts[ cell ]++ ] = i;
+				}
+			}
+		}
+	}
+	
+	delete [] fillCounts;
+}
+
+
+
+int dedaiPathGraph::GetFaceClosestTo( const decDVector &position, double maxDistance, double &distance ) const{
+	if( ! pGridCells || maxDistance < 0.0 ){
+		return -1;
+	}
+	
+	const int fromX = pGridIndex( position.x - maxDistance, pGridOrigin.x, pGridSizeX );
+	const int fromY = pGridIndex( position.y - maxDistance, pGridOrigin.y, pGridSizeY );
+	const int fromZ = pGridIndex( position.z - maxDistance, pGridOrigin.z, pGridSizeZ );
+	const int toX = pGridIndex( position.x + maxDistance, pGridOrigin.x, pGridSizeX );
+	const int toY = pGridIndex( position.y + maxDistance, pGridOrigin.y, pGridSizeY );
+	const int toZ = pGridIndex( position.z + maxDistance, pGridOrigin.z, pGridSizeZ );
+	
+	double bestDistSquared = maxDistance * maxDistance;
+	int bestFace = -1;
+	int x, y, z, i;
+	
+	for( z=fromZ; z<=toZ; z++ ){
+		for( y=fromY; y<=toY; y++ ){
+			for( x=fromX; x<=toX; x++ ){
+				const int cell = ( z * pGridSizeY + y ) * pGridSizeX + x;
+				const int last = pGridCells[ cell + 1 ];
+				
+				for( i=pGridCells[ cell ]; i<last; i++ ){
+					const int faceIndex = pGridFaces[ i ];
+					if( faceIndex == bestFace ){
+						continue;
+					}
+					
+					// the distance to the face box is a lower bound of the distance to the face
+					const sFace &face = pFaces[ faceIndex ];
+					const decDVector closest( position.Largest( face.minExtend ).Smallest( face.maxExtend ) );
+					if( ( closest - position ).LengthSquared() > bestDistSquared ){
+						continue;
+					}
+					
+					const double testDistSquared = FaceDistanceSquared( faceIndex, position );
+					if( testDistSquared <= bestDistSquared ){
+						bestFace = faceIndex;
+						bestDistSquared = testDistSquared;
+					}
+				}
+			}
+		}
+	}
+	
+	if( bestFace != -1 ){
+		distance = sqrt( bestDistSquared );
+	}
+	return bestFace;
+}
+
+double dedaiPathGraph::FaceDistanceSquared( int face, const decDVector &position ) const{
+	if( face < 0 || face >= pFaceCount ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const sFace &testFace = pFaces[ face ];
+	const decDVector * const vertices = pVertices + testFace.firstVertex;
+	const decDVector &normal = testFace.normal;
+	int i;
+	
+	decDVector testPos( position + normal * ( normal * ( testFace.center - position ) ) );
+	
+	for( i=0; i<testFace.vertexCount; i++ ){
+		const decDVector &ev1 = vertices[ i ];
+		const decDVector &ev2 = vertices[ ( i + 1 ) % testFace.vertexCount ];
+		decDVector edgeNormal( normal % ( ev2 - ev1 ) );
+		const double length = edgeNormal.Length();
+		if( length < DOUBLE_SAFE_EPSILON ){
+			continue;
+		}
+		edgeNormal /= length;
+		
+		const double lambda = edgeNormal * ( testPos - ev1 );
+		if( lambda < 0.0 ){
+			testPos -= edgeNormal * lambda;
+		}
+	}
+	
+	return ( testPos - position ).LengthSquared();
+}
+
+
+
+dedaiPathGraphClusters *dedaiPathGraph::GetClusters( dedaiPathQueryCosts *costs ){
+	if( ! costs ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int count = pClusters.GetCount();
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		dedaiPathGraphClusters * const clusters = ( dedaiPathGraphClusters* )pClusters.GetAt( i );
+		if( clusters->GetCosts()->Equals( *costs ) ){
+			return clusters;
+		}
+	}
+	
+	// navigators sharing the same costs share the clusters. different costs are rare
+	// hence dropping the oldest clusters is enough to bound the memory consumption
+	if( count == MAX_CLUSTER_COSTS ){
+		pClusters.RemoveFrom( 0 );
+	}
+	
+	// reuse the clusters of the outdated graph using the same costs if present. these are
+	// not used anymore by the outdated graph since the layer replaced it
+	deThreadSafeObjectReference previous;
+	
+	if( pPreviousGraph ){
+		decThreadSafeObjectOrderedSet &previousClusters =
+			( ( dedaiPathGraph* )( deThreadSafeObject* )pPreviousGraph )->pClusters;
+		const int previousCount = previousClusters.GetCount();
+		
+		for( i=0; i<previousCount; i++ ){
+			dedaiPathGraphClusters * const clusters = ( dedaiPathGraphClusters* )previousClusters.GetAt( i );
+			if( clusters->GetCosts()->Equals( *costs ) && clusters->GetClusterCount() > 0 ){
+				previous = clusters;
+				previousClusters.RemoveFrom( i );
+				break;
+			}
+		}
+	}
+	
+	deThreadSafeObjectReference clusters;
+	
+	if( previous ){
+		clusters.TakeOver( new dedaiPathGraphClusters( *this, costs,
+			*( ( dedaiPathGraphClusters* )( deThreadSafeObject* )previous ),
+			pDirtyBoxes, pDirtyBoxCount ) );
+		
+	}else{
+		clusters.TakeOver( new dedaiPathGraphClusters( *this, costs, CLUSTER_SIZE ) );
+	}
+	
+	pClusters.Add( clusters );
+	
+	if( pPreviousGraph && ( ( dedaiPathGraph* )( deThreadSafeObject* )pPreviousGraph )->pClusters.GetCount() == 0 ){
+		pDropPreviousGraph();
+	}
+	
+	return ( dedaiPathGraphClusters* )( deThreadSafeObject* )clusters;
+}
+
+void dedaiPathGraph::SetPreviousGraph( dedaiPathGraph *graph, const decDVector *dirtyBoxes, int dirtyBoxCount ){
+	if( graph == this || dirtyBoxCount < 0 || ( dirtyBoxCount > 0 && ! dirtyBoxes ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pDropPreviousGraph();
+	
+	if( ! graph || graph->pClusters.GetCount() == 0 ){
+		return;
+	}
+	
+	if( dirtyBoxCount > 0 ){
+		pDirtyBoxes = new decDVector[ dirtyBoxCount * 2 ];
+		int i;
+		for( i=0; i<dirtyBoxCount*2; i++ ){
+			pDirtyBoxes[ i ] = dirtyBoxes[ i ];
+		}
+		pDirtyBoxCount = dirtyBoxCount;
+	}
+	
+	// the outdated graph is not used anymore to build clusters. drop its own outdated graph
+	// to not keep a chain of graphs alive
+	graph->pDropPreviousGraph();
+	pPreviousGraph = graph;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void dedaiPathGraph::pAddMeshFaces( dedaiSpaceMesh &mesh, int *faceMap ){
+	const decDMatrix &matrix = mesh.GetSpace().GetMatrix();
+	const dedaiSpaceMeshCorner * const corners = mesh.GetCorners();
+	const dedaiSpaceMeshFace * const faces = mesh.GetFaces();
+	const decVector * const vertices = mesh.GetVertices();
+	const int vertexCount = mesh.GetVertexCount();
+	const int faceCount = mesh.GetFaceCount();
+	const int vertexBase = pVertexCount;
+	int i, j;
+	
+	// vertices are shared by faces. add them all in world space using the vertex base
+	for( i=0; i<vertexCount; i++ ){
+		AddVertex( matrix * decDVector( vertices[ i ] ) );
+	}
+	
+	// faces require their vertices in polygon order. these are added after the shared
+	// vertices. the portal vertices use the shared vertices
+	for( i=0; i<faceCount; i++ ){
+		const dedaiSpaceMeshFace &face = faces[ i ];
+		const int cornerCount = face.GetCornerCount();
+		
+		if( ! face.GetEnabled() || cornerCount < 3 ){
+			faceMap[ i ] = -1;
+			continue;
+		}
+		
+		const int firstVertex = pVertexCount;
+		const dedaiSpaceMeshCorner * const faceCorners = corners + face.GetFirstCorner();
+		for( j=0; j<cornerCount; j++ ){
+			const decDVector position( pVertices[ vertexBase + faceCorners[ j ].GetVertex() ] );
+			AddVertex( position );
+		}
+		
+		faceMap[ i ] = AddFace( firstVertex, cornerCount, face.GetTypeNumber() );
+	}
+}
+
+void dedaiPathGraph::pAddMeshLinks( dedaiSpaceMesh &mesh, const decPointerList &meshes,
+int **faceMaps, const int *vertexBases ){
+	const int meshIndex = meshes.IndexOf( &mesh );
+	const int * const faceMap = faceMaps[ meshIndex ];
+	const int vertexBase = vertexBases[ meshIndex ];
+	const dedaiSpaceMeshCorner * const corners = mesh.GetCorners();
+	const dedaiSpaceMeshEdge * const edges = mesh.GetEdges();
+	const dedaiSpaceMeshLink * const links = mesh.GetLinks();
+	const dedaiSpaceMeshFace * const faces = mesh.GetFaces();
+	const int faceCount = mesh.GetFaceCount();
+	int i, j;
+	
+	for( i=0; i<faceCount; i++ ){
+		const int graphFace = faceMap[ i ];
+		if( graphFace == -1 ){
+			continue;
+		}
+		
+		const dedaiSpaceMeshFace &face = faces[ i ];
+		const int cornerCount = face.GetCornerCount();
+		const dedaiSpaceMeshCorner * const faceCorners = corners + face.GetFirstCorner();
+		
+		for( j=0; j<cornerCount; j++ ){
+			const dedaiSpaceMeshCorner &corner = faceCorners[ j ];
+			const dedaiSpaceMeshEdge &edge = edges[ corner.GetEdge() ];
+			const int vertex1 = vertexBase + corner.GetVertex();
+			const int vertex2 = vertexBase + faceCorners[ ( j + 1 ) % cornerCount ].GetVertex();
+			int neighborFace = -1;
+			
+			if( edge.GetFace2() == -1 ){
+				if( corner.GetLink() != CORNER_NO_LINK ){
+					const dedaiSpaceMeshLink &link = links[ corner.GetLink() ];
+					const int linkMeshIndex = meshes.IndexOf( link.GetMesh() );
+					if( linkMeshIndex != -1 ){
+						neighborFace = faceMaps[ linkMeshIndex ][ link.GetFace() ];
+					}
+				}
+				
+			}else if( edge.GetFace1() == i ){
+				neighborFace = faceMap[ edge.GetFace2() ];
+				
+			}else{
+				neighborFace = faceMap[ edge.GetFace1() ];
+			}
+			
+			if( neighborFace != -1 ){
+				AddLink( graphFace, neighborFace, vertex1, vertex2 );
+			}
+		}
+	}
+}
+
+void dedaiPathGraph::pDropPreviousGraph(){
+	pPreviousGraph = NULL;
+	
+	if( pDirtyBoxes ){
+		delete [] pDirtyBoxes;
+		pDirtyBoxes = NULL;
+	}
+	pDirtyBoxCount = 0;
+}
+
+int dedaiPathGraph::pGridIndex( double value, double origin, int size ) const{
+	const int index = ( int )floor( ( value - origin ) / pGridCellSize );
+	return decMath::clamp( index, 0, size - 1 );
+}
@@ -0,0 +1,261 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHGRAPH_H_
+#define _DEDAIPATHGRAPH_H_
+
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/threading/deThreadSafeObject.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+class decPointerList;
+class dedaiPathGraphClusters;
+class dedaiPathQueryCosts;
+class dedaiSpaceMesh;
+class dedaiSpaceMeshFace;
+
+
+
+/**
+ * \brief Read-only path finding graph snapshot.
+ * 
+ * Flattened copy of all navigation mesh faces of a layer in world space. Contains face
+ * centers, face polygons, cost types and portals between neighbor faces. Once built the
+ * graph is never modified again and can be safely used by parallel tasks while the live
+ * navigation spaces are modified on the main thread. Layers drop their graph if they
+ * become dirty and create a new one on demand.
+ * 
+ * Faces are located using a uniform grid storing for each cell the faces overlapping it.
+ * 
+ * For large graphs cluster abstractions can be created for hierarchical searches. These
+ * are created on demand for each costs used and kept with the graph. If the graph replaces
+ * an outdated graph the clusters are built incrementally from the clusters of the outdated
+ * graph. Only clusters touching the areas changed since then are built from scratch.
+ */
+class dedaiPathGraph : public deThreadSafeObject{
+public:
+	/** \brief Face. */
+	struct sFace{
+		/** \brief Center in world space. */
+		decDVector center;
+		
+		/** \brief Normal in world space. */
+		decDVector normal;
+		
+		/** \brief Minimum extend in world space. */
+		decDVector minExtend;
+		
+		/** \brief Maximum extend in world space. */
+		decDVector maxExtend;
+		
+		/** \brief Index of first vertex. */
+		int firstVertex;
+		
+		/** \brief Number of vertices. */
+		int vertexCount;
+		
+		/** \brief Index of first link. */
+		int firstLink;
+		
+		/** \brief Number of links. */
+		int linkCount;
+		
+		/** \brief Cost table type index. */
+		int costType;
+	};
+	
+	/**
+	 * \brief Link to neighbor face.
+	 * 
+	 * Portal vertices are oriented as seen from the face owning the link. Moving through
+	 * the portal the left vertex is located on the left side and the right vertex on the
+	 * right side relative to the face normal.
+	 */
+	struct sLink{
+		/** \brief Index of neighbor face. */
+		int face;
+		
+		/** \brief Index of left portal vertex. */
+		int vertexLeft;
+		
+		/** \brief Index of right portal vertex. */
+		int vertexRight;
+	};
+	
+	
+	
+private:
+	decDVector *pVertices;
+	int pVertexCount;
+	int pVertexSize;
+	
+	sFace *pFaces;
+	int pFaceCount;
+	int pFaceSize;
+	
+	sLink *pLinks;
+	int pLinkCount;
+	int pLinkSize;
+	
+	decDVector pGridOrigin;
+	double pGridCellSize;
+	int pGridSizeX;
+	int pGridSizeY;
+	int pGridSizeZ;
+	int *pGridCells;
+	int *pGridFaces;
+	
+	decThreadSafeObjectOrderedSet pClusters;
+	
+	deThreadSafeObjectReference pPreviousGraph;
+	decDVector *pDirtyBoxes;
+	int pDirtyBoxCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create empty graph. */
+	dedaiPathGraph();
+	
+protected:
+	/** \brief Clean up graph. */
+	virtual ~dedaiPathGraph();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of vertices. */
+	inline int GetVertexCount() const{ return pVertexCount; }
+	
+	/** \brief Vertices. */
+	inline const decDVector *GetVertices() const{ return pVertices; }
+	
+	/** \brief Number of faces. */
+	inline int GetFaceCount() const{ return pFaceCount; }
+	
+	/** \brief Faces. */
+	inline const sFace *GetFaces() const{ return pFaces; }
+	
+	/** \brief Number of links. */
+	inline int GetLinkCount() const{ return pLinkCount; }
+	
+	/** \brief Links. */
+	inline const sLink *GetLinks() const{ return pLinks; }
+	
+	
+	
+	/**
+	 * \brief Add vertex.
+	 * \returns Index of the added vertex.
+	 */
+	int AddVertex( const decDVector &position );
+	
+	/**
+	 * \brief Add face.
+	 * 
+	 * The face uses \em vertexCount vertices starting at \em firstVertex in polygon order.
+	 * Center, normal and extends are calculated from the vertices. Links are added using
+	 * AddLink() after adding all faces.
+	 * 
+	 * \returns Index of the added face.
+	 */
+	int AddFace( int firstVertex, int vertexCount, int costType );
+	
+	/**
+	 * \brief Add link from face to neighbor face.
+	 * 
+	 * Links of a face have to be added all at once. The portal vertices are oriented
+	 * automatically.
+	 */
+	void AddLink( int face, int neighborFace, int vertex1, int vertex2 );
+	
+	/**
+	 * \brief Init graph from navigation meshes.
+	 * 
+	 * \em meshes contains dedaiSpaceMesh. Disabled faces are skipped. Links to navigation
+	 * meshes not present in \em meshes are ignored. Calls BuildLookupGrid().
+	 */
+	void InitFromMeshes( const decPointerList &meshes );
+	
+	/** \brief Build face lookup grid. Call after adding all faces. */
+	void BuildLookupGrid();
+	
+	
+	
+	/**
+	 * \brief Face closest to position.
+	 * 
+	 * Only faces inside \em maxDistance are considered. Uses the same distance calculation
+	 * as dedaiSpaceMesh::GetFaceClosestTo().
+	 * 
+	 * \returns Face index or -1 if not found.
+	 */
+	int GetFaceClosestTo( const decDVector &position, double maxDistance, double &distance ) const;
+	
+	/** \brief Squared distance from position to face polygon. */
+	double FaceDistanceSquared( int face, const decDVector &position ) const;
+	
+	
+	
+	/**
+	 * \brief Cluster abstraction for costs.
+	 * 
+	 * Creates clusters if not existing yet. Only the last few costs used are kept.
+	 * 
+	 * \warning Call only from the main thread. Building clusters is expensive. Call
+	 *          after all faces and links have been added.
+	 */
+	dedaiPathGraphClusters *GetClusters( dedaiPathQueryCosts *costs );
+	
+	/**
+	 * \brief Set outdated graph to build clusters incrementally from.
+	 * 
+	 * Clusters of \em graph are reused by GetClusters() where the graph did not change.
+	 * The outdated graph is kept until all its clusters have been reused or this graph
+	 * is replaced too.
+	 * 
+	 * \param[in] graph Outdated graph or \em NULL to build all clusters from scratch.
+	 * \param[in] dirtyBoxes Minimum and maximum extends of areas changed since \em graph
+	 *                       has been built stored in pairs. Contains 2 * \em dirtyBoxCount
+	 *                       entries.
+	 * 
+	 * \warning Call only from the main thread.
+	 */
+	void SetPreviousGraph( dedaiPathGraph *graph, const decDVector *dirtyBoxes, int dirtyBoxCount );
+	/*@}*/
+	
+	
+	
+private:
+	void pAddMeshFaces( dedaiSpaceMesh &mesh, int *faceMap );
+	void pAddMeshLinks( dedaiSpaceMesh &mesh, const decPointerList &meshes,
+		int **faceMaps, const int *vertexBases );
+	int pGridIndex( double value, double origin, int size ) const;
+	void pDropPreviousGraph();
+};
+
+#endif
@@ -0,0 +1,769 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dedaiPathGraph.h"
+#include "dedaiPathGraphClusters.h"
+#include "dedaiPathGraphSearch.h"
+#include "../query/dedaiPathQueryCosts.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Definitions
+////////////////
+
+struct sClusterCrossing{
+	int face;
+	int neighbor;
+	int parent;
+	int count;
+	decDVector center;
+	double bestDistance;
+	int best;
+};
+
+struct dedaiPathGraphClusters::sClusterKey{
+	decDVector center;
+	int cluster;
+};
+
+static int fCompareCenters( const decDVector &a, const decDVector &b ){
+	if( a.x != b.x ){
+		return a.x < b.x ? -1 : 1;
+	}
+	if( a.y != b.y ){
+		return a.y < b.y ? -1 : 1;
+	}
+	if( a.z != b.z ){
+		return a.z < b.z ? -1 : 1;
+	}
+	return 0;
+}
+
+static int fSortClusterKeys( const void *a, const void *b ){
+	// cluster keys start with the center
+	return fCompareCenters( *( ( const decDVector* )a ), *( ( const decDVector* )b ) );
+}
+
+
+
+// Class dedaiPathGraphClusters
+/////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathGraphClusters::dedaiPathGraphClusters( const dedaiPathGraph &graph,
+dedaiPathQueryCosts *costs, int clusterSize ) :
+pGraph( graph ),
+pCosts( costs ),
+
+pCellSize( 1.0 ),
+
+pFaceClusters( NULL ),
+pFaceEntrances( NULL ),
+
+pClusters( NULL ),
+pClusterCount( 0 ),
+pClusterFaces( NULL ),
+pClusterFaceIndices( NULL ),
+
+pEntrances( NULL ),
+pEntranceCount( 0 ),
+
+pEdges( NULL ),
+pEdgeCount( 0 ),
+
+pEntranceCosts( NULL ),
+
+pReusedClusterCount( 0 )
+{
+	if( ! costs || clusterSize < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	try{
+		pInitCells( clusterSize );
+		pBuildClusters();
+		pBuildEntrances();
+		pBuildEntranceCosts( NULL, NULL, 0 );
+		pBuildEdges();
+		
+	}catch( const deException & ){
+		pCleanUp();
+		throw;
+	}
+}
+
+dedaiPathGraphClusters::dedaiPathGraphClusters( const dedaiPathGraph &graph,
+dedaiPathQueryCosts *costs, const dedaiPathGraphClusters &previous,
+const decDVector *dirtyBoxes, int dirtyBoxCount ) :
+pGraph( graph ),
+pCosts( costs ),
+
+pOrigin( previous.pOrigin ),
+pCellSize( previous.pCellSize ),
+
+pFaceClusters( NULL ),
+pFaceEntrances( NULL ),
+
+pClusters( NULL ),
+pClusterCount( 0 ),
+pClusterFaces( NULL ),
+pClusterFaceIndices( NULL ),
+
+pEntrances( NULL ),
+pEntranceCount( 0 ),
+
+pEdges( NULL ),
+pEdgeCount( 0 ),
+
+pEntranceCosts( NULL ),
+
+pReusedClusterCount( 0 )
+{
+	if( ! costs || ! costs->Equals( *previous.GetCosts() ) || dirtyBoxCount < 0
+	|| ( dirtyBoxCount > 0 && ! dirtyBoxes ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	// using the same cells produces the same clusters where the graph did not change
+	try{
+		pBuildClusters();
+		pBuildEntrances();
+		pBuildEntranceCosts( &previous, dirtyBoxes, dirtyBoxCount );
+		pBuildEdges();
+		
+	}catch( const deException & ){
+		pCleanUp();
+		throw;
+	}
+}
+
+dedaiPathGraphClusters::~dedaiPathGraphClusters(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+dedaiPathQueryCosts *dedaiPathGraphClusters::GetCosts() const{
+	return ( dedaiPathQueryCosts* )( deThreadSafeObject* )pCosts;
+}
+
+float dedaiPathGraphClusters::GetEntranceCostTo( int entrance, int face ) const{
+	const sEntrance &entranceData = pEntrances[ entrance ];
+	const sCluster &cluster = pClusters[ entranceData.cluster ];
+	
+	if( pFaceClusters[ face ] != entranceData.cluster ){
+		return -1.0f;
+	}
+	
+	return pEntranceCosts[ cluster.firstEntranceCost
+		+ ( entrance - cluster.firstEntrance ) * cluster.faceCount
+		+ pClusterFaceIndices[ face ] ];
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void dedaiPathGraphClusters::pCleanUp(){
+	if( pEntranceCosts ){
+		delete [] pEntranceCosts;
+	}
+	if( pEdges ){
+		delete [] pEdges;
+	}
+	if( pEntrances ){
+		delete [] pEntrances;
+	}
+	if( pClusterFaceIndices ){
+		delete [] pClusterFaceIndices;
+	}
+	if( pClusterFaces ){
+		delete [] pClusterFaces;
+	}
+	if( pClusters ){
+		delete [] pClusters;
+	}
+	if( pFaceEntrances ){
+		delete [] pFaceEntrances;
+	}
+	if( pFaceClusters ){
+		delete [] pFaceClusters;
+	}
+}
+
+void dedaiPathGraphClusters::pInitCells( int clusterSize ){
+	const int faceCount = pGraph.GetFaceCount();
+	if( faceCount == 0 ){
+		return;
+	}
+	
+	const dedaiPathGraph::sFace * const faces = pGraph.GetFaces();
+	double averageSize = 0.0;
+	int i;
+	
+	// clusters are connected faces inside cubic cells. cell size is chosen to contain
+	// roughly cluster size faces on walkable surfaces. cells produce straight cluster
+	// borders which keeps the number of border segments and thus entrances low
+	pOrigin = faces[ 0 ].center;
+	
+	for( i=0; i<faceCount; i++ ){
+		const dedaiPathGraph::sFace &face = faces[ i ];
+		const decDVector size( face.maxExtend - face.minExtend );
+		averageSize += decMath::max( size.x, size.y, size.z );
+		pOrigin.SetSmallest( face.center );
+	}
+	
+	pCellSize = decMath::max( averageSize / ( double )faceCount
+		* sqrt( ( double )clusterSize ), 0.1 );
+}
+
+void dedaiPathGraphClusters::pBuildClusters(){
+	const int faceCount = pGraph.GetFaceCount();
+	if( faceCount == 0 ){
+		return;
+	}
+	
+	const dedaiPathGraph::sFace * const faces = pGraph.GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph.GetLinks();
+	int i, j;
+	
+	pFaceClusters = new int[ faceCount ];
+	pClusterFaces = new int[ faceCount ];
+	pClusterFaceIndices = new int[ faceCount ];
+	pClusters = new sCluster[ faceCount ];
+	
+	for( i=0; i<faceCount; i++ ){
+		pFaceClusters[ i ] = -1;
+	}
+	
+	// flood fill cells starting at the first unassigned face. the cluster face list
+	// doubles as flooding queue
+	int clusterFaceCount = 0;
+	
+	for( i=0; i<faceCount; i++ ){
+		if( pFaceClusters[ i ] != -1 ){
+			continue;
+		}
+		
+		const decDVector cell( pCellOf( faces[ i ].center ) );
+		
+		sCluster &cluster = pClusters[ pClusterCount ];
+		cluster.firstFace = clusterFaceCount;
+		cluster.faceCount = 1;
+		cluster.firstEntrance = 0;
+		cluster.entranceCount = 0;
+		cluster.firstEntranceCost = 0;
+		
+		pFaceClusters[ i ] = pClusterCount;
+		pClusterFaces[ clusterFaceCount++ ] = i;
+		
+		int next;
+		for( next=cluster.firstFace; next<clusterFaceCount; next++ ){
+			const dedaiPathGraph::sFace &face = faces[ pClusterFaces[ next ] ];
+			const int lastLink = face.firstLink + face.linkCount;
+			
+			for( j=face.firstLink; j<lastLink; j++ ){
+				const int neighbor = links[ j ].face;
+				if( pFaceClusters[ neighbor ] != -1
+				|| ! pCellOf( faces[ neighbor ].center ).IsEqualTo( cell, 0.5 ) ){
+					continue;
+				}
+				
+				pFaceClusters[ neighbor ] = pClusterCount;
+				pClusterFaces[ clusterFaceCount++ ] = neighbor;
+				cluster.faceCount++;
+			}
+		}
+		
+		pClusterCount++;
+	}
+	
+	for( i=0; i<pClusterCount; i++ ){
+		const sCluster &cluster = pClusters[ i ];
+		for( j=0; j<cluster.faceCount; j++ ){
+			pClusterFaceIndices[ pClusterFaces[ cluster.firstFace + j ] ] = j;
+		}
+	}
+}
+
+decDVector dedaiPathGraphClusters::pCellOf( const decDVector &position ) const{
+	return decDVector( floor( ( position.x - pOrigin.x ) / pCellSize ),
+		floor( ( position.y - pOrigin.y ) / pCellSize ),
+		floor( ( position.z - pOrigin.z ) / pCellSize ) );
+}
+
+void dedaiPathGraphClusters::pBuildEntrances(){
+	const int faceCount = pGraph.GetFaceCount();
+	if( faceCount == 0 ){
+		return;
+	}
+	
+	int i, j;
+	
+	pFaceEntrances = new int[ faceCount ];
+	for( i=0; i<faceCount; i++ ){
+		pFaceEntrances[ i ] = -1;
+	}
+	
+	const int entranceCount = pMarkEntrances();
+	if( entranceCount == 0 ){
+		return;
+	}
+	
+	// entrances are stored grouped by cluster
+	pEntrances = new sEntrance[ entranceCount ];
+	
+	for( i=0; i<pClusterCount; i++ ){
+		sCluster &cluster = pClusters[ i ];
+		cluster.firstEntrance = pEntranceCount;
+		
+		for( j=0; j<cluster.faceCount; j++ ){
+			const int face = pClusterFaces[ cluster.firstFace + j ];
+			if( pFaceEntrances[ face ] == -1 ){
+				continue;
+			}
+			
+			sEntrance &entrance = pEntrances[ pEntranceCount ];
+			entrance.face = face;
+			entrance.cluster = i;
+			entrance.firstEdge = 0;
+			entrance.edgeCount = 0;
+			pFaceEntrances[ face ] = pEntranceCount++;
+		}
+		
+		cluster.entranceCount = pEntranceCount - cluster.firstEntrance;
+	}
+}
+
+int dedaiPathGraphClusters::pMarkEntrances(){
+	const int faceCount = pGraph.GetFaceCount();
+	const dedaiPathGraph::sFace * const faces = pGraph.GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph.GetLinks();
+	sClusterCrossing *crossings = NULL;
+	int *faceCrossings = NULL;
+	int crossingCount = 0;
+	int entranceCount = 0;
+	int i, j, k, l;
+	
+	// crossings are links between faces of different clusters. crossings into the same
+	// neighbor cluster from linked faces form a border segment. like HPA* only one
+	// crossing per segment is used as entrance. this keeps the number of entrances low.
+	// the crossing closest to the segment center is used
+	try{
+		faceCrossings = new int[ faceCount + 1 ];
+		
+		for( i=0; i<faceCount; i++ ){
+			const dedaiPathGraph::sFace &face = faces[ i ];
+			const int lastLink = face.firstLink + face.linkCount;
+			
+			faceCrossings[ i ] = crossingCount;
+			for( j=face.firstLink; j<lastLink; j++ ){
+				if( pFaceClusters[ links[ j ].face ] != pFaceClusters[ i ] ){
+					crossingCount++;
+				}
+			}
+		}
+		faceCrossings[ faceCount ] = crossingCount;
+		
+		if( crossingCount == 0 ){
+			delete [] faceCrossings;
+			return 0;
+		}
+		
+		crossings = new sClusterCrossing[ crossingCount ];
+		
+		for( i=0, k=0; i<faceCount; i++ ){
+			const dedaiPathGraph::sFace &face = faces[ i ];
+			const int lastLink = face.firstLink + face.linkCount;
+			
+			for( j=face.firstLink; j<lastLink; j++ ){
+				const int neighbor = links[ j ].face;
+				if( pFaceClusters[ neighbor ] == pFaceClusters[ i ] ){
+					continue;
+				}
+				
+				sClusterCrossing &crossing = crossings[ k ];
+				crossing.face = i;
+				crossing.neighbor = neighbor;
+				crossing.parent = k++;
+				crossing.count = 0;
+				crossing.bestDistance = 0.0;
+				crossing.best = -1;
+			}
+		}
+		
+		// merge crossings into segments using union-find
+		for( i=0; i<crossingCount; i++ ){
+			const sClusterCrossing &crossing = crossings[ i ];
+			const int cluster = pFaceClusters[ crossing.face ];
+			const int targetCluster = pFaceClusters[ crossing.neighbor ];
+			const dedaiPathGraph::sFace &face = faces[ crossing.face ];
+			const int lastLink = face.firstLink + face.linkCount;
+			
+			for( j=face.firstLink-1; j<lastLink; j++ ){
+				// j before first link tests the face itself
+				const int testFace = j < face.firstLink ? crossing.face : links[ j ].face;
+				if( pFaceClusters[ testFace ] != cluster ){
+					continue;
+				}
+				
+				for( k=faceCrossings[ testFace ]; k<faceCrossings[ testFace + 1 ]; k++ ){
+					if( k == i || pFaceClusters[ crossings[ k ].neighbor ] != targetCluster ){
+						continue;
+					}
+					
+					int root1 = i;
+					while( crossings[ root1 ].parent != root1 ){
+						root1 = crossings[ root1 ].parent;
+					}
+					int root2 = k;
+					while( crossings[ root2 ].parent != root2 ){
+						root2 = crossings[ root2 ].parent;
+					}
+					crossings[ root2 ].parent = root1;
+				}
+			}
+		}
+		
+		// flatten and find segment centers
+		for( i=0; i<crossingCount; i++ ){
+			l = i;
+			while( crossings[ l ].parent != l ){
+				l = crossings[ l ].parent;
+			}
+			crossings[ i ].parent = l;
+			
+			sClusterCrossing &segment = crossings[ l ];
+			if( segment.count == 0 ){
+				segment.center.SetZero();
+			}
+			segment.center += faces[ crossings[ i ].face ].center;
+			segment.count++;
+		}
+		
+		for( i=0; i<crossingCount; i++ ){
+			sClusterCrossing &segment = crossings[ crossings[ i ].parent ];
+			const double distance = ( faces[ crossings[ i ].face ].center
+				- segment.center / ( double )segment.count ).LengthSquared();
+			if( segment.best == -1 || distance < segment.bestDistance ){
+				segment.best = i;
+				segment.bestDistance = distance;
+			}
+		}
+		
+		// both faces of the best crossing are entrances. links are usually symmetric but
+		// marking both sides ensures one-way links can be used too
+		for( i=0; i<crossingCount; i++ ){
+			if( crossings[ i ].parent != i ){
+				continue;
+			}
+			
+			const sClusterCrossing &best = crossings[ crossings[ i ].best ];
+			if( pFaceEntrances[ best.face ] == -1 ){
+				pFaceEntrances[ best.face ] = 0;
+				entranceCount++;
+			}
+			if( pFaceEntrances[ best.neighbor ] == -1 ){
+				pFaceEntrances[ best.neighbor ] = 0;
+				entranceCount++;
+			}
+		}
+		
+		delete [] crossings;
+		delete [] faceCrossings;
+		
+	}catch( const deException & ){
+		if( crossings ){
+			delete [] crossings;
+		}
+		if( faceCrossings ){
+			delete [] faceCrossings;
+		}
+		throw;
+	}
+	
+	return entranceCount;
+}
+
+void dedaiPathGraphClusters::pBuildEntranceCosts( const dedaiPathGraphClusters *previous,
+const decDVector *dirtyBoxes, int dirtyBoxCount ){
+	if( pEntranceCount == 0 ){
+		return;
+	}
+	
+	sClusterKey *previousKeys = NULL;
+	int costCount = 0;
+	int i, j;
+	
+	for( i=0; i<pClusterCount; i++ ){
+		sCluster &cluster = pClusters[ i ];
+		cluster.firstEntranceCost = costCount;
+		costCount += cluster.entranceCount * cluster.faceCount;
+	}
+	
+	pEntranceCosts = new float[ costCount ];
+	
+	const dedaiPathQueryCosts &costs = *GetCosts();
+	dedaiPathGraphSearch search;
+	search.SetGraph( &pGraph );
+	
+	try{
+		if( previous && previous->pEntranceCount > 0 ){
+			previousKeys = pCreateClusterKeys( *previous );
+		}
+		
+		for( i=0; i<pClusterCount; i++ ){
+			const sCluster &cluster = pClusters[ i ];
+			if( cluster.entranceCount == 0 ){
+				continue;
+			}
+			
+			// entrances at the same face of a matching previous cluster have the same costs.
+			// only new entrances and entrances of changed clusters have to be searched
+			const int previousIndex = previousKeys ? pMatchPreviousCluster(
+				i, *previous, previousKeys, dirtyBoxes, dirtyBoxCount ) : -1;
+			if( previousIndex != -1 ){
+				pReusedClusterCount++;
+			}
+			
+			for( j=0; j<cluster.entranceCount; j++ ){
+				const int face = pEntrances[ cluster.firstEntrance + j ].face;
+				float * const faceCosts = pEntranceCosts + cluster.firstEntranceCost + j * cluster.faceCount;
+				
+				if( previousIndex != -1 ){
+					const sCluster &previousCluster = previous->pClusters[ previousIndex ];
+					const int previousEntrance = previous->pFaceEntrances[ previous->pClusterFaces[
+						previousCluster.firstFace + pClusterFaceIndices[ face ] ] ];
+					
+					if( previousEntrance != -1 ){
+						memcpy( faceCosts, previous->pEntranceCosts + previousCluster.firstEntranceCost
+							+ ( previousEntrance - previousCluster.firstEntrance ) * cluster.faceCount,
+							sizeof( float ) * cluster.faceCount );
+						continue;
+					}
+				}
+				
+				search.FindClusterCosts( costs, *this, face, faceCosts );
+			}
+		}
+		
+		if( previousKeys ){
+			delete [] previousKeys;
+		}
+		
+	}catch( const deException & ){
+		if( previousKeys ){
+			delete [] previousKeys;
+		}
+		throw;
+	}
+}
+
+dedaiPathGraphClusters::sClusterKey *dedaiPathGraphClusters::pCreateClusterKeys(
+const dedaiPathGraphClusters &clusters ){
+	const dedaiPathGraph::sFace * const faces = clusters.pGraph.GetFaces();
+	sClusterKey * const keys = new sClusterKey[ clusters.pClusterCount ];
+	int i;
+	
+	// clusters are identified by the center of their first face. graph faces keep their
+	// order where meshes did not change hence the flood fill starts at the same face
+	for( i=0; i<clusters.pClusterCount; i++ ){
+		keys[ i ].center = faces[ clusters.pClusterFaces[ clusters.pClusters[ i ].firstFace ] ].center;
+		keys[ i ].cluster = i;
+	}
+	
+	qsort( keys, clusters.pClusterCount, sizeof( sClusterKey ), fSortClusterKeys );
+	return keys;
+}
+
+int dedaiPathGraphClusters::pMatchPreviousCluster( int cluster, const dedaiPathGraphClusters &previous,
+const sClusterKey *previousKeys, const decDVector *dirtyBoxes, int dirtyBoxCount ) const{
+	const dedaiPathGraph::sFace * const faces = pGraph.GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph.GetLinks();
+	const sCluster &clusterData = pClusters[ cluster ];
+	const int * const clusterFaces = pClusterFaces + clusterData.firstFace;
+	int i, j;
+	
+	// clusters touching a changed area are built from scratch
+	if( dirtyBoxCount > 0 ){
+		decDVector minExtend( faces[ clusterFaces[ 0 ] ].minExtend );
+		decDVector maxExtend( faces[ clusterFaces[ 0 ] ].maxExtend );
+		
+		for( i=1; i<clusterData.faceCount; i++ ){
+			minExtend.SetSmallest( faces[ clusterFaces[ i ] ].minExtend );
+			maxExtend.SetLargest( faces[ clusterFaces[ i ] ].maxExtend );
+		}
+		
+		for( i=0; i<dirtyBoxCount; i++ ){
+			if( maxExtend >= dirtyBoxes[ i * 2 ] && minExtend <= dirtyBoxes[ i * 2 + 1 ] ){
+				return -1;
+			}
+		}
+	}
+	
+	// find previous cluster starting at the same face
+	const decDVector &firstCenter = faces[ clusterFaces[ 0 ] ].center;
+	int low = 0;
+	int high = previous.pClusterCount - 1;
+	int found = -1;
+	
+	while( low <= high ){
+		const int middle = ( low + high ) / 2;
+		const int result = fCompareCenters( previousKeys[ middle ].center, firstCenter );
+		
+		if( result < 0 ){
+			low = middle + 1;
+			
+		}else if( result > 0 ){
+			high = middle - 1;
+			
+		}else{
+			found = previousKeys[ middle ].cluster;
+			break;
+		}
+	}
+	
+	if( found == -1 ){
+		return -1;
+	}
+	
+	// changes not covered by the dirty boxes are caught by comparing the clusters face by
+	// face. entrance costs depend only on face centers, cost types and links inside the
+	// cluster. the flood fill visits the faces in the same order if these are equal
+	const sCluster &previousCluster = previous.pClusters[ found ];
+	if( previousCluster.faceCount != clusterData.faceCount ){
+		return -1;
+	}
+	
+	const dedaiPathGraph::sFace * const previousFaces = previous.pGraph.GetFaces();
+	const dedaiPathGraph::sLink * const previousLinks = previous.pGraph.GetLinks();
+	const int * const previousClusterFaces = previous.pClusterFaces + previousCluster.firstFace;
+	
+	for( i=0; i<clusterData.faceCount; i++ ){
+		const dedaiPathGraph::sFace &face = faces[ clusterFaces[ i ] ];
+		const dedaiPathGraph::sFace &previousFace = previousFaces[ previousClusterFaces[ i ] ];
+		
+		if( face.costType != previousFace.costType || face.linkCount != previousFace.linkCount
+		|| fCompareCenters( face.center, previousFace.center ) != 0 ){
+			return -1;
+		}
+		
+		for( j=0; j<face.linkCount; j++ ){
+			const int neighbor = links[ face.firstLink + j ].face;
+			const int previousNeighbor = previousLinks[ previousFace.firstLink + j ].face;
+			const bool inside = pFaceClusters[ neighbor ] == cluster;
+			
+			if( inside != ( previous.pFaceClusters[ previousNeighbor ] == found ) ){
+				return -1;
+			}
+			if( inside && pClusterFaceIndices[ neighbor ] != previous.pClusterFaceIndices[ previousNeighbor ] ){
+				return -1;
+			}
+		}
+	}
+	
+	return found;
+}
+
+void dedaiPathGraphClusters::pBuildEdges(){
+	if( pEntranceCount == 0 ){
+		return;
+	}
+	
+	const dedaiPathGraph::sFace * const faces = pGraph.GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph.GetLinks();
+	const dedaiPathQueryCosts &costs = *GetCosts();
+	const float blockingCost = costs.GetBlockingCost();
+	int i, j;
+	
+	// upper bound of edges is all entrances of a cluster connected to each other plus
+	// all links crossing clusters
+	int edgeSize = 0;
+	for( i=0; i<pClusterCount; i++ ){
+		edgeSize += pClusters[ i ].entranceCount * pClusters[ i ].entranceCount;
+	}
+	for( i=0; i<pEntranceCount; i++ ){
+		edgeSize += faces[ pEntrances[ i ].face ].linkCount;
+	}
+	
+	pEdges = new sEdge[ edgeSize ];
+	
+	for( i=0; i<pEntranceCount; i++ ){
+		sEntrance &entrance = pEntrances[ i ];
+		const sCluster &cluster = pClusters[ entrance.cluster ];
+		const float * const entranceCosts = pEntranceCosts + cluster.firstEntranceCost
+			+ ( i - cluster.firstEntrance ) * cluster.faceCount;
+		
+		entrance.firstEdge = pEdgeCount;
+		
+		// edges through the cluster
+		for( j=0; j<cluster.entranceCount; j++ ){
+			const int target = cluster.firstEntrance + j;
+			if( target == i ){
+				continue;
+			}
+			
+			const float cost = entranceCosts[ pClusterFaceIndices[ pEntrances[ target ].face ] ];
+			if( cost < 0.0f ){
+				continue;
+			}
+			
+			sEdge &edge = pEdges[ pEdgeCount++ ];
+			edge.entrance = target;
+			edge.cost = cost;
+		}
+		
+		// edges crossing into neighbor clusters
+		const dedaiPathGraph::sFace &face = faces[ entrance.face ];
+		const int lastLink = face.firstLink + face.linkCount;
+		
+		for( j=face.firstLink; j<lastLink; j++ ){
+			const int neighbor = links[ j ].face;
+			if( pFaceClusters[ neighbor ] == entrance.cluster || pFaceEntrances[ neighbor ] == -1 ){
+				continue;
+			}
+			
+			const float cost = dedaiPathGraphSearch::GetStepCost( costs, face, faces[ neighbor ] );
+			if( cost >= blockingCost ){
+				continue;
+			}
+			
+			sEdge &edge = pEdges[ pEdgeCount++ ];
+			edge.entrance = pFaceEntrances[ neighbor ];
+			edge.cost = cost;
+		}
+		
+		entrance.edgeCount = pEdgeCount - entrance.firstEdge;
+	}
+}
@@ -0,0 +1,225 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHGRAPHCLUSTERS_H_
+#define _DEDAIPATHGRAPHCLUSTERS_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/threading/deThreadSafeObject.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+class dedaiPathGraph;
+class dedaiPathQueryCosts;
+
+
+
+/**
+ * \brief Path graph cluster abstraction.
+ * 
+ * Hierarchical abstraction of a dedaiPathGraph used to speed up long path searches. Faces
+ * are grouped into clusters of connected faces inside the same cubic cell. Linked faces
+ * along the border to the same neighbor cluster form a border segment. One face pair of
+ * each segment is used as entrance. Entrances are connected by edges either crossing into
+ * a neighbor cluster or running through a cluster. Searches first find a path through the
+ * entrances and then refine the path locally inside each cluster. Paths found this way
+ * are usually a few percent longer than optimal paths.
+ * 
+ * Edge costs depend on the navigator costs hence one instance exists for each costs used
+ * with a graph. For each entrance the costs to reach all faces of the same cluster are
+ * stored. These are used for intra-cluster edges and to connect the goal face.
+ * 
+ * Like the graph clusters are never modified after creation and can be used by parallel
+ * tasks. Since they are built from the graph they are rebuilt whenever the graph is. If
+ * the clusters of the previous graph are known the rebuild is incremental. Clusters not
+ * touching any of the changed areas copy the entrance costs from the matching previous
+ * cluster. Only entrance costs of clusters inside changed areas are calculated again.
+ */
+class dedaiPathGraphClusters : public deThreadSafeObject{
+public:
+	/** \brief Cluster. */
+	struct sCluster{
+		/** \brief Index of first face in cluster face list. */
+		int firstFace;
+		
+		/** \brief Number of faces. */
+		int faceCount;
+		
+		/** \brief Index of first entrance. */
+		int firstEntrance;
+		
+		/** \brief Number of entrances. */
+		int entranceCount;
+		
+		/** \brief Index of first entry in entrance cost table. */
+		int firstEntranceCost;
+	};
+	
+	/** \brief Entrance. */
+	struct sEntrance{
+		/** \brief Index of face. */
+		int face;
+		
+		/** \brief Index of cluster. */
+		int cluster;
+		
+		/** \brief Index of first edge. */
+		int firstEdge;
+		
+		/** \brief Number of edges. */
+		int edgeCount;
+	};
+	
+	/** \brief Edge between entrances. */
+	struct sEdge{
+		/** \brief Index of target entrance. */
+		int entrance;
+		
+		/** \brief Cost to move from the source to the target entrance face. */
+		float cost;
+	};
+	
+	
+	
+private:
+	struct sClusterKey;
+	
+	const dedaiPathGraph &pGraph;
+	deThreadSafeObjectReference pCosts;
+	
+	decDVector pOrigin;
+	double pCellSize;
+	
+	int *pFaceClusters;
+	int *pFaceEntrances;
+	
+	sCluster *pClusters;
+	int pClusterCount;
+	int *pClusterFaces;
+	int *pClusterFaceIndices;
+	
+	sEntrance *pEntrances;
+	int pEntranceCount;
+	
+	sEdge *pEdges;
+	int pEdgeCount;
+	
+	float *pEntranceCosts;
+	
+	int pReusedClusterCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create clusters for graph using costs.
+	 * \param[in] clusterSize Approximate number of faces per cluster.
+	 */
+	dedaiPathGraphClusters( const dedaiPathGraph &graph, dedaiPathQueryCosts *costs, int clusterSize );
+	
+	/**
+	 * \brief Create clusters for graph incrementally from clusters of a previous graph.
+	 * 
+	 * Uses the same cells as \em previous. Clusters not touching any dirty box and matching
+	 * a previous cluster face by face reuse the entrance costs of the previous cluster.
+	 * 
+	 * \param[in] costs Costs. Has to be equal to the costs used by \em previous.
+	 * \param[in] dirtyBoxes Minimum and maximum extends of changed areas in world space
+	 *                       stored in pairs. Contains 2 * \em dirtyBoxCount entries.
+	 */
+	dedaiPathGraphClusters( const dedaiPathGraph &graph, dedaiPathQueryCosts *costs,
+		const dedaiPathGraphClusters &previous, const decDVector *dirtyBoxes, int dirtyBoxCount );
+	
+protected:
+	/** \brief Clean up clusters. */
+	virtual ~dedaiPathGraphClusters();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Graph. */
+	inline const dedaiPathGraph &GetGraph() const{ return pGraph; }
+	
+	/** \brief Costs used to calculate edge costs. */
+	dedaiPathQueryCosts *GetCosts() const;
+	
+	/** \brief Number of clusters. */
+	inline int GetClusterCount() const{ return pClusterCount; }
+	
+	/** \brief Clusters. */
+	inline const sCluster *GetClusters() const{ return pClusters; }
+	
+	/** \brief Cluster faces. Index using sCluster::firstFace. */
+	inline const int *GetClusterFaces() const{ return pClusterFaces; }
+	
+	/** \brief Cluster index for each graph face. */
+	inline const int *GetFaceClusters() const{ return pFaceClusters; }
+	
+	/** \brief Index of each graph face relative to sCluster::firstFace. */
+	inline const int *GetClusterFaceIndices() const{ return pClusterFaceIndices; }
+	
+	/** \brief Entrance index for each graph face or -1 if not an entrance. */
+	inline const int *GetFaceEntrances() const{ return pFaceEntrances; }
+	
+	/** \brief Number of entrances. */
+	inline int GetEntranceCount() const{ return pEntranceCount; }
+	
+	/** \brief Entrances. */
+	inline const sEntrance *GetEntrances() const{ return pEntrances; }
+	
+	/** \brief Number of edges. */
+	inline int GetEdgeCount() const{ return pEdgeCount; }
+	
+	/** \brief Edges. */
+	inline const sEdge *GetEdges() const{ return pEdges; }
+	
+	/**
+	 * \brief Cost to move from entrance face to face in the same cluster.
+	 * \returns Cost or -1 if the face can not be reached inside the cluster.
+	 */
+	float GetEntranceCostTo( int entrance, int face ) const;
+	
+	/** \brief Number of clusters reusing entrance costs of previous clusters. */
+	inline int GetReusedClusterCount() const{ return pReusedClusterCount; }
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+	void pInitCells( int clusterSize );
+	void pBuildClusters();
+	decDVector pCellOf( const decDVector &position ) const;
+	void pBuildEntrances();
+	int pMarkEntrances();
+	void pBuildEntranceCosts( const dedaiPathGraphClusters *previous,
+		const decDVector *dirtyBoxes, int dirtyBoxCount );
+	static sClusterKey *pCreateClusterKeys( const dedaiPathGraphClusters &clusters );
+	int pMatchPreviousCluster( int cluster, const dedaiPathGraphClusters &previous,
+		const sClusterKey *previousKeys, const decDVector *dirtyBoxes, int dirtyBoxCount ) const;
+	void pBuildEdges();
+};
+
+#endif
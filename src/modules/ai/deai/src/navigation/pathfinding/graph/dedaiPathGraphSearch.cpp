@@ -0,0 +1,768 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dedaiPathGraph.h"
+#include "dedaiPathGraphClusters.h"
+#include "dedaiPathGraphSearch.h"
+#include "../query/dedaiPathQueryCosts.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/resources/navigation/navigator/deNavigatorPath.h>
+
+
+
+// Class dedaiPathGraphSearch
+///////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathGraphSearch::dedaiPathGraphSearch() :
+pGraph( NULL ),
+
+pNodes( NULL ),
+pNodeSize( 0 ),
+pStamp( 0 ),
+
+pHeap( NULL ),
+pHeapCount( 0 ),
+pHeapSize( 0 ),
+
+pCorridor( NULL ),
+pCorridorLinks( NULL ),
+pCorridorCount( 0 ),
+pCorridorSize( 0 ),
+
+pPortals( NULL ),
+pPortalSize( 0 ),
+
+pAbstractNodes( NULL ),
+pAbstractNodeSize( 0 ),
+pAbstractStamp( 0 ),
+
+pAbstractPath( NULL ),
+pAbstractPathSize( 0 ),
+
+pClusterCosts( NULL ),
+pClusterCostSize( 0 ),
+
+pVisitedFaceCount( 0 ){
+}
+
+dedaiPathGraphSearch::~dedaiPathGraphSearch(){
+	if( pClusterCosts ){
+		delete [] pClusterCosts;
+	}
+	if( pAbstractPath ){
+		delete [] pAbstractPath;
+	}
+	if( pAbstractNodes ){
+		delete [] pAbstractNodes;
+	}
+	if( pPortals ){
+		delete [] pPortals;
+	}
+	if( pCorridorLinks ){
+		delete [] pCorridorLinks;
+	}
+	if( pCorridor ){
+		delete [] pCorridor;
+	}
+	if( pHeap ){
+		delete [] pHeap;
+	}
+	if( pNodes ){
+		delete [] pNodes;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void dedaiPathGraphSearch::SetGraph( const dedaiPathGraph *graph ){
+	pGraph = graph;
+	pCorridorCount = 0;
+}
+
+bool dedaiPathGraphSearch::FindCorridor( const dedaiPathQueryCosts &costs, int startFace, int goalFace ){
+	if( ! pGraph ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int faceCount = pGraph->GetFaceCount();
+	if( startFace < 0 || startFace >= faceCount || goalFace < 0 || goalFace >= faceCount ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pCorridorCount = 0;
+	pVisitedFaceCount = 0;
+	
+	if( startFace == goalFace ){
+		return true;
+	}
+	
+	if( ! pSearch( costs, NULL, -1, startFace, goalFace ) ){
+		return false;
+	}
+	
+	pAppendSearchCorridor( goalFace );
+	return true;
+}
+
+bool dedaiPathGraphSearch::FindCorridor( const dedaiPathQueryCosts &costs,
+const dedaiPathGraphClusters *clusters, int startFace, int goalFace ){
+	if( ! clusters ){
+		return FindCorridor( costs, startFace, goalFace );
+	}
+	
+	if( ! pGraph || &clusters->GetGraph() != pGraph ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int faceCount = pGraph->GetFaceCount();
+	if( startFace < 0 || startFace >= faceCount || goalFace < 0 || goalFace >= faceCount ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int * const faceClusters = clusters->GetFaceClusters();
+	if( faceClusters[ startFace ] == faceClusters[ goalFace ] ){
+		// start and goal are close together. a plain search is fast enough
+		return FindCorridor( costs, startFace, goalFace );
+	}
+	
+	pCorridorCount = 0;
+	pVisitedFaceCount = 0;
+	
+	if( ! pSearchAbstract( costs, *clusters, startFace, goalFace ) ){
+		return false;
+	}
+	
+	// abstract path is stored in reverse order in the abstract nodes. count the entrances
+	// and store them in path order for the refinement
+	const int goalNode = clusters->GetEntranceCount();
+	int pathCount = 0;
+	int node;
+	
+	for( node=pAbstractNodes[ goalNode ].parent; node!=-1; node=pAbstractNodes[ node ].parent ){
+		pathCount++;
+	}
+	
+	if( pathCount > pAbstractPathSize ){
+		if( pAbstractPath ){
+			delete [] pAbstractPath;
+			pAbstractPath = NULL;
+		}
+		pAbstractPath = new int[ pathCount ];
+		pAbstractPathSize = pathCount;
+	}
+	
+	int index = pathCount;
+	for( node=pAbstractNodes[ goalNode ].parent; node!=-1; node=pAbstractNodes[ node ].parent ){
+		pAbstractPath[ --index ] = node;
+	}
+	
+	return pRefineAbstract( costs, *clusters, startFace, goalFace, pathCount );
+}
+
+void dedaiPathGraphSearch::FindClusterCosts( const dedaiPathQueryCosts &costs,
+const dedaiPathGraphClusters &clusters, int startFace, float *faceCosts ){
+	if( ! pGraph || &clusters.GetGraph() != pGraph || ! faceCosts ){
+		DETHROW( deeInvalidParam );
+	}
+	if( startFace < 0 || startFace >= pGraph->GetFaceCount() ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int clusterIndex = clusters.GetFaceClusters()[ startFace ];
+	const dedaiPathGraphClusters::sCluster &cluster = clusters.GetClusters()[ clusterIndex ];
+	const int * const clusterFaces = clusters.GetClusterFaces() + cluster.firstFace;
+	const float blockingCost = costs.GetBlockingCost();
+	int i;
+	
+	pSearch( costs, &clusters, clusterIndex, startFace, -1 );
+	
+	for( i=0; i<cluster.faceCount; i++ ){
+		const sNode &node = pNodes[ clusterFaces[ i ] ];
+		if( node.stamp == pStamp && node.costG < blockingCost ){
+			faceCosts[ i ] = node.costG;
+			
+		}else{
+			faceCosts[ i ] = -1.0f;
+		}
+	}
+}
+
+void dedaiPathGraphSearch::FindPoints( const decDVector &start, const decDVector &goal, deNavigatorPath &path ){
+	path.RemoveAll();
+	
+	if( pCorridorCount < 2 ){
+		path.Add( goal );
+		return;
+	}
+	
+	pBuildPortals( start, goal );
+	
+	// simple stupid funnel algorithm working on the oriented portals. the orientation test
+	// uses the normal of the face the portal leaves from. this works across slopes and
+	// faces on walls as long as neighbor faces do not bend too much
+	const int portalCount = pCorridorCount + 1;
+	const double epsilon = 1e-6;
+	decDVector apex( start );
+	decDVector funnelLeft( start );
+	decDVector funnelRight( start );
+	int apexIndex = 0;
+	int leftIndex = 0;
+	int rightIndex = 0;
+	int i;
+	
+	for( i=1; i<portalCount; i++ ){
+		const sPortal &portal = pPortals[ i ];
+		
+		// tighten right side
+		if( pOrient( apex, funnelRight, portal.right, portal.normal ) >= 0.0 ){
+			if( apex.IsEqualTo( funnelRight, epsilon )
+			|| pOrient( apex, funnelLeft, portal.right, portal.normal ) < 0.0 ){
+				funnelRight = portal.right;
+				rightIndex = i;
+				
+			}else{
+				// right side crosses left side. left corner becomes new apex
+				if( ! funnelLeft.IsEqualTo( apex, epsilon ) ){
+					apex = funnelLeft;
+					pAddPoint( path, apex );
+				}
+				apexIndex = leftIndex;
+				
+				funnelLeft = apex;
+				funnelRight = apex;
+				leftIndex = apexIndex;
+				rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+		
+		// tighten left side
+		if( pOrient( apex, funnelLeft, portal.left, portal.normal ) <= 0.0 ){
+			if( apex.IsEqualTo( funnelLeft, epsilon )
+			|| pOrient( apex, funnelRight, portal.left, portal.normal ) > 0.0 ){
+				funnelLeft = portal.left;
+				leftIndex = i;
+				
+			}else{
+				// left side crosses right side. right corner becomes new apex
+				if( ! funnelRight.IsEqualTo( apex, epsilon ) ){
+					apex = funnelRight;
+					pAddPoint( path, apex );
+				}
+				apexIndex = rightIndex;
+				
+				funnelLeft = apex;
+				funnelRight = apex;
+				leftIndex = apexIndex;
+				rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+	}
+	
+	pAddPoint( path, goal );
+	if( path.GetCount() == 0 ){
+		path.Add( goal );
+	}
+}
+
+float dedaiPathGraphSearch::GetStepCost( const dedaiPathQueryCosts &costs,
+const dedaiPathGraph::sFace &from, const dedaiPathGraph::sFace &to ){
+	float fixCost, costPerMeter;
+	costs.GetCostParametersFor( to.costType, fixCost, costPerMeter );
+	
+	float cost = costPerMeter * ( float )( to.center - from.center ).Length();
+	if( to.costType != from.costType ){
+		cost += fixCost;
+	}
+	return cost;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+bool dedaiPathGraphSearch::pSearch( const dedaiPathQueryCosts &costs,
+const dedaiPathGraphClusters *clusters, int cluster, int startFace, int goalFace ){
+	pPrepareNodes();
+	pHeapCount = 0;
+	
+	// without goal face all faces are visited like dijkstra does. with clusters the
+	// search does not leave the cluster
+	const dedaiPathGraph::sFace * const faces = pGraph->GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph->GetLinks();
+	const int * const faceClusters = clusters ? clusters->GetFaceClusters() : NULL;
+	const bool hasGoal = goalFace != -1;
+	const decDVector &goalCenter = faces[ hasGoal ? goalFace : startFace ].center;
+	const float blockingCost = costs.GetBlockingCost();
+	int i;
+	
+	sNode &startNode = pNodes[ startFace ];
+	startNode.stamp = pStamp;
+	startNode.parent = -1;
+	startNode.link = -1;
+	startNode.costG = 0.0f;
+	startNode.costF = hasGoal ? ( float )( goalCenter - faces[ startFace ].center ).Length() : 0.0f;
+	startNode.closed = false;
+	pHeapPush( startFace, startNode.costF );
+	
+	while( pHeapCount > 0 ){
+		const int testFace = pHeapPop();
+		sNode &testNode = pNodes[ testFace ];
+		
+		// heap entries are not removed if a face cost improves. skip stale entries
+		if( testNode.closed ){
+			continue;
+		}
+		testNode.closed = true;
+		pVisitedFaceCount++;
+		
+		if( testFace == goalFace ){
+			return true;
+		}
+		
+		const dedaiPathGraph::sFace &face = faces[ testFace ];
+		const int lastLink = face.firstLink + face.linkCount;
+		
+		for( i=face.firstLink; i<lastLink; i++ ){
+			const int nextFace = links[ i ].face;
+			if( faceClusters && faceClusters[ nextFace ] != cluster ){
+				continue;
+			}
+			
+			sNode &nextNode = pNodes[ nextFace ];
+			const bool visited = nextNode.stamp == pStamp;
+			
+			if( visited && nextNode.closed ){
+				continue;
+			}
+			
+			const dedaiPathGraph::sFace &next = faces[ nextFace ];
+			const float costG = testNode.costG + GetStepCost( costs, face, next );
+			
+			if( ! visited ){
+				nextNode.stamp = pStamp;
+				nextNode.parent = testFace;
+				nextNode.link = i;
+				nextNode.costG = costG;
+				nextNode.costF = costG;
+				if( hasGoal ){
+					nextNode.costF += ( float )( goalCenter - next.center ).Length();
+				}
+				
+				// faces reaching the blocking cost can not be crossed. close them right away
+				// so they are not tested again
+				nextNode.closed = nextNode.costF >= blockingCost;
+				if( ! nextNode.closed ){
+					pHeapPush( nextFace, nextNode.costF );
+				}
+				
+			}else if( costG < nextNode.costG ){
+				nextNode.costF += costG - nextNode.costG;
+				nextNode.costG = costG;
+				nextNode.parent = testFace;
+				nextNode.link = i;
+				pHeapPush( nextFace, nextNode.costF );
+			}
+		}
+	}
+	
+	return ! hasGoal;
+}
+
+bool dedaiPathGraphSearch::pSearchAbstract( const dedaiPathQueryCosts &costs,
+const dedaiPathGraphClusters &clusters, int startFace, int goalFace ){
+	const dedaiPathGraph::sFace * const faces = pGraph->GetFaces();
+	const dedaiPathGraphClusters::sEntrance * const entrances = clusters.GetEntrances();
+	const dedaiPathGraphClusters::sEdge * const edges = clusters.GetEdges();
+	const int * const faceClusters = clusters.GetFaceClusters();
+	const int entranceCount = clusters.GetEntranceCount();
+	const int goalCluster = faceClusters[ goalFace ];
+	const int goalNode = entranceCount;
+	const decDVector &goalCenter = faces[ goalFace ].center;
+	const float blockingCost = costs.GetBlockingCost();
+	int i;
+	
+	// connect the start face to the entrances of its cluster
+	const dedaiPathGraphClusters::sCluster &startCluster =
+		clusters.GetClusters()[ faceClusters[ startFace ] ];
+		
+	if( startCluster.faceCount > pClusterCostSize ){
+		if( pClusterCosts ){
+			delete [] pClusterCosts;
+			pClusterCosts = NULL;
+		}
+		pClusterCosts = new float[ startCluster.faceCount ];
+		pClusterCostSize = startCluster.faceCount;
+	}
+	
+	FindClusterCosts( costs, clusters, startFace, pClusterCosts );
+	
+	pPrepareAbstractNodes( entranceCount + 1 );
+	pHeapCount = 0;
+	
+	const int * const clusterFaceIndices = clusters.GetClusterFaceIndices();
+	for( i=0; i<startCluster.entranceCount; i++ ){
+		const int entrance = startCluster.firstEntrance + i;
+		const float costG = pClusterCosts[ clusterFaceIndices[ entrances[ entrance ].face ] ];
+		if( costG < 0.0f ){
+			continue;
+		}
+		
+		sNode &node = pAbstractNodes[ entrance ];
+		node.stamp = pAbstractStamp;
+		node.parent = -1;
+		node.link = -1;
+		node.costG = costG;
+		node.costF = costG + ( float )( goalCenter - faces[ entrances[ entrance ].face ].center ).Length();
+		node.closed = node.costF >= blockingCost;
+		if( ! node.closed ){
+			pHeapPush( entrance, node.costF );
+		}
+	}
+	
+	// search entrances. the goal node is connected to the entrances of the goal cluster
+	// using the precalculated entrance costs
+	while( pHeapCount > 0 ){
+		const int testEntrance = pHeapPop();
+		sNode &testNode = pAbstractNodes[ testEntrance ];
+		
+		if( testNode.closed ){
+			continue;
+		}
+		testNode.closed = true;
+		pVisitedFaceCount++;
+		
+		if( testEntrance == goalNode ){
+			return true;
+		}
+		
+		const dedaiPathGraphClusters::sEntrance &entrance = entrances[ testEntrance ];
+		const int lastEdge = entrance.firstEdge + entrance.edgeCount;
+		
+		if( entrance.cluster == goalCluster ){
+			const float goalCost = clusters.GetEntranceCostTo( testEntrance, goalFace );
+			if( goalCost >= 0.0f ){
+				const float costG = testNode.costG + goalCost;
+				sNode &node = pAbstractNodes[ goalNode ];
+				
+				if( node.stamp != pAbstractStamp || costG < node.costG ){
+					node.stamp = pAbstractStamp;
+					node.parent = testEntrance;
+					node.link = -1;
+					node.costG = costG;
+					node.costF = costG;
+					node.closed = node.costF >= blockingCost;
+					if( ! node.closed ){
+						pHeapPush( goalNode, node.costF );
+					}
+				}
+			}
+		}
+		
+		for( i=entrance.firstEdge; i<lastEdge; i++ ){
+			const dedaiPathGraphClusters::sEdge &edge = edges[ i ];
+			sNode &nextNode = pAbstractNodes[ edge.entrance ];
+			const bool visited = nextNode.stamp == pAbstractStamp;
+			
+			if( visited && nextNode.closed ){
+				continue;
+			}
+			
+			const float costG = testNode.costG + edge.cost;
+			
+			if( ! visited ){
+				nextNode.stamp = pAbstractStamp;
+				nextNode.parent = testEntrance;
+				nextNode.link = -1;
+				nextNode.costG = costG;
+				nextNode.costF = costG + ( float )( goalCenter
+					- faces[ entrances[ edge.entrance ].face ].center ).Length();
+				nextNode.closed = nextNode.costF >= blockingCost;
+				if( ! nextNode.closed ){
+					pHeapPush( edge.entrance, nextNode.costF );
+				}
+				
+			}else if( costG < nextNode.costG ){
+				nextNode.costF += costG - nextNode.costG;
+				nextNode.costG = costG;
+				nextNode.parent = testEntrance;
+				pHeapPush( edge.entrance, nextNode.costF );
+			}
+		}
+	}
+	
+	return false;
+}
+
+bool dedaiPathGraphSearch::pRefineAbstract( const dedaiPathQueryCosts &costs,
+const dedaiPathGraphClusters &clusters, int startFace, int goalFace, int pathCount ){
+	const dedaiPathGraph::sFace * const faces = pGraph->GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph->GetLinks();
+	const dedaiPathGraphClusters::sEntrance * const entrances = clusters.GetEntrances();
+	const int * const faceClusters = clusters.GetFaceClusters();
+	int i, j, currentFace = startFace;
+	
+	pAppendCorridor( startFace, -1 );
+	
+	for( i=0; i<=pathCount; i++ ){
+		const int targetFace = i < pathCount ? entrances[ pAbstractPath[ i ] ].face : goalFace;
+		if( targetFace == currentFace ){
+			continue;
+		}
+		
+		const int cluster = faceClusters[ currentFace ];
+		
+		if( faceClusters[ targetFace ] == cluster ){
+			// edge through cluster. search restricted to the cluster
+			if( ! pSearch( costs, &clusters, cluster, currentFace, targetFace ) ){
+				pCorridorCount = 0;
+				return false; // can not happen unless clusters do not match costs
+			}
+			pAppendSearchCorridor( targetFace );
+			
+		}else{
+			// edge crossing into neighbor cluster. faces are linked directly
+			const dedaiPathGraph::sFace &face = faces[ currentFace ];
+			const int lastLink = face.firstLink + face.linkCount;
+			
+			for( j=face.firstLink; j<lastLink; j++ ){
+				if( links[ j ].face == targetFace ){
+					break;
+				}
+			}
+			if( j == lastLink ){
+				DETHROW( deeInvalidParam );
+			}
+			
+			pAppendCorridor( targetFace, j );
+		}
+		
+		currentFace = targetFace;
+	}
+	
+	return true;
+}
+
+void dedaiPathGraphSearch::pPrepareNodes(){
+	const int faceCount = pGraph->GetFaceCount();
+	
+	if( faceCount > pNodeSize ){
+		if( pNodes ){
+			delete [] pNodes;
+			pNodes = NULL;
+		}
+		pNodes = new sNode[ faceCount ];
+		pNodeSize = faceCount;
+		memset( pNodes, 0, sizeof( sNode ) * faceCount );
+		pStamp = 0;
+	}
+	
+	// stamps tell apart nodes visited by this search from nodes visited by previous
+	// searches. this avoids clearing all nodes for each search
+	pStamp++;
+	if( pStamp == 0 ){
+		memset( pNodes, 0, sizeof( sNode ) * pNodeSize );
+		pStamp = 1;
+	}
+}
+
+void dedaiPathGraphSearch::pPrepareAbstractNodes( int count ){
+	if( count > pAbstractNodeSize ){
+		if( pAbstractNodes ){
+			delete [] pAbstractNodes;
+			pAbstractNodes = NULL;
+		}
+		pAbstractNodes = new sNode[ count ];
+		pAbstractNodeSize = count;
+		memset( pAbstractNodes, 0, sizeof( sNode ) * count );
+		pAbstractStamp = 0;
+	}
+	
+	pAbstractStamp++;
+	if( pAbstractStamp == 0 ){
+		memset( pAbstractNodes, 0, sizeof( sNode ) * pAbstractNodeSize );
+		pAbstractStamp = 1;
+	}
+}
+
+void dedaiPathGraphSearch::pHeapPush( int face, float costF ){
+	if( pHeapCount == pHeapSize ){
+		const int newSize = pHeapSize * 3 / 2 + 64;
+		sHeapEntry * const newArray = new sHeapEntry[ newSize ];
+		if( pHeap ){
+			memcpy( newArray, pHeap, sizeof( sHeapEntry ) * pHeapCount );
+			delete [] pHeap;
+		}
+		pHeap = newArray;
+		pHeapSize = newSize;
+	}
+	
+	int index = pHeapCount++;
+	while( index > 0 ){
+		const int parent = ( index - 1 ) / 2;
+		if( pHeap[ parent ].costF <= costF ){
+			break;
+		}
+		pHeap[ index ] = pHeap[ parent ];
+		index = parent;
+	}
+	
+	pHeap[ index ].costF = costF;
+	pHeap[ index ].face = face;
+}
+
+int dedaiPathGraphSearch::pHeapPop(){
+	const int face = pHeap[ 0 ].face;
+	const sHeapEntry last = pHeap[ --pHeapCount ];
+	int index = 0;
+	
+	while( true ){
+		int child = index * 2 + 1;
+		if( child >= pHeapCount ){
+			break;
+		}
+		if( child + 1 < pHeapCount && pHeap[ child + 1 ].costF < pHeap[ child ].costF ){
+			child++;
+		}
+		if( last.costF <= pHeap[ child ].costF ){
+			break;
+		}
+		pHeap[ index ] = pHeap[ child ];
+		index = child;
+	}
+	
+	if( pHeapCount > 0 ){
+		pHeap[ index ] = last;
+	}
+	return face;
+}
+
+void dedaiPathGraphSearch::pEnsureCorridorSize( int size ){
+	if( size <= pCorridorSize ){
+		return;
+	}
+	
+	const int newSize = size * 3 / 2 + 16;
+	int * const newCorridor = new int[ newSize ];
+	int * const newCorridorLinks = new int[ newSize ];
+	
+	if( pCorridor ){
+		memcpy( newCorridor, pCorridor, sizeof( int ) * pCorridorCount );
+		memcpy( newCorridorLinks, pCorridorLinks, sizeof( int ) * pCorridorCount );
+		delete [] pCorridorLinks;
+		delete [] pCorridor;
+	}
+	
+	pCorridor = newCorridor;
+	pCorridorLinks = newCorridorLinks;
+	pCorridorSize = newSize;
+}
+
+void dedaiPathGraphSearch::pAppendCorridor( int face, int link ){
+	pEnsureCorridorSize( pCorridorCount + 1 );
+	pCorridor[ pCorridorCount ] = face;
+	pCorridorLinks[ pCorridorCount ] = link;
+	pCorridorCount++;
+}
+
+void dedaiPathGraphSearch::pAppendSearchCorridor( int goalFace ){
+	int count = 0;
+	int face;
+	
+	for( face=goalFace; face!=-1; face=pNodes[ face ].parent ){
+		count++;
+	}
+	
+	// the start face of the search is the last face of a non-empty corridor
+	if( pCorridorCount > 0 ){
+		count--;
+	}
+	
+	pEnsureCorridorSize( pCorridorCount + count );
+	
+	int index = pCorridorCount + count;
+	for( face=goalFace; index>pCorridorCount; face=pNodes[ face ].parent ){
+		index--;
+		pCorridor[ index ] = face;
+		pCorridorLinks[ index ] = pNodes[ face ].link;
+	}
+	
+	pCorridorCount += count;
+}
+
+void dedaiPathGraphSearch::pBuildPortals( const decDVector &start, const decDVector &goal ){
+	const int portalCount = pCorridorCount + 1;
+	
+	if( portalCount > pPortalSize ){
+		if( pPortals ){
+			delete [] pPortals;
+			pPortals = NULL;
+		}
+		pPortals = new sPortal[ portalCount ];
+		pPortalSize = portalCount;
+	}
+	
+	const dedaiPathGraph::sFace * const faces = pGraph->GetFaces();
+	const dedaiPathGraph::sLink * const links = pGraph->GetLinks();
+	const decDVector * const vertices = pGraph->GetVertices();
+	int i;
+	
+	pPortals[ 0 ].left = start;
+	pPortals[ 0 ].right = start;
+	pPortals[ 0 ].normal = faces[ pCorridor[ 0 ] ].normal;
+	
+	for( i=1; i<pCorridorCount; i++ ){
+		const dedaiPathGraph::sLink &link = links[ pCorridorLinks[ i ] ];
+		pPortals[ i ].left = vertices[ link.vertexLeft ];
+		pPortals[ i ].right = vertices[ link.vertexRight ];
+		pPortals[ i ].normal = faces[ pCorridor[ i - 1 ] ].normal;
+	}
+	
+	pPortals[ pCorridorCount ].left = goal;
+	pPortals[ pCorridorCount ].right = goal;
+	pPortals[ pCorridorCount ].normal = faces[ pCorridor[ pCorridorCount - 1 ] ].normal;
+}
+
+double dedaiPathGraphSearch::pOrient( const decDVector &apex, const decDVector &a,
+const decDVector &b, const decDVector &normal ){
+	return normal * ( ( a - apex ) % ( b - apex ) );
+}
+
+void dedaiPathGraphSearch::pAddPoint( deNavigatorPath &path, const decDVector &point ){
+	const int count = path.GetCount();
+	if( count == 0 || ! path.GetAt( count - 1 ).IsEqualTo( point, 1e-6 ) ){
+		path.Add( point );
+	}
+}
@@ -0,0 +1,199 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHGRAPHSEARCH_H_
+#define _DEDAIPATHGRAPHSEARCH_H_
+
+#include "dedaiPathGraph.h"
+
+#include <dragengine/common/math/decMath.h>
+
+class dedaiPathGraphClusters;
+class dedaiPathQueryCosts;
+class deNavigatorPath;
+
+
+
+/**
+ * \brief Path graph search.
+ * 
+ * Runs A* searches on a dedaiPathGraph and converts the found face corridor into path
+ * points using a funnel algorithm. All search state is stored in this object instead of
+ * the graph hence multiple searches can run in parallel on the same graph as long as
+ * each thread uses an own search object. Scratch memory is kept between searches.
+ * 
+ * The cost model matches dedaiPathFinderNavMesh. Fix costs are applied only if the type
+ * changes between faces. Cost per meter is applied on the distance between face centers.
+ * Faces with costs reaching the blocking cost are not passed.
+ * 
+ * If clusters are used long searches run first on the cluster entrances. The found
+ * entrance path is then refined into a face corridor by searches restricted to the
+ * clusters along the path. The result is close to but not always the optimal path.
+ */
+class dedaiPathGraphSearch{
+private:
+	struct sNode{
+		float costG;
+		float costF;
+		int parent;
+		int link;
+		unsigned int stamp;
+		bool closed;
+	};
+	
+	struct sHeapEntry{
+		float costF;
+		int face;
+	};
+	
+	struct sPortal{
+		decDVector left;
+		decDVector right;
+		decDVector normal;
+	};
+	
+	const dedaiPathGraph *pGraph;
+	
+	sNode *pNodes;
+	int pNodeSize;
+	unsigned int pStamp;
+	
+	sHeapEntry *pHeap;
+	int pHeapCount;
+	int pHeapSize;
+	
+	int *pCorridor;
+	int *pCorridorLinks;
+	int pCorridorCount;
+	int pCorridorSize;
+	
+	sPortal *pPortals;
+	int pPortalSize;
+	
+	sNode *pAbstractNodes;
+	int pAbstractNodeSize;
+	unsigned int pAbstractStamp;
+	
+	int *pAbstractPath;
+	int pAbstractPathSize;
+	
+	float *pClusterCosts;
+	int pClusterCostSize;
+	
+	int pVisitedFaceCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create search. */
+	dedaiPathGraphSearch();
+	
+	/** \brief Clean up search. */
+	~dedaiPathGraphSearch();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Graph or \em NULL if not set. */
+	inline const dedaiPathGraph *GetGraph() const{ return pGraph; }
+	
+	/** \brief Set graph or \em NULL if not set. */
+	void SetGraph( const dedaiPathGraph *graph );
+	
+	/**
+	 * \brief Find face corridor from start face to goal face.
+	 * 
+	 * \returns true if a corridor has been found. If start and goal face are the same
+	 *          the corridor is empty and true is returned.
+	 */
+	bool FindCorridor( const dedaiPathQueryCosts &costs, int startFace, int goalFace );
+	
+	/**
+	 * \brief Find face corridor from start face to goal face using clusters.
+	 * 
+	 * If \em clusters is \em NULL or start and goal face are located in the same cluster
+	 * the search is the same as FindCorridor(costs,startFace,goalFace). \em clusters has
+	 * to be created for the same graph and costs.
+	 * 
+	 * \returns true if a corridor has been found.
+	 */
+	bool FindCorridor( const dedaiPathQueryCosts &costs, const dedaiPathGraphClusters *clusters,
+		int startFace, int goalFace );
+	
+	/**
+	 * \brief Find costs from face to all faces in the same cluster.
+	 * 
+	 * The search is restricted to the cluster. \em faceCosts has to hold one value for
+	 * each face of the cluster. Costs of faces not reachable are set to -1.
+	 */
+	void FindClusterCosts( const dedaiPathQueryCosts &costs, const dedaiPathGraphClusters &clusters,
+		int startFace, float *faceCosts );
+	
+	/** \brief Number of faces in corridor. */
+	inline int GetCorridorCount() const{ return pCorridorCount; }
+	
+	/** \brief Faces in corridor. */
+	inline const int *GetCorridor() const{ return pCorridor; }
+	
+	/** \brief Number of faces visited by the last FindCorridor() call. */
+	inline int GetVisitedFaceCount() const{ return pVisitedFaceCount; }
+	
+	/**
+	 * \brief Find path points along the last found corridor.
+	 * 
+	 * Replaces \em path with the path points. Like dedaiPathFinderNavMesh the start point
+	 * is not included and the goal point is always the last point. If the corridor is
+	 * empty the path contains only the goal point.
+	 */
+	void FindPoints( const decDVector &start, const decDVector &goal, deNavigatorPath &path );
+	
+	/** \brief Cost to move from face to neighbor face. */
+	static float GetStepCost( const dedaiPathQueryCosts &costs,
+		const dedaiPathGraph::sFace &from, const dedaiPathGraph::sFace &to );
+	/*@}*/
+	
+	
+	
+private:
+	bool pSearch( const dedaiPathQueryCosts &costs, const dedaiPathGraphClusters *clusters,
+		int cluster, int startFace, int goalFace );
+	bool pSearchAbstract( const dedaiPathQueryCosts &costs, const dedaiPathGraphClusters &clusters,
+		int startFace, int goalFace );
+	bool pRefineAbstract( const dedaiPathQueryCosts &costs, const dedaiPathGraphClusters &clusters,
+		int startFace, int goalFace, int pathCount );
+	void pPrepareNodes();
+	void pPrepareAbstractNodes( int count );
+	void pHeapPush( int face, float costF );
+	int pHeapPop();
+	void pEnsureCorridorSize( int size );
+	void pAppendCorridor( int face, int link );
+	void pAppendSearchCorridor( int goalFace );
+	void pBuildPortals( const decDVector &start, const decDVector &goal );
+	static double pOrient( const decDVector &apex, const decDVector &a,
+		const decDVector &b, const decDVector &normal );
+	static void pAddPoint( deNavigatorPath &path, const decDVector &point );
+};
+
+#endif
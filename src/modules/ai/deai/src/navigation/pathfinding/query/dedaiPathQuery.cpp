@@ -0,0 +1,97 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "dedaiPathQuery.h"
+#include "dedaiPathQueryCosts.h"
+#include "../graph/dedaiPathGraph.h"
+#include "../graph/dedaiPathGraphClusters.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class dedaiPathQuery
+/////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathQuery::dedaiPathQuery( const decDVector &start, const decDVector &goal ) :
+pStart( start ),
+pGoal( goal ),
+pLayer( NULL ),
+pStartFace( -1 ),
+pGoalFace( -1 ),
+pState( esPending ){
+}
+
+dedaiPathQuery::~dedaiPathQuery(){
+}
+
+
+
+// Management
+///////////////
+
+void dedaiPathQuery::SetLayer( dedaiLayer *layer ){
+	pLayer = layer;
+}
+
+dedaiPathGraph *dedaiPathQuery::GetGraph() const{
+	return ( dedaiPathGraph* )( deThreadSafeObject* )pGraph;
+}
+
+void dedaiPathQuery::SetGraph( dedaiPathGraph *graph ){
+	pGraph = graph;
+}
+
+dedaiPathQueryCosts *dedaiPathQuery::GetCosts() const{
+	return ( dedaiPathQueryCosts* )( deThreadSafeObject* )pCosts;
+}
+
+void dedaiPathQuery::SetCosts( dedaiPathQueryCosts *costs ){
+	pCosts = costs;
+}
+
+dedaiPathGraphClusters *dedaiPathQuery::GetClusters() const{
+	return ( dedaiPathGraphClusters* )( deThreadSafeObject* )pClusters;
+}
+
+void dedaiPathQuery::SetClusters( dedaiPathGraphClusters *clusters ){
+	pClusters = clusters;
+}
+
+void dedaiPathQuery::SetFaces( int startFace, int goalFace ){
+	pStartFace = startFace;
+	pGoalFace = goalFace;
+}
+
+void dedaiPathQuery::SetState( eStates state ){
+	pState = state;
+}
+
+void dedaiPathQuery::Cancel(){
+	if( pState != esFinished ){
+		pState = esCancelled;
+	}
+}
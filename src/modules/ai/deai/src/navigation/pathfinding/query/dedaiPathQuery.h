@@ -0,0 +1,171 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHQUERY_H_
+#define _DEDAIPATHQUERY_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/resources/navigation/navigator/deNavigatorPath.h>
+#include <dragengine/threading/deThreadSafeObject.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+class dedaiLayer;
+class dedaiPathGraph;
+class dedaiPathGraphClusters;
+class dedaiPathQueryCosts;
+
+
+
+/**
+ * \brief Asynchronous path query.
+ * 
+ * Submitted to dedaiPathQueryManager by dedaiNavigator::FindPathAsync(). Queries are
+ * collected during the frame and processed in batches by parallel tasks. The result is
+ * stored in the query once finished. The state has to be checked by the owner of the
+ * query. The path is only valid if the state is esFinished.
+ */
+class dedaiPathQuery : public deThreadSafeObject{
+public:
+	/** \brief Query state. */
+	enum eStates{
+		/** \brief Query is waiting to be dispatched. */
+		esPending,
+		
+		/** \brief Query is processed by a parallel task. */
+		esProcessing,
+		
+		/** \brief Query finished. Path is valid. */
+		esFinished,
+		
+		/** \brief Query has been cancelled. */
+		esCancelled
+	};
+	
+	
+	
+private:
+	decDVector pStart;
+	decDVector pGoal;
+	
+	dedaiLayer *pLayer;
+	deThreadSafeObjectReference pGraph;
+	deThreadSafeObjectReference pCosts;
+	deThreadSafeObjectReference pClusters;
+	
+	int pStartFace;
+	int pGoalFace;
+	
+	deNavigatorPath pPath;
+	eStates pState;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create path query. */
+	dedaiPathQuery( const decDVector &start, const decDVector &goal );
+	
+protected:
+	/** \brief Clean up path query. */
+	virtual ~dedaiPathQuery();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Start position. */
+	inline const decDVector &GetStart() const{ return pStart; }
+	
+	/** \brief Goal position. */
+	inline const decDVector &GetGoal() const{ return pGoal; }
+	
+	
+	
+	/** \brief Layer or \em NULL if not set. */
+	inline dedaiLayer *GetLayer() const{ return pLayer; }
+	
+	/** \brief Set layer or \em NULL if not set. */
+	void SetLayer( dedaiLayer *layer );
+	
+	/** \brief Path graph or \em NULL if not set. */
+	dedaiPathGraph *GetGraph() const;
+	
+	/**
+	 * \brief Set path graph or \em NULL if not set.
+	 * \details If not set the path graph of the layer is used.
+	 */
+	void SetGraph( dedaiPathGraph *graph );
+	
+	/** \brief Costs or \em NULL if not set. */
+	dedaiPathQueryCosts *GetCosts() const;
+	
+	/** \brief Set costs or \em NULL if not set. */
+	void SetCosts( dedaiPathQueryCosts *costs );
+	
+	/** \brief Path graph clusters or \em NULL to not use a hierarchical search. */
+	dedaiPathGraphClusters *GetClusters() const;
+	
+	/**
+	 * \brief Set path graph clusters or \em NULL to not use a hierarchical search.
+	 * \details Set by dedaiPathQueryManager for long searches on large graphs.
+	 */
+	void SetClusters( dedaiPathGraphClusters *clusters );
+	
+	
+	
+	/** \brief Start face in path graph or -1 if not resolved. */
+	inline int GetStartFace() const{ return pStartFace; }
+	
+	/** \brief Goal face in path graph or -1 if not resolved. */
+	inline int GetGoalFace() const{ return pGoalFace; }
+	
+	/** \brief Set start and goal face in path graph. */
+	void SetFaces( int startFace, int goalFace );
+	
+	
+	
+	/** \brief Path. Valid only if state is esFinished. */
+	inline deNavigatorPath &GetPath(){ return pPath; }
+	inline const deNavigatorPath &GetPath() const{ return pPath; }
+	
+	/** \brief State. */
+	inline eStates GetState() const{ return pState; }
+	
+	/** \brief Set state. */
+	void SetState( eStates state );
+	
+	/** \brief Query is finished or cancelled. */
+	inline bool IsDone() const{ return pState == esFinished || pState == esCancelled; }
+	
+	/**
+	 * \brief Cancel query.
+	 * 
+	 * Pending queries are dropped during the next dispatch. Queries being processed finish
+	 * processing but the result is discarded.
+	 */
+	void Cancel();
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,424 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dedaiPathQuery.h"
+#include "dedaiPathQueryBenchmark.h"
+#include "dedaiPathQueryCosts.h"
+#include "dedaiPathQueryManager.h"
+#include "../graph/dedaiPathGraph.h"
+#include "../graph/dedaiPathGraphClusters.h"
+#include "../graph/dedaiPathGraphSearch.h"
+#include "../../../deDEAIModule.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/resources/navigation/navigator/deNavigatorPath.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+
+
+// Definitions
+////////////////
+
+#define GOAL_COUNT		16
+#define HOLE_PERCENTAGE	15
+
+
+
+// Class dedaiPathQueryBenchmark
+//////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathQueryBenchmark::dedaiPathQueryBenchmark( deDEAIModule &deai ) :
+pDEAI( deai ),
+pRandomSeed( 0x5eed1234 ){
+}
+
+dedaiPathQueryBenchmark::~dedaiPathQueryBenchmark(){
+}
+
+
+
+// Management
+///////////////
+
+void dedaiPathQueryBenchmark::Run( int queryCount, int gridSize, decString &result ){
+	if( queryCount < 1 || gridSize < 2 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	decDVector *starts = NULL;
+	decDVector *goals = NULL;
+	int *pointCounts = NULL;
+	int *pointCountsHierarchical = NULL;
+	decTimer timer;
+	int i;
+	
+	pRandomSeed = 0x5eed1234;
+	
+	// build graph
+	timer.Reset();
+	deThreadSafeObjectReference graphRef;
+	graphRef.TakeOver( pCreateGraph( gridSize, 0 ) );
+	dedaiPathGraph &graph = *( ( dedaiPathGraph* )( deThreadSafeObject* )graphRef );
+	const float timeBuild = timer.GetElapsedTime();
+	
+	deThreadSafeObjectReference costsRef;
+	costsRef.TakeOver( new dedaiPathQueryCosts( 0.0f, 1.0f, 1e6f, 0.5f ) );
+	dedaiPathQueryCosts &costs = *( ( dedaiPathQueryCosts* )( deThreadSafeObject* )costsRef );
+	
+	try{
+		starts = new decDVector[ queryCount ];
+		goals = new decDVector[ queryCount ];
+		pointCounts = new int[ queryCount ];
+		pointCountsHierarchical = new int[ queryCount ];
+		
+		decDVector goalPositions[ GOAL_COUNT ];
+		for( i=0; i<GOAL_COUNT; i++ ){
+			goalPositions[ i ] = pRandomPosition( gridSize );
+		}
+		for( i=0; i<queryCount; i++ ){
+			starts[ i ] = pRandomPosition( gridSize );
+			goals[ i ] = goalPositions[ pRandom( GOAL_COUNT ) ];
+		}
+		
+		// sequential. resolves faces the same way as the manager for a fair comparison
+		const double maxDistance = ( double )costs.GetMaxOutsideDistance();
+		dedaiPathGraphSearch search;
+		deNavigatorPath path;
+		int pointCountSequential = 0;
+		int visitedSequential = 0;
+		double lengthSequential = 0.0;
+		double distance;
+		
+		search.SetGraph( &graph );
+		
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const int startFace = graph.GetFaceClosestTo( starts[ i ], maxDistance, distance );
+			const int goalFace = graph.GetFaceClosestTo( goals[ i ], maxDistance, distance );
+			
+			if( startFace != -1 && goalFace != -1 && startFace != goalFace ){
+				search.FindCorridor( costs, startFace, goalFace );
+				search.FindPoints( starts[ i ], goals[ i ], path );
+				visitedSequential += search.GetVisitedFaceCount();
+				
+			}else{
+				path.RemoveAll();
+				path.Add( goals[ i ] );
+			}
+			
+			pointCounts[ i ] = path.GetCount();
+			pointCountSequential += path.GetCount();
+			lengthSequential += pPathLength( starts[ i ], path );
+		}
+		const float timeSequential = timer.GetElapsedTime();
+		
+		// sequential using clusters
+		timer.Reset();
+		const dedaiPathGraphClusters * const clusters = graph.GetClusters( &costs );
+		const float timeClusters = timer.GetElapsedTime();
+		
+		int pointCountHierarchical = 0;
+		int visitedHierarchical = 0;
+		double lengthHierarchical = 0.0;
+		
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const int startFace = graph.GetFaceClosestTo( starts[ i ], maxDistance, distance );
+			const int goalFace = graph.GetFaceClosestTo( goals[ i ], maxDistance, distance );
+			
+			if( startFace != -1 && goalFace != -1 && startFace != goalFace ){
+				search.FindCorridor( costs, clusters, startFace, goalFace );
+				search.FindPoints( starts[ i ], goals[ i ], path );
+				visitedHierarchical += search.GetVisitedFaceCount();
+				
+			}else{
+				path.RemoveAll();
+				path.Add( goals[ i ] );
+			}
+			
+			pointCountsHierarchical[ i ] = path.GetCount();
+			pointCountHierarchical += path.GetCount();
+			lengthHierarchical += pPathLength( starts[ i ], path );
+		}
+		const float timeHierarchical = timer.GetElapsedTime();
+		
+		// batched using the manager and parallel tasks
+		dedaiPathQueryManager manager( pDEAI );
+		decThreadSafeObjectOrderedSet queries;
+		deThreadSafeObjectReference query;
+		
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			query.TakeOver( new dedaiPathQuery( starts[ i ], goals[ i ] ) );
+			dedaiPathQuery &pathQuery = *( ( dedaiPathQuery* )( deThreadSafeObject* )query );
+			pathQuery.SetGraph( &graph );
+			pathQuery.SetCosts( &costs );
+			queries.Add( query );
+			manager.AddQuery( &pathQuery );
+		}
+		manager.Update();
+		const float timeDispatch = timer.GetElapsedTime();
+		manager.WaitForTasks();
+		const float timeBatched = timeDispatch + timer.GetElapsedTime();
+		
+		// the manager uses clusters depending on the graph size. compare against the
+		// matching sequential run
+		const int * const expectedPointCounts = graph.GetFaceCount() >= manager.GetClusterFaceCount()
+			? pointCountsHierarchical : pointCounts;
+		int pointCountBatched = 0;
+		int mismatchCount = 0;
+		for( i=0; i<queryCount; i++ ){
+			const dedaiPathQuery &pathQuery = *( ( dedaiPathQuery* )queries.GetAt( i ) );
+			if( pathQuery.GetState() != dedaiPathQuery::esFinished
+			|| pathQuery.GetPath().GetCount() != expectedPointCounts[ i ] ){
+				mismatchCount++;
+			}
+			pointCountBatched += pathQuery.GetPath().GetCount();
+		}
+		
+		result.Format( "Path query benchmark: queries=%d grid=%dx%d faces=%d cores=%d\n"
+			"  Build graph: %.3fms\n"
+			"  Build clusters: %.3fms (clusters=%d, entrances=%d, edges=%d)\n"
+			"  Sequential: %.3fms (%.2fus/query, points=%d, visited=%d, length=%.1f)\n"
+			"  Hierarchical: %.3fms (%.2fus/query, points=%d, visited=%d, length=%.1f)\n"
+			"  Batched: %.3fms (dispatch %.3fms, searches=%d, tasks=%d, points=%d, mismatches=%d)\n",
+			queryCount, gridSize, gridSize, graph.GetFaceCount(),
+			pDEAI.GetGameEngine()->GetParallelProcessing().GetCoreCount(),
+			timeBuild * 1e3f, timeClusters * 1e3f, clusters->GetClusterCount(),
+			clusters->GetEntranceCount(), clusters->GetEdgeCount(),
+			timeSequential * 1e3f, timeSequential * 1e6f / ( float )queryCount,
+			pointCountSequential, visitedSequential, lengthSequential,
+			timeHierarchical * 1e3f, timeHierarchical * 1e6f / ( float )queryCount,
+			pointCountHierarchical, visitedHierarchical, lengthHierarchical,
+			timeBatched * 1e3f, timeDispatch * 1e3f, manager.GetLastSearchCount(),
+			manager.GetLastTaskCount(), pointCountBatched, mismatchCount );
+		
+		pBenchmarkRebuild( gridSize, graph, *clusters, result );
+		
+		delete [] pointCountsHierarchical;
+		delete [] pointCounts;
+		delete [] goals;
+		delete [] starts;
+		
+	}catch( const deException & ){
+		if( pointCountsHierarchical ){
+			delete [] pointCountsHierarchical;
+		}
+		if( pointCounts ){
+			delete [] pointCounts;
+		}
+		if( goals ){
+			delete [] goals;
+		}
+		if( starts ){
+			delete [] starts;
+		}
+		throw;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void dedaiPathQueryBenchmark::pBenchmarkRebuild( int gridSize, const dedaiPathGraph &graph,
+const dedaiPathGraphClusters &clusters, decString &result ){
+	decTimer timer;
+	int i;
+	
+	// same graph with a square blocked in the middle like a blocker would do. the random
+	// seed is reset to get the same holes everywhere else
+	const int blockedSize = decMath::max( gridSize / 16, 1 );
+	const double blockedMin = ( double )( ( gridSize - blockedSize ) / 2 );
+	
+	pRandomSeed = 0x5eed1234;
+	deThreadSafeObjectReference changedGraphRef;
+	changedGraphRef.TakeOver( pCreateGraph( gridSize, blockedSize ) );
+	const dedaiPathGraph &changedGraph = *( ( dedaiPathGraph* )( deThreadSafeObject* )changedGraphRef );
+	
+	const decDVector dirtyBoxes[ 2 ] = {
+		decDVector( blockedMin, -1.0, blockedMin ),
+		decDVector( blockedMin + ( double )blockedSize, 1.0, blockedMin + ( double )blockedSize ) };
+	const decDVector fullBoxes[ 2 ] = {
+		decDVector( -1.0, -1.0, -1.0 ),
+		decDVector( ( double )gridSize + 1.0, 1.0, ( double )gridSize + 1.0 ) };
+	
+	// incremental rebuild reusing the clusters outside the blocked area against a rebuild
+	// of all clusters using the same cells. both have to produce the same edges
+	timer.Reset();
+	deThreadSafeObjectReference incrementalRef;
+	incrementalRef.TakeOver( new dedaiPathGraphClusters( changedGraph,
+		clusters.GetCosts(), clusters, dirtyBoxes, 1 ) );
+	const float timeIncremental = timer.GetElapsedTime();
+	
+	timer.Reset();
+	deThreadSafeObjectReference fullRef;
+	fullRef.TakeOver( new dedaiPathGraphClusters( changedGraph,
+		clusters.GetCosts(), clusters, fullBoxes, 1 ) );
+	const float timeFull = timer.GetElapsedTime();
+	
+	const dedaiPathGraphClusters &incremental = *( ( dedaiPathGraphClusters* )( deThreadSafeObject* )incrementalRef );
+	const dedaiPathGraphClusters &full = *( ( dedaiPathGraphClusters* )( deThreadSafeObject* )fullRef );
+	int mismatchCount = 0;
+	
+	if( incremental.GetClusterCount() != full.GetClusterCount()
+	|| incremental.GetEntranceCount() != full.GetEntranceCount()
+	|| incremental.GetEdgeCount() != full.GetEdgeCount() ){
+		mismatchCount = -1;
+		
+	}else{
+		const dedaiPathGraphClusters::sEdge * const edgesIncremental = incremental.GetEdges();
+		const dedaiPathGraphClusters::sEdge * const edgesFull = full.GetEdges();
+		const int edgeCount = full.GetEdgeCount();
+		
+		for( i=0; i<edgeCount; i++ ){
+			if( edgesIncremental[ i ].entrance != edgesFull[ i ].entrance
+			|| fabsf( edgesIncremental[ i ].cost - edgesFull[ i ].cost ) > 1e-4f ){
+				mismatchCount++;
+			}
+		}
+	}
+	
+	result.AppendFormat( "  Rebuild clusters: %.3fms incremental (blocked=%dx%d, reused=%d/%d)"
+		" vs %.3fms full (edge mismatches=%d)\n", timeIncremental * 1e3f, blockedSize, blockedSize,
+		incremental.GetReusedClusterCount(), incremental.GetClusterCount(), timeFull * 1e3f,
+		mismatchCount );
+}
+
+dedaiPathGraph *dedaiPathQueryBenchmark::pCreateGraph( int gridSize, int blockedSize ){
+	const int vertexStride = gridSize + 1;
+	const int cellCount = gridSize * gridSize;
+	const int blockedMin = ( gridSize - blockedSize ) / 2;
+	const int blockedMax = blockedMin + blockedSize;
+	dedaiPathGraph *graph = NULL;
+	int *faceMap = NULL;
+	int x, z;
+	
+	try{
+		graph = new dedaiPathGraph;
+		faceMap = new int[ cellCount ];
+		
+		// shared grid vertices used by the portals
+		for( z=0; z<=gridSize; z++ ){
+			for( x=0; x<=gridSize; x++ ){
+				graph->AddVertex( decDVector( ( double )x, 0.0, ( double )z ) );
+			}
+		}
+		
+		// faces with holes. polygon vertices are added per face
+		for( z=0; z<gridSize; z++ ){
+			for( x=0; x<gridSize; x++ ){
+				// blocked cells still use up the random number to keep the other holes
+				if( pRandom( 100 ) < HOLE_PERCENTAGE || ( x >= blockedMin && x < blockedMax
+				&& z >= blockedMin && z < blockedMax ) ){
+					faceMap[ z * gridSize + x ] = -1;
+					continue;
+				}
+				
+				const int firstVertex = graph->GetVertexCount();
+				graph->AddVertex( decDVector( ( double )x, 0.0, ( double )z ) );
+				graph->AddVertex( decDVector( ( double )x, 0.0, ( double )( z + 1 ) ) );
+				graph->AddVertex( decDVector( ( double )( x + 1 ), 0.0, ( double )( z + 1 ) ) );
+				graph->AddVertex( decDVector( ( double )( x + 1 ), 0.0, ( double )z ) );
+				faceMap[ z * gridSize + x ] = graph->AddFace( firstVertex, 4, 0 );
+			}
+		}
+		
+		// links to the neighbor faces in face order
+		for( z=0; z<gridSize; z++ ){
+			for( x=0; x<gridSize; x++ ){
+				const int face = faceMap[ z * gridSize + x ];
+				if( face == -1 ){
+					continue;
+				}
+				
+				if( x > 0 && faceMap[ z * gridSize + x - 1 ] != -1 ){
+					graph->AddLink( face, faceMap[ z * gridSize + x - 1 ],
+						z * vertexStride + x, ( z + 1 ) * vertexStride + x );
+				}
+				if( x < gridSize - 1 && faceMap[ z * gridSize + x + 1 ] != -1 ){
+					graph->AddLink( face, faceMap[ z * gridSize + x + 1 ],
+						z * vertexStride + x + 1, ( z + 1 ) * vertexStride + x + 1 );
+				}
+				if( z > 0 && faceMap[ ( z - 1 ) * gridSize + x ] != -1 ){
+					graph->AddLink( face, faceMap[ ( z - 1 ) * gridSize + x ],
+						z * vertexStride + x, z * vertexStride + x + 1 );
+				}
+				if( z < gridSize - 1 && faceMap[ ( z + 1 ) * gridSize + x ] != -1 ){
+					graph->AddLink( face, faceMap[ ( z + 1 ) * gridSize + x ],
+						( z + 1 ) * vertexStride + x, ( z + 1 ) * vertexStride + x + 1 );
+				}
+			}
+		}
+		
+		graph->BuildLookupGrid();
+		
+		delete [] faceMap;
+		
+	}catch( const deException & ){
+		if( faceMap ){
+			delete [] faceMap;
+		}
+		if( graph ){
+			graph->FreeReference();
+		}
+		throw;
+	}
+	
+	return graph;
+}
+
+decDVector dedaiPathQueryBenchmark::pRandomPosition( int gridSize ){
+	return decDVector( ( double )pRandom( gridSize * 100 ) * 0.01, 0.0,
+		( double )pRandom( gridSize * 100 ) * 0.01 );
+}
+
+int dedaiPathQueryBenchmark::pRandom( int range ){
+	// fixed seed linear congruential generator. results are reproducible across runs
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return ( int )( ( pRandomSeed >> 8 ) % ( unsigned int )range );
+}
+
+double dedaiPathQueryBenchmark::pPathLength( const decDVector &start, const deNavigatorPath &path ){
+	const int count = path.GetCount();
+	decDVector position( start );
+	double length = 0.0;
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		length += ( path.GetAt( i ) - position ).Length();
+		position = path.GetAt( i );
+	}
+	
+	return length;
+}
@@ -0,0 +1,92 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHQUERYBENCHMARK_H_
+#define _DEDAIPATHQUERYBENCHMARK_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/common/string/decString.h>
+
+class deDEAIModule;
+class deNavigatorPath;
+class dedaiPathGraph;
+class dedaiPathGraphClusters;
+
+
+
+/**
+ * \brief Path query benchmark.
+ * 
+ * Developer mode benchmark for the asynchronous path queries. Builds a synthetic grid
+ * navigation mesh with holes and fires a large number of queries at it. The queries are
+ * processed once sequentially on the calling thread and once using dedaiPathQueryManager
+ * with parallel tasks. Start points are spread across the mesh while goals are picked
+ * from a small set of locations similar to many agents moving towards few targets.
+ * 
+ * The sequential run is done once with plain and once with hierarchical searches to
+ * compare visited faces and path lengths.
+ * 
+ * Last the graph is built again with a small area blocked. The clusters are rebuilt once
+ * incrementally and once entirely to compare the times and verify both produce the same
+ * edges.
+ */
+class dedaiPathQueryBenchmark{
+private:
+	deDEAIModule &pDEAI;
+	unsigned int pRandomSeed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create benchmark. */
+	dedaiPathQueryBenchmark( deDEAIModule &deai );
+	
+	/** \brief Clean up benchmark. */
+	~dedaiPathQueryBenchmark();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Run benchmark.
+	 * \param[in] queryCount Number of queries to run.
+	 * \param[in] gridSize Number of grid cells along each side of the navigation mesh.
+	 * \param[out] result Benchmark results in human readable form.
+	 */
+	void Run( int queryCount, int gridSize, decString &result );
+	/*@}*/
+	
+	
+	
+private:
+	void pBenchmarkRebuild( int gridSize, const dedaiPathGraph &graph,
+		const dedaiPathGraphClusters &clusters, decString &result );
+	dedaiPathGraph *pCreateGraph( int gridSize, int blockedSize );
+	decDVector pRandomPosition( int gridSize );
+	int pRandom( int range );
+	static double pPathLength( const decDVector &start, const deNavigatorPath &path );
+};
+
+#endif
@@ -0,0 +1,110 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dedaiPathQueryCosts.h"
+#include "../../dedaiNavigator.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/resources/navigation/navigator/deNavigator.h>
+
+
+
+// Class dedaiPathQueryCosts
+//////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathQueryCosts::dedaiPathQueryCosts( const dedaiNavigator &navigator ) :
+pFixCosts( NULL ),
+pCostsPerMeter( NULL ),
+pTypeCount( 0 ),
+pDefaultFixCost( navigator.GetNavigator().GetDefaultFixCost() ),
+pDefaultCostPerMeter( navigator.GetNavigator().GetDefaultCostPerMeter() ),
+pBlockingCost( navigator.GetNavigator().GetBlockingCost() ),
+pMaxOutsideDistance( navigator.GetNavigator().GetMaxOutsideDistance() )
+{
+	const int typeCount = navigator.GetTypeMappingCount();
+	if( typeCount == 0 ){
+		return;
+	}
+	
+	try{
+		pFixCosts = new float[ typeCount ];
+		pCostsPerMeter = new float[ typeCount ];
+		
+	}catch( const deException & ){
+		if( pFixCosts ){
+			delete [] pFixCosts;
+		}
+		throw;
+	}
+	
+	for( pTypeCount=0; pTypeCount<typeCount; pTypeCount++ ){
+		navigator.GetCostParametersFor( pTypeCount, pFixCosts[ pTypeCount ], pCostsPerMeter[ pTypeCount ] );
+	}
+}
+
+dedaiPathQueryCosts::dedaiPathQueryCosts( float fixCost, float costPerMeter,
+float blockingCost, float maxOutsideDistance ) :
+pFixCosts( NULL ),
+pCostsPerMeter( NULL ),
+pTypeCount( 0 ),
+pDefaultFixCost( fixCost ),
+pDefaultCostPerMeter( costPerMeter ),
+pBlockingCost( blockingCost ),
+pMaxOutsideDistance( maxOutsideDistance ){
+}
+
+dedaiPathQueryCosts::~dedaiPathQueryCosts(){
+	if( pCostsPerMeter ){
+		delete [] pCostsPerMeter;
+	}
+	if( pFixCosts ){
+		delete [] pFixCosts;
+	}
+}
+
+
+
+// Management
+///////////////
+
+bool dedaiPathQueryCosts::Equals( const dedaiPathQueryCosts &costs ) const{
+	if( &costs == this ){
+		return true;
+	}
+	
+	if( costs.pTypeCount != pTypeCount
+	|| costs.pDefaultFixCost != pDefaultFixCost
+	|| costs.pDefaultCostPerMeter != pDefaultCostPerMeter
+	|| costs.pBlockingCost != pBlockingCost
+	|| costs.pMaxOutsideDistance != pMaxOutsideDistance ){
+		return false;
+	}
+	
+	return pTypeCount == 0 || (
+		memcmp( costs.pFixCosts, pFixCosts, sizeof( float ) * pTypeCount ) == 0
+		&& memcmp( costs.pCostsPerMeter, pCostsPerMeter, sizeof( float ) * pTypeCount ) == 0 );
+}
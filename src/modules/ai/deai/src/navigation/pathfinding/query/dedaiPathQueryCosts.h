@@ -0,0 +1,98 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHQUERYCOSTS_H_
+#define _DEDAIPATHQUERYCOSTS_H_
+
+#include <dragengine/threading/deThreadSafeObject.h>
+
+class dedaiNavigator;
+
+
+
+/**
+ * \brief Path query cost parameters.
+ * 
+ * Immutable copy of the navigator cost parameters indexed by layer cost table type. Used
+ * by path searches running in parallel tasks where the navigator can not be accessed.
+ * Navigators keep one instance until their costs change.
+ */
+class dedaiPathQueryCosts : public deThreadSafeObject{
+private:
+	float *pFixCosts;
+	float *pCostsPerMeter;
+	int pTypeCount;
+	float pDefaultFixCost;
+	float pDefaultCostPerMeter;
+	float pBlockingCost;
+	float pMaxOutsideDistance;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create costs from navigator.
+	 * \warning Navigator has to be prepared.
+	 */
+	dedaiPathQueryCosts( const dedaiNavigator &navigator );
+	
+	/** \brief Create costs with only default parameters. */
+	dedaiPathQueryCosts( float fixCost, float costPerMeter, float blockingCost, float maxOutsideDistance );
+	
+protected:
+	/** \brief Clean up costs. */
+	virtual ~dedaiPathQueryCosts();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of types. */
+	inline int GetTypeCount() const{ return pTypeCount; }
+	
+	/** \brief Cost parameters for cost table type. */
+	inline void GetCostParametersFor( int type, float &fixCost, float &costPerMeter ) const{
+		if( type >= 0 && type < pTypeCount ){
+			fixCost = pFixCosts[ type ];
+			costPerMeter = pCostsPerMeter[ type ];
+			
+		}else{
+			fixCost = pDefaultFixCost;
+			costPerMeter = pDefaultCostPerMeter;
+		}
+	}
+	
+	/** \brief Blocking cost. */
+	inline float GetBlockingCost() const{ return pBlockingCost; }
+	
+	/** \brief Maximum distance of start and goal point outside navigation spaces. */
+	inline float GetMaxOutsideDistance() const{ return pMaxOutsideDistance; }
+	
+	/** \brief Costs are equal. */
+	bool Equals( const dedaiPathQueryCosts &costs ) const;
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,409 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dedaiPathQuery.h"
+#include "dedaiPathQueryCosts.h"
+#include "dedaiPathQueryManager.h"
+#include "dedaiPathQueryTask.h"
+#include "../graph/dedaiPathGraph.h"
+#include "../graph/dedaiPathGraphClusters.h"
+#include "../../layer/dedaiLayer.h"
+#include "../../../deDEAIModule.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/resources/navigation/navigator/deNavigatorPathQuery.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+
+
+// Class dedaiPathQueryManager
+////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathQueryManager::dedaiPathQueryManager( deDEAIModule &deai ) :
+pDEAI( deai ),
+
+pScratchQueries( NULL ),
+pScratchNext( NULL ),
+pScratchSearches( NULL ),
+pScratchSize( 0 ),
+pScratchTable( NULL ),
+pScratchTableSize( 0 ),
+
+pClusterFaceCount( 4096 ),
+
+pLastQueryCount( 0 ),
+pLastSearchCount( 0 ),
+pLastTaskCount( 0 ){
+}
+
+dedaiPathQueryManager::~dedaiPathQueryManager(){
+	CancelAll();
+	
+	if( pScratchTable ){
+		delete [] pScratchTable;
+	}
+	if( pScratchSearches ){
+		delete [] pScratchSearches;
+	}
+	if( pScratchNext ){
+		delete [] pScratchNext;
+	}
+	if( pScratchQueries ){
+		delete [] pScratchQueries;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void dedaiPathQueryManager::SetClusterFaceCount( int faceCount ){
+	pClusterFaceCount = decMath::max( faceCount, 0 );
+}
+
+void dedaiPathQueryManager::AddQuery( dedaiPathQuery *query ){
+	if( ! query || ( ! query->GetLayer() && ! query->GetGraph() ) || ! query->GetCosts() ){
+		DETHROW( deeInvalidParam );
+	}
+	if( query->GetState() != dedaiPathQuery::esPending ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pPendingQueries.Add( query );
+}
+
+void dedaiPathQueryManager::AddQuery( dedaiPathQuery *query, deNavigatorPathQuery *engineQuery ){
+	if( ! engineQuery ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	AddQuery( query );
+	
+	pDeliverQueries.Add( query );
+	pDeliverEngineQueries.Add( engineQuery );
+}
+
+void dedaiPathQueryManager::Update(){
+	pDropFinishedTasks();
+	pDeliverResults();
+	pDispatch();
+}
+
+void dedaiPathQueryManager::WaitForTasks(){
+	deParallelProcessing &parallelProcessing = pDEAI.GetGameEngine()->GetParallelProcessing();
+	const int count = pRunningTasks.GetCount();
+	int i;
+	
+	if( ! parallelProcessing.GetPaused() ){
+		// parallel processing is paused if the engine is in progress of being stopped.
+		// in this case all tasks have been waited for already and no tasks are running
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( dedaiPathQueryTask* )pRunningTasks.GetAt( i ) );
+		}
+	}
+	
+	pRunningTasks.RemoveAll();
+}
+
+void dedaiPathQueryManager::CancelAll(){
+	const int pendingCount = pPendingQueries.GetCount();
+	int i;
+	
+	for( i=0; i<pendingCount; i++ ){
+		( ( dedaiPathQuery* )pPendingQueries.GetAt( i ) )->Cancel();
+	}
+	pPendingQueries.RemoveAll();
+	
+	const int deliverCount = pDeliverEngineQueries.GetCount();
+	for( i=0; i<deliverCount; i++ ){
+		( ( deNavigatorPathQuery* )pDeliverEngineQueries.GetAt( i ) )->Cancel();
+	}
+	pDeliverEngineQueries.RemoveAll();
+	pDeliverQueries.RemoveAll();
+	
+	const int taskCount = pRunningTasks.GetCount();
+	for( i=0; i<taskCount; i++ ){
+		( ( dedaiPathQueryTask* )pRunningTasks.GetAt( i ) )->Cancel();
+	}
+	WaitForTasks();
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void dedaiPathQueryManager::pDropFinishedTasks(){
+	int i;
+	
+	for( i=pRunningTasks.GetCount()-1; i>=0; i-- ){
+		if( ( ( dedaiPathQueryTask* )pRunningTasks.GetAt( i ) )->GetQueriesUpdated() ){
+			pRunningTasks.RemoveFrom( i );
+		}
+	}
+}
+
+void dedaiPathQueryManager::pDeliverResults(){
+	const int count = pDeliverQueries.GetCount();
+	if( count == 0 ){
+		return;
+	}
+	
+	decThreadSafeObjectOrderedSet keepQueries;
+	decObjectList keepEngineQueries;
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		dedaiPathQuery * const query = ( dedaiPathQuery* )pDeliverQueries.GetAt( i );
+		deNavigatorPathQuery * const engineQuery = ( deNavigatorPathQuery* )pDeliverEngineQueries.GetAt( i );
+		
+		// engine query has been cancelled or has been submitted again with different
+		// parameters after being cancelled. drop the query
+		if( engineQuery->GetState() != deNavigatorPathQuery::esPending
+		|| ! engineQuery->GetStart().IsEqualTo( query->GetStart() )
+		|| ! engineQuery->GetGoal().IsEqualTo( query->GetGoal() ) ){
+			query->Cancel();
+			continue;
+		}
+		
+		if( ! query->IsDone() ){
+			keepQueries.Add( query );
+			keepEngineQueries.Add( engineQuery );
+			continue;
+		}
+		
+		if( query->GetState() == dedaiPathQuery::esFinished ){
+			engineQuery->GetPath() = query->GetPath();
+			engineQuery->SetState( deNavigatorPathQuery::esFinished );
+			
+		}else{
+			engineQuery->SetState( deNavigatorPathQuery::esCancelled );
+		}
+	}
+	
+	if( keepQueries.GetCount() < count ){
+		pDeliverQueries = keepQueries;
+		pDeliverEngineQueries = keepEngineQueries;
+	}
+}
+
+void dedaiPathQueryManager::pDispatch(){
+	pLastQueryCount = 0;
+	pLastSearchCount = 0;
+	pLastTaskCount = 0;
+	
+	const int pendingCount = pPendingQueries.GetCount();
+	if( pendingCount == 0 ){
+		return;
+	}
+	
+	pEnsureScratch( pendingCount );
+	
+	// resolve faces and group queries into searches. queries with the same graph, start
+	// face, goal face and costs share a search. the searches are located using an open
+	// addressing hash table on the face indices storing search indices
+	const int tableMask = pScratchTableSize - 1;
+	dedaiPathGraph *layerGraph = NULL;
+	dedaiLayer *graphLayer = NULL;
+	int queryCount = 0;
+	int searchCount = 0;
+	double distance;
+	int i;
+	
+	for( i=0; i<pScratchTableSize; i++ ){
+		pScratchTable[ i ] = -1;
+	}
+	
+	for( i=0; i<pendingCount; i++ ){
+		dedaiPathQuery * const query = ( dedaiPathQuery* )pPendingQueries.GetAt( i );
+		if( query->GetState() != dedaiPathQuery::esPending ){
+			continue; // cancelled
+		}
+		
+		if( ! query->GetGraph() ){
+			if( query->GetLayer() != graphLayer ){
+				graphLayer = query->GetLayer();
+				layerGraph = graphLayer->GetPathGraph();
+			}
+			query->SetGraph( layerGraph );
+		}
+		dedaiPathGraph * const graph = query->GetGraph();
+		
+		const dedaiPathQueryCosts &costs = *query->GetCosts();
+		const double maxDistance = ( double )costs.GetMaxOutsideDistance();
+		int goalFace = -1;
+		const int startFace = graph->GetFaceClosestTo( query->GetStart(), maxDistance, distance );
+		if( startFace != -1 ){
+			goalFace = graph->GetFaceClosestTo( query->GetGoal(), maxDistance, distance );
+		}
+		query->SetFaces( startFace, goalFace );
+		
+		// no search required. the path contains only the goal point like the
+		// synchronous path finder does
+		if( startFace == -1 || goalFace == -1 || startFace == goalFace ){
+			deNavigatorPath &path = query->GetPath();
+			path.RemoveAll();
+			path.Add( query->GetGoal() );
+			query->SetState( dedaiPathQuery::esFinished );
+			continue;
+		}
+		
+		query->SetState( dedaiPathQuery::esProcessing );
+		pScratchQueries[ queryCount ] = query;
+		pScratchNext[ queryCount ] = -1;
+		
+		int slot = ( int )( ( ( unsigned int )startFace * 73856093u )
+			^ ( ( unsigned int )goalFace * 19349663u ) ) & tableMask;
+			
+		while( pScratchTable[ slot ] != -1 ){
+			const int searchHead = pScratchSearches[ pScratchTable[ slot ] ];
+			const dedaiPathQuery &headQuery = *pScratchQueries[ searchHead ];
+			
+			if( headQuery.GetStartFace() == startFace && headQuery.GetGoalFace() == goalFace
+			&& headQuery.GetGraph() == graph && headQuery.GetCosts()->Equals( costs ) ){
+				pScratchNext[ queryCount ] = pScratchNext[ searchHead ];
+				pScratchNext[ searchHead ] = queryCount;
+				break;
+			}
+			
+			slot = ( slot + 1 ) & tableMask;
+		}
+		
+		if( pScratchTable[ slot ] == -1 ){
+			if( graph->GetFaceCount() >= pClusterFaceCount ){
+				query->SetClusters( graph->GetClusters( query->GetCosts() ) );
+			}
+			
+			pScratchTable[ slot ] = searchCount;
+			pScratchSearches[ searchCount++ ] = queryCount;
+		}
+		
+		queryCount++;
+	}
+	
+	pPendingQueries.RemoveAll();
+	
+	pLastQueryCount = queryCount;
+	pLastSearchCount = searchCount;
+	
+	if( searchCount == 0 ){
+		return;
+	}
+	
+	// distribute searches across tasks. each task works on a single graph. searches are
+	// spread across twice the number of cores to balance uneven search costs
+	deParallelProcessing &parallelProcessing = pDEAI.GetGameEngine()->GetParallelProcessing();
+	const int taskTarget = decMath::max( parallelProcessing.GetCoreCount(), 1 ) * 2;
+	const int searchesPerTask = decMath::max( ( searchCount + taskTarget - 1 ) / taskTarget, 8 );
+	deThreadSafeObjectReference task;
+	int j, k;
+	
+	for( i=0; i<searchCount; i++ ){
+		if( pScratchSearches[ i ] == -1 ){
+			continue;
+		}
+		
+		dedaiPathGraph * const taskGraph = pScratchQueries[ pScratchSearches[ i ] ]->GetGraph();
+		dedaiPathQueryTask *queryTask = NULL;
+		
+		for( j=i; j<searchCount; j++ ){
+			const int searchHead = pScratchSearches[ j ];
+			if( searchHead == -1 || pScratchQueries[ searchHead ]->GetGraph() != taskGraph ){
+				continue;
+			}
+			
+			if( ! queryTask ){
+				task.TakeOver( new dedaiPathQueryTask( pDEAI, taskGraph ) );
+				queryTask = ( dedaiPathQueryTask* )( deThreadSafeObject* )task;
+			}
+			
+			queryTask->AddSearch( pScratchQueries[ searchHead ] );
+			for( k=pScratchNext[ searchHead ]; k!=-1; k=pScratchNext[ k ] ){
+				queryTask->AddSearchQuery( pScratchQueries[ k ] );
+			}
+			pScratchSearches[ j ] = -1;
+			
+			if( queryTask->GetSearchCount() == searchesPerTask ){
+				pRunningTasks.Add( queryTask );
+				parallelProcessing.AddTask( queryTask );
+				pLastTaskCount++;
+				queryTask = NULL;
+			}
+		}
+		
+		if( queryTask ){
+			pRunningTasks.Add( queryTask );
+			parallelProcessing.AddTask( queryTask );
+			pLastTaskCount++;
+		}
+	}
+}
+
+void dedaiPathQueryManager::pEnsureScratch( int count ){
+	if( count > pScratchSize ){
+		const int newSize = count * 3 / 2 + 16;
+		
+		if( pScratchSearches ){
+			delete [] pScratchSearches;
+			pScratchSearches = NULL;
+		}
+		if( pScratchNext ){
+			delete [] pScratchNext;
+			pScratchNext = NULL;
+		}
+		if( pScratchQueries ){
+			delete [] pScratchQueries;
+			pScratchQueries = NULL;
+		}
+		pScratchSize = 0;
+		
+		pScratchQueries = new dedaiPathQuery*[ newSize ];
+		pScratchNext = new int[ newSize ];
+		pScratchSearches = new int[ newSize ];
+		pScratchSize = newSize;
+	}
+	
+	// hash table at least twice the number of queries to keep probe sequences short
+	int tableSize = 64;
+	while( tableSize < count * 2 ){
+		tableSize <<= 1;
+	}
+	
+	if( tableSize > pScratchTableSize ){
+		if( pScratchTable ){
+			delete [] pScratchTable;
+			pScratchTable = NULL;
+		}
+		pScratchTableSize = 0;
+		
+		pScratchTable = new int[ tableSize ];
+		pScratchTableSize = tableSize;
+	}
+}
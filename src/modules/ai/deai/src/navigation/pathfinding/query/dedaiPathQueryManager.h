@@ -0,0 +1,149 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHQUERYMANAGER_H_
+#define _DEDAIPATHQUERYMANAGER_H_
+
+#include <dragengine/common/collection/decObjectList.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
+
+class deDEAIModule;
+class dedaiPathQuery;
+
+class deNavigatorPathQuery;
+
+
+
+/**
+ * \brief Path query manager.
+ * 
+ * Collects asynchronous path queries during a frame and dispatches them in batches to
+ * parallel tasks during Update(). Start and goal faces are resolved on the main thread
+ * using the path graph. Queries with identical graph, costs, start face and goal
+ * face share a single search. The corridor is found once and only the path points are
+ * calculated per query. Results are available after the tasks finished which is usually
+ * the next frame.
+ * 
+ * Searches on graphs with at least the cluster face count faces use the graph cluster
+ * abstraction. Clusters are built on the main thread the first time they are needed.
+ * 
+ * Queries can be bound to engine navigator path queries. Engine queries are only accessed
+ * on the main thread. Results of finished queries are copied to the engine queries during
+ * the next Update(). Engine queries cancelled or changed in the mean time are dropped.
+ */
+class dedaiPathQueryManager{
+private:
+	deDEAIModule &pDEAI;
+	
+	decThreadSafeObjectOrderedSet pPendingQueries;
+	decThreadSafeObjectOrderedSet pRunningTasks;
+	
+	decThreadSafeObjectOrderedSet pDeliverQueries;
+	decObjectList pDeliverEngineQueries;
+	
+	dedaiPathQuery **pScratchQueries;
+	int *pScratchNext;
+	int *pScratchSearches;
+	int pScratchSize;
+	int *pScratchTable;
+	int pScratchTableSize;
+	
+	int pClusterFaceCount;
+	
+	int pLastQueryCount;
+	int pLastSearchCount;
+	int pLastTaskCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create manager. */
+	dedaiPathQueryManager( deDEAIModule &deai );
+	
+	/** \brief Clean up manager. */
+	~dedaiPathQueryManager();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Module. */
+	inline deDEAIModule &GetDEAI() const{ return pDEAI; }
+	
+	/** \brief Number of pending queries. */
+	inline int GetPendingQueryCount() const{ return pPendingQueries.GetCount(); }
+	
+	/** \brief Number of running tasks. */
+	inline int GetRunningTaskCount() const{ return pRunningTasks.GetCount(); }
+	
+	/** \brief Number of engine queries waiting for their result. */
+	inline int GetDeliverQueryCount() const{ return pDeliverQueries.GetCount(); }
+	
+	/** \brief Minimum number of graph faces to use hierarchical searches. */
+	inline int GetClusterFaceCount() const{ return pClusterFaceCount; }
+	
+	/** \brief Set minimum number of graph faces to use hierarchical searches. */
+	void SetClusterFaceCount( int faceCount );
+	
+	/** \brief Number of queries dispatched during the last update. */
+	inline int GetLastQueryCount() const{ return pLastQueryCount; }
+	
+	/** \brief Number of unique searches dispatched during the last update. */
+	inline int GetLastSearchCount() const{ return pLastSearchCount; }
+	
+	/** \brief Number of tasks dispatched during the last update. */
+	inline int GetLastTaskCount() const{ return pLastTaskCount; }
+	
+	/**
+	 * \brief Add query.
+	 * \details Query requires layer or graph and costs to be set and has to be in pending state.
+	 */
+	void AddQuery( dedaiPathQuery *query );
+	
+	/**
+	 * \brief Add query bound to engine navigator path query.
+	 * \details Result is copied to \em engineQuery once \em query finished.
+	 */
+	void AddQuery( dedaiPathQuery *query, deNavigatorPathQuery *engineQuery );
+	
+	/** \brief Drop finished tasks, deliver results and dispatch pending queries. */
+	void Update();
+	
+	/** \brief Wait for all running tasks to finish. */
+	void WaitForTasks();
+	
+	/** \brief Cancel all pending queries, running tasks and engine queries. */
+	void CancelAll();
+	/*@}*/
+	
+	
+	
+private:
+	void pDropFinishedTasks();
+	void pDeliverResults();
+	void pDispatch();
+	void pEnsureScratch( int count );
+};
+
+#endif
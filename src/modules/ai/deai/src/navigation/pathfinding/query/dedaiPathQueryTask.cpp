@@ -0,0 +1,148 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "dedaiPathQuery.h"
+#include "dedaiPathQueryCosts.h"
+#include "dedaiPathQueryTask.h"
+#include "../graph/dedaiPathGraph.h"
+#include "../graph/dedaiPathGraphClusters.h"
+#include "../graph/dedaiPathGraphSearch.h"
+#include "../../../deDEAIModule.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class dedaiPathQueryTask
+/////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiPathQueryTask::dedaiPathQueryTask( deDEAIModule &deai, dedaiPathGraph *graph ) :
+deParallelTask( &deai ),
+pDEAI( deai ),
+pGraph( graph ),
+pQueriesUpdated( false )
+{
+	if( ! graph ){
+		DETHROW( deeInvalidParam );
+	}
+}
+
+dedaiPathQueryTask::~dedaiPathQueryTask(){
+}
+
+
+
+// Management
+///////////////
+
+dedaiPathGraph &dedaiPathQueryTask::GetGraph() const{
+	return *( ( dedaiPathGraph* )( deThreadSafeObject* )pGraph );
+}
+
+void dedaiPathQueryTask::AddSearch( dedaiPathQuery *query ){
+	pQueries.Add( query );
+	pSearchQueryCounts.Add( 1 );
+}
+
+void dedaiPathQueryTask::AddSearchQuery( dedaiPathQuery *query ){
+	const int index = pSearchQueryCounts.GetCount() - 1;
+	if( index == -1 ){
+		DETHROW( deeInvalidAction );
+	}
+	
+	pQueries.Add( query );
+	pSearchQueryCounts.SetAt( index, pSearchQueryCounts.GetAt( index ) + 1 );
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void dedaiPathQueryTask::Run(){
+	const int searchCount = pSearchQueryCounts.GetCount();
+	dedaiPathGraphSearch search;
+	int i, j, firstQuery = 0;
+	
+	search.SetGraph( &GetGraph() );
+	
+	for( i=0; i<searchCount; i++ ){
+		if( IsCancelled() ){
+			return;
+		}
+		
+		const dedaiPathQuery &searchQuery = *( ( dedaiPathQuery* )pQueries.GetAt( firstQuery ) );
+		const int queryCount = pSearchQueryCounts.GetAt( i );
+		
+		// if no corridor is found the corridor is empty and the path contains only the
+		// goal point. this matches the behavior of the synchronous path finder
+		search.FindCorridor( *searchQuery.GetCosts(), searchQuery.GetClusters(),
+			searchQuery.GetStartFace(), searchQuery.GetGoalFace() );
+		
+		for( j=0; j<queryCount; j++ ){
+			dedaiPathQuery &query = *( ( dedaiPathQuery* )pQueries.GetAt( firstQuery + j ) );
+			search.FindPoints( query.GetStart(), query.GetGoal(), query.GetPath() );
+		}
+		
+		firstQuery += queryCount;
+	}
+}
+
+void dedaiPathQueryTask::Finished(){
+	const int count = pQueries.GetCount();
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		dedaiPathQuery &query = *( ( dedaiPathQuery* )pQueries.GetAt( i ) );
+		if( query.GetState() != dedaiPathQuery::esProcessing ){
+			continue;
+		}
+		
+		if( IsCancelled() ){
+			query.SetState( dedaiPathQuery::esCancelled );
+			
+		}else{
+			query.SetState( dedaiPathQuery::esFinished );
+		}
+	}
+	
+	pQueriesUpdated = true;
+}
+
+
+
+// Debugging
+//////////////
+
+decString dedaiPathQueryTask::GetDebugName() const{
+	return "DEAI:PathQuery";
+}
+
+decString dedaiPathQueryTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "searches=%d queries=%d", pSearchQueryCounts.GetCount(), pQueries.GetCount() );
+	return details;
+}
@@ -0,0 +1,116 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAIPATHQUERYTASK_H_
+#define _DEDAIPATHQUERYTASK_H_
+
+#include <dragengine/common/collection/decIntList.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
+#include <dragengine/parallel/deParallelTask.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+class deDEAIModule;
+class dedaiPathGraph;
+class dedaiPathQuery;
+
+
+
+/**
+ * \brief Parallel task processing a batch of path queries.
+ * 
+ * Queries are grouped into searches. All queries of a search share the same start face,
+ * goal face and costs. The face corridor is found once per search and path points are
+ * calculated for each query along the shared corridor. If the first query of a search
+ * has clusters set a hierarchical search is used.
+ * 
+ * Run() writes only to the query paths. Finished() marks the queries finished on the
+ * main thread unless they have been cancelled in the mean time.
+ */
+class dedaiPathQueryTask : public deParallelTask{
+private:
+	deDEAIModule &pDEAI;
+	deThreadSafeObjectReference pGraph;
+	
+	decThreadSafeObjectOrderedSet pQueries;
+	decIntList pSearchQueryCounts;
+	bool pQueriesUpdated;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create task. */
+	dedaiPathQueryTask( deDEAIModule &deai, dedaiPathGraph *graph );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~dedaiPathQueryTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Graph. */
+	dedaiPathGraph &GetGraph() const;
+	
+	/** \brief Number of searches. */
+	inline int GetSearchCount() const{ return pSearchQueryCounts.GetCount(); }
+	
+	/** \brief Number of queries. */
+	inline int GetQueryCount() const{ return pQueries.GetCount(); }
+	
+	/** \brief Add query starting a new search. */
+	void AddSearch( dedaiPathQuery *query );
+	
+	/** \brief Add query sharing the last added search. */
+	void AddSearchQuery( dedaiPathQuery *query );
+	
+	/** \brief Finished() has been called and the query states are updated. */
+	inline bool GetQueriesUpdated() const{ return pQueriesUpdated; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
@@ -83,6 +83,7 @@ pDirtyLayout( true ),
 pDirtyLinks( true ),
 
 pDirtyBlocking( true ),
+pHasBlockingExtends( false ),
 
 pDebugDrawer( NULL ),
 pDDSSpace( NULL ),
@@ -387,7 +388,47 @@ void dedaiSpace::ClearLinks(){
 
 
 void dedaiSpace::InvalidateBlocking(){
-	pDirtyLayout = true; // right now updating blocking needs a full relayout
+	if( pMesh ){
+		pMesh->InvalidateBlocking();
+		
+	}else{
+		pDirtyLayout = true; // updating grid blocking needs a full relayout
+	}
+	
+	pDirtyBlocking = true;
+	pDirtyLinks = true;
+	ClearLinks();
+}
+
+void dedaiSpace::InvalidateBlocking( const decDVector &boxMin, const decDVector &boxMax ){
+	if( ! pMesh ){
+		InvalidateBlocking();
+		return;
+	}
+	
+	// mesh faces are in local space. transform the box corners into local space
+	const decDMatrix &matrix = GetInverseMatrix();
+	decVector minExtend, maxExtend;
+	int i;
+	
+	for( i=0; i<8; i++ ){
+		const decVector corner( matrix * decDVector(
+			( i & 1 ) ? boxMax.x : boxMin.x,
+			( i & 2 ) ? boxMax.y : boxMin.y,
+			( i & 4 ) ? boxMax.z : boxMin.z ) );
+		
+		if( i == 0 ){
+			minExtend = corner;
+			maxExtend = corner;
+			
+		}else{
+			minExtend.SetSmallest( corner );
+			maxExtend.SetLargest( corner );
+		}
+	}
+	
+	pMesh->InvalidateBlocking( minExtend, maxExtend );
+	
 	pDirtyBlocking = true;
 	pDirtyLinks = true;
 	ClearLinks();
@@ -914,16 +955,25 @@ void dedaiSpace::pUpdateBlockerConvexVolumeList(){
 
 void dedaiSpace::pInvalidateLayerBlocking(){
 	if( ! pLayer ){
+		pHasBlockingExtends = false;
 		return;
 	}
 	
+	// blocking has to be updated also where the blocker shape has been located the last time
+	if( pHasBlockingExtends ){
+		pLayer->InvalidateBlocking( pType, pBlockingMinExtends, pBlockingMaxExtends );
+		pHasBlockingExtends = false;
+	}
+	
 	if( pBlockerShape.GetCount() == 0 ){
-		pDirtyLayout = true; // a blocker could be located ontop of us
-		pDirtyBlocking = true; // a blocker could be located ontop of us
+		InvalidateBlocking(); // a blocker could be located ontop of us
 		pLayer->InvalidateLinks( pType, GetMinimumExtends(), GetMaximumExtends() );
 		
 	}else{
-		pLayer->InvalidateBlocking( pType, GetMinimumExtends(), GetMaximumExtends() );
+		pBlockingMinExtends = GetMinimumExtends();
+		pBlockingMaxExtends = GetMaximumExtends();
+		pHasBlockingExtends = true;
+		pLayer->InvalidateBlocking( pType, pBlockingMinExtends, pBlockingMaxExtends );
 	}
 }
 
@@ -74,6 +74,10 @@ private:
 	
 	bool pDirtyBlocking;
 	
+	decDVector pBlockingMinExtends;
+	decDVector pBlockingMaxExtends;
+	bool pHasBlockingExtends;
+	
 	decConvexVolumeList pBlockerConvexVolumeList;
 	
 	deDebugDrawer *pDebugDrawer;
@@ -228,6 +232,9 @@ public:
 	/** \brief Invalidate due to blocking change. */
 	void InvalidateBlocking();
 	
+	/** \brief Invalidate due to blocking change inside box in world space. */
+	void InvalidateBlocking( const decDVector &boxMin, const decDVector &boxMax );
+	
 	/** \brief Layout of owner content changed. */
     void OwnerLayoutChanged();
 	
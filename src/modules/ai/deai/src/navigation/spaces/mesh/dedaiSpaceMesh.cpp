@@ -23,6 +23,7 @@
 #include <string.h>
 
 #include "dedaiSpaceMesh.h"
+#include "dedaiSpaceMeshBlockingTask.h"
 #include "dedaiSpaceMeshEdge.h"
 #include "dedaiSpaceMeshCorner.h"
 #include "dedaiSpaceMeshFace.h"
@@ -41,10 +42,13 @@
 #include "../../../utils/dedaiConvexFace.h"
 #include "../../../utils/dedaiConvexFaceList.h"
 
+#include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
 #include <dragengine/common/math/decConvexVolume.h>
 #include <dragengine/common/math/decConvexVolumeList.h>
 #include <dragengine/common/math/decConvexVolumeFace.h>
+#include <dragengine/parallel/deParallelProcessing.h>
 #include <dragengine/resources/debug/deDebugDrawerShape.h>
 #include <dragengine/resources/debug/deDebugDrawerShapeFace.h>
 #include <dragengine/resources/navigation/blocker/deNavigationBlocker.h>
@@ -53,6 +57,7 @@
 #include <dragengine/resources/navigation/space/deNavigationSpaceCorner.h>
 #include <dragengine/resources/world/deWorld.h>
 #include <dragengine/resources/terrain/heightmap/deHeightTerrain.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
 
 
 
@@ -61,6 +66,12 @@
 
 #define THRESHOLD_EQUAL 0.0001
 
+// minimum number of dirty faces to split faces using parallel tasks
+#define PARALLEL_SPLIT_FACE_COUNT 64
+
+// minimum number of faces to split per parallel task
+#define PARALLEL_SPLIT_TASK_FACE_COUNT 16
+
 
 
 // Class dedaiSpaceMesh
@@ -96,6 +107,14 @@ pFaceSize( 0 ),
 pStaticFaceCount( 0 ),
 pBlockerBaseFace( 0 ),
 
+pBaseVertices( NULL ),
+pBaseEdges( NULL ),
+pBaseCorners( NULL ),
+pBaseFaces( NULL ),
+
+pBlockedFaces( NULL ),
+pDirtyBlockedFaces( NULL ),
+
 pLinks( NULL ),
 pLinkCount( 0 ),
 pLinkSize( 0 ){
@@ -542,11 +561,11 @@ void dedaiSpaceMesh::LinkToOtherMeshes(){
 }
 
 void dedaiSpaceMesh::UpdateBlocking(){
-	// remove all created blocking elements
-	pFaceCount = pBlockerBaseFace;
-	pCornerCount = pBlockerBaseCorner;
-	pEdgeCount = pBlockerBaseEdge;
-	pVertexCount = pBlockerBaseVertex;
+	// remove all created blocking elements. linking to other meshes can split edges of
+	// base faces and blocking disables base faces. restore the stored base elements to
+	// undo these modifications
+	RemoveAllLinks();
+	pRestoreBlockerBase();
 	
 	// process overlapping blockers
 	if( ! pSpace.GetParentWorld() ){
@@ -561,51 +580,92 @@ void dedaiSpaceMesh::UpdateBlocking(){
 	// TODO calculate extends of cut volumes to optimize
 	
 	// split faces using the list of splitter volumes
-	const int splitterCount = splitterList.GetVolumeCount();
-	if( splitterCount == 0 ){
+	if( splitterList.GetVolumeCount() == 0 ){
+		pClearBlockedFaces();
 		return;
 	}
 	
-	int i, j;
+	// split dirty faces. faces not dirty keep the split result of the last update
+	pSplitDirtyFaces( splitterList );
+	
+	// remove blocked faces adding the split faces instead
+	int i;
 	
 	for( i=0; i<pBlockerBaseFace; i++ ){
-		const dedaiSpaceMeshFace &face = pFaces[ i ];
-		
-		// NOTE we are not testing for face.GetEnabled() here since blocking is done on the
-		//      initial face set which all are enabled before blocking is applied
-		
-		// TODO skip faces with extends not overlapping cut extends
-		
+		if( pBlockedFaces[ i ] ){
+			pDisableFace( i );
+			pAddConvexFaces( *pBlockedFaces[ i ], pFaces[ i ] );
+			// after this call face reference is potentially invalid due to memory move
+		}
+	}
+}
+
+void dedaiSpaceMesh::InvalidateBlocking(){
+	int i;
+	for( i=0; i<pBlockerBaseFace; i++ ){
+		pDirtyBlockedFaces[ i ] = true;
+	}
+}
+
+void dedaiSpaceMesh::InvalidateBlocking( const decVector &minExtend, const decVector &maxExtend ){
+	int i;
+	
+	for( i=0; i<pBlockerBaseFace; i++ ){
+		const dedaiSpaceMeshFace &face = pBaseFaces[ i ];
+		if( face.GetMaximumExtend() >= minExtend && face.GetMinimumExtend() <= maxExtend ){
+			pDirtyBlockedFaces[ i ] = true;
+		}
+	}
+}
+
+dedaiConvexFaceList *dedaiSpaceMesh::SplitBaseFace( int face,
+const decConvexVolumeList &splitters, bool optimize ) const{
+	if( face < 0 || face >= pBlockerBaseFace ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	// NOTE we are not testing for face.GetEnabled() here since blocking is done on the
+	//      initial face set which all are enabled before blocking is applied
+	const dedaiSpaceMeshFace &meshFace = pBaseFaces[ face ];
+	const int splitterCount = splitters.GetVolumeCount();
+	dedaiConvexFaceList *list = NULL;
+	int i;
+	
+	try{
 		// init convex face list with face to split
-		dedaiConvexFaceList convexFaceList;
-		pInitConvexFaceListFromFace( convexFaceList, face );
+		list = new dedaiConvexFaceList;
+		pInitConvexFaceListFromFace( *list, meshFace );
 		
 		// split by all splitter volumes
-		for( j=0; j<splitterCount; j++ ){
-			convexFaceList.SplitByVolume( *splitterList.GetVolumeAt( j ) );
+		for( i=0; i<splitterCount; i++ ){
+			list->SplitByVolume( *splitters.GetVolumeAt( i ) );
 		}
 		
 		// if there is more than one face or the first face is not equal to the original face
-		// then the splitting has affected the face. in this case add all faces as blocker faces
-		if( pMatchesConvexFaceListMeshFace( convexFaceList, face ) ){
-			continue;
+		// then the splitting has affected the face. otherwise the face is not blocked
+		if( pMatchesConvexFaceListMeshFace( *list, meshFace ) ){
+			delete list;
+			return NULL;
 		}
 		
 		// collapse redundant vertices to reduce the number of split faces
-		if( pSpace.GetDEAI().GetDeveloperMode().GetQuickDebug() == 0
-		|| pSpace.GetDEAI().GetDeveloperMode().GetQuickDebug() == 9 ){
-			pOptimizeBlockedFaces( convexFaceList, face.GetCornerCount() );
+		if( optimize ){
+			pOptimizeBlockedFaces( *list, meshFace.GetCornerCount() );
 		}
 		
-		// remove old face adding the new ones
-		pDisableFace( i );
-		pAddConvexFaces( convexFaceList, face );
-		// after this call face reference is potentially invalid due to memory move
+	}catch( const deException & ){
+		if( list ){
+			delete list;
+		}
+		throw;
 	}
+	
+	return list;
 }
 
 void dedaiSpaceMesh::Clear(){
 	RemoveAllLinks();
+	pFreeBlockerBase();
 	pFaceCount = 0;
 	pCornerCount = 0;
 	pEdgeCount = 0;
@@ -968,11 +1028,8 @@ void dedaiSpaceMesh::pInitFromNavSpace(){
 		firstCorner += cornerCount;
 	}
 	
-	// store base indices for blockers
-	pBlockerBaseVertex = pVertexCount;
-	pBlockerBaseEdge = pEdgeCount;
-	pBlockerBaseCorner = pCornerCount;
-	pBlockerBaseFace = pFaceCount;
+	// store base indices and elements for blockers
+	pStoreBlockerBase();
 }
 
 void dedaiSpaceMesh::pInitFromHTNavSpace(){
@@ -1151,14 +1208,219 @@ void dedaiSpaceMesh::pInitFromHTNavSpace(){
 		firstCorner += faceCornerCount;
 	}
 	
-	// store base indices for blockers
+	// store base indices and elements for blockers
+	pStoreBlockerBase();
+}
+
+
+
+void dedaiSpaceMesh::pStoreBlockerBase(){
+	pFreeBlockerBase();
+	
 	pBlockerBaseVertex = pVertexCount;
 	pBlockerBaseEdge = pEdgeCount;
 	pBlockerBaseCorner = pCornerCount;
 	pBlockerBaseFace = pFaceCount;
+	
+	if( pVertexCount > 0 ){
+		pBaseVertices = new decVector[ pVertexCount ];
+		memcpy( pBaseVertices, pVertices, sizeof( decVector ) * pVertexCount );
+	}
+	if( pEdgeCount > 0 ){
+		pBaseEdges = new dedaiSpaceMeshEdge[ pEdgeCount ];
+		memcpy( pBaseEdges, pEdges, sizeof( dedaiSpaceMeshEdge ) * pEdgeCount );
+	}
+	if( pCornerCount > 0 ){
+		pBaseCorners = new dedaiSpaceMeshCorner[ pCornerCount ];
+		memcpy( pBaseCorners, pCorners, sizeof( dedaiSpaceMeshCorner ) * pCornerCount );
+	}
+	
+	if( pFaceCount > 0 ){
+		int i;
+		
+		pBaseFaces = new dedaiSpaceMeshFace[ pFaceCount ];
+		memcpy( pBaseFaces, pFaces, sizeof( dedaiSpaceMeshFace ) * pFaceCount );
+		
+		pBlockedFaces = new dedaiConvexFaceList*[ pFaceCount ];
+		pDirtyBlockedFaces = new bool[ pFaceCount ];
+		for( i=0; i<pFaceCount; i++ ){
+			pBlockedFaces[ i ] = NULL;
+			pDirtyBlockedFaces[ i ] = true;
+		}
+	}
 }
 
+void dedaiSpaceMesh::pRestoreBlockerBase(){
+	pFaceCount = pBlockerBaseFace;
+	pCornerCount = pBlockerBaseCorner;
+	pEdgeCount = pBlockerBaseEdge;
+	pVertexCount = pBlockerBaseVertex;
+	
+	if( pVertexCount > 0 ){
+		memcpy( pVertices, pBaseVertices, sizeof( decVector ) * pVertexCount );
+	}
+	if( pEdgeCount > 0 ){
+		memcpy( pEdges, pBaseEdges, sizeof( dedaiSpaceMeshEdge ) * pEdgeCount );
+	}
+	if( pCornerCount > 0 ){
+		memcpy( pCorners, pBaseCorners, sizeof( dedaiSpaceMeshCorner ) * pCornerCount );
+	}
+	if( pFaceCount > 0 ){
+		memcpy( pFaces, pBaseFaces, sizeof( dedaiSpaceMeshFace ) * pFaceCount );
+	}
+}
 
+void dedaiSpaceMesh::pFreeBlockerBase(){
+	pClearBlockedFaces();
+	
+	if( pDirtyBlockedFaces ){
+		delete [] pDirtyBlockedFaces;
+		pDirtyBlockedFaces = NULL;
+	}
+	if( pBlockedFaces ){
+		delete [] pBlockedFaces;
+		pBlockedFaces = NULL;
+	}
+	if( pBaseFaces ){
+		delete [] pBaseFaces;
+		pBaseFaces = NULL;
+	}
+	if( pBaseCorners ){
+		delete [] pBaseCorners;
+		pBaseCorners = NULL;
+	}
+	if( pBaseEdges ){
+		delete [] pBaseEdges;
+		pBaseEdges = NULL;
+	}
+	if( pBaseVertices ){
+		delete [] pBaseVertices;
+		pBaseVertices = NULL;
+	}
+	
+	pBlockerBaseVertex = 0;
+	pBlockerBaseEdge = 0;
+	pBlockerBaseCorner = 0;
+	pBlockerBaseFace = 0;
+}
+
+void dedaiSpaceMesh::pClearBlockedFaces(){
+	int i;
+	
+	for( i=0; i<pBlockerBaseFace; i++ ){
+		if( pBlockedFaces[ i ] ){
+			delete pBlockedFaces[ i ];
+			pBlockedFaces[ i ] = NULL;
+		}
+		pDirtyBlockedFaces[ i ] = false;
+	}
+}
+
+void dedaiSpaceMesh::pSplitDirtyFaces( const decConvexVolumeList &splitters ){
+	// collect dirty faces dropping their split result
+	int i, j, dirtyCount = 0;
+	
+	for( i=0; i<pBlockerBaseFace; i++ ){
+		if( ! pDirtyBlockedFaces[ i ] ){
+			continue;
+		}
+		
+		if( pBlockedFaces[ i ] ){
+			delete pBlockedFaces[ i ];
+			pBlockedFaces[ i ] = NULL;
+		}
+		dirtyCount++;
+	}
+	
+	if( dirtyCount == 0 ){
+		return;
+	}
+	
+	deDEAIModule &deai = pSpace.GetDEAI();
+	const bool optimize = deai.GetDeveloperMode().GetQuickDebug() == 0
+		|| deai.GetDeveloperMode().GetQuickDebug() == 9;
+	deParallelProcessing &parallelProcessing = deai.GetGameEngine()->GetParallelProcessing();
+	decThreadSafeObjectOrderedSet tasks;
+	int *dirtyFaces = NULL;
+	
+	try{
+		dirtyFaces = new int[ dirtyCount ];
+		for( i=0, j=0; i<pBlockerBaseFace; i++ ){
+			if( pDirtyBlockedFaces[ i ] ){
+				dirtyFaces[ j++ ] = i;
+			}
+		}
+		
+		// split faces using parallel tasks if there are enough dirty faces. tasks only read
+		// the base faces and write the split result of their faces. parallel processing is
+		// paused if the engine is in progress of being stopped. split then faces directly
+		if( dirtyCount >= PARALLEL_SPLIT_FACE_COUNT && parallelProcessing.GetCoreCount() > 1
+		&& ! parallelProcessing.GetPaused() ){
+			const int taskTarget = parallelProcessing.GetCoreCount() * 2;
+			const int facesPerTask = decMath::max( ( dirtyCount + taskTarget - 1 ) / taskTarget,
+				PARALLEL_SPLIT_TASK_FACE_COUNT );
+			deThreadSafeObjectReference task;
+			
+			try{
+				for( i=0; i<dirtyCount; i+=facesPerTask ){
+					task.TakeOver( new dedaiSpaceMeshBlockingTask( deai, *this, splitters,
+						dirtyFaces + i, decMath::min( facesPerTask, dirtyCount - i ),
+						optimize, pBlockedFaces ) );
+					tasks.Add( task );
+					parallelProcessing.AddTask( ( dedaiSpaceMeshBlockingTask* )( deThreadSafeObject* )task );
+				}
+				
+			}catch( const deException & ){
+				const int count = tasks.GetCount();
+				for( i=0; i<count; i++ ){
+					parallelProcessing.WaitForTask( ( dedaiSpaceMeshBlockingTask* )tasks.GetAt( i ) );
+				}
+				throw;
+			}
+			
+			const int count = tasks.GetCount();
+			for( i=0; i<count; i++ ){
+				parallelProcessing.WaitForTask( ( dedaiSpaceMeshBlockingTask* )tasks.GetAt( i ) );
+			}
+			
+			// split faces of failed tasks again. this time exceptions are thrown
+			for( i=0; i<count; i++ ){
+				const dedaiSpaceMeshBlockingTask &blockingTask = *( ( dedaiSpaceMeshBlockingTask* )tasks.GetAt( i ) );
+				if( ! blockingTask.GetFailed() ){
+					continue;
+				}
+				
+				const int * const taskFaces = blockingTask.GetFaces();
+				const int taskFaceCount = blockingTask.GetFaceCount();
+				for( j=0; j<taskFaceCount; j++ ){
+					const int face = taskFaces[ j ];
+					if( pBlockedFaces[ face ] ){
+						delete pBlockedFaces[ face ];
+						pBlockedFaces[ face ] = NULL;
+					}
+					pBlockedFaces[ face ] = SplitBaseFace( face, splitters, optimize );
+				}
+			}
+			
+		}else{
+			for( i=0; i<dirtyCount; i++ ){
+				pBlockedFaces[ dirtyFaces[ i ] ] = SplitBaseFace( dirtyFaces[ i ], splitters, optimize );
+			}
+		}
+		
+		for( i=0; i<dirtyCount; i++ ){
+			pDirtyBlockedFaces[ dirtyFaces[ i ] ] = false;
+		}
+		
+		delete [] dirtyFaces;
+		
+	}catch( const deException & ){
+		if( dirtyFaces ){
+			delete [] dirtyFaces;
+		}
+		throw;
+	}
+}
 
 void dedaiSpaceMesh::pInitConvexFaceListFromFace( dedaiConvexFaceList &list, const dedaiSpaceMeshFace &face ) const{
 	const int firstCorner = face.GetFirstCorner();
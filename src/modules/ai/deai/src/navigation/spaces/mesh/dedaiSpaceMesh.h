@@ -66,6 +66,14 @@ private:
 	int pStaticFaceCount;
 	int pBlockerBaseFace;
 	
+	decVector *pBaseVertices;
+	dedaiSpaceMeshEdge *pBaseEdges;
+	dedaiSpaceMeshCorner *pBaseCorners;
+	dedaiSpaceMeshFace *pBaseFaces;
+	
+	dedaiConvexFaceList **pBlockedFaces;
+	bool *pDirtyBlockedFaces;
+	
 	dedaiSpaceMeshLink *pLinks;
 	int pLinkCount;
 	int pLinkSize;
@@ -212,9 +220,29 @@ public:
 	/** \brief Link to other navigation meshes if possible. */
 	void LinkToOtherMeshes();
 	
-	/** \brief Update blocking. */
+	/**
+	 * \brief Update blocking.
+	 * 
+	 * Only base faces marked dirty using InvalidateBlocking() are split again. The split
+	 * results of all other base faces are reused from the last update.
+	 */
 	void UpdateBlocking();
 	
+	/** \brief Mark all base faces dirty for the next blocking update. */
+	void InvalidateBlocking();
+	
+	/** \brief Mark base faces overlapping box in local space dirty for the next blocking update. */
+	void InvalidateBlocking( const decVector &minExtend, const decVector &maxExtend );
+	
+	/**
+	 * \brief Split base face by splitter volumes.
+	 * 
+	 * Returns split faces or NULL if the face is not affected by the splitter volumes.
+	 * Caller takes over ownership of the returned list. Reads only the base faces and
+	 * is safe to be called from parallel tasks while the mesh is not modified.
+	 */
+	dedaiConvexFaceList *SplitBaseFace( int face, const decConvexVolumeList &splitters, bool optimize ) const;
+	
 	/** \brief Clear space mesh. */
 	void Clear();
 	
@@ -229,6 +257,11 @@ public:
 private:
 	void pInitFromNavSpace();
 	void pInitFromHTNavSpace();
+	void pStoreBlockerBase();
+	void pRestoreBlockerBase();
+	void pFreeBlockerBase();
+	void pClearBlockedFaces();
+	void pSplitDirtyFaces( const decConvexVolumeList &splitters );
 	
 	void pInitConvexFaceListFromFace( dedaiConvexFaceList &list, const dedaiSpaceMeshFace &face ) const;
 	bool pMatchesConvexFaceListMeshFace( dedaiConvexFaceList &list, const dedaiSpaceMeshFace &face ) const;
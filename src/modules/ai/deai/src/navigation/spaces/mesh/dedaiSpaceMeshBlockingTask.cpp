@@ -0,0 +1,100 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "dedaiSpaceMesh.h"
+#include "dedaiSpaceMeshBlockingTask.h"
+#include "../../../deDEAIModule.h"
+#include "../../../utils/dedaiConvexFaceList.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decConvexVolumeList.h>
+
+
+
+// Class dedaiSpaceMeshBlockingTask
+/////////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+dedaiSpaceMeshBlockingTask::dedaiSpaceMeshBlockingTask( deDEAIModule &deai,
+const dedaiSpaceMesh &mesh, const decConvexVolumeList &splitters, const int *faces,
+int faceCount, bool optimize, dedaiConvexFaceList **results ) :
+deParallelTask( &deai ),
+pMesh( mesh ),
+pSplitters( splitters ),
+pFaces( faces ),
+pFaceCount( faceCount ),
+pOptimize( optimize ),
+pResults( results ),
+pFailed( false )
+{
+	if( ! faces || faceCount < 0 || ! results ){
+		DETHROW( deeInvalidParam );
+	}
+}
+
+dedaiSpaceMeshBlockingTask::~dedaiSpaceMeshBlockingTask(){
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void dedaiSpaceMeshBlockingTask::Run(){
+	int i;
+	
+	try{
+		for( i=0; i<pFaceCount; i++ ){
+			if( IsCancelled() ){
+				pFailed = true;
+				return;
+			}
+			
+			const int face = pFaces[ i ];
+			pResults[ face ] = pMesh.SplitBaseFace( face, pSplitters, pOptimize );
+		}
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void dedaiSpaceMeshBlockingTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString dedaiSpaceMeshBlockingTask::GetDebugName() const{
+	return "DEAI:MeshBlocking";
+}
+
+decString dedaiSpaceMeshBlockingTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "faces=%d splitters=%d", pFaceCount, pSplitters.GetVolumeCount() );
+	return details;
+}
@@ -0,0 +1,113 @@
+/* 
+ * Drag[en]gine AI Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDAISPACEMESHBLOCKINGTASK_H_
+#define _DEDAISPACEMESHBLOCKINGTASK_H_
+
+#include <dragengine/parallel/deParallelTask.h>
+
+class deDEAIModule;
+class dedaiSpaceMesh;
+class dedaiConvexFaceList;
+class decConvexVolumeList;
+
+
+
+/**
+ * \brief Parallel task splitting a range of space mesh base faces by blocker volumes.
+ * 
+ * Run() only reads the base faces of the mesh and writes the split results into the
+ * result slots of the processed faces. The results are applied to the mesh by the
+ * caller after the task finished. If splitting fails the task is marked failed and
+ * the caller has to split the range again.
+ */
+class dedaiSpaceMeshBlockingTask : public deParallelTask{
+private:
+	const dedaiSpaceMesh &pMesh;
+	const decConvexVolumeList &pSplitters;
+	const int *pFaces;
+	int pFaceCount;
+	bool pOptimize;
+	dedaiConvexFaceList **pResults;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create task.
+	 * \param[in] mesh Mesh to split faces of.
+	 * \param[in] splitters Splitter volumes. Has to stay valid until the task finished.
+	 * \param[in] faces Indices of faces to split. Has to stay valid until the task finished.
+	 * \param[in] faceCount Number of faces to split.
+	 * \param[in] optimize Optimize split faces.
+	 * \param[out] results Result slots indexed by face index.
+	 */
+	dedaiSpaceMeshBlockingTask( deDEAIModule &deai, const dedaiSpaceMesh &mesh,
+		const decConvexVolumeList &splitters, const int *faces, int faceCount,
+		bool optimize, dedaiConvexFaceList **results );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~dedaiSpaceMeshBlockingTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Indices of faces to split. */
+	inline const int *GetFaces() const{ return pFaces; }
+	
+	/** \brief Number of faces to split. */
+	inline int GetFaceCount() const{ return pFaceCount; }
+	
+	/** \brief Splitting failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
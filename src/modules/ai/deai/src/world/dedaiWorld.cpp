@@ -32,6 +32,7 @@
 #include "../navigation/heightterrain/dedaiHeightTerrainSector.h"
 #include "../navigation/heightterrain/dedaiHeightTerrainNavSpace.h"
 #include "../navigation/layer/dedaiLayer.h"
+#include "../navigation/pathfinding/query/dedaiPathQueryManager.h"
 #include "../devmode/dedaiDeveloperMode.h"
 
 #include <dragengine/resources/navigation/navigator/deNavigator.h>
@@ -54,9 +55,12 @@ dedaiWorld::dedaiWorld( deDEAIModule &deai, deWorld &world ) :
 pDEAI( deai ),
 pWorld( world ),
 pHeightTerrain( NULL ),
+pPathQueryManager( NULL ),
 pDevModeUpdateTracker( 0 )
 {
 	try{
+		pPathQueryManager = new dedaiPathQueryManager( deai );
+		
 		HeightTerrainChanged();
 		
 		deNavigationSpace *navspace = world.GetRootNavigationSpace();
@@ -228,6 +232,8 @@ void dedaiWorld::Update( float elapsed ){
 	for( i=0; i<count; i++ ){
 		( ( dedaiLayer* )pLayers.GetAt( i ) )->Update( elapsed );
 	}
+	
+	pPathQueryManager->Update();
 }
 
 
@@ -336,6 +342,10 @@ void dedaiWorld::HeightTerrainChanged(){
 //////////////////////
 
 void dedaiWorld::pCleanUp(){
+	if( pPathQueryManager ){
+		delete pPathQueryManager;
+	}
+	
 	AllNavigatorsRemoved();
 	AllNavigationBlockersRemoved();
 	AllNavigationSpacesRemoved();
@@ -29,6 +29,7 @@
 
 class dedaiLayer;
 class dedaiHeightTerrain;
+class dedaiPathQueryManager;
 class deNavigationBlocker;
 class deDEAIModule;
 class deWorld;
@@ -49,6 +50,8 @@ private:
 	
 	decObjectList pLayers;
 	
+	dedaiPathQueryManager *pPathQueryManager;
+	
 	unsigned int pDevModeUpdateTracker;
 	
 	
@@ -87,6 +90,9 @@ public:
 	 */
 	dedaiLayer *GetLayer( int layer );
 	
+	/** \brief Path query manager. */
+	inline dedaiPathQueryManager &GetPathQueryManager() const{ return *pPathQueryManager; }
+	
 	
 	
 	/** \brief Update developer mode information if enabled. */
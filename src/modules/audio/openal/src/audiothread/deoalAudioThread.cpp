@@ -48,8 +48,10 @@
 #include "../microphone/deoalAMicrophone.h"
 #include "../model/deoalModel.h"
 #include "../skin/deoalSkin.h"
+#include "../sound/deoalDecodeAhead.h"
 #include "../sound/deoalDecodeBuffer.h"
 #include "../sound/deoalSound.h"
+#include "../sound/deoalSoundResidency.h"
 #include "../source/deoalSourceManager.h"
 #include "../speaker/deoalSpeaker.h"
 #include "../speaker/deoalSpeakerList.h"
@@ -111,6 +113,8 @@ pRayTracing( NULL ),
 
 pCaches( NULL ),
 pDecodeBuffer( NULL ),
+pDecodeAhead( NULL ),
+pSoundResidency( NULL ),
 
 pExtensions( NULL ),
 pCapabilities( NULL ),
@@ -611,6 +615,8 @@ void deoalAudioThread::pInitThreadPhase1(){
 	pSourceManager = new deoalSourceManager( *this );
 	pSpeakerList = new deoalSpeakerList;
 	pDecodeBuffer = new deoalDecodeBuffer( ( 44100 / 10 ) * 4 );
+	pDecodeAhead = new deoalDecodeAhead( *this );
+	pSoundResidency = new deoalSoundResidency( *this );
 	pSharedBufferList = new deoalSharedBufferList;
 	
 	pRTParallelEnvProbe = new deoalRTParallelEnvProbe( *this );
@@ -666,6 +672,12 @@ void deoalAudioThread::pCleanUpThread(){
 	if( pSpeakerList ){
 		delete pSpeakerList;
 	}
+	if( pSoundResidency ){
+		delete pSoundResidency;
+	}
+	if( pDecodeAhead ){
+		delete pDecodeAhead;
+	}
 	if( pDecodeBuffer ){
 		delete pDecodeBuffer;
 	}
@@ -781,6 +793,7 @@ void deoalAudioThread::pProcessAudio(){
 	}else{
 		OAL_CHECK( *this, alListenerf( AL_GAIN, 0.0f ) ); // mute listener
 	}
+	pSoundResidency->EnforceBudget();
 	pDebugInfo->StoreTimeAudioThreadAudio();
 	
 	pDelayed->ProcessFreeOperations( false );
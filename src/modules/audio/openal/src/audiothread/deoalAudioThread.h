@@ -42,7 +42,9 @@ class deoalCaches;
 class deoalCapabilities;
 class deoalConfiguration;
 class deoalDebugInfo;
+class deoalDecodeAhead;
 class deoalDecodeBuffer;
+class deoalSoundResidency;
 class deoalDevMode;
 class deoalExtensions;
 class deoalRTParallelEnvProbe;
@@ -90,6 +92,8 @@ private:
 	
 	deoalCaches *pCaches;
 	deoalDecodeBuffer *pDecodeBuffer;
+	deoalDecodeAhead *pDecodeAhead;
+	deoalSoundResidency *pSoundResidency;
 	
 	deoalExtensions *pExtensions;
 	deoalCapabilities *pCapabilities;
@@ -253,6 +257,12 @@ public:
 	/** \brief Shared decode buffer. */
 	inline deoalDecodeBuffer &GetDecodeBuffer() const{ return *pDecodeBuffer; }
 	
+	/** \brief Decode-ahead for streaming speakers. */
+	inline deoalDecodeAhead &GetDecodeAhead() const{ return *pDecodeAhead; }
+	
+	/** \brief Residency of non-streaming sound samples. */
+	inline deoalSoundResidency &GetSoundResidency() const{ return *pSoundResidency; }
+	
 	/** \brief Configuration. */
 	inline deoalConfiguration &GetConfiguration(){ return pConfiguration; }
 	inline const deoalConfiguration &GetConfiguration() const{ return pConfiguration; }
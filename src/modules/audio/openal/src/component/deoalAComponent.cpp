@@ -38,6 +38,7 @@
 #include "../world/octree/deoalWorldOctree.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decSkinning.h>
 #include <dragengine/resources/component/deComponent.h>
 #include <dragengine/resources/component/deComponentBone.h>
 #include <dragengine/resources/rig/deRig.h>
@@ -70,6 +71,7 @@ pBoneCount( 0 ),
 pWeightMatrices( NULL ),
 pFaces( NULL ),
 pFaceCount( 0 ),
+pSkinnedCorners( NULL ),
 // pOctree( NULL ),
 pBVH( NULL ),
 
@@ -424,6 +426,9 @@ void deoalAComponent::pCleanUp(){
 // 	if( pOctree ){
 // 		delete pOctree;
 // 	}
+	if( pSkinnedCorners ){
+		delete [] pSkinnedCorners;
+	}
 	if( pFaces ){
 		delete [] pFaces;
 	}
@@ -809,19 +814,27 @@ void deoalAComponent::pUpdateFaces(){
 		}
 	}
 	
+	if( ! pSkinnedCorners ){
+		pSkinnedCorners = new decVector[ pFaceCount * 3 ];
+	}
+	
+	pModel->PrepareSkinning();
+	pModel->GetSkinning()->Transform( pWeightMatrices ? &pWeightMatrices[ 0 ].a11 : NULL,
+		sizeof( decMatrix ) / sizeof( float ), &pSkinnedCorners[ 0 ].x, sizeof( decVector ) / sizeof( float ) );
+	
 	int i;
 	for( i=0; i<pFaceCount; i++ ){
-		const deoalModelFace &modelFace = pModel->GetFaceAt( i );
+		const decVector * const corners = pSkinnedCorners + i * 3;
 		deoalModelFace &face = pFaces[ i ];
 		
 		if( face.GetWeightSet1() != -1 ){
-			face.SetVertex1( pWeightMatrices[ face.GetWeightSet1() ] * modelFace.GetVertex1() );
+			face.SetVertex1( corners[ 0 ] );
 		}
 		if( face.GetWeightSet2() != -1 ){
-			face.SetVertex2( pWeightMatrices[ face.GetWeightSet2() ] * modelFace.GetVertex2() );
+			face.SetVertex2( corners[ 1 ] );
 		}
 		if( face.GetWeightSet3() != -1 ){
-			face.SetVertex3( pWeightMatrices[ face.GetWeightSet3() ] * modelFace.GetVertex3() );
+			face.SetVertex3( corners[ 2 ] );
 		}
 		
 		face.UpdateNormalAndEdges();
@@ -853,6 +866,10 @@ void deoalAComponent::pUpdateFaces(){
 
 void deoalAComponent::pDropFaces(){
 	pDropOctree();
+	if( pSkinnedCorners ){
+		delete [] pSkinnedCorners;
+		pSkinnedCorners = NULL;
+	}
 	if( pFaces ){
 		delete [] pFaces;
 		pFaces = NULL;
@@ -95,6 +95,7 @@ private:
 	
 	deoalModelFace *pFaces;
 	int pFaceCount;
+	decVector *pSkinnedCorners;
 // 	deoalModelOctree *pOctree;
 	deoalModelRTBVH *pBVH;
 	decVector pDynamicMinExtend;
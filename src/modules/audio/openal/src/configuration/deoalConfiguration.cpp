@@ -42,6 +42,8 @@ pDirty( false ),
 
 pEnableEFX( true ),
 pStreamBufSizeThreshold( 700000 ), // see deoalSound.cpp
+pDecodeAheadBuffers( 3 ),
+pSoundMemoryBudget( 64 ),
 pAurealizationMode( eaFull ),
 
 pSoundTraceRayCount( 64 ),
@@ -107,6 +109,24 @@ void deoalConfiguration::SetStreamBufSizeThreshold( int threshold ){
 	pDirty = true;
 }
 
+void deoalConfiguration::SetDecodeAheadBuffers( int buffers ){
+	buffers = decMath::clamp( buffers, 0, 10 );
+	if( buffers == pDecodeAheadBuffers ){
+		return;
+	}
+	pDecodeAheadBuffers = buffers;
+	pDirty = true;
+}
+
+void deoalConfiguration::SetSoundMemoryBudget( int budget ){
+	budget = decMath::clamp( budget, 0, 2047 );
+	if( budget == pSoundMemoryBudget ){
+		return;
+	}
+	pSoundMemoryBudget = budget;
+	pDirty = true;
+}
+
 void deoalConfiguration::SetAurealizationMode( eAurealizationModes mode ){
 	if( mode == pAurealizationMode ){
 		return;
@@ -230,6 +250,8 @@ deoalConfiguration &deoalConfiguration::operator=( const deoalConfiguration &con
 	pDeviceName = config.pDeviceName;
 	pEnableEFX = config.pEnableEFX;
 	pStreamBufSizeThreshold = config.pStreamBufSizeThreshold;
+	pDecodeAheadBuffers = config.pDecodeAheadBuffers;
+	pSoundMemoryBudget = config.pSoundMemoryBudget;
 	pDisableExtensions = config.pDisableExtensions;
 	pAurealizationMode = config.pAurealizationMode;
 	
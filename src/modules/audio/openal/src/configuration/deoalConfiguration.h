@@ -67,6 +67,8 @@ private:
 	decString pDeviceName;
 	bool pEnableEFX;
 	int pStreamBufSizeThreshold;
+	int pDecodeAheadBuffers;
+	int pSoundMemoryBudget;
 	decStringSet pDisableExtensions;
 	eAurealizationModes pAurealizationMode;
 	
@@ -127,6 +129,24 @@ public:
 	/** \brief Set buffer size threshold to stream sound samples. */
 	void SetStreamBufSizeThreshold( int threshold );
 	
+	/**
+	 * \brief Number of streaming buffers to decode ahead for streaming speakers.
+	 * \details Decoding ahead is done by decode-ahead threads. 0 decodes on the audio thread.
+	 */
+	inline int GetDecodeAheadBuffers() const{ return pDecodeAheadBuffers; }
+	
+	/** \brief Set number of streaming buffers to decode ahead for streaming speakers. */
+	void SetDecodeAheadBuffers( int buffers );
+	
+	/**
+	 * \brief Memory budget in MB for non-streaming sound samples.
+	 * \details If exceeded least recently played sounds drop their samples. 0 is unlimited.
+	 */
+	inline int GetSoundMemoryBudget() const{ return pSoundMemoryBudget; }
+	
+	/** \brief Set memory budget in MB for non-streaming sound samples. */
+	void SetSoundMemoryBudget( int budget );
+	
 	/** \brief Disable extensions. */
 	inline decStringSet &GetDisableExtensions(){ return pDisableExtensions; }
 	inline const decStringSet &GetDisableExtensions() const{ return pDisableExtensions; }
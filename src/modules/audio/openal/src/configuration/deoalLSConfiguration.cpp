@@ -228,6 +228,12 @@ void deoalLSConfiguration::pLoadConfig( decBaseFileReader *file ){
 			pConfig.SetStreamBufSizeThreshold( pGetCDataInt( *tag,
 				pConfig.GetStreamBufSizeThreshold() ) );
 			
+		}else if( name == "decodeAheadBuffers" ){
+			pConfig.SetDecodeAheadBuffers( pGetCDataInt( *tag, pConfig.GetDecodeAheadBuffers() ) );
+			
+		}else if( name == "soundMemoryBudget" ){
+			pConfig.SetSoundMemoryBudget( pGetCDataInt( *tag, pConfig.GetSoundMemoryBudget() ) );
+			
 		}else if( name == "disableExtension" ){
 			pConfig.GetDisableExtensions().Add( pGetCData( *tag, "" ) );
 			pConfig.SetDirty( true );
@@ -43,12 +43,16 @@
 
 deoalCaches::deoalCaches( deoalAudioThread &audioThread ) :
 pAudioThread( audioThread ),
-pSound( NULL )
+pSound( NULL ),
+pModel( NULL )
 {
 	try{
 		pSound = new deCacheHelper( &audioThread.GetOal().GetVFS(),
 			decPath::CreatePathUnix( "/cache/local/sound" ) );
 		
+		pModel = new deCacheHelper( &audioThread.GetOal().GetVFS(),
+			decPath::CreatePathUnix( "/cache/local/model" ) );
+		
 	}catch( const deException & ){
 		pCleanUp();
 		throw;
@@ -78,6 +82,9 @@ void deoalCaches::Unlock(){
 //////////////////////
 
 void deoalCaches::pCleanUp(){
+	if( pModel ){
+		delete pModel;
+	}
 	if( pSound ){
 		delete pSound;
 	}
@@ -38,6 +38,7 @@ private:
 	deMutex pMutex;
 	
 	deCacheHelper *pSound;
+	deCacheHelper *pModel;
 	
 	
 	
@@ -64,6 +65,9 @@ public:
 	/** \brief Sound cache. */
 	inline deCacheHelper &GetSound() const{ return *pSound; }
 	
+	/** \brief Model cache. */
+	inline deCacheHelper &GetModel() const{ return *pModel; }
+	
 	
 	
 private:
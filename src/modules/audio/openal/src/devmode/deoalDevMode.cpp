@@ -22,6 +22,7 @@
 #include <stdlib.h>
 
 #include "deoalDevMode.h"
+#include "deoalRayTraceBenchmark.h"
 #include "../deoalBasics.h"
 #include "../deAudioOpenAL.h"
 #include "../configuration/deoalConfiguration.h"
@@ -116,6 +117,10 @@ bool deoalDevMode::ExecuteCommand( const decUnicodeArgumentList &command, decUni
 		}else if( command.MatchesArgumentAt( 0, "dm_capture_speaker_direct_closest" ) ){
 			pCmdCaptureSpeakerDirectClosest( command, answer );
 			return true;
+			
+		}else if( command.MatchesArgumentAt( 0, "dm_ray_trace_benchmark" ) ){
+			pCmdRayTraceBenchmark( command, answer );
+			return true;
 		}
 		
 	}catch( const deException &exception ){
@@ -149,6 +154,8 @@ void deoalDevMode::pCmdHelp( const decUnicodeArgumentList &, decUnicodeString &a
 	answer.AppendFromUTF8( "dm_capture_mic_rays [xray] => Capture microphone sound rays once (visualize).\n" );
 	answer.AppendFromUTF8( "dm_show_audio_models [0|1] => Show audio models.\n" );
 	answer.AppendFromUTF8( "dm_capture_speaker_direct_closest <number> => Capture speaker direct closest.\n" );
+	answer.AppendFromUTF8( "dm_ray_trace_benchmark [rays] [grid] => "
+		"Benchmark model BVH ray tracing on a synthetic test mesh.\n" );
 }
 
 void deoalDevMode::pCmdEnable( const decUnicodeArgumentList &, decUnicodeString &answer ){
@@ -261,6 +268,23 @@ void deoalDevMode::pCmdCaptureSpeakerDirectClosest( const decUnicodeArgumentList
 	}
 }
 
+void deoalDevMode::pCmdRayTraceBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	int rayCount = 100000;
+	int gridSize = 64;
+	
+	if( command.GetArgumentCount() > 1 ){
+		rayCount = decMath::max( command.GetArgumentAt( 1 )->ToInt(), 1 );
+	}
+	if( command.GetArgumentCount() > 2 ){
+		gridSize = decMath::max( command.GetArgumentAt( 2 )->ToInt(), 1 );
+	}
+	
+	deoalRayTraceBenchmark benchmark;
+	decString result;
+	benchmark.Run( rayCount, gridSize, result );
+	answer.AppendFromUTF8( result );
+}
+
 
 
 void deoalDevMode::pActiveWorldNotifyDevModeChanged(){
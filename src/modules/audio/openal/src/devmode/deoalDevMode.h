@@ -129,6 +129,7 @@ private:
 	void pCmdCaptureMicRays( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	void pCmdShowAudioModels( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	void pCmdCaptureSpeakerDirectClosest( const decUnicodeArgumentList &command, decUnicodeString &answer );
+	void pCmdRayTraceBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	
 	void pActiveWorldNotifyDevModeChanged();
 };
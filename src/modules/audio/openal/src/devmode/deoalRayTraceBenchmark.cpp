@@ -0,0 +1,367 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "deoalRayTraceBenchmark.h"
+#include "../model/deoalModelFace.h"
+#include "../utils/deoalSimdRay.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/utils/decTimer.h>
+
+
+
+// Definitions
+////////////////
+
+// height of the box enclosing the height field
+#define BOX_HEIGHT		10.0f
+
+// length of rays traced
+#define RAY_LENGTH		20.0f
+
+// margin added to binary node boxes. matches deoalSimdRay
+#define BOX_MARGIN		1e-4f
+
+
+
+// Class deoalRayTraceBenchmark
+/////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+deoalRayTraceBenchmark::deoalRayTraceBenchmark() :
+pRandomSeed( 0x5eed1234 ){
+}
+
+deoalRayTraceBenchmark::~deoalRayTraceBenchmark(){
+}
+
+
+
+// Management
+///////////////
+
+void deoalRayTraceBenchmark::Run( int rayCount, int gridSize, decString &result ){
+	if( rayCount < 1 || gridSize < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	deoalModelFace *faces = NULL;
+	decVector *origins = NULL;
+	decVector *directions = NULL;
+	int *hitCounts = NULL;
+	int faceCount = 0;
+	decTimer timer;
+	int i;
+	
+	pRandomSeed = 0x5eed1234;
+	
+	try{
+		faces = pCreateMesh( gridSize, faceCount );
+		
+		// build bvh
+		deoalModelRTBVH bvh;
+		timer.Reset();
+		bvh.Build( faces, faceCount );
+		const float timeBuild = timer.GetElapsedTime();
+		bvh.DropBuildData();
+		
+		// random rays inside the box
+		origins = new decVector[ rayCount ];
+		directions = new decVector[ rayCount ];
+		hitCounts = new int[ rayCount ];
+		
+		const float size = ( float )gridSize;
+		for( i=0; i<rayCount; i++ ){
+			origins[ i ].Set( pRandom() * size, 1.0f + pRandom() * ( BOX_HEIGHT - 2.0f ), pRandom() * size );
+			
+			decVector direction( pRandom() * 2.0f - 1.0f, pRandom() * 2.0f - 1.0f, pRandom() * 2.0f - 1.0f );
+			if( direction.IsZero() ){
+				direction.Set( 0.0f, -1.0f, 0.0f );
+			}
+			directions[ i ] = direction.Normalized() * RAY_LENGTH;
+		}
+		
+		// binary nodes with scalar tests
+		int hitCountBinary = 0;
+		
+		timer.Reset();
+		for( i=0; i<rayCount; i++ ){
+			const decVector &direction = directions[ i ];
+			const decVector invDirection(
+				fabsf( direction.x ) > FLOAT_SAFE_EPSILON ? 1.0f / direction.x : 1e30f,
+				fabsf( direction.y ) > FLOAT_SAFE_EPSILON ? 1.0f / direction.y : 1e30f,
+				fabsf( direction.z ) > FLOAT_SAFE_EPSILON ? 1.0f / direction.z : 1e30f );
+			
+			hitCounts[ i ] = pTraceBinary( bvh, bvh.GetNodes()[ 0 ], origins[ i ], direction, invDirection );
+			hitCountBinary += hitCounts[ i ];
+		}
+		const float timeBinary = timer.GetElapsedTime();
+		
+		// wide nodes with simd tests
+		deoalSimdRay ray;
+		int hitCountWide = 0;
+		int mismatchCount = 0;
+		
+		timer.Reset();
+		for( i=0; i<rayCount; i++ ){
+			ray.SetRay( origins[ i ], directions[ i ] );
+			const int hitCount = pTraceWide( bvh, bvh.GetWideNodes()[ 0 ], origins[ i ], directions[ i ], ray );
+			hitCountWide += hitCount;
+			if( hitCount != hitCounts[ i ] ){
+				mismatchCount++;
+			}
+		}
+		const float timeWide = timer.GetElapsedTime();
+		
+		result.Format( "Ray trace benchmark: rays=%d grid=%dx%d faces=%d"
+#ifdef __SSE__
+			" simd=sse\n"
+#else
+			" simd=none\n"
+#endif
+			"  Build: %.3fms (nodes=%d, wide nodes=%d)\n"
+			"  Binary: %.3fms (%.0f rays/s, hits=%d)\n"
+			"  Wide: %.3fms (%.0f rays/s, hits=%d, mismatches=%d)\n",
+			rayCount, gridSize, gridSize, faceCount,
+			timeBuild * 1e3f, bvh.GetNodeCount(), bvh.GetWideNodeCount(),
+			timeBinary * 1e3f, ( float )rayCount / decMath::max( timeBinary, 1e-6f ), hitCountBinary,
+			timeWide * 1e3f, ( float )rayCount / decMath::max( timeWide, 1e-6f ), hitCountWide,
+			mismatchCount );
+		
+		delete [] hitCounts;
+		delete [] directions;
+		delete [] origins;
+		delete [] faces;
+		
+	}catch( const deException & ){
+		if( hitCounts ){
+			delete [] hitCounts;
+		}
+		if( directions ){
+			delete [] directions;
+		}
+		if( origins ){
+			delete [] origins;
+		}
+		if( faces ){
+			delete [] faces;
+		}
+		throw;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+deoalModelFace *deoalRayTraceBenchmark::pCreateMesh( int gridSize, int &faceCount ){
+	const int vertexStride = gridSize + 1;
+	const float size = ( float )gridSize;
+	float *heights = NULL;
+	deoalModelFace *faces = NULL;
+	int x, z;
+	
+	faceCount = gridSize * gridSize * 2 + 12;
+	
+	try{
+		heights = new float[ vertexStride * vertexStride ];
+		faces = new deoalModelFace[ faceCount ];
+		
+		// rolling height field with some noise
+		for( z=0; z<=gridSize; z++ ){
+			for( x=0; x<=gridSize; x++ ){
+				heights[ z * vertexStride + x ] = sinf( ( float )x * 0.3f ) * cosf( ( float )z * 0.2f )
+					+ pRandom() * 0.5f;
+			}
+		}
+		
+		int index = 0;
+		for( z=0; z<gridSize; z++ ){
+			for( x=0; x<gridSize; x++ ){
+				const decVector v1( ( float )x, heights[ z * vertexStride + x ], ( float )z );
+				const decVector v2( ( float )x, heights[ ( z + 1 ) * vertexStride + x ], ( float )( z + 1 ) );
+				const decVector v3( ( float )( x + 1 ), heights[ ( z + 1 ) * vertexStride + x + 1 ], ( float )( z + 1 ) );
+				const decVector v4( ( float )( x + 1 ), heights[ z * vertexStride + x + 1 ], ( float )z );
+				
+				faces[ index ].SetVertex1( v1 );
+				faces[ index ].SetVertex2( v2 );
+				faces[ index ].SetVertex3( v3 );
+				faces[ index++ ].UpdateNormalAndEdges();
+				
+				faces[ index ].SetVertex1( v1 );
+				faces[ index ].SetVertex2( v3 );
+				faces[ index ].SetVertex3( v4 );
+				faces[ index++ ].UpdateNormalAndEdges();
+			}
+		}
+		
+		// box enclosing the height field
+		const decVector corners[ 8 ] = {
+			decVector( 0.0f, -2.0f, 0.0f ), decVector( size, -2.0f, 0.0f ),
+			decVector( size, -2.0f, size ), decVector( 0.0f, -2.0f, size ),
+			decVector( 0.0f, BOX_HEIGHT, 0.0f ), decVector( size, BOX_HEIGHT, 0.0f ),
+			decVector( size, BOX_HEIGHT, size ), decVector( 0.0f, BOX_HEIGHT, size ) };
+		const int quads[ 6 ][ 4 ] = {
+			{ 0, 1, 2, 3 }, { 4, 7, 6, 5 }, { 0, 4, 5, 1 },
+			{ 1, 5, 6, 2 }, { 2, 6, 7, 3 }, { 3, 7, 4, 0 } };
+		int i;
+		
+		for( i=0; i<6; i++ ){
+			faces[ index ].SetVertex1( corners[ quads[ i ][ 0 ] ] );
+			faces[ index ].SetVertex2( corners[ quads[ i ][ 1 ] ] );
+			faces[ index ].SetVertex3( corners[ quads[ i ][ 2 ] ] );
+			faces[ index++ ].UpdateNormalAndEdges();
+			
+			faces[ index ].SetVertex1( corners[ quads[ i ][ 0 ] ] );
+			faces[ index ].SetVertex2( corners[ quads[ i ][ 2 ] ] );
+			faces[ index ].SetVertex3( corners[ quads[ i ][ 3 ] ] );
+			faces[ index++ ].UpdateNormalAndEdges();
+		}
+		
+		delete [] heights;
+		
+	}catch( const deException & ){
+		if( faces ){
+			delete [] faces;
+		}
+		if( heights ){
+			delete [] heights;
+		}
+		throw;
+	}
+	
+	return faces;
+}
+
+float deoalRayTraceBenchmark::pRandom(){
+	// fixed seed linear congruential generator. results are reproducible across runs
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return ( float )( ( pRandomSeed >> 8 ) & 0xffff ) / 65535.0f;
+}
+
+int deoalRayTraceBenchmark::pTraceBinary( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sNode &node,
+const decVector &origin, const decVector &direction, const decVector &invDirection ) const{
+	int hitCount = 0;
+	
+	if( node.faceCount > 0 ){
+		const deoalModelRTBVH::sFace * const faces = bvh.GetFaces() + node.firstFace;
+		int i;
+		
+		for( i=0; i<node.faceCount; i++ ){
+			if( pRayHitsFace( faces[ i ], origin, direction ) ){
+				hitCount++;
+			}
+		}
+		
+	}else{
+		const deoalModelRTBVH::sNode &child1 = bvh.GetNodes()[ node.node1 ];
+		if( pRayHitsBox( child1.center, child1.halfSize, origin, direction, invDirection ) ){
+			hitCount += pTraceBinary( bvh, child1, origin, direction, invDirection );
+		}
+		
+		const deoalModelRTBVH::sNode &child2 = bvh.GetNodes()[ node.node2 ];
+		if( pRayHitsBox( child2.center, child2.halfSize, origin, direction, invDirection ) ){
+			hitCount += pTraceBinary( bvh, child2, origin, direction, invDirection );
+		}
+	}
+	
+	return hitCount;
+}
+
+int deoalRayTraceBenchmark::pTraceWide( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sWideNode &node,
+const decVector &origin, const decVector &direction, const deoalSimdRay &ray ) const{
+	float distances[ 4 ];
+	const int mask = ray.RayHitsBoxes( node.bounds, distances );
+	int i, j, k, hitCount = 0;
+	
+	for( i=0; i<4; i++ ){
+		if( ( mask & ( 1 << i ) ) == 0 ){
+			continue;
+		}
+		
+		if( node.node[ i ] != -1 ){
+			hitCount += pTraceWide( bvh, bvh.GetWideNodes()[ node.node[ i ] ], origin, direction, ray );
+			continue;
+		}
+		
+		const int lastFace = node.firstFace[ i ] + node.faceCount[ i ];
+		
+		for( j=node.firstFace[ i ]; j<lastFace; j+=4 ){
+			const int faceMask = ray.RayHitsFacePlanes( bvh.GetFacePlaneNormalX() + j,
+				bvh.GetFacePlaneNormalY() + j, bvh.GetFacePlaneNormalZ() + j,
+				bvh.GetFacePlaneDistance() + j, decMath::min( lastFace - j, 4 ), 1.0f );
+			
+			for( k=0; k<4; k++ ){
+				if( ( faceMask & ( 1 << k ) ) != 0 && pRayHitsFace( bvh.GetFaces()[ j + k ], origin, direction ) ){
+					hitCount++;
+				}
+			}
+		}
+	}
+	
+	return hitCount;
+}
+
+bool deoalRayTraceBenchmark::pRayHitsBox( const decVector &center, const decVector &halfSize,
+const decVector &origin, const decVector &direction, const decVector &invDirection ){
+	const decVector minExtend( center - halfSize - decVector( BOX_MARGIN, BOX_MARGIN, BOX_MARGIN ) );
+	const decVector maxExtend( center + halfSize + decVector( BOX_MARGIN, BOX_MARGIN, BOX_MARGIN ) );
+	
+	const float x1 = ( minExtend.x - origin.x ) * invDirection.x;
+	const float x2 = ( maxExtend.x - origin.x ) * invDirection.x;
+	const float y1 = ( minExtend.y - origin.y ) * invDirection.y;
+	const float y2 = ( maxExtend.y - origin.y ) * invDirection.y;
+	const float z1 = ( minExtend.z - origin.z ) * invDirection.z;
+	const float z2 = ( maxExtend.z - origin.z ) * invDirection.z;
+	
+	const float enter = decMath::max( decMath::max( decMath::min( x1, x2 ),
+		decMath::min( y1, y2 ) ), decMath::max( decMath::min( z1, z2 ), 0.0f ) );
+	const float leave = decMath::min( decMath::min( decMath::max( x1, x2 ),
+		decMath::max( y1, y2 ) ), decMath::min( decMath::max( z1, z2 ), 1.0f ) );
+	
+	return enter <= leave;
+}
+
+bool deoalRayTraceBenchmark::pRayHitsFace( const deoalModelRTBVH::sFace &face,
+const decVector &origin, const decVector &direction ){
+	const float dot = face.normal * direction;
+	if( fabsf( dot ) < FLOAT_SAFE_EPSILON ){
+		return false;
+	}
+	
+	const float lambda = ( ( face.baseVertex - origin ) * face.normal ) / dot;
+	if( lambda < 0.0f || lambda > 1.0f ){
+		return false;
+	}
+	
+	const decVector hitPoint( origin + direction * lambda );
+	
+	return face.edgeNormal[ 0 ] * hitPoint >= face.edgeDistance[ 0 ]
+		&& face.edgeNormal[ 1 ] * hitPoint >= face.edgeDistance[ 1 ]
+		&& face.edgeNormal[ 2 ] * hitPoint >= face.edgeDistance[ 2 ];
+}
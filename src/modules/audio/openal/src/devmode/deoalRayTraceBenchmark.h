@@ -0,0 +1,90 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+
+#ifndef _DEOALRAYTRACEBENCHMARK_H_
+#define _DEOALRAYTRACEBENCHMARK_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/common/string/decString.h>
+
+#include "../model/octree/deoalModelRTBVH.h"
+
+class deoalModelFace;
+class deoalSimdRay;
+
+
+
+/**
+ * \brief Ray tracing benchmark.
+ * 
+ * Developer mode benchmark for the model BVH. Builds a synthetic test mesh consisting of
+ * a height field inside a closed box and traces random rays against it. Rays are traced
+ * once using the binary nodes with scalar tests and once using the wide nodes with SIMD
+ * tests. Both runs count all faces hit and have to produce the same result.
+ */
+class deoalRayTraceBenchmark{
+private:
+	unsigned int pRandomSeed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create benchmark. */
+	deoalRayTraceBenchmark();
+	
+	/** \brief Clean up benchmark. */
+	~deoalRayTraceBenchmark();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Run benchmark.
+	 * \param[in] rayCount Number of rays to trace.
+	 * \param[in] gridSize Number of height field cells along each side of the test mesh.
+	 * \param[out] result Benchmark results in human readable form.
+	 */
+	void Run( int rayCount, int gridSize, decString &result );
+	/*@}*/
+	
+	
+	
+private:
+	deoalModelFace *pCreateMesh( int gridSize, int &faceCount );
+	float pRandom();
+	
+	int pTraceBinary( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sNode &node,
+		const decVector &origin, const decVector &direction, const decVector &invDirection ) const;
+	int pTraceWide( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sWideNode &node,
+		const decVector &origin, const decVector &direction, const deoalSimdRay &ray ) const;
+	
+	static bool pRayHitsBox( const decVector &center, const decVector &halfSize,
+		const decVector &origin, const decVector &direction, const decVector &invDirection );
+	static bool pRayHitsFace( const deoalModelRTBVH::sFace &face,
+		const decVector &origin, const decVector &direction );
+};
+
+#endif
@@ -27,6 +27,7 @@
 #include "../../../model/octree/deoalModelOctreeVisitor.h"
 #include "../../../model/octree/deoalModelRTOctree.h"
 #include "../../../model/octree/deoalModelRTBVH.h"
+#include "../../../utils/deoalSimdRay.h"
 
 class deoalAComponent;
 class deoalAModel;
@@ -55,6 +56,8 @@ private:
 	decVector pRayBoxMin;
 	decVector pRayBoxMax;
 	
+	deoalSimdRay pSimdRay;
+	
 	bool pBlocked;
 	
 	
@@ -127,7 +130,8 @@ public:
 	
 protected:
 	void pVisitNode( const deoalModelRTOctree &octree, const deoalModelRTOctree::sNode &node );
-	void pVisitNode( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sNode &node );
+	void pVisitNode( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sWideNode &node );
+	void pVisitFaces( const deoalModelRTBVH &bvh, int firstFace, int faceCount );
 	bool pRayHitsBox( const decVector &center, const decVector &halfExtends );
 };
 
@@ -91,6 +91,8 @@ void deoalMOVRayHitsClosest::SetRay( const decVector &origin, const decVector &d
 	const decVector margin( 0.0005f, 0.0005f, 0.0005f );
 	pRayBoxMin = pRayOrigin.Smallest( pRayTarget ) - margin;
 	pRayBoxMax = pRayOrigin.Largest( pRayTarget ) + margin;
+	
+	pSimdRay.SetRay( origin, direction );
 }
 
 void deoalMOVRayHitsClosest::SetFrontFacing( bool frontFacing ){
@@ -125,8 +127,8 @@ void deoalMOVRayHitsClosest::VisitOctree( const deoalModelRTOctree &octree ){
 }
 
 void deoalMOVRayHitsClosest::VisitBVH( const deoalModelRTBVH &bvh ){
-	if( bvh.GetNodeCount() > 0 ){
-		pVisitNode( bvh, bvh.GetNodes()[ 0 ] );
+	if( bvh.GetWideNodeCount() > 0 ){
+		pVisitNode( bvh, bvh.GetWideNodes()[ 0 ] );
 	}
 }
 
@@ -249,16 +251,70 @@ const deoalModelRTOctree::sNode &node ){
 	}
 }
 
-void deoalMOVRayHitsClosest::pVisitNode( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sNode &node ){
-	if( node.faceCount > 0 ){
+void deoalMOVRayHitsClosest::pVisitNode( const deoalModelRTBVH &bvh,
+const deoalModelRTBVH::sWideNode &node ){
+	float distances[ 4 ];
+	const int mask = pSimdRay.RayHitsBoxes( node.bounds, distances );
+	if( mask == 0 ){
+		return;
+	}
+	
+	// visit children hit by the ray in front to back order
+	int order[ 4 ];
+	int i, j, count = 0;
+	
+	for( i=0; i<4; i++ ){
+		if( ( mask & ( 1 << i ) ) == 0 ){
+			continue;
+		}
+		
+		for( j=count; j>0 && distances[ order[ j - 1 ] ] > distances[ i ]; j-- ){
+			order[ j ] = order[ j - 1 ];
+		}
+		order[ j ] = i;
+		count++;
+	}
+	
+	for( i=0; i<count; i++ ){
+		const int child = order[ i ];
+		if( distances[ child ] >= pLimitDistance ){
+			break;
+		}
+		
+		if( node.node[ child ] != -1 ){
+			pVisitNode( bvh, bvh.GetWideNodes()[ node.node[ child ] ] );
+			
+		}else if( node.faceCount[ child ] > 0 ){
+			pVisitFaces( bvh, node.firstFace[ child ], node.faceCount[ child ] );
+		}
+	}
+}
+
+void deoalMOVRayHitsClosest::pVisitFaces( const deoalModelRTBVH &bvh, int firstFace, int faceCount ){
 #ifdef MOVRAYHITSFACES_DO_TIMIING
-		timer.Reset();
+	timer.Reset();
 #endif
-		const deoalModelRTBVH::sFace * const faces = bvh.GetFaces() + node.firstFace;
-		int i;
+	const deoalModelRTBVH::sFace * const faces = bvh.GetFaces();
+	const float * const planeNormalX = bvh.GetFacePlaneNormalX();
+	const float * const planeNormalY = bvh.GetFacePlaneNormalY();
+	const float * const planeNormalZ = bvh.GetFacePlaneNormalZ();
+	const float * const planeDistance = bvh.GetFacePlaneDistance();
+	const int lastFace = firstFace + faceCount;
+	int i, j;
+	
+	for( i=firstFace; i<lastFace; i+=4 ){
+		const int mask = pSimdRay.RayHitsFacePlanes( planeNormalX + i, planeNormalY + i,
+			planeNormalZ + i, planeDistance + i, decMath::min( lastFace - i, 4 ), pLimitDistance );
+		if( mask == 0 ){
+			continue;
+		}
 		
-		for( i=0; i<node.faceCount; i++ ){
-			const deoalModelRTBVH::sFace &face = faces[ i ];
+		for( j=0; j<4; j++ ){
+			if( ( mask & ( 1 << j ) ) == 0 ){
+				continue;
+			}
+			
+			const deoalModelRTBVH::sFace &face = faces[ i + j ];
 			
 			const float dot = face.normal * pRayDirection;
 			if( pFrontFacing == ( dot > 0.0f ) || fabsf( dot ) < FLOAT_SAFE_EPSILON ){
@@ -289,44 +345,11 @@ void deoalMOVRayHitsClosest::pVisitNode( const deoalModelRTBVH &bvh, const deoal
 			
 			pSetResult( lambda, hitPoint, face.normal, face.indexFace );
 		}
+	}
 #ifdef MOVRAYHITSFACES_DO_TIMIING
-		timing += timer.GetElapsedTime();
-		timingCount += count;
+	timing += timer.GetElapsedTime();
+	timingCount += faceCount;
 #endif
-		
-	}else{
-		const deoalModelRTBVH::sNode &child1 = bvh.GetNodes()[ node.node1 ];
-		const deoalModelRTBVH::sNode &child2 = bvh.GetNodes()[ node.node2 ];
-		float closestDistance;
-		
-		if( ( child2.center - child1.center ) * GetRayDirection() > 0.0f ){
-			const deoalModelRTBVH::sNode &child1 = bvh.GetNodes()[ node.node1 ];
-			if( pRayHitsBox( child1.center, child1.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child1 );
-			}
-			
-			const deoalModelRTBVH::sNode &child2 = bvh.GetNodes()[ node.node2 ];
-			if( pRayHitsBox( child2.center, child2.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child2 );
-			}
-			
-		}else{
-			const deoalModelRTBVH::sNode &child2 = bvh.GetNodes()[ node.node2 ];
-			if( pRayHitsBox( child2.center, child2.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child2 );
-			}
-			
-			const deoalModelRTBVH::sNode &child1 = bvh.GetNodes()[ node.node1 ];
-			if( pRayHitsBox( child1.center, child1.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child1 );
-			}
-		}
-	}
-	
 }
 
 bool deoalMOVRayHitsClosest::pRayHitsBox( const decVector &center, const decVector &halfExtends,
@@ -27,6 +27,7 @@
 #include "../../../model/octree/deoalModelOctreeVisitor.h"
 #include "../../../model/octree/deoalModelRTOctree.h"
 #include "../../../model/octree/deoalModelRTBVH.h"
+#include "../../../utils/deoalSimdRay.h"
 
 class deoalAComponent;
 class deoalAModel;
@@ -66,6 +67,8 @@ private:
 	decVector pRayBoxMin;
 	decVector pRayBoxMax;
 	
+	deoalSimdRay pSimdRay;
+	
 	bool pHasResult;
 	float pResultDistance;
 	decVector pResultPoint;
@@ -171,7 +174,8 @@ public:
 protected:
 	void pVisitNode( const deoalModelOctree &node );
 	void pVisitNode( const deoalModelRTOctree &octree, const deoalModelRTOctree::sNode &node );
-	void pVisitNode( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sNode &node );
+	void pVisitNode( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sWideNode &node );
+	void pVisitFaces( const deoalModelRTBVH &bvh, int firstFace, int faceCount );
 	bool pRayHitsBox( const decVector &center, const decVector &halfExtends, float &closestDistance );
 	void pSetResult( float distance, const decVector &point, const decVector &normal, int face );
 };
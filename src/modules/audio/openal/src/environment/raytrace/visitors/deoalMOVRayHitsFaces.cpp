@@ -89,6 +89,8 @@ void deoalMOVRayHitsFaces::SetRay( const decVector &origin, const decVector &dir
 	const decVector margin( 0.0005f, 0.0005f, 0.0005f );
 	pRayBoxMin = pRayOrigin.Smallest( pRayTarget ) - margin;
 	pRayBoxMax = pRayOrigin.Largest( pRayTarget ) + margin;
+	
+	pSimdRay.SetRay( origin, direction );
 }
 
 
@@ -240,8 +242,8 @@ void deoalMOVRayHitsFaces::VisitOctree( const deoalModelRTOctree &octree ){
 }
 
 void deoalMOVRayHitsFaces::VisitBVH( const deoalModelRTBVH &bvh ){
-	if( bvh.GetNodeCount() > 0 ){
-		pVisitNode( bvh, bvh.GetNodes()[ 0 ] );
+	if( bvh.GetWideNodeCount() > 0 ){
+		pVisitNode( bvh, bvh.GetWideNodes()[ 0 ] );
 	}
 }
 
@@ -319,16 +321,52 @@ const deoalModelRTOctree::sNode &node ){
 	}
 }
 
-void deoalMOVRayHitsFaces::pVisitNode( const deoalModelRTBVH &bvh, const deoalModelRTBVH::sNode &node ){
-	if( node.faceCount > 0 ){
+void deoalMOVRayHitsFaces::pVisitNode( const deoalModelRTBVH &bvh,
+const deoalModelRTBVH::sWideNode &node ){
+	float distances[ 4 ];
+	const int mask = pSimdRay.RayHitsBoxes( node.bounds, distances );
+	int i;
+	
+	for( i=0; i<4; i++ ){
+		if( ( mask & ( 1 << i ) ) == 0 ){
+			continue;
+		}
+		
+		if( node.node[ i ] != -1 ){
+			pVisitNode( bvh, bvh.GetWideNodes()[ node.node[ i ] ] );
+			
+		}else if( node.faceCount[ i ] > 0 ){
+			pVisitFaces( bvh, node.firstFace[ i ], node.faceCount[ i ] );
+		}
+	}
+}
+
+void deoalMOVRayHitsFaces::pVisitFaces( const deoalModelRTBVH &bvh, int firstFace, int faceCount ){
 #ifdef MOVRAYHITSFACES_DO_TIMIING
-		timer.Reset();
+	timer.Reset();
 #endif
-		const deoalModelRTBVH::sFace * const faces = bvh.GetFaces() + node.firstFace;
-		int i;
+	const deoalModelRTBVH::sFace * const faces = bvh.GetFaces();
+	const float * const planeNormalX = bvh.GetFacePlaneNormalX();
+	const float * const planeNormalY = bvh.GetFacePlaneNormalY();
+	const float * const planeNormalZ = bvh.GetFacePlaneNormalZ();
+	const float * const planeDistance = bvh.GetFacePlaneDistance();
+	const int lastFace = firstFace + faceCount;
+	int i, j;
+	
+	for( i=firstFace; i<lastFace; i+=4 ){
+		// pre-test face planes in groups of 4 then do the exact test on the candidates
+		const int mask = pSimdRay.RayHitsFacePlanes( planeNormalX + i, planeNormalY + i,
+			planeNormalZ + i, planeDistance + i, decMath::min( lastFace - i, 4 ), 1.0f );
+		if( mask == 0 ){
+			continue;
+		}
 		
-		for( i=0; i<node.faceCount; i++ ){
-			const deoalModelRTBVH::sFace &face = faces[ i ];
+		for( j=0; j<4; j++ ){
+			if( ( mask & ( 1 << j ) ) == 0 ){
+				continue;
+			}
+			
+			const deoalModelRTBVH::sFace &face = faces[ i + j ];
 			
 			const float dot = face.normal * pRayDirection;
 			if( fabsf( dot ) < FLOAT_SAFE_EPSILON ){
@@ -372,22 +410,11 @@ void deoalMOVRayHitsFaces::pVisitNode( const deoalModelRTBVH &bvh, const deoalMo
 					&pComponent, face.indexFace, dot <= 0.0f );
 			}
 		}
+	}
 #ifdef MOVRAYHITSFACES_DO_TIMIING
-		timing += timer.GetElapsedTime();
-		timingCount += count;
+	timing += timer.GetElapsedTime();
+	timingCount += faceCount;
 #endif
-		
-	}else{
-		const deoalModelRTBVH::sNode &child1 = bvh.GetNodes()[ node.node1 ];
-		if( pRayHitsBox( child1.center, child1.halfSize ) ){
-			pVisitNode( bvh, child1 );
-		}
-		
-		const deoalModelRTBVH::sNode &child2 = bvh.GetNodes()[ node.node2 ];
-		if( pRayHitsBox( child2.center, child2.halfSize ) ){
-			pVisitNode( bvh, child2 );
-		}
-	}
 }
 
 bool deoalMOVRayHitsFaces::pRayHitsBox( const decVector &center, const decVector &halfExtends ){
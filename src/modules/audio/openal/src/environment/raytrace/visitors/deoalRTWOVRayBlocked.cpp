@@ -87,8 +87,8 @@ void deoalRTWOVRayBlocked::VisitBVH( const deoalRTWorldBVH &bvh ){
 	timerAll.Reset();
 	#endif
 	
-	if( bvh.GetVisitNodeCount() > 0 ){
-		VisitNode( bvh, bvh.GetVisitNodes()[ 0 ] );
+	if( bvh.GetWideVisitNodeCount() > 0 ){
+		VisitNode( bvh, bvh.GetWideVisitNodes()[ 0 ] );
 	}
 	
 	#ifdef RTWOVRAYBLOCKED_DO_TIMING
@@ -97,39 +97,36 @@ void deoalRTWOVRayBlocked::VisitBVH( const deoalRTWorldBVH &bvh ){
 }
 
 void deoalRTWOVRayBlocked::VisitNode( const deoalRTWorldBVH &bvh,
-const deoalRTWorldBVH::sVisitNode &node ){
-	// visit components
-	if( node.componentCount > 0 ){
-		const deoalRTWorldBVH::sVisitComponent * const components =
-			bvh.GetVisitComponents() + node.firstComponent;
-		int i;
-		
-		for( i=0; i<node.componentCount; i++ ){
-			const deoalRTWorldBVH::sVisitComponent &component = components[ i ];
-			if( /*pRayHitsSphere( component.sphereCenter, component.sphereRadiusSquared )
-			&& */pRayHitsBox( component.center, component.halfSize ) ){
-				VisitComponent( component );
-				if( pBlocked ){
-					return;
-				}
-			}
+const deoalRTWorldBVH::sWideVisitNode &node ){
+	float distances[ 4 ];
+	const int mask = GetSimdRay().RayHitsBoxes( node.bounds, distances );
+	int i, j;
+	
+	for( i=0; i<4; i++ ){
+		if( ( mask & ( 1 << i ) ) == 0 ){
+			continue;
 		}
 		
-	// visit child nodes if hit by ray
-	}else{
-		const deoalRTWorldBVH::sVisitNode &child1 = bvh.GetVisitNodes()[ node.node1 ];
-		if( pRayHitsBox( child1.center, child1.halfSize ) ){
-			VisitNode( bvh, child1 );
+		// visit child nodes if hit by ray
+		if( node.node[ i ] != -1 ){
+			VisitNode( bvh, bvh.GetWideVisitNodes()[ node.node[ i ] ] );
 			if( pBlocked ){
 				return;
 			}
+			continue;
 		}
 		
-		const deoalRTWorldBVH::sVisitNode &child2 = bvh.GetVisitNodes()[ node.node2 ];
-		if( pRayHitsBox( child2.center, child2.halfSize ) ){
-			VisitNode( bvh, child2 );
-			if( pBlocked ){
-				return;
+		// visit components
+		const deoalRTWorldBVH::sVisitComponent * const components =
+			bvh.GetVisitComponents() + node.firstComponent[ i ];
+		
+		for( j=0; j<node.componentCount[ i ]; j++ ){
+			const deoalRTWorldBVH::sVisitComponent &component = components[ j ];
+			if( pRayHitsBox( component.center, component.halfSize ) ){
+				VisitComponent( component );
+				if( pBlocked ){
+					return;
+				}
 			}
 		}
 	}
@@ -89,7 +89,7 @@ public:
 	void VisitBVH( const deoalRTWorldBVH &bvh );
 	
 	/** \brief Visit optimized ray-trace bvh node. */
-	void VisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sVisitNode &node );
+	void VisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sWideVisitNode &node );
 	
 	/** \brief Visit component. */
 	void VisitComponent( const deoalRTWorldBVH::sVisitComponent &rtcomponent );
@@ -99,8 +99,8 @@ void deoalRTWOVRayHitsClosest::VisitBVH( const deoalRTWorldBVH & bvh ){
 	
 	pHasResult = false;
 	
-	if( bvh.GetVisitNodeCount() > 0 ){
-		pVisitNode( bvh, bvh.GetVisitNodes()[ 0 ] );
+	if( bvh.GetWideVisitNodeCount() > 0 ){
+		pVisitNode( bvh, bvh.GetWideVisitNodes()[ 0 ] );
 	}
 	
 	#ifdef RTWOVRAYHITSCLOSEST_DO_TIMING
@@ -179,75 +179,53 @@ void deoalRTWOVRayHitsClosest::VisitComponent( const deoalRTWorldBVH::sVisitComp
 // Protected Functions
 ////////////////////////
 
-struct sSortNode{
-	const deoalRTWorldBVH::sVisitNode *node;
-	float distance;
-};
-
-void deoalRTWOVRayHitsClosest::pVisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sVisitNode &node ){
-	// visit components
-	if( node.componentCount > 0 ){
-		const deoalRTWorldBVH::sVisitComponent * const components =
-			bvh.GetVisitComponents() + node.firstComponent;
-		float closestDistance;
-		int i;
-		
-		for( i=0; i<node.componentCount; i++ ){
-			const deoalRTWorldBVH::sVisitComponent &component = components[ i ];
-			if( pRayHitsBox( component.center, component.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				VisitComponent( component );
-			}
+void deoalRTWOVRayHitsClosest::pVisitNode( const deoalRTWorldBVH &bvh,
+const deoalRTWorldBVH::sWideVisitNode &node ){
+	float distances[ 4 ];
+	const int mask = GetSimdRay().RayHitsBoxes( node.bounds, distances );
+	if( mask == 0 ){
+		return;
+	}
+	
+	// visit children hit by the ray in front to back order
+	int order[ 4 ];
+	int i, j, count = 0;
+	
+	for( i=0; i<4; i++ ){
+		if( ( mask & ( 1 << i ) ) == 0 ){
+			continue;
 		}
 		
-	// visit child nodes if hit by ray
-	}else{
-		#if 1
-		const deoalRTWorldBVH::sVisitNode &child1 = bvh.GetVisitNodes()[ node.node1 ];
-		const deoalRTWorldBVH::sVisitNode &child2 = bvh.GetVisitNodes()[ node.node2 ];
-		float closestDistance;
+		for( j=count; j>0 && distances[ order[ j - 1 ] ] > distances[ i ]; j-- ){
+			order[ j ] = order[ j - 1 ];
+		}
+		order[ j ] = i;
+		count++;
+	}
+	
+	for( i=0; i<count; i++ ){
+		const int child = order[ i ];
+		if( distances[ child ] >= pLimitDistance ){
+			break;
+		}
 		
-		if( ( child2.center - child1.center ) * GetRayDirection() > 0.0f ){
-			const deoalRTWorldBVH::sVisitNode &child1 = bvh.GetVisitNodes()[ node.node1 ];
-			if( pRayHitsBox( child1.center, child1.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child1 );
-			}
-			
-			const deoalRTWorldBVH::sVisitNode &child2 = bvh.GetVisitNodes()[ node.node2 ];
-			if( pRayHitsBox( child2.center, child2.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child2 );
-			}
-			
-		}else{
-			const deoalRTWorldBVH::sVisitNode &child2 = bvh.GetVisitNodes()[ node.node2 ];
-			if( pRayHitsBox( child2.center, child2.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child2 );
-			}
-			
-			const deoalRTWorldBVH::sVisitNode &child1 = bvh.GetVisitNodes()[ node.node1 ];
-			if( pRayHitsBox( child1.center, child1.halfSize, closestDistance )
-			&& closestDistance < pLimitDistance ){
-				pVisitNode( bvh, child1 );
-			}
+		// visit child nodes if hit by ray
+		if( node.node[ child ] != -1 ){
+			pVisitNode( bvh, bvh.GetWideVisitNodes()[ node.node[ child ] ] );
+			continue;
 		}
 		
-		#else
+		// visit components
+		const deoalRTWorldBVH::sVisitComponent * const components =
+			bvh.GetVisitComponents() + node.firstComponent[ child ];
 		float closestDistance;
 		
-		const deoalRTWorldBVH::sVisitNode &child1 = bvh.GetVisitNodes()[ node.node1 ];
-		if( pRayHitsBox( child1.center, child1.halfSize, closestDistance )
-		&& closestDistance < pLimitDistance ){
-			pVisitNode( bvh, child1 );
-		}
-		
-		const deoalRTWorldBVH::sVisitNode &child2 = bvh.GetVisitNodes()[ node.node2 ];
-		if( pRayHitsBox( child2.center, child2.halfSize, closestDistance )
-		&& closestDistance < pLimitDistance ){
-			pVisitNode( bvh, child2 );
+		for( j=0; j<node.componentCount[ child ]; j++ ){
+			const deoalRTWorldBVH::sVisitComponent &component = components[ j ];
+			if( pRayHitsBox( component.center, component.halfSize, closestDistance )
+			&& closestDistance < pLimitDistance ){
+				VisitComponent( component );
+			}
 		}
-		#endif
 	}
 }
@@ -116,7 +116,7 @@ public:
 	
 	
 protected:
-	void pVisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sVisitNode &node );
+	void pVisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sWideVisitNode &node );
 };
 
 #endif
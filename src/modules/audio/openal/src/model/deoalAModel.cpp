@@ -31,8 +31,17 @@
 #include "../audiothread/deoalAudioThread.h"
 #include "../audiothread/deoalATLogger.h"
 #include "../utils/cache/deoalRayCache.h"
+#include "../deAudioOpenAL.h"
+#include "../deoalCaches.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/common/file/decBaseFileReaderReference.h>
+#include <dragengine/common/file/decBaseFileWriter.h>
+#include <dragengine/common/file/decBaseFileWriterReference.h>
+#include <dragengine/common/math/decSkinning.h>
+#include <dragengine/filesystem/deCacheHelper.h>
+#include <dragengine/filesystem/deVirtualFileSystem.h>
 #include <dragengine/resources/model/deModel.h>
 #include <dragengine/resources/model/deModelLOD.h>
 #include <dragengine/resources/model/deModelBone.h>
@@ -42,6 +51,30 @@
 
 
 
+// Definitions
+////////////////
+
+// Cache version in the range from 0 to 255. Increment each time the cache
+// format changed. If reaching 256 wrap around to 0. Important is only the
+// number changes to force discarding old caches
+#define CACHE_VERSION 0
+
+#define ENABLE_CACHE_LOGGING false
+
+
+
+// Cache file header
+//////////////////////
+
+struct sCacheHeader{
+	uint64_t filetime;
+	uint8_t version;
+	uint8_t padding[ 3 ];
+	uint32_t faceCount;
+};
+
+
+
 // Class deoalAModel
 /////////////////////
 
@@ -57,6 +90,7 @@ pWeights( NULL ),
 pWeightCount( 0 ),
 pWeightSets( NULL ),
 pWeightSetCount( 0 ),
+pSkinning( NULL ),
 // pRTSphereRadiusSquared( 0.0f ),
 pOctree( NULL ),
 pOctreeOverlap( NULL ),
@@ -114,6 +148,32 @@ void deoalAModel::PrepareOctree(){
 	pBuildOctree();
 }
 
+void deoalAModel::PrepareSkinning(){
+	if( pSkinning ){
+		return;
+	}
+	
+	int i;
+	
+	pSkinning = new decSkinning;
+	
+	try{
+		pSkinning->SetVertexCount( pFaceCount * 3 );
+		for( i=0; i<pFaceCount; i++ ){
+			const deoalModelFace &face = pFaces[ i ];
+			pSkinning->SetVertexAt( i * 3, face.GetVertex1(), face.GetWeightSet1() );
+			pSkinning->SetVertexAt( i * 3 + 1, face.GetVertex2(), face.GetWeightSet2() );
+			pSkinning->SetVertexAt( i * 3 + 2, face.GetVertex3(), face.GetWeightSet3() );
+		}
+		pSkinning->Prepare();
+		
+	}catch( const deException & ){
+		delete pSkinning;
+		pSkinning = NULL;
+		throw;
+	}
+}
+
 
 
 // Private Functions
@@ -135,6 +195,9 @@ void deoalAModel::pCleanUp(){
 	if( pOctreeOverlap ){
 		delete pOctreeOverlap;
 	}
+	if( pSkinning ){
+		delete pSkinning;
+	}
 	if( pWeightSets ){
 		delete [] pWeightSets;
 	}
@@ -281,8 +344,11 @@ void deoalAModel::pBuildOctree(){
 	// ray-tracing optimized octree
 // 	pRTOctree = new deoalModelRTOctree( *pOctree );
 	pRTBVH = new deoalModelRTBVH;
-	pRTBVH->Build( pFaces, pFaceCount );
-	pRTBVH->DropBuildData();
+	if( ! pLoadRTBVHFromCache() ){
+		pRTBVH->Build( pFaces, pFaceCount );
+		pRTBVH->DropBuildData();
+		pWriteRTBVHToCache();
+	}
 	
 	// debug
 // 	pDebugLogOctreePerfMetrics( *pOctree );
@@ -290,6 +356,141 @@ void deoalAModel::pBuildOctree(){
 	// allocated. then the original octree is visited to fill in data.
 }
 
+bool deoalAModel::pLoadRTBVHFromCache(){
+	if( pFilename.IsEmpty() || pFaceCount == 0 ){
+		return false;
+	}
+	
+	const bool enableCacheLogging = ENABLE_CACHE_LOGGING;
+	
+	deVirtualFileSystem &vfs = pAudioThread.GetOal().GetVFS();
+	deoalCaches &caches = pAudioThread.GetCaches();
+	deoalATLogger &logger = pAudioThread.GetLogger();
+	deCacheHelper &cacheModel = caches.GetModel();
+	decBaseFileReaderReference reader;
+	
+	const decPath path( decPath::CreatePathUnix( pFilename ) );
+	if( ! vfs.CanReadFile( path ) ){
+		// without a source file no cache since it is no more unique
+		return false;
+	}
+	
+	caches.Lock();
+	
+	try{
+		reader.TakeOver( cacheModel.Read( pFilename ) );
+		if( ! reader ){
+			// cache file absent
+			caches.Unlock();
+			return false;
+		}
+		
+		// read header and compare parameters
+		sCacheHeader header;
+		reader->Read( &header, sizeof( header ) );
+		
+		// check file modification times to reject the cached file if the source model
+		// changed. check also the cache version in case we upgraded
+		if( header.filetime != ( uint64_t )vfs.GetFileModificationTime( path )
+		|| header.version != CACHE_VERSION
+		|| ( int )header.faceCount != pFaceCount ){
+			// cache file outdated
+			reader = NULL;
+			cacheModel.Delete( pFilename );
+			caches.Unlock();
+			
+			if( enableCacheLogging ){
+				logger.LogInfoFormat( "Model '%s': Cache outdated. Cache discarded",
+					pFilename.GetString() );
+			}
+			return false;
+		}
+		
+		// read bvh. fails if the bvh build parameters changed
+		if( ! pRTBVH->ReadFromCache( reader ) || pRTBVH->GetFaceCount() != pFaceCount ){
+			reader = NULL;
+			cacheModel.Delete( pFilename );
+			caches.Unlock();
+			
+			if( enableCacheLogging ){
+				logger.LogInfoFormat( "Model '%s': BVH build parameters changed. Cache discarded",
+					pFilename.GetString() );
+			}
+			return false;
+		}
+		
+		// done
+		reader = NULL;
+		caches.Unlock();
+		
+		if( enableCacheLogging ){
+			logger.LogInfoFormat( "Model '%s': Loaded from cache", pFilename.GetString() );
+		}
+		return true;
+		
+	}catch( const deException & ){
+		// damaged cache file
+		reader = NULL;
+		cacheModel.Delete( pFilename );
+		caches.Unlock();
+		
+		if( enableCacheLogging ){
+			logger.LogInfoFormat( "Model '%s': Cache file damaged. Cache discarded",
+				pFilename.GetString() );
+		}
+		return false;
+	}
+}
+
+void deoalAModel::pWriteRTBVHToCache(){
+	if( pFilename.IsEmpty() || pFaceCount == 0 ){
+		return;
+	}
+	
+	const bool enableCacheLogging = ENABLE_CACHE_LOGGING;
+	
+	deVirtualFileSystem &vfs = pAudioThread.GetOal().GetVFS();
+	deoalCaches &caches = pAudioThread.GetCaches();
+	deoalATLogger &logger = pAudioThread.GetLogger();
+	deCacheHelper &cacheModel = caches.GetModel();
+	decBaseFileWriterReference writer;
+	
+	const decPath path( decPath::CreatePathUnix( pFilename ) );
+	if( ! vfs.CanReadFile( path ) ){
+		return; // without a source file no cache since it is no more unique
+	}
+	
+	sCacheHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.filetime = ( uint64_t )vfs.GetFileModificationTime( path );
+	header.version = ( uint8_t )CACHE_VERSION;
+	header.faceCount = ( uint32_t )pFaceCount;
+	
+	caches.Lock();
+	
+	try{
+		writer.TakeOver( cacheModel.Write( pFilename ) );
+		writer->Write( &header, sizeof( header ) );
+		pRTBVH->WriteToCache( writer );
+		writer = NULL;
+		
+		caches.Unlock();
+		if( enableCacheLogging ){
+			logger.LogInfoFormat( "Model '%s': Cache written", pFilename.GetString() );
+		}
+		
+	}catch( const deException &e ){
+		writer = NULL;
+		cacheModel.Delete( pFilename );
+		caches.Unlock();
+		
+		if( enableCacheLogging ){
+			logger.LogException( e );
+			logger.LogErrorFormat( "Model '%s': Failed writing cache file", pFilename.GetString() );
+		}
+	}
+}
+
 /*
 void deoalAModel::pInitRTSphere( const deModelLOD &lod ){
 	const int vertexCount = lod.GetVertexCount();
@@ -29,6 +29,7 @@
 class deoalModelFace;
 class deoalAudioThread;
 class deoalRayCache;
+class decSkinning;
 
 class deoalModelOctree;
 class deoalModelRTOctree;
@@ -71,6 +72,7 @@ private:
 	int pWeightCount;
 	sWeightSet *pWeightSets;
 	int pWeightSetCount;
+	decSkinning *pSkinning;
 	
 	decVector pMinExtend;
 	decVector pMaxExtend;
@@ -139,6 +141,16 @@ public:
 	/** \brief Weight set count. */
 	inline int GetWeightSetCount() const{ return pWeightSetCount; }
 	
+	/**
+	 * \brief Skinning kernel or NULL if not prepared.
+	 * 
+	 * Contains three vertices per face in face order.
+	 */
+	inline const decSkinning *GetSkinning() const{ return pSkinning; }
+	
+	/** \brief Prepare skinning kernel if not present. */
+	void PrepareSkinning();
+	
 	
 	
 	/** \brief Minimum extend. */
@@ -188,6 +200,8 @@ private:
 	void pBuildWeights( const deModelLOD &lod );
 	void pBuildFaces( const deModelLOD &lod );
 	void pBuildOctree();
+	bool pLoadRTBVHFromCache();
+	void pWriteRTBVHToCache();
 // 	void pInitRTSphere( const deModelLOD &lod );
 	
 	void pDebugLogOctreePerfMetrics( const deoalModelOctree &octree );
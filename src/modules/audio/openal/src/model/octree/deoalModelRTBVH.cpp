@@ -28,6 +28,64 @@
 #include "../deoalModelFace.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/common/file/decBaseFileWriter.h>
+
+
+
+// Definitions
+////////////////
+
+// number of bins used to find the best split using the surface area heuristic
+#define SAH_BIN_COUNT 12
+
+// relative cost of traversing a node and testing a face
+#define SAH_COST_TRAVERSAL 1.0f
+#define SAH_COST_FACE 1.0f
+
+// maximum number of faces in a leaf. nodes with more faces are always split if possible
+#define MAX_LEAF_FACES 4
+
+// minimum size of face center extends along an axis to split along this axis
+#define SPLIT_THRESHOLD 1e-4f
+
+// build parameters stored in cache files. cached visit data is only used if the data has
+// been build using the same parameters and structure layouts
+struct sCacheBuildParameters{
+	uint8_t binCount;
+	uint8_t maxLeafFaces;
+	uint8_t sizeofFace;
+	uint8_t sizeofNode;
+	uint16_t sizeofWideNode;
+	uint16_t padding;
+	float costTraversal;
+	float costFace;
+};
+
+static void fInitCacheBuildParameters( sCacheBuildParameters &parameters ){
+	memset( &parameters, 0, sizeof( parameters ) );
+	parameters.binCount = ( uint8_t )SAH_BIN_COUNT;
+	parameters.maxLeafFaces = ( uint8_t )MAX_LEAF_FACES;
+	parameters.sizeofFace = ( uint8_t )sizeof( deoalModelRTBVH::sFace );
+	parameters.sizeofNode = ( uint8_t )sizeof( deoalModelRTBVH::sNode );
+	parameters.sizeofWideNode = ( uint16_t )sizeof( deoalModelRTBVH::sWideNode );
+	parameters.costTraversal = SAH_COST_TRAVERSAL;
+	parameters.costFace = SAH_COST_FACE;
+}
+
+struct sSAHBin{
+	decVector minExtend;
+	decVector maxExtend;
+	int count;
+};
+
+static inline float fAxisValue( const decVector &vector, int axis ){
+	return axis == 0 ? vector.x : ( axis == 1 ? vector.y : vector.z );
+}
+
+static inline float fHalfArea( const decVector &size ){
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
 
 
 
@@ -46,6 +104,14 @@ pNodes( NULL ),
 pNodeCount( 0 ),
 pNodeSize( 0 ),
 
+pWideNodes( NULL ),
+pWideNodeCount( 0 ),
+pWideNodeSize( 0 ),
+
+pFacePlanes( NULL ),
+pFacePlaneStride( 0 ),
+pFacePlaneSize( 0 ),
+
 pBuildNodes( NULL ),
 pBuildNodeCount( 0 ),
 pBuildNodeSize( 0 ),
@@ -70,6 +136,8 @@ deoalModelRTBVH::~deoalModelRTBVH(){
 void deoalModelRTBVH::Build( const deoalModelFace *faces, int faceCount ){
 	pNodeCount = 0;
 	pFaceCount = 0;
+	pWideNodeCount = 0;
+	pFacePlaneStride = 0;
 	pBuildFaceCount = 0;
 	pBuildNodeCount = 0;
 	if( faceCount == 0 ){
@@ -136,6 +204,21 @@ void deoalModelRTBVH::Build( const deoalModelFace *faces, int faceCount ){
 	pIndexNode = 0;
 	pIndexFace = 0;
 	pBuildVisitNode( pBuildNodes[ 0 ] );
+	
+	// build wide nodes and face planes for traversal. the wide node count is at most the
+	// binary node count
+	if( pNodeCount > pWideNodeSize ){
+		if( pWideNodes ){
+			delete [] pWideNodes;
+			pWideNodes = NULL;
+			pWideNodeSize = 0;
+		}
+		pWideNodes = new sWideNode[ pNodeCount ];
+		pWideNodeSize = pNodeCount;
+	}
+	pBuildWideNode( 0 );
+	
+	pBuildFacePlanes();
 }
 
 void deoalModelRTBVH::DropBuildData(){
@@ -153,12 +236,133 @@ void deoalModelRTBVH::DropBuildData(){
 	}
 }
 
+void deoalModelRTBVH::WriteToCache( decBaseFileWriter &writer ) const{
+	sCacheBuildParameters parameters;
+	fInitCacheBuildParameters( parameters );
+	writer.Write( &parameters, sizeof( parameters ) );
+	
+	writer.WriteInt( pFaceCount );
+	writer.WriteInt( pNodeCount );
+	writer.WriteInt( pWideNodeCount );
+	
+	// visit data is stored as is to read it back using a single read per array. face
+	// planes are not stored since they are quickly recreated from the faces
+	if( pFaceCount > 0 ){
+		writer.Write( pFaces, sizeof( sFace ) * pFaceCount );
+	}
+	if( pNodeCount > 0 ){
+		writer.Write( pNodes, sizeof( sNode ) * pNodeCount );
+	}
+	if( pWideNodeCount > 0 ){
+		writer.Write( pWideNodes, sizeof( sWideNode ) * pWideNodeCount );
+	}
+}
+
+bool deoalModelRTBVH::ReadFromCache( decBaseFileReader &reader ){
+	sCacheBuildParameters expected, parameters;
+	fInitCacheBuildParameters( expected );
+	reader.Read( &parameters, sizeof( parameters ) );
+	if( memcmp( &parameters, &expected, sizeof( parameters ) ) != 0 ){
+		return false;
+	}
+	
+	pFaceCount = 0;
+	pNodeCount = 0;
+	pWideNodeCount = 0;
+	pFacePlaneStride = 0;
+	
+	const int faceCount = reader.ReadInt();
+	const int nodeCount = reader.ReadInt();
+	const int wideNodeCount = reader.ReadInt();
+	if( faceCount < 0 || nodeCount < 0 || nodeCount > faceCount * 2
+	|| wideNodeCount < 0 || wideNodeCount > nodeCount
+	|| ( faceCount > 0 && ( nodeCount == 0 || wideNodeCount == 0 ) ) ){
+		DETHROW( deeInvalidFileFormat );
+	}
+	
+	if( faceCount > pFaceSize ){
+		if( pFaces ){
+			delete [] pFaces;
+			pFaces = NULL;
+			pFaceSize = 0;
+		}
+		pFaces = new sFace[ faceCount ];
+		pFaceSize = faceCount;
+	}
+	if( nodeCount > pNodeSize ){
+		if( pNodes ){
+			delete [] pNodes;
+			pNodes = NULL;
+			pNodeSize = 0;
+		}
+		pNodes = new sNode[ nodeCount ];
+		pNodeSize = nodeCount;
+	}
+	if( wideNodeCount > pWideNodeSize ){
+		if( pWideNodes ){
+			delete [] pWideNodes;
+			pWideNodes = NULL;
+			pWideNodeSize = 0;
+		}
+		pWideNodes = new sWideNode[ wideNodeCount ];
+		pWideNodeSize = wideNodeCount;
+	}
+	
+	if( faceCount > 0 ){
+		reader.Read( pFaces, sizeof( sFace ) * faceCount );
+		reader.Read( pNodes, sizeof( sNode ) * nodeCount );
+		reader.Read( pWideNodes, sizeof( sWideNode ) * wideNodeCount );
+	}
+	
+	// verify indices. traversal trusts them
+	int i, j;
+	for( i=0; i<nodeCount; i++ ){
+		const sNode &node = pNodes[ i ];
+		if( node.faceCount > 0 ){
+			if( node.firstFace < 0 || node.firstFace + node.faceCount > faceCount ){
+				DETHROW( deeInvalidFileFormat );
+			}
+			
+		}else if( node.node1 <= i || node.node1 >= nodeCount
+		|| node.node2 <= i || node.node2 >= nodeCount ){
+			DETHROW( deeInvalidFileFormat );
+		}
+	}
+	for( i=0; i<wideNodeCount; i++ ){
+		const sWideNode &node = pWideNodes[ i ];
+		for( j=0; j<4; j++ ){
+			if( node.node[ j ] != -1 ){
+				if( node.node[ j ] <= i || node.node[ j ] >= wideNodeCount ){
+					DETHROW( deeInvalidFileFormat );
+				}
+				
+			}else if( node.faceCount[ j ] < 0 || node.firstFace[ j ] < 0
+			|| node.firstFace[ j ] + node.faceCount[ j ] > faceCount ){
+				DETHROW( deeInvalidFileFormat );
+			}
+		}
+	}
+	
+	pFaceCount = faceCount;
+	pNodeCount = nodeCount;
+	pWideNodeCount = wideNodeCount;
+	
+	pBuildFacePlanes();
+	return true;
+}
+
 
 
 // Private Functions
 //////////////////////
 
 void deoalModelRTBVH::pCleanUp(){
+	if( pFacePlanes ){
+		delete [] pFacePlanes;
+	}
+	if( pWideNodes ){
+		delete [] pWideNodes;
+	}
 	if( pNodes ){
 		delete [] pNodes;
 	}
@@ -220,7 +424,8 @@ void deoalModelRTBVH::pUpdateNodeExtends( sBuildNode &node ) const{
 }
 
 void deoalModelRTBVH::pSplitNode( int nodeIndex ){
-	if( pBuildNodes[ nodeIndex ].faceCount < 3 ){
+	const int faceCount = pBuildNodes[ nodeIndex ].faceCount;
+	if( faceCount < 3 ){
 		return;
 	}
 	
@@ -238,41 +443,115 @@ void deoalModelRTBVH::pSplitNode( int nodeIndex ){
 		faceIndex = face.next;
 	}
 	
-	// find primary axis
+	// sort faces into bins along all axes large enough to be split
 	const decVector centerSize( centerMax - centerMin );
-	const float splitThreshold = 0.1f; //0.001f; // 0.01f
-	float splitPosition;
-	int primaryAxis;
-	
-	if( centerSize.x >= centerSize.y ){
-		if( centerSize.x >= centerSize.z ){
-			if( centerSize.x < splitThreshold ){
-				return;
+	sSAHBin bins[ 3 ][ SAH_BIN_COUNT ];
+	float binScale[ 3 ];
+	int axis, bin;
+	
+	for( axis=0; axis<3; axis++ ){
+		const float size = fAxisValue( centerSize, axis );
+		binScale[ axis ] = size >= SPLIT_THRESHOLD ? ( float )SAH_BIN_COUNT / size : 0.0f;
+		
+		for( bin=0; bin<SAH_BIN_COUNT; bin++ ){
+			bins[ axis ][ bin ].count = 0;
+		}
+	}
+	
+	faceIndex = pBuildNodes[ nodeIndex ].firstFace;
+	while( faceIndex != -1 ){
+		const sBuildFace &face = pBuildFaces[ faceIndex ];
+		
+		for( axis=0; axis<3; axis++ ){
+			if( binScale[ axis ] == 0.0f ){
+				continue;
 			}
-			splitPosition = ( centerMin.x + centerMax.x ) * 0.5f;
-			primaryAxis = 0;
 			
-		}else{
-			if( centerSize.z < splitThreshold ){
-				return;
+			bin = decMath::min( ( int )( ( fAxisValue( face.center, axis )
+				- fAxisValue( centerMin, axis ) ) * binScale[ axis ] ), SAH_BIN_COUNT - 1 );
+			sSAHBin &sahBin = bins[ axis ][ bin ];
+			
+			if( sahBin.count == 0 ){
+				sahBin.minExtend = face.minExtend;
+				sahBin.maxExtend = face.maxExtend;
+				
+			}else{
+				sahBin.minExtend.SetSmallest( face.minExtend );
+				sahBin.maxExtend.SetLargest( face.maxExtend );
 			}
-			splitPosition = ( centerMin.z + centerMax.z ) * 0.5f;
-			primaryAxis = 2;
+			sahBin.count++;
 		}
 		
-	}else if( centerSize.y >= centerSize.z ){
-		if( centerSize.y < splitThreshold ){
-			return;
+		faceIndex = face.next;
+	}
+	
+	// find split with the lowest cost. split is located after the best bin
+	const float nodeArea = decMath::max( fHalfArea( pBuildNodes[ nodeIndex ].halfSize ), 1e-12f );
+	float bestCost = 0.0f;
+	int bestAxis = -1;
+	int bestBin = -1;
+	
+	for( axis=0; axis<3; axis++ ){
+		if( binScale[ axis ] == 0.0f ){
+			continue;
 		}
-		splitPosition = ( centerMin.y + centerMax.y ) * 0.5f;
-		primaryAxis = 1;
 		
-	}else{
-		if( centerSize.z < splitThreshold ){
-			return;
+		const sSAHBin * const axisBins = bins[ axis ];
+		float rightCost[ SAH_BIN_COUNT ];
+		decVector minExtend, maxExtend;
+		int count = 0;
+		
+		for( bin=SAH_BIN_COUNT-1; bin>0; bin-- ){
+			const sSAHBin &sahBin = axisBins[ bin ];
+			if( sahBin.count > 0 ){
+				if( count == 0 ){
+					minExtend = sahBin.minExtend;
+					maxExtend = sahBin.maxExtend;
+					
+				}else{
+					minExtend.SetSmallest( sahBin.minExtend );
+					maxExtend.SetLargest( sahBin.maxExtend );
+				}
+				count += sahBin.count;
+			}
+			rightCost[ bin - 1 ] = count > 0 ? fHalfArea( maxExtend - minExtend ) * count : -1.0f;
+		}
+		
+		count = 0;
+		for( bin=0; bin<SAH_BIN_COUNT-1; bin++ ){
+			const sSAHBin &sahBin = axisBins[ bin ];
+			if( sahBin.count > 0 ){
+				if( count == 0 ){
+					minExtend = sahBin.minExtend;
+					maxExtend = sahBin.maxExtend;
+					
+				}else{
+					minExtend.SetSmallest( sahBin.minExtend );
+					maxExtend.SetLargest( sahBin.maxExtend );
+				}
+				count += sahBin.count;
+			}
+			
+			if( count == 0 || rightCost[ bin ] < 0.0f ){
+				continue; // split has to leave faces on both sides
+			}
+			
+			const float cost = SAH_COST_TRAVERSAL + SAH_COST_FACE
+				* ( fHalfArea( maxExtend - minExtend ) * count + rightCost[ bin ] ) / nodeArea;
+			if( bestAxis == -1 || cost < bestCost ){
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = bin;
+			}
 		}
-		splitPosition = ( centerMin.z + centerMax.z ) * 0.5f;
-		primaryAxis = 2;
+	}
+	
+	// keep node as leaf if no split is possible or if splitting is more expensive
+	if( bestAxis == -1 ){
+		return;
+	}
+	if( faceCount <= MAX_LEAF_FACES && bestCost >= SAH_COST_FACE * faceCount ){
+		return;
 	}
 	
 	// create child nodes
@@ -282,60 +561,27 @@ void deoalModelRTBVH::pSplitNode( int nodeIndex ){
 	sBuildNode &node = pBuildNodes[ nodeIndex ];
 	sBuildNode &child1 = pBuildNodes[ childIndex1 ];
 	sBuildNode &child2 = pBuildNodes[ childIndex2 ];
+	const float splitMin = fAxisValue( centerMin, bestAxis );
+	const float splitScale = binScale[ bestAxis ];
 	
 	faceIndex = node.firstFace;
-	
-	switch( primaryAxis ){
-	case 0: // x largest
-		while( faceIndex != -1 ){
-			sBuildFace &face = pBuildFaces[ faceIndex ];
-			const int nextFaceIndex = face.next;
-			face.next = -1;
-			
-			if( face.center.x < splitPosition ){
-				pNodeAddFace( child1, faceIndex );
-				
-			}else{
-				pNodeAddFace( child2, faceIndex );
-			}
-			
-			faceIndex = nextFaceIndex;
-		}
-		break;
+	while( faceIndex != -1 ){
+		sBuildFace &face = pBuildFaces[ faceIndex ];
+		const int nextFaceIndex = face.next;
+		face.next = -1;
 		
-	case 1: // y largest
-		while( faceIndex != -1 ){
-			sBuildFace &face = pBuildFaces[ faceIndex ];
-			const int nextFaceIndex = face.next;
-			face.next = -1;
-			
-			if( face.center.y < splitPosition ){
-				pNodeAddFace( child1, faceIndex );
-				
-			}else{
-				pNodeAddFace( child2, faceIndex );
-			}
-			
-			faceIndex = nextFaceIndex;
-		}
-		break;
+		// same calculation as used for binning to get the same result
+		bin = decMath::min( ( int )( ( fAxisValue( face.center, bestAxis ) - splitMin )
+			* splitScale ), SAH_BIN_COUNT - 1 );
 		
-	case 2: // z largest
-		while( faceIndex != -1 ){
-			sBuildFace &face = pBuildFaces[ faceIndex ];
-			const int nextFaceIndex = face.next;
-			face.next = -1;
+		if( bin <= bestBin ){
+			pNodeAddFace( child1, faceIndex );
 			
-			if( face.center.z < splitPosition ){
-				pNodeAddFace( child1, faceIndex );
-				
-			}else{
-				pNodeAddFace( child2, faceIndex );
-			}
-			
-			faceIndex = nextFaceIndex;
+		}else{
+			pNodeAddFace( child2, faceIndex );
 		}
-		break;
+		
+		faceIndex = nextFaceIndex;
 	}
 	
 	node.faceCount = 0;
@@ -411,3 +657,110 @@ void deoalModelRTBVH::pBuildVisitNode( const sBuildNode &buildNode ){
 		DETHROW( deeInvalidParam );
 	}
 }
+
+void deoalModelRTBVH::pBuildFacePlanes(){
+	// pad arrays to allow reading 4 values starting at the last face
+	const int stride = pFaceCount + 3;
+	
+	if( stride * 4 > pFacePlaneSize ){
+		if( pFacePlanes ){
+			delete [] pFacePlanes;
+			pFacePlanes = NULL;
+			pFacePlaneSize = 0;
+		}
+		pFacePlanes = new float[ stride * 4 ];
+		pFacePlaneSize = stride * 4;
+	}
+	pFacePlaneStride = stride;
+	
+	float * const normalX = pFacePlanes;
+	float * const normalY = normalX + stride;
+	float * const normalZ = normalY + stride;
+	float * const distance = normalZ + stride;
+	int i;
+	
+	for( i=0; i<pFaceCount; i++ ){
+		const sFace &face = pFaces[ i ];
+		normalX[ i ] = face.normal.x;
+		normalY[ i ] = face.normal.y;
+		normalZ[ i ] = face.normal.z;
+		distance[ i ] = face.normal * face.baseVertex;
+	}
+	
+	for( i=pFaceCount; i<stride; i++ ){
+		normalX[ i ] = 0.0f;
+		normalY[ i ] = 0.0f;
+		normalZ[ i ] = 0.0f;
+		distance[ i ] = 0.0f;
+	}
+}
+
+int deoalModelRTBVH::pBuildWideNode( int nodeIndex ){
+	// collect up to 4 children by opening the inner child with the largest surface area
+	// until no more child can be opened. if the node is a leaf it becomes the only child
+	int children[ 4 ];
+	int childCount = 0;
+	int i;
+	
+	if( pNodes[ nodeIndex ].faceCount > 0 ){
+		children[ childCount++ ] = nodeIndex;
+		
+	}else{
+		children[ childCount++ ] = pNodes[ nodeIndex ].node1;
+		children[ childCount++ ] = pNodes[ nodeIndex ].node2;
+	}
+	
+	while( childCount < 4 ){
+		float bestArea = 0.0f;
+		int bestChild = -1;
+		
+		for( i=0; i<childCount; i++ ){
+			const sNode &child = pNodes[ children[ i ] ];
+			if( child.faceCount > 0 ){
+				continue;
+			}
+			
+			const float area = fHalfArea( child.halfSize );
+			if( bestChild == -1 || area > bestArea ){
+				bestArea = area;
+				bestChild = i;
+			}
+		}
+		
+		if( bestChild == -1 ){
+			break;
+		}
+		
+		const sNode &child = pNodes[ children[ bestChild ] ];
+		children[ bestChild ] = child.node1;
+		children[ childCount++ ] = child.node2;
+	}
+	
+	// store children. wide nodes are preallocated so references stay valid
+	const int wideIndex = pWideNodeCount++;
+	sWideNode &wideNode = pWideNodes[ wideIndex ];
+	
+	for( i=0; i<4; i++ ){
+		wideNode.node[ i ] = -1;
+		wideNode.firstFace[ i ] = 0;
+		wideNode.faceCount[ i ] = 0;
+		
+		if( i >= childCount ){
+			deoalSimdRay::ClearBox( wideNode.bounds, i );
+			continue;
+		}
+		
+		const sNode &child = pNodes[ children[ i ] ];
+		deoalSimdRay::SetBox( wideNode.bounds, i, child.center, child.halfSize );
+		
+		if( child.faceCount > 0 ){
+			wideNode.firstFace[ i ] = child.firstFace;
+			wideNode.faceCount[ i ] = child.faceCount;
+			
+		}else{
+			wideNode.node[ i ] = pBuildWideNode( children[ i ] );
+		}
+	}
+	
+	return wideIndex;
+}
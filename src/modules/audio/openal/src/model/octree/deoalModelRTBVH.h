@@ -24,15 +24,24 @@
 
 #include <dragengine/common/math/decMath.h>
 
+#include "../../utils/deoalSimdRay.h"
+
 
 class deoalAModel;
 class deoalModelFace;
 class deoalModelBVH;
+class decBaseFileReader;
+class decBaseFileWriter;
 
 
 
 /**
  * \brief Ray-tracing optimized model BVH.
+ * 
+ * Binary tree is build using the surface area heuristic. For traversal the binary tree is
+ * collapsed into a 4-wide tree with child bounds stored in structure of arrays layout to
+ * test all children at once using deoalSimdRay. Face planes are stored in structure of
+ * arrays layout too to pre-test faces in groups of 4.
  */
 class deoalModelRTBVH{
 public:
@@ -45,6 +54,21 @@ public:
 		int faceCount;
 	};
 	
+	/** \brief Wide node with up to 4 children. */
+	struct sWideNode{
+		/** \brief Child bounds. Unused children are never hit. */
+		deoalSimdRay::sBoxes bounds;
+		
+		/** \brief Wide child node index or -1 if child is a leaf or unused. */
+		int node[ 4 ];
+		
+		/** \brief First face of leaf child. */
+		int firstFace[ 4 ];
+		
+		/** \brief Face count of leaf child or 0 if child is a node or unused. */
+		int faceCount[ 4 ];
+	};
+	
 	struct sFace{
 		decVector normal;
 		decVector baseVertex;
@@ -83,6 +107,14 @@ private:
 	int pNodeCount;
 	int pNodeSize;
 	
+	sWideNode *pWideNodes;
+	int pWideNodeCount;
+	int pWideNodeSize;
+	
+	float *pFacePlanes;
+	int pFacePlaneStride;
+	int pFacePlaneSize;
+	
 	sBuildNode *pBuildNodes;
 	int pBuildNodeCount;
 	int pBuildNodeSize;
@@ -122,6 +154,28 @@ public:
 	/** \brief Node count. */
 	inline int GetNodeCount() const{ return pNodeCount; }
 	
+	/** \brief Wide nodes. */
+	inline const sWideNode *GetWideNodes() const{ return pWideNodes; }
+	
+	/** \brief Wide node count. */
+	inline int GetWideNodeCount() const{ return pWideNodeCount; }
+	
+	/**
+	 * \brief Face plane normal x coordinates.
+	 * 
+	 * Array is padded to allow reading 4 values starting at any face.
+	 */
+	inline const float *GetFacePlaneNormalX() const{ return pFacePlanes; }
+	
+	/** \brief Face plane normal y coordinates. */
+	inline const float *GetFacePlaneNormalY() const{ return pFacePlanes + pFacePlaneStride; }
+	
+	/** \brief Face plane normal z coordinates. */
+	inline const float *GetFacePlaneNormalZ() const{ return pFacePlanes + pFacePlaneStride * 2; }
+	
+	/** \brief Face plane distances. */
+	inline const float *GetFacePlaneDistance() const{ return pFacePlanes + pFacePlaneStride * 3; }
+	
 	
 	
 	/** \brief Build from faces. */
@@ -129,6 +183,16 @@ public:
 	
 	/** \brief Drop temporary build data. */
 	void DropBuildData();
+	
+	/** \brief Write visit data to cache file. */
+	void WriteToCache( decBaseFileWriter &writer ) const;
+	
+	/**
+	 * \brief Read visit data from cache file written using WriteToCache().
+	 * \returns false if the cache file has been written using different build parameters.
+	 * \throws deeInvalidFileFormat Cache file is damaged.
+	 */
+	bool ReadFromCache( decBaseFileReader &reader );
 	/*@}*/
 	
 	
@@ -140,6 +204,8 @@ private:
 	void pSplitNode( int nodeIndex );
 	void pNodeAddFace( sBuildNode &node, int faceIndex );
 	void pBuildVisitNode( const sBuildNode &buildNode );
+	void pBuildFacePlanes();
+	int pBuildWideNode( int nodeIndex );
 };
 
 #endif
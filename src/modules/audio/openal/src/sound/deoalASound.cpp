@@ -24,6 +24,7 @@
 
 #include "deoalASound.h"
 #include "deoalDecodeBuffer.h"
+#include "deoalSoundResidency.h"
 #include "../deoalCaches.h"
 #include "../deAudioOpenAL.h"
 #include "../audiothread/deoalAudioThread.h"
@@ -101,7 +102,13 @@ pStreamData( NULL ),
 pStreamDataSize( 0 ),
 pStreaming( true ),
 pIsUsed( false ),
-pIsCached( false )
+pIsCached( false ),
+pCanReload( false ),
+
+pResidencyTracked( false ),
+pResidencySize( 0 ),
+pLLResidencyPrev( NULL ),
+pLLResidencyNext( NULL )
 {
 	pDetermineFormat();
 	if( ! pValid ){
@@ -115,7 +122,11 @@ pIsCached( false )
 		return;
 	}
 	
-	pLoadFromCache();
+	// with a sound memory budget the samples are loaded from the cache the first time
+	// the buffer is prepared. this avoids keeping samples in memory which are never played
+	const bool useBudget = audioThread.GetConfiguration().GetSoundMemoryBudget() > 0;
+	
+	pLoadFromCache( ! useBudget );
 	if( pIsCached ){
 		LEAK_CHECK_CREATE( audioThread, Sound );
 		return;
@@ -124,12 +135,20 @@ pIsCached( false )
 	pLoadEntireSound( sound );
 	pWriteToCache();
 	
+	if( useBudget ){
+		pDropStreamData();
+	}
+	
 	LEAK_CHECK_CREATE( audioThread, Sound );
 }
 
 deoalASound::~deoalASound(){
 	LEAK_CHECK_FREE( pAudioThread, Sound );
 	
+	if( pResidencyTracked ){
+		pAudioThread.GetSoundResidency().Remove( this );
+	}
+	
 	pCleanUp();
 }
 
@@ -154,7 +173,7 @@ void deoalASound::PreloadSound( deSound &sound ){
 				pFilename.GetString() );
 		}
 		
-		if( ! pStreamData ){
+		if( ! pStreamData && ( ! pCanReload || ! pReloadFromCache() ) ){
 			pLoadEntireSound( sound );
 		}
 		
@@ -169,10 +188,68 @@ void deoalASound::PrepareBuffers(){
 	}
 	
 	if( ! pBuffer ){
+		if( ! pStreamData && ! pReloadFromCache() ){
+			pAudioThread.GetLogger().LogWarnFormat( "Sound '%s': Failed reloading samples from cache",
+				pFilename.GetString() );
+			return;
+		}
+		
 		OAL_CHECK( pAudioThread, alGenBuffers( 1, &pBuffer ) );
 		OAL_CHECK( pAudioThread, alBufferData( pBuffer, pFormat,
 			( const ALvoid * )pStreamData, pStreamDataSize, pSampleRate ) );
+		
+		// the buffer holds now a copy of the samples. with a sound memory budget drop
+		// the samples if they can be reloaded from the cache
+		if( pAudioThread.GetConfiguration().GetSoundMemoryBudget() > 0 ){
+			pDropStreamData();
+		}
 	}
+	
+	pAudioThread.GetSoundResidency().Touch( this );
+}
+
+int deoalASound::GetResidentSize() const{
+	int size = pStreamDataSize;
+	if( pBuffer ){
+		size += pSampleCount * pBytesPerSample * pChannelCount;
+	}
+	return size;
+}
+
+bool deoalASound::DropResidentData(){
+	if( ! pCanReload ){
+		return false;
+	}
+	
+	pDropStreamData();
+	
+	if( pBuffer ){
+		OAL_CHECK( pAudioThread, alDeleteBuffers( 1, &pBuffer ) );
+		pBuffer = 0;
+	}
+	
+	return true;
+}
+
+
+
+// Residency management
+/////////////////////////
+
+void deoalASound::SetResidencyTracked( bool tracked ){
+	pResidencyTracked = tracked;
+}
+
+void deoalASound::SetResidencySize( int size ){
+	pResidencySize = size;
+}
+
+void deoalASound::SetLLResidencyPrev( deoalASound *sound ){
+	pLLResidencyPrev = sound;
+}
+
+void deoalASound::SetLLResidencyNext( deoalASound *sound ){
+	pLLResidencyNext = sound;
 }
 
 
@@ -224,7 +301,7 @@ void deoalASound::pCleanUp(){
 
 
 
-void deoalASound::pLoadFromCache(){
+void deoalASound::pLoadFromCache( bool loadData ){
 	const bool enableCacheLogging = ENABLE_CACHE_LOGGING;
 	
 	deVirtualFileSystem &vfs = pAudioThread.GetOal().GetVFS();
@@ -309,9 +386,17 @@ void deoalASound::pLoadFromCache(){
 		}
 		
 		if( header.bufferSize > 0 ){
-			pStreamData = new char[ header.bufferSize ];
-			pStreamDataSize = header.bufferSize;
-			reader->Read( pStreamData, pStreamDataSize );
+			if( reader->GetLength() - reader->GetPosition() != ( int )header.bufferSize ){
+				DETHROW( deeInvalidParam );
+			}
+			
+			if( loadData ){
+				pStreamData = new char[ header.bufferSize ];
+				pStreamDataSize = header.bufferSize;
+				reader->Read( pStreamData, pStreamDataSize );
+			}
+			
+			pCanReload = true;
 		}
 		
 		// done
@@ -324,6 +409,13 @@ void deoalASound::pLoadFromCache(){
 		
 	}catch( const deException & ){
 		// damaged cache file
+		if( pStreamData ){
+			delete [] pStreamData;
+			pStreamData = NULL;
+			pStreamDataSize = 0;
+		}
+		pCanReload = false;
+		
 		reader = NULL;
 		cacheSound.Delete( pFilename );
 		caches.Unlock();
@@ -381,6 +473,8 @@ void deoalASound::pWriteToCache(){
 		}
 		writer = NULL;
 		
+		pCanReload = pStreamDataSize > 0;
+		
 		caches.Unlock();
 		if( enableCacheLogging ){
 			logger.LogInfoFormat( "Sound '%s': Cache written", pFilename.GetString() );
@@ -389,6 +483,7 @@ void deoalASound::pWriteToCache(){
 	}catch( const deException &e ){
 		writer = NULL;
 		cacheSound.Delete( pFilename );
+		pCanReload = false;
 		caches.Unlock();
 		
 		if( enableCacheLogging ){
@@ -400,6 +495,26 @@ void deoalASound::pWriteToCache(){
 
 
 
+bool deoalASound::pReloadFromCache(){
+	pCanReload = false;
+	
+	pLoadFromCache( true );
+	
+	return pStreamData != NULL;
+}
+
+void deoalASound::pDropStreamData(){
+	if( ! pCanReload || ! pStreamData ){
+		return;
+	}
+	
+	delete [] pStreamData;
+	pStreamData = NULL;
+	pStreamDataSize = 0;
+}
+
+
+
 void deoalASound::pDetermineStreaming(){
 	// it is tricky to decide if data should be kept in memory or streamed.
 	// 
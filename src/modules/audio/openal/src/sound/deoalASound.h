@@ -56,6 +56,12 @@ private:
 	
 	bool pIsUsed;
 	bool pIsCached;
+	bool pCanReload;
+	
+	bool pResidencyTracked;
+	int pResidencySize;
+	deoalASound *pLLResidencyPrev;
+	deoalASound *pLLResidencyNext;
 	
 	
 	
@@ -108,7 +114,12 @@ public:
 	
 	
 	
-	/** \brief Stream data or \em NULL if not loaded. */
+	/**
+	 * \brief Stream data or \em NULL if not loaded.
+	 * 
+	 * If a sound memory budget is set stream data is dropped once the buffer has been
+	 * created if the data can be reloaded from the cache.
+	 */
 	inline char *GetStreamData() const{ return pStreamData; }
 	
 	/** \brief Stream data size in bytes or 0 if not loaded. */
@@ -120,6 +131,9 @@ public:
 	/** \bnrief Sound has been at least once. */
 	inline bool IsUsed() const{ return pIsUsed; }
 	
+	/** \brief Sample data can be reloaded from the cache if dropped. */
+	inline bool GetCanReload() const{ return pCanReload; }
+	
 	
 	
 	/**
@@ -147,8 +161,56 @@ public:
 	 * This method has to be called whenever a speaker or microphone starts using the sound.
 	 * If the buffer is not present and the sound is not streaming the samples are loaded
 	 * from the original resource file, the buffer created and the samples cached.
+	 * 
+	 * If the buffer has been dropped by deoalSoundResidency the samples are reloaded from
+	 * the cache. Marks the sound most recently used in deoalSoundResidency.
 	 */
 	void PrepareBuffers();
+	
+	/**
+	 * \brief Resident memory in bytes.
+	 * 
+	 * Sum of loaded stream data and buffer memory.
+	 */
+	int GetResidentSize() const;
+	
+	/**
+	 * \brief Drop stream data and buffer if the samples can be reloaded from the cache.
+	 * 
+	 * Returns true if dropped. Caller is responsible to ensure no source uses the buffer.
+	 * 
+	 * \warning Called by deoalSoundResidency from the audio thread.
+	 */
+	bool DropResidentData();
+	/*@}*/
+	
+	
+	
+	/** \name Residency management */
+	/*@{*/
+	/** \brief Sound is tracked by deoalSoundResidency. */
+	inline bool GetResidencyTracked() const{ return pResidencyTracked; }
+	
+	/** \brief Set if sound is tracked by deoalSoundResidency. */
+	void SetResidencyTracked( bool tracked );
+	
+	/** \brief Resident size accounted by deoalSoundResidency. */
+	inline int GetResidencySize() const{ return pResidencySize; }
+	
+	/** \brief Set resident size accounted by deoalSoundResidency. */
+	void SetResidencySize( int size );
+	
+	/** \brief Previous less recently used sound. */
+	inline deoalASound *GetLLResidencyPrev() const{ return pLLResidencyPrev; }
+	
+	/** \brief Set previous less recently used sound. */
+	void SetLLResidencyPrev( deoalASound *sound );
+	
+	/** \brief Next more recently used sound. */
+	inline deoalASound *GetLLResidencyNext() const{ return pLLResidencyNext; }
+	
+	/** \brief Set next more recently used sound. */
+	void SetLLResidencyNext( deoalASound *sound );
 	/*@}*/
 	
 	
@@ -156,8 +218,10 @@ public:
 private:
 	void pCleanUp();
 	
-	void pLoadFromCache();
+	void pLoadFromCache( bool loadData );
 	void pWriteToCache();
+	bool pReloadFromCache();
+	void pDropStreamData();
 	
 	void pDetermineStreaming();
 	void pDetermineFormat();
@@ -0,0 +1,174 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoalDecodeAhead.h"
+#include "deoalDecodeAheadStream.h"
+#include "deoalDecodeAheadThread.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Definitions
+////////////////
+
+// number of decode-ahead threads. decoding is light weight compared to the audio
+// processing. two threads keep streams filled while one is blocked by a slow decoder
+#define THREAD_COUNT 2
+
+
+
+// Class deoalDecodeAhead
+///////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoalDecodeAhead::deoalDecodeAhead( deoalAudioThread &audioThread ) :
+pAudioThread( audioThread ),
+pShutDown( false ),
+pThreads( NULL ),
+pThreadCount( 0 )
+{
+	try{
+		pThreads = new deoalDecodeAheadThread*[ THREAD_COUNT ];
+		
+		for( pThreadCount=0; pThreadCount<THREAD_COUNT; pThreadCount++ ){
+			pThreads[ pThreadCount ] = new deoalDecodeAheadThread( *this );
+			pThreads[ pThreadCount ]->Start();
+		}
+		
+	}catch( const deException & ){
+		pCleanUp();
+		throw;
+	}
+}
+
+deoalDecodeAhead::~deoalDecodeAhead(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void deoalDecodeAhead::AddStream( deoalDecodeAheadStream *stream ){
+	if( ! stream ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	deMutexGuard guard( pMutex );
+	pStreams.Add( stream );
+}
+
+void deoalDecodeAhead::RemoveStream( deoalDecodeAheadStream *stream ){
+	deMutexGuard guard( pMutex );
+	const int index = pStreams.IndexOf( stream );
+	if( index == -1 ){
+		DETHROW( deeInvalidParam );
+	}
+	pStreams.RemoveFrom( index );
+	guard.Unlock();
+	
+	// threads lock the stream decode mutex while holding the decode-ahead mutex. locking
+	// the decode mutex after removing the stream ensures no thread is using it anymore
+	stream->GetMutexDecode().Lock();
+	stream->GetMutexDecode().Unlock();
+}
+
+void deoalDecodeAhead::WakeUp(){
+	pSemaphore.Signal();
+}
+
+bool deoalDecodeAhead::WaitForWork(){
+	pSemaphore.Wait();
+	
+	deMutexGuard guard( pMutex );
+	return ! pShutDown;
+}
+
+deoalDecodeAheadStream *deoalDecodeAhead::NextStream(){
+	deMutexGuard guard( pMutex );
+	if( pShutDown ){
+		return NULL;
+	}
+	
+	const int count = pStreams.GetCount();
+	deoalDecodeAheadStream *bestStream = NULL;
+	float bestFillRatio = 0.0f;
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		deoalDecodeAheadStream * const stream = ( deoalDecodeAheadStream* )pStreams.GetAt( i );
+		
+		// streams locked by other threads or the audio thread are skipped
+		if( ! stream->GetMutexDecode().TryLock() ){
+			continue;
+		}
+		
+		const float fillRatio = stream->GetFillRatio();
+		
+		if( fillRatio >= 0.0f && ( ! bestStream || fillRatio < bestFillRatio ) ){
+			if( bestStream ){
+				bestStream->GetMutexDecode().Unlock();
+			}
+			bestStream = stream;
+			bestFillRatio = fillRatio;
+			
+		}else{
+			stream->GetMutexDecode().Unlock();
+		}
+	}
+	
+	return bestStream;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deoalDecodeAhead::pCleanUp(){
+	if( ! pThreads ){
+		return;
+	}
+	
+	pMutex.Lock();
+	pShutDown = true;
+	pMutex.Unlock();
+	
+	int i;
+	for( i=0; i<pThreadCount; i++ ){
+		pSemaphore.Signal();
+	}
+	for( i=0; i<pThreadCount; i++ ){
+		pThreads[ i ]->WaitForExit();
+		delete pThreads[ i ];
+	}
+	delete [] pThreads;
+	pThreads = NULL;
+}
@@ -0,0 +1,104 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOALDECODEAHEAD_H_
+#define _DEOALDECODEAHEAD_H_
+
+#include <dragengine/common/collection/decPointerList.h>
+#include <dragengine/threading/deMutex.h>
+#include <dragengine/threading/deSemaphore.h>
+
+class deoalAudioThread;
+class deoalDecodeAheadStream;
+class deoalDecodeAheadThread;
+
+
+
+/**
+ * \brief Decode-ahead.
+ * 
+ * Pool of threads decoding streaming speakers ahead of playback. Threads wake up if a
+ * stream has been read from or started. Each thread decodes one chunk at a time of the
+ * stream closest to running dry until all streams are filled.
+ * 
+ * Lock order is decode-ahead mutex then stream decode mutex then stream buffer mutex.
+ */
+class deoalDecodeAhead{
+private:
+	deoalAudioThread &pAudioThread;
+	
+	deMutex pMutex;
+	deSemaphore pSemaphore;
+	decPointerList pStreams;
+	bool pShutDown;
+	
+	deoalDecodeAheadThread **pThreads;
+	int pThreadCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create decode-ahead. */
+	deoalDecodeAhead( deoalAudioThread &audioThread );
+	
+	/** \brief Clean up decode-ahead. */
+	~deoalDecodeAhead();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Audio thread. */
+	inline deoalAudioThread &GetAudioThread() const{ return pAudioThread; }
+	
+	/** \brief Add stream. */
+	void AddStream( deoalDecodeAheadStream *stream );
+	
+	/** \brief Remove stream waiting for threads to finish decoding it. */
+	void RemoveStream( deoalDecodeAheadStream *stream );
+	
+	/** \brief Wake up threads to decode streams. */
+	void WakeUp();
+	
+	/**
+	 * \brief Wait for streams to decode.
+	 * \details Called by decode-ahead threads. Returns false if the thread has to exit.
+	 */
+	bool WaitForWork();
+	
+	/**
+	 * \brief Next stream to decode or NULL if all streams are filled.
+	 * \details Called by decode-ahead threads. The decode mutex of the returned stream is
+	 *          locked. The caller has to unlock it after decoding.
+	 */
+	deoalDecodeAheadStream *NextStream();
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+};
+
+#endif
@@ -0,0 +1,240 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoalDecodeAhead.h"
+#include "deoalDecodeAheadStream.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/resources/sound/deSoundDecoder.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Class deoalDecodeAheadStream
+/////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoalDecodeAheadStream::deoalDecodeAheadStream( deoalDecodeAhead &decodeAhead,
+int chunkSize, int chunkCount ) :
+pDecodeAhead( decodeAhead ),
+pDecoder( NULL ),
+pLooping( false ),
+pEndOfStream( false ),
+pBuffer( NULL ),
+pSize( 0 ),
+pChunkSize( chunkSize ),
+pReadPosition( 0 ),
+pFillCount( 0 )
+{
+	if( chunkSize < 1 || chunkCount < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pBuffer = new char[ chunkSize * chunkCount ];
+	pSize = chunkSize * chunkCount;
+	
+	try{
+		decodeAhead.AddStream( this );
+		
+	}catch( const deException & ){
+		delete [] pBuffer;
+		throw;
+	}
+}
+
+deoalDecodeAheadStream::~deoalDecodeAheadStream(){
+	pDecodeAhead.RemoveStream( this );
+	
+	if( pBuffer ){
+		delete [] pBuffer;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void deoalDecodeAheadStream::SetLooping( bool looping ){
+	if( looping == pLooping ){
+		return;
+	}
+	
+	// data decoded so far stays valid. only decoding past the end of stream changes
+	deMutexGuard guard( pMutexDecode );
+	pLooping = looping;
+	if( looping ){
+		pEndOfStream = false;
+	}
+}
+
+void deoalDecodeAheadStream::Start( deSoundDecoder *decoder, int position, bool looping ){
+	if( ! decoder ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	deMutexGuard guardDecode( pMutexDecode );
+	deMutexGuard guardBuffer( pMutexBuffer );
+	
+	pDecoder = decoder;
+	pLooping = looping;
+	pEndOfStream = false;
+	pReadPosition = 0;
+	pFillCount = 0;
+	
+	decoder->SetPosition( position );
+	
+	pDecodeAhead.WakeUp();
+}
+
+void deoalDecodeAheadStream::Stop(){
+	deMutexGuard guardDecode( pMutexDecode );
+	deMutexGuard guardBuffer( pMutexBuffer );
+	
+	pDecoder = NULL;
+	pEndOfStream = false;
+	pReadPosition = 0;
+	pFillCount = 0;
+}
+
+int deoalDecodeAheadStream::Read( char *buffer, int size ){
+	if( ! buffer || size < 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	int bytesRead = pReadBuffer( buffer, size );
+	
+	if( bytesRead < size ){
+		// decode-ahead ran dry. decode the missing data synchronously. a decode-ahead
+		// thread can have finished decoding a chunk while waiting for the mutex
+		deMutexGuard guard( pMutexDecode );
+		bytesRead += pReadBuffer( buffer + bytesRead, size - bytesRead );
+		if( bytesRead < size ){
+			bytesRead += pDecode( buffer + bytesRead, size - bytesRead );
+		}
+	}
+	
+	if( bytesRead < size ){
+		memset( buffer + bytesRead, '\0', size - bytesRead );
+	}
+	
+	pDecodeAhead.WakeUp();
+	return bytesRead;
+}
+
+
+
+float deoalDecodeAheadStream::GetFillRatio(){
+	if( ! pDecoder || pEndOfStream ){
+		return -1.0f;
+	}
+	
+	deMutexGuard guard( pMutexBuffer );
+	if( pFillCount == pSize ){
+		return -1.0f;
+	}
+	return ( float )pFillCount / ( float )pSize;
+}
+
+void deoalDecodeAheadStream::DecodeChunk(){
+	if( ! pDecoder || pEndOfStream ){
+		return;
+	}
+	
+	deMutexGuard guard( pMutexBuffer );
+	const int writePosition = ( pReadPosition + pFillCount ) % pSize;
+	const int count = decMath::min( pChunkSize, pSize - pFillCount, pSize - writePosition );
+	if( count == 0 ){
+		return;
+	}
+	guard.Unlock();
+	
+	// the region written to is not part of the filled region hence the audio thread
+	// does not read it while decoding
+	const int bytesRead = pDecode( pBuffer + writePosition, count );
+	
+	guard.Lock();
+	pFillCount += bytesRead;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+int deoalDecodeAheadStream::pReadBuffer( char *buffer, int size ){
+	deMutexGuard guard( pMutexBuffer );
+	
+	const int count = decMath::min( size, pFillCount );
+	if( count == 0 ){
+		return 0;
+	}
+	
+	const int firstCount = decMath::min( count, pSize - pReadPosition );
+	memcpy( buffer, pBuffer + pReadPosition, firstCount );
+	if( count > firstCount ){
+		memcpy( buffer + firstCount, pBuffer, count - firstCount );
+	}
+	
+	pReadPosition = ( pReadPosition + count ) % pSize;
+	pFillCount -= count;
+	
+	return count;
+}
+
+int deoalDecodeAheadStream::pDecode( char *buffer, int size ){
+	// same behavior as deoalDecodeBuffer::Decode and deoalDecodeBuffer::DecodeLooping
+	if( ! pDecoder || pEndOfStream ){
+		return 0;
+	}
+	
+	int totalBytesRead = 0;
+	
+	while( totalBytesRead < size ){
+		const int bytesRead = pDecoder->ReadSamples( buffer + totalBytesRead, size - totalBytesRead );
+		totalBytesRead += bytesRead;
+		
+		if( totalBytesRead == size ){
+			break;
+		}
+		
+		if( ! pLooping ){
+			pEndOfStream = true;
+			break;
+		}
+		
+		if( bytesRead == 0 && totalBytesRead == 0 && pDecoder->GetPosition() == 0 ){
+			pEndOfStream = true; // empty stream. prevent looping forever
+			break;
+		}
+		
+		pDecoder->SetPosition( 0 ); // rewind
+	}
+	
+	return totalBytesRead;
+}
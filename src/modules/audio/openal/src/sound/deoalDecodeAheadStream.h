@@ -0,0 +1,143 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOALDECODEAHEADSTREAM_H_
+#define _DEOALDECODEAHEADSTREAM_H_
+
+#include <dragengine/threading/deMutex.h>
+
+class deoalDecodeAhead;
+class deSoundDecoder;
+
+
+
+/**
+ * \brief Decode-ahead stream.
+ * 
+ * Ring buffer of decoded PCM data for a streaming speaker. Decode-ahead threads fill the
+ * ring buffer while the audio thread reads from it. If the ring buffer runs dry the audio
+ * thread decodes the missing data synchronously.
+ * 
+ * The decode mutex is held while the decoder is used. The buffer mutex is held while
+ * the ring buffer positions are changed. Lock order is decode mutex then buffer mutex.
+ * Decoding writes only to the free part of the ring buffer hence the buffer mutex is
+ * not held while decoding.
+ * 
+ * The decoder is not owned by the stream. The owner has to call Stop() before the
+ * decoder is released.
+ */
+class deoalDecodeAheadStream{
+private:
+	deoalDecodeAhead &pDecodeAhead;
+	
+	deSoundDecoder *pDecoder;
+	bool pLooping;
+	bool pEndOfStream;
+	
+	char *pBuffer;
+	int pSize;
+	int pChunkSize;
+	int pReadPosition;
+	int pFillCount;
+	
+	deMutex pMutexDecode;
+	deMutex pMutexBuffer;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create decode-ahead stream and add it to decode-ahead.
+	 * \param[in] decodeAhead Decode-ahead to add stream to.
+	 * \param[in] chunkSize Size in bytes to decode at once. Has to be a multiple of
+	 *                      the sample size.
+	 * \param[in] chunkCount Number of chunks to decode ahead.
+	 */
+	deoalDecodeAheadStream( deoalDecodeAhead &decodeAhead, int chunkSize, int chunkCount );
+	
+	/** \brief Remove stream from decode-ahead and clean up stream. */
+	~deoalDecodeAheadStream();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Size in bytes decoded at once. */
+	inline int GetChunkSize() const{ return pChunkSize; }
+	
+	/** \brief Number of chunks decoded ahead. */
+	inline int GetChunkCount() const{ return pSize / pChunkSize; }
+	
+	/** \brief Decode looping. */
+	inline bool GetLooping() const{ return pLooping; }
+	
+	/** \brief Set decode looping. */
+	void SetLooping( bool looping );
+	
+	/**
+	 * \brief Start decoding.
+	 * \param[in] decoder Decoder to use.
+	 * \param[in] position Sample position to start decoding at.
+	 * \param[in] looping Rewind decoder if the end of stream is reached.
+	 */
+	void Start( deSoundDecoder *decoder, int position, bool looping );
+	
+	/** \brief Stop decoding and drop decoder. */
+	void Stop();
+	
+	/**
+	 * \brief Read decoded data.
+	 * 
+	 * Missing data is decoded synchronously. If the end of stream is reached the remaining
+	 * buffer is filled with zeros. Returns the number of bytes read.
+	 */
+	int Read( char *buffer, int size );
+	
+	
+	
+	/** \brief Decode mutex. */
+	inline deMutex &GetMutexDecode(){ return pMutexDecode; }
+	
+	/**
+	 * \brief Ratio of ring buffer filled with decoded data or -1 if no decoding is required.
+	 * \details Streams with lower fill ratio are closer to running dry and are decoded first.
+	 * \warning Caller has to hold the decode mutex.
+	 */
+	float GetFillRatio();
+	
+	/**
+	 * \brief Decode next chunk into the ring buffer.
+	 * \warning Caller has to hold the decode mutex.
+	 */
+	void DecodeChunk();
+	/*@}*/
+	
+	
+	
+private:
+	int pReadBuffer( char *buffer, int size );
+	int pDecode( char *buffer, int size );
+};
+
+#endif
@@ -0,0 +1,59 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOALDECODEAHEADTHREAD_H_
+#define _DEOALDECODEAHEADTHREAD_H_
+
+#include <dragengine/threading/deThread.h>
+
+class deoalDecodeAhead;
+
+
+
+/**
+ * \brief Decode-ahead thread.
+ */
+class deoalDecodeAheadThread : public deThread{
+private:
+	deoalDecodeAhead &pDecodeAhead;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create decode-ahead thread. */
+	deoalDecodeAheadThread( deoalDecodeAhead &decodeAhead );
+	
+	/** \brief Clean up decode-ahead thread. */
+	virtual ~deoalDecodeAheadThread();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Run thread. */
+	virtual void Run();
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,175 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "deoalASound.h"
+#include "deoalSoundResidency.h"
+#include "../audiothread/deoalAudioThread.h"
+#include "../audiothread/deoalATLogger.h"
+#include "../configuration/deoalConfiguration.h"
+#include "../source/deoalSourceManager.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Class deoalSoundResidency
+//////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoalSoundResidency::deoalSoundResidency( deoalAudioThread &audioThread ) :
+pAudioThread( audioThread ),
+pRootSound( NULL ),
+pTailSound( NULL ),
+pSoundCount( 0 ),
+pResidentSize( 0 ){
+}
+
+deoalSoundResidency::~deoalSoundResidency(){
+	// sounds can outlive the audio thread objects. clear the tracked flag so they do
+	// not try to remove themselves later on
+	while( pRootSound ){
+		deoalASound * const next = pRootSound->GetLLResidencyNext();
+		pRootSound->SetLLResidencyPrev( NULL );
+		pRootSound->SetLLResidencyNext( NULL );
+		pRootSound->SetResidencyTracked( false );
+		pRootSound->SetResidencySize( 0 );
+		pRootSound = next;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void deoalSoundResidency::Touch( deoalASound *sound ){
+	if( ! sound ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const deMutexGuard guard( pMutex );
+	
+	if( sound->GetResidencyTracked() ){
+		if( sound == pTailSound ){
+			pResidentSize -= sound->GetResidencySize();
+			sound->SetResidencySize( sound->GetResidentSize() );
+			pResidentSize += sound->GetResidencySize();
+			return;
+		}
+		
+		pUnlink( sound );
+	}
+	
+	if( pTailSound ){
+		pTailSound->SetLLResidencyNext( sound );
+		sound->SetLLResidencyPrev( pTailSound );
+		
+	}else{
+		pRootSound = sound;
+		sound->SetLLResidencyPrev( NULL );
+	}
+	sound->SetLLResidencyNext( NULL );
+	pTailSound = sound;
+	
+	sound->SetResidencyTracked( true );
+	sound->SetResidencySize( sound->GetResidentSize() );
+	pResidentSize += sound->GetResidencySize();
+	pSoundCount++;
+}
+
+void deoalSoundResidency::Remove( deoalASound *sound ){
+	if( ! sound ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const deMutexGuard guard( pMutex );
+	if( sound->GetResidencyTracked() ){
+		pUnlink( sound );
+	}
+}
+
+void deoalSoundResidency::EnforceBudget(){
+	// budget is in MB. clamped by the configuration to not overflow
+	const int budget = pAudioThread.GetConfiguration().GetSoundMemoryBudget() * 1024 * 1024;
+	if( budget == 0 || pResidentSize <= budget ){
+		return;
+	}
+	
+	const deoalSourceManager &sourceManager = pAudioThread.GetSourceManager();
+	const deMutexGuard guard( pMutex );
+	const int residentSize = pResidentSize;
+	deoalASound *sound = pRootSound;
+	int dropCount = 0;
+	
+	while( sound && pResidentSize > budget ){
+		deoalASound * const next = sound->GetLLResidencyNext();
+		
+		// sounds attached to a source can not drop their buffer. this includes paused
+		// sources and sources stolen by other speakers not yet updated
+		if( ! sourceManager.IsBufferAttached( sound->GetBuffer() )
+		&& sound->DropResidentData() ){
+			pUnlink( sound );
+			dropCount++;
+		}
+		
+		sound = next;
+	}
+	
+	if( dropCount > 0 ){
+		pAudioThread.GetLogger().LogInfoFormat( "Sound residency: Dropped %d sounds (%d -> %d bytes)",
+			dropCount, residentSize, pResidentSize );
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deoalSoundResidency::pUnlink( deoalASound *sound ){
+	if( sound->GetLLResidencyPrev() ){
+		sound->GetLLResidencyPrev()->SetLLResidencyNext( sound->GetLLResidencyNext() );
+		
+	}else{
+		pRootSound = sound->GetLLResidencyNext();
+	}
+	
+	if( sound->GetLLResidencyNext() ){
+		sound->GetLLResidencyNext()->SetLLResidencyPrev( sound->GetLLResidencyPrev() );
+		
+	}else{
+		pTailSound = sound->GetLLResidencyPrev();
+	}
+	
+	sound->SetLLResidencyPrev( NULL );
+	sound->SetLLResidencyNext( NULL );
+	sound->SetResidencyTracked( false );
+	
+	pResidentSize -= sound->GetResidencySize();
+	sound->SetResidencySize( 0 );
+	pSoundCount--;
+}
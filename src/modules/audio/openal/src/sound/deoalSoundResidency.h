@@ -0,0 +1,94 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOALSOUNDRESIDENCY_H_
+#define _DEOALSOUNDRESIDENCY_H_
+
+#include <dragengine/threading/deMutex.h>
+
+class deoalAudioThread;
+class deoalASound;
+
+
+
+/**
+ * \brief Sound residency.
+ * 
+ * Keeps track of non-streaming sounds with resident sample data in least recently played
+ * order. If the resident memory exceeds the sound memory budget the least recently played
+ * sounds not attached to any source drop their sample data. Dropped sounds reload their
+ * samples from the cache the next time a speaker prepares the buffer.
+ * 
+ * Sounds are added and removed from the main thread and the audio thread. The budget
+ * is enforced from the audio thread only.
+ */
+class deoalSoundResidency{
+private:
+	deoalAudioThread &pAudioThread;
+	
+	deMutex pMutex;
+	deoalASound *pRootSound;
+	deoalASound *pTailSound;
+	int pSoundCount;
+	int pResidentSize;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create sound residency. */
+	deoalSoundResidency( deoalAudioThread &audioThread );
+	
+	/** \brief Clean up sound residency. */
+	~deoalSoundResidency();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of tracked sounds. */
+	inline int GetSoundCount() const{ return pSoundCount; }
+	
+	/** \brief Resident memory of tracked sounds in bytes. */
+	inline int GetResidentSize() const{ return pResidentSize; }
+	
+	/** \brief Mark sound most recently played adding it if not tracked. */
+	void Touch( deoalASound *sound );
+	
+	/** \brief Remove sound if tracked. */
+	void Remove( deoalASound *sound );
+	
+	/**
+	 * \brief Drop sample data of least recently played sounds until the budget is met.
+	 * \warning Called from the audio thread.
+	 */
+	void EnforceBudget();
+	/*@}*/
+	
+	
+	
+private:
+	void pUnlink( deoalASound *sound );
+};
+
+#endif
@@ -140,6 +140,27 @@ void deoalSourceManager::UnbindSource( deoalSource *source ){
 	pCountUnbound++;
 }
 
+bool deoalSourceManager::IsBufferAttached( ALuint buffer ) const{
+	if( ! buffer ){
+		return false;
+	}
+	
+	const int count = pSources.GetCount();
+	ALint attached;
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		attached = 0;
+		OAL_CHECK( pAudioThread, alGetSourcei( ( ( deoalSource* )pSources.GetAt( i ) )
+			->GetSource(), AL_BUFFER, &attached ) );
+		if( ( ALuint )attached == buffer ){
+			return true;
+		}
+	}
+	
+	return false;
+}
+
 
 
 void deoalSourceManager::DebugOutput( decUnicodeString& ){
@@ -99,6 +99,9 @@ public:
 	/** \brief Unbind source. */
 	void UnbindSource( deoalSource *source );
 	
+	/** \brief Buffer is attached to a source. Returns false if buffer is 0. */
+	bool IsBufferAttached( ALuint buffer ) const;
+	
 	
 	
 	/** \brief Dnformation for developer mode display. */
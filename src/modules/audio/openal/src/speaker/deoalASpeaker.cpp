@@ -33,6 +33,7 @@
 #include "../effect/deoalFilter.h"
 #include "../extensions/deoalExtensions.h"
 #include "../microphone/deoalAMicrophone.h"
+#include "../sound/deoalDecodeAheadStream.h"
 #include "../sound/deoalDecodeBuffer.h"
 #include "../sound/deoalASound.h"
 #include "../soundLevelMeter/deoalASoundLevelMeter.h"
@@ -78,6 +79,7 @@ pSound( NULL ),
 pSynthesizer( NULL ),
 pVideoPlayer( NULL ),
 pSourceUpdateTracker( 0 ),
+pDecodeAheadStream( NULL ),
 pSpeakerType( deSpeaker::estPoint ),
 pPositionless( true ),
 pStreaming( false ),
@@ -158,6 +160,7 @@ deoalAVideoPlayer *videoPlayer ){
 		return;
 	}
 	// drop old source and decoder if present
+	pStopDecodeAhead();
 	pSoundDecoder = NULL;
 	
 	if( pVideoPlayer ){
@@ -200,6 +203,7 @@ deoalAVideoPlayer *videoPlayer ){
 void deoalASpeaker::SetSoundDecoder( deSoundDecoder *decoder ){
 	// WARNING Called during synchronization time from main thread.
 	
+	pStopDecodeAhead();
 	pSoundDecoder = decoder;
 	pNeedsInitialDecode = decoder != NULL;
 }
@@ -710,6 +714,10 @@ public:
 };
 
 void deoalASpeaker::pCleanUp(){
+	if( pDecodeAheadStream ){
+		delete pDecodeAheadStream;
+		pDecodeAheadStream = NULL;
+	}
 	pSoundDecoder = NULL;
 	if( pBufferData ){
 		delete [] pBufferData;
@@ -768,16 +776,11 @@ void deoalASpeaker::pDecodeInitial(){
 	
 	pQueueSampleOffset = pPlayPosition = pPlayFrom;
 	
-	pSoundDecoder->SetPosition( pQueueSampleOffset );
+	pStartDecodeAhead();
 	
 	for( i=0; i<pSource->GetBufferCount(); i++ ){
-		if( pLooping ){
-			buffer.DecodeLooping( pSoundDecoder, pBufferSize );
-			
-		}else{
-			if( buffer.Decode( pSoundDecoder, pBufferSize ) == 0 ){
-				break;
-			}
+		if( pDecode( buffer ) == 0 ){
+			break;
 		}
 		
 		const ALuint albuffer = pSource->GetBufferAt( i );
@@ -820,15 +823,14 @@ void deoalASpeaker::pDecodeNext( bool underrun ){
 		restartPlaying = true;
 	}
 	
+	if( pDecodeAheadStream ){
+		pDecodeAheadStream->SetLooping( pLooping );
+	}
+	
 	for( i=0; i<numFinished; i++ ){
-		if( pLooping ){
-			buffer.DecodeLooping( pSoundDecoder, pBufferSize );
-			
-		}else{
-			if( buffer.Decode( pSoundDecoder, pBufferSize ) == 0 ){
-				numFinished = i;
-				break;
-			}
+		if( pDecode( buffer ) == 0 ){
+			numFinished = i;
+			break;
 		}
 		
 		OAL_CHECK( pAudioThread, alBufferData( buffers[ i ], pSound->GetFormat(),
@@ -849,6 +851,50 @@ void deoalASpeaker::pDecodeNext( bool underrun ){
 	}
 }
 
+void deoalASpeaker::pStartDecodeAhead(){
+	const int chunkCount = pAudioThread.GetConfiguration().GetDecodeAheadBuffers();
+	
+	if( pDecodeAheadStream && ( chunkCount == 0 || pDecodeAheadStream->GetChunkSize() != pBufferSize
+	|| pDecodeAheadStream->GetChunkCount() != chunkCount ) ){
+		delete pDecodeAheadStream;
+		pDecodeAheadStream = NULL;
+	}
+	
+	if( chunkCount == 0 ){
+		pSoundDecoder->SetPosition( pQueueSampleOffset );
+		return;
+	}
+	
+	if( ! pDecodeAheadStream ){
+		pDecodeAheadStream = new deoalDecodeAheadStream(
+			pAudioThread.GetDecodeAhead(), pBufferSize, chunkCount );
+	}
+	pDecodeAheadStream->Start( pSoundDecoder, pQueueSampleOffset, pLooping );
+}
+
+void deoalASpeaker::pStopDecodeAhead(){
+	// waits for decode-ahead threads to stop using the sound decoder
+	if( pDecodeAheadStream ){
+		pDecodeAheadStream->Stop();
+	}
+}
+
+int deoalASpeaker::pDecode( deoalDecodeBuffer &buffer ){
+	if( pDecodeAheadStream ){
+		if( pBufferSize > buffer.GetSize() ){
+			buffer.SetSize( pBufferSize );
+		}
+		return pDecodeAheadStream->Read( buffer.GetBuffer(), pBufferSize );
+	}
+	
+	if( pLooping ){
+		return buffer.DecodeLooping( pSoundDecoder, pBufferSize );
+		
+	}else{
+		return buffer.Decode( pSoundDecoder, pBufferSize );
+	}
+}
+
 void deoalASpeaker::pSynthInit(){
 	if( ! pSynthesizer ){
 		DETHROW( deeInvalidAction );
@@ -35,6 +35,8 @@ class deoalAudioThread;
 class deoalAMicrophone;
 class deoalASound;
 class deoalASynthesizerInstance;
+class deoalDecodeAheadStream;
+class deoalDecodeBuffer;
 class deoalAVideoPlayer;
 class deoalSource;
 class deoalAWorld;
@@ -61,6 +63,7 @@ private:
 	deoalAVideoPlayer *pVideoPlayer;
 	unsigned int pSourceUpdateTracker;
 	deSoundDecoderReference pSoundDecoder;
+	deoalDecodeAheadStream *pDecodeAheadStream;
 	
 	deSpeaker::eSpeakerType pSpeakerType;
 	decDVector pPosition;
@@ -429,6 +432,9 @@ private:
 	
 	void pDecodeInitial();
 	void pDecodeNext( bool underrun );
+	void pStartDecodeAhead();
+	void pStopDecodeAhead();
+	int pDecode( deoalDecodeBuffer &buffer );
 	void pSynthInit();
 	void pSynthNext( bool underrun );
 	void pVideoPlayerInit();
@@ -0,0 +1,100 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "deoalSimdRay.h"
+
+
+
+// Definitions
+////////////////
+
+// enlarge boxes by a small margin to not miss faces touching the box boundaries due to
+// floating point precision issues
+#define BOX_MARGIN 1e-4f
+
+// inverse direction used for axes the ray is parallel to. large enough to push entering
+// and leaving distances out of the segment range for origins outside the slab
+#define INV_DIRECTION_PARALLEL 1e30f
+
+
+
+// Class deoalSimdRay
+///////////////////////
+
+const float deoalSimdRay::PLANE_SLACK = 1e-3f;
+
+
+// Constructors and Destructors
+/////////////////////////////////
+
+deoalSimdRay::deoalSimdRay(){
+	int i;
+	for( i=0; i<3; i++ ){
+		pOrigin[ i ] = 0.0f;
+		pDirection[ i ] = 0.0f;
+		pInvDirection[ i ] = INV_DIRECTION_PARALLEL;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void deoalSimdRay::SetRay( const decVector &origin, const decVector &direction ){
+	pOrigin[ 0 ] = origin.x;
+	pOrigin[ 1 ] = origin.y;
+	pOrigin[ 2 ] = origin.z;
+	
+	pDirection[ 0 ] = direction.x;
+	pDirection[ 1 ] = direction.y;
+	pDirection[ 2 ] = direction.z;
+	
+	int i;
+	for( i=0; i<3; i++ ){
+		if( fabsf( pDirection[ i ] ) > FLOAT_SAFE_EPSILON ){
+			pInvDirection[ i ] = 1.0f / pDirection[ i ];
+			
+		}else{
+			pInvDirection[ i ] = INV_DIRECTION_PARALLEL;
+		}
+	}
+}
+
+void deoalSimdRay::ClearBox( sBoxes &boxes, int index ){
+	// inverted boxes would be hit by every ray with the slab test. use instead a point
+	// located far outside any reachable area
+	boxes.minX[ index ] = 1e30f;
+	boxes.minY[ index ] = 1e30f;
+	boxes.minZ[ index ] = 1e30f;
+	boxes.maxX[ index ] = 1e30f;
+	boxes.maxY[ index ] = 1e30f;
+	boxes.maxZ[ index ] = 1e30f;
+}
+
+void deoalSimdRay::SetBox( sBoxes &boxes, int index, const decVector &center, const decVector &halfSize ){
+	boxes.minX[ index ] = center.x - halfSize.x - BOX_MARGIN;
+	boxes.minY[ index ] = center.y - halfSize.y - BOX_MARGIN;
+	boxes.minZ[ index ] = center.z - halfSize.z - BOX_MARGIN;
+	boxes.maxX[ index ] = center.x + halfSize.x + BOX_MARGIN;
+	boxes.maxY[ index ] = center.y + halfSize.y + BOX_MARGIN;
+	boxes.maxZ[ index ] = center.z + halfSize.z + BOX_MARGIN;
+}
@@ -0,0 +1,214 @@
+/* 
+ * Drag[en]gine OpenAL Audio Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOALSIMDRAY_H_
+#define _DEOALSIMDRAY_H_
+
+#include <dragengine/common/math/decMath.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+
+/**
+ * \brief Ray test against four boxes or face planes at once.
+ * 
+ * Used by wide BVH traversal. Boxes and face planes are stored in structure of arrays
+ * layout. If SSE is available the tests use SSE instructions otherwise a scalar fallback
+ * with the same results is used.
+ * 
+ * The ray is a segment from the origin to origin plus direction. Distances are given in
+ * the range from 0 to 1 along the segment.
+ */
+class deoalSimdRay{
+public:
+	/** \brief Slack in meters added to face plane tests. */
+	static const float PLANE_SLACK;
+	
+	/** \brief Four boxes in structure of arrays layout. */
+	struct sBoxes{
+		float minX[ 4 ];
+		float minY[ 4 ];
+		float minZ[ 4 ];
+		float maxX[ 4 ];
+		float maxY[ 4 ];
+		float maxZ[ 4 ];
+	};
+	
+	
+	
+private:
+	float pOrigin[ 3 ];
+	float pDirection[ 3 ];
+	float pInvDirection[ 3 ];
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create ray. */
+	deoalSimdRay();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Set ray. */
+	void SetRay( const decVector &origin, const decVector &direction );
+	
+	/** \brief Set box to never be hit. */
+	static void ClearBox( sBoxes &boxes, int index );
+	
+	/** \brief Set box from center and half size enlarged by a small margin. */
+	static void SetBox( sBoxes &boxes, int index, const decVector &center, const decVector &halfSize );
+	
+	/**
+	 * \brief Test ray against boxes.
+	 * \param[in] boxes Boxes to test.
+	 * \param[out] distances Distance along ray the box is entered for boxes hit.
+	 * \returns Bit mask of boxes hit.
+	 */
+	inline int RayHitsBoxes( const sBoxes &boxes, float *distances ) const{
+#ifdef __SSE__
+		const __m128 originX = _mm_set1_ps( pOrigin[ 0 ] );
+		const __m128 originY = _mm_set1_ps( pOrigin[ 1 ] );
+		const __m128 originZ = _mm_set1_ps( pOrigin[ 2 ] );
+		const __m128 invDirX = _mm_set1_ps( pInvDirection[ 0 ] );
+		const __m128 invDirY = _mm_set1_ps( pInvDirection[ 1 ] );
+		const __m128 invDirZ = _mm_set1_ps( pInvDirection[ 2 ] );
+		
+		const __m128 x1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxes.minX ), originX ), invDirX );
+		const __m128 x2 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxes.maxX ), originX ), invDirX );
+		const __m128 y1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxes.minY ), originY ), invDirY );
+		const __m128 y2 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxes.maxY ), originY ), invDirY );
+		const __m128 z1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxes.minZ ), originZ ), invDirZ );
+		const __m128 z2 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxes.maxZ ), originZ ), invDirZ );
+		
+		const __m128 enter = _mm_max_ps( _mm_max_ps( _mm_min_ps( x1, x2 ), _mm_min_ps( y1, y2 ) ),
+			_mm_max_ps( _mm_min_ps( z1, z2 ), _mm_setzero_ps() ) );
+		const __m128 leave = _mm_min_ps( _mm_min_ps( _mm_max_ps( x1, x2 ), _mm_max_ps( y1, y2 ) ),
+			_mm_min_ps( _mm_max_ps( z1, z2 ), _mm_set1_ps( 1.0f ) ) );
+		
+		_mm_storeu_ps( distances, enter );
+		return _mm_movemask_ps( _mm_cmple_ps( enter, leave ) );
+		
+#else
+		int i, mask = 0;
+		
+		for( i=0; i<4; i++ ){
+			const float x1 = ( boxes.minX[ i ] - pOrigin[ 0 ] ) * pInvDirection[ 0 ];
+			const float x2 = ( boxes.maxX[ i ] - pOrigin[ 0 ] ) * pInvDirection[ 0 ];
+			const float y1 = ( boxes.minY[ i ] - pOrigin[ 1 ] ) * pInvDirection[ 1 ];
+			const float y2 = ( boxes.maxY[ i ] - pOrigin[ 1 ] ) * pInvDirection[ 1 ];
+			const float z1 = ( boxes.minZ[ i ] - pOrigin[ 2 ] ) * pInvDirection[ 2 ];
+			const float z2 = ( boxes.maxZ[ i ] - pOrigin[ 2 ] ) * pInvDirection[ 2 ];
+			
+			const float enter = decMath::max( decMath::max( decMath::min( x1, x2 ),
+				decMath::min( y1, y2 ) ), decMath::max( decMath::min( z1, z2 ), 0.0f ) );
+			const float leave = decMath::min( decMath::min( decMath::max( x1, x2 ),
+				decMath::max( y1, y2 ) ), decMath::min( decMath::max( z1, z2 ), 1.0f ) );
+			
+			distances[ i ] = enter;
+			if( enter <= leave ){
+				mask |= 1 << i;
+			}
+		}
+		
+		return mask;
+#endif
+	}
+	
+	/**
+	 * \brief Test ray against face planes.
+	 * 
+	 * Conservative pre-test for the exact face test done by the caller. Faces are reported
+	 * if the ray is not parallel to the face and the plane is hit inside the distance range.
+	 * 
+	 * \param[in] normalX Face normal x coordinates. At least 4 values are read.
+	 * \param[in] normalY Face normal y coordinates. At least 4 values are read.
+	 * \param[in] normalZ Face normal z coordinates. At least 4 values are read.
+	 * \param[in] distance Face plane distances. At least 4 values are read.
+	 * \param[in] count Number of faces to test in the range from 1 to 4.
+	 * \param[in] maxDistance Maximum hit distance.
+	 * \returns Bit mask of face planes hit.
+	 */
+	inline int RayHitsFacePlanes( const float *normalX, const float *normalY, const float *normalZ,
+	const float *distance, int count, float maxDistance ) const{
+#ifdef __SSE__
+		const __m128 nx = _mm_loadu_ps( normalX );
+		const __m128 ny = _mm_loadu_ps( normalY );
+		const __m128 nz = _mm_loadu_ps( normalZ );
+		
+		const __m128 dot = _mm_add_ps( _mm_add_ps(
+			_mm_mul_ps( nx, _mm_set1_ps( pDirection[ 0 ] ) ),
+			_mm_mul_ps( ny, _mm_set1_ps( pDirection[ 1 ] ) ) ),
+			_mm_mul_ps( nz, _mm_set1_ps( pDirection[ 2 ] ) ) );
+		const __m128 numerator = _mm_sub_ps( _mm_loadu_ps( distance ), _mm_add_ps( _mm_add_ps(
+			_mm_mul_ps( nx, _mm_set1_ps( pOrigin[ 0 ] ) ),
+			_mm_mul_ps( ny, _mm_set1_ps( pOrigin[ 1 ] ) ) ),
+			_mm_mul_ps( nz, _mm_set1_ps( pOrigin[ 2 ] ) ) ) );
+		
+		// numerator and dot have the same sign if lambda >= 0. compare |numerator| against
+		// |dot| * maxDistance instead of dividing. the plane distance slack keeps the test
+		// conservative against rounding differences to the exact test
+		const __m128 signMask = _mm_set1_ps( -0.0f );
+		const __m128 absDot = _mm_andnot_ps( signMask, dot );
+		const __m128 absNumerator = _mm_andnot_ps( signMask, numerator );
+		const __m128 slack = _mm_set1_ps( PLANE_SLACK );
+		
+		const __m128 sameSide = _mm_cmpge_ps( _mm_mul_ps( numerator, dot ),
+			_mm_sub_ps( _mm_setzero_ps(), _mm_mul_ps( absDot, slack ) ) );
+		const __m128 inRange = _mm_cmple_ps( absNumerator,
+			_mm_add_ps( _mm_mul_ps( absDot, _mm_set1_ps( maxDistance ) ), slack ) );
+		const __m128 notParallel = _mm_cmpge_ps( absDot, _mm_set1_ps( FLOAT_SAFE_EPSILON * 0.5f ) );
+		
+		const int mask = _mm_movemask_ps( _mm_and_ps( _mm_and_ps( sameSide, inRange ), notParallel ) );
+		return mask & ( ( 1 << count ) - 1 );
+		
+#else
+		int i, mask = 0;
+		
+		for( i=0; i<count; i++ ){
+			const float dot = normalX[ i ] * pDirection[ 0 ] + normalY[ i ] * pDirection[ 1 ]
+				+ normalZ[ i ] * pDirection[ 2 ];
+			const float absDot = fabsf( dot );
+			if( absDot < FLOAT_SAFE_EPSILON * 0.5f ){
+				continue;
+			}
+			
+			const float numerator = distance[ i ] - ( normalX[ i ] * pOrigin[ 0 ]
+				+ normalY[ i ] * pOrigin[ 1 ] + normalZ[ i ] * pOrigin[ 2 ] );
+			if( numerator * dot >= -absDot * PLANE_SLACK
+			&& fabsf( numerator ) <= absDot * maxDistance + PLANE_SLACK ){
+				mask |= 1 << i;
+			}
+		}
+		
+		return mask;
+#endif
+	}
+	/*@}*/
+};
+
+#endif
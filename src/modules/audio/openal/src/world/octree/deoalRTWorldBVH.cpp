@@ -50,6 +50,9 @@ pBuildComponentSize( 0 ),
 pVisitNodes( NULL ),
 pVisitNodeCount( 0 ),
 pVisitNodeSize( 0 ),
+pWideVisitNodes( NULL ),
+pWideVisitNodeCount( 0 ),
+pWideVisitNodeSize( 0 ),
 pVisitComponents( NULL ),
 pVisitComponentCount( 0 ),
 pVisitComponentSize( 0 ){
@@ -59,6 +62,9 @@ deoalRTWorldBVH::~deoalRTWorldBVH(){
 	if( pVisitComponents ){
 		delete [] pVisitComponents;
 	}
+	if( pWideVisitNodes ){
+		delete [] pWideVisitNodes;
+	}
 	if( pVisitNodes ){
 		delete [] pVisitNodes;
 	}
@@ -78,6 +84,7 @@ deoalRTWorldBVH::~deoalRTWorldBVH(){
 void deoalRTWorldBVH::Build( const decDVector &position ){
 	pVisitComponentCount = 0;
 	pVisitNodeCount = 0;
+	pWideVisitNodeCount = 0;
 	pBuildComponentCount = 0;
 	pBuildNodeCount = 0;
 	
@@ -103,6 +110,7 @@ void deoalRTWorldBVH::Finish(){
 	if( pBuildComponentCount == 0 ){
 		pVisitComponentCount = 0;
 		pVisitNodeCount = 0;
+		pWideVisitNodeCount = 0;
 		return;
 	}
 	
@@ -150,6 +158,19 @@ void deoalRTWorldBVH::Finish(){
 	pIndexComponent = 0;
 	pWorldMatrix.SetTranslation( pPosition );
 	pBuildVisitNode( pBuildNodes[ 0 ] );
+	
+	// build wide visit nodes. there are never more wide nodes than visit nodes
+	if( pVisitNodeCount > pWideVisitNodeSize ){
+		sWideVisitNode * const nodes = new sWideVisitNode[ pVisitNodeCount ];
+		if( pWideVisitNodes ){
+			delete [] pWideVisitNodes;
+		}
+		pWideVisitNodes = nodes;
+		pWideVisitNodeSize = pVisitNodeCount;
+	}
+	
+	pWideVisitNodeCount = 0;
+	pBuildWideVisitNode( 0 );
 }
 
 
@@ -416,3 +437,74 @@ void deoalRTWorldBVH::pBuildVisitNode( const sBuildNode &buildNode ){
 		DETHROW( deeInvalidParam );
 	}
 }
+
+int deoalRTWorldBVH::pBuildWideVisitNode( int nodeIndex ){
+	// collect up to 4 children by opening the inner child with the largest surface area
+	// until no more child can be opened. if the node is a leaf it becomes the only child
+	int children[ 4 ];
+	int childCount = 0;
+	int i;
+	
+	if( pVisitNodes[ nodeIndex ].componentCount > 0 ){
+		children[ childCount++ ] = nodeIndex;
+		
+	}else{
+		children[ childCount++ ] = pVisitNodes[ nodeIndex ].node1;
+		children[ childCount++ ] = pVisitNodes[ nodeIndex ].node2;
+	}
+	
+	while( childCount < 4 ){
+		float bestArea = 0.0f;
+		int bestChild = -1;
+		
+		for( i=0; i<childCount; i++ ){
+			const sVisitNode &child = pVisitNodes[ children[ i ] ];
+			if( child.componentCount > 0 ){
+				continue;
+			}
+			
+			const float area = child.halfSize.x * child.halfSize.y
+				+ child.halfSize.y * child.halfSize.z + child.halfSize.z * child.halfSize.x;
+			if( bestChild == -1 || area > bestArea ){
+				bestArea = area;
+				bestChild = i;
+			}
+		}
+		
+		if( bestChild == -1 ){
+			break;
+		}
+		
+		const sVisitNode &child = pVisitNodes[ children[ bestChild ] ];
+		children[ bestChild ] = child.node1;
+		children[ childCount++ ] = child.node2;
+	}
+	
+	// store children. wide nodes are preallocated so references stay valid
+	const int wideIndex = pWideVisitNodeCount++;
+	sWideVisitNode &wideNode = pWideVisitNodes[ wideIndex ];
+	
+	for( i=0; i<4; i++ ){
+		wideNode.node[ i ] = -1;
+		wideNode.firstComponent[ i ] = 0;
+		wideNode.componentCount[ i ] = 0;
+		
+		if( i >= childCount ){
+			deoalSimdRay::ClearBox( wideNode.bounds, i );
+			continue;
+		}
+		
+		const sVisitNode &child = pVisitNodes[ children[ i ] ];
+		deoalSimdRay::SetBox( wideNode.bounds, i, child.center, child.halfSize );
+		
+		if( child.componentCount > 0 ){
+			wideNode.firstComponent[ i ] = child.firstComponent;
+			wideNode.componentCount[ i ] = child.componentCount;
+			
+		}else{
+			wideNode.node[ i ] = pBuildWideVisitNode( children[ i ] );
+		}
+	}
+	
+	return wideIndex;
+}
@@ -24,6 +24,8 @@
 
 #include <dragengine/common/math/decMath.h>
 
+#include "../../utils/deoalSimdRay.h"
+
 class deoalAComponent;
 
 
@@ -64,6 +66,20 @@ public:
 		int componentCount;
 	};
 	
+	/**
+	 * \brief Wide BVH node used for visiting tree.
+	 * 
+	 * Collapsed from up to 4 visit nodes. Children with a node index of -1 are leaves
+	 * containing componentCount components starting at firstComponent. Unused children
+	 * have no components and bounds never hit by rays.
+	 */
+	struct sWideVisitNode{
+		deoalSimdRay::sBoxes bounds;
+		int node[ 4 ];
+		int firstComponent[ 4 ];
+		int componentCount[ 4 ];
+	};
+	
 	/** \brief Component used for visiting tree. */
 	struct sVisitComponent{
 		decVector center;
@@ -89,6 +105,10 @@ private:
 	int pVisitNodeCount;
 	int pVisitNodeSize;
 	
+	sWideVisitNode *pWideVisitNodes;
+	int pWideVisitNodeCount;
+	int pWideVisitNodeSize;
+	
 	sVisitComponent *pVisitComponents;
 	int pVisitComponentCount;
 	int pVisitComponentSize;
@@ -144,6 +164,12 @@ public:
 	/** \brief Visit node count. */
 	inline int GetVisitNodeCount() const{ return pVisitNodeCount; }
 	
+	/** \brief Wide visit nodes array. First node is the root node. */
+	inline const sWideVisitNode *GetWideVisitNodes() const{ return pWideVisitNodes; }
+	
+	/** \brief Wide visit node count. */
+	inline int GetWideVisitNodeCount() const{ return pWideVisitNodeCount; }
+	
 	/** \brief Visit components array. */
 	inline const sVisitComponent *GetVisitComponents() const{ return pVisitComponents; }
 	
@@ -160,6 +186,7 @@ private:
 	void pSplitNode( int nodeIndex );
 	void pNodeAddComponent( sBuildNode &node, int componentIndex );
 	void pBuildVisitNode( const sBuildNode &buildNode );
+	int pBuildWideVisitNode( int nodeIndex );
 };
 
 #endif
@@ -78,6 +78,8 @@ void deoalRTWorldBVHVisitor::SetRay( const decVector &origin, const decVector &d
 	pRayBoxMin = pRayOrigin.Smallest( pRayTarget ) - margin;
 	pRayBoxMax = pRayOrigin.Largest( pRayTarget ) + margin;
 	
+	pSimdRay.SetRay( origin, direction );
+	
 // 	pRayNormDir = pRayDirection / pRayLength;
 // 	pSphereDot = -( origin * pRayNormDir );
 }
@@ -90,8 +92,8 @@ const decDVector &origin, const decDVector &direction ){
 
 
 void deoalRTWorldBVHVisitor::VisitBVH( const deoalRTWorldBVH &bvh ){
-	if( bvh.GetVisitNodeCount() > 0 ){
-		pVisitNode( bvh, bvh.GetVisitNodes()[ 0 ] );
+	if( bvh.GetWideVisitNodeCount() > 0 ){
+		pVisitNode( bvh, bvh.GetWideVisitNodes()[ 0 ] );
 	}
 }
 
@@ -104,31 +106,31 @@ void deoalRTWorldBVHVisitor::VisitComponent( const deoalRTWorldBVH::sVisitCompon
 ////////////////////////
 
 void deoalRTWorldBVHVisitor::pVisitNode( const deoalRTWorldBVH &bvh,
-const deoalRTWorldBVH::sVisitNode &node ){
-	// visit components
-	if( node.componentCount > 0 ){
-		const deoalRTWorldBVH::sVisitComponent * const components =
-			bvh.GetVisitComponents() + node.firstComponent;
-		int i;
-		
-		for( i=0; i<node.componentCount; i++ ){
-			const deoalRTWorldBVH::sVisitComponent &component = components[ i ];
-			if( /*pRayHitsSphere( component.sphereCenter, component.sphereRadiusSquared )
-			&& */pRayHitsBox( component.center, component.halfSize ) ){
-				VisitComponent( component );
-			}
+const deoalRTWorldBVH::sWideVisitNode &node ){
+	float distances[ 4 ];
+	const int mask = pSimdRay.RayHitsBoxes( node.bounds, distances );
+	int i, j;
+	
+	for( i=0; i<4; i++ ){
+		if( ( mask & ( 1 << i ) ) == 0 ){
+			continue;
 		}
 		
-	// visit child nodes if hit by ray
-	}else{
-		const deoalRTWorldBVH::sVisitNode &child1 = bvh.GetVisitNodes()[ node.node1 ];
-		if( pRayHitsBox( child1.center, child1.halfSize ) ){
-			pVisitNode( bvh, child1 );
+		// visit child nodes if hit by ray
+		if( node.node[ i ] != -1 ){
+			pVisitNode( bvh, bvh.GetWideVisitNodes()[ node.node[ i ] ] );
+			continue;
 		}
 		
-		const deoalRTWorldBVH::sVisitNode &child2 = bvh.GetVisitNodes()[ node.node2 ];
-		if( pRayHitsBox( child2.center, child2.halfSize ) ){
-			pVisitNode( bvh, child2 );
+		// visit components
+		const deoalRTWorldBVH::sVisitComponent * const components =
+			bvh.GetVisitComponents() + node.firstComponent[ i ];
+		
+		for( j=0; j<node.componentCount[ i ]; j++ ){
+			const deoalRTWorldBVH::sVisitComponent &component = components[ j ];
+			if( pRayHitsBox( component.center, component.halfSize ) ){
+				VisitComponent( component );
+			}
 		}
 	}
 }
@@ -44,6 +44,8 @@ private:
 	decVector pRayBoxMin;
 	decVector pRayBoxMax;
 	
+	deoalSimdRay pSimdRay;
+	
 // 	decVector pRayNormDir;
 // 	float pSphereDot;
 	
@@ -94,6 +96,9 @@ public:
 	/** \brief Ray box maximum extend. */
 	inline const decVector &GetRayBoxMax() const{ return pRayBoxMax; }
 	
+	/** \brief Ray for testing wide BVH nodes. */
+	inline const deoalSimdRay &GetSimdRay() const{ return pSimdRay; }
+	
 	/** \brief Set test ray. */
 	void SetRay( const decVector &origin, const decVector &direction );
 	
@@ -112,7 +117,7 @@ public:
 	
 	
 protected:
-	void pVisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sVisitNode &node );
+	void pVisitNode( const deoalRTWorldBVH &bvh, const deoalRTWorldBVH::sWideVisitNode &node );
 	bool pRayHitsBox( const decVector &center, const decVector &halfExtends ) const;
 // 	bool pRayHitsSphere( const decVector &center, float radiusSquared ) const;
 	bool pRayHitsBox( const decVector &center, const decVector &halfExtends, float &closestDistance ) const;
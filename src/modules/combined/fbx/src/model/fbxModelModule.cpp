@@ -117,6 +117,7 @@ void fbxModelModule::LoadModel( decBaseFileReader &reader, deModel &model ){
 	try{
 		fbxScene scene( reader );
 		scene.Prepare( *this );
+		scene.DecompressArrays( *this );
 		//scene.DebugPrintStructure( *this, true );
 		
 		pLoadModel( model, scene );
@@ -40,7 +40,6 @@
 
 #include <dragengine/common/exceptions.h>
 #include <dragengine/common/file/decBaseFileReader.h>
-#include <dragengine/common/file/decZFileReader.h>
 
 
 // Class fbxProperty
@@ -269,30 +268,3 @@ const char *fbxProperty::DebugTypeName() const{
 		return "??";
 	}
 }
-
-
-
-// Protected Functions
-////////////////////////
-
-void fbxProperty::pGetValueReader( decBaseFileReader &reader, decBaseFileReaderReference& valueReader ){
-	const int encoding = reader.ReadUInt();
-	const int compressedLength = reader.ReadUInt();
-	
-	switch( encoding ){
-	case 0: // plain
-		valueReader = &reader;
-		break;
-		
-	case 1: // z-lib encoded
-		(void)compressedLength;
-		valueReader.TakeOver( new decZFileReader( &reader, true, compressedLength ) );
-		break;
-		
-	default:{
-		decString message( "unknown encoding: " );
-		message.AppendValue( encoding );
-		DETHROW_INFO( deeInvalidFileFormat, message );
-		}
-	}
-}
@@ -25,7 +25,6 @@
 #include <stdint.h>
 
 #include <dragengine/deObject.h>
-#include <dragengine/common/file/decBaseFileReaderReference.h>
 #include <dragengine/common/math/decMath.h>
 #include <dragengine/common/string/decString.h>
 
@@ -150,11 +149,6 @@ public:
 	/** \brief Debug type names. */
 	const char *DebugTypeName() const;
 	/*@}*/
-	
-	
-	
-protected:
-	void pGetValueReader( decBaseFileReader &reader, decBaseFileReaderReference &valueReader );
 };
 
 #endif
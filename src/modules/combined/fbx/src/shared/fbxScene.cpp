@@ -30,15 +30,20 @@
 #include "fbxProperty.h"
 #include "fbxObjectMap.h"
 #include "fbxConnectionMap.h"
+#include "property/fbxPropertyArray.h"
+#include "property/fbxPropertyArrayDecompressTask.h"
 #include "property/fbxPropertyString.h"
 
 #include <dragengine/deEngine.h>
 #include <dragengine/deObjectReference.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
 #include <dragengine/common/file/decBaseFileReader.h>
 #include <dragengine/common/file/decBaseFileWriter.h>
 #include <dragengine/common/math/decMath.h>
+#include <dragengine/parallel/deParallelProcessing.h>
 #include <dragengine/systems/modules/deBaseModule.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
 
 
 
@@ -49,6 +54,9 @@
 #define FBX_UNIT_SCALE 0.01f
 // #define FBX_UNIT_SCALE 1.0f
 
+// minimum compressed length in bytes of all arrays to decompress them in parallel
+#define PARALLEL_DECOMPRESS_LENGTH 262144
+
 
 // Class fbxScene
 ///////////////////
@@ -466,6 +474,66 @@ void fbxScene::Prepare( deBaseModule &module ){
 	}
 }
 
+void fbxScene::DecompressArrays( deBaseModule &module ){
+	decPointerList arrays;
+	int length = 0;
+	pCollectCompressedArrays( *pNode, arrays, length );
+	
+	const int arrayCount = arrays.GetCount();
+	int i;
+	
+	deParallelProcessing &parallelProcessing = module.GetGameEngine()->GetParallelProcessing();
+	
+	if( arrayCount > 1 && length >= PARALLEL_DECOMPRESS_LENGTH
+	&& parallelProcessing.GetCoreCount() > 1 && ! parallelProcessing.GetPaused() ){
+		const int taskLength = decMath::max( PARALLEL_DECOMPRESS_LENGTH / 4,
+			length / ( parallelProcessing.GetCoreCount() * 2 ) );
+		decThreadSafeObjectOrderedSet tasks;
+		deThreadSafeObjectReference task;
+		
+		try{
+			for( i=0; i<arrayCount; i++ ){
+				if( ! task ){
+					task.TakeOver( new fbxPropertyArrayDecompressTask( &module ) );
+				}
+				
+				fbxPropertyArrayDecompressTask &decompressTask = *( ( fbxPropertyArrayDecompressTask* )
+					( deThreadSafeObject* )task );
+				decompressTask.AddArray( ( fbxPropertyArray* )arrays.GetAt( i ) );
+				
+				if( decompressTask.GetCompressedLength() >= taskLength ){
+					tasks.Add( task );
+					parallelProcessing.AddTask( &decompressTask );
+					task = NULL;
+				}
+			}
+			
+			if( task ){
+				tasks.Add( task );
+				parallelProcessing.AddTask( ( fbxPropertyArrayDecompressTask* )( deThreadSafeObject* )task );
+				task = NULL;
+			}
+			
+		}catch( const deException & ){
+			const int count = tasks.GetCount();
+			for( i=0; i<count; i++ ){
+				parallelProcessing.WaitForTask( ( fbxPropertyArrayDecompressTask* )tasks.GetAt( i ) );
+			}
+			throw;
+		}
+		
+		const int count = tasks.GetCount();
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( fbxPropertyArrayDecompressTask* )tasks.GetAt( i ) );
+		}
+	}
+	
+	// decompress arrays not decompressed by tasks. if a task failed this reports the error
+	for( i=0; i<arrayCount; i++ ){
+		( ( fbxPropertyArray* )arrays.GetAt( i ) )->Decompress();
+	}
+}
+
 void fbxScene::Save(decBaseFileWriter &writer ){
 }
 
@@ -489,3 +557,34 @@ fbxScene::eAxis fbxScene::pGetAxis( int axisType, int axisSign ) const{
 		DETHROW_INFO( deeInvalidParam, "invalid axis type" );
 	}
 }
+
+void fbxScene::pCollectCompressedArrays( const fbxNode &node, decPointerList &arrays, int &length ) const{
+	const int propertyCount = node.GetPropertyCount();
+	int i;
+	
+	for( i=0; i<propertyCount; i++ ){
+		fbxProperty * const property = node.GetPropertyAt( i );
+		
+		switch( property->GetType() ){
+		case fbxProperty::etArrayBoolean:
+		case fbxProperty::etArrayInteger:
+		case fbxProperty::etArrayLong:
+		case fbxProperty::etArrayFloat:
+		case fbxProperty::etArrayDouble:{
+			fbxPropertyArray * const array = ( fbxPropertyArray* )property;
+			if( array->GetCompressed() ){
+				arrays.Add( array );
+				length += array->GetCompressedLength();
+			}
+			}break;
+			
+		default:
+			break;
+		}
+	}
+	
+	const int nodeCount = node.GetNodeCount();
+	for( i=0; i<nodeCount; i++ ){
+		pCollectCompressedArrays( *node.GetNodeAt( i ), arrays, length );
+	}
+}
@@ -191,6 +191,14 @@ public:
 	/** \brief Prepare after reading. */
 	void Prepare( deBaseModule &module );
 	
+	/**
+	 * \brief Decompress all compressed array properties.
+	 * 
+	 * Uses parallel tasks if worth the effort. Otherwise arrays are decompressed on
+	 * first access. Call if most arrays are going to be accessed.
+	 */
+	void DecompressArrays( deBaseModule &module );
+	
 	/** \brief Save to file. */
 	void Save( decBaseFileWriter &writer );
 	
@@ -202,6 +210,7 @@ public:
 	
 private:
 	eAxis pGetAxis( int axisType, int axisSign ) const;
+	void pCollectCompressedArrays( const fbxNode &node, decPointerList &arrays, int &length ) const;
 };
 
 #endif
@@ -0,0 +1,144 @@
+/* 
+ * FBX Modules
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fbxPropertyArray.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/common/file/decBaseFileReaderReference.h>
+#include <dragengine/common/file/decMemoryFile.h>
+#include <dragengine/common/file/decMemoryFileReader.h>
+#include <dragengine/common/file/decZFileReader.h>
+
+
+
+// Class fbxPropertyArray
+///////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+fbxPropertyArray::fbxPropertyArray( eType type, int elementSize ) :
+fbxProperty( type ),
+pElementSize( elementSize ),
+pDecompressValues( NULL ),
+pDecompressCount( 0 ){
+}
+
+fbxPropertyArray::~fbxPropertyArray(){
+}
+
+
+
+// Management
+///////////////
+
+int fbxPropertyArray::GetCompressedLength() const{
+	return pCompressed ? pCompressed->GetLength() : 0;
+}
+
+void fbxPropertyArray::Decompress(){
+	if( ! pCompressed ){
+		return;
+	}
+	
+	decBaseFileReaderReference memoryReader;
+	memoryReader.TakeOver( new decMemoryFileReader( pCompressed ) );
+	
+	decBaseFileReaderReference valueReader;
+	valueReader.TakeOver( new decZFileReader( memoryReader, true, pCompressed->GetLength() ) );
+	valueReader->Read( pDecompressValues, pElementSize * pDecompressCount );
+	
+	pConvertByteOrder( pDecompressValues, pDecompressCount );
+	
+	pCompressed = NULL;
+	pDecompressValues = NULL;
+	pDecompressCount = 0;
+}
+
+
+
+// Protected Functions
+////////////////////////
+
+void fbxPropertyArray::pReadValues( decBaseFileReader &reader, void *values, int count ){
+	const int encoding = reader.ReadUInt();
+	const int compressedLength = reader.ReadUInt();
+	
+	if( count < 0 || compressedLength < 0 ){
+		DETHROW_INFO( deeInvalidFileFormat, "invalid array length" );
+	}
+	
+	switch( encoding ){
+	case 0: // plain
+		reader.Read( values, pElementSize * count );
+		pConvertByteOrder( values, count );
+		break;
+		
+	case 1: // z-lib encoded. kept compressed until accessed
+		if( count == 0 ){
+			reader.MovePosition( compressedLength );
+			break;
+		}
+		
+		pCompressed.TakeOver( new decMemoryFile( "fbxArray" ) );
+		pCompressed->Resize( compressedLength );
+		reader.Read( pCompressed->GetPointer(), compressedLength );
+		
+		pDecompressValues = values;
+		pDecompressCount = count;
+		break;
+		
+	default:{
+		decString message( "unknown encoding: " );
+		message.AppendValue( encoding );
+		DETHROW_INFO( deeInvalidFileFormat, message );
+		}
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void fbxPropertyArray::pConvertByteOrder( void *values, int count ){
+	#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	// values are stored little endian
+	if( pElementSize > 1 ){
+		uint8_t *bytes = ( uint8_t* )values;
+		int i, j;
+		
+		for( i=0; i<count; i++ ){
+			for( j=0; j<pElementSize/2; j++ ){
+				const uint8_t swap = bytes[ j ];
+				bytes[ j ] = bytes[ pElementSize - 1 - j ];
+				bytes[ pElementSize - 1 - j ] = swap;
+			}
+			bytes += pElementSize;
+		}
+	}
+	#endif
+}
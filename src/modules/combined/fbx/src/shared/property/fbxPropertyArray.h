@@ -0,0 +1,104 @@
+/* 
+ * FBX Modules
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _FBXPROPERTYARRAY_H_
+#define _FBXPROPERTYARRAY_H_
+
+
+#include "../fbxProperty.h"
+
+#include <dragengine/common/file/decMemoryFileReference.h>
+
+
+/**
+ * \brief FBX property array base class.
+ * 
+ * Reads array values with a single bulk read. Compressed arrays are kept compressed
+ * until the values are accessed the first time or Decompress() is called. Different
+ * arrays can be decompressed in parallel.
+ * 
+ * Subclasses allocate the value array and call pReadValues() from their load constructor.
+ * Value access has to call pEnsureDecompressed() first.
+ */
+class fbxPropertyArray : public fbxProperty{
+private:
+	int pElementSize;
+	decMemoryFileReference pCompressed;
+	void *pDecompressValues;
+	int pDecompressCount;
+	
+	
+	
+protected:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create property. */
+	fbxPropertyArray( eType type, int elementSize );
+	
+	/** \brief Clean up property. */
+	virtual ~fbxPropertyArray();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Values are still compressed. */
+	inline bool GetCompressed() const{ return pCompressed != NULL; }
+	
+	/** \brief Size of compressed data in bytes or 0 if not compressed. */
+	int GetCompressedLength() const;
+	
+	/**
+	 * \brief Decompress values if compressed.
+	 * 
+	 * Safe to call from worker threads as long as no other thread accesses this array.
+	 */
+	void Decompress();
+	/*@}*/
+	
+	
+	
+protected:
+	/**
+	 * \brief Read values.
+	 * \param[in] reader Reader positioned at the array encoding.
+	 * \param[out] values Array of count values to read into. Has to stay valid until
+	 *                    values are decompressed.
+	 * \param[in] count Number of values.
+	 */
+	void pReadValues( decBaseFileReader &reader, void *values, int count );
+	
+	/** \brief Decompress values if compressed. */
+	inline void pEnsureDecompressed() const{
+		if( pCompressed ){
+			( ( fbxPropertyArray* )this )->Decompress();
+		}
+	}
+	
+	
+	
+private:
+	void pConvertByteOrder( void *values, int count );
+};
+
+#endif
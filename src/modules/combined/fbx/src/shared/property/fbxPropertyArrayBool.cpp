@@ -41,31 +41,29 @@
 ////////////////////////////
 
 fbxPropertyArrayBool::fbxPropertyArrayBool() :
-fbxProperty( etArrayBoolean ),
+fbxPropertyArray( etArrayBoolean, sizeof( uint8_t ) ),
 pValues( NULL ),
-pCount( 0 ){
+pCount( 0 ),
+pSize( 0 ){
 }
 
 fbxPropertyArrayBool::fbxPropertyArrayBool( decBaseFileReader &reader ) :
-fbxProperty( etArrayBoolean ),
+fbxPropertyArray( etArrayBoolean, sizeof( uint8_t ) ),
 pValues( NULL ),
-pCount( 0 )
+pCount( 0 ),
+pSize( 0 )
 {
 	const int count = reader.ReadUInt();
 	
-	decBaseFileReaderReference valueReader;
-	pGetValueReader( reader, valueReader );
-	
-	if( count == 0 ){
-		return;
-	}
-	
 	try{
-		pValues = new bool[ count ];
-		for( pCount=0; pCount<count; pCount++ ){
-			pValues[ pCount ] = valueReader->ReadByte() != 0;
+		if( count > 0 ){
+			pValues = new uint8_t[ count ];
+			pSize = count;
 		}
 		
+		pReadValues( reader, pValues, count );
+		pCount = count;
+		
 	}catch( const deException & ){
 		if( pValues ){
 			delete [] pValues;
@@ -89,17 +87,25 @@ bool fbxPropertyArrayBool::GetValueAt( int index ) const{
 	if( index < 0 || index >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
-	return pValues[ index ];
+	pEnsureDecompressed();
+	return pValues[ index ] != 0;
 }
 
 void fbxPropertyArrayBool::AddValue( bool value ){
-	bool * const newArray = new bool[ pCount + 1 ];
-	if( pValues ){
-		memcpy( newArray, pValues, sizeof( bool ) * pCount );
-		delete [] pValues;
+	pEnsureDecompressed();
+	
+	if( pCount == pSize ){
+		const int newSize = pSize * 3 / 2 + 1;
+		uint8_t * const newArray = new uint8_t[ newSize ];
+		if( pValues ){
+			memcpy( newArray, pValues, sizeof( uint8_t ) * pCount );
+			delete [] pValues;
+		}
+		pValues = newArray;
+		pSize = newSize;
 	}
-	pValues = newArray;
-	pValues[ pCount++ ] = value;
+	
+	pValues[ pCount++ ] = value ? 1 : 0;
 }
 
 fbxPropertyArrayBool &fbxPropertyArrayBool::CastArrayBool(){
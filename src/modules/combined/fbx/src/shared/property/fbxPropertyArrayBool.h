@@ -23,16 +23,17 @@
 #define _FBXPROPERTYARRAYBOOL_H_
 
 
-#include "../fbxProperty.h"
+#include "fbxPropertyArray.h"
 
 
 /**
  * \brief FBX property array bool.
  */
-class fbxPropertyArrayBool : public fbxProperty{
+class fbxPropertyArrayBool : public fbxPropertyArray{
 private:
-	bool *pValues;
+	uint8_t *pValues;
 	int pCount;
+	int pSize;
 	
 	
 	
@@ -0,0 +1,94 @@
+/* 
+ * FBX Modules
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "fbxPropertyArray.h"
+#include "fbxPropertyArrayDecompressTask.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class fbxPropertyArrayDecompressTask
+/////////////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+fbxPropertyArrayDecompressTask::fbxPropertyArrayDecompressTask( deBaseModule *owner ) :
+deParallelTask( owner ),
+pCompressedLength( 0 ),
+pFailed( false ){
+}
+
+fbxPropertyArrayDecompressTask::~fbxPropertyArrayDecompressTask(){
+}
+
+
+
+// Management
+///////////////
+
+void fbxPropertyArrayDecompressTask::AddArray( fbxPropertyArray *array ){
+	if( ! array ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pArrays.Add( array );
+	pCompressedLength += array->GetCompressedLength();
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void fbxPropertyArrayDecompressTask::Run(){
+	try{
+		const int count = pArrays.GetCount();
+		int i;
+		for( i=0; i<count; i++ ){
+			( ( fbxPropertyArray* )pArrays.GetAt( i ) )->Decompress();
+		}
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void fbxPropertyArrayDecompressTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString fbxPropertyArrayDecompressTask::GetDebugName() const{
+	return "FBX-DecompressArrays";
+}
+
+decString fbxPropertyArrayDecompressTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "arrays=%d compressed=%d", pArrays.GetCount(), pCompressedLength );
+	return details;
+}
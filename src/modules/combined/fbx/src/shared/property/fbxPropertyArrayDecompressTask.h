@@ -0,0 +1,95 @@
+/* 
+ * FBX Modules
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _FBXPROPERTYARRAYDECOMPRESSTASK_H_
+#define _FBXPROPERTYARRAYDECOMPRESSTASK_H_
+
+#include <dragengine/common/collection/decPointerList.h>
+#include <dragengine/parallel/deParallelTask.h>
+
+class fbxPropertyArray;
+
+
+
+/**
+ * \brief Parallel task decompressing array properties.
+ * 
+ * If an exception is thrown the task is marked failed. Arrays not decompressed are
+ * decompressed on first access.
+ */
+class fbxPropertyArrayDecompressTask : public deParallelTask{
+private:
+	decPointerList pArrays;
+	int pCompressedLength;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create task. */
+	fbxPropertyArrayDecompressTask( deBaseModule *owner );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~fbxPropertyArrayDecompressTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Add array. Array has to stay valid until the task finished. */
+	void AddArray( fbxPropertyArray *array );
+	
+	/** \brief Compressed length in bytes of all arrays. */
+	inline int GetCompressedLength() const{ return pCompressedLength; }
+	
+	/** \brief Decompressing failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
@@ -41,31 +41,29 @@
 ////////////////////////////
 
 fbxPropertyArrayDouble::fbxPropertyArrayDouble() :
-fbxProperty( etArrayDouble ),
+fbxPropertyArray( etArrayDouble, sizeof( double ) ),
 pValues( NULL ),
-pCount( 0 ){
+pCount( 0 ),
+pSize( 0 ){
 }
 
 fbxPropertyArrayDouble::fbxPropertyArrayDouble( decBaseFileReader &reader ) :
-fbxProperty( etArrayDouble ),
+fbxPropertyArray( etArrayDouble, sizeof( double ) ),
 pValues( NULL ),
-pCount( 0 )
+pCount( 0 ),
+pSize( 0 )
 {
 	const int count = reader.ReadUInt();
 	
-	decBaseFileReaderReference valueReader;
-	pGetValueReader( reader, valueReader );
-	
-	if( count == 0 ){
-		return;
-	}
-	
 	try{
-		pValues = new double[ count ];
-		for( pCount=0; pCount<count; pCount++ ){
-			pValues[ pCount ] = valueReader->ReadDouble();
+		if( count > 0 ){
+			pValues = new double[ count ];
+			pSize = count;
 		}
 		
+		pReadValues( reader, pValues, count );
+		pCount = count;
+		
 	}catch( const deException & ){
 		if( pValues ){
 			delete [] pValues;
@@ -89,16 +87,24 @@ double fbxPropertyArrayDouble::GetValueAt( int index ) const{
 	if( index < 0 || index >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return pValues[ index ];
 }
 
 void fbxPropertyArrayDouble::AddValue( double value ){
-	double * const newArray = new double[ pCount + 1 ];
-	if( pValues ){
-		memcpy( newArray, pValues, sizeof( double ) * pCount );
-		delete [] pValues;
+	pEnsureDecompressed();
+	
+	if( pCount == pSize ){
+		const int newSize = pSize * 3 / 2 + 1;
+		double * const newArray = new double[ newSize ];
+		if( pValues ){
+			memcpy( newArray, pValues, sizeof( double ) * pCount );
+			delete [] pValues;
+		}
+		pValues = newArray;
+		pSize = newSize;
 	}
-	pValues = newArray;
+	
 	pValues[ pCount++ ] = value;
 }
 
@@ -135,6 +141,7 @@ decVector2 fbxPropertyArrayDouble::GetValueAtAsVector2( int index ) const{
 	if( begin < 0 || begin + 1 >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return decVector2( pValues[ begin ], pValues[ begin + 1 ] );
 }
 
@@ -143,6 +150,7 @@ decVector fbxPropertyArrayDouble::GetValueAtAsVector( int index ) const{
 	if( begin < 0 || begin + 2 >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return decVector( pValues[ begin ], pValues[ begin + 1 ], pValues[ begin + 2 ] );
 }
 
@@ -151,6 +159,7 @@ decMatrix fbxPropertyArrayDouble::GetValueAtAsMatrix( int index ) const{
 	if( begin < 0 || begin + 15 >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	
 	decMatrix matrix;
 	matrix.a11 = pValues[ begin ];
@@ -23,16 +23,17 @@
 #define _FBXPROPERTYARRAYDOUBLE_H_
 
 
-#include "../fbxProperty.h"
+#include "fbxPropertyArray.h"
 
 
 /**
  * \brief FBX property array integer.
  */
-class fbxPropertyArrayDouble : public fbxProperty{
+class fbxPropertyArrayDouble : public fbxPropertyArray{
 private:
 	double *pValues;
 	int pCount;
+	int pSize;
 	
 	
 	
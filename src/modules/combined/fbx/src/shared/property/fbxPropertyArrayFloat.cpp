@@ -41,31 +41,29 @@
 ////////////////////////////
 
 fbxPropertyArrayFloat::fbxPropertyArrayFloat() :
-fbxProperty( etArrayFloat ),
+fbxPropertyArray( etArrayFloat, sizeof( float ) ),
 pValues( NULL ),
-pCount( 0 ){
+pCount( 0 ),
+pSize( 0 ){
 }
 
 fbxPropertyArrayFloat::fbxPropertyArrayFloat( decBaseFileReader &reader ) :
-fbxProperty( etArrayFloat ),
+fbxPropertyArray( etArrayFloat, sizeof( float ) ),
 pValues( NULL ),
-pCount( 0 )
+pCount( 0 ),
+pSize( 0 )
 {
 	const int count = reader.ReadUInt();
 	
-	decBaseFileReaderReference valueReader;
-	pGetValueReader( reader, valueReader );
-	
-	if( count == 0 ){
-		return;
-	}
-	
 	try{
-		pValues = new float[ count ];
-		for( pCount=0; pCount<count; pCount++ ){
-			pValues[ pCount ] = valueReader->ReadFloat();
+		if( count > 0 ){
+			pValues = new float[ count ];
+			pSize = count;
 		}
 		
+		pReadValues( reader, pValues, count );
+		pCount = count;
+		
 	}catch( const deException & ){
 		if( pValues ){
 			delete [] pValues;
@@ -89,16 +87,24 @@ float fbxPropertyArrayFloat::GetValueAt( int index ) const{
 	if( index < 0 || index >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return pValues[ index ];
 }
 
 void fbxPropertyArrayFloat::AddValue( float value ){
-	float * const newArray = new float[ pCount + 1 ];
-	if( pValues ){
-		memcpy( newArray, pValues, sizeof( float ) * pCount );
-		delete [] pValues;
+	pEnsureDecompressed();
+	
+	if( pCount == pSize ){
+		const int newSize = pSize * 3 / 2 + 1;
+		float * const newArray = new float[ newSize ];
+		if( pValues ){
+			memcpy( newArray, pValues, sizeof( float ) * pCount );
+			delete [] pValues;
+		}
+		pValues = newArray;
+		pSize = newSize;
 	}
-	pValues = newArray;
+	
 	pValues[ pCount++ ] = value;
 }
 
@@ -135,6 +141,7 @@ decVector2 fbxPropertyArrayFloat::GetValueAtAsVector2( int index ) const{
 	if( begin < 0 || begin + 1 >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return decVector2( pValues[ begin ], pValues[ begin + 1 ] );
 }
 
@@ -143,6 +150,7 @@ decVector fbxPropertyArrayFloat::GetValueAtAsVector( int index ) const{
 	if( begin < 0 || begin + 2 >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return decVector( pValues[ begin ], pValues[ begin + 1 ], pValues[ begin + 2 ] );
 }
 
@@ -151,6 +159,7 @@ decMatrix fbxPropertyArrayFloat::GetValueAtAsMatrix( int index ) const{
 	if( begin < 0 || begin + 15 >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	
 	decMatrix matrix;
 	matrix.a11 = pValues[ begin ];
@@ -23,16 +23,17 @@
 #define _FBXPROPERTYARRAYFLOAT_H_
 
 
-#include "../fbxProperty.h"
+#include "fbxPropertyArray.h"
 
 
 /**
  * \brief FBX property array integer.
  */
-class fbxPropertyArrayFloat : public fbxProperty{
+class fbxPropertyArrayFloat : public fbxPropertyArray{
 private:
 	float *pValues;
 	int pCount;
+	int pSize;
 	
 	
 	
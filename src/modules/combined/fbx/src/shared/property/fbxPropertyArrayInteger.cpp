@@ -41,31 +41,29 @@
 ////////////////////////////
 
 fbxPropertyArrayInteger::fbxPropertyArrayInteger() :
-fbxProperty( etArrayInteger ),
+fbxPropertyArray( etArrayInteger, sizeof( int ) ),
 pValues( NULL ),
-pCount( 0 ){
+pCount( 0 ),
+pSize( 0 ){
 }
 
 fbxPropertyArrayInteger::fbxPropertyArrayInteger( decBaseFileReader &reader ) :
-fbxProperty( etArrayInteger ),
+fbxPropertyArray( etArrayInteger, sizeof( int ) ),
 pValues( NULL ),
-pCount( 0 )
+pCount( 0 ),
+pSize( 0 )
 {
 	const int count = reader.ReadUInt();
 	
-	decBaseFileReaderReference valueReader;
-	pGetValueReader( reader, valueReader );
-	
-	if( count == 0 ){
-		return;
-	}
-	
 	try{
-		pValues = new int[ count ];
-		for( pCount=0; pCount<count; pCount++ ){
-			pValues[ pCount ] = valueReader->ReadInt();
+		if( count > 0 ){
+			pValues = new int[ count ];
+			pSize = count;
 		}
 		
+		pReadValues( reader, pValues, count );
+		pCount = count;
+		
 	}catch( const deException & ){
 		if( pValues ){
 			delete [] pValues;
@@ -89,16 +87,24 @@ int fbxPropertyArrayInteger::GetValueAt( int index ) const{
 	if( index < 0 || index >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return pValues[ index ];
 }
 
 void fbxPropertyArrayInteger::AddValue( int value ){
-	int * const newArray = new int[ pCount + 1 ];
-	if( pValues ){
-		memcpy( newArray, pValues, sizeof( int ) * pCount );
-		delete [] pValues;
+	pEnsureDecompressed();
+	
+	if( pCount == pSize ){
+		const int newSize = pSize * 3 / 2 + 1;
+		int * const newArray = new int[ newSize ];
+		if( pValues ){
+			memcpy( newArray, pValues, sizeof( int ) * pCount );
+			delete [] pValues;
+		}
+		pValues = newArray;
+		pSize = newSize;
 	}
-	pValues = newArray;
+	
 	pValues[ pCount++ ] = value;
 }
 
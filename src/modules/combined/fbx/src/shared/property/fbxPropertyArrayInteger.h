@@ -23,16 +23,17 @@
 #define _FBXPROPERTYARRAYINTEGER_H_
 
 
-#include "../fbxProperty.h"
+#include "fbxPropertyArray.h"
 
 
 /**
  * \brief FBX property array integer.
  */
-class fbxPropertyArrayInteger : public fbxProperty{
+class fbxPropertyArrayInteger : public fbxPropertyArray{
 private:
 	int *pValues;
 	int pCount;
+	int pSize;
 	
 	
 	
@@ -41,31 +41,29 @@
 ////////////////////////////
 
 fbxPropertyArrayLong::fbxPropertyArrayLong() :
-fbxProperty( etArrayLong ),
+fbxPropertyArray( etArrayLong, sizeof( int64_t ) ),
 pValues( NULL ),
-pCount( 0 ){
+pCount( 0 ),
+pSize( 0 ){
 }
 
 fbxPropertyArrayLong::fbxPropertyArrayLong( decBaseFileReader &reader ) :
-fbxProperty( etArrayLong ),
+fbxPropertyArray( etArrayLong, sizeof( int64_t ) ),
 pValues( NULL ),
-pCount( 0 )
+pCount( 0 ),
+pSize( 0 )
 {
 	const int count = reader.ReadUInt();
 	
-	decBaseFileReaderReference valueReader;
-	pGetValueReader( reader, valueReader );
-	
-	if( count == 0 ){
-		return;
-	}
-	
 	try{
-		pValues = new int64_t[ count ];
-		for( pCount=0; pCount<count; pCount++ ){
-			pValues[ pCount ] = valueReader->ReadLong();
+		if( count > 0 ){
+			pValues = new int64_t[ count ];
+			pSize = count;
 		}
 		
+		pReadValues( reader, pValues, count );
+		pCount = count;
+		
 	}catch( const deException & ){
 		if( pValues ){
 			delete [] pValues;
@@ -89,16 +87,24 @@ int64_t fbxPropertyArrayLong::GetValueAt( int index ) const{
 	if( index < 0 || index >= pCount ){
 		DETHROW( deeInvalidParam );
 	}
+	pEnsureDecompressed();
 	return pValues[ index ];
 }
 
 void fbxPropertyArrayLong::AddValue( int64_t value ){
-	int64_t * const newArray = new int64_t[ pCount + 1 ];
-	if( pValues ){
-		memcpy( newArray, pValues, sizeof( int64_t ) * pCount );
-		delete [] pValues;
+	pEnsureDecompressed();
+	
+	if( pCount == pSize ){
+		const int newSize = pSize * 3 / 2 + 1;
+		int64_t * const newArray = new int64_t[ newSize ];
+		if( pValues ){
+			memcpy( newArray, pValues, sizeof( int64_t ) * pCount );
+			delete [] pValues;
+		}
+		pValues = newArray;
+		pSize = newSize;
 	}
-	pValues = newArray;
+	
 	pValues[ pCount++ ] = value;
 }
 
@@ -25,16 +25,17 @@
 
 #include <stdint.h>
 
-#include "../fbxProperty.h"
+#include "fbxPropertyArray.h"
 
 
 /**
  * \brief FBX property array integer.
  */
-class fbxPropertyArrayLong : public fbxProperty{
+class fbxPropertyArrayLong : public fbxPropertyArray{
 private:
 	int64_t *pValues;
 	int pCount;
+	int pSize;
 	
 	
 	
@@ -56,6 +56,7 @@
 #include "../vbo/deoglVBOLayout.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decSkinning.h>
 
 
 
@@ -1314,29 +1315,10 @@ void deoglRComponentLOD::pCalculateWeights( const deoglModelLOD &modelLOD ){
 #endif
 }
 
-void deoglRComponentLOD::pTransformVertices( const deoglModelLOD &modelLOD ){
-	const oglModelPosition * const positions = modelLOD.GetPositions();
-	const int positionCount = modelLOD.GetPositionCount();
-	int i;
-	
-	for( i=0; i<positionCount; i++ ){
-		const oglModelPosition &modelPosition = positions[ i ];
-		const decVector &orgpos = positions[ i ].position;
-		oglVector &trpos = pPositions[ i ];
-		
-		if( modelPosition.weight == -1 ){
-			trpos.x = orgpos.x;
-			trpos.y = orgpos.y;
-			trpos.z = orgpos.z;
-			
-		}else{
-			const oglMatrix3x4 &matrix = pWeights[ modelPosition.weight ];
-			
-			trpos.x = matrix.a11 * orgpos.x + matrix.a12 * orgpos.y + matrix.a13 * orgpos.z + matrix.a14;
-			trpos.y = matrix.a21 * orgpos.x + matrix.a22 * orgpos.y + matrix.a23 * orgpos.z + matrix.a24;
-			trpos.z = matrix.a31 * orgpos.x + matrix.a32 * orgpos.y + matrix.a33 * orgpos.z + matrix.a34;
-		}
-	}
+void deoglRComponentLOD::pTransformVertices( deoglModelLOD &modelLOD ){
+	modelLOD.PrepareSkinning();
+	modelLOD.GetSkinning()->Transform( &pWeights[ 0 ].a11, sizeof( oglMatrix3x4 ) / sizeof( GLfloat ),
+		&pPositions[ 0 ].x, sizeof( oglVector ) / sizeof( GLfloat ) );
 }
 
 void deoglRComponentLOD::pCalculateNormalsAndTangents( const deoglModelLOD &modelLOD ){
@@ -229,7 +229,7 @@ private:
 	void pUpdateVAO( deoglModelLOD &modelLOD );
 	
 	void pCalculateWeights( const deoglModelLOD &modelLOD );
-	void pTransformVertices( const deoglModelLOD &modelLOD );
+	void pTransformVertices( deoglModelLOD &modelLOD );
 	void pCalculateNormalsAndTangents( const deoglModelLOD &modelLOD );
 	
 	void pPrepareVBOLayout( const deoglModelLOD &modelLOD );
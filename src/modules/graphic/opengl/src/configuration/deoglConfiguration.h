@@ -159,6 +159,7 @@ private:
 	
 	bool pDebugNoCulling;
 	eOcclusionTestModes pOcclusionTestMode;
+	bool pSoftwareOcclusionTest;
 	
 	int pQuickDebug;
 	
@@ -504,6 +505,10 @@ public:
 	inline eOcclusionTestModes GetOcclusionTestMode() const{ return pOcclusionTestMode; }
 	/** Sets the occlusion test mode. */
 	void SetOcclusionTestMode( eOcclusionTestModes mode );
+	/** Determines if occluded elements are culled using a CPU rasterized occlusion map. */
+	inline bool GetSoftwareOcclusionTest() const{ return pSoftwareOcclusionTest; }
+	/** Sets if occluded elements are culled using a CPU rasterized occlusion map. */
+	void SetSoftwareOcclusionTest( bool enable );
 	
 	/** Retrieves the debug snapshot value. */
 	inline int GetDebugSnapshot() const{ return pDebugSnapshot; }
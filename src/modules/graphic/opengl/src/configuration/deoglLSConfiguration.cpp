@@ -360,6 +360,9 @@ void deoglLSConfiguration::pLoadConfigOpenGL( deoglConfiguration &configuration,
 					configuration.SetOcclusionTestMode( ( deoglConfiguration::eOcclusionTestModes )
 						strtol( tag->GetFirstData()->GetData(), NULL, 10 ) );
 					
+				}else if( strcmp( name, "softwareOcclusionTest" ) == 0 ){
+					configuration.SetSoftwareOcclusionTest( strtol( tag->GetFirstData()->GetData(), NULL, 10 ) != 0 );
+					
 				}else if( strcmp( name, "disableCubeMapLinearFiltering" ) == 0 ){
 					configuration.SetDisableCubeMapLinearFiltering( strtol( tag->GetFirstData()->GetData(), NULL, 10 ) != 0 );
 					
@@ -66,6 +66,7 @@
 #include "parameters/debug/deoglPDebugUseShadow.h"
 #include "parameters/debug/deoglPQuickDebug.h"
 #include "parameters/debug/deoglPShowLightCB.h"
+#include "parameters/debug/deoglPSoftwareOcclusionTest.h"
 #include "parameters/debug/deoglPOcclusionReduction.h"
 #include "parameters/debug/deoglPOccTestMode.h"
 #include "parameters/debug/deoglPWireframeMode.h"
@@ -631,6 +632,7 @@ void deGraphicOpenGl::pCreateParameters() {
 	pParameters.AddParameter( new deoglPOccTestMode( *this ) );
 	pParameters.AddParameter( new deoglPQuickDebug( *this ) );
 	pParameters.AddParameter( new deoglPShowLightCB( *this ) );
+	pParameters.AddParameter( new deoglPSoftwareOcclusionTest( *this ) );
 	pParameters.AddParameter( new deoglPWireframeMode( *this ) );
 #endif
 }
@@ -43,7 +43,8 @@
 deoglCaches::deoglCaches( deGraphicOpenGl &ogl ) :
 pOgl( ogl ),
 pSkinTextures( NULL ),
-pModels( NULL )
+pModels( NULL ),
+pShaders( NULL )
 {
 	(void)pOgl;
 	
@@ -54,6 +55,9 @@ pModels( NULL )
 		pModels = new deCacheHelper( &ogl.GetVFS(),
 			decPath::CreatePathUnix( "/cache/local/models" ) );
 		
+		pShaders = new deCacheHelper( &ogl.GetVFS(),
+			decPath::CreatePathUnix( "/cache/local/shaders" ) );
+		
 	}catch( const deException & ){
 		pCleanUp();
 		throw;
@@ -83,6 +87,9 @@ void deoglCaches::Unlock(){
 //////////////////////
 
 void deoglCaches::pCleanUp(){
+	if( pShaders ){
+		delete pShaders;
+	}
 	if( pModels ){
 		delete pModels;
 	}
@@ -39,6 +39,7 @@ private:
 	
 	deCacheHelper *pSkinTextures;
 	deCacheHelper *pModels;
+	deCacheHelper *pShaders;
 	
 	
 	
@@ -68,6 +69,9 @@ public:
 	/** \brief Model cache. */
 	inline deCacheHelper &GetModels() const{ return *pModels; }
 	
+	/** \brief Shader program binary cache. */
+	inline deCacheHelper &GetShaders() const{ return *pShaders; }
+	
 	
 	
 private:
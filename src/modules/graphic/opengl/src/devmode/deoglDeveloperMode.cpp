@@ -59,8 +59,10 @@
 #include "../vbo/deoglSharedVBOListList.h"
 #include "../vbo/deoglVBOAttribute.h"
 #include "../framebuffer/deoglFramebuffer.h"
+#include "../occlusiontest/software/deoglSoftwareOcclusionBenchmark.h"
 #include "../renderthread/deoglRenderThread.h"
 #include "../renderthread/deoglRTFramebuffer.h"
+#include "../renderthread/deoglRTLogger.h"
 #include "../deGraphicOpenGl.h"
 
 #include <dragengine/deEngine.h>
@@ -441,6 +443,10 @@ bool deoglDeveloperMode::ExecuteCommand( const decUnicodeArgumentList &command,
 				pCmdTests( command, answer );
 				result = true;
 				
+			}else if( command.MatchesArgumentAt( 0, "dm_software_occlusion_benchmark" ) ){
+				pCmdSoftwareOcclusionBenchmark( command, answer );
+				result = true;
+				
 			}else if( command.MatchesArgumentAt( 0, "dm_show_debug_info" ) ){
 				pCmdShowDebugInfo( command, answer );
 				result = true;
@@ -500,6 +506,7 @@ void deoglDeveloperMode::pCmdHelp( const decUnicodeArgumentList &command, decUni
 	answer.AppendFromUTF8( "dm_show_transp_layer_count [1|0] => Show the number of transparency layers.\n" );
 	answer.AppendFromUTF8( "dm_show_vis_component [1|0] => Displays the visibility of components.\n" );
 	answer.AppendFromUTF8( "dm_show_vis_light [1|0] => Displays the visibility of lights.\n" );
+	answer.AppendFromUTF8( "dm_software_occlusion_benchmark [occluders] [boxes] => Benchmark software occlusion map.\n" );
 	answer.AppendFromUTF8( "dm_stats => Displays various stats.\n" );
 	answer.AppendFromUTF8( "dm_tests => Runs various tests.\n" );
 	answer.AppendFromUTF8( "dm_show_debug_info [1|0] => Show debug information and enable timing measurements.\n" );
@@ -1235,6 +1242,24 @@ void deoglDeveloperMode::pCmdTests( const decUnicodeArgumentList &command, decUn
 	tests.Tests( command, answer );
 }
 
+void deoglDeveloperMode::pCmdSoftwareOcclusionBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	int occluderCount = 200;
+	int boxCount = 10000;
+	
+	if( command.GetArgumentCount() > 1 ){
+		occluderCount = decMath::max( command.GetArgumentAt( 1 )->ToInt(), 1 );
+	}
+	if( command.GetArgumentCount() > 2 ){
+		boxCount = decMath::max( command.GetArgumentAt( 2 )->ToInt(), 1 );
+	}
+	
+	deoglSoftwareOcclusionBenchmark benchmark( pRenderThread );
+	decString text;
+	benchmark.Run( occluderCount, boxCount, text );
+	pRenderThread.GetLogger().LogInfo( text.GetString() );
+	answer.AppendFromUTF8( text );
+}
+
 
 
 void deoglDeveloperMode::pCmdShowDebugInfo( const decUnicodeArgumentList &command, decUnicodeString &answer ){
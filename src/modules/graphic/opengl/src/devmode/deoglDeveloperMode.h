@@ -223,6 +223,7 @@ private:
 	void pCmdHighlightTransparentObjects( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	
 	void pCmdTests( const decUnicodeArgumentList &command, decUnicodeString &answer );
+	void pCmdSoftwareOcclusionBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	
 	void pCmdDebugRenderPlan( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	void pCmdShowMemoryInfo( const decUnicodeArgumentList &command, decUnicodeString &answer );
@@ -19,6 +19,7 @@
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -26,6 +27,7 @@
 #include "deoglDeveloperModeTests.h"
 #include "../shaders/paramblock/deoglSPBlockUBO.h"
 #include "../shaders/paramblock/deoglSPBParameter.h"
+#include "../occlusiontest/software/deoglSoftwareOcclusionMap.h"
 #include "../utils/convexhull/deoglConvexHull2D.h"
 
 #include <dragengine/deEngine.h>
@@ -77,6 +79,7 @@ void deoglDeveloperModeTests::Help( decUnicodeString &answer ){
 	answer.AppendFromUTF8( "where <mode> can be:\n" );
 	answer.AppendFromUTF8( "shaderParameterBlock => Test deoglSPBlockUBO.\n" );
 	answer.AppendFromUTF8( "convexHull2D => Test deoglConvexHull2D.\n" );
+	answer.AppendFromUTF8( "softwareOcclusionMap => Test deoglSoftwareOcclusionMap.\n" );
 }
 
 void deoglDeveloperModeTests::Tests( const decUnicodeArgumentList &command, decUnicodeString &answer ){
@@ -90,6 +93,15 @@ void deoglDeveloperModeTests::Tests( const decUnicodeArgumentList &command, decU
 				AnswerTestFailedWithException( answer, e );
 			}
 			
+		}else if( command.MatchesArgumentAt( 1, "softwareOcclusionMap" ) ){
+			try{
+				TestSoftwareOcclusionMap( answer );
+				AnswerTestPassed( answer );
+				
+			}catch( const deException &e ){
+				AnswerTestFailedWithException( answer, e );
+			}
+			
 		}else{
 			Help( answer );
 		}
@@ -192,6 +204,81 @@ void deoglDeveloperModeTests::TestConvexHull2D( decUnicodeString &answer ){
 }
 
 
+void deoglDeveloperModeTests::TestSoftwareOcclusionMap( decUnicodeString &answer ){
+	// square occluder 10m in front of the camera covering the center half of the map
+	const float positions[ 12 ] = { -5.0f, -5.0f, 10.0f, 5.0f, -5.0f, 10.0f,
+		5.0f, 5.0f, 10.0f, -5.0f, 5.0f, 10.0f };
+	const unsigned short corners[ 6 ] = { 0, 1, 2, 0, 2, 3 };
+	const unsigned short cornersFlipped[ 6 ] = { 0, 2, 1, 0, 3, 2 };
+	const decVector behindMin( -1.0f, -1.0f, 20.0f ), behindMax( 1.0f, 1.0f, 21.0f );
+	deoglSoftwareOcclusionMap map( 64, 64 );
+	decMatrix matrix;
+	
+	// 90 degree field of view with the view distance as w coordinate
+	matrix.a43 = 1.0f;
+	matrix.a44 = 0.0f;
+	map.SetMatrix( matrix, 0.1f );
+	
+	// empty map occludes nothing
+	map.Clear();
+	map.Rasterize();
+	ASSERT_TRUE( map.TestBox( behindMin, behindMax ) );
+	
+	// double sided occluder
+	map.Clear();
+	map.AddOccluder( positions, 3, corners, 0, 2, decMatrix() );
+	ASSERT_EQUAL( map.GetTriangleCount(), 2 );
+	map.Rasterize();
+	
+	ASSERT_TRUE( fabsf( map.GetDepthAt( 32, 32 ) - 0.1f ) < 1e-4f );
+	ASSERT_TRUE( map.GetDepthAt( 2, 2 ) == 0.0f );
+	
+	// boxes behind the occluder are rejected. the large one is accepted using tiles
+	ASSERT_FALSE( map.TestBox( behindMin, behindMax ) );
+	ASSERT_FALSE( map.TestBox( decVector( -4.0f, -4.0f, 30.0f ), decVector( 4.0f, 4.0f, 31.0f ) ) );
+	
+	// boxes in front of the occluder, intersecting it, beside it or partially covered are visible
+	ASSERT_TRUE( map.TestBox( decVector( -1.0f, -1.0f, 5.0f ), decVector( 1.0f, 1.0f, 6.0f ) ) );
+	ASSERT_TRUE( map.TestBox( decVector( -1.0f, -1.0f, 9.0f ), decVector( 1.0f, 1.0f, 11.0f ) ) );
+	ASSERT_TRUE( map.TestBox( decVector( 12.0f, -1.0f, 20.0f ), decVector( 14.0f, 1.0f, 21.0f ) ) );
+	ASSERT_TRUE( map.TestBox( decVector( 8.0f, -1.0f, 20.0f ), decVector( 12.0f, 1.0f, 21.0f ) ) );
+	
+	// boxes crossing the near plane are visible
+	ASSERT_TRUE( map.TestBox( decVector( -1.0f, -1.0f, -1.0f ), decVector( 1.0f, 1.0f, 21.0f ) ) );
+	
+	// occluder matrix is applied
+	map.Clear();
+	map.AddOccluder( positions, 3, corners, 0, 2, decMatrix::CreateTranslation( 10.0f, 0.0f, 10.0f ) );
+	map.Rasterize();
+	ASSERT_TRUE( map.TestBox( behindMin, behindMax ) );
+	ASSERT_FALSE( map.TestBox( decVector( 19.0f, -1.0f, 40.0f ), decVector( 21.0f, 1.0f, 41.0f ) ) );
+	
+	// single sided occluder occludes only if facing the camera
+	map.Clear();
+	map.AddOccluder( positions, 3, corners, 2, 0, decMatrix() );
+	map.Rasterize();
+	const bool visibleFront = map.TestBox( behindMin, behindMax );
+	
+	map.Clear();
+	map.AddOccluder( positions, 3, cornersFlipped, 2, 0, decMatrix() );
+	map.Rasterize();
+	const bool visibleBack = map.TestBox( behindMin, behindMax );
+	
+	ASSERT_TRUE( visibleFront != visibleBack );
+	
+	// bands rasterized one by one in any order equal rasterizing all at once
+	map.Clear();
+	map.AddOccluder( positions, 3, corners, 0, 2, decMatrix() );
+	const int bandCount = map.GetBandCount();
+	int i;
+	for( i=bandCount-1; i>=0; i-- ){
+		map.RasterizeBand( i );
+	}
+	ASSERT_FALSE( map.TestBox( behindMin, behindMax ) );
+	ASSERT_TRUE( fabsf( map.GetDepthAt( 32, 32 ) - 0.1f ) < 1e-4f );
+}
+
+
 
 void deoglDeveloperModeTests::AnswerTestPassed( decUnicodeString &answer ){
 	answer.AppendFromUTF8( "Test passed\n" );
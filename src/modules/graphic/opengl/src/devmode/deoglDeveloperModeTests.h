@@ -58,6 +58,9 @@ public:
 	/** Test 2d convex hull class. */
 	void TestConvexHull2D( decUnicodeString &answer );
 	
+	/** Test software occlusion map rasterizing a known occluder and testing boxes. */
+	void TestSoftwareOcclusionMap( decUnicodeString &answer );
+	
 	/** Answer test passed. */
 	void AnswerTestPassed( decUnicodeString &answer );
 	/** Answer test failed with exception. */
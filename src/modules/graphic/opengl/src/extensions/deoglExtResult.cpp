@@ -460,6 +460,10 @@ GLAPI PFNGLUNIFORMBLOCKBINDINGPROC pglUniformBlockBinding = NULL;
 // GL_ARB_get_program_binary : no opengl version
 //////////////////////////////////////////////////
 
+GLAPI PFNGLGETPROGRAMBINARYPROC pglGetProgramBinary = NULL;
+GLAPI PFNGLPROGRAMBINARYPROC pglProgramBinary = NULL;
+GLAPI PFNGLPROGRAMPARAMETERIPROC pglProgramParameteri = NULL;
+
 
 
 // GL_ARB_separate_shader_objects : no opengl version
@@ -717,9 +717,9 @@ extern GLAPI PFNGLUNIFORMBLOCKBINDINGPROC pglUniformBlockBinding;
 // GL_ARB_get_program_binary : no opengl version
 //////////////////////////////////////////////////
 
-// extern GLAPI PFNGLGETPROGRAMBINARYPROC pglGetProgramBinary;
-// extern GLAPI PFNGLPROGRAMBINARYPROC pglProgramBinary;
-// extern GLAPI PFNGLPROGRAMPARAMETERIPROC pglProgramParameteri;
+extern GLAPI PFNGLGETPROGRAMBINARYPROC pglGetProgramBinary;
+extern GLAPI PFNGLPROGRAMBINARYPROC pglProgramBinary;
+extern GLAPI PFNGLPROGRAMPARAMETERIPROC pglProgramParameteri;
 
 
 
@@ -303,6 +303,7 @@ void deoglExtensions::DisableExtension( eExtensions extension ){
 
 void deoglExtensions::pScanVendor(){
 	pStrVendor = ( const char * )glGetString( GL_VENDOR );
+	pStrRenderer = ( const char * )glGetString( GL_RENDERER );
 	
 	if( strncmp( pStrVendor.GetString(), "ATI", 3 ) == 0 ){
 		pVendor = evATI;
@@ -952,6 +953,9 @@ void deoglExtensions::pFetchOptionalFunctions(){
 	
 	// GL_ARB_get_program_binary : no opengl version
 	if( pHasExtension[ ext_ARB_get_program_binary ] ){
+		pGetOptionalFunctionArbExt( (void**)&pglGetProgramBinary, "glGetProgramBinary", ext_ARB_get_program_binary );
+		pGetOptionalFunctionArbExt( (void**)&pglProgramBinary, "glProgramBinary", ext_ARB_get_program_binary );
+		pGetOptionalFunctionArbExt( (void**)&pglProgramParameteri, "glProgramParameteri", ext_ARB_get_program_binary );
 	}
 	
 	// GL_ARB_separate_shader_objects : no opengl version
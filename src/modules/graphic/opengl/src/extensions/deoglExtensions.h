@@ -359,6 +359,7 @@ private:
 	static bool pInitialized;
 	
 	decString pStrVendor;
+	decString pStrRenderer;
 	decString pStrGLVersion;
 	decStringList pStrListExtensions;
 	
@@ -404,6 +405,8 @@ public:
 	
 	/** Retrieves the vendor string. */
 	inline const decString &GetStringVendor() const{ return pStrVendor; }
+	/** Retrieves the renderer string. */
+	inline const decString &GetStringRenderer() const{ return pStrRenderer; }
 	/** Retrieves the opengl version string. */
 	inline const decString &GetStringGLVersion() const{ return pStrGLVersion; }
 	/** Retrieves the list of extension strings supported by the hardware. */
@@ -49,6 +49,7 @@
 #include "../utils/collision/deoglCollisionDetection.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decSkinning.h>
 #include <dragengine/common/utils/decTimer.h>
 #include <dragengine/common/file/decBaseFileReader.h>
 #include <dragengine/common/file/decBaseFileWriter.h>
@@ -116,6 +117,7 @@ pIBOType( deoglVBOLayout::eitUnsignedShort )
 	pTexCoordSetCount = 0;
 	
 	pOctree = NULL;
+	pSkinning = NULL;
 	
 	pMaxError = 0.0f;
 	pAvgError = 0.0f;
@@ -200,6 +202,7 @@ pIBOType( deoglVBOLayout::eitUnsignedShort )
 	pTexCoordSetCount = 0;
 	
 	pOctree = NULL;
+	pSkinning = NULL;
 	
 	pMaxError = 0.0f;
 	pAvgError = 0.0f;
@@ -470,6 +473,29 @@ void deoglModelLOD::PrepareOctree(){
 	}
 }
 
+void deoglModelLOD::PrepareSkinning(){
+	if( pSkinning ){
+		return;
+	}
+	
+	int i;
+	
+	pSkinning = new decSkinning;
+	
+	try{
+		pSkinning->SetVertexCount( pPositionCount );
+		for( i=0; i<pPositionCount; i++ ){
+			pSkinning->SetVertexAt( i, pPositions[ i ].position, pPositions[ i ].weight );
+		}
+		pSkinning->Prepare();
+		
+	}catch( const deException & ){
+		delete pSkinning;
+		pSkinning = NULL;
+		throw;
+	}
+}
+
 
 
 void deoglModelLOD::pCalcErrorMetrics( const deModel &engModel ){
@@ -763,6 +789,9 @@ void deoglModelLOD::pCleanUp(){
 		pglDeleteBuffers( 1, &pIBO );
 	}
 	
+	if( pSkinning ){
+		delete pSkinning;
+	}
 	if( pOctree ){
 		delete pOctree;
 	}
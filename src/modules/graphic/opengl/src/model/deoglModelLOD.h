@@ -31,6 +31,7 @@ class deoglRModel;
 class deoglModelFace;
 class deoglModelTexture;
 class deoglModelOctree;
+class decSkinning;
 class deoglModelLODTexCoordSet;
 class deoglSharedVBOBlock;
 class deoglSharedSPBRTIGroupList;
@@ -113,6 +114,7 @@ public:
 	bool pDecal;
 	
 	deoglModelOctree *pOctree;
+	decSkinning *pSkinning;
 	
 	float pMaxError;
 	float pAvgError;
@@ -227,6 +229,12 @@ public:
 	/** \brief Prepare octree if not existing already. */
 	void PrepareOctree();
 	
+	/** \brief CPU skinning kernel for positions or \em NULL if not prepared. */
+	inline const decSkinning *GetSkinning() const{ return pSkinning; }
+	
+	/** \brief Prepare CPU skinning kernel if not existing already. */
+	void PrepareSkinning();
+	
 	/** Retrieves the maximum error in meters compared to LOD 0. */
 	inline float GetMaxError() const{ return pMaxError; }
 	/** Retrieves the average error in meters compared to LOD 0. */
@@ -40,6 +40,7 @@
 #include "../../delayedoperation/deoglDelayedOperations.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decSkinning.h>
 #include <dragengine/resources/component/deComponent.h>
 #include <dragengine/resources/model/deModel.h>
 #include <dragengine/resources/model/deModelBone.h>
@@ -80,6 +81,7 @@ pRenderThread( renderThread )
 	pVBOVertexSize = 0;
 	
 	pDirtyOccMesh = true;
+	pDirtyVertices = true;
 	pDirtyVBO = true;
 }
 
@@ -111,6 +113,7 @@ void deoglDynamicOcclusionMesh::InvalidateVAO(){
 
 
 void deoglDynamicOcclusionMesh::ComponentStateChanged(){
+	pDirtyVertices = true;
 	pDirtyVBO = true;
 	pDirtyOccMesh = true;
 }
@@ -140,17 +143,28 @@ void deoglDynamicOcclusionMesh::UpdateBoneMappings( const deComponent &component
 		pBoneMappings.Add( model.IndexOfBoneNamed( occmesh.GetBoneAt( i ).GetName() ) );
 	}
 	
+	pDirtyVertices = true;
 	pDirtyVBO = true;
 }
 
-void deoglDynamicOcclusionMesh::Prepare(){
-	if( ! pDirtyVBO ){
+void deoglDynamicOcclusionMesh::PrepareVertices(){
+	if( ! pDirtyVertices ){
 		return;
 	}
 	
 	pBuildArrays();
 	pCalculateWeights();
 	pTransformVertices();
+	
+	pDirtyVertices = false;
+}
+
+void deoglDynamicOcclusionMesh::Prepare(){
+	if( ! pDirtyVBO ){
+		return;
+	}
+	
+	PrepareVertices();
 	pBuildVBO();
 	pUpdateVAO();
 	
@@ -386,26 +400,13 @@ void deoglDynamicOcclusionMesh::pCalculateWeights(){
 }
 
 void deoglDynamicOcclusionMesh::pTransformVertices(){
-	const deoglROcclusionMesh::sVertex * const vertices = pOcclusionMesh->GetVertices();
-	const int vertexCount = pOcclusionMesh->GetVertexCount();
-	int v;
-	
-	for( v=0; v<vertexCount; v++ ){
-		const deoglROcclusionMesh::sVertex &orgvertex = vertices[ v ];
-		decVector &trapos = pVertices[ v ];
-		
-		if( orgvertex.weight == -1 ){
-			trapos = orgvertex.position;
-			
-		}else{
-			const oglMatrix3x4 &matrix = pWeights[ orgvertex.weight ];
-			const decVector &orgpos = orgvertex.position;
-			
-			trapos.x = matrix.a11 * orgpos.x + matrix.a12 * orgpos.y + matrix.a13 * orgpos.z + matrix.a14;
-			trapos.y = matrix.a21 * orgpos.x + matrix.a22 * orgpos.y + matrix.a23 * orgpos.z + matrix.a24;
-			trapos.z = matrix.a31 * orgpos.x + matrix.a32 * orgpos.y + matrix.a33 * orgpos.z + matrix.a34;
-		}
+	if( ! pVertices ){
+		return;
 	}
+	
+	pOcclusionMesh->PrepareSkinning();
+	pOcclusionMesh->GetSkinning()->Transform( pWeights ? &pWeights[ 0 ].a11 : NULL,
+		sizeof( oglMatrix3x4 ) / sizeof( GLfloat ), &pVertices[ 0 ].x, sizeof( decVector ) / sizeof( float ) );
 }
 
 void deoglDynamicOcclusionMesh::pBuildVBO(){
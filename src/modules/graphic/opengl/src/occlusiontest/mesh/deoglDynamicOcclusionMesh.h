@@ -59,6 +59,7 @@ public:
 	int pVBOVertexSize;
 	
 	bool pDirtyOccMesh;
+	bool pDirtyVertices;
 	bool pDirtyVBO;
 	
 public:
@@ -92,6 +93,17 @@ public:
 	/** \brief Update bone mappings. */
 	void UpdateBoneMappings( const deComponent &component );
 	
+	/**
+	 * \brief Transformed vertices in component space.
+	 * 
+	 * Valid after PrepareVertices() or Prepare() has been called. NULL if the occlusion
+	 * mesh has no vertices.
+	 */
+	inline const decVector *GetVertices() const{ return pVertices; }
+	
+	/** \brief Transform vertices if dirty without touching the VBO. */
+	void PrepareVertices();
+	
 	/** Prepare for rendering. */
 	void Prepare();
 	/*@}*/
@@ -37,6 +37,7 @@
 #include "../../vbo/deoglVBOAttribute.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decSkinning.h>
 #include <dragengine/resources/occlusionmesh/deOcclusionMesh.h>
 #include <dragengine/resources/occlusionmesh/deOcclusionMeshWeight.h>
 #include <dragengine/resources/occlusionmesh/deOcclusionMeshVertex.h>
@@ -63,6 +64,7 @@ pSharedSPBListUBO( NULL )
 	
 	pVertices = NULL;
 	pVertexCount = 0;
+	pSkinning = NULL;
 	
 	pCorners = NULL;
 	pCornerCount = 0;
@@ -116,6 +118,29 @@ deoglSharedSPBListUBO &deoglROcclusionMesh::GetSharedSPBListUBO(){
 	return *pSharedSPBListUBO;
 }
 
+void deoglROcclusionMesh::PrepareSkinning(){
+	if( pSkinning ){
+		return;
+	}
+	
+	int i;
+	
+	pSkinning = new decSkinning;
+	
+	try{
+		pSkinning->SetVertexCount( pVertexCount );
+		for( i=0; i<pVertexCount; i++ ){
+			pSkinning->SetVertexAt( i, pVertices[ i ].position, pVertices[ i ].weight );
+		}
+		pSkinning->Prepare();
+		
+	}catch( const deException & ){
+		delete pSkinning;
+		pSkinning = NULL;
+		throw;
+	}
+}
+
 
 
 // Private Functions
@@ -146,6 +171,9 @@ public:
 };
 
 void deoglROcclusionMesh::pCleanUp(){
+	if( pSkinning ){
+		delete pSkinning;
+	}
 	if( pCorners ){
 		delete [] pCorners;
 	}
@@ -30,6 +30,7 @@
 #include <dragengine/common/string/decString.h>
 
 class deOcclusionMesh;
+class decSkinning;
 class deoglRenderThread;
 class deoglSharedVBOBlock;
 class deoglSharedSPBListUBO;
@@ -66,6 +67,7 @@ public:
 	
 	sVertex *pVertices;
 	int pVertexCount;
+	decSkinning *pSkinning;
 	
 	unsigned short *pCorners;
 	int pCornerCount;
@@ -120,6 +122,12 @@ public:
 	/** \brief Vertex count. */
 	inline int GetVertexCount() const{ return pVertexCount; }
 	
+	/** \brief CPU skinning kernel for vertices or \em NULL if not prepared. */
+	inline const decSkinning *GetSkinning() const{ return pSkinning; }
+	
+	/** \brief Prepare CPU skinning kernel if not prepared. */
+	void PrepareSkinning();
+	
 	
 	
 	/** \brief Corners. */
@@ -0,0 +1,204 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoglSoftwareOcclusionBenchmark.h"
+#include "deoglSoftwareOcclusionTest.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/utils/decTimer.h>
+
+
+
+// Definitions
+////////////////
+
+// number of times occluders are added and rasterized to average the timings
+#define ITERATION_COUNT 20
+
+// scene depth range in meters
+#define SCENE_NEAR 5.0f
+#define SCENE_FAR 100.0f
+
+// unit box occluder. faces facing away from the box center are front facing
+static const float vBoxPositions[ 24 ] = {
+	0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+static const unsigned short vBoxCorners[ 36 ] = {
+	0, 1, 3, 0, 3, 2, // -z
+	4, 6, 7, 4, 7, 5, // +z
+	0, 2, 6, 0, 6, 4, // -x
+	1, 5, 7, 1, 7, 3, // +x
+	0, 4, 5, 0, 5, 1, // -y
+	2, 3, 7, 2, 7, 6 }; // +y
+
+
+
+// Class deoglSoftwareOcclusionBenchmark
+//////////////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+deoglSoftwareOcclusionBenchmark::deoglSoftwareOcclusionBenchmark( deoglRenderThread &renderThread ) :
+pRenderThread( renderThread ),
+pRandomSeed( 0x5eed1234 ){
+}
+
+deoglSoftwareOcclusionBenchmark::~deoglSoftwareOcclusionBenchmark(){
+}
+
+
+
+// Management
+///////////////
+
+void deoglSoftwareOcclusionBenchmark::Run( int occluderCount, int boxCount, decString &result ){
+	if( occluderCount < 1 || boxCount < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	deoglSoftwareOcclusionTest * const test = new deoglSoftwareOcclusionTest( pRenderThread );
+	decMatrix *occluderMatrices = NULL;
+	decVector *boxMinExtends = NULL;
+	decVector *boxMaxExtends = NULL;
+	decTimer timer;
+	int i, j;
+	
+	pRandomSeed = 0x5eed1234;
+	
+	try{
+		deoglSoftwareOcclusionMap &map = test->GetMap();
+		
+		// 90 degree vertical field of view with square pixels
+		decMatrix matrix;
+		matrix.a11 = ( float )map.GetHeight() / ( float )map.GetWidth();
+		matrix.a43 = 1.0f;
+		matrix.a44 = 0.0f;
+		map.SetMatrix( matrix, 0.1f );
+		
+		// wall shaped occluders inside the view frustum
+		occluderMatrices = new decMatrix[ occluderCount ];
+		for( i=0; i<occluderCount; i++ ){
+			const float z = pRandomFloat( SCENE_NEAR * 2.0f, SCENE_FAR * 0.6f );
+			occluderMatrices[ i ] = decMatrix::CreateScale( pRandomFloat( 2.0f, 8.0f ),
+				pRandomFloat( 2.0f, 6.0f ), pRandomFloat( 0.5f, 1.0f ) )
+				* decMatrix::CreateTranslation( pRandomFloat( -z, z ), pRandomFloat( -z, z ) * 0.5f, z );
+		}
+		
+		// boxes to test inside the view frustum
+		boxMinExtends = new decVector[ boxCount ];
+		boxMaxExtends = new decVector[ boxCount ];
+		for( i=0; i<boxCount; i++ ){
+			const float z = pRandomFloat( SCENE_NEAR, SCENE_FAR );
+			boxMinExtends[ i ].Set( pRandomFloat( -z, z ), pRandomFloat( -z, z ) * 0.5f, z );
+			boxMaxExtends[ i ] = boxMinExtends[ i ] + decVector( pRandomFloat( 0.5f, 3.0f ),
+				pRandomFloat( 0.5f, 3.0f ), pRandomFloat( 0.5f, 3.0f ) );
+		}
+		
+		// add occluders and rasterize on the calling thread
+		float timeAdd = 0.0f;
+		float timeRasterize = 0.0f;
+		
+		for( i=0; i<ITERATION_COUNT; i++ ){
+			map.Clear();
+			
+			timer.Reset();
+			for( j=0; j<occluderCount; j++ ){
+				map.AddOccluder( vBoxPositions, 3, vBoxCorners, 12, 0, occluderMatrices[ j ] );
+			}
+			timeAdd += timer.GetElapsedTime();
+			
+			map.Rasterize();
+			timeRasterize += timer.GetElapsedTime();
+		}
+		
+		const int triangleCount = map.GetTriangleCount();
+		
+		// rasterize using parallel tasks
+		float timeRasterizeParallel = 0.0f;
+		
+		for( i=0; i<ITERATION_COUNT; i++ ){
+			map.Clear();
+			for( j=0; j<occluderCount; j++ ){
+				map.AddOccluder( vBoxPositions, 3, vBoxCorners, 12, 0, occluderMatrices[ j ] );
+			}
+			
+			timer.Reset();
+			test->Rasterize();
+			timeRasterizeParallel += timer.GetElapsedTime();
+		}
+		
+		// test boxes
+		int occludedCount = 0;
+		timer.Reset();
+		for( i=0; i<boxCount; i++ ){
+			if( ! map.TestBox( boxMinExtends[ i ], boxMaxExtends[ i ] ) ){
+				occludedCount++;
+			}
+		}
+		const float timeTest = timer.GetElapsedTime();
+		
+		const float iterationFactor = 1e3f / ( float )ITERATION_COUNT;
+		
+		result.Format( "Software occlusion benchmark: occluders=%d boxes=%d map=%dx%d bands=%d\n"
+			"  Add occluders: %.3fms (triangles=%d)\n"
+			"  Rasterize: %.3fms, parallel %.3fms\n"
+			"  Test boxes: %.3fms (%.2fus/box, occluded=%d)\n",
+			occluderCount, boxCount, map.GetWidth(), map.GetHeight(), map.GetBandCount(),
+			timeAdd * iterationFactor, triangleCount,
+			timeRasterize * iterationFactor, timeRasterizeParallel * iterationFactor,
+			timeTest * 1e3f, timeTest * 1e6f / ( float )boxCount, occludedCount );
+		
+		delete [] boxMaxExtends;
+		delete [] boxMinExtends;
+		delete [] occluderMatrices;
+		test->FreeReference();
+		
+	}catch( const deException & ){
+		if( boxMaxExtends ){
+			delete [] boxMaxExtends;
+		}
+		if( boxMinExtends ){
+			delete [] boxMinExtends;
+		}
+		if( occluderMatrices ){
+			delete [] occluderMatrices;
+		}
+		test->FreeReference();
+		throw;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+float deoglSoftwareOcclusionBenchmark::pRandomFloat( float minimum, float maximum ){
+	// fixed seed linear congruential generator. results are reproducible across runs
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return minimum + ( float )( ( pRandomSeed >> 8 ) % 10000u ) * 1e-4f * ( maximum - minimum );
+}
@@ -0,0 +1,77 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLSOFTWAREOCCLUSIONBENCHMARK_H_
+#define _DEOGLSOFTWAREOCCLUSIONBENCHMARK_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/common/string/decString.h>
+
+class deoglRenderThread;
+
+
+
+/**
+ * \brief Software occlusion benchmark.
+ * 
+ * Developer mode benchmark for deoglSoftwareOcclusionMap. Builds a synthetic scene of
+ * random wall shaped box occluders in front of the camera and random boxes to test.
+ * Reports the time to add the occluders, to rasterize the map on the calling thread
+ * and using deoglSoftwareOcclusionTest parallel tasks as well as the time to test the
+ * boxes and the number of occluded boxes.
+ */
+class deoglSoftwareOcclusionBenchmark{
+private:
+	deoglRenderThread &pRenderThread;
+	unsigned int pRandomSeed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create benchmark. */
+	deoglSoftwareOcclusionBenchmark( deoglRenderThread &renderThread );
+	
+	/** \brief Clean up benchmark. */
+	~deoglSoftwareOcclusionBenchmark();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Run benchmark.
+	 * \param[in] occluderCount Number of box occluders.
+	 * \param[in] boxCount Number of boxes to test.
+	 * \param[out] result Benchmark results in human readable form.
+	 */
+	void Run( int occluderCount, int boxCount, decString &result );
+	/*@}*/
+	
+	
+	
+private:
+	float pRandomFloat( float minimum, float maximum );
+};
+
+#endif
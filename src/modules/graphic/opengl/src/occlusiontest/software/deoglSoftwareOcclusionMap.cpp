@@ -0,0 +1,569 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoglSoftwareOcclusionMap.h"
+
+#include <dragengine/common/exceptions.h>
+
+#if defined( __SSE__ ) || defined( _M_X64 )
+#	include <xmmintrin.h>
+#	define DEOGLSOFTWAREOCCLUSIONMAP_SSE 1
+#endif
+
+
+
+// Definitions
+////////////////
+
+// boxes are considered closer by this factor to compensate for rounding errors. this way
+// an occluder has to be noticeably closer than a box to occlude it
+#define BOX_DEPTH_BIAS 1.001f
+
+// triangles with a smaller area in pixels are ignored
+#define MIN_TRIANGLE_AREA 1e-4f
+
+
+
+// Class deoglSoftwareOcclusionMap
+////////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoglSoftwareOcclusionMap::deoglSoftwareOcclusionMap( int width, int height ) :
+pWidth( 0 ),
+pHeight( 0 ),
+pTileCountX( 0 ),
+pTileCountY( 0 ),
+pDepth( NULL ),
+pTileDepth( NULL ),
+pNearDistance( 0.01f ),
+pTriangles( NULL ),
+pTriangleCount( 0 ),
+pTriangleSize( 0 )
+{
+	try{
+		SetSize( width, height );
+		
+	}catch( const deException & ){
+		pCleanUp();
+		throw;
+	}
+}
+
+deoglSoftwareOcclusionMap::~deoglSoftwareOcclusionMap(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void deoglSoftwareOcclusionMap::SetSize( int width, int height ){
+	if( width < TILE_WIDTH || width % TILE_WIDTH != 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	if( height < BAND_HEIGHT || height % BAND_HEIGHT != 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	if( width == pWidth && height == pHeight ){
+		return;
+	}
+	
+	const int tileCountX = width / TILE_WIDTH;
+	const int tileCountY = height / TILE_HEIGHT;
+	float *depth = NULL;
+	float *tileDepth = NULL;
+	
+	try{
+		depth = new float[ width * height ];
+		tileDepth = new float[ tileCountX * tileCountY ];
+		
+	}catch( const deException & ){
+		if( depth ){
+			delete [] depth;
+		}
+		throw;
+	}
+	
+	if( pTileDepth ){
+		delete [] pTileDepth;
+	}
+	if( pDepth ){
+		delete [] pDepth;
+	}
+	
+	pDepth = depth;
+	pTileDepth = tileDepth;
+	pWidth = width;
+	pHeight = height;
+	pTileCountX = tileCountX;
+	pTileCountY = tileCountY;
+	
+	Clear();
+}
+
+void deoglSoftwareOcclusionMap::SetMatrix( const decMatrix &matrix, float nearDistance ){
+	if( nearDistance <= 0.0f ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pMatrix = matrix;
+	pNearDistance = nearDistance;
+}
+
+void deoglSoftwareOcclusionMap::Clear(){
+	memset( pDepth, 0, sizeof( float ) * ( pWidth * pHeight ) );
+	memset( pTileDepth, 0, sizeof( float ) * ( pTileCountX * pTileCountY ) );
+	pTriangleCount = 0;
+}
+
+void deoglSoftwareOcclusionMap::AddOccluder( const float *positions, int positionStride,
+const unsigned short *corners, int singleSidedFaceCount, int doubleSidedFaceCount,
+const decMatrix &matrix ){
+	if( positionStride < 3 || singleSidedFaceCount < 0 || doubleSidedFaceCount < 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int faceCount = singleSidedFaceCount + doubleSidedFaceCount;
+	if( faceCount == 0 ){
+		return;
+	}
+	if( ! positions || ! corners ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const decMatrix m( matrix * pMatrix );
+	sClipVertex vertices[ 3 ];
+	int i, j;
+	
+	for( i=0; i<faceCount; i++ ){
+		for( j=0; j<3; j++ ){
+			const float * const p = positions + positionStride * corners[ i * 3 + j ];
+			vertices[ j ].x = m.a11 * p[ 0 ] + m.a12 * p[ 1 ] + m.a13 * p[ 2 ] + m.a14;
+			vertices[ j ].y = m.a21 * p[ 0 ] + m.a22 * p[ 1 ] + m.a23 * p[ 2 ] + m.a24;
+			vertices[ j ].w = m.a41 * p[ 0 ] + m.a42 * p[ 1 ] + m.a43 * p[ 2 ] + m.a44;
+		}
+		
+		pAddTriangle( vertices[ 0 ], vertices[ 1 ], vertices[ 2 ], i >= singleSidedFaceCount );
+	}
+}
+
+void deoglSoftwareOcclusionMap::RasterizeBand( int band ){
+	if( band < 0 || band >= GetBandCount() ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int minY = band * BAND_HEIGHT;
+	const int maxY = minY + BAND_HEIGHT;
+	int i;
+	
+	for( i=0; i<pTriangleCount; i++ ){
+		const sTriangle &triangle = pTriangles[ i ];
+		if( triangle.maxY > minY && triangle.minY < maxY ){
+			pRasterizeTriangle( triangle, decMath::max( triangle.minY, minY ),
+				decMath::min( triangle.maxY, maxY ) );
+		}
+	}
+	
+	pUpdateTileDepth( band );
+}
+
+void deoglSoftwareOcclusionMap::Rasterize(){
+	const int bandCount = GetBandCount();
+	int i;
+	
+	for( i=0; i<bandCount; i++ ){
+		RasterizeBand( i );
+	}
+}
+
+bool deoglSoftwareOcclusionMap::TestBox( const decVector &minExtend, const decVector &maxExtend ) const{
+	float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f, minW = 0.0f;
+	int i;
+	
+	for( i=0; i<8; i++ ){
+		const float cx = ( i & 1 ) ? maxExtend.x : minExtend.x;
+		const float cy = ( i & 2 ) ? maxExtend.y : minExtend.y;
+		const float cz = ( i & 4 ) ? maxExtend.z : minExtend.z;
+		
+		const float w = pMatrix.a41 * cx + pMatrix.a42 * cy + pMatrix.a43 * cz + pMatrix.a44;
+		if( w < pNearDistance ){
+			return true; // box crosses the near plane
+		}
+		
+		const float invW = 1.0f / w;
+		const float x = ( pMatrix.a11 * cx + pMatrix.a12 * cy + pMatrix.a13 * cz + pMatrix.a14 ) * invW;
+		const float y = ( pMatrix.a21 * cx + pMatrix.a22 * cy + pMatrix.a23 * cz + pMatrix.a24 ) * invW;
+		
+		if( i == 0 ){
+			minX = maxX = x;
+			minY = maxY = y;
+			minW = w;
+			
+		}else{
+			minX = decMath::min( minX, x );
+			maxX = decMath::max( maxX, x );
+			minY = decMath::min( minY, y );
+			maxY = decMath::max( maxY, y );
+			minW = decMath::min( minW, w );
+		}
+	}
+	
+	// pixels touched by the box rectangle
+	const float scaleX = ( float )pWidth * 0.5f;
+	const float scaleY = ( float )pHeight * 0.5f;
+	
+	const int pixelMinX = decMath::max( ( int )floorf( ( minX + 1.0f ) * scaleX ), 0 );
+	const int pixelMinY = decMath::max( ( int )floorf( ( minY + 1.0f ) * scaleY ), 0 );
+	const int pixelMaxX = decMath::min( ( int )ceilf( ( maxX + 1.0f ) * scaleX ), pWidth );
+	const int pixelMaxY = decMath::min( ( int )ceilf( ( maxY + 1.0f ) * scaleY ), pHeight );
+	
+	if( pixelMinX >= pixelMaxX || pixelMinY >= pixelMaxY ){
+		return true; // outside map. frustum culling has to deal with it
+	}
+	
+	// the box is occluded if all pixels are closer than the closest point of the box.
+	// tiles with a minimum depth closer than the box are occluded as a whole
+	const float boxDepth = BOX_DEPTH_BIAS / minW;
+	const int tileMinX = pixelMinX / TILE_WIDTH;
+	const int tileMinY = pixelMinY / TILE_HEIGHT;
+	const int tileMaxX = ( pixelMaxX - 1 ) / TILE_WIDTH;
+	const int tileMaxY = ( pixelMaxY - 1 ) / TILE_HEIGHT;
+	int tx, ty, px, py;
+	
+	for( ty=tileMinY; ty<=tileMaxY; ty++ ){
+		const float * const tileRow = pTileDepth + pTileCountX * ty;
+		const int fromY = decMath::max( ty * TILE_HEIGHT, pixelMinY );
+		const int toY = decMath::min( ( ty + 1 ) * TILE_HEIGHT, pixelMaxY );
+		
+		for( tx=tileMinX; tx<=tileMaxX; tx++ ){
+			if( tileRow[ tx ] > boxDepth ){
+				continue;
+			}
+			
+			const int fromX = decMath::max( tx * TILE_WIDTH, pixelMinX );
+			const int toX = decMath::min( ( tx + 1 ) * TILE_WIDTH, pixelMaxX );
+			
+			for( py=fromY; py<toY; py++ ){
+				const float * const row = pDepth + pWidth * py;
+				for( px=fromX; px<toX; px++ ){
+					if( row[ px ] <= boxDepth ){
+						return true;
+					}
+				}
+			}
+		}
+	}
+	
+	return false;
+}
+
+float deoglSoftwareOcclusionMap::GetDepthAt( int x, int y ) const{
+	if( x < 0 || x >= pWidth || y < 0 || y >= pHeight ){
+		DETHROW( deeInvalidParam );
+	}
+	return pDepth[ pWidth * y + x ];
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deoglSoftwareOcclusionMap::pCleanUp(){
+	if( pTriangles ){
+		delete [] pTriangles;
+	}
+	if( pTileDepth ){
+		delete [] pTileDepth;
+	}
+	if( pDepth ){
+		delete [] pDepth;
+	}
+}
+
+static inline float deoglSOMClipDistance( const float x, const float y, const float w,
+int plane, float nearDistance ){
+	switch( plane ){
+	case 0:
+		return w - nearDistance;
+		
+	case 1:
+		return w + x;
+		
+	case 2:
+		return w - x;
+		
+	case 3:
+		return w + y;
+		
+	default:
+		return w - y;
+	}
+}
+
+void deoglSoftwareOcclusionMap::pAddTriangle( const sClipVertex &v1, const sClipVertex &v2,
+const sClipVertex &v3, bool doubleSided ){
+	// classify vertices against the near plane and the four side planes. triangles fully
+	// outside a plane are dropped, triangles fully inside all planes need no clipping
+	int outside1 = 0, outside2 = 0, outside3 = 0;
+	int plane;
+	
+	for( plane=0; plane<5; plane++ ){
+		if( deoglSOMClipDistance( v1.x, v1.y, v1.w, plane, pNearDistance ) < 0.0f ){
+			outside1 |= 1 << plane;
+		}
+		if( deoglSOMClipDistance( v2.x, v2.y, v2.w, plane, pNearDistance ) < 0.0f ){
+			outside2 |= 1 << plane;
+		}
+		if( deoglSOMClipDistance( v3.x, v3.y, v3.w, plane, pNearDistance ) < 0.0f ){
+			outside3 |= 1 << plane;
+		}
+	}
+	
+	if( ( outside1 & outside2 & outside3 ) != 0 ){
+		return;
+	}
+	
+	if( ( outside1 | outside2 | outside3 ) == 0 ){
+		pAddClippedTriangle( v1, v2, v3, doubleSided );
+		return;
+	}
+	
+	// clip polygon against all planes. each plane adds at most one vertex
+	sClipVertex polygon[ 2 ][ 8 ];
+	int count = 3;
+	int current = 0;
+	int i;
+	
+	polygon[ 0 ][ 0 ] = v1;
+	polygon[ 0 ][ 1 ] = v2;
+	polygon[ 0 ][ 2 ] = v3;
+	
+	for( plane=0; plane<5; plane++ ){
+		const sClipVertex * const input = polygon[ current ];
+		sClipVertex * const output = polygon[ 1 - current ];
+		int outputCount = 0;
+		
+		for( i=0; i<count; i++ ){
+			const sClipVertex &a = input[ i ];
+			const sClipVertex &b = input[ ( i + 1 ) % count ];
+			const float distanceA = deoglSOMClipDistance( a.x, a.y, a.w, plane, pNearDistance );
+			const float distanceB = deoglSOMClipDistance( b.x, b.y, b.w, plane, pNearDistance );
+			
+			if( distanceA >= 0.0f ){
+				output[ outputCount++ ] = a;
+			}
+			
+			if( ( distanceA >= 0.0f ) != ( distanceB >= 0.0f ) ){
+				const float t = distanceA / ( distanceA - distanceB );
+				sClipVertex &v = output[ outputCount++ ];
+				v.x = a.x + ( b.x - a.x ) * t;
+				v.y = a.y + ( b.y - a.y ) * t;
+				v.w = a.w + ( b.w - a.w ) * t;
+			}
+		}
+		
+		count = outputCount;
+		current = 1 - current;
+		
+		if( count < 3 ){
+			return;
+		}
+	}
+	
+	const sClipVertex * const clipped = polygon[ current ];
+	for( i=2; i<count; i++ ){
+		pAddClippedTriangle( clipped[ 0 ], clipped[ i - 1 ], clipped[ i ], doubleSided );
+	}
+}
+
+void deoglSoftwareOcclusionMap::pAddClippedTriangle( const sClipVertex &v1,
+const sClipVertex &v2, const sClipVertex &v3, bool doubleSided ){
+	const float scaleX = ( float )pWidth * 0.5f;
+	const float scaleY = ( float )pHeight * 0.5f;
+	
+	const float z1 = 1.0f / v1.w;
+	const float z2 = 1.0f / v2.w;
+	const float z3 = 1.0f / v3.w;
+	const float x1 = ( v1.x * z1 + 1.0f ) * scaleX;
+	const float y1 = ( v1.y * z1 + 1.0f ) * scaleY;
+	const float x2 = ( v2.x * z2 + 1.0f ) * scaleX;
+	const float y2 = ( v2.y * z2 + 1.0f ) * scaleY;
+	const float x3 = ( v3.x * z3 + 1.0f ) * scaleX;
+	const float y3 = ( v3.y * z3 + 1.0f ) * scaleY;
+	
+	// front faces are counter clockwise. back faces of double sided triangles are flipped
+	const float area = ( x2 - x1 ) * ( y3 - y1 ) - ( x3 - x1 ) * ( y2 - y1 );
+	
+	if( area > MIN_TRIANGLE_AREA ){
+		pAddSetupTriangle( x1, y1, z1, x2, y2, z2, x3, y3, z3, area );
+		
+	}else if( doubleSided && area < -MIN_TRIANGLE_AREA ){
+		pAddSetupTriangle( x1, y1, z1, x3, y3, z3, x2, y2, z2, -area );
+	}
+}
+
+void deoglSoftwareOcclusionMap::pAddSetupTriangle( float x1, float y1, float z1,
+float x2, float y2, float z2, float x3, float y3, float z3, float area ){
+	// pixel bounding box. the horizontal range is aligned to four pixels for SIMD
+	const int minX = decMath::max( ( int )floorf( decMath::min( x1, x2, x3 ) ), 0 ) & ~3;
+	const int minY = decMath::max( ( int )floorf( decMath::min( y1, y2, y3 ) ), 0 );
+	const int maxX = ( decMath::min( ( int )ceilf( decMath::max( x1, x2, x3 ) ), pWidth ) + 3 ) & ~3;
+	const int maxY = decMath::min( ( int )ceilf( decMath::max( y1, y2, y3 ) ), pHeight );
+	
+	if( minX >= maxX || minY >= maxY ){
+		return;
+	}
+	
+	if( pTriangleCount == pTriangleSize ){
+		const int newSize = pTriangleSize * 3 / 2 + 1;
+		sTriangle * const newArray = new sTriangle[ newSize ];
+		if( pTriangles ){
+			memcpy( newArray, pTriangles, sizeof( sTriangle ) * pTriangleCount );
+			delete [] pTriangles;
+		}
+		pTriangles = newArray;
+		pTriangleSize = newSize;
+	}
+	
+	sTriangle &triangle = pTriangles[ pTriangleCount++ ];
+	
+	// edge functions are not negative inside the triangle
+	triangle.edgeA[ 0 ] = y1 - y2;
+	triangle.edgeB[ 0 ] = x2 - x1;
+	triangle.edgeC[ 0 ] = -( triangle.edgeA[ 0 ] * x1 + triangle.edgeB[ 0 ] * y1 );
+	
+	triangle.edgeA[ 1 ] = y2 - y3;
+	triangle.edgeB[ 1 ] = x3 - x2;
+	triangle.edgeC[ 1 ] = -( triangle.edgeA[ 1 ] * x2 + triangle.edgeB[ 1 ] * y2 );
+	
+	triangle.edgeA[ 2 ] = y3 - y1;
+	triangle.edgeB[ 2 ] = x1 - x3;
+	triangle.edgeC[ 2 ] = -( triangle.edgeA[ 2 ] * x3 + triangle.edgeB[ 2 ] * y3 );
+	
+	// inverse view distance is linear in screen space. clamping to the closest vertex
+	// prevents extrapolating beyond the triangle at pixels touching the edges
+	const float invArea = 1.0f / area;
+	triangle.depthA = ( ( z2 - z1 ) * ( y3 - y1 ) - ( z3 - z1 ) * ( y2 - y1 ) ) * invArea;
+	triangle.depthB = ( ( z3 - z1 ) * ( x2 - x1 ) - ( z2 - z1 ) * ( x3 - x1 ) ) * invArea;
+	triangle.depthC = z1 - triangle.depthA * x1 - triangle.depthB * y1;
+	triangle.depthMax = decMath::max( z1, z2, z3 );
+	
+	triangle.minX = minX;
+	triangle.minY = minY;
+	triangle.maxX = maxX;
+	triangle.maxY = maxY;
+}
+
+void deoglSoftwareOcclusionMap::pRasterizeTriangle( const sTriangle &triangle, int minY, int maxY ){
+	int x, y;
+	
+#ifdef DEOGLSOFTWAREOCCLUSIONMAP_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 offsetX = _mm_set_ps( 3.5f, 2.5f, 1.5f, 0.5f );
+	const __m128 edgeA0 = _mm_set1_ps( triangle.edgeA[ 0 ] );
+	const __m128 edgeA1 = _mm_set1_ps( triangle.edgeA[ 1 ] );
+	const __m128 edgeA2 = _mm_set1_ps( triangle.edgeA[ 2 ] );
+	const __m128 depthA = _mm_set1_ps( triangle.depthA );
+	const __m128 depthMax = _mm_set1_ps( triangle.depthMax );
+	
+	for( y=minY; y<maxY; y++ ){
+		const float py = ( float )y + 0.5f;
+		const __m128 rowEdge0 = _mm_set1_ps( triangle.edgeB[ 0 ] * py + triangle.edgeC[ 0 ] );
+		const __m128 rowEdge1 = _mm_set1_ps( triangle.edgeB[ 1 ] * py + triangle.edgeC[ 1 ] );
+		const __m128 rowEdge2 = _mm_set1_ps( triangle.edgeB[ 2 ] * py + triangle.edgeC[ 2 ] );
+		const __m128 rowDepth = _mm_set1_ps( triangle.depthB * py + triangle.depthC );
+		float * const row = pDepth + pWidth * y;
+		
+		for( x=triangle.minX; x<triangle.maxX; x+=4 ){
+			const __m128 px = _mm_add_ps( _mm_set1_ps( ( float )x ), offsetX );
+			
+			const __m128 inside = _mm_and_ps( _mm_and_ps(
+				_mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( edgeA0, px ), rowEdge0 ), zero ),
+				_mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( edgeA1, px ), rowEdge1 ), zero ) ),
+				_mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( edgeA2, px ), rowEdge2 ), zero ) );
+			
+			if( _mm_movemask_ps( inside ) == 0 ){
+				continue;
+			}
+			
+			// depth is never negative hence masked out pixels can use 0 with max
+			const __m128 depth = _mm_min_ps( _mm_add_ps( _mm_mul_ps( depthA, px ), rowDepth ), depthMax );
+			_mm_storeu_ps( row + x, _mm_max_ps( _mm_loadu_ps( row + x ), _mm_and_ps( inside, depth ) ) );
+		}
+	}
+	
+#else
+	for( y=minY; y<maxY; y++ ){
+		const float py = ( float )y + 0.5f;
+		const float rowEdge0 = triangle.edgeB[ 0 ] * py + triangle.edgeC[ 0 ];
+		const float rowEdge1 = triangle.edgeB[ 1 ] * py + triangle.edgeC[ 1 ];
+		const float rowEdge2 = triangle.edgeB[ 2 ] * py + triangle.edgeC[ 2 ];
+		const float rowDepth = triangle.depthB * py + triangle.depthC;
+		float * const row = pDepth + pWidth * y;
+		
+		for( x=triangle.minX; x<triangle.maxX; x++ ){
+			const float px = ( float )x + 0.5f;
+			
+			if( triangle.edgeA[ 0 ] * px + rowEdge0 >= 0.0f
+			&& triangle.edgeA[ 1 ] * px + rowEdge1 >= 0.0f
+			&& triangle.edgeA[ 2 ] * px + rowEdge2 >= 0.0f ){
+				const float depth = decMath::min( triangle.depthA * px + rowDepth, triangle.depthMax );
+				if( depth > row[ x ] ){
+					row[ x ] = depth;
+				}
+			}
+		}
+	}
+#endif
+}
+
+void deoglSoftwareOcclusionMap::pUpdateTileDepth( int band ){
+	const int tileRowsPerBand = BAND_HEIGHT / TILE_HEIGHT;
+	const int firstTileRow = band * tileRowsPerBand;
+	int tx, ty, px, py;
+	
+	for( ty=firstTileRow; ty<firstTileRow+tileRowsPerBand; ty++ ){
+		float * const tileRow = pTileDepth + pTileCountX * ty;
+		
+		for( tx=0; tx<pTileCountX; tx++ ){
+			const float *row = pDepth + pWidth * ty * TILE_HEIGHT + tx * TILE_WIDTH;
+			float minDepth = row[ 0 ];
+			
+			for( py=0; py<TILE_HEIGHT; py++, row+=pWidth ){
+				for( px=0; px<TILE_WIDTH; px++ ){
+					minDepth = decMath::min( minDepth, row[ px ] );
+				}
+			}
+			
+			tileRow[ tx ] = minDepth;
+		}
+	}
+}
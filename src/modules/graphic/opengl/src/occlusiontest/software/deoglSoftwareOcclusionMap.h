@@ -0,0 +1,198 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLSOFTWAREOCCLUSIONMAP_H_
+#define _DEOGLSOFTWAREOCCLUSIONMAP_H_
+
+#include <dragengine/common/math/decMath.h>
+
+
+/**
+ * \brief CPU rasterized hierarchical occlusion map.
+ *
+ * Rasterizes occluder triangles into a low resolution depth buffer and tests boxes
+ * against it. Positions are camera relative. The matrix transforms camera relative
+ * positions into clip space and has to produce the view distance as w coordinate like
+ * the non-infinite frustum matrix does. Depth is stored as inverse view distance hence
+ * the map is cleared to 0 and larger values are closer to the camera.
+ *
+ * Usage is split into three phases. First the map is cleared and occluders are added.
+ * Adding occluders transforms, clips and culls faces and stores the triangle setup.
+ * Then the triangles are rasterized. The map is divided into horizontal bands which
+ * can be rasterized in parallel since they do not share pixels. Each band rasterizes
+ * four pixels at a time using SSE if available. Rasterizing a band also updates the
+ * minimum depth of the tiles in the band. At last boxes are tested against the map.
+ * Tiles fully occluding the box are accepted without visiting the pixels.
+ *
+ * Tests are conservative in depth. A box is only reported occluded if all pixels it
+ * covers are closer to the camera than the closest point of the box.
+ *
+ * The class has no dependency on OpenGL.
+ */
+class deoglSoftwareOcclusionMap{
+public:
+	/** \brief Width of tile in pixels. */
+	static const int TILE_WIDTH = 8;
+	
+	/** \brief Height of tile in pixels. */
+	static const int TILE_HEIGHT = 4;
+	
+	/** \brief Height of band in pixels. */
+	static const int BAND_HEIGHT = 16;
+	
+	
+	
+private:
+	struct sTriangle{
+		float edgeA[ 3 ];
+		float edgeB[ 3 ];
+		float edgeC[ 3 ];
+		float depthA;
+		float depthB;
+		float depthC;
+		float depthMax;
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+	
+	struct sClipVertex{
+		float x;
+		float y;
+		float w;
+	};
+	
+	int pWidth;
+	int pHeight;
+	int pTileCountX;
+	int pTileCountY;
+	
+	float *pDepth;
+	float *pTileDepth;
+	
+	decMatrix pMatrix;
+	float pNearDistance;
+	
+	sTriangle *pTriangles;
+	int pTriangleCount;
+	int pTriangleSize;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create occlusion map. */
+	deoglSoftwareOcclusionMap( int width, int height );
+	
+	/** \brief Clean up occlusion map. */
+	~deoglSoftwareOcclusionMap();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Width in pixels. */
+	inline int GetWidth() const{ return pWidth; }
+	
+	/** \brief Height in pixels. */
+	inline int GetHeight() const{ return pHeight; }
+	
+	/**
+	 * \brief Set size.
+	 * \throws deeInvalidParam width is not a multiple of TILE_WIDTH.
+	 * \throws deeInvalidParam height is not a multiple of BAND_HEIGHT.
+	 */
+	void SetSize( int width, int height );
+	
+	/** \brief Camera relative position to clip space matrix. */
+	inline const decMatrix &GetMatrix() const{ return pMatrix; }
+	
+	/** \brief Near clip distance. */
+	inline float GetNearDistance() const{ return pNearDistance; }
+	
+	/** \brief Set camera relative position to clip space matrix and near clip distance. */
+	void SetMatrix( const decMatrix &matrix, float nearDistance );
+	
+	/** \brief Remove all triangles and clear depth. */
+	void Clear();
+	
+	/** \brief Number of triangles to rasterize. */
+	inline int GetTriangleCount() const{ return pTriangleCount; }
+	
+	/**
+	 * \brief Add occluder.
+	 * \param[in] positions First float of first vertex position.
+	 * \param[in] positionStride Distance between vertex positions in floats. At least 3.
+	 * \param[in] corners Vertex indices with three entries per face. Single sided faces
+	 *                    are followed by double sided faces.
+	 * \param[in] singleSidedFaceCount Number of single sided faces.
+	 * \param[in] doubleSidedFaceCount Number of double sided faces.
+	 * \param[in] matrix Transforms positions into camera relative positions.
+	 */
+	void AddOccluder( const float *positions, int positionStride, const unsigned short *corners,
+		int singleSidedFaceCount, int doubleSidedFaceCount, const decMatrix &matrix );
+	
+	/** \brief Number of bands. */
+	inline int GetBandCount() const{ return pHeight / BAND_HEIGHT; }
+	
+	/**
+	 * \brief Rasterize triangles into band.
+	 *
+	 * Different bands can be rasterized in parallel. Triangles can not be added while
+	 * bands are rasterized.
+	 */
+	void RasterizeBand( int band );
+	
+	/** \brief Rasterize triangles into all bands. */
+	void Rasterize();
+	
+	/**
+	 * \brief Box is potentially visible.
+	 *
+	 * Call after all bands have been rasterized. Thread safe.
+	 *
+	 * \param[in] minExtend Camera relative minimum extend of box.
+	 * \param[in] maxExtend Camera relative maximum extend of box.
+	 */
+	bool TestBox( const decVector &minExtend, const decVector &maxExtend ) const;
+	
+	/** \brief Depth at pixel for debugging. */
+	float GetDepthAt( int x, int y ) const;
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+	void pAddTriangle( const sClipVertex &v1, const sClipVertex &v2,
+		const sClipVertex &v3, bool doubleSided );
+	void pAddClippedTriangle( const sClipVertex &v1, const sClipVertex &v2,
+		const sClipVertex &v3, bool doubleSided );
+	void pAddSetupTriangle( float x1, float y1, float z1, float x2, float y2, float z2,
+		float x3, float y3, float z3, float area );
+	void pRasterizeTriangle( const sTriangle &triangle, int minY, int maxY );
+	void pUpdateTileDepth( int band );
+};
+
+#endif
@@ -0,0 +1,131 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoglSoftwareOcclusionTest.h"
+#include "deoglSoftwareOcclusionTestTask.h"
+#include "../../deGraphicOpenGl.h"
+#include "../../renderthread/deoglRenderThread.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/parallel/deParallelTaskReference.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Definitions
+////////////////
+
+// size of the occlusion map. small enough to be rasterized quickly but large enough
+// to not lose too much occlusion along occluder edges
+#define MAP_WIDTH 256
+#define MAP_HEIGHT 128
+
+
+
+// Class deoglSoftwareOcclusionTest
+/////////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoglSoftwareOcclusionTest::deoglSoftwareOcclusionTest( deoglRenderThread &renderThread ) :
+pRenderThread( renderThread ),
+pMap( MAP_WIDTH, MAP_HEIGHT ),
+pNextBand( 0 ),
+pBandCount( 0 ),
+pRunningBandCount( 0 ),
+pPendingTaskCount( 0 ),
+pWaiting( false ){
+}
+
+deoglSoftwareOcclusionTest::~deoglSoftwareOcclusionTest(){
+}
+
+
+
+// Management
+///////////////
+
+void deoglSoftwareOcclusionTest::Rasterize(){
+	deParallelProcessing &parallel = pRenderThread.GetOgl().GetGameEngine()->GetParallelProcessing();
+	const int bandCount = pMap.GetBandCount();
+	deMutexGuard guard( pMutex );
+	
+	pNextBand = 0;
+	pBandCount = bandCount;
+	pRunningBandCount = 0;
+	
+	// tasks still pending from earlier calls join the work once they start running
+	const int taskCount = decMath::max( decMath::min( parallel.GetCoreCount() - 1, bandCount - 1 )
+		- pPendingTaskCount, 0 );
+	pPendingTaskCount += taskCount;
+	
+	guard.Unlock();
+	
+	int i;
+	for( i=0; i<taskCount; i++ ){
+		deParallelTaskReference task;
+		task.TakeOver( new deoglSoftwareOcclusionTestTask( *this ) );
+		parallel.AddTaskAsync( task );
+	}
+	
+	RasterizeBands();
+	
+	guard.Lock();
+	if( pRunningBandCount == 0 ){
+		return;
+	}
+	pWaiting = true;
+	guard.Unlock();
+	
+	pSemaphoreFinished.Wait();
+}
+
+void deoglSoftwareOcclusionTest::RasterizeBands(){
+	deMutexGuard guard( pMutex );
+	
+	while( pNextBand < pBandCount ){
+		const int band = pNextBand++;
+		pRunningBandCount++;
+		guard.Unlock();
+		
+		pMap.RasterizeBand( band );
+		
+		guard.Lock();
+		pRunningBandCount--;
+		
+		if( pRunningBandCount == 0 && pNextBand == pBandCount && pWaiting ){
+			pWaiting = false;
+			pSemaphoreFinished.Signal();
+		}
+	}
+}
+
+void deoglSoftwareOcclusionTest::TaskStarted(){
+	deMutexGuard guard( pMutex );
+	pPendingTaskCount--;
+}
@@ -0,0 +1,98 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLSOFTWAREOCCLUSIONTEST_H_
+#define _DEOGLSOFTWAREOCCLUSIONTEST_H_
+
+#include "deoglSoftwareOcclusionMap.h"
+
+#include <dragengine/threading/deMutex.h>
+#include <dragengine/threading/deSemaphore.h>
+#include <dragengine/threading/deThreadSafeObject.h>
+
+class deoglRenderThread;
+
+
+
+/**
+ * \brief Software occlusion test.
+ *
+ * Owns a software occlusion map and rasterizes its bands in parallel. Rasterize() is
+ * called by the render thread. Parallel tasks are added asynchronously and claim bands
+ * until none are left. The render thread claims bands too and then waits only for bands
+ * still running. Tasks not started yet find no bands left and return. This prevents
+ * stalling the render thread if the parallel processing is busy or paused. Tasks hold
+ * a reference to the test hence it stays alive while tasks are pending.
+ */
+class deoglSoftwareOcclusionTest : public deThreadSafeObject{
+private:
+	deoglRenderThread &pRenderThread;
+	deoglSoftwareOcclusionMap pMap;
+	
+	deMutex pMutex;
+	deSemaphore pSemaphoreFinished;
+	int pNextBand;
+	int pBandCount;
+	int pRunningBandCount;
+	int pPendingTaskCount;
+	bool pWaiting;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create software occlusion test. */
+	deoglSoftwareOcclusionTest( deoglRenderThread &renderThread );
+	
+protected:
+	/** \brief Clean up software occlusion test. */
+	virtual ~deoglSoftwareOcclusionTest();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Render thread. */
+	inline deoglRenderThread &GetRenderThread() const{ return pRenderThread; }
+	
+	/** \brief Occlusion map. */
+	inline deoglSoftwareOcclusionMap &GetMap(){ return pMap; }
+	inline const deoglSoftwareOcclusionMap &GetMap() const{ return pMap; }
+	
+	/**
+	 * \brief Rasterize occlusion map.
+	 *
+	 * Returns after all bands have been rasterized. Call only from the render thread.
+	 */
+	void Rasterize();
+	
+	/** \brief Rasterize bands until none are left. For use by parallel tasks. */
+	void RasterizeBands();
+	
+	/** \brief Parallel task started running. For use by parallel tasks. */
+	void TaskStarted();
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,72 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLSOFTWAREOCCLUSIONTESTTASK_H_
+#define _DEOGLSOFTWAREOCCLUSIONTESTTASK_H_
+
+#include <dragengine/parallel/deParallelTask.h>
+
+class deoglSoftwareOcclusionTest;
+
+
+
+/**
+ * \brief Parallel task rasterizing software occlusion map bands.
+ */
+class deoglSoftwareOcclusionTestTask : public deParallelTask{
+private:
+	deoglSoftwareOcclusionTest *pTest;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create task. */
+	deoglSoftwareOcclusionTestTask( deoglSoftwareOcclusionTest &test );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~deoglSoftwareOcclusionTestTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	/*@}*/
+};
+
+#endif
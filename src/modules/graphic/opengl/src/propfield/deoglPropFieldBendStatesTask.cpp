@@ -0,0 +1,82 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "deoglPropFieldBendStatesTask.h"
+#include "deoglRPropField.h"
+#include "deoglRPropFieldType.h"
+#include "../deGraphicOpenGl.h"
+#include "../renderthread/deoglRenderThread.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class deoglPropFieldBendStatesTask
+///////////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+deoglPropFieldBendStatesTask::deoglPropFieldBendStatesTask( deoglRPropFieldType &type,
+int firstCluster, int clusterCount ) :
+deParallelTask( &type.GetPropField().GetRenderThread().GetOgl() ),
+pType( type ),
+pFirstCluster( firstCluster ),
+pClusterCount( clusterCount ),
+pFailed( false ){
+}
+
+deoglPropFieldBendStatesTask::~deoglPropFieldBendStatesTask(){
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void deoglPropFieldBendStatesTask::Run(){
+	try{
+		pType.PrepareClusterBendStateData( pFirstCluster, pClusterCount );
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void deoglPropFieldBendStatesTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString deoglPropFieldBendStatesTask::GetDebugName() const{
+	return "OpenGL:PropFieldBendStates";
+}
+
+decString deoglPropFieldBendStatesTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "first=%d count=%d", pFirstCluster, pClusterCount );
+	return details;
+}
@@ -0,0 +1,100 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLPROPFIELDBENDSTATESTASK_H_
+#define _DEOGLPROPFIELDBENDSTATESTASK_H_
+
+#include <dragengine/parallel/deParallelTask.h>
+
+class deoglRPropFieldType;
+
+
+
+/**
+ * \brief Parallel task preparing bend state data of a range of prop field type clusters.
+ * 
+ * If an exception is thrown the task is marked failed and the caller has to prepare
+ * the clusters.
+ */
+class deoglPropFieldBendStatesTask : public deParallelTask{
+private:
+	deoglRPropFieldType &pType;
+	int pFirstCluster;
+	int pClusterCount;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create task.
+	 * \param[in] type Prop field type. Has to stay valid until the task finished.
+	 * \param[in] firstCluster Index of first cluster to prepare.
+	 * \param[in] clusterCount Number of clusters to prepare.
+	 */
+	deoglPropFieldBendStatesTask( deoglRPropFieldType &type, int firstCluster, int clusterCount );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~deoglPropFieldBendStatesTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Index of first cluster to prepare. */
+	inline int GetFirstCluster() const{ return pFirstCluster; }
+	
+	/** \brief Number of clusters to prepare. */
+	inline int GetClusterCount() const{ return pClusterCount; }
+	
+	/** \brief Preparing failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
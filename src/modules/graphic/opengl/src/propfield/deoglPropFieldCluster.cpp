@@ -49,8 +49,6 @@
 #include "../world/deoglRWorld.h"
 
 #include <dragengine/common/exceptions.h>
-#include <dragengine/resources/propfield/dePropFieldBendState.h>
-#include <dragengine/resources/propfield/dePropFieldType.h>
 
 
 
@@ -65,8 +63,12 @@ pPropFieldType( propFieldType ),
 pRenderThread( propFieldType.GetPropField().GetRenderThread() ),
 
 pInstances( NULL ),
+pInstanceBendStates( NULL ),
 pInstanceCount( 0 ),
 
+pUsedBendStates( NULL ),
+pUsedBendStateCount( 0 ),
+
 pBendStateData( NULL ),
 pBendStateDataSize( 0 ),
 
@@ -98,6 +100,12 @@ deoglPropFieldCluster::~deoglPropFieldCluster(){
 	if( pBendStateData ){
 		delete [] pBendStateData;
 	}
+	if( pUsedBendStates ){
+		delete [] pUsedBendStates;
+	}
+	if( pInstanceBendStates ){
+		delete [] pInstanceBendStates;
+	}
 	if( pInstances ){
 		delete [] pInstances;
 	}
@@ -150,19 +158,83 @@ void deoglPropFieldCluster::SetInstanceCount( int count ){
 	
 	if( count != pInstanceCount ){
 		sInstance *instances = NULL;
+		int *bendStates = NULL;
 		
 		if( count > 0 ){
-			instances = new sInstance[ count ];
+			try{
+				instances = new sInstance[ count ];
+				bendStates = new int[ count ];
+				
+			}catch( const deException & ){
+				if( instances ){
+					delete [] instances;
+				}
+				throw;
+			}
 		}
 		
+		if( pInstanceBendStates ){
+			delete [] pInstanceBendStates;
+		}
 		if( pInstances ){
 			delete [] pInstances;
 		}
 		pInstances = instances;
+		pInstanceBendStates = bendStates;
 		pInstanceCount = count;
+		pUsedBendStateCount = 0;
 	}
 }
 
+void deoglPropFieldCluster::UpdateUsedBendStates(){
+	int i, maxBendState = -1;
+	
+	for( i=0; i<pInstanceCount; i++ ){
+		maxBendState = decMath::max( maxBendState, pInstanceBendStates[ i ] );
+	}
+	
+	if( pUsedBendStates ){
+		delete [] pUsedBendStates;
+		pUsedBendStates = NULL;
+	}
+	pUsedBendStateCount = 0;
+	
+	if( maxBendState == -1 ){
+		return;
+	}
+	
+	// instances of a cluster are close to each other and typically use only a few bend states
+	bool * const used = new bool[ maxBendState + 1 ];
+	
+	try{
+		memset( used, 0, sizeof( bool ) * ( maxBendState + 1 ) );
+		
+		for( i=0; i<pInstanceCount; i++ ){
+			const int bendState = pInstanceBendStates[ i ];
+			if( bendState >= 0 && ! used[ bendState ] ){
+				used[ bendState ] = true;
+				pUsedBendStateCount++;
+			}
+		}
+		
+		pUsedBendStates = new int[ pUsedBendStateCount ];
+		
+	}catch( const deException & ){
+		delete [] used;
+		pUsedBendStateCount = 0;
+		throw;
+	}
+	
+	pUsedBendStateCount = 0;
+	for( i=0; i<=maxBendState; i++ ){
+		if( used[ i ] ){
+			pUsedBendStates[ pUsedBendStateCount++ ] = i;
+		}
+	}
+	
+	delete [] used;
+}
+
 
 
 void deoglPropFieldCluster::UpdateTBOs(){
@@ -260,10 +332,11 @@ void deoglPropFieldCluster::UpdateTBOBendStates(){
 	}
 }
 
-void deoglPropFieldCluster::PrepareBendStateData( const dePropFieldType &type ){
-	const dePropFieldBendState * const engBendStates = type.GetBendStates();
-	const int engBendStateCount = type.GetBendStateCount();
+void deoglPropFieldCluster::PrepareBendStateData( const HALF_FLOAT *bendStates,
+const bool *changedBendStates, int bendStateCount ){
 	const int vboDataSize = pInstanceCount * 4; // sizeof( halfFloat ) * 2
+	bool changed = false;
+	int i;
 	
 	if( vboDataSize > pBendStateDataSize ){
 		if( pBendStateData ){
@@ -276,22 +349,34 @@ void deoglPropFieldCluster::PrepareBendStateData( const dePropFieldType &type ){
 			pBendStateData = new char[ vboDataSize ];
 			pBendStateDataSize = vboDataSize;
 		}
+		
+		changed = true;
+	}
+	
+	// skip the update if none of the bend states used by the instances changed. instances
+	// with bend states outside the valid range use zero bending which never changes
+	for( i=0; ! changed && i<pUsedBendStateCount; i++ ){
+		const int bendState = pUsedBendStates[ i ];
+		changed = bendState >= bendStateCount || changedBendStates[ bendState ];
+	}
+	
+	if( ! changed ){
+		return;
 	}
 	
 	HALF_FLOAT * const vboData = ( HALF_FLOAT* )pBendStateData;
 	const HALF_FLOAT halfZero = CONVERT_FLOAT_TO_HALF( 0.0f );
 	HALF_FLOAT *vboDataPtr = vboData;
-	int i;
 	
 	for( i=0; i<pInstanceCount; i++ ){
-		const sInstance &instance = pInstances[ i ];
+		const int bendState = pInstanceBendStates[ i ];
 		
 		// pixel 1: bend.x, bend.z
-		if( instance.bstate >= 0 && instance.bstate < engBendStateCount ){
-			const dePropFieldBendState &engBendState = engBendStates[ instance.bstate ];
+		if( bendState >= 0 && bendState < bendStateCount ){
+			const HALF_FLOAT * const bend = bendStates + bendState * 2;
 			
-			*( vboDataPtr++ ) = CONVERT_FLOAT_TO_HALF( engBendState.GetBendX() ); // pixel 1 r: bend.x
-			*( vboDataPtr++ ) = CONVERT_FLOAT_TO_HALF( engBendState.GetBendZ() ); // pixel 1 g: bend.z
+			*( vboDataPtr++ ) = bend[ 0 ]; // pixel 1 r: bend.x
+			*( vboDataPtr++ ) = bend[ 1 ]; // pixel 1 g: bend.z
 			
 		}else{
 			*( vboDataPtr++ ) = halfZero; // pixel 1 r: bend.x
@@ -26,8 +26,8 @@
 
 #include "../deoglBasics.h"
 #include "../skin/deoglSkinTexture.h"
+#include "../utils/deoglConvertFloatHalf.h"
 
-class dePropFieldType;
 class deoglRPropFieldType;
 class deoglTexUnitsConfig;
 
@@ -37,6 +37,10 @@ class deoglTexUnitsConfig;
  * @brief Prop Field Cluster.
  * Cluster in a prop field resource. Clusters are a cubic area containing a set
  * of prop field instances belonging to the same type.
+ * 
+ * Bend state indices of instances are stored in a separate array since they are the only
+ * instance parameter accessed while updating bend states. The list of distinct bend states
+ * used by the instances allows to skip updating clusters if none of these changed.
  */
 class deoglPropFieldCluster{
 public:
@@ -46,7 +50,6 @@ public:
 		float rotation[ 9 ];
 		float position[ 3 ];
 		float scaling;
-		int bstate;
 	};
 	
 private:
@@ -57,8 +60,12 @@ private:
 	decVector pMaxExtend;
 	
 	sInstance *pInstances;
+	int *pInstanceBendStates;
 	int pInstanceCount;
 	
+	int *pUsedBendStates;
+	int pUsedBendStateCount;
+	
 	char *pBendStateData;
 	int pBendStateDataSize;
 	
@@ -105,6 +112,13 @@ public:
 	void SetInstanceCount( int count );
 	/** Retrieves the instances. */
 	inline sInstance *GetInstances() const{ return pInstances; }
+	/** Retrieves the instance bend state indices. */
+	inline int *GetInstanceBendStates() const{ return pInstanceBendStates; }
+	
+	/** \brief Number of distinct bend states used by instances. */
+	inline int GetUsedBendStateCount() const{ return pUsedBendStateCount; }
+	/** \brief Update list of distinct bend states used by instances. Call after setting instances. */
+	void UpdateUsedBendStates();
 	
 	/** Retrieves the instances TBO. */
 	inline GLuint GetTBOInstances() const{ return pTBOInstances; }
@@ -121,8 +135,17 @@ public:
 	/** Update tbo bend states. */
 	void UpdateTBOBendStates();
 	
-	/** \brief Prepare bend state data. */
-	void PrepareBendStateData( const dePropFieldType &type );
+	/**
+	 * \brief Prepare bend state data.
+	 * \param[in] bendStates Bend X and Z as half float for each bend state.
+	 * \param[in] changedBendStates Bend state changed since the last call.
+	 * \param[in] bendStateCount Number of bend states.
+	 * 
+	 * Does nothing if none of the bend states used by the instances changed. Safe to be
+	 * called in parallel for different clusters.
+	 */
+	void PrepareBendStateData( const HALF_FLOAT *bendStates,
+		const bool *changedBendStates, int bendStateCount );
 	
 	/** Retrieves the texture units configuration for the given shader type. */
 	deoglTexUnitsConfig *GetTUCForShaderType( deoglSkinTexture::eShaderTypes shaderType );
@@ -26,6 +26,7 @@
 #include "deoglRPropField.h"
 #include "deoglRPropFieldType.h"
 #include "deoglPropFieldCluster.h"
+#include "deoglPropFieldBendStatesTask.h"
 #include "deoglPointSieve.h"
 #include "deoglPointSieveBucket.h"
 #include "deoglPFClusterGenerator.h"
@@ -54,7 +55,11 @@
 #include "../delayedoperation/deoglDelayedDeletion.h"
 #include "../delayedoperation/deoglDelayedOperations.h"
 
+#include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
+#include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
 #include <dragengine/resources/propfield/dePropField.h>
 #include <dragengine/resources/propfield/dePropFieldType.h>
 #include <dragengine/resources/propfield/dePropFieldInstance.h>
@@ -62,6 +67,14 @@
 
 
 
+// Definitions
+////////////////
+
+// minimum number of instances of a type to prepare cluster bend states using parallel tasks
+#define PARALLEL_BEND_STATE_INSTANCE_COUNT 16384
+
+
+
 // Class deoglRPropFieldType
 /////////////////////////////
 
@@ -78,6 +91,12 @@ pUseSkinTexture( NULL ),
 
 pBendFactor( 1.0f ),
 
+pBendStates( NULL ),
+pChangedBendStates( NULL ),
+pBendStateCount( 0 ),
+pBendStateSize( 0 ),
+pDirtyClusterBendStates( true ),
+
 pParamBlock( NULL ),
 
 pValidParamBlock( false ),
@@ -132,6 +151,12 @@ public:
 
 deoglRPropFieldType::~deoglRPropFieldType(){
 	LEAK_CHECK_FREE( pPropField.GetRenderThread(), PropFieldType );
+	if( pChangedBendStates ){
+		delete [] pChangedBendStates;
+	}
+	if( pBendStates ){
+		delete [] pBendStates;
+	}
 	if( pSkin ){
 		pSkin->FreeReference();
 	}
@@ -211,6 +236,7 @@ void deoglRPropFieldType::RebuildInstances( const dePropFieldType &type ){
 	pBendFactor = 1.0f;
 	
 	RemoveAllClusters();
+	pDirtyClusterBendStates = true;
 	
 	if( ! pModel || ! pSkin ){
 		return;
@@ -291,6 +317,7 @@ void deoglRPropFieldType::AddClustersWithSieve( const dePropFieldType &type ){
 			
 			cluster->SetInstanceCount( indexCount );
 			deoglPropFieldCluster::sInstance * const pfInstances = cluster->GetInstances();
+			int * const pfBendStates = cluster->GetInstanceBendStates();
 			
 			for( i=0; i< indexCount; i++ ){
 				const int index = bucket.GetIndexAt( i );
@@ -329,9 +356,10 @@ void deoglRPropFieldType::AddClustersWithSieve( const dePropFieldType &type ){
 				pfinst.position[ 1 ] = ipos.y;
 				pfinst.position[ 2 ] = ipos.z;
 				pfinst.scaling = iscale;
-				pfinst.bstate = engInstances[ index ].GetBendState();
+				pfBendStates[ i ] = engInstances[ index ].GetBendState();
 			}
 			
+			cluster->UpdateUsedBendStates();
 			cluster->SetExtends( clusterMinExtend, clusterMaxExtend );
 			
 			AddCluster( cluster );
@@ -382,6 +410,7 @@ void deoglRPropFieldType::AddClustersFromGenerator( const dePropFieldType &type,
 			cluster = new deoglPropFieldCluster( *this );
 			cluster->SetInstanceCount( entryCount );
 			deoglPropFieldCluster::sInstance * const instances = cluster->GetInstances();
+			int * const bendStates = cluster->GetInstanceBendStates();
 			
 			for( i=0; i<entryCount; i++ ){
 				const int index = entries[ i ].index;
@@ -419,9 +448,10 @@ void deoglRPropFieldType::AddClustersFromGenerator( const dePropFieldType &type,
 				instance.position[ 1 ] = ipos.y;
 				instance.position[ 2 ] = ipos.z;
 				instance.scaling = iscale;
-				instance.bstate = engInstances[ index ].GetBendState();
+				bendStates[ i ] = engInstances[ index ].GetBendState();
 			}
 			
+			cluster->UpdateUsedBendStates();
 			cluster->SetExtends( clusterMinExtend, clusterMaxExtend );
 			
 			AddCluster( cluster );
@@ -516,11 +546,70 @@ void deoglRPropFieldType::RemoveAllClusters(){
 
 
 void deoglRPropFieldType::PrepareBendStateData( const dePropFieldType &type ){
-	const int count = pClusters.GetCount();
+	if( ! pUpdateBendStates( type ) && ! pDirtyClusterBendStates ){
+		return;
+	}
+	
+	const int clusterCount = pClusters.GetCount();
+	deParallelProcessing &parallelProcessing = pPropField.GetRenderThread().GetOgl()
+		.GetGameEngine()->GetParallelProcessing();
+	
+	// parallel processing is paused if the engine is in progress of being stopped.
+	// prepare the clusters directly in this case
+	if( type.GetInstanceCount() < PARALLEL_BEND_STATE_INSTANCE_COUNT || clusterCount < 2
+	|| parallelProcessing.GetCoreCount() < 2 || parallelProcessing.GetPaused() ){
+		PrepareClusterBendStateData( 0, clusterCount );
+		pDirtyClusterBendStates = false;
+		return;
+	}
+	
+	// clusters only write their own bend state data hence ranges of clusters can be
+	// prepared by parallel tasks
+	const int taskTarget = parallelProcessing.GetCoreCount() * 2;
+	const int clustersPerTask = ( clusterCount + taskTarget - 1 ) / taskTarget;
+	decThreadSafeObjectOrderedSet tasks;
+	deThreadSafeObjectReference task;
 	int i;
 	
+	try{
+		for( i=0; i<clusterCount; i+=clustersPerTask ){
+			task.TakeOver( new deoglPropFieldBendStatesTask( *this, i,
+				decMath::min( clustersPerTask, clusterCount - i ) ) );
+			tasks.Add( task );
+			parallelProcessing.AddTask( ( deoglPropFieldBendStatesTask* )( deThreadSafeObject* )task );
+		}
+		
+	}catch( const deException & ){
+		const int count = tasks.GetCount();
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( deoglPropFieldBendStatesTask* )tasks.GetAt( i ) );
+		}
+		throw;
+	}
+	
+	const int count = tasks.GetCount();
+	for( i=0; i<count; i++ ){
+		parallelProcessing.WaitForTask( ( deoglPropFieldBendStatesTask* )tasks.GetAt( i ) );
+	}
+	
+	// prepare clusters of failed tasks again. this time exceptions are thrown
 	for( i=0; i<count; i++ ){
-		( ( deoglPropFieldCluster* )pClusters.GetAt( i ) )->PrepareBendStateData( type );
+		const deoglPropFieldBendStatesTask &bendStatesTask = *( ( deoglPropFieldBendStatesTask* )tasks.GetAt( i ) );
+		if( bendStatesTask.GetFailed() ){
+			PrepareClusterBendStateData( bendStatesTask.GetFirstCluster(), bendStatesTask.GetClusterCount() );
+		}
+	}
+	
+	pDirtyClusterBendStates = false;
+}
+
+void deoglRPropFieldType::PrepareClusterBendStateData( int firstCluster, int clusterCount ){
+	const int lastCluster = firstCluster + clusterCount;
+	int i;
+	
+	for( i=firstCluster; i<lastCluster; i++ ){
+		( ( deoglPropFieldCluster* )pClusters.GetAt( i ) )->PrepareBendStateData(
+			pBendStates, pChangedBendStates, pBendStateCount );
 	}
 }
 
@@ -552,144 +641,201 @@ deoglSPBlockUBO *deoglRPropFieldType::GetParamBlock(){
 				pParamBlock = skinShader.CreateSPBInstParam();
 			//}
 		}
-		
+			
 		pValidParamBlock = true;
 		pDirtyParamBlock = true;
 	}
-	
+		
 	if( pDirtyParamBlock ){
 		if( pParamBlock ){
 			UpdateInstanceParamBlock( *pParamBlock, *pUseSkinTexture->GetShaderFor( deoglSkinTexture::estPropFieldGeometry ) );
 		}
-		
+			
 		pDirtyParamBlock = false;
 	}
-	
+		
 	return pParamBlock;
 }
-
+	
 void deoglRPropFieldType::InvalidateParamBlocks(){
 	pValidParamBlock = false;
 	MarkParamBlocksDirty();
 }
-
+	
 void deoglRPropFieldType::MarkParamBlocksDirty(){
 	pDirtyParamBlock = true;
 }
-
+	
 void deoglRPropFieldType::MarkTUCsDirty(){
 	const int count = pClusters.GetCount();
 	int i;
-	
+		
 	for( i=0; i<count; i++ ){
 		( ( deoglPropFieldCluster* )pClusters.GetAt( i ) )->MarkTUCsDirty();
 	}
 }
-
-
-
+	
+	
+	
 void deoglRPropFieldType::UpdateInstanceParamBlock( deoglSPBlockUBO &paramBlock, deoglSkinShader &skinShader ){
 	deoglRDynamicSkin *useDynamicSkin = NULL;
 	deoglSkinState *useSkinState = NULL;
-	
+		
 	if( ! pUseSkinTexture ){
 		return;
 	}
-	
+		
 	paramBlock.MapBuffer();
 	try{
 		// prop field matrix
 		const decDVector &referencePosition = pPropField.GetParentWorld()->GetReferencePosition();
 		const decDVector &pfpos = pPropField.GetPosition();
 		decDMatrix matrixModel = decDMatrix::CreateTranslation( pfpos - referencePosition );
-		
+			
 		//printf( "propfield=%p type=%p pos=(%f,%f,%f)\n", pPropField->GetPropField(), pType, matrixModel.a14, matrixModel.a24, matrixModel.a34 );
-		
+			
 		// update shader parameter block
 		int target;
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutMatrixModel );
 		if( target != -1 ){
 			paramBlock.SetParameterDataMat4x3( target, matrixModel );
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutMatrixNormal );
 		if( target != -1 ){
 			paramBlock.SetParameterDataMat3x3( target, decDMatrix() ); // inverse of 0-rotation
 		}
-		
+			
 		// per texture properties
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutMatrixTexCoord );
 		if( target != -1 ){
 			paramBlock.SetParameterDataMat3x2( target, decTexMatrix() );
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutPropFieldParams );
 		if( target != -1 ){
 			paramBlock.SetParameterDataFloat( target, pBendFactor );
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutDoubleSided );
 		if( target != -1 ){
 			if( pModel ){
 				paramBlock.SetParameterDataBool( target, pModel->GetLODAt( 0 ).GetTextureAt( 0 ).GetDoubleSided() );
-				
+					
 			}else{
 				paramBlock.SetParameterDataBool( target, false );
 			}
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutEnvMapFade );
 		if( target != -1 ){
 			paramBlock.SetParameterDataFloat( target, 0.0f );
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutVariationSeed );
 		if( target != -1 ){
 			if( useSkinState ){
 				paramBlock.SetParameterDataVec2( target, useSkinState->GetVariationSeed() );
-				
+					
 			}else{
 				paramBlock.SetParameterDataVec2( target, 0.0f, 0.0f );
 			}
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutBillboardPosTransform );
 		if( target != -1 ){
 			decVector2 scale = decVector2( 1.0f, 1.0f );
 			decVector2 offset;
-			
+				
 			if( pModel && pModel->GetImposterBillboard() ){
 				const deoglImposterBillboard &billboard = *pModel->GetImposterBillboard();
 				const decVector2 &minExtend = billboard.GetMinExtend();
 				const decVector2 &maxExtend = billboard.GetMaxExtend();
-				
+					
 				scale.x = ( maxExtend.x - minExtend.x ) * 0.5f;
 				scale.y = ( maxExtend.y - minExtend.y ) * 0.5f;
 				offset.x = ( maxExtend.x + minExtend.x ) * 0.5f;
 				offset.y = ( maxExtend.y + minExtend.y ) * 0.5f;
 			}
-			
+				
 			paramBlock.SetParameterDataVec4( target, scale.x, scale.y, offset.x, offset.y );
 		}
-		
+			
 		target = skinShader.GetInstanceUniformTarget( deoglSkinShader::eiutBillboardParams );
 		if( target != -1 ){
 			paramBlock.SetParameterDataBVec3( target, false, false, false );
 		}
-		
+			
 		// per texture dynamic texture properties
 		skinShader.SetDynTexParamsInInstParamSPB( paramBlock, *pUseSkinTexture, useSkinState, useDynamicSkin );
-		
+			
 	}catch( const deException & ){
 		paramBlock.UnmapBuffer();
 		throw;
 	}
 	paramBlock.UnmapBuffer();
 }
-
-
-
+	
+	
+	
 void deoglRPropFieldType::WorldReferencePointChanged(){
 	pDirtyParamBlock = true;
 }
+	
+	
+	
+// Private Functions
+//////////////////////
+	
+bool deoglRPropFieldType::pUpdateBendStates( const dePropFieldType &type ){
+	const dePropFieldBendState * const engBendStates = type.GetBendStates();
+	const int count = type.GetBendStateCount();
+		
+	if( count > pBendStateSize ){
+		HALF_FLOAT * const bendStates = new HALF_FLOAT[ count * 2 ];
+		bool *changedBendStates = NULL;
+			
+		try{
+			changedBendStates = new bool[ count ];
+				
+		}catch( const deException & ){
+			delete [] bendStates;
+			throw;
+		}
+			
+		if( pChangedBendStates ){
+			delete [] pChangedBendStates;
+		}
+		if( pBendStates ){
+			delete [] pBendStates;
+		}
+		pBendStates = bendStates;
+		pChangedBendStates = changedBendStates;
+		pBendStateSize = count;
+	}
+		
+	// compare in half float precision. changes below this precision do not alter the
+	// bend state data. if the count changed all bend states are considered changed
+	const bool countChanged = count != pBendStateCount;
+	bool changed = countChanged;
+	int i;
+		
+	pBendStateCount = count;
+		
+	for( i=0; i<count; i++ ){
+		const HALF_FLOAT bendX = convertFloatToHalf( engBendStates[ i ].GetBendX() );
+		const HALF_FLOAT bendZ = convertFloatToHalf( engBendStates[ i ].GetBendZ() );
+		HALF_FLOAT * const bend = pBendStates + i * 2;
+			
+		pChangedBendStates[ i ] = countChanged || bend[ 0 ] != bendX || bend[ 1 ] != bendZ;
+			
+		if( pChangedBendStates[ i ] ){
+			bend[ 0 ] = bendX;
+			bend[ 1 ] = bendZ;
+			changed = true;
+		}
+	}
+		
+	return changed;
+}
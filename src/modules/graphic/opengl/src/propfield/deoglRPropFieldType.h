@@ -26,6 +26,7 @@
 #include <dragengine/common/collection/decPointerList.h>
 #include <dragengine/deObject.h>
 #include "../skin/deoglSkinTexture.h"
+#include "../utils/deoglConvertFloatHalf.h"
 
 class deoglPFClusterGenerator;
 class deoglPropFieldCluster;
@@ -43,6 +44,10 @@ class dePropFieldType;
 
 /**
  * \brief Render prop field type.
+ * 
+ * Bend states are converted to half floats once per type and compared against the values
+ * of the last update. Clusters only update their bend state data if one of the bend states
+ * used by their instances changed. Types with many instances update clusters in parallel.
  */
 class deoglRPropFieldType : public deObject{
 private:
@@ -59,6 +64,12 @@ private:
 	decVector pMaxExtend;
 	float pBendFactor;
 	
+	HALF_FLOAT *pBendStates;
+	bool *pChangedBendStates;
+	int pBendStateCount;
+	int pBendStateSize;
+	bool pDirtyClusterBendStates;
+	
 	deoglSPBlockUBO *pParamBlock;
 	
 	bool pValidParamBlock;
@@ -152,6 +163,9 @@ public:
 	/** \brief Prepare bend states. */
 	void PrepareBendStateData( const dePropFieldType &type );
 	
+	/** \brief Prepare bend states of range of clusters. Safe to be called in parallel. */
+	void PrepareClusterBendStateData( int firstCluster, int clusterCount );
+	
 	
 	
 	/** \brief Shader parameter block for a shader type. */
@@ -180,6 +194,11 @@ public:
 	/** \brief World reference point changed. */
 	void WorldReferencePointChanged();
 	/*@}*/
+	
+	
+	
+private:
+	bool pUpdateBendStates( const dePropFieldType &type );
 };
 
 #endif
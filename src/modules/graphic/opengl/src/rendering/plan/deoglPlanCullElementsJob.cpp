@@ -0,0 +1,203 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoglPlanCullElementsJob.h"
+#include "deoglPlanCullElementsTask.h"
+#include "../../deGraphicOpenGl.h"
+#include "../../renderthread/deoglRenderThread.h"
+#include "../../world/deoglWorldOctree.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/parallel/deParallelTaskReference.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Class deoglPlanCullElementsJob
+///////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoglPlanCullElementsJob::deoglPlanCullElementsJob( deoglRenderThread &renderThread ) :
+pRenderThread( renderThread ),
+pVisitor( NULL ),
+pSubTrees( NULL ),
+pSubTreeCount( 0 ),
+pSubTreeSize( 0 ),
+pNextSubTree( 0 ),
+pRunningSubTreeCount( 0 ),
+pPendingTaskCount( 0 ),
+pWaiting( false ),
+pException( NULL ){
+}
+
+deoglPlanCullElementsJob::~deoglPlanCullElementsJob(){
+	if( pException ){
+		delete pException;
+	}
+	if( pSubTrees ){
+		while( pSubTreeSize > 0 ){
+			pSubTreeSize--;
+			delete pSubTrees[ pSubTreeSize ];
+		}
+		delete [] pSubTrees;
+	}
+}
+
+
+
+// Management
+///////////////
+
+const deoglPlanVisitorCullElements::sElements &deoglPlanCullElementsJob::GetElementsAt( int index ) const{
+	if( index < 0 || index >= pSubTreeCount ){
+		DETHROW( deeInvalidParam );
+	}
+	return pSubTrees[ index ]->elements;
+}
+
+void deoglPlanCullElementsJob::AddSubTree( const deoglWorldOctree *node ){
+	if( ! node ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	if( pSubTreeCount == pSubTreeSize ){
+		const int newSize = pSubTreeSize * 3 / 2 + 1;
+		sSubTree ** const newArray = new sSubTree*[ newSize ];
+		if( pSubTrees ){
+			memcpy( newArray, pSubTrees, sizeof( sSubTree* ) * pSubTreeSize );
+			delete [] pSubTrees;
+		}
+		pSubTrees = newArray;
+		
+		for( ; pSubTreeSize<newSize; pSubTreeSize++ ){
+			pSubTrees[ pSubTreeSize ] = new sSubTree;
+		}
+	}
+	
+	sSubTree &subTree = *pSubTrees[ pSubTreeCount++ ];
+	subTree.node = node;
+	subTree.elements.RemoveAll();
+}
+
+void deoglPlanCullElementsJob::RemoveAllSubTrees(){
+	pSubTreeCount = 0;
+}
+
+void deoglPlanCullElementsJob::Run( const deoglPlanVisitorCullElements &visitor ){
+	deParallelProcessing &parallel = pRenderThread.GetOgl().GetGameEngine()->GetParallelProcessing();
+	deMutexGuard guard( pMutex );
+	
+	pVisitor = &visitor;
+	pNextSubTree = 0;
+	pRunningSubTreeCount = 0;
+	
+	// tasks still pending from earlier calls join the work once they start running
+	const int taskCount = decMath::max( decMath::min( parallel.GetCoreCount() - 1, pSubTreeCount - 1 )
+		- pPendingTaskCount, 0 );
+	pPendingTaskCount += taskCount;
+	
+	guard.Unlock();
+	
+	int i;
+	for( i=0; i<taskCount; i++ ){
+		deParallelTaskReference task;
+		task.TakeOver( new deoglPlanCullElementsTask( *this ) );
+		parallel.AddTaskAsync( task );
+	}
+	
+	CullSubTrees( pBoxes );
+	
+	guard.Lock();
+	if( pRunningSubTreeCount > 0 ){
+		pWaiting = true;
+		guard.Unlock();
+		
+		pSemaphoreFinished.Wait();
+		
+		guard.Lock();
+	}
+	pVisitor = NULL;
+	
+	// rethrow failure of a sub tree now that no sub tree is culled anymore
+	if( pException ){
+		const deException exception( *pException );
+		delete pException;
+		pException = NULL;
+		throw exception;
+	}
+}
+
+void deoglPlanCullElementsJob::CullSubTrees( deoglFrustumCullBoxes &boxes ){
+	deMutexGuard guard( pMutex );
+	
+	while( pVisitor && pNextSubTree < pSubTreeCount ){
+		sSubTree &subTree = *pSubTrees[ pNextSubTree++ ];
+		pRunningSubTreeCount++;
+		guard.Unlock();
+		
+		try{
+			pVisitor->CullSubTree( *subTree.node, boxes, subTree.elements );
+			guard.Lock();
+			
+		}catch( const deException &e ){
+			guard.Lock();
+			pSetException( e );
+			
+		}catch( ... ){
+			guard.Lock();
+			pSetException( deException( "UnknownException",
+				"Unknown exception culling sub tree", __FILE__, __LINE__ ) );
+		}
+		
+		pRunningSubTreeCount--;
+		
+		if( pRunningSubTreeCount == 0 && pNextSubTree == pSubTreeCount && pWaiting ){
+			pWaiting = false;
+			pSemaphoreFinished.Signal();
+		}
+	}
+}
+
+void deoglPlanCullElementsJob::TaskStarted(){
+	deMutexGuard guard( pMutex );
+	pPendingTaskCount--;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deoglPlanCullElementsJob::pSetException( const deException &exception ){
+	// keep the first failure and skip the remaining sub trees. called with mutex locked
+	if( ! pException ){
+		pException = new deException( exception );
+	}
+	pNextSubTree = pSubTreeCount;
+}
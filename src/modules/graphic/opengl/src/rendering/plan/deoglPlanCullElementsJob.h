@@ -0,0 +1,125 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLPLANCULLELEMENTSJOB_H_
+#define _DEOGLPLANCULLELEMENTSJOB_H_
+
+#include "deoglPlanVisitorCullElements.h"
+
+#include <dragengine/threading/deMutex.h>
+#include <dragengine/threading/deSemaphore.h>
+#include <dragengine/threading/deThreadSafeObject.h>
+
+class deoglRenderThread;
+class deoglWorldOctree;
+class deException;
+
+
+
+/**
+ * \brief Cull world octree sub trees in parallel.
+ * 
+ * Run() is called by the render thread. Parallel tasks are added asynchronously and claim
+ * sub trees until none are left. The render thread claims sub trees too and then waits
+ * only for sub trees still running. Tasks not started yet find no sub trees left and
+ * return. Tasks hold a reference to the job hence it stays alive while tasks are pending.
+ * Each sub tree stores the found elements in its own list so the result does not depend
+ * on which thread culled the sub tree.
+ */
+class deoglPlanCullElementsJob : public deThreadSafeObject{
+private:
+	struct sSubTree{
+		const deoglWorldOctree *node;
+		deoglPlanVisitorCullElements::sElements elements;
+	};
+	
+	deoglRenderThread &pRenderThread;
+	const deoglPlanVisitorCullElements *pVisitor;
+	deoglFrustumCullBoxes pBoxes;
+	
+	sSubTree **pSubTrees;
+	int pSubTreeCount;
+	int pSubTreeSize;
+	
+	deMutex pMutex;
+	deSemaphore pSemaphoreFinished;
+	int pNextSubTree;
+	int pRunningSubTreeCount;
+	int pPendingTaskCount;
+	bool pWaiting;
+	deException *pException;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create job. */
+	deoglPlanCullElementsJob( deoglRenderThread &renderThread );
+	
+protected:
+	/** \brief Clean up job. */
+	virtual ~deoglPlanCullElementsJob();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Render thread. */
+	inline deoglRenderThread &GetRenderThread() const{ return pRenderThread; }
+	
+	/** \brief Number of sub trees. */
+	inline int GetSubTreeCount() const{ return pSubTreeCount; }
+	
+	/** \brief Elements found in sub tree at index. Valid after Run() returned. */
+	const deoglPlanVisitorCullElements::sElements &GetElementsAt( int index ) const;
+	
+	/** \brief Add sub tree. */
+	void AddSubTree( const deoglWorldOctree *node );
+	
+	/** \brief Remove all sub trees. */
+	void RemoveAllSubTrees();
+	
+	/**
+	 * \brief Cull all sub trees.
+	 * 
+	 * Returns after all sub trees have been culled. Call only from the render thread.
+	 * If culling a sub tree failed the exception is rethrown after all running sub
+	 * trees finished.
+	 */
+	void Run( const deoglPlanVisitorCullElements &visitor );
+	
+	/** \brief Cull sub trees until none are left. For use by parallel tasks. */
+	void CullSubTrees( deoglFrustumCullBoxes &boxes );
+	
+	/** \brief Parallel task started running. For use by parallel tasks. */
+	void TaskStarted();
+	/*@}*/
+	
+	
+	
+private:
+	void pSetException( const deException &exception );
+};
+
+#endif
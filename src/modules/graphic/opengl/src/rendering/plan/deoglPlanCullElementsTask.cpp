@@ -0,0 +1,75 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoglPlanCullElementsJob.h"
+#include "deoglPlanCullElementsTask.h"
+#include "../../deGraphicOpenGl.h"
+#include "../../renderthread/deoglRenderThread.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class deoglPlanCullElementsTask
+////////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoglPlanCullElementsTask::deoglPlanCullElementsTask( deoglPlanCullElementsJob &job ) :
+deParallelTask( &job.GetRenderThread().GetOgl() ),
+pJob( &job )
+{
+	job.AddReference();
+}
+
+deoglPlanCullElementsTask::~deoglPlanCullElementsTask(){
+	pJob->FreeReference();
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void deoglPlanCullElementsTask::Run(){
+	pJob->TaskStarted();
+	
+	if( ! IsCancelled() ){
+		pJob->CullSubTrees( pBoxes );
+	}
+}
+
+void deoglPlanCullElementsTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString deoglPlanCullElementsTask::GetDebugName() const{
+	return "OpenGL:PlanCullElements";
+}
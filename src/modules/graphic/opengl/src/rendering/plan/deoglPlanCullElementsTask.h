@@ -0,0 +1,75 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLPLANCULLELEMENTSTASK_H_
+#define _DEOGLPLANCULLELEMENTSTASK_H_
+
+#include "../../utils/collision/deoglFrustumCullBoxes.h"
+
+#include <dragengine/parallel/deParallelTask.h>
+
+class deoglPlanCullElementsJob;
+
+
+
+/**
+ * \brief Parallel task culling world octree sub trees.
+ */
+class deoglPlanCullElementsTask : public deParallelTask{
+private:
+	deoglPlanCullElementsJob *pJob;
+	deoglFrustumCullBoxes pBoxes;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create task. */
+	deoglPlanCullElementsTask( deoglPlanCullElementsJob &job );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~deoglPlanCullElementsTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	/*@}*/
+};
+
+#endif
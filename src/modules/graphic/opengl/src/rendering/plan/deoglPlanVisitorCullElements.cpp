@@ -22,24 +22,36 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "deoglPlanCullElementsJob.h"
 #include "deoglPlanVisitorCullElements.h"
 #include "deoglRenderPlan.h"
 #include "../../collidelist/deoglCollideList.h"
 #include "../../billboard/deoglRBillboard.h"
+#include "../../billboard/deoglBillboardList.h"
 #include "../../component/deoglRComponent.h"
 #include "../../light/deoglRLight.h"
 #include "../../particle/deoglRParticleEmitterInstance.h"
+#include "../../particle/deoglParticleEmitterInstanceList.h"
 #include "../../world/deoglWorldOctree.h"
 #include "../../utils/collision/deoglDCollisionVolume.h"
 #include "../../utils/collision/deoglDCollisionSphere.h"
 #include "../../utils/collision/deoglDCollisionBox.h"
 #include "../../utils/collision/deoglDCollisionDetection.h"
+#include "../../utils/collision/deoglDCollisionFrustum.h"
 
 
 #include <dragengine/common/exceptions.h>
 
 
 
+// Definitions
+////////////////
+
+// depth of the octree nodes culled in parallel. nodes above are visited directly
+#define PARALLEL_SUBTREE_DEPTH 2
+
+
+
 // Class deoglPlanVisitorCullElements
 ///////////////////////////////////////
 
@@ -62,9 +74,17 @@ deoglPlanVisitorCullElements::deoglPlanVisitorCullElements( deoglRenderPlan *pla
 	
 	pCullLayerMask = false;
 	
+	pJob = NULL;
+	
 	SetVisitAll( true );
 }
 
+deoglPlanVisitorCullElements::~deoglPlanVisitorCullElements(){
+	if( pJob ){
+		pJob->FreeReference();
+	}
+}
+
 
 
 // Management
@@ -77,6 +97,7 @@ void deoglPlanVisitorCullElements::Init( deoglDCollisionFrustum *frustum ){
 	
 	pFrustum = frustum;
 	pCameraView = pPlan->GetInverseCameraMatrix().TransformView();
+	pBoxes.SetFrustum( *frustum, pPlan->GetCameraPosition() );
 	
 	CalculateFrustumBoundaryBox();
 	CalculateErrorScaling();
@@ -193,42 +214,52 @@ void deoglPlanVisitorCullElements::VisitWorldOctree( deoglWorldOctree &octree ){
 		DETHROW( deeInvalidParam );
 	}
 	
-	//octree.VisitNodesColliding( this, pFrustumMinExtend, pFrustumMaxExtend );
-	octree.VisitNodesCollidingVolume( this, pFrustum );
+	// visit the top levels directly and collect the sub trees below for parallel culling
+	if( ! pJob ){
+		pJob = new deoglPlanCullElementsJob( pPlan->GetRenderThread() );
+	}
+	pJob->RemoveAllSubTrees();
+	
+	pCollectSubTrees( octree, 0, deoglDCollisionDetection::eirPartial );
+	
+	const int subTreeCount = pJob->GetSubTreeCount();
+	if( subTreeCount == 0 ){
+		return;
+	}
+	
+	pJob->Run( *this );
+	
+	int i;
+	for( i=0; i<subTreeCount; i++ ){
+		AddElements( pJob->GetElementsAt( i ) );
+	}
 }
 
-
-
-// Visiting
-/////////////
-
-void deoglPlanVisitorCullElements::VisitNode( deoglDOctree *node, int intersection ){
-	bool cullWithVolume = ( intersection != deoglDCollisionDetection::eirInside );
-	const deoglWorldOctree &sonode = *( ( deoglWorldOctree* )node );
+void deoglPlanVisitorCullElements::CullNodeElements( const deoglWorldOctree &node, int intersection,
+deoglFrustumCullBoxes &boxes, sElements &elements ) const{
+	const bool cullWithVolume = ( intersection != deoglDCollisionDetection::eirInside );
 	const decDVector &cameraPosition = pPlan->GetCameraPosition();
-	deoglCollideList &collideList = pPlan->GetCollideList();
-	deoglDCollisionBox box;
 	int i, count;
 	
-	// test node against frustum
-	/*
-	box.SetCenter( node->GetCenter() );
-	box.SetHalfSize( node->GetHalfSize() );
-	if( ! pFrustum->BoxHitsFrustum( &box ) ){
-		return;
-	}
-	intersection = deoglDCollisionDetection::eirPartial;
-	cullWithVolume = true;
-	*/
-	
 	// visit components
-	count = sonode.GetComponentCount();
+	count = node.GetComponentCount();
+	
+	if( cullWithVolume && count > 0 ){
+		boxes.RemoveAllBoxes();
+		for( i=0; i<count; i++ ){
+			const deoglRComponent &component = *node.GetComponentAt( i );
+			boxes.AddBox( component.GetMinimumExtend(), component.GetMaximumExtend() );
+		}
+		boxes.Cull();
+	}
 	
 	for( i=0; i<count; i++ ){
-		deoglRComponent * const component = sonode.GetComponentAt( i );
+		// cull using cull volume if required
+		if( cullWithVolume && ! boxes.GetVisibleAt( i ) ){
+			continue;
+		}
 		
-		const decDVector &minExtend = component->GetMinimumExtend();
-		const decDVector &maxExtend = component->GetMaximumExtend();
+		deoglRComponent * const component = node.GetComponentAt( i );
 		
 		// cull using layer mask if required. components with empty layer mask never match
 		// and thus are never culled
@@ -237,21 +268,9 @@ void deoglPlanVisitorCullElements::VisitNode( deoglDOctree *node, int intersecti
 			continue;
 		}
 		
-		// cull using cull volume if required
-		if( cullWithVolume ){
-			// possible optmizations:
-			// - check against pFrustum*Extend before checking against the frustum volume
-			// - depending on the size of the object use a sphere instead of a box
-			// - maybe use the sphere for the test against the pFrustum*Extend ?
-			
-			box.SetFromExtends( minExtend, maxExtend );
-			
-			if( ! pFrustum->BoxHitsFrustum( &box ) ){
-				continue;
-			}
-		}
-		
 		// cull using too small filter
+		const decDVector &minExtend = component->GetMinimumExtend();
+		const decDVector &maxExtend = component->GetMaximumExtend();
 		const decDVector center = ( minExtend + maxExtend ) * 0.5;
 		const float radius = ( float )( ( maxExtend - minExtend ).Length() * 0.5 );
 		const float componentDistance = ( float )( ( center - cameraPosition ) * pCameraView ) - radius;
@@ -267,14 +286,29 @@ void deoglPlanVisitorCullElements::VisitNode( deoglDOctree *node, int intersecti
 		}
 		
 		// add component
-		collideList.AddComponent( component );
+		elements.components.Add( component );
 	}
 	
 	// visit billboards
-	count = sonode.GetBillboardList().GetCount();
+	const deoglBillboardList &billboards = node.GetBillboardList();
+	count = billboards.GetCount();
+	
+	if( cullWithVolume && count > 0 ){
+		boxes.RemoveAllBoxes();
+		for( i=0; i<count; i++ ){
+			const deoglRBillboard &billboard = *billboards.GetAt( i );
+			boxes.AddBox( billboard.GetMinimumExtend(), billboard.GetMaximumExtend() );
+		}
+		boxes.Cull();
+	}
 	
 	for( i=0; i<count; i++ ){
-		deoglRBillboard * const billboard = sonode.GetBillboardList().GetAt( i );
+		// cull using cull volume if required
+		if( cullWithVolume && ! boxes.GetVisibleAt( i ) ){
+			continue;
+		}
+		
+		deoglRBillboard * const billboard = billboards.GetAt( i );
 		
 		// cull using layer mask if required. billboards with empty layer mask never match
 		// and thus are never culled
@@ -283,24 +317,9 @@ void deoglPlanVisitorCullElements::VisitNode( deoglDOctree *node, int intersecti
 			continue;
 		}
 		
-		// cull using cull volume if required
+		// cull using too small filter
 		const decDVector &minExtend = billboard->GetMinimumExtend();
 		const decDVector &maxExtend = billboard->GetMaximumExtend();
-		
-		if( cullWithVolume ){
-			// possible optmizations:
-			// - check against pFrustum*Extend before checking against the frustum volume
-			// - depending on the size of the object use a sphere instead of a box
-			// - maybe use the sphere for the test against the pFrustum*Extend ?
-			
-			box.SetFromExtends( minExtend, maxExtend );
-			
-			if( ! pFrustum->BoxHitsFrustum( &box ) ){
-				continue;
-			}
-		}
-		
-		// cull using too small filter
 		const decDVector center = ( minExtend + maxExtend ) * 0.5;
 		const float radius = ( float )( ( maxExtend - minExtend ).Length() * 0.5 );
 		const float billboardDistance = ( float )( ( center - cameraPosition ) * pCameraView ) - radius;
@@ -310,71 +329,185 @@ void deoglPlanVisitorCullElements::VisitNode( deoglDOctree *node, int intersecti
 		}
 		
 		// add billboard
-		collideList.AddBillboard( billboard );
+		elements.billboards.Add( billboard );
 	}
 	
-	// visit lights
-	count = sonode.GetLightCount();
+	// visit lights. the light collision volume is updated on demand hence the lights
+	// of partially visible nodes are culled against the frustum by AddElements()
+	count = node.GetLightCount();
 	
-	if( intersection == deoglDCollisionDetection::eirInside ){
-		for( i=0; i<count; i++ ){
-			deoglRLight * const light = sonode.GetLightAt( i );
+	for( i=0; i<count; i++ ){
+		deoglRLight * const light = node.GetLightAt( i );
 		
-			if( pCullLayerMask && light->GetLayerMask().IsNotEmpty()
-			&& pLayerMask.MatchesNot( light->GetLayerMask() ) ){
-				continue;
-			}
-			
-			collideList.AddLight( light );
+		if( pCullLayerMask && light->GetLayerMask().IsNotEmpty()
+		&& pLayerMask.MatchesNot( light->GetLayerMask() ) ){
+			continue;
 		}
 		
-	}else{
-		for( i=0; i<count; i++ ){
-			deoglRLight * const light = sonode.GetLightAt( i );
-			
-			if( pCullLayerMask && light->GetLayerMask().IsNotEmpty()
-			&& pLayerMask.MatchesNot( light->GetLayerMask() ) ){
-				continue;
-			}
-			
-			if( ! light->GetCollisionVolume()->VolumeHitsVolume( pFrustum ) ){
-				continue;
-			}
+		if( cullWithVolume ){
+			elements.lights.Add( light );
 			
-			collideList.AddLight( light );
+		}else{
+			elements.lightsInside.Add( light );
 		}
 	}
 	
 	// visit particle emitters
-	const deoglParticleEmitterInstanceList &nodeParticleEmitterInstanceList = sonode.GetParticleEmittersList();
-	deoglParticleEmitterInstanceList &clistParticleEmitterInstanceList = collideList.GetParticleEmitterList();
-	count = nodeParticleEmitterInstanceList.GetCount();
+	const deoglParticleEmitterInstanceList &particleEmitters = node.GetParticleEmittersList();
+	count = particleEmitters.GetCount();
 	
-	if( intersection == deoglDCollisionDetection::eirInside ){
+	if( cullWithVolume && count > 0 ){
+		boxes.RemoveAllBoxes();
 		for( i=0; i<count; i++ ){
-			deoglRParticleEmitterInstance * const instance = nodeParticleEmitterInstanceList.GetAt( i );
+			const deoglRParticleEmitterInstance &instance = *particleEmitters.GetAt( i );
+			boxes.AddBox( instance.GetMinExtend(), instance.GetMaxExtend() );
+		}
+		boxes.Cull();
+	}
+	
+	for( i=0; i<count; i++ ){
+		if( cullWithVolume && ! boxes.GetVisibleAt( i ) ){
+			continue;
+		}
 		
-			if( pCullLayerMask && instance->GetLayerMask().IsNotEmpty()
-			&& pLayerMask.MatchesNot( instance->GetLayerMask() ) ){
-				continue;
-			}
-			
-			clistParticleEmitterInstanceList.Add( instance );
+		deoglRParticleEmitterInstance * const instance = particleEmitters.GetAt( i );
+		
+		if( pCullLayerMask && instance->GetLayerMask().IsNotEmpty()
+		&& pLayerMask.MatchesNot( instance->GetLayerMask() ) ){
+			continue;
 		}
 		
-	}else{
-		for( i=0; i<count; i++ ){
-			deoglRParticleEmitterInstance * const instance = nodeParticleEmitterInstanceList.GetAt( i );
-			
-			if( pCullLayerMask && instance->GetLayerMask().IsNotEmpty()
-			&& pLayerMask.MatchesNot( instance->GetLayerMask() ) ){
-				continue;
-			}
-			
-			box.SetFromExtends( instance->GetMinExtend(), instance->GetMaxExtend() );
-			if( pFrustum->BoxHitsFrustum( &box ) ){
-				clistParticleEmitterInstanceList.Add( instance );
-			}
+		elements.particleEmitters.Add( instance );
+	}
+}
+
+void deoglPlanVisitorCullElements::CullSubTree( const deoglWorldOctree &node,
+deoglFrustumCullBoxes &boxes, sElements &elements ) const{
+	if( ! pFrustum ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	boxes.SetFrustum( *pFrustum, pPlan->GetCameraPosition() );
+	pCullSubTree( node, deoglDCollisionDetection::eirPartial, boxes, elements );
+}
+
+void deoglPlanVisitorCullElements::AddElements( const sElements &elements ){
+	deoglCollideList &collideList = pPlan->GetCollideList();
+	int i, count;
+	
+	count = elements.components.GetCount();
+	for( i=0; i<count; i++ ){
+		collideList.AddComponent( ( deoglRComponent* )elements.components.GetAt( i ) );
+	}
+	
+	count = elements.billboards.GetCount();
+	for( i=0; i<count; i++ ){
+		collideList.AddBillboard( ( deoglRBillboard* )elements.billboards.GetAt( i ) );
+	}
+	
+	count = elements.lights.GetCount();
+	for( i=0; i<count; i++ ){
+		deoglRLight * const light = ( deoglRLight* )elements.lights.GetAt( i );
+		if( light->GetCollisionVolume()->VolumeHitsVolume( pFrustum ) ){
+			collideList.AddLight( light );
 		}
 	}
+	
+	count = elements.lightsInside.GetCount();
+	for( i=0; i<count; i++ ){
+		collideList.AddLight( ( deoglRLight* )elements.lightsInside.GetAt( i ) );
+	}
+	
+	deoglParticleEmitterInstanceList &particleEmitters = collideList.GetParticleEmitterList();
+	count = elements.particleEmitters.GetCount();
+	for( i=0; i<count; i++ ){
+		particleEmitters.Add( ( deoglRParticleEmitterInstance* )elements.particleEmitters.GetAt( i ) );
+	}
+}
+
+
+
+// Visiting
+/////////////
+
+void deoglPlanVisitorCullElements::VisitNode( deoglDOctree *node, int intersection ){
+	pElements.RemoveAll();
+	CullNodeElements( *( ( deoglWorldOctree* )node ), intersection, pBoxes, pElements );
+	AddElements( pElements );
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deoglPlanVisitorCullElements::pCollectSubTrees( deoglWorldOctree &node, int depth, int intersection ){
+	intersection = pIntersectNode( node, intersection );
+	if( intersection == deoglDCollisionDetection::eirOutside ){
+		return;
+	}
+	
+	if( depth == PARALLEL_SUBTREE_DEPTH ){
+		pJob->AddSubTree( &node );
+		return;
+	}
+	
+	VisitNode( &node, intersection );
+	
+	int i;
+	for( i=0; i<8; i++ ){
+		deoglDOctree * const child = node.GetNodeAt( i );
+		if( child ){
+			pCollectSubTrees( *( ( deoglWorldOctree* )child ), depth + 1, intersection );
+		}
+	}
+}
+
+void deoglPlanVisitorCullElements::pCullSubTree( const deoglWorldOctree &node, int intersection,
+deoglFrustumCullBoxes &boxes, sElements &elements ) const{
+	intersection = pIntersectNode( node, intersection );
+	if( intersection == deoglDCollisionDetection::eirOutside ){
+		return;
+	}
+	
+	CullNodeElements( node, intersection, boxes, elements );
+	
+	int i;
+	for( i=0; i<8; i++ ){
+		const deoglDOctree * const child = node.GetNodeAt( i );
+		if( child ){
+			pCullSubTree( *( ( const deoglWorldOctree* )child ), intersection, boxes, elements );
+		}
+	}
+}
+
+int deoglPlanVisitorCullElements::pIntersectNode( const deoglWorldOctree &node, int parentIntersection ) const{
+	// children of nodes fully inside the frustum are fully inside too
+	if( parentIntersection == deoglDCollisionDetection::eirInside ){
+		return deoglDCollisionDetection::eirInside;
+	}
+	
+	switch( pFrustum->IntersectBox( node.GetCenter(), node.GetHalfSize() ) ){
+	case deoglDCollisionFrustum::eitInside:
+		return deoglDCollisionDetection::eirInside;
+		
+	case deoglDCollisionFrustum::eitIntersect:
+		return deoglDCollisionDetection::eirPartial;
+		
+	default:
+		return deoglDCollisionDetection::eirOutside;
+	}
+}
+
+
+
+// deoglPlanVisitorCullElements::sElements
+////////////////////////////////////////////
+
+void deoglPlanVisitorCullElements::sElements::RemoveAll(){
+	components.RemoveAll();
+	billboards.RemoveAll();
+	lights.RemoveAll();
+	lightsInside.RemoveAll();
+	particleEmitters.RemoveAll();
 }
@@ -22,13 +22,16 @@
 #ifndef _DEOGLPLANVISITORCULLELEMENTS_H_
 #define _DEOGLPLANVISITORCULLELEMENTS_H_
 
+#include <dragengine/common/collection/decPointerList.h>
 #include <dragengine/common/math/decMath.h>
 #include <dragengine/common/utils/decLayerMask.h>
 #include <dragengine/common/string/decString.h>
 
+#include "../../utils/collision/deoglFrustumCullBoxes.h"
 #include "../../world/deoglDefaultWorldOctreeVisitor.h"
 
 class deoglDCollisionFrustum;
+class deoglPlanCullElementsJob;
 class deoglRenderPlan;
 class deoglWorldOctree;
 
@@ -53,8 +56,40 @@ class deoglWorldOctree;
  * 
  * @par Dynamic Elements
  * Cull dynamic components if enabled. Use SetCullDynamicComponents to enable or disable this filter.
+ * 
+ * @par Parallel culling
+ * VisitWorldOctree visits the top levels of the octree itself and culls the sub trees below in
+ * parallel. Each sub tree stores the found elements in its own list. The lists are added to the
+ * collide list in sub tree order once all sub trees are done. Components, billboards and particle
+ * emitters of each node are culled using deoglFrustumCullBoxes. Nodes fully inside the frustum
+ * pass this on to their child nodes and add their elements without culling them. Lights are
+ * culled while adding them to the collide list since their collision volume is updated on demand.
  */
 class deoglPlanVisitorCullElements : public deoglDefaultWorldOctreeVisitor{
+public:
+	/** \brief Elements found while culling. */
+	struct sElements{
+		/** \brief Components. */
+		decPointerList components;
+		
+		/** \brief Billboards. */
+		decPointerList billboards;
+		
+		/** \brief Lights still to be culled against the frustum. */
+		decPointerList lights;
+		
+		/** \brief Lights from nodes inside the frustum not requiring culling. */
+		decPointerList lightsInside;
+		
+		/** \brief Particle emitter instances. */
+		decPointerList particleEmitters;
+		
+		/** \brief Remove all elements. */
+		void RemoveAll();
+	};
+	
+	
+	
 private:
 	deoglRenderPlan *pPlan;
 	
@@ -74,11 +109,17 @@ private:
 	bool pCullLayerMask;
 	decLayerMask pLayerMask;
 	
+	deoglFrustumCullBoxes pBoxes;
+	sElements pElements;
+	deoglPlanCullElementsJob *pJob;
+	
 public:
 	/** @name Constructors and Destructors */
 	/*@{*/
 	/** Creates a new visitor. */
 	deoglPlanVisitorCullElements( deoglRenderPlan *plan );
+	/** Cleans up the visitor. */
+	virtual ~deoglPlanVisitorCullElements();
 	/*@}*/
 	
 	/** @name Management */
@@ -126,6 +167,25 @@ public:
 	
 	/** Visit a world octree using this visitor. */
 	void VisitWorldOctree( deoglWorldOctree &octree );
+	
+	/**
+	 * \brief Cull elements of node.
+	 * 
+	 * Thread safe. Stores found elements in elements.
+	 */
+	void CullNodeElements( const deoglWorldOctree &node, int intersection,
+		deoglFrustumCullBoxes &boxes, sElements &elements ) const;
+	
+	/**
+	 * \brief Cull elements of node and all child nodes hitting the frustum.
+	 * 
+	 * Thread safe. Stores found elements in elements.
+	 */
+	void CullSubTree( const deoglWorldOctree &node, deoglFrustumCullBoxes &boxes,
+		sElements &elements ) const;
+	
+	/** \brief Add elements to the plan collide list culling lights. */
+	void AddElements( const sElements &elements );
 	/*@}*/
 	
 	/** @name Visiting */
@@ -133,6 +193,12 @@ public:
 	/** Visits an octree node. The default implementation is to visit all world elements stored in the node. */
 	virtual void VisitNode( deoglDOctree *node, int intersection );
 	/*@}*/
+	
+private:
+	void pCollectSubTrees( deoglWorldOctree &node, int depth, int intersection );
+	void pCullSubTree( const deoglWorldOctree &node, int intersection,
+		deoglFrustumCullBoxes &boxes, sElements &elements ) const;
+	int pIntersectNode( const deoglWorldOctree &node, int parentIntersection ) const;
 };
 
 #endif
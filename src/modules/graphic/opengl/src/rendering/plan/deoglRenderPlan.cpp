@@ -51,6 +51,9 @@
 #include "../../model/deoglModelLOD.h"
 #include "../../model/deoglRModel.h"
 #include "../../occlusiontest/deoglOcclusionTest.h"
+#include "../../occlusiontest/mesh/deoglDynamicOcclusionMesh.h"
+#include "../../occlusiontest/mesh/deoglROcclusionMesh.h"
+#include "../../occlusiontest/software/deoglSoftwareOcclusionTest.h"
 #include "../../particle/deoglRParticleEmitter.h"
 #include "../../particle/deoglRParticleEmitterInstance.h"
 #include "../../particle/deoglRParticleEmitterInstanceType.h"
@@ -185,6 +188,8 @@ pRenderThread( renderThread ){
 	pStencilPrevRefValue = 0;
 	pStencilWriteMask = 0xf;
 	
+	pSoftwareOcclusionTest = NULL;
+	
 	pDebug = NULL;
 	pDebugTiming = false;
 }
@@ -233,6 +238,10 @@ deoglRenderPlan::~deoglRenderPlan(){
 		delete pDebug;
 	}
 	
+	if( pSoftwareOcclusionTest ){
+		pSoftwareOcclusionTest->FreeReference();
+	}
+	
 	if( pVisitorCullElements ){
 		delete pVisitorCullElements;
 	}
@@ -717,6 +726,11 @@ void deoglRenderPlan::pPlanCollideList( deoglDCollisionFrustum *frustum ){
 	}
 // DEBUG_PRINT_TIMER( "RenderPlan.PrepareRender: Add Env-Map" );
 	
+	// cull elements occluded in the software occlusion map. this reduces the number of
+	// elements requiring GPU occlusion testing and rendering
+	pPlanSoftwareOcclusionTest();
+// DEBUG_PRINT_TIMER( "RenderPlan.PrepareRender: Software Occlusion Test" );
+	
 	// collect occlusion test data and upload it. we do something else in the mean
 	// time until the GPU uploaded the data to avoid stalling as good as possible
 	pPlanOcclusionTestInputData();
@@ -726,6 +740,93 @@ void deoglRenderPlan::pPlanCollideList( deoglDCollisionFrustum *frustum ){
 	pDebugVisibleNoCull();
 }
 
+void deoglRenderPlan::pPlanSoftwareOcclusionTest(){
+	const deoglConfiguration &config = pRenderThread.GetConfiguration();
+	if( ! config.GetSoftwareOcclusionTest() || config.GetDebugNoCulling() ){
+		return;
+	}
+	
+	const int componentCount = pCollideList.GetComponentCount();
+	const int lightCount = pCollideList.GetLightCount();
+	if( componentCount == 0 ){
+		return;
+	}
+	
+	if( ! pSoftwareOcclusionTest ){
+		pSoftwareOcclusionTest = new deoglSoftwareOcclusionTest( pRenderThread );
+	}
+	
+	deoglSoftwareOcclusionMap &map = pSoftwareOcclusionTest->GetMap();
+	const decDMatrix matrixCameraRelative( decDMatrix::CreateTranslation( -pCameraPosition ) );
+	int i;
+	
+	map.SetMatrix( ( pRefPosCameraMatrix.GetRotationMatrix() * pFrustumMatrix ).ToMatrix(),
+		pCameraImageDistance );
+	map.Clear();
+	
+	// add occlusion meshes of all components as occluders
+	for( i=0; i<componentCount; i++ ){
+		deoglRComponent &component = *pCollideList.GetComponentAt( i )->GetComponent();
+		const deoglROcclusionMesh * const occlusionMesh = component.GetOcclusionMesh();
+		if( ! occlusionMesh ){
+			continue;
+		}
+		
+		deoglDynamicOcclusionMesh * const dynamicOcclusionMesh = component.GetDynamicOcclusionMesh();
+		const float *positions = NULL;
+		int positionStride = 0;
+		
+		if( dynamicOcclusionMesh ){
+			dynamicOcclusionMesh->PrepareVertices();
+			if( dynamicOcclusionMesh->GetVertices() ){
+				positions = &dynamicOcclusionMesh->GetVertices()[ 0 ].x;
+				positionStride = sizeof( decVector ) / sizeof( float );
+			}
+			
+		}else if( occlusionMesh->GetVertexCount() > 0 ){
+			positions = &occlusionMesh->GetVertices()[ 0 ].position.x;
+			positionStride = sizeof( deoglROcclusionMesh::sVertex ) / sizeof( float );
+		}
+		
+		if( ! positions ){
+			continue;
+		}
+		
+		map.AddOccluder( positions, positionStride, occlusionMesh->GetCorners(),
+			occlusionMesh->GetSingleSidedFaceCount(), occlusionMesh->GetDoubleSidedFaceCount(),
+			( component.GetMatrix() * matrixCameraRelative ).ToMatrix() );
+	}
+	
+	if( map.GetTriangleCount() == 0 ){
+		return;
+	}
+	
+	pSoftwareOcclusionTest->Rasterize();
+	
+	// test elements against the occlusion map and remove the occluded ones
+	pCollideList.MarkComponentsVisible( true );
+	pCollideList.MarkLightsVisible( true );
+	
+	for( i=0; i<componentCount; i++ ){
+		deoglRComponent &component = *pCollideList.GetComponentAt( i )->GetComponent();
+		if( ! map.TestBox( ( component.GetMinimumExtend() - pCameraPosition ).ToVector(),
+		( component.GetMaximumExtend() - pCameraPosition ).ToVector() ) ){
+			component.OcclusionTestInvisible();
+		}
+	}
+	
+	for( i=0; i<lightCount; i++ ){
+		deoglRLight &light = *pCollideList.GetLightAt( i );
+		if( ! map.TestBox( ( light.GetMinimumExtend() - pCameraPosition ).ToVector(),
+		( light.GetMaximumExtend() - pCameraPosition ).ToVector() ) ){
+			light.OcclusionTestInvisible();
+		}
+	}
+	
+	pCollideList.RemoveVisibleComponents( false );
+	pCollideList.RemoveVisibleLights( false );
+}
+
 void deoglRenderPlan::pPlanOcclusionTestInputData(){
 	const int componentCount = pCollideList.GetComponentCount();
 	deoglOcclusionTest &occtest = pRenderThread.GetOcclusionTest();
@@ -52,6 +52,7 @@ class deoglTexture;
 class deoglRWorld;
 class deoglRSkyInstance;
 class deoglRSkyInstanceLayer;
+class deoglSoftwareOcclusionTest;
 
 
 
@@ -165,6 +166,7 @@ private:
 	deoglOcclusionMap *pOcclusionMap;
 	int pOcclusionMapBaseLevel;
 	decMatrix pOcclusionTestMatrix;
+	deoglSoftwareOcclusionTest *pSoftwareOcclusionTest;
 	
 	deoglRenderPlanDebug *pDebug;
 	bool pDebugTiming;
@@ -650,6 +652,7 @@ private:
 	void pPlanShadowCasting();
 	void pPlanOcclusionTesting();
 	void pPlanCollideList( deoglDCollisionFrustum *frustum );
+	void pPlanSoftwareOcclusionTest();
 	void pPlanOcclusionTestInputData();
 	void pPlanLODLevels();
 	void pPlanEnvMaps();
@@ -25,6 +25,7 @@
 #include "deoglShaderDefines.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/string/decString.h>
 
 
 
@@ -143,6 +144,19 @@ bool deoglShaderDefines::Equals( const deoglShaderDefines &defines ) const{
 	return *this == defines;
 }
 
+unsigned int deoglShaderDefines::CalcHashCode() const{
+	// defines are compared independent of their order. combining the define hashes
+	// using addition keeps the hash code independent of the order too
+	unsigned int hashCode = ( unsigned int )pDefineCount;
+	int i;
+	
+	for( i=0; i<pDefineCount; i++ ){
+		hashCode += decString::Hash( pDefines[ i ].name ) * 31 + decString::Hash( pDefines[ i ].value );
+	}
+	
+	return hashCode;
+}
+
 
 
 // Operators
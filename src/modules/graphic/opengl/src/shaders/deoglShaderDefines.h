@@ -73,6 +73,12 @@ public:
 	
 	/** Determines if this defines object equals another defines object. */
 	bool Equals( const deoglShaderDefines &defines ) const;
+	
+	/**
+	 * Calculates a hash code. The hash code does not depend on the order the defines
+	 * have been added in hence equal defines objects have the same hash code.
+	 */
+	unsigned int CalcHashCode() const;
 	/*@}*/
 	
 	/** @name Operators */
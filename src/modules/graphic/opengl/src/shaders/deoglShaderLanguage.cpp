@@ -31,12 +31,28 @@
 #include "deoglShaderProgram.h"
 #include "deoglShaderUnitSourceCode.h"
 #include "deoglShaderManager.h"
+#include "../deoglCaches.h"
+#include "../deGraphicOpenGl.h"
 #include "../extensions/deoglExtensions.h"
 #include "../renderthread/deoglRenderThread.h"
 #include "../renderthread/deoglRTLogger.h"
 #include "../renderthread/deoglRTShader.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/common/file/decBaseFileWriter.h>
+#include <dragengine/filesystem/deCacheHelper.h>
+
+
+
+// Definitions
+////////////////
+
+// cache version in case the cache file format changes
+#define CACHE_VERSION 1
+
+// maximum size in bytes of memoized preprocessed unit sources before they are dropped
+#define MAX_PREPROCESSED_UNITS_SIZE 8388608
 
 
 
@@ -201,6 +217,17 @@ static bool psfMatchesLink( const deoglShaderProgram &program ){
 #endif  // PRINT_SHADERS
 
 
+
+static void appendDefinesKey( decString &key, const deoglShaderDefines &defines ){
+	const int count = defines.GetDefineCount();
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		key.AppendFormat( "|%s=%s", defines.GetDefineNameAt( i ), defines.GetDefineValueAt( i ) );
+	}
+}
+
+
 // Class deoglShaderLanguage
 //////////////////////////////
 
@@ -209,7 +236,9 @@ static bool psfMatchesLink( const deoglShaderProgram &program ){
 
 deoglShaderLanguage::deoglShaderLanguage( deoglRenderThread &renderThread ) :
 pRenderThread( renderThread ),
-pPreprocessor( renderThread )
+pPreprocessor( renderThread ),
+pPreprocessedUnitsSize( 0 ),
+pCacheBinaries( false )
 {
 	pErrorLog = NULL;
 	
@@ -264,6 +293,18 @@ pPreprocessor( renderThread )
 				pGLSLExtensions.Add( "GL_ARB_shader_storage_buffer_object" );
 		}
 	}
+	
+	// program binaries are cached only if the driver supports at least one binary format.
+	// the driver identity is stored along with the binary since binaries are only valid
+	// for the same driver and hardware they have been created with
+	if( pglGetProgramBinary && pglProgramBinary && pglProgramParameteri ){
+		GLint formatCount = 0;
+		glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount );
+		pCacheBinaries = formatCount > 0;
+	}
+	
+	pDriverIdentity.Format( "%s|%s|%s", ext.GetStringVendor().GetString(),
+		ext.GetStringRenderer().GetString(), ext.GetStringGLVersion().GetString() );
 }
 
 deoglShaderLanguage::~deoglShaderLanguage(){
@@ -277,6 +318,7 @@ deoglShaderLanguage::~deoglShaderLanguage(){
 
 deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &program ){
 	const deoglShaderSources &sources = *program.GetSources();
+	const deoglShaderDefines &defines = program.GetDefines();
 	deoglShaderUnitSourceCode * const scTessellationControl = program.GetTessellationControlSourceCode();
 	deoglShaderUnitSourceCode * const scTessellationEvaluation = program.GetTessellationEvaluationSourceCode();
 	deoglShaderUnitSourceCode * const scGeometry = program.GetGeometrySourceCode();
@@ -292,6 +334,8 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 	const deoglShaderBindingList &outputList = sources.GetOutputList();
 	const decStringList &parameterList = sources.GetParameterList();
 	const decStringList &feedbackList = sources.GetFeedbackList();
+	decString preprocessedTCP, preprocessedTEP, preprocessedGP, preprocessedVP, preprocessedFP;
+	decString memoKey, cacheId, cacheValidation;
 	GLuint handleShader = 0;
 	GLuint handleTCP = 0;
 	GLuint handleTEP = 0;
@@ -300,6 +344,11 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 	GLuint handleFP = 0;
 	deoglShaderCompiled *compiled = NULL;
 	int i, count, location;
+	bool linked = false;
+	
+	// program binaries can not be used if only the NV transform feedback extension exists
+	// since the feedback varyings have to be bound after linking
+	const bool cacheBinary = pCacheBinaries && ( pglTransformFeedbackVaryings || feedbackList.GetCount() == 0 );
 	
 	#ifdef PRINT_COMPILING
 	decString debugText( "compiling " );
@@ -319,12 +368,11 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 		debugText.AppendFormat( " frag(%s)", scFragment->GetFilePath() );
 	}
 	debugText.Append( " defines(" );
-	for( i=0; i<program.GetDefines().GetDefineCount(); i++ ){
+	for( i=0; i<defines.GetDefineCount(); i++ ){
 		if( i > 0 ){
 			debugText.Append( " " );
 		}
-		debugText.AppendFormat( "%s=%s", program.GetDefines().GetDefineNameAt( i ),
-			program.GetDefines().GetDefineValueAt( i ) );
+		debugText.AppendFormat( "%s=%s", defines.GetDefineNameAt( i ), defines.GetDefineValueAt( i ) );
 	}
 	debugText.Append( ")" );
 	pRenderThread.GetLogger().LogInfo( debugText.GetString() );
@@ -337,21 +385,100 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 		// retrieve the shader handle
 		handleShader = compiled->GetHandleShader();
 		
-		// compile the tessellation control program if existing
+		// preprocess all units first. the preprocessed sources are required to validate
+		// cached program binaries. unit source codes are identified by their file path
+		// while inline source codes are identified by the shader file they are defined in
 		if( scTessellationControl ){
+			pPreprocessUnit( preprocessedTCP, scTessellationControl->GetFilePath(), defines,
+				scTessellationControl->GetFilePath(), scTessellationControl->GetSourceCode() );
+		}
+		
+		if( scTessellationEvaluation ){
+			pPreprocessUnit( preprocessedTEP, scTessellationEvaluation->GetFilePath(), defines,
+				scTessellationEvaluation->GetFilePath(), scTessellationEvaluation->GetSourceCode() );
+		}
+		
+		if( scGeometry ){
+			pPreprocessUnit( preprocessedGP, scGeometry->GetFilePath(), defines,
+				scGeometry->GetFilePath(), scGeometry->GetSourceCode() );
+			
+		}else if( ! inlscGeometry.IsEmpty() ){
+			memoKey.Format( "%s#geometry", sources.GetFilename().GetString() );
+			pPreprocessUnit( preprocessedGP, memoKey, defines, "<inline>", inlscGeometry.GetString() );
+		}
+		
+		if( scVertex ){
+			pPreprocessUnit( preprocessedVP, scVertex->GetFilePath(), defines,
+				scVertex->GetFilePath(), scVertex->GetSourceCode() );
+			
+		}else if( ! inlscVertex.IsEmpty() ){
+			memoKey.Format( "%s#vertex", sources.GetFilename().GetString() );
+			pPreprocessUnit( preprocessedVP, memoKey, defines, "<inline>", inlscVertex.GetString() );
+		}
+		
+		#ifdef ANDROID
+		// fragment source code is modified using the output list of the shader file
+		memoKey.Format( "%s#fragment", sources.GetFilename().GetString() );
+		
+		if( scFragment ){
+			pPreprocessUnit( preprocessedFP, memoKey, defines, scFragment->GetFilePath(),
+				scFragment->GetSourceCode(), &outputList );
+			
+		}else if( ! inlscFragment.IsEmpty() ){
+			pPreprocessUnit( preprocessedFP, memoKey, defines, "<inline>",
+				inlscFragment.GetString(), &outputList );
+		}
+		#else
+		if( scFragment ){
+			pPreprocessUnit( preprocessedFP, scFragment->GetFilePath(), defines,
+				scFragment->GetFilePath(), scFragment->GetSourceCode() );
+			
+		}else if( ! inlscFragment.IsEmpty() ){
+			memoKey.Format( "%s#fragment", sources.GetFilename().GetString() );
+			pPreprocessUnit( preprocessedFP, memoKey, defines, "<inline>", inlscFragment.GetString() );
+		}
+		#endif
+		
+		// try loading the linked program from the cache. the cached binary is only used if
+		// the driver, the preprocessed sources and the bindings done before linking match
+		if( cacheBinary ){
+			cacheId = sources.GetName();
+			appendDefinesKey( cacheId, defines );
+			
+			decString bindings;
+			count = inputList.GetCount();
+			for( i=0; i<count; i++ ){
+				bindings.AppendFormat( "a%s=%d;", inputList.GetNameAt( i ), inputList.GetTargetAt( i ) );
+			}
+			count = outputList.GetCount();
+			for( i=0; i<count; i++ ){
+				bindings.AppendFormat( "o%s=%d;", outputList.GetNameAt( i ), outputList.GetTargetAt( i ) );
+			}
+			count = feedbackList.GetCount();
+			for( i=0; i<count; i++ ){
+				bindings.AppendFormat( "f%s;", feedbackList.GetAt( i ).GetString() );
+			}
+			
+			cacheValidation.Format( "%s\n%d:%x %d:%x %d:%x %d:%x %d:%x %d:%x", pDriverIdentity.GetString(),
+				preprocessedTCP.GetLength(), preprocessedTCP.Hash(),
+				preprocessedTEP.GetLength(), preprocessedTEP.Hash(),
+				preprocessedGP.GetLength(), preprocessedGP.Hash(),
+				preprocessedVP.GetLength(), preprocessedVP.Hash(),
+				preprocessedFP.GetLength(), preprocessedFP.Hash(),
+				bindings.GetLength(), bindings.Hash() );
+			
+			linked = pLoadCachedBinary( handleShader, cacheId, cacheValidation );
+		}
+		
+		// compile the tessellation control program if existing
+		if( ! linked && scTessellationControl ){
 			compiled->CreateTessellationControlProgram();
 			handleTCP = compiled->GetHandleTCP();
 			if( ! handleTCP ){
 				DETHROW( deeInvalidAction );
 			}
 			
-			pPreparePreprocessor( program.GetDefines() );
-			
-			if( scTessellationControl ){
-				pAppendPreprocessSourcesBuffer( scTessellationControl->GetFilePath(), scTessellationControl->GetSourceCode() );
-			}
-			
-			if( ! pCompileObject( handleTCP ) ){
+			if( ! pCompileObject( handleTCP, preprocessedTCP ) ){
 				pRenderThread.GetLogger().LogError( "Shader compilation failed:" );
 				pRenderThread.GetLogger().LogErrorFormat( "  shader file = %s", sources.GetFilename().GetString() );
 				
@@ -362,6 +489,11 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 				if( pErrorLog ){
 					pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
 				}
+				
+				// preprocess again since memoized sources lack the source location map
+				pPreparePreprocessor( defines );
+				pAppendPreprocessSourcesBuffer( scTessellationControl->GetFilePath(), scTessellationControl->GetSourceCode() );
+				
 				pOutputShaderToFile( "error" );
 				pPreprocessor.LogSourceLocationMap();
 				DETHROW( deeInvalidParam );
@@ -370,20 +502,14 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 		}
 		
 		// compile the tessellation evaluation program if existing
-		if( scTessellationEvaluation ){
+		if( ! linked && scTessellationEvaluation ){
 			compiled->CreateTessellationEvaluationProgram();
 			handleTEP = compiled->GetHandleTEP();
 			if( ! handleTEP ){
 				DETHROW( deeInvalidAction );
 			}
 			
-			pPreparePreprocessor( program.GetDefines() );
-			
-			if( scTessellationEvaluation ){
-				pAppendPreprocessSourcesBuffer( scTessellationEvaluation->GetFilePath(), scTessellationEvaluation->GetSourceCode() );
-			}
-			
-			if( ! pCompileObject( handleTEP ) ){
+			if( ! pCompileObject( handleTEP, preprocessedTEP ) ){
 				pRenderThread.GetLogger().LogError( "Shader compilation failed:" );
 				pRenderThread.GetLogger().LogErrorFormat( "  shader file = %s", sources.GetFilename().GetString() );
 				
@@ -394,6 +520,11 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 				if( pErrorLog ){
 					pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
 				}
+				
+				// preprocess again since memoized sources lack the source location map
+				pPreparePreprocessor( defines );
+				pAppendPreprocessSourcesBuffer( scTessellationEvaluation->GetFilePath(), scTessellationEvaluation->GetSourceCode() );
+				
 				pOutputShaderToFile( "error" );
 				pPreprocessor.LogSourceLocationMap();
 				DETHROW( deeInvalidParam );
@@ -402,28 +533,19 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 		}
 		
 		// compile the geometry program if existing
-		if( scGeometry || ! inlscGeometry.IsEmpty() ){
+		if( ! linked && ( scGeometry || ! inlscGeometry.IsEmpty() ) ){
 			compiled->CreateGeometryProgram();
 			handleGP = compiled->GetHandleGP();
 			if( ! handleGP ) DETHROW( deeInvalidAction );
 			
-			pPreparePreprocessor( program.GetDefines() );
-			
-			if( scGeometry ){
-				pAppendPreprocessSourcesBuffer( scGeometry->GetFilePath(), scGeometry->GetSourceCode() );
-				
-			}else{
-				pAppendPreprocessSourcesBuffer( "<inline>", inlscGeometry.GetString() );
-			}
-			
 			#ifdef PRINT_ALL_SHADERS
 			pRenderThread.GetLogger().LogInfo( "COMPILE GEOMETRY IN" );
-			pRenderThread.GetLogger().LogInfo( pPreprocessor.GetSources() );
+			pRenderThread.GetLogger().LogInfo( preprocessedGP );
 			#ifdef PRINT_SHADERS_SPECIAL_MODE
-			vSpecialPrintShader.sourceGeometry = pPreprocessor.GetSources();
+			vSpecialPrintShader.sourceGeometry = preprocessedGP;
 			#endif
 			#endif
-			if( ! pCompileObject( handleGP ) ){
+			if( ! pCompileObject( handleGP, preprocessedGP ) ){
 				pRenderThread.GetLogger().LogError( "Shader compilation failed:" );
 				pRenderThread.GetLogger().LogErrorFormat( "  shader file = %s", sources.GetFilename().GetString() );
 				
@@ -437,6 +559,17 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 				if( pErrorLog ){
 					pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
 				}
+				
+				// preprocess again since memoized sources lack the source location map
+				pPreparePreprocessor( defines );
+				
+				if( scGeometry ){
+					pAppendPreprocessSourcesBuffer( scGeometry->GetFilePath(), scGeometry->GetSourceCode() );
+					
+				}else{
+					pAppendPreprocessSourcesBuffer( "<inline>", inlscGeometry.GetString() );
+				}
+				
 				pOutputShaderToFile( "error" );
 				pPreprocessor.LogSourceLocationMap();
 				DETHROW( deeInvalidParam );
@@ -448,30 +581,21 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 		}
 		
 		// compile the vertex program if existing
-		if( scVertex || ! inlscVertex.IsEmpty() ){
+		if( ! linked && ( scVertex || ! inlscVertex.IsEmpty() ) ){
 			compiled->CreateVertexProgram();
 			handleVP = compiled->GetHandleVP();
 			if( ! handleVP ) DETHROW( deeInvalidAction );
 			
-			pPreparePreprocessor( program.GetDefines() );
-			
-			if( scVertex ){
-				pAppendPreprocessSourcesBuffer( scVertex->GetFilePath(), scVertex->GetSourceCode() );
-				
-			}else{
-				pAppendPreprocessSourcesBuffer( "<inline>", inlscVertex.GetString() );
-			}
-			
 			#ifdef PRINT_SHADERS
 			if( psfMatchesVertex( program ) ){
 				pRenderThread.GetLogger().LogInfo( "COMPILE VERTEX IN" );
-				pRenderThread.GetLogger().LogInfo( pPreprocessor.GetSources() );
+				pRenderThread.GetLogger().LogInfo( preprocessedVP );
 				#ifdef PRINT_SHADERS_SPECIAL_MODE
-				vSpecialPrintShader.sourceVertex = pPreprocessor.GetSources();
+				vSpecialPrintShader.sourceVertex = preprocessedVP;
 				#endif
 			}
 			#endif
-			if( ! pCompileObject( handleVP ) ){
+			if( ! pCompileObject( handleVP, preprocessedVP ) ){
 				pRenderThread.GetLogger().LogError( "Shader compilation failed:" );
 				pRenderThread.GetLogger().LogErrorFormat( "  shader file = %s", sources.GetFilename().GetString() );
 				
@@ -485,6 +609,17 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 				if( pErrorLog ){
 					pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
 				}
+				
+				// preprocess again since memoized sources lack the source location map
+				pPreparePreprocessor( defines );
+				
+				if( scVertex ){
+					pAppendPreprocessSourcesBuffer( scVertex->GetFilePath(), scVertex->GetSourceCode() );
+					
+				}else{
+					pAppendPreprocessSourcesBuffer( "<inline>", inlscVertex.GetString() );
+				}
+				
 				pPreprocessor.LogSourceLocationMap();
 				pOutputShaderToFile( "error" );
 				DETHROW( deeInvalidParam );
@@ -504,39 +639,21 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 		}
 		
 		// compiled the fragment program if existing
-		if( scFragment || ! inlscFragment.IsEmpty() ){
+		if( ! linked && ( scFragment || ! inlscFragment.IsEmpty() ) ){
 			compiled->CreateFragmentProgram();
 			handleFP = compiled->GetHandleFP();
 			if( ! handleFP ) DETHROW( deeInvalidAction );
 			
-			pPreparePreprocessor( program.GetDefines() );
-			
-			#ifdef ANDROID
-			if( scFragment ){
-				pAppendPreprocessSourcesBuffer( scFragment->GetFilePath(), scFragment->GetSourceCode(), &outputList );
-				
-			}else{
-				pAppendPreprocessSourcesBuffer( "<inline>", inlscFragment.GetString(), &outputList );
-			}
-			#else
-			if( scFragment ){
-				pAppendPreprocessSourcesBuffer( scFragment->GetFilePath(), scFragment->GetSourceCode() );
-				
-			}else{
-				pAppendPreprocessSourcesBuffer( "<inline>", inlscFragment.GetString() );
-			}
-			#endif
-			
 			#ifdef PRINT_SHADERS
 			if( psfMatchesFragment( program ) ){
 				pRenderThread.GetLogger().LogInfo( "COMPILE FRAGMENT IN" );
-				pRenderThread.GetLogger().LogInfo( pPreprocessor.GetSources() );
+				pRenderThread.GetLogger().LogInfo( preprocessedFP );
 				#ifdef PRINT_SHADERS_SPECIAL_MODE
-				vSpecialPrintShader.sourceFragment = pPreprocessor.GetSources();
+				vSpecialPrintShader.sourceFragment = preprocessedFP;
 				#endif
 			}
 			#endif
-			if( ! pCompileObject( handleFP ) ){
+			if( ! pCompileObject( handleFP, preprocessedFP ) ){
 				pRenderThread.GetLogger().LogError( "Shader compilation failed:" );
 				pRenderThread.GetLogger().LogErrorFormat( "  shader file = %s", sources.GetFilename().GetString() );
 				
@@ -550,6 +667,26 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 				if( pErrorLog ){
 					pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
 				}
+				
+				// preprocess again since memoized sources lack the source location map
+				pPreparePreprocessor( defines );
+				
+				#ifdef ANDROID
+				if( scFragment ){
+					pAppendPreprocessSourcesBuffer( scFragment->GetFilePath(), scFragment->GetSourceCode(), &outputList );
+					
+				}else{
+					pAppendPreprocessSourcesBuffer( "<inline>", inlscFragment.GetString(), &outputList );
+				}
+				#else
+				if( scFragment ){
+					pAppendPreprocessSourcesBuffer( scFragment->GetFilePath(), scFragment->GetSourceCode() );
+					
+				}else{
+					pAppendPreprocessSourcesBuffer( "<inline>", inlscFragment.GetString() );
+				}
+				#endif
+				
 				pPreprocessor.LogSourceLocationMap();
 				pOutputShaderToFile( "error" );
 				DETHROW( deeInvalidParam );
@@ -562,104 +699,115 @@ deoglShaderCompiled *deoglShaderLanguage::CompileShader( deoglShaderProgram &pro
 			OGL_CHECK( pRenderThread, pglAttachShader( handleShader, handleFP ) );
 		}
 		
-		// bind attribute locations. this has to be done before linking according to ogl
-		// specs. furthermore the name is not required to exist. if not existing the
-		// output is simple not linked to anything.
-		if( pglBindAttribLocation ){
-			count = inputList.GetCount();
-			for( i=0; i<count; i++ ){
-				OGL_CHECK( pRenderThread, pglBindAttribLocation( handleShader, inputList.GetTargetAt( i ), inputList.GetNameAt( i ) ) );
-			}
-		}
-		
-		// bind data locations. this has to be done before linking according to ogl specs.
-		// furthermore the name is not required to exist. if not existing the output is
-		// simple not linked to anything.
-		if( pglBindFragDataLocation ){
-			count = outputList.GetCount();
-			for( i=0; i<count; i++ ){
-				OGL_CHECK( pRenderThread, pglBindFragDataLocation( handleShader, outputList.GetTargetAt( i ), outputList.GetNameAt( i ) ) );
+		if( ! linked ){
+			// bind attribute locations. this has to be done before linking according to ogl
+			// specs. furthermore the name is not required to exist. if not existing the
+			// output is simple not linked to anything.
+			if( pglBindAttribLocation ){
+				count = inputList.GetCount();
+				for( i=0; i<count; i++ ){
+					OGL_CHECK( pRenderThread, pglBindAttribLocation( handleShader, inputList.GetTargetAt( i ), inputList.GetNameAt( i ) ) );
+				}
 			}
-		}
-		
-		// bind feedback variables. this has to be done before linking according to ogl specs
-		if( pglTransformFeedbackVaryings ){
-			count = feedbackList.GetCount();
 			
-			if( count > 0 ){
-				const char ** const varnames = new const char *[ count ];
-				
+			// bind data locations. this has to be done before linking according to ogl specs.
+			// furthermore the name is not required to exist. if not existing the output is
+			// simple not linked to anything.
+			if( pglBindFragDataLocation ){
+				count = outputList.GetCount();
 				for( i=0; i<count; i++ ){
-					varnames[ i ] = feedbackList.GetAt( i ).GetString();
+					OGL_CHECK( pRenderThread, pglBindFragDataLocation( handleShader, outputList.GetTargetAt( i ), outputList.GetNameAt( i ) ) );
 				}
-				
-				OGL_CHECK( pRenderThread, pglTransformFeedbackVaryings( handleShader, count, varnames, GL_INTERLEAVED_ATTRIBS ) );
-				
-				delete [] varnames;
 			}
-		}
-		
-		// mark feedback variables active. required only if only the NV transform feedback extension exists.
-		// required to be done before linking
-		if( ! pglTransformFeedbackVaryings && pglTransformFeedbackVaryingsNV ){
-			count = feedbackList.GetCount();
 			
-			for( i=0; i<count; i++ ){
-				OGL_CHECK( pRenderThread, pglActiveVaryingNV( handleShader, feedbackList.GetAt( i ).GetString() ) );
-			}
-		}
-		
-		// link the shader
-		#ifdef PRINT_SHADERS
-		if( psfMatchesLink( program ) ){
-			pRenderThread.GetLogger().LogInfo( "COMPILE LINK IN" );
-			#ifdef PRINT_SHADERS_SPECIAL_MODE
-			vSpecialPrintShader.PrintShader();
-			#endif
-		}
-		#endif
-		if( ! pLinkShader( handleShader ) ){
-			pRenderThread.GetLogger().LogErrorFormat( "Shader linking failed (%s):", sources.GetFilename().GetString() );
-			
-			if( scTessellationControl ){
-				pRenderThread.GetLogger().LogErrorFormat( "  tessellation control unit source code file = %s", scTessellationControl->GetFilePath() );
-			}
-			if( scTessellationEvaluation ){
-				pRenderThread.GetLogger().LogErrorFormat( "  tessellation evaluation unit source code file = %s", scTessellationEvaluation->GetFilePath() );
+			// bind feedback variables. this has to be done before linking according to ogl specs
+			if( pglTransformFeedbackVaryings ){
+				count = feedbackList.GetCount();
+				
+				if( count > 0 ){
+					const char ** const varnames = new const char *[ count ];
+					
+					for( i=0; i<count; i++ ){
+						varnames[ i ] = feedbackList.GetAt( i ).GetString();
+					}
+					
+					OGL_CHECK( pRenderThread, pglTransformFeedbackVaryings( handleShader, count, varnames, GL_INTERLEAVED_ATTRIBS ) );
+					
+					delete [] varnames;
+				}
 			}
 			
-			if( scGeometry ){
-				pRenderThread.GetLogger().LogErrorFormat( "  geometry unit source code file = %s", scGeometry->GetFilePath() );
+			// mark feedback variables active. required only if only the NV transform feedback extension exists.
+			// required to be done before linking
+			if( ! pglTransformFeedbackVaryings && pglTransformFeedbackVaryingsNV ){
+				count = feedbackList.GetCount();
 				
-			}else{
-				pRenderThread.GetLogger().LogErrorFormat( "  inline geometry unit source code." );
+				for( i=0; i<count; i++ ){
+					OGL_CHECK( pRenderThread, pglActiveVaryingNV( handleShader, feedbackList.GetAt( i ).GetString() ) );
+				}
 			}
 			
-			if( scVertex ){
-				pRenderThread.GetLogger().LogErrorFormat( "  vertex unit source code file = %s", scVertex->GetFilePath() );
-				
-			}else{
-				pRenderThread.GetLogger().LogErrorFormat( "  inline vertex unit source code." );
+			// hint the driver the program binary will be retrieved after linking
+			if( cacheBinary ){
+				OGL_CHECK( pRenderThread, pglProgramParameteri( handleShader, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE ) );
 			}
 			
-			if( scFragment ){
-				pRenderThread.GetLogger().LogErrorFormat( "  fragment unit source code file = %s", scFragment->GetFilePath() );
+			// link the shader
+			#ifdef PRINT_SHADERS
+			if( psfMatchesLink( program ) ){
+				pRenderThread.GetLogger().LogInfo( "COMPILE LINK IN" );
+				#ifdef PRINT_SHADERS_SPECIAL_MODE
+				vSpecialPrintShader.PrintShader();
+				#endif
+			}
+			#endif
+			if( ! pLinkShader( handleShader ) ){
+				pRenderThread.GetLogger().LogErrorFormat( "Shader linking failed (%s):", sources.GetFilename().GetString() );
 				
-			}else{
-				pRenderThread.GetLogger().LogError( "  inline fragment unit source code." );
+				if( scTessellationControl ){
+					pRenderThread.GetLogger().LogErrorFormat( "  tessellation control unit source code file = %s", scTessellationControl->GetFilePath() );
+				}
+				if( scTessellationEvaluation ){
+					pRenderThread.GetLogger().LogErrorFormat( "  tessellation evaluation unit source code file = %s", scTessellationEvaluation->GetFilePath() );
+				}
+				
+				if( scGeometry ){
+					pRenderThread.GetLogger().LogErrorFormat( "  geometry unit source code file = %s", scGeometry->GetFilePath() );
+					
+				}else{
+					pRenderThread.GetLogger().LogErrorFormat( "  inline geometry unit source code." );
+				}
+				
+				if( scVertex ){
+					pRenderThread.GetLogger().LogErrorFormat( "  vertex unit source code file = %s", scVertex->GetFilePath() );
+					
+				}else{
+					pRenderThread.GetLogger().LogErrorFormat( "  inline vertex unit source code." );
+				}
+				
+				if( scFragment ){
+					pRenderThread.GetLogger().LogErrorFormat( "  fragment unit source code file = %s", scFragment->GetFilePath() );
+					
+				}else{
+					pRenderThread.GetLogger().LogError( "  inline fragment unit source code." );
+				}
+				
+				if( pErrorLog ){
+					pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
+				}
+				
+				DETHROW( deeInvalidParam );
 			}
-			
-			if( pErrorLog ){
-				pRenderThread.GetLogger().LogErrorFormat( "  error log: %s", pErrorLog );
+			#ifdef PRINT_SHADERS
+			if( psfMatchesLink( program ) ){
+				pRenderThread.GetLogger().LogInfo( "COMPILE LINK OUT" );
 			}
+			#endif
 			
-			DETHROW( deeInvalidParam );
-		}
-		#ifdef PRINT_SHADERS
-		if( psfMatchesLink( program ) ){
-			pRenderThread.GetLogger().LogInfo( "COMPILE LINK OUT" );
+			if( cacheBinary ){
+				pSaveCachedBinary( handleShader, cacheId, cacheValidation );
+			}
 		}
-		#endif
 		
 		// for the rest we have to activate this shader. to avoid upseting the shader tracker the current shader
 		// has to be deactivated first. this ensures the next time a shader is activated it is bound as active
@@ -1314,9 +1462,9 @@ void deoglShaderLanguage::pAppendPreprocessSourcesBuffer( const char *inputFile,
 }
 #endif
 
-bool deoglShaderLanguage::pCompileObject( GLuint handle ){
-	const char *sources = pPreprocessor.GetSources();
-	int sourcesLen = pPreprocessor.GetSourcesLength();
+bool deoglShaderLanguage::pCompileObject( GLuint handle, const decString &preprocessed ){
+	const char *sources = preprocessed.GetString();
+	int sourcesLen = preprocessed.GetLength();
 	int result;
 	
 	try{
@@ -1391,6 +1539,180 @@ bool deoglShaderLanguage::pLinkShader( GLuint handle ){
 	return true;
 }
 
+#ifdef ANDROID
+void deoglShaderLanguage::pPreprocessUnit( decString &preprocessed, const char *memoKey,
+const deoglShaderDefines &defines, const char *inputFile, const char *data,
+const deoglShaderBindingList *outputList ){
+#else
+void deoglShaderLanguage::pPreprocessUnit( decString &preprocessed, const char *memoKey,
+const deoglShaderDefines &defines, const char *inputFile, const char *data ){
+#endif
+	decString key( memoKey );
+	appendDefinesKey( key, defines );
+	
+	const decString *memoized;
+	if( pPreprocessedUnits.GetAt( key, &memoized ) ){
+		preprocessed = *memoized;
+		return;
+	}
+	
+	pPreparePreprocessor( defines );
+	#ifdef ANDROID
+	pAppendPreprocessSourcesBuffer( inputFile, data, outputList );
+	#else
+	pAppendPreprocessSourcesBuffer( inputFile, data );
+	#endif
+	preprocessed = pPreprocessor.GetSources();
+	
+	if( pPreprocessedUnitsSize + preprocessed.GetLength() > MAX_PREPROCESSED_UNITS_SIZE ){
+		pPreprocessedUnits.RemoveAll();
+		pPreprocessedUnitsSize = 0;
+	}
+	
+	pPreprocessedUnits.SetAt( key, preprocessed );
+	pPreprocessedUnitsSize += preprocessed.GetLength();
+}
+
+bool deoglShaderLanguage::pLoadCachedBinary( GLuint handle, const decString &cacheId,
+const decString &validation ){
+	deoglCaches &caches = pRenderThread.GetOgl().GetCaches();
+	deCacheHelper &cacheShaders = caches.GetShaders();
+	decBaseFileReader *reader = NULL;
+	char *binary = NULL;
+	GLenum format = 0;
+	int length = 0;
+	
+	caches.Lock();
+	
+	try{
+		reader = cacheShaders.Read( cacheId );
+		
+		if( reader ){
+			// reject the cached binary if the cache version, the driver or the sources changed
+			if( reader->ReadByte() == CACHE_VERSION && reader->ReadString16() == validation ){
+				format = ( GLenum )reader->ReadUInt();
+				length = reader->ReadInt();
+				if( length < 1 ){
+					DETHROW( deeInvalidFileFormat );
+				}
+				
+				binary = new char[ length ];
+				reader->Read( binary, length );
+				
+			}else{
+				pRenderThread.GetLogger().LogInfoFormat( "Shader '%s': Cache outdated. Cache discarded",
+					cacheId.GetString() );
+			}
+			
+			reader->FreeReference();
+			reader = NULL;
+			
+			if( ! binary ){
+				cacheShaders.Delete( cacheId );
+			}
+		}
+		
+		caches.Unlock();
+		
+	}catch( const deException &e ){
+		if( binary ){
+			delete [] binary;
+		}
+		if( reader ){
+			reader->FreeReference();
+		}
+		cacheShaders.Delete( cacheId );
+		caches.Unlock();
+		pRenderThread.GetLogger().LogErrorFormat( "Shader '%s': Loading cache failed. Cache discarded",
+			cacheId.GetString() );
+		pRenderThread.GetLogger().LogException( e );
+		return false;
+	}
+	
+	if( ! binary ){
+		return false;
+	}
+	
+	// drivers reject binaries if they consider them incompatible for example after an update.
+	// the error state is cleared since failing is fine. the program is compiled in this case
+	GLint result = GL_FALSE;
+	pglProgramBinary( handle, format, binary, length );
+	glGetError();
+	delete [] binary;
+	
+	OGL_CHECK( pRenderThread, pglGetProgramiv( handle, GL_LINK_STATUS, &result ) );
+	if( result ){
+		return true;
+	}
+	
+	pRenderThread.GetLogger().LogInfoFormat( "Shader '%s': Cache rejected by driver. Cache discarded",
+		cacheId.GetString() );
+	
+	caches.Lock();
+	try{
+		cacheShaders.Delete( cacheId );
+		caches.Unlock();
+		
+	}catch( const deException & ){
+		caches.Unlock();
+		throw;
+	}
+	
+	return false;
+}
+
+void deoglShaderLanguage::pSaveCachedBinary( GLuint handle, const decString &cacheId,
+const decString &validation ){
+	GLint length = 0;
+	OGL_CHECK( pRenderThread, pglGetProgramiv( handle, GL_PROGRAM_BINARY_LENGTH, &length ) );
+	if( length < 1 ){
+		return;
+	}
+	
+	deoglCaches &caches = pRenderThread.GetOgl().GetCaches();
+	deCacheHelper &cacheShaders = caches.GetShaders();
+	char * const binary = new char[ length ];
+	decBaseFileWriter *writer = NULL;
+	GLenum format = 0;
+	
+	try{
+		OGL_CHECK( pRenderThread, pglGetProgramBinary( handle, length, &length, &format, binary ) );
+		
+	}catch( const deException & ){
+		delete [] binary;
+		throw;
+	}
+	
+	// failing to write the cache is not an error. the program is compiled again next time
+	caches.Lock();
+	
+	try{
+		writer = cacheShaders.Write( cacheId );
+		writer->WriteByte( CACHE_VERSION );
+		writer->WriteString16( validation );
+		writer->WriteUInt( ( unsigned int )format );
+		writer->WriteInt( length );
+		writer->Write( binary, length );
+		
+		writer->FreeReference();
+		writer = NULL;
+		
+		caches.Unlock();
+		
+	}catch( const deException &e ){
+		if( writer ){
+			writer->FreeReference();
+		}
+		cacheShaders.Delete( cacheId );
+		caches.Unlock();
+		pRenderThread.GetLogger().LogErrorFormat( "Shader '%s': Writing cache failed",
+			cacheId.GetString() );
+		pRenderThread.GetLogger().LogException( e );
+	}
+	
+	delete [] binary;
+}
+
 void deoglShaderLanguage::pOutputShaderToFile( const char *file ){
 #ifdef ANDROID
 	pRenderThread.GetLogger().LogErrorFormat( "%s_%.3i.shader", file, pShaderFileNumber++ );
@@ -26,6 +26,7 @@
 #include "../deoglBasics.h"
 
 #include <dragengine/common/string/decStringList.h>
+#include <dragengine/common/string/decStringDictionary.h>
 
 class deoglShaderDefines;
 class deoglShaderSources;
@@ -58,6 +59,12 @@ private:
 	
 	deoglShaderPreprocessor pPreprocessor;
 	
+	decStringDictionary pPreprocessedUnits;
+	int pPreprocessedUnitsSize;
+	
+	bool pCacheBinaries;
+	decString pDriverIdentity;
+	
 public:
 	/** @name Constructors and Destructors */
 	/*@{*/
@@ -69,7 +76,11 @@ public:
 	
 	/** @name Management */
 	/*@{*/
-	/** Compieles a shader from the given sources using the specified defines. */
+	/**
+	 * Compieles a shader from the given sources using the specified defines. Preprocessed
+	 * unit sources are memoized. If supported linked program binaries are stored in the
+	 * shader cache and used instead of compiling the shader if still valid.
+	 */
 	deoglShaderCompiled *CompileShader( deoglShaderProgram &program );
 	/*@}*/
 	
@@ -82,9 +93,20 @@ private:
 	void pAppendPreprocessSourcesBuffer( const char *inputFile, const char *data );
 	#endif
 	
-	bool pCompileObject( GLuint handle );
+	#ifdef ANDROID
+	void pPreprocessUnit( decString &preprocessed, const char *memoKey, const deoglShaderDefines &defines,
+		const char *inputFile, const char *data, const deoglShaderBindingList *outputList = NULL );
+	#else
+	void pPreprocessUnit( decString &preprocessed, const char *memoKey, const deoglShaderDefines &defines,
+		const char *inputFile, const char *data );
+	#endif
+	
+	bool pCompileObject( GLuint handle, const decString &preprocessed );
 	bool pLinkShader( GLuint handle );
 	
+	bool pLoadCachedBinary( GLuint handle, const decString &cacheId, const decString &validation );
+	void pSaveCachedBinary( GLuint handle, const decString &cacheId, const decString &validation );
+	
 	void pOutputShaderToFile( const char *file );
 	void pPrintErrorLog();
 };
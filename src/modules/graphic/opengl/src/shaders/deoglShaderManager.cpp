@@ -46,6 +46,14 @@
 
 
 
+// Definitions
+////////////////
+
+// initial number of program hash buckets. has to be a power of two
+#define PROGRAM_BUCKET_COUNT 64
+
+
+
 // Class deoglShaderManager
 /////////////////////////////
 
@@ -68,10 +76,13 @@ pSourcesSize( 0 ),
 pPrograms( NULL ),
 pProgramCount( 0 ),
 pProgramSize( 0 ),
+pProgramBuckets( NULL ),
+pProgramBucketCount( 0 ),
 
 pPathShaderSources( "/share/shaderSources" ),
 pPathShaders( "/share/shaders" )
 {
+	pRehashPrograms( PROGRAM_BUCKET_COUNT );
 	pLanguage = new deoglShaderLanguage( renderThread );
 }
 
@@ -89,6 +100,9 @@ deoglShaderManager::~deoglShaderManager(){
 	if( pPrograms ){
 		delete [] pPrograms;
 	}
+	if( pProgramBuckets ){
+		delete [] pProgramBuckets;
+	}
 	
 	RemoveAllSources();
 	if( pSources ){
@@ -394,15 +408,7 @@ bool deoglShaderManager::HasProgramWith( deoglShaderSources *sources, const deog
 		DETHROW( deeInvalidParam );
 	}
 	
-	int i;
-	
-	for( i=0; i<pProgramCount; i++ ){
-		if( sources == pPrograms[ i ]->GetSources() && defines.Equals( pPrograms[ i ]->GetDefines() ) ){
-			return true;
-		}
-	}
-	
-	return false;
+	return pFindProgram( sources, defines ) != NULL;
 }
 
 deoglShaderProgram *deoglShaderManager::GetProgramWith( deoglShaderSources *sources, const deoglShaderDefines &defines ){
@@ -410,24 +416,21 @@ deoglShaderProgram *deoglShaderManager::GetProgramWith( deoglShaderSources *sour
 		DETHROW( deeInvalidParam );
 	}
 	
-	int i;
+	deoglShaderProgram *program = pFindProgram( sources, defines );
 	
-	for( i=0; i<pProgramCount; i++ ){
-		if( sources == pPrograms[ i ]->GetSources() && defines.Equals( pPrograms[ i ]->GetDefines() ) ){
-			if( pPrograms[ i ]->GetUsageCount() < 0 ){
-				pRenderThread.GetLogger().LogWarnFormat( "ShaderManager.GetProgramWith(): Program '%s' has usage count %i!",
-					pPrograms[ i ]->GetSources()->GetName().GetString(), pPrograms[ i ]->GetUsageCount() );
-				
-				while( pPrograms[ i ]->GetUsageCount() < 0 ){
-					pPrograms[ i ]->AddUsage();
-				}
+	if( program ){
+		if( program->GetUsageCount() < 0 ){
+			pRenderThread.GetLogger().LogWarnFormat( "ShaderManager.GetProgramWith(): Program '%s' has usage count %i!",
+				program->GetSources()->GetName().GetString(), program->GetUsageCount() );
+			
+			while( program->GetUsageCount() < 0 ){
+				program->AddUsage();
 			}
-			pPrograms[ i ]->AddUsage();
-			return pPrograms[ i ];
 		}
+		program->AddUsage();
+		return program;
 	}
 	
-	deoglShaderProgram *program = NULL;
 	
 	try{
 		program = new deoglShaderProgram( sources, defines );
@@ -509,9 +512,21 @@ void deoglShaderManager::AddProgram( deoglShaderProgram *program ){
 	
 	pPrograms[ pProgramCount ] = program;
 	pProgramCount++;
+	
+	if( pProgramCount > pProgramBucketCount ){
+		pRehashPrograms( pProgramBucketCount * 2 );
+		
+	}else{
+		pAddProgramToBucket( program );
+	}
 }
 
 void deoglShaderManager::RemoveAllPrograms(){
+	int i;
+	for( i=0; i<pProgramBucketCount; i++ ){
+		pProgramBuckets[ i ] = NULL;
+	}
+	
 	while( pProgramCount > 0 ){
 		pProgramCount--;
 		delete pPrograms[ pProgramCount ];
@@ -619,3 +634,44 @@ void deoglShaderManager::pLoadSourcesIn( const char *directory ){
 		throw;
 	}
 }
+
+deoglShaderProgram *deoglShaderManager::pFindProgram( deoglShaderSources *sources,
+const deoglShaderDefines &defines ) const{
+	const unsigned int hashCode = deoglShaderProgram::CalcHashCode( *sources, defines );
+	deoglShaderProgram *program = pProgramBuckets[ hashCode & ( pProgramBucketCount - 1 ) ];
+	
+	while( program ){
+		if( program->GetHashCode() == hashCode && program->GetSources() == sources
+		&& defines.Equals( program->GetDefines() ) ){
+			return program;
+		}
+		program = program->GetLLHashNext();
+	}
+	
+	return NULL;
+}
+
+void deoglShaderManager::pAddProgramToBucket( deoglShaderProgram *program ){
+	const int bucket = ( int )( program->GetHashCode() & ( pProgramBucketCount - 1 ) );
+	program->SetLLHashNext( pProgramBuckets[ bucket ] );
+	pProgramBuckets[ bucket ] = program;
+}
+
+void deoglShaderManager::pRehashPrograms( int bucketCount ){
+	deoglShaderProgram ** const newBuckets = new deoglShaderProgram*[ bucketCount ];
+	int i;
+	
+	for( i=0; i<bucketCount; i++ ){
+		newBuckets[ i ] = NULL;
+	}
+	
+	if( pProgramBuckets ){
+		delete [] pProgramBuckets;
+	}
+	pProgramBuckets = newBuckets;
+	pProgramBucketCount = bucketCount;
+	
+	for( i=0; i<pProgramCount; i++ ){
+		pAddProgramToBucket( pPrograms[ i ] );
+	}
+}
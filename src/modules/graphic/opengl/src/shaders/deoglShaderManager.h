@@ -60,6 +60,8 @@ private:
 	deoglShaderProgram **pPrograms;
 	int pProgramCount;
 	int pProgramSize;
+	deoglShaderProgram **pProgramBuckets;
+	int pProgramBucketCount;
 	
 	decString pPathShaderSources;
 	decString pPathShaders;
@@ -163,6 +165,9 @@ public:
 private:
 	void pLoadUnitSourceCodesIn( const char *directory );
 	void pLoadSourcesIn( const char *directory );
+	deoglShaderProgram *pFindProgram( deoglShaderSources *sources, const deoglShaderDefines &defines ) const;
+	void pAddProgramToBucket( deoglShaderProgram *program );
+	void pRehashPrograms( int bucketCount );
 };
 
 // end of include only once
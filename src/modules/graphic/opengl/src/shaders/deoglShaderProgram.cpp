@@ -24,6 +24,7 @@
 
 #include "deoglShaderCompiled.h"
 #include "deoglShaderProgram.h"
+#include "deoglShaderSources.h"
 #include "deoglShaderUnitSourceCode.h"
 
 #include <dragengine/common/exceptions.h>
@@ -54,6 +55,9 @@ deoglShaderProgram::deoglShaderProgram( deoglShaderSources *sources ){
 	pRenderTaskTrackingNumber = 0;
 	
 	pUsageCount = 1;
+	
+	pHashCode = CalcHashCode( *sources, pDefines );
+	pLLHashNext = NULL;
 }
 
 deoglShaderProgram::deoglShaderProgram( deoglShaderSources *sources, const deoglShaderDefines &defines ){
@@ -76,6 +80,9 @@ deoglShaderProgram::deoglShaderProgram( deoglShaderSources *sources, const deogl
 	pUsageCount = 1;
 	
 	pDefines = defines;
+	
+	pHashCode = CalcHashCode( *sources, pDefines );
+	pLLHashNext = NULL;
 }
 
 deoglShaderProgram::~deoglShaderProgram(){
@@ -89,6 +96,12 @@ deoglShaderProgram::~deoglShaderProgram(){
 // Management
 ///////////////
 
+unsigned int deoglShaderProgram::CalcHashCode( const deoglShaderSources &sources,
+const deoglShaderDefines &defines ){
+	return sources.GetName().Hash() * 31 + defines.CalcHashCode();
+}
+
+
 void deoglShaderProgram::SetTessellationControlSourceCode( deoglShaderUnitSourceCode *sourceCode ){
 	pSCTessellationControl = sourceCode;
 }
@@ -139,3 +152,12 @@ void deoglShaderProgram::RemoveUsage(){
 	
 	pUsageCount--;
 }
+
+
+
+// Linked List
+////////////////
+
+void deoglShaderProgram::SetLLHashNext( deoglShaderProgram *program ){
+	pLLHashNext = program;
+}
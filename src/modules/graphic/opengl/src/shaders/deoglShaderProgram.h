@@ -40,6 +40,8 @@ class deoglShaderProgram{
 private:
 	deoglShaderSources *pSources;
 	deoglShaderDefines pDefines;
+	unsigned int pHashCode;
+	deoglShaderProgram *pLLHashNext;
 	
 	deoglShaderUnitSourceCode *pSCTessellationControl;
 	deoglShaderUnitSourceCode *pSCTessellationEvaluation;
@@ -72,6 +74,12 @@ public:
 	/** Retrieves the defines. */
 	inline const deoglShaderDefines &GetDefines() const{ return pDefines; }
 	
+	/** \brief Hash code of sources and defines combination. */
+	inline unsigned int GetHashCode() const{ return pHashCode; }
+	
+	/** \brief Calculate hash code for sources and defines combination. */
+	static unsigned int CalcHashCode( const deoglShaderSources &sources, const deoglShaderDefines &defines );
+	
 	/** \brief Retrieves the tessellation control source code or NULL if not used. */
 	inline deoglShaderUnitSourceCode *GetTessellationControlSourceCode() const{ return pSCTessellationControl; }
 	/** \brief Sets the tessellation control source code or NULL if not used. */
@@ -114,6 +122,15 @@ public:
 	/** Removes a usage decreasing the usage count by one. */
 	void RemoveUsage();
 	/*@}*/
+	
+	/** @name Linked List */
+	/*@{*/
+	/** \brief Next program in shader manager hash bucket or NULL. */
+	inline deoglShaderProgram *GetLLHashNext() const{ return pLLHashNext; }
+	
+	/** \brief Set next program in shader manager hash bucket or NULL. */
+	void SetLLHashNext( deoglShaderProgram *program );
+	/*@}*/
 };
 
 #endif
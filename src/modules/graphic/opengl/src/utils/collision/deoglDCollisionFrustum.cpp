@@ -536,3 +536,28 @@ deoglDCollisionFrustum::eIntersectType deoglDCollisionFrustum::IntersectSphere(
 	
 	return result;
 }
+
+deoglDCollisionFrustum::eIntersectType deoglDCollisionFrustum::IntersectBox(
+const decDVector &center, const decDVector &halfSize ) const{
+	const decDVector * const normals[ 6 ] = { &pNormalNear, &pNormalFar,
+		&pNormalLeft, &pNormalRight, &pNormalTop, &pNormalBottom };
+	const double distances[ 6 ] = { pDistNear, pDistFar, pDistLeft, pDistRight, pDistTop, pDistBottom };
+	eIntersectType result = eitInside;
+	int i;
+	
+	for( i=0; i<6; i++ ){
+		const decDVector &normal = *normals[ i ];
+		const double radius = halfSize.x * fabs( normal.x ) + halfSize.y * fabs( normal.y )
+			+ halfSize.z * fabs( normal.z );
+		const double dist = normal * center - distances[ i ];
+		
+		if( dist < -radius ){
+			return eitOutside;
+		}
+		if( dist < radius ){
+			result = eitIntersect;
+		}
+	}
+	
+	return result;
+}
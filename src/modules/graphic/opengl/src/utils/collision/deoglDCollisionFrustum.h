@@ -229,6 +229,12 @@ public:
 	 * @return eIntersectType indicating the intersection type
 	 */
 	eIntersectType IntersectSphere(deoglDCollisionSphere *sphere);
+	
+	/**
+	 * Determines if the given axis aligned box intersects this frustum.
+	 * @return eIntersectType indicating the intersection type
+	 */
+	eIntersectType IntersectBox( const decDVector &center, const decDVector &halfSize ) const;
 	/*@}*/
 };
 
@@ -0,0 +1,267 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deoglFrustumCullBoxes.h"
+#include "deoglDCollisionFrustum.h"
+
+#include <dragengine/common/exceptions.h>
+
+#if defined( __SSE__ ) || defined( _M_X64 )
+#	include <xmmintrin.h>
+#	define DEOGLFRUSTUMCULLBOXES_SSE 1
+#endif
+
+
+
+// Definitions
+////////////////
+
+// tolerance added to the box extends to compensate for float precision relative to
+// the reference position
+#define CULL_TOLERANCE 0.01f
+
+
+
+// Class deoglFrustumCullBoxes
+////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+deoglFrustumCullBoxes::deoglFrustumCullBoxes() :
+pCenterX( NULL ),
+pCenterY( NULL ),
+pCenterZ( NULL ),
+pHalfSizeX( NULL ),
+pHalfSizeY( NULL ),
+pHalfSizeZ( NULL ),
+pVisible( NULL ),
+pCount( 0 ),
+pSize( 0 )
+{
+	memset( pNormalX, 0, sizeof( pNormalX ) );
+	memset( pNormalY, 0, sizeof( pNormalY ) );
+	memset( pNormalZ, 0, sizeof( pNormalZ ) );
+	memset( pDistance, 0, sizeof( pDistance ) );
+}
+
+deoglFrustumCullBoxes::~deoglFrustumCullBoxes(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void deoglFrustumCullBoxes::SetFrustum( const deoglDCollisionFrustum &frustum,
+const decDVector &referencePosition ){
+	const decDVector normals[ 6 ] = { frustum.GetNearNormal(), frustum.GetFarNormal(),
+		frustum.GetLeftNormal(), frustum.GetRightNormal(), frustum.GetTopNormal(),
+		frustum.GetBottomNormal() };
+	const double distances[ 6 ] = { frustum.GetNearDistance(), frustum.GetFarDistance(),
+		frustum.GetLeftDistance(), frustum.GetRightDistance(), frustum.GetTopDistance(),
+		frustum.GetBottomDistance() };
+	int i;
+	
+	// planes are moved to the reference position to keep float values small
+	for( i=0; i<6; i++ ){
+		pNormalX[ i ] = ( float )normals[ i ].x;
+		pNormalY[ i ] = ( float )normals[ i ].y;
+		pNormalZ[ i ] = ( float )normals[ i ].z;
+		pDistance[ i ] = ( float )( distances[ i ] - normals[ i ] * referencePosition );
+	}
+	
+	pReferencePosition = referencePosition;
+}
+
+void deoglFrustumCullBoxes::AddBox( const decDVector &minExtend, const decDVector &maxExtend ){
+	if( pCount == pSize ){
+		pResize( pSize * 3 / 2 + 4 );
+	}
+	
+	const decDVector center( ( minExtend + maxExtend ) * 0.5 - pReferencePosition );
+	const decDVector halfSize( ( maxExtend - minExtend ) * 0.5 );
+	
+	pCenterX[ pCount ] = ( float )center.x;
+	pCenterY[ pCount ] = ( float )center.y;
+	pCenterZ[ pCount ] = ( float )center.z;
+	pHalfSizeX[ pCount ] = ( float )halfSize.x + CULL_TOLERANCE;
+	pHalfSizeY[ pCount ] = ( float )halfSize.y + CULL_TOLERANCE;
+	pHalfSizeZ[ pCount ] = ( float )halfSize.z + CULL_TOLERANCE;
+	pCount++;
+}
+
+void deoglFrustumCullBoxes::RemoveAllBoxes(){
+	pCount = 0;
+}
+
+void deoglFrustumCullBoxes::Cull(){
+	int i, j;
+	
+#ifdef DEOGLFRUSTUMCULLBOXES_SSE
+	// arrays are sized in multiples of four. pad the last group with empty boxes
+	const int groupCount = ( pCount + 3 ) / 4;
+	
+	for( i=pCount; i<groupCount*4; i++ ){
+		pCenterX[ i ] = pCenterY[ i ] = pCenterZ[ i ] = 0.0f;
+		pHalfSizeX[ i ] = pHalfSizeY[ i ] = pHalfSizeZ[ i ] = 0.0f;
+	}
+	
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+	__m128 normalX[ 6 ], normalY[ 6 ], normalZ[ 6 ];
+	__m128 absNormalX[ 6 ], absNormalY[ 6 ], absNormalZ[ 6 ];
+	__m128 distance[ 6 ];
+	
+	for( j=0; j<6; j++ ){
+		normalX[ j ] = _mm_set1_ps( pNormalX[ j ] );
+		normalY[ j ] = _mm_set1_ps( pNormalY[ j ] );
+		normalZ[ j ] = _mm_set1_ps( pNormalZ[ j ] );
+		absNormalX[ j ] = _mm_andnot_ps( signMask, normalX[ j ] );
+		absNormalY[ j ] = _mm_andnot_ps( signMask, normalY[ j ] );
+		absNormalZ[ j ] = _mm_andnot_ps( signMask, normalZ[ j ] );
+		distance[ j ] = _mm_set1_ps( pDistance[ j ] );
+	}
+	
+	for( i=0; i<groupCount; i++ ){
+		const int base = i * 4;
+		const __m128 centerX = _mm_loadu_ps( pCenterX + base );
+		const __m128 centerY = _mm_loadu_ps( pCenterY + base );
+		const __m128 centerZ = _mm_loadu_ps( pCenterZ + base );
+		const __m128 halfSizeX = _mm_loadu_ps( pHalfSizeX + base );
+		const __m128 halfSizeY = _mm_loadu_ps( pHalfSizeY + base );
+		const __m128 halfSizeZ = _mm_loadu_ps( pHalfSizeZ + base );
+		__m128 outside = _mm_setzero_ps();
+		
+		for( j=0; j<6; j++ ){
+			const __m128 nearDot = _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( halfSizeX, absNormalX[ j ] ),
+				_mm_mul_ps( halfSizeY, absNormalY[ j ] ) ),
+				_mm_mul_ps( halfSizeZ, absNormalZ[ j ] ) );
+			const __m128 farDot = _mm_sub_ps( distance[ j ], _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( centerX, normalX[ j ] ),
+				_mm_mul_ps( centerY, normalY[ j ] ) ),
+				_mm_mul_ps( centerZ, normalZ[ j ] ) ) );
+			outside = _mm_or_ps( outside, _mm_cmpgt_ps( farDot, nearDot ) );
+		}
+		
+		const int mask = _mm_movemask_ps( outside );
+		const int last = decMath::min( base + 4, pCount );
+		for( j=base; j<last; j++ ){
+			pVisible[ j ] = ( mask & ( 1 << ( j - base ) ) ) == 0;
+		}
+	}
+	
+#else
+	for( i=0; i<pCount; i++ ){
+		pVisible[ i ] = true;
+		
+		for( j=0; j<6; j++ ){
+			const float nearDot = pHalfSizeX[ i ] * fabsf( pNormalX[ j ] )
+				+ pHalfSizeY[ i ] * fabsf( pNormalY[ j ] ) + pHalfSizeZ[ i ] * fabsf( pNormalZ[ j ] );
+			const float farDot = pDistance[ j ] - ( pCenterX[ i ] * pNormalX[ j ]
+				+ pCenterY[ i ] * pNormalY[ j ] + pCenterZ[ i ] * pNormalZ[ j ] );
+			if( farDot > nearDot ){
+				pVisible[ i ] = false;
+				break;
+			}
+		}
+	}
+#endif
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void deoglFrustumCullBoxes::pCleanUp(){
+	if( pVisible ){
+		delete [] pVisible;
+	}
+	if( pHalfSizeZ ){
+		delete [] pHalfSizeZ;
+	}
+	if( pHalfSizeY ){
+		delete [] pHalfSizeY;
+	}
+	if( pHalfSizeX ){
+		delete [] pHalfSizeX;
+	}
+	if( pCenterZ ){
+		delete [] pCenterZ;
+	}
+	if( pCenterY ){
+		delete [] pCenterY;
+	}
+	if( pCenterX ){
+		delete [] pCenterX;
+	}
+}
+
+void deoglFrustumCullBoxes::pResize( int size ){
+	// sizes are rounded up to multiples of four for processing groups of four boxes
+	size = ( size + 3 ) & ~3;
+	
+	float *arrays[ 6 ] = { NULL, NULL, NULL, NULL, NULL, NULL };
+	bool *visible = NULL;
+	int i;
+	
+	try{
+		for( i=0; i<6; i++ ){
+			arrays[ i ] = new float[ size ];
+		}
+		visible = new bool[ size ];
+		
+	}catch( const deException & ){
+		for( i=0; i<6; i++ ){
+			if( arrays[ i ] ){
+				delete [] arrays[ i ];
+			}
+		}
+		throw;
+	}
+	
+	if( pCount > 0 ){
+		memcpy( arrays[ 0 ], pCenterX, sizeof( float ) * pCount );
+		memcpy( arrays[ 1 ], pCenterY, sizeof( float ) * pCount );
+		memcpy( arrays[ 2 ], pCenterZ, sizeof( float ) * pCount );
+		memcpy( arrays[ 3 ], pHalfSizeX, sizeof( float ) * pCount );
+		memcpy( arrays[ 4 ], pHalfSizeY, sizeof( float ) * pCount );
+		memcpy( arrays[ 5 ], pHalfSizeZ, sizeof( float ) * pCount );
+	}
+	
+	pCleanUp();
+	
+	pCenterX = arrays[ 0 ];
+	pCenterY = arrays[ 1 ];
+	pCenterZ = arrays[ 2 ];
+	pHalfSizeX = arrays[ 3 ];
+	pHalfSizeY = arrays[ 4 ];
+	pHalfSizeZ = arrays[ 5 ];
+	pVisible = visible;
+	pSize = size;
+}
@@ -0,0 +1,101 @@
+/* 
+ * Drag[en]gine OpenGL Graphic Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEOGLFRUSTUMCULLBOXES_H_
+#define _DEOGLFRUSTUMCULLBOXES_H_
+
+#include <dragengine/common/math/decMath.h>
+
+class deoglDCollisionFrustum;
+
+
+
+/**
+ * \brief Cull list of boxes against frustum.
+ *
+ * Boxes are stored in structure of arrays form as float center and half size relative
+ * to a reference position. Culling tests four boxes at a time against all frustum planes
+ * using SSE if available. The test is the same as deoglDCollisionFrustum::BoxHitsFrustum()
+ * but with a small tolerance to stay conservative despite the float precision.
+ *
+ * Not thread safe. Use one instance per thread.
+ */
+class deoglFrustumCullBoxes{
+private:
+	float pNormalX[ 6 ];
+	float pNormalY[ 6 ];
+	float pNormalZ[ 6 ];
+	float pDistance[ 6 ];
+	decDVector pReferencePosition;
+	
+	float *pCenterX;
+	float *pCenterY;
+	float *pCenterZ;
+	float *pHalfSizeX;
+	float *pHalfSizeY;
+	float *pHalfSizeZ;
+	bool *pVisible;
+	int pCount;
+	int pSize;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create box list. */
+	deoglFrustumCullBoxes();
+	
+	/** \brief Clean up box list. */
+	~deoglFrustumCullBoxes();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Set frustum and reference position. */
+	void SetFrustum( const deoglDCollisionFrustum &frustum, const decDVector &referencePosition );
+	
+	/** \brief Number of boxes. */
+	inline int GetCount() const{ return pCount; }
+	
+	/** \brief Add box. */
+	void AddBox( const decDVector &minExtend, const decDVector &maxExtend );
+	
+	/** \brief Remove all boxes. */
+	void RemoveAllBoxes();
+	
+	/** \brief Cull all boxes. */
+	void Cull();
+	
+	/** \brief Box at index is visible. Valid after Cull() has been called. */
+	inline bool GetVisibleAt( int index ) const{ return pVisible[ index ]; }
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+	void pResize( int size );
+};
+
+#endif
@@ -48,19 +48,24 @@
 #include "debnAddress.h"
 #include "debnConnection.h"
 #include "debnWorld.h"
+#include "debnLoadTest.h"
 #include "deNetworkBasic.h"
 #include "states/debnState.h"
+#include "io/debnIOEvent.h"
+#include "io/debnIOThread.h"
 
 #include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
 #include <dragengine/common/file/decBaseFileReader.h>
 #include <dragengine/common/file/decBaseFileReaderReference.h>
+#include <dragengine/common/math/decMath.h>
 #include <dragengine/common/string/unicode/decUnicodeString.h>
 #include <dragengine/common/string/unicode/decUnicodeArgumentList.h>
 #include <dragengine/resources/network/deNetworkMessage.h>
 #include <dragengine/resources/network/deNetworkMessageReader.h>
 #include <dragengine/resources/network/deNetworkMessageWriter.h>
 #include <dragengine/systems/modules/deModuleParameter.h>
+#include <dragengine/threading/deMutexGuard.h>
 
 
 
@@ -126,8 +131,12 @@ deBaseNetworkModule( loadableModule ){
 	pHeadSocket = NULL;
 	pTailSocket = NULL;
 	
-	pDatagram = NULL;
-	pAddressReceive = NULL;
+	pDatagrams = NULL;
+	pAddressesReceive = NULL;
+	
+	pIOThread = NULL;
+	pProcessEvents = NULL;
+	pUseIOThread = false;
 	
 	//pMessagesSend = NULL;
 	//pMessagesReceive = NULL;
@@ -146,19 +155,28 @@ deNetworkBasic::~deNetworkBasic(){
 
 bool deNetworkBasic::Init(){
 	try{
-		// create shared datagram
-		pDatagram = new deNetworkMessage;
-		if( ! pDatagram ) DETHROW( deeOutOfMemory );
-		pDatagram->SetDataLength( 1024 );
+		// create shared datagrams for batched receiving
+		int i;
+		pDatagrams = new deNetworkMessage*[ debnSocket::RECEIVE_BATCH_SIZE ];
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			pDatagrams[ i ] = NULL;
+		}
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			pDatagrams[ i ] = new deNetworkMessage;
+			pDatagrams[ i ]->SetDataLength( 1024 );
+		}
 		
-		// create receive address
-		pAddressReceive = new debnAddress;
-		if( ! pAddressReceive ) DETHROW( deeOutOfMemory );
+		// create receive addresses
+		pAddressesReceive = new debnAddress[ debnSocket::RECEIVE_BATCH_SIZE ];
 		
 		pSharedSendDatagram.TakeOver( new deNetworkMessage );
 		pSharedSendDatagram->SetDataLength( 50 );
 		pSharedSendDatagramWriter.TakeOver( new deNetworkMessageWriter( pSharedSendDatagram, false ) );
 		
+		if( pUseIOThread ){
+			pStartIOThread();
+		}
+		
 		// create send and receive message queues
 		//pMessagesSend = new debnMessageQueue;
 		//if( ! pMessagesSend ) DETHROW( deeOutOfMemory );
@@ -191,14 +209,22 @@ void deNetworkBasic::CleanUp(){
 		pMessagesReceive = NULL;
 	}*/
 	
-	if( pAddressReceive ){
-		delete pAddressReceive;
-		pAddressReceive = NULL;
+	pStopIOThread( false );
+	
+	if( pAddressesReceive ){
+		delete [] pAddressesReceive;
+		pAddressesReceive = NULL;
 	}
 	
-	if( pDatagram ){
-		pDatagram->FreeReference();
-		pDatagram = NULL;
+	if( pDatagrams ){
+		int i;
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			if( pDatagrams[ i ] ){
+				pDatagrams[ i ]->FreeReference();
+			}
+		}
+		delete [] pDatagrams;
+		pDatagrams = NULL;
 	}
 	
 	// ensure all linked lists are NULL
@@ -216,6 +242,21 @@ void deNetworkBasic::ProcessNetwork(){
 DEBUG_RESET_TIMERS;
 	const float elapsedTime = GetGameEngine()->GetElapsedTime();
 	
+	if( pIOThread ){
+		// the I/O thread receives datagrams and handles reliable transmission. process
+		// the handed over events, update states and send queued datagrams
+		pProcessIOEvents();
+DEBUG_PRINT_TIMER( *this, "Process I/O Events" );
+		
+		pProcessConnections( elapsedTime );
+DEBUG_PRINT_TIMER( *this, "Process Connections" );
+		
+		pFlushSockets();
+DEBUG_PRINT_TIMER( *this, "Flush Sockets" );
+DEBUG_PRINT_TIMER_TOTAL( *this, "Process Network" );
+		return;
+	}
+	
 	// process all messages destined to go out
 	pProcessConnections( elapsedTime );
 DEBUG_PRINT_TIMER( *this, "Process Connections" );
@@ -232,9 +273,91 @@ DEBUG_PRINT_TIMER( *this, "Sleep" );
 	// check on incoming messages
 	pReceiveDatagrams();
 DEBUG_PRINT_TIMER( *this, "Receive Datagrams" );
+	
+	// send all datagrams queued during processing in one batch per socket
+	pFlushSockets();
+DEBUG_PRINT_TIMER( *this, "Flush Sockets" );
 DEBUG_PRINT_TIMER_TOTAL( *this, "Process Network" );
 }
 
+void deNetworkBasic::SendCommand( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	if( command.GetArgumentCount() == 0 ){
+		answer.SetFromUTF8( "No command provided." );
+		return;
+	}
+	
+	if( command.MatchesArgumentAt( 0, "help" ) ){
+		answer.SetFromUTF8( "load_test [clients] [rounds] => Loopback load test simulating many clients.\n" );
+		
+	}else if( command.MatchesArgumentAt( 0, "load_test" ) ){
+		pCmdLoadTest( command, answer );
+		
+	}else{
+		answer.SetFromUTF8( "Unknown command '" );
+		answer += *command.GetArgumentAt( 0 );
+		answer.AppendFromUTF8( "'." );
+	}
+}
+
+
+
+// Parameters
+///////////////
+
+int deNetworkBasic::GetParameterCount() const{
+	return 1;
+}
+
+void deNetworkBasic::GetParameterInfo( int index, deModuleParameter &info ) const{
+	if( index != 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	info.SetName( "ioThread" );
+	info.SetDescription( "Receive datagrams, acknowledge and resend reliable messages "
+		"using a dedicated thread independent of the frame rate." );
+	info.SetType( deModuleParameter::eptBoolean );
+	info.SetDisplayName( "I/O Thread" );
+	info.SetCategory( deModuleParameter::ecAdvanced );
+}
+
+int deNetworkBasic::IndexOfParameterNamed( const char *name ) const{
+	return strcmp( name, "ioThread" ) == 0 ? 0 : -1;
+}
+
+decString deNetworkBasic::GetParameterValue( const char *name ) const{
+	if( strcmp( name, "ioThread" ) == 0 ){
+		return pUseIOThread ? "1" : "0";
+	}
+	
+	DETHROW( deeInvalidParam );
+}
+
+void deNetworkBasic::SetParameterValue( const char *name, const char *value ){
+	if( strcmp( name, "ioThread" ) != 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const bool useIOThread = strcmp( value, "1" ) == 0;
+	if( useIOThread == pUseIOThread ){
+		return;
+	}
+	
+	pUseIOThread = useIOThread;
+	
+	// thread is started during Init if the module is not initialized yet
+	if( ! pDatagrams ){
+		return;
+	}
+	
+	if( useIOThread ){
+		pStartIOThread();
+		
+	}else{
+		pStopIOThread( true );
+	}
+}
+
 
 
 // Peer Management
@@ -245,6 +368,8 @@ void deNetworkBasic::RegisterConnection( debnConnection *connection ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	const deMutexGuard guard( pMutex );
+	
 	if( pTailConnection ){
 		pTailConnection->SetNextConnection( connection );
 		connection->SetPreviousConnection( pTailConnection );
@@ -263,6 +388,8 @@ void deNetworkBasic::UnregisterConnection( debnConnection *connection ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	const deMutexGuard guard( pMutex );
+	
 	debnConnection * const previous = connection->GetPreviousConnection();
 	debnConnection * const next = connection->GetNextConnection();
 	
@@ -290,6 +417,8 @@ void deNetworkBasic::RegisterServer( debnServer *server ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	const deMutexGuard guard( pMutex );
+	
 	if( pTailServer ){
 		pTailServer->SetNextServer( server );
 		server->SetPreviousServer( pTailServer );
@@ -308,6 +437,8 @@ void deNetworkBasic::UnregisterServer( debnServer *server ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	const deMutexGuard guard( pMutex );
+	
 	debnServer * const previous = server->GetPreviousServer();
 	debnServer * const next = server->GetNextServer();
 	
@@ -335,6 +466,8 @@ void deNetworkBasic::RegisterSocket( debnSocket *bnSocket ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	const deMutexGuard guard( pMutex );
+	
 	if( pTailSocket ){
 		pTailSocket->SetNextSocket( bnSocket );
 		bnSocket->SetPreviousSocket( pTailSocket );
@@ -353,6 +486,8 @@ void deNetworkBasic::UnregisterSocket( debnSocket *bnSocket ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	const deMutexGuard guard( pMutex );
+	
 	debnSocket * const previous = bnSocket->GetPreviousSocket();
 	debnSocket * const next = bnSocket->GetNextSocket();
 	
@@ -373,6 +508,19 @@ void deNetworkBasic::UnregisterSocket( debnSocket *bnSocket ){
 	bnSocket->SetIsRegistered( false );
 	bnSocket->SetNextSocket( NULL );
 	bnSocket->SetPreviousSocket( NULL );
+	
+	// drop events received on the socket not processed yet
+	if( pIOThread ){
+		pIOThread->RemoveSocketEvents( bnSocket );
+		
+		debnIOEvent *event = pProcessEvents;
+		while( event ){
+			if( event->GetSocket() == bnSocket ){
+				event->SetSocket( NULL );
+			}
+			event = event->GetNextEvent();
+		}
+	}
 }
 
 
@@ -516,15 +664,7 @@ deBaseNetworkState *deNetworkBasic::CreateState( deNetworkState *state ){
 //////////////////////
 
 debnConnection *deNetworkBasic::pFindConnection( const debnSocket *bnSocket, const debnAddress *address ) const{
-	debnConnection *connection = pHeadConnection;
-	
-	while( connection ){
-		if( connection->Matches( bnSocket, address ) ) return connection;
-		
-		connection = connection->GetNextConnection();
-	}
-	
-	return NULL;
+	return pConnectionMap.Find( bnSocket, *address );
 }
 
 debnServer *deNetworkBasic::pFindServer( const debnSocket *bnSocket ) const{
@@ -545,73 +685,106 @@ void deNetworkBasic::pReceiveDatagrams(){
 	debnSocket *bnSocket = pHeadSocket;
 	
 	while( bnSocket ){
-		while( bnSocket->ReceiveDatagram( pDatagram, pAddressReceive ) ){
-			decBaseFileReaderReference reader;
-			reader.TakeOver( new deNetworkMessageReader( pDatagram ) );
-			
-			const eCommandCodes command = ( eCommandCodes )reader->ReadByte();
-			
-			if( command == eccConnectionRequest ){
-				debnServer * const server = pFindServer( bnSocket );
-				if( server ){
-					server->ProcessConnectionRequest( pAddressReceive, reader );
-					
-				}else{
-					LogError( "Connection request for a non existing socket? how in gods name is this possible?!\n" );
+		// processing datagrams can release the socket. guard it until done
+		bnSocket->AddReference();
+		
+		try{
+			while( true ){
+				const int count = bnSocket->ReceiveDatagrams( pDatagrams,
+					pAddressesReceive, debnSocket::RECEIVE_BATCH_SIZE );
+				
+				int i;
+				for( i=0; i<count; i++ ){
+					pProcessDatagram( bnSocket, pDatagrams[ i ], pAddressesReceive + i );
 				}
-				continue;
 				
-			}
-			
-			debnConnection * const connection = pFindConnection( bnSocket, pAddressReceive );
-			if( connection ){
-				switch( command ){
-				case eccConnectionAck:
-					connection->ProcessConnectionAck( reader );
-					break;
-					
-				case eccConnectionClose:
-					connection->ProcessConnectionClose( reader );
-					break;
-					
-				case eccMessage:
-					connection->ProcessMessage( reader );
-					break;
-					
-				case eccReliableMessage:
-					connection->ProcessReliableMessage( reader );
-					break;
-					
-				case eccReliableLinkState:
-					connection->ProcessReliableLinkState( reader );
-					break;
-					
-				case eccReliableAck:
-					connection->ProcessReliableAck( reader );
+				// stop if the socket is drained or has been released while processing
+				if( count < debnSocket::RECEIVE_BATCH_SIZE || bnSocket->GetRefCount() == 1 ){
 					break;
-					
-				case eccLinkUp:
-					connection->ProcessLinkUp( reader );
-					break;
-					
-				case eccLinkDown:
-					connection->ProcessLinkDown( reader );
-					break;
-					
-				case eccLinkUpdate:
-					connection->ProcessLinkUpdate( reader );
-					break;
-					
-				default:
-					LogWarn( "Invalid command code, rejected!\n" );
 				}
-				
-			}else{
-				LogWarn( "Invalid datagram: Sender does not match any connection!\n" );
 			}
+			
+		}catch( const deException & ){
+			bnSocket->FreeReference();
+			throw;
 		}
 		
-		bnSocket = bnSocket->GetNextSocket();
+		debnSocket * const nextSocket = bnSocket->GetNextSocket();
+		bnSocket->FreeReference();
+		bnSocket = nextSocket;
+	}
+}
+
+void deNetworkBasic::pProcessDatagram( debnSocket *bnSocket, deNetworkMessage *datagram, debnAddress *address ){
+	decBaseFileReaderReference reader;
+	reader.TakeOver( new deNetworkMessageReader( datagram ) );
+	
+	const eCommandCodes command = ( eCommandCodes )reader->ReadByte();
+	
+	if( command == eccConnectionRequest ){
+		debnServer * const server = pFindServer( bnSocket );
+		if( server ){
+			server->ProcessConnectionRequest( address, reader );
+			
+		}else{
+			LogError( "Connection request for a non existing socket? how in gods name is this possible?!\n" );
+		}
+		return;
+	}
+	
+	debnConnection * const connection = pFindConnection( bnSocket, address );
+	if( connection ){
+		switch( command ){
+		case eccConnectionAck:
+			connection->ProcessConnectionAck( reader );
+			break;
+			
+		case eccConnectionClose:
+			connection->ProcessConnectionClose( reader );
+			break;
+			
+		case eccMessage:
+			connection->ProcessMessage( reader );
+			break;
+			
+		case eccReliableMessage:
+			connection->ProcessReliableMessage( reader );
+			break;
+			
+		case eccReliableLinkState:
+			connection->ProcessReliableLinkState( reader );
+			break;
+			
+		case eccReliableAck:
+			connection->ProcessReliableAck( reader );
+			break;
+			
+		case eccLinkUp:
+			connection->ProcessLinkUp( reader );
+			break;
+			
+		case eccLinkDown:
+			connection->ProcessLinkDown( reader );
+			break;
+			
+		case eccLinkUpdate:
+			connection->ProcessLinkUpdate( reader );
+			break;
+			
+		case eccLinkUpdateDelta:
+			connection->ProcessLinkUpdateDelta( reader );
+			break;
+			
+		case eccLinkUpdateAck:
+			connection->ProcessLinkUpdateAck( reader );
+			break;
+			
+		default:
+			LogWarn( "Invalid command code, rejected!\n" );
+		}
+		
+	}else{
+		LogWarn( "Invalid datagram: Sender does not match any connection!\n" );
 	}
 }
 
@@ -624,3 +797,120 @@ void deNetworkBasic::pProcessConnections( float elapsedTime ){
 		connection = connection->GetNextConnection();
 	}
 }
+
+void deNetworkBasic::pFlushSockets(){
+	debnSocket *bnSocket = pHeadSocket;
+	
+	while( bnSocket ){
+		bnSocket->FlushDatagrams();
+		bnSocket = bnSocket->GetNextSocket();
+	}
+}
+
+void deNetworkBasic::pStartIOThread(){
+	if( pIOThread ){
+		return;
+	}
+	
+	pIOThread = new debnIOThread( *this );
+	
+	try{
+		pIOThread->Start();
+		
+	}catch( const deException & ){
+		delete pIOThread;
+		pIOThread = NULL;
+		throw;
+	}
+}
+
+void deNetworkBasic::pStopIOThread( bool processEvents ){
+	if( ! pIOThread ){
+		return;
+	}
+	
+	deMutexGuard guard( pMutex );
+	pIOThread->RequestShutDown();
+	guard.Unlock();
+	
+	pIOThread->WaitForExit();
+	
+	// reliable messages handed over have been acknowledged already. process them
+	// or they are lost. processing has to be done while the thread still exists
+	if( processEvents ){
+		pProcessIOEvents();
+	}
+	
+	delete pIOThread;
+	pIOThread = NULL;
+}
+
+void deNetworkBasic::pProcessIOEvents(){
+	pProcessEvents = pIOThread->TakeEvents();
+	if( ! pProcessEvents ){
+		return;
+	}
+	
+	debnIOEvent *event = pProcessEvents;
+	
+	try{
+		while( event ){
+			// socket is cleared if released while processing events
+			debnSocket * const bnSocket = event->GetSocket();
+			
+			if( bnSocket ){
+				if( event->GetType() == debnIOEvent::eetDatagram ){
+					pProcessDatagram( bnSocket, event->GetMessage(), &event->GetAddress() );
+					
+				}else{
+					debnConnection * const connection = pFindConnection( bnSocket, &event->GetAddress() );
+					
+					if( connection ){
+						if( event->GetType() == debnIOEvent::eetConnectionAck ){
+							connection->ConnectionAckReceived( event->GetNumber() == 1 );
+							
+						}else{
+							decBaseFileReaderReference reader;
+							reader.TakeOver( new deNetworkMessageReader( event->GetMessage() ) );
+							connection->ProcessReliableEvent( event->GetType() == debnIOEvent::eetReliableLinkState
+								? eccReliableLinkState : eccReliableMessage, event->GetNumber(), reader );
+						}
+					}
+				}
+			}
+			
+			event = event->GetNextEvent();
+		}
+		
+	}catch( const deException & ){
+		pIOThread->ReturnEvents( pProcessEvents );
+		pProcessEvents = NULL;
+		throw;
+	}
+	
+	pIOThread->ReturnEvents( pProcessEvents );
+	pProcessEvents = NULL;
+}
+
+void deNetworkBasic::pCmdLoadTest( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	int clientCount = 200;
+	int roundCount = 50;
+	
+	if( pIOThread ){
+		answer.SetFromUTF8( "Load test is not supported while the I/O thread is running." );
+		return;
+	}
+	
+	if( command.GetArgumentCount() > 1 ){
+		clientCount = decMath::clamp( command.GetArgumentAt( 1 )->ToInt(), 1, 900 );
+	}
+	if( command.GetArgumentCount() > 2 ){
+		roundCount = decMath::max( command.GetArgumentAt( 2 )->ToInt(), 1 );
+	}
+	
+	debnLoadTest loadTest( *this );
+	decString text;
+	loadTest.Run( clientCount, roundCount, text );
+	LogInfo( text.GetString() );
+	answer.AppendFromUTF8( text );
+}
@@ -22,15 +22,20 @@
 #ifndef _DENETWORKBASIC_H_
 #define _DENETWORKBASIC_H_
 
+#include "debnConnectionMap.h"
+
 #include <dragengine/common/file/decBaseFileWriterReference.h>
 #include <dragengine/common/string/decStringList.h>
 #include <dragengine/resources/network/deNetworkMessageReference.h>
 #include <dragengine/systems/modules/network/deBaseNetworkModule.h>
+#include <dragengine/threading/deMutex.h>
 
 class debnSocket;
 class debnServer;
 class debnAddress;
 class debnConnection;
+class debnIOThread;
+class debnIOEvent;
 class deNetworkMessage;
 
 
@@ -101,6 +106,45 @@ class deNetworkMessage;
    
    value:
       [ value_index:uint16 ] [ value_data:* ]
+ 
+ Link update delta: (protocol version 2 only)
+   [ 10 ] [ sequence:uint16 ] [ link_count:uint8 ] [ link ]{ 1..link_count }
+   
+   link:
+      [ link_id:uint16 ] [ baseline:uint16 ] [ length:uint16 ] [ bits:uint8 ]{ length }
+   
+   baseline:
+      sequence of the acknowledged update the values are delta encoded against or
+      0xffff for a full update
+   
+   bits: (bit packed starting with the least significant bit)
+      full update:
+         [ step:32 ]{ per non raw value } [ value ]{ per value }
+      
+      delta update:
+         ( [ changed:1 ] [ value ]{ if changed } ){ per value }
+      
+      value:
+         raw values (string, data):
+            [ length:varuint ] [ byte:8 ]{ length }
+         
+         other values:
+            [ delta ]{ per quantized component }
+      
+      delta: (zig-zag encoded difference to baseline component or 0 for full updates)
+         [ 0:1 ] for no difference or
+         [ 1:1 ] [ bitCount-1:6 ] [ bits:bitCount-1 ] with implicit most significant bit
+      
+      step:
+         float32 quantization step. 0 for exact values and half floats (component is
+         the half float bit pattern). quaternions are send as smallest three with the
+         index of the dropped largest component as first component.
+ 
+ Link update ack: (protocol version 2 only)
+   [ 11 ] [ sequence:uint16 ] [ rejected_count:uint8 ] [ link_id:uint16 ]{ 0..rejected_count }
+   
+   rejected links could not be decoded because the baseline is missing. the sender
+   sends a full update next.
 */
 
 /*
@@ -139,6 +183,8 @@ enum eCommandCodes{
 	eccLinkUp,
 	eccLinkDown,
 	eccLinkUpdate,
+	eccLinkUpdateDelta,
+	eccLinkUpdateAck
 };
 
 enum eConnectionAck{
@@ -194,7 +240,8 @@ enum eValueTypes{
 };
 
 enum eProtocols{
-	epDENetworkProtocol // Drag[en]gine Network Protocol: Version 1
+	epDENetworkProtocol, // Drag[en]gine Network Protocol: Version 1
+	epDENetworkProtocolV2 // Drag[en]gine Network Protocol: Version 2 (delta compressed link updates)
 };
 
 
@@ -212,13 +259,20 @@ private:
 	debnServer *pTailServer;
 	debnSocket *pHeadSocket;
 	debnSocket *pTailSocket;
+	debnConnectionMap pConnectionMap;
 	
 	// sending and receiving
-	deNetworkMessage *pDatagram;
-	debnAddress *pAddressReceive;
+	deNetworkMessage **pDatagrams;
+	debnAddress *pAddressesReceive;
 	deNetworkMessageReference pSharedSendDatagram;
 	decBaseFileWriterReference pSharedSendDatagramWriter;
 	
+	// optional I/O thread
+	deMutex pMutex;
+	debnIOThread *pIOThread;
+	debnIOEvent *pProcessEvents;
+	bool pUseIOThread;
+	
 	//debnMessageQueue *pMessagesSend;
 	//debnMessageQueue *pMessagesReceive;
 	
@@ -246,6 +300,31 @@ public:
 	virtual void CleanUp();
 	/** Process network. */
 	virtual void ProcessNetwork();
+	
+	/** \brief Send command. */
+	virtual void SendCommand( const decUnicodeArgumentList &command, decUnicodeString &answer );
+	/*@}*/
+	
+	/** \name Parameters */
+	/*@{*/
+	/** \brief Number of parameters. */
+	virtual int GetParameterCount() const;
+	
+	/**
+	 * \brief Get information about parameter.
+	 * \param[in] index Index of the parameter
+	 * \param[in] parameter Object to fill with information about the parameter
+	 */
+	virtual void GetParameterInfo( int index, deModuleParameter &parameter ) const;
+	
+	/** \brief Index of named parameter or -1 if not found. */
+	virtual int IndexOfParameterNamed( const char *name ) const;
+	
+	/** \brief Value of named parameter. */
+	virtual decString GetParameterValue( const char *name ) const;
+	
+	/** \brief Set value of named parameter. */
+	virtual void SetParameterValue( const char *name, const char *value );
 	/*@}*/
 	
 	/** @name Management */
@@ -253,6 +332,27 @@ public:
 	inline deNetworkMessage *GetSharedSendDatagram() const{ return pSharedSendDatagram; }
 	inline decBaseFileWriter &GetSharedSendDatagramWriter() const{ return pSharedSendDatagramWriter; }
 	
+	/**
+	 * \brief Module mutex.
+	 * 
+	 * Guards sockets, connections and reliable message processing against the I/O thread.
+	 * Never hold the mutex while calling into scripting modules.
+	 */
+	inline deMutex &GetMutex(){ return pMutex; }
+	
+	/** \brief I/O thread or NULL if not running. */
+	inline debnIOThread *GetIOThread() const{ return pIOThread; }
+	
+	/** \brief First registered connection. */
+	inline debnConnection *GetHeadConnection() const{ return pHeadConnection; }
+	
+	/** \brief First registered socket. */
+	inline debnSocket *GetHeadSocket() const{ return pHeadSocket; }
+	
+	/** \brief Connections by socket and remote address. */
+	inline debnConnectionMap &GetConnectionMap(){ return pConnectionMap; }
+	inline const debnConnectionMap &GetConnectionMap() const{ return pConnectionMap; }
+	
 	/** Register a connection. */
 	void RegisterConnection( debnConnection *connection );
 	/** Unregister a connection if existing. */
@@ -284,7 +384,13 @@ private:
 	debnServer *pFindServer( const debnSocket *bnSocket ) const;
 	
 	void pReceiveDatagrams();
+	void pProcessDatagram( debnSocket *bnSocket, deNetworkMessage *datagram, debnAddress *address );
 	void pProcessConnections( float elapsedTime );
+	void pFlushSockets();
+	void pStartIOThread();
+	void pStopIOThread( bool processEvents );
+	void pProcessIOEvents();
+	void pCmdLoadTest( const decUnicodeArgumentList &command, decUnicodeString &answer );
 };
 
 // end of include only once
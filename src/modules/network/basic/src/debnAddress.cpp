@@ -241,6 +241,15 @@ decString debnAddress::ToString() const{
 	return string;
 }
 
+unsigned int debnAddress::Hash() const{
+	unsigned int hash = ( unsigned int )pType * 31u + ( unsigned int )pPort;
+	int i;
+	for( i=0; i<pValueCount; i++ ){
+		hash = hash * 31u + pValues[ i ];
+	}
+	return hash;
+}
+
 
 
 // Operators
@@ -143,6 +143,9 @@ public:
 	
 	/** \brief Address in string form. */
 	decString ToString() const;
+	
+	/** \brief Hash code for use in hash tables. Equal addresses have equal hash codes. */
+	unsigned int Hash() const;
 	/*@}*/
 	
 	
@@ -27,6 +27,10 @@
 #include "debnAddress.h"
 #include "debnConnection.h"
 #include "deNetworkBasic.h"
+#include "io/debnIOThread.h"
+#include "delta/debnBitReader.h"
+#include "delta/debnBitWriter.h"
+#include "delta/debnDeltaSnapshots.h"
 #include "states/debnState.h"
 #include "states/debnStateLink.h"
 #include "states/debnStateLinkList.h"
@@ -51,6 +55,15 @@
 #include <dragengine/resources/network/deNetworkMessageReader.h>
 #include <dragengine/resources/network/deNetworkMessageWriter.h>
 #include <dragengine/systems/modules/scripting/deBaseScriptingConnection.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Definitions
+////////////////
+
+// delta link updates are packed into datagrams up to this size to stay below common MTUs
+#define DELTA_DATAGRAM_SIZE 1200
 
 
 
@@ -71,9 +84,15 @@ debnConnection::debnConnection( deNetworkBasic *netBasic, deConnection *connecti
 	pConnectionState = ecsDisconnected;
 	pIdentifier = -1;
 	
+	pProtocol = epDENetworkProtocol;
 	pStateLinks = NULL;
 	pModifiedStateLinks = NULL;
 	
+	pDeltaWriter = NULL;
+	pDeltaBuffer = NULL;
+	pDeltaBufferSize = 0;
+	pDeltaSequence = 0;
+	
 	pReliableMessagesSend = NULL;
 	pReliableMessagesRecv = NULL;
 	pReliableNumberSend = 0;
@@ -84,10 +103,14 @@ debnConnection::debnConnection( deNetworkBasic *netBasic, deConnection *connecti
 	pNextConnection = NULL;
 	pIsRegistered = false;
 	
+	pNextMapped = NULL;
+	pIsMapped = false;
+	
 	try{
 		pRemoteAddress = new debnAddress;
 		pStateLinks = new debnStateLinkManager;
 		pModifiedStateLinks = new debnStateLinkList;
+		pDeltaWriter = new debnBitWriter;
 		pReliableMessagesSend = new debnMessageManager;
 		pReliableMessagesRecv = new debnMessageManager;
 		
@@ -117,11 +140,28 @@ void debnConnection::SetIdentifier( int identifier ){
 
 void debnConnection::Process( float elapsedTime ){
 	if( pConnectionState == ecsConnected ){
-		pUpdateTimeouts( elapsedTime );
+		if( pNetBasic->GetIOThread() ){
+			// timeouts are handled by the I/O thread. sending pending reliables here
+			// still sends all reliables added during the frame in one batch
+			const deMutexGuard guard( pNetBasic->GetMutex() );
+			pSendPendingReliables();
+			
+		}else{
+			pUpdateTimeouts( elapsedTime );
+			pSendPendingReliables();
+		}
+		
 		pUpdateStates();
 	}
 }
 
+void debnConnection::ProcessReliables( float elapsedTime ){
+	if( pConnectionState == ecsConnected ){
+		pUpdateTimeouts( elapsedTime );
+		pSendPendingReliables();
+	}
+}
+
 void debnConnection::InvalidateState( debnState *state ){
 	debnStateLink *stateLink, *nextLink;
 	
@@ -156,37 +196,56 @@ void debnConnection::AcceptConnection( debnSocket *bnSocket, debnAddress *addres
 	*pRemoteAddress = *address;
 	pConnection->SetRemoteAddress( address->ToString() );
 	
+	const deMutexGuard guard( pNetBasic->GetMutex() );
+	pNetBasic->GetConnectionMap().Add( this );
+	
 	pConnectionState = ecsConnected;
 	pProtocol = protocol;
 }
 
 void debnConnection::ProcessConnectionAck( decBaseFileReader &reader ){
-	deBaseScriptingConnection *scrCon = pConnection->GetPeerScripting();
+	if( pConnectionState != ecsConnecting ){
+		pNetBasic->LogInfo( "Invalid connection ack received." );
+		return;
+	}
+	
+	const eConnectionAck code = ( eConnectionAck )reader.ReadByte();
 	
-	if( pConnectionState == ecsConnecting ){
-		const eConnectionAck code = ( eConnectionAck )reader.ReadByte();
+	if( code == ecaAccepted ){
+// 		pNetBasic->LogInfoFormat( "Connection accepted." );
 		
-		if( code == ecaAccepted ){
-// 			pNetBasic->LogInfoFormat( "Connection accepted." );
-			
-			pProtocol = ( eProtocols )reader.ReadUShort();
-			
-			pConnectionState = ecsConnected;
-			pConnection->SetConnected( true );
-			
-		}else{
-// 			pNetBasic->LogInfo( "Connection rejected." );
-			
-			pConnectionState = ecsDisconnected;
-			pConnection->SetConnected( false );
-			
-			if( scrCon ){
-				scrCon->ConnectionClosed();
-			}
-		}
+		pProtocol = ( eProtocols )reader.ReadUShort();
+		pConnectionState = ecsConnected;
 		
 	}else{
-		pNetBasic->LogInfo( "Invalid connection ack received." );
+// 		pNetBasic->LogInfo( "Connection rejected." );
+		
+		pConnectionState = ecsDisconnected;
+	}
+	
+	// the I/O thread changes the state right away so reliables arriving next are
+	// accepted but the connection resource and scripting are updated by the main thread
+	debnIOThread * const ioThread = pNetBasic->GetIOThread();
+	if( ioThread ){
+		ioThread->QueueEvent( debnIOEvent::eetConnectionAck, pSocket, *pRemoteAddress,
+			code == ecaAccepted ? 1 : 0, NULL, 0 );
+		
+	}else{
+		ConnectionAckReceived( code == ecaAccepted );
+	}
+}
+
+void debnConnection::ConnectionAckReceived( bool accepted ){
+	if( accepted ){
+		pConnection->SetConnected( true );
+		
+	}else{
+		pConnection->SetConnected( false );
+		
+		deBaseScriptingConnection * const scrCon = pConnection->GetPeerScripting();
+		if( scrCon ){
+			scrCon->ConnectionClosed();
+		}
 	}
 }
 
@@ -254,14 +313,7 @@ void debnConnection::ProcessReliableMessage( decBaseFileReader &reader ){
 	
 	// send ack
 // 	pNetBasic->LogInfoFormat( "ProcessReliableMessage: send ack for %i", number );
-	decBaseFileWriter &sendWriter = pNetBasic->GetSharedSendDatagramWriter();
-	sendWriter.SetPosition( 0 );
-	pNetBasic->GetSharedSendDatagram()->Clear();
-	sendWriter.WriteByte( ( uint8_t )eccReliableAck );
-	sendWriter.WriteUShort( ( uint16_t )number );
-	sendWriter.WriteByte( ( uint8_t )eraSuccess );
-	
-	pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+	pSendReliableAck( number, eraSuccess );
 	
 	// prepare
 	//length = reader.GetDataLength() - reader.GetPosition();
@@ -270,7 +322,7 @@ void debnConnection::ProcessReliableMessage( decBaseFileReader &reader ){
 	// if the number is the next one expected send directly to the script
 	if( number == pReliableNumberRecv ){
 		// process message
-		pProcessReliableMessage( number, reader );
+		pDeliverReliable( eccReliableMessage, number, reader );
 		
 		// bump up the number
 		pReliableNumberRecv = ( pReliableNumberRecv + 1 ) % 65535;
@@ -309,14 +361,7 @@ void debnConnection::ProcessReliableLinkState( decBaseFileReader &reader ){
 	
 	// send ack
 // 	pNetBasic->LogInfoFormat( "ProcessReliableLinkState: send ack for %i", number );
-	decBaseFileWriter &sendWriter = pNetBasic->GetSharedSendDatagramWriter();
-	sendWriter.SetPosition( 0 );
-	pNetBasic->GetSharedSendDatagram()->Clear();
-	sendWriter.WriteByte( ( uint8_t )eccReliableAck );
-	sendWriter.WriteUShort( ( uint16_t )number );
-	sendWriter.WriteByte( ( uint8_t )eraSuccess );
-	
-	pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+	pSendReliableAck( number, eraSuccess );
 	
 	// prepare
 	//length = reader.GetDataLength() - reader.GetPosition();
@@ -324,7 +369,7 @@ void debnConnection::ProcessReliableLinkState( decBaseFileReader &reader ){
 	// if the number is the next one expected send directly to the script
 	if( number == pReliableNumberRecv ){
 		// process the link
-		pProcessLinkState( number, reader );
+		pDeliverReliable( eccReliableLinkState, number, reader );
 		
 		// bump up the number
 		pReliableNumberRecv = ( pReliableNumberRecv + 1 ) % 65535;
@@ -372,7 +417,16 @@ void debnConnection::ProcessReliableAck( decBaseFileReader &reader ){
 		bnMessage->SetSecondsSinceSend( 0.0f );
 		
 		// resend message
-		pSocket->SendDatagram( bnMessage->GetMessage(), pRemoteAddress );
+		pSocket->QueueDatagram( bnMessage->GetMessage(), pRemoteAddress );
+	}
+}
+
+void debnConnection::ProcessReliableEvent( int type, int number, decBaseFileReader &reader ){
+	if( type == eccReliableLinkState ){
+		pProcessLinkState( number, reader );
+		
+	}else{
+		pProcessReliableMessage( number, reader );
 	}
 }
 
@@ -453,6 +507,103 @@ void debnConnection::ProcessLinkUpdate( decBaseFileReader &reader ){
 	}
 }
 
+void debnConnection::ProcessLinkUpdateDelta( decBaseFileReader &reader ){
+	if( pConnectionState != ecsConnected ){
+		pNetBasic->LogInfo( "Link update delta: not connected." );
+		return;
+	}
+	
+	int sequence, rejected[ 255 ], rejectedCount = 0;
+	
+	try{
+		sequence = reader.ReadUShort();
+		
+		const int count = reader.ReadByte();
+		int i;
+		for( i=0; i<count; i++ ){
+			const int identifier = reader.ReadUShort();
+			const int baseline = reader.ReadUShort();
+			const int length = reader.ReadUShort();
+			
+			debnStateLink * const stateLink = pStateLinks->GetLinkWithIdentifier( identifier );
+			if( ! stateLink || stateLink->GetLinkState() != debnStateLink::elsUp || ! stateLink->GetState() ){
+				reader.MovePosition( length );
+				rejected[ rejectedCount++ ] = identifier;
+				continue;
+			}
+			
+			if( length > pDeltaBufferSize ){
+				uint8_t * const newBuffer = new uint8_t[ length ];
+				if( pDeltaBuffer ){
+					delete [] pDeltaBuffer;
+				}
+				pDeltaBuffer = newBuffer;
+				pDeltaBufferSize = length;
+			}
+			reader.Read( pDeltaBuffer, length );
+			
+			debnBitReader bitReader( pDeltaBuffer, length );
+			if( ! stateLink->GetState()->LinkReadDelta( bitReader, *stateLink,
+			sequence, baseline == 0xffff ? -1 : baseline ) ){
+				rejected[ rejectedCount++ ] = identifier;
+			}
+		}
+		
+	}catch( const deException & ){
+		pNetBasic->LogInfo( "Invalid data in the link update delta message!" );
+		return;
+	}
+	
+	// acknowledge the update. the sender uses the received snapshots as baseline
+	decBaseFileWriter &sendWriter = pNetBasic->GetSharedSendDatagramWriter();
+	sendWriter.SetPosition( 0 );
+	pNetBasic->GetSharedSendDatagram()->Clear();
+	sendWriter.WriteByte( ( uint8_t )eccLinkUpdateAck );
+	sendWriter.WriteUShort( ( uint16_t )sequence );
+	sendWriter.WriteByte( ( uint8_t )rejectedCount );
+	
+	int i;
+	for( i=0; i<rejectedCount; i++ ){
+		sendWriter.WriteUShort( ( uint16_t )rejected[ i ] );
+	}
+	
+	pSocket->QueueDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+}
+
+void debnConnection::ProcessLinkUpdateAck( decBaseFileReader &reader ){
+	if( pConnectionState != ecsConnected ){
+		pNetBasic->LogInfo( "Link update ack: not connected." );
+		return;
+	}
+	
+	try{
+		const int sequence = reader.ReadUShort();
+		
+		// links not modified have no changes pending an acknowledge
+		const int linkCount = pModifiedStateLinks->GetLinkCount();
+		int i;
+		for( i=0; i<linkCount; i++ ){
+			debnStateLink &stateLink = *pModifiedStateLinks->GetLinkAt( i );
+			if( stateLink.GetComponentCount() > 0 ){
+				stateLink.GetSendSnapshots().AcknowledgeSequence( sequence );
+			}
+		}
+		
+		// rejected links send a full update next
+		const int rejectedCount = reader.ReadByte();
+		for( i=0; i<rejectedCount; i++ ){
+			debnStateLink * const stateLink = pStateLinks->GetLinkWithIdentifier( reader.ReadUShort() );
+			if( stateLink && stateLink->GetComponentCount() > 0 ){
+				stateLink->GetSendSnapshots().Clear();
+				stateLink->SetChanged( true );
+			}
+		}
+		
+	}catch( const deException & ){
+		pNetBasic->LogInfo( "Invalid data in the link update ack message!" );
+	}
+}
+
 
 
 bool debnConnection::ConnectTo( const char *address ){
@@ -475,16 +626,21 @@ bool debnConnection::ConnectTo( const char *address ){
 	pNetBasic->GetSharedSendDatagram()->Clear();
 	sendWriter.WriteByte( eccConnectionRequest );
 	
-	sendWriter.WriteUShort( 1 );
+	sendWriter.WriteUShort( 2 );
 	sendWriter.WriteUShort( epDENetworkProtocol );
+	sendWriter.WriteUShort( epDENetworkProtocolV2 );
 	
 	pRemoteAddress->SetIPv4FromString( address );
 	pConnection->SetRemoteAddress( address );
 	
-	pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
-	
-	// switch to connecting state
+	// switch to connecting state before sending. the I/O thread can process the ack
+	// as soon as the request is send
+	deMutexGuard guard( pNetBasic->GetMutex() );
+	pNetBasic->GetConnectionMap().Add( this );
 	pConnectionState = ecsConnecting;
+	guard.Unlock();
+	
+	pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
 	
 	// finished
 	return true;
@@ -501,7 +657,8 @@ void debnConnection::Disconnect(){
 			pNetBasic->GetSharedSendDatagram()->Clear();
 			sendWriter.WriteByte( eccConnectionClose );
 			
-			pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+			// queued to keep the order with reliable messages still in the send queue
+			pSocket->QueueDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
 		}
 		
 		// clean up
@@ -532,6 +689,9 @@ void debnConnection::SendReliableMessage( deNetworkMessage *message ){
 	// only if connected
 	if( pConnectionState != ecsConnected ) return;
 	
+	// the I/O thread removes acknowledged messages advancing the send number
+	const deMutexGuard guard( pNetBasic->GetMutex() );
+	
 	// add message
 	try{
 		// create message
@@ -555,15 +715,8 @@ void debnConnection::SendReliableMessage( deNetworkMessage *message ){
 		throw;
 	}
 	
-	// if the message fits into the window send it right now
-	if( pReliableMessagesSend->GetMessageCount() <= pReliableWindowSize ){
-		// send
-		pSocket->SendDatagram( bnMessage->GetMessage(), pRemoteAddress );
-		
-		// mark the message send
-		bnMessage->SetState( debnMessage::emsSend );
-		bnMessage->SetSecondsSinceSend( 0.0f );
-	}
+	// the message is send during the next Process call if it fits into the window.
+	// this coalesces all reliables added during a frame into one batched send
 }
 
 void debnConnection::LinkState( deNetworkMessage *message, deNetworkState *state, bool readOnly ){
@@ -604,7 +757,9 @@ void debnConnection::LinkState( deNetworkMessage *message, deNetworkState *state
 	
 	//pNetBasic->LogInfoFormat( "Linking state %p using link %i", state, stateLink->GetIdentifier() );
 	
-	// add message
+	// add message. the I/O thread removes acknowledged messages advancing the send number
+	deMutexGuard guard( pNetBasic->GetMutex() );
+	
 	try{
 		// create message
 		bnMessage = new debnMessage;
@@ -633,15 +788,9 @@ void debnConnection::LinkState( deNetworkMessage *message, deNetworkState *state
 		throw;
 	}
 	
-	// if the message fits into the window send it right now
-	if( pReliableMessagesSend->GetMessageCount() <= pReliableWindowSize ){
-		// send
-		pSocket->SendDatagram( bnMessage->GetMessage(), pRemoteAddress );
-		
-		// mark the message send
-		bnMessage->SetState( debnMessage::emsSend );
-		bnMessage->SetSecondsSinceSend( 0.0f );
-	}
+	guard.Unlock();
+	
+	// the message is send during the next Process call if it fits into the window
 	
 	// switch the link to the listening state
 	stateLink->SetLinkState( debnStateLink::elsListening );
@@ -664,15 +813,31 @@ void debnConnection::SetIsRegistered( bool isRegistered ){
 	pIsRegistered = isRegistered;
 }
 
+void debnConnection::SetNextMapped( debnConnection *connection ){
+	pNextMapped = connection;
+}
+
+void debnConnection::SetIsMapped( bool isMapped ){
+	pIsMapped = isMapped;
+}
+
 
 
 // Private Functions
 //////////////////////
 
 void debnConnection::pCleanUp(){
-	if( pNetBasic ) pNetBasic->UnregisterConnection( this );
+	if( pNetBasic ){
+		deMutexGuard guard( pNetBasic->GetMutex() );
+		pNetBasic->GetConnectionMap().Remove( this );
+		guard.Unlock();
+		
+		pNetBasic->UnregisterConnection( this );
+	}
 	
 	if( pStateLinks ) delete pStateLinks;
+	if( pDeltaWriter ) delete pDeltaWriter;
+	if( pDeltaBuffer ) delete [] pDeltaBuffer;
 	if( pSocket ) pSocket->FreeReference();
 	if( pRemoteAddress ) delete pRemoteAddress;
 	
@@ -695,15 +860,22 @@ void debnConnection::pDisconnect(){
 	}
 	pStateLinks->RemoveAllLinks();
 	
-	// clean up reliables
+	// clean up reliables. the socket is released after unlocking since
+	// unregistering the socket locks the module mutex too
+	deMutexGuard guard( pNetBasic->GetMutex() );
 	pReliableMessagesRecv->RemoveAllMessages();
 	pReliableMessagesSend->RemoveAllMessages();
 	
 	// free the socket
 	pConnectionState = ecsDisconnected;
-	if( pSocket ){
-		pSocket->FreeReference();
-		pSocket = NULL;
+	pNetBasic->GetConnectionMap().Remove( this );
+	
+	debnSocket * const bnSocket = pSocket;
+	pSocket = NULL;
+	guard.Unlock();
+	
+	if( bnSocket ){
+		bnSocket->FreeReference();
 	}
 	
 	// switch to disconnected state
@@ -712,6 +884,11 @@ void debnConnection::pDisconnect(){
 }
 
 void debnConnection::pUpdateStates(){
+	if( pProtocol == epDENetworkProtocolV2 ){
+		pUpdateStatesDelta();
+		return;
+	}
+	
 	int linkCount = pModifiedStateLinks->GetLinkCount();
 	if( linkCount == 0 ){
 		return;
@@ -759,7 +936,80 @@ void debnConnection::pUpdateStates(){
 		}
 	}
 	
-	pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+	pSocket->QueueDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+}
+
+void debnConnection::pUpdateStatesDelta(){
+	int linkCount = pModifiedStateLinks->GetLinkCount();
+	if( linkCount == 0 ){
+		return;
+	}
+	
+	decBaseFileWriter &sendWriter = pNetBasic->GetSharedSendDatagramWriter();
+	int i, datagramLinkCount = 0;
+	
+	for( i=0; i<linkCount; i++ ){
+		debnStateLink &stateLink = *pModifiedStateLinks->GetLinkAt( i );
+		if( stateLink.GetLinkState() != debnStateLink::elsUp || ! stateLink.GetChanged() ){
+			continue;
+		}
+		
+		pDeltaWriter->Reset();
+		
+		if( ! stateLink.GetState() || ! stateLink.GetState()->LinkWriteDelta( *pDeltaWriter, stateLink ) ){
+			// remote side acknowledged the current values
+			stateLink.ResetChanged();
+			pModifiedStateLinks->RemoveLink( &stateLink );
+			linkCount--;
+			i--;
+			continue;
+		}
+		
+		pDeltaWriter->Flush();
+		const int length = pDeltaWriter->GetLength();
+		
+		if( datagramLinkCount > 0 && ( datagramLinkCount == 255
+		|| sendWriter.GetPosition() + 6 + length > DELTA_DATAGRAM_SIZE ) ){
+			pSendLinkUpdateDelta( datagramLinkCount );
+			datagramLinkCount = 0;
+		}
+		
+		if( datagramLinkCount == 0 ){
+			sendWriter.SetPosition( 0 );
+			pNetBasic->GetSharedSendDatagram()->Clear();
+			sendWriter.WriteByte( ( uint8_t )eccLinkUpdateDelta );
+			sendWriter.WriteUShort( ( uint16_t )pDeltaSequence );
+			sendWriter.WriteByte( 0 ); // link count, updated before sending
+		}
+		
+		const debnDeltaSnapshots &snapshots = stateLink.GetSendSnapshots();
+		sendWriter.WriteUShort( ( uint16_t )stateLink.GetIdentifier() );
+		sendWriter.WriteUShort( snapshots.GetBaseline() != -1
+			? ( uint16_t )snapshots.GetBaselineSequence() : ( uint16_t )0xffff );
+		sendWriter.WriteUShort( ( uint16_t )length );
+		sendWriter.Write( pDeltaWriter->GetData(), length );
+		
+		stateLink.StoreSendSnapshot( pDeltaSequence );
+		datagramLinkCount++;
+		
+		// the link stays modified and is send again each update until the remote side
+		// acknowledged it. lost updates are covered this way without reliable resending
+	}
+	
+	if( datagramLinkCount > 0 ){
+		pSendLinkUpdateDelta( datagramLinkCount );
+	}
+}
+
+void debnConnection::pSendLinkUpdateDelta( int linkCount ){
+	decBaseFileWriter &sendWriter = pNetBasic->GetSharedSendDatagramWriter();
+	sendWriter.SetPosition( 3 );
+	sendWriter.WriteByte( ( uint8_t )linkCount );
+	
+	pSocket->QueueDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+	
+	// 0xffff marks full updates and is skipped
+	pDeltaSequence = ( pDeltaSequence + 1 ) % 0xffff;
 }
 
 void debnConnection::pUpdateTimeouts( float elapsedTime ){
@@ -780,7 +1030,7 @@ void debnConnection::pUpdateTimeouts( float elapsedTime ){
 			if( bnMessage->GetSecondsSinceSend() > timeout ){
 				// send the message
 				pNetBasic->LogInfoFormat( "pUpdateTimeouts: resend message %i", bnMessage->GetNumber() );
-				pSocket->SendDatagram( bnMessage->GetMessage(), pRemoteAddress );
+				pSocket->QueueDatagram( bnMessage->GetMessage(), pRemoteAddress );
 				
 				// reset the timeout
 				bnMessage->SetSecondsSinceSend( 0.0f );
@@ -802,15 +1052,10 @@ void debnConnection::pProcessQueuedMessages(){
 		
 		// process the message
 		type = bnMessage->GetType();
-		if( type == eccReliableMessage ){
+		if( type == eccReliableMessage || type == eccReliableLinkState ){
 			decBaseFileReaderReference reader;
 			reader.TakeOver( new deNetworkMessageReader( bnMessage->GetMessage() ) );
-			pProcessReliableMessage( pReliableNumberRecv, reader );
-			
-		}else if( type == eccReliableLinkState ){
-			decBaseFileReaderReference reader;
-			reader.TakeOver( new deNetworkMessageReader( bnMessage->GetMessage() ) );
-			pProcessLinkState( pReliableNumberRecv, reader );
+			pDeliverReliable( type, pReliableNumberRecv, reader );
 		}
 		
 		// remove the message from the queue
@@ -918,7 +1163,7 @@ void debnConnection::pProcessLinkState( int number, decBaseFileReader &reader ){
 	sendWriter.WriteByte( ( uint8_t )code );
 	sendWriter.WriteUShort( ( uint16_t )identifier );
 	
-	pSocket->SendDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
+	pSocket->QueueDatagram( pNetBasic->GetSharedSendDatagram(), pRemoteAddress );
 }
 
 void debnConnection::pAddReliableReceive( int type, int number, decBaseFileReader &reader ){
@@ -947,6 +1192,29 @@ void debnConnection::pAddReliableReceive( int type, int number, decBaseFileReade
 	}
 }
 
+void debnConnection::pDeliverReliable( int type, int number, decBaseFileReader &reader ){
+	// scripting modules can only be called by the main thread
+	debnIOThread * const ioThread = pNetBasic->GetIOThread();
+	if( ioThread ){
+		ioThread->QueueEvent( type == eccReliableLinkState ? debnIOEvent::eetReliableLinkState
+			: debnIOEvent::eetReliableMessage, pSocket, *pRemoteAddress, number, reader );
+		
+	}else{
+		ProcessReliableEvent( type, number, reader );
+	}
+}
+
+void debnConnection::pSendReliableAck( int number, eReliableAck code ){
+	// the shared send datagram is not used since this can be called by the I/O thread
+	uint8_t ack[ 4 ];
+	ack[ 0 ] = ( uint8_t )eccReliableAck;
+	ack[ 1 ] = ( uint8_t )number;
+	ack[ 2 ] = ( uint8_t )( number >> 8 );
+	ack[ 3 ] = ( uint8_t )code;
+	
+	pSocket->QueueDatagram( ack, 4, pRemoteAddress );
+}
+
 void debnConnection::pRemoveSendReliablesDone(){
 	bool removedSome = false;
 	
@@ -985,7 +1253,7 @@ void debnConnection::pSendPendingReliables(){
 		bnMessage = pReliableMessagesSend->GetMessageAt( i );
 		if( bnMessage->GetState() == debnMessage::emsPending ){
 			// send
-			pSocket->SendDatagram( bnMessage->GetMessage(), pRemoteAddress );
+			pSocket->QueueDatagram( bnMessage->GetMessage(), pRemoteAddress );
 			
 			// mark the message send
 			bnMessage->SetState( debnMessage::emsSend );
@@ -22,6 +22,8 @@
 #ifndef _DEBNCONNECTION_H_
 #define _DEBNCONNECTION_H_
 
+#include <stdint.h>
+
 #include "deNetworkBasic.h"
 
 #include <dragengine/systems/modules/network/deBaseNetworkConnection.h>
@@ -35,6 +37,7 @@ class debnState;
 class debnStateLinkManager;
 class debnStateLinkList;
 class debnMessageAckList;
+class debnBitWriter;
 class deNetworkMessage;
 class decBaseFileReader;
 
@@ -72,6 +75,12 @@ private:
 	debnStateLinkManager *pStateLinks;
 	debnStateLinkList *pModifiedStateLinks;
 	
+	// delta compressed link updates
+	debnBitWriter *pDeltaWriter;
+	uint8_t *pDeltaBuffer;
+	int pDeltaBufferSize;
+	int pDeltaSequence;
+	
 	// reliable messages
 	debnMessageManager *pReliableMessagesSend;
 	debnMessageManager *pReliableMessagesRecv;
@@ -83,6 +92,9 @@ private:
 	debnConnection *pNextConnection;
 	bool pIsRegistered;
 	
+	debnConnection *pNextMapped;
+	bool pIsMapped;
+	
 	
 	
 public:
@@ -105,6 +117,9 @@ public:
 	/** \brief Socket. */
 	inline debnSocket *GetSocket() const{ return pSocket; }
 	
+	/** \brief Remote address. */
+	inline const debnAddress &GetRemoteAddress() const{ return *pRemoteAddress; }
+	
 	/** \brief Connection identifier. */
 	inline int GetIdentifier() const{ return pIdentifier; }
 	
@@ -122,6 +137,13 @@ public:
 	/** \brief Process connection. */
 	void Process( float elapsedTime );
 	
+	/**
+	 * \brief Resend timed out reliables and send pending reliables.
+	 * 
+	 * Called by the I/O thread with the module mutex held.
+	 */
+	void ProcessReliables( float elapsedTime );
+	
 	/** \brief Invalidate network state. */
 	void InvalidateState( debnState *state );
 	
@@ -134,6 +156,9 @@ public:
 	/** \brief Process connection ack message. */
 	void ProcessConnectionAck( decBaseFileReader &reader );
 	
+	/** \brief Connection ack has been processed. */
+	void ConnectionAckReceived( bool accepted );
+	
 	/** \brief Process connection close message. */
 	void ProcessConnectionClose( decBaseFileReader &reader );
 	
@@ -149,6 +174,14 @@ public:
 	/** \brief Process reliable ack. */
 	void ProcessReliableAck( decBaseFileReader &reader );
 	
+	/**
+	 * \brief Process reliable message or link state received in order.
+	 * \param[in] type eccReliableMessage or eccReliableLinkState.
+	 * \param[in] number Reliable number.
+	 * \param[in] reader Reader positioned after the reliable number.
+	 */
+	void ProcessReliableEvent( int type, int number, decBaseFileReader &reader );
+	
 	/** \brief Process link up. */
 	void ProcessLinkUp( decBaseFileReader &reader );
 	
@@ -158,6 +191,12 @@ public:
 	/** \brief Process link update. */
 	void ProcessLinkUpdate( decBaseFileReader &reader );
 	
+	/** \brief Process delta compressed link update. */
+	void ProcessLinkUpdateDelta( decBaseFileReader &reader );
+	
+	/** \brief Process delta compressed link update ack. */
+	void ProcessLinkUpdateAck( decBaseFileReader &reader );
+	
 	/** \brief Connect to connection object on host. */
 	virtual bool ConnectTo( const char *address );
 	
@@ -195,6 +234,18 @@ public:
 	
 	/** \brief Set if connection is registered. */
 	void SetIsRegistered( bool isRegistered );
+	
+	/** \brief Next connection in the same connection map bucket. */
+	inline debnConnection *GetNextMapped() const{ return pNextMapped; }
+	
+	/** \brief Set next connection in the same connection map bucket. */
+	void SetNextMapped( debnConnection *connection );
+	
+	/** \brief Connection is mapped. */
+	inline bool GetIsMapped() const{ return pIsMapped; }
+	
+	/** \brief Set if connection is mapped. */
+	void SetIsMapped( bool isMapped );
 	/*@}*/
 	
 	
@@ -203,11 +254,15 @@ private:
 	void pCleanUp();
 	void pDisconnect();
 	void pUpdateStates();
+	void pUpdateStatesDelta();
+	void pSendLinkUpdateDelta( int linkCount );
 	void pUpdateTimeouts( float elapsedTime );
 	void pProcessQueuedMessages();
 	void pProcessReliableMessage( int number, decBaseFileReader &reader );
 	void pProcessLinkState( int number, decBaseFileReader &reader );
 	void pAddReliableReceive( int type, int number, decBaseFileReader &reader );
+	void pDeliverReliable( int type, int number, decBaseFileReader &reader );
+	void pSendReliableAck( int number, eReliableAck code );
 	void pRemoveSendReliablesDone();
 	void pSendPendingReliables();
 };
@@ -0,0 +1,178 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "debnAddress.h"
+#include "debnConnection.h"
+#include "debnConnectionMap.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Definitions
+////////////////
+
+#define INITIAL_BUCKET_COUNT 64
+
+
+
+// Class debnConnectionMap
+////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debnConnectionMap::debnConnectionMap() :
+pBuckets( NULL ),
+pBucketCount( 0 ),
+pCount( 0 ){
+}
+
+debnConnectionMap::~debnConnectionMap(){
+	if( pBuckets ){
+		delete [] pBuckets;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void debnConnectionMap::Add( debnConnection *connection ){
+	if( ! connection || connection->GetIsMapped() || ! connection->GetSocket() ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	if( pCount >= pBucketCount ){
+		pGrow();
+	}
+	
+	pAppend( connection );
+	connection->SetIsMapped( true );
+	pCount++;
+}
+
+void debnConnectionMap::Remove( debnConnection *connection ){
+	if( ! connection || ! connection->GetIsMapped() ){
+		return;
+	}
+	
+	debnConnection ** const bucket = pBuckets + pBucketIndex(
+		connection->GetSocket(), connection->GetRemoteAddress() );
+	debnConnection *previous = NULL;
+	debnConnection *current = *bucket;
+	
+	while( current ){
+		if( current == connection ){
+			if( previous ){
+				previous->SetNextMapped( connection->GetNextMapped() );
+				
+			}else{
+				*bucket = connection->GetNextMapped();
+			}
+			
+			connection->SetNextMapped( NULL );
+			connection->SetIsMapped( false );
+			pCount--;
+			return;
+		}
+		
+		previous = current;
+		current = current->GetNextMapped();
+	}
+	
+	DETHROW( deeInvalidParam ); // socket or address changed while mapped
+}
+
+debnConnection *debnConnectionMap::Find( const debnSocket *bnSocket, const debnAddress &address ) const{
+	if( pCount == 0 ){
+		return NULL;
+	}
+	
+	debnConnection *connection = pBuckets[ pBucketIndex( bnSocket, address ) ];
+	while( connection ){
+		if( connection->Matches( bnSocket, &address ) ){
+			return connection;
+		}
+		connection = connection->GetNextMapped();
+	}
+	
+	return NULL;
+}
+
+
+
+// Private Functions
+//////////////////////
+
+int debnConnectionMap::pBucketIndex( const debnSocket *bnSocket, const debnAddress &address ) const{
+	unsigned int hash = address.Hash() ^ ( unsigned int )( ( uintptr_t )bnSocket >> 4 );
+	hash *= 2654435761u;
+	return ( int )( ( hash ^ ( hash >> 16 ) ) & ( unsigned int )( pBucketCount - 1 ) );
+}
+
+void debnConnectionMap::pAppend( debnConnection *connection ){
+	debnConnection ** const bucket = pBuckets + pBucketIndex(
+		connection->GetSocket(), connection->GetRemoteAddress() );
+	connection->SetNextMapped( NULL );
+	
+	if( ! *bucket ){
+		*bucket = connection;
+		return;
+	}
+	
+	debnConnection *tail = *bucket;
+	while( tail->GetNextMapped() ){
+		tail = tail->GetNextMapped();
+	}
+	tail->SetNextMapped( connection );
+}
+
+void debnConnectionMap::pGrow(){
+	const int newBucketCount = pBucketCount > 0 ? pBucketCount * 2 : INITIAL_BUCKET_COUNT;
+	debnConnection ** const newBuckets = new debnConnection*[ newBucketCount ];
+	memset( newBuckets, 0, sizeof( debnConnection* ) * newBucketCount );
+	
+	debnConnection ** const oldBuckets = pBuckets;
+	const int oldBucketCount = pBucketCount;
+	pBuckets = newBuckets;
+	pBucketCount = newBucketCount;
+	
+	// rehash keeping the relative order of connections sharing a chain
+	int i;
+	for( i=0; i<oldBucketCount; i++ ){
+		debnConnection *connection = oldBuckets[ i ];
+		while( connection ){
+			debnConnection * const next = connection->GetNextMapped();
+			pAppend( connection );
+			connection = next;
+		}
+	}
+	
+	if( oldBuckets ){
+		delete [] oldBuckets;
+	}
+}
@@ -0,0 +1,86 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNCONNECTIONMAP_H_
+#define _DEBNCONNECTIONMAP_H_
+
+class debnAddress;
+class debnSocket;
+class debnConnection;
+
+
+
+/**
+ * \brief Hash map of connections by socket and remote address.
+ * 
+ * Used to find the connection a received datagram belongs to without walking the list
+ * of all connections. Connections are chained per bucket using the intrusive next
+ * mapped connection pointer. New connections are appended to the end of the chain to
+ * find the oldest matching connection first like the linear search did. Connections
+ * have to be removed before their socket or remote address changes.
+ */
+class debnConnectionMap{
+private:
+	debnConnection **pBuckets;
+	int pBucketCount;
+	int pCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create connection map. */
+	debnConnectionMap();
+	
+	/** \brief Clean up connection map. */
+	~debnConnectionMap();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of mapped connections. */
+	inline int GetCount() const{ return pCount; }
+	
+	/**
+	 * \brief Add connection.
+	 * \throws deeInvalidParam Connection is already mapped or has no socket.
+	 */
+	void Add( debnConnection *connection );
+	
+	/** \brief Remove connection if mapped. */
+	void Remove( debnConnection *connection );
+	
+	/** \brief Connection matching socket and address or NULL if absent. */
+	debnConnection *Find( const debnSocket *bnSocket, const debnAddress &address ) const;
+	/*@}*/
+	
+	
+	
+private:
+	int pBucketIndex( const debnSocket *bnSocket, const debnAddress &address ) const;
+	void pAppend( debnConnection *connection );
+	void pGrow();
+};
+
+#endif
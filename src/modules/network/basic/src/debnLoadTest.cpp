@@ -0,0 +1,305 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "debnAddress.h"
+#include "debnConnection.h"
+#include "debnConnectionMap.h"
+#include "debnLoadTest.h"
+#include "debnSocket.h"
+#include "deNetworkBasic.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decObjectList.h>
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/resources/network/deConnection.h>
+#include <dragengine/resources/network/deConnectionReference.h>
+#include <dragengine/resources/network/deConnectionManager.h>
+#include <dragengine/resources/network/deNetworkMessage.h>
+#include <dragengine/resources/network/deNetworkMessageReference.h>
+
+
+
+// Definitions
+////////////////
+
+// number of clients sending before the server socket is drained. keeps the amount of
+// waiting datagrams below the default socket receive buffer size
+#define GROUP_SIZE		64
+
+#define PAYLOAD_SIZE	32
+
+
+
+// Class debnLoadTest
+///////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+debnLoadTest::debnLoadTest( deNetworkBasic &netBasic ) :
+pNetBasic( netBasic ),
+pRandomSeed( 0x5eed1234 ){
+}
+
+debnLoadTest::~debnLoadTest(){
+}
+
+
+
+// Management
+///////////////
+
+void debnLoadTest::Run( int clientCount, int roundCount, decString &result ){
+	if( clientCount < 1 || roundCount < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	deConnectionManager &connectionManager = *pNetBasic.GetGameEngine()->GetConnectionManager();
+	deNetworkMessage *batch[ debnSocket::RECEIVE_BATCH_SIZE ];
+	debnAddress addresses[ debnSocket::RECEIVE_BATCH_SIZE ];
+	debnConnection **connections = NULL;
+	debnSocket **clients = NULL;
+	debnSocket *server = NULL;
+	decObjectList engineConnections;
+	deNetworkMessageReference message;
+	decTimer timer;
+	int i, j, k;
+	
+	memset( batch, 0, sizeof( batch ) );
+	
+	try{
+		// create server and client sockets bound to free loopback ports
+		server = new debnSocket( &pNetBasic );
+		server->GetAddress()->SetIPv4Loopback();
+		server->GetAddress()->SetPort( 0 );
+		server->Bind();
+		
+		clients = new debnSocket*[ clientCount ];
+		memset( clients, 0, sizeof( debnSocket* ) * clientCount );
+		
+		for( i=0; i<clientCount; i++ ){
+			clients[ i ] = new debnSocket( &pNetBasic );
+			clients[ i ]->GetAddress()->SetIPv4Loopback();
+			clients[ i ]->GetAddress()->SetPort( 0 );
+			clients[ i ]->Bind();
+		}
+		
+		// accept a connection for each client on the server socket
+		connections = new debnConnection*[ clientCount ];
+		
+		for( i=0; i<clientCount; i++ ){
+			deConnectionReference connection;
+			connection.TakeOver( connectionManager.CreateConnection() );
+			engineConnections.Add( ( deConnection* )connection );
+			
+			connections[ i ] = ( debnConnection* )connection->GetPeerNetwork();
+			connections[ i ]->AcceptConnection( server, clients[ i ]->GetAddress(), epDENetworkProtocol );
+		}
+		
+		// prepare datagrams
+		message.TakeOver( new deNetworkMessage );
+		message->SetDataLength( 2 + PAYLOAD_SIZE );
+		memset( message->GetBuffer(), 0, 2 + PAYLOAD_SIZE );
+		message->GetBuffer()[ 0 ] = ( uint8_t )eccMessage;
+		
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			batch[ i ] = new deNetworkMessage;
+		}
+		
+		// connection lookup. linear search like walking the connection list
+		const int lookupCount = clientCount * roundCount;
+		int *lookups = new int[ lookupCount ];
+		int lookupMismatches = 0;
+		double timeLookupLinear = 0.0;
+		double timeLookupMap = 0.0;
+		
+		try{
+			for( i=0; i<lookupCount; i++ ){
+				lookups[ i ] = pRandom( clientCount );
+			}
+			
+			timer.Reset();
+			for( i=0; i<lookupCount; i++ ){
+				const debnAddress &address = *clients[ lookups[ i ] ]->GetAddress();
+				for( j=0; j<clientCount; j++ ){
+					if( connections[ j ]->Matches( server, &address ) ){
+						break;
+					}
+				}
+				if( j != lookups[ i ] ){
+					lookupMismatches++;
+				}
+			}
+			timeLookupLinear = timer.GetElapsedTime();
+			
+			const debnConnectionMap &map = pNetBasic.GetConnectionMap();
+			for( i=0; i<lookupCount; i++ ){
+				if( map.Find( server, *clients[ lookups[ i ] ]->GetAddress() ) != connections[ lookups[ i ] ] ){
+					lookupMismatches++;
+				}
+			}
+			timeLookupMap = timer.GetElapsedTime();
+			
+		}catch( const deException & ){
+			delete [] lookups;
+			throw;
+		}
+		delete [] lookups;
+		
+		// receiving on the server socket
+		const int datagramCount = clientCount * roundCount;
+		double timeReceiveSingle = 0.0;
+		double timeReceiveBatched = 0.0;
+		int receivedSingle = 0;
+		int receivedBatched = 0;
+		
+		for( i=0; i<roundCount; i++ ){
+			for( j=0; j<clientCount; j+=GROUP_SIZE ){
+				pSendGroup( clients, j, clientCount - j, *server, message );
+				
+				timer.Reset();
+				while( server->ReceiveDatagram( batch[ 0 ], addresses ) ){
+					receivedSingle++;
+				}
+				timeReceiveSingle += timer.GetElapsedTime();
+			}
+		}
+		
+		for( i=0; i<roundCount; i++ ){
+			for( j=0; j<clientCount; j+=GROUP_SIZE ){
+				pSendGroup( clients, j, clientCount - j, *server, message );
+				
+				timer.Reset();
+				while( true ){
+					const int count = server->ReceiveDatagrams( batch, addresses, debnSocket::RECEIVE_BATCH_SIZE );
+					receivedBatched += count;
+					if( count < debnSocket::RECEIVE_BATCH_SIZE ){
+						break;
+					}
+				}
+				timeReceiveBatched += timer.GetElapsedTime();
+			}
+		}
+		
+		// sending from the server socket to all clients
+		double timeSendSingle = 0.0;
+		double timeSendQueued = 0.0;
+		int sendArrived = 0;
+		
+		for( i=0; i<roundCount; i++ ){
+			for( j=0; j<clientCount; j+=GROUP_SIZE ){
+				const int last = decMath::min( j + GROUP_SIZE, clientCount );
+				
+				timer.Reset();
+				for( k=j; k<last; k++ ){
+					server->SendDatagram( message, clients[ k ]->GetAddress() );
+				}
+				timeSendSingle += timer.GetElapsedTime();
+				
+				for( k=j; k<last; k++ ){
+					sendArrived += clients[ k ]->ReceiveDatagrams( batch, addresses, debnSocket::RECEIVE_BATCH_SIZE );
+				}
+				
+				timer.Reset();
+				for( k=j; k<last; k++ ){
+					server->QueueDatagram( message, clients[ k ]->GetAddress() );
+				}
+				server->FlushDatagrams();
+				timeSendQueued += timer.GetElapsedTime();
+				
+				for( k=j; k<last; k++ ){
+					sendArrived += clients[ k ]->ReceiveDatagrams( batch, addresses, debnSocket::RECEIVE_BATCH_SIZE );
+				}
+			}
+		}
+		
+		result.Format( "Network load test: clients=%d rounds=%d datagrams=%d\n"
+			"Lookup: linear=%.2fms map=%.2fms speedup=%.1fx mismatches=%d\n"
+			"Receive: single=%.2fms (%d received) batched=%.2fms (%d received) speedup=%.1fx\n"
+			"Send: single=%.2fms queued=%.2fms speedup=%.1fx (%d of %d arrived)",
+			clientCount, roundCount, datagramCount,
+			timeLookupLinear * 1e3, timeLookupMap * 1e3,
+			timeLookupLinear / decMath::max( timeLookupMap, 1e-9 ), lookupMismatches,
+			timeReceiveSingle * 1e3, receivedSingle, timeReceiveBatched * 1e3, receivedBatched,
+			timeReceiveSingle / decMath::max( timeReceiveBatched, 1e-9 ),
+			timeSendSingle * 1e3, timeSendQueued * 1e3,
+			timeSendSingle / decMath::max( timeSendQueued, 1e-9 ),
+			sendArrived, datagramCount * 2 );
+		
+	}catch( const deException & ){
+		engineConnections.RemoveAll();
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			if( batch[ i ] ){
+				batch[ i ]->FreeReference();
+			}
+		}
+		if( connections ){
+			delete [] connections;
+		}
+		if( clients ){
+			for( i=0; i<clientCount; i++ ){
+				if( clients[ i ] ){
+					clients[ i ]->FreeReference();
+				}
+			}
+			delete [] clients;
+		}
+		if( server ){
+			server->FreeReference();
+		}
+		throw;
+	}
+	
+	engineConnections.RemoveAll();
+	for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+		batch[ i ]->FreeReference();
+	}
+	delete [] connections;
+	for( i=0; i<clientCount; i++ ){
+		clients[ i ]->FreeReference();
+	}
+	delete [] clients;
+	server->FreeReference();
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void debnLoadTest::pSendGroup( debnSocket **clients, int first, int count,
+const debnSocket &server, const deNetworkMessage *message ){
+	const int last = first + decMath::min( count, GROUP_SIZE );
+	int i;
+	for( i=first; i<last; i++ ){
+		clients[ i ]->SendDatagram( message, server.GetAddress() );
+	}
+}
+
+int debnLoadTest::pRandom( int range ){
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return ( int )( ( pRandomSeed >> 16 ) % ( unsigned int )range );
+}
@@ -0,0 +1,82 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNLOADTEST_H_
+#define _DEBNLOADTEST_H_
+
+#include <dragengine/common/string/decString.h>
+
+class deNetworkBasic;
+class debnConnection;
+class debnSocket;
+class deNetworkMessage;
+
+
+
+/**
+ * \brief Loopback load test.
+ * 
+ * Simulates many clients sending to one server socket over the loopback device. For each
+ * client a connection is accepted on the server socket like debnServer does. Compares
+ * the linear connection search against the connection map, receiving one datagram per
+ * call against batched receiving and sending one datagram per call against queued
+ * sending. Clients send in groups small enough to not overflow the socket buffers.
+ * Run using the "load_test" module command.
+ */
+class debnLoadTest{
+private:
+	deNetworkBasic &pNetBasic;
+	unsigned int pRandomSeed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create load test. */
+	debnLoadTest( deNetworkBasic &netBasic );
+	
+	/** \brief Clean up load test. */
+	~debnLoadTest();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Run load test.
+	 * \param[in] clientCount Number of simulated clients each using an own socket.
+	 * \param[in] roundCount Number of datagrams send by each client.
+	 * \param[out] result Load test results in human readable form.
+	 */
+	void Run( int clientCount, int roundCount, decString &result );
+	/*@}*/
+	
+	
+	
+private:
+	void pSendGroup( debnSocket **clients, int first, int count,
+		const debnSocket &server, const deNetworkMessage *message );
+	int pRandom( int range );
+};
+
+#endif
@@ -102,7 +102,7 @@ void debnServer::ProcessConnectionRequest( debnAddress *address, decBaseFileRead
 		clientProtocols.Add( reader.ReadUShort() );
 	}
 	
-	if( ! clientProtocols.Has( epDENetworkProtocol ) ){
+	if( ! clientProtocols.Has( epDENetworkProtocol ) && ! clientProtocols.Has( epDENetworkProtocolV2 ) ){
 		decBaseFileWriter &sendWriter = pNetBasic->GetSharedSendDatagramWriter();
 		sendWriter.SetPosition( 0 );
 		pNetBasic->GetSharedSendDatagram()->Clear();
@@ -112,7 +112,8 @@ void debnServer::ProcessConnectionRequest( debnAddress *address, decBaseFileRead
 		return;
 	}
 	
-	eProtocols protocol = epDENetworkProtocol;
+	const eProtocols protocol = clientProtocols.Has( epDENetworkProtocolV2 )
+		? epDENetworkProtocolV2 : epDENetworkProtocol;
 	
 	// create connection 
 	deConnectionReference connection;
@@ -33,6 +33,10 @@
 #	include <sys/poll.h>
 #endif
 
+#if defined OS_UNIX && defined __linux__
+#	define BN_USE_MMSG 1
+#endif
+
 #ifdef OS_W32
 #	include <dragengine/app/include_windows.h>
 typedef int socklen_t;
@@ -45,6 +49,18 @@ typedef int socklen_t;
 
 #include <dragengine/resources/network/deNetworkMessage.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Definitions
+////////////////
+
+// maximum size of received datagrams
+#define MAX_DATAGRAM_SIZE 8192
+
+// number of datagrams queued before the queue is flushed
+#define QUEUE_SIZE 64
 
 
 
@@ -63,6 +79,14 @@ debnSocket::debnSocket( deNetworkBasic *netBasic ){
 	pAddress = NULL;
 	pSocket = -1;
 	
+	pQueueData = NULL;
+	pQueueDataSize = 0;
+	pQueueDataUsed = 0;
+	pQueueOffsets = NULL;
+	pQueueLengths = NULL;
+	pQueueAddresses = NULL;
+	pQueueCount = 0;
+	
 	pPreviousSocket = NULL;
 	pNextSocket = NULL;
 	pIsRegistered = false;
@@ -71,6 +95,10 @@ debnSocket::debnSocket( deNetworkBasic *netBasic ){
 		pAddress = new debnAddress;
 		if( ! pAddress ) DETHROW( deeOutOfMemory );
 		
+		pQueueOffsets = new int[ QUEUE_SIZE ];
+		pQueueLengths = new int[ QUEUE_SIZE ];
+		pQueueAddresses = new debnAddress[ QUEUE_SIZE ];
+		
 		// create socket
 		pSocket = socket( PF_INET, SOCK_DGRAM, 0 );
 		if( pSocket == -1 ){
@@ -158,7 +186,7 @@ bool debnSocket::ReceiveDatagram( deNetworkMessage *stream, debnAddress *address
 	if( select( 0, &fd, NULL, NULL, &tv ) == 1 )
 #endif
 	{
-		dataLen = 8192; // TEMP HACK !!!
+		dataLen = MAX_DATAGRAM_SIZE;
 		
 		stream->SetDataLength( dataLen );
 		
@@ -189,24 +217,73 @@ bool debnSocket::ReceiveDatagram( deNetworkMessage *stream, debnAddress *address
 	return ( dataLen > 0 );
 }
 
-void debnSocket::SendDatagram( const deNetworkMessage *stream, const debnAddress *address ){
-	if( ! stream || ! address ){
+int debnSocket::ReceiveDatagrams( deNetworkMessage **streams, debnAddress *addresses, int count ){
+	if( ! streams || ! addresses ){
 		DETHROW( deeInvalidParam );
 	}
+	if( count > RECEIVE_BATCH_SIZE ){
+		count = RECEIVE_BATCH_SIZE;
+	}
 	
-	struct sockaddr_in sa;
+#ifdef BN_USE_MMSG
+	struct mmsghdr messages[ RECEIVE_BATCH_SIZE ];
+	struct iovec vectors[ RECEIVE_BATCH_SIZE ];
+	struct sockaddr_in sources[ RECEIVE_BATCH_SIZE ];
+	int i;
 	
-	memset( &sa, '\0', sizeof( sa ) );
-    sa.sin_family = AF_INET;
-	address->SetSocketIPv4( sa );
+	memset( messages, 0, sizeof( struct mmsghdr ) * count );
 	
-	#ifdef OS_W32
-	sendto( pSocket, ( char* )stream->GetBuffer(), stream->GetDataLength(),
-		0, ( struct sockaddr * )&sa, sizeof( sockaddr ) );
-	#else
-	sendto( pSocket, stream->GetBuffer(), stream->GetDataLength(),
-		0, ( struct sockaddr * )&sa, sizeof( sockaddr ) );
-	#endif
+	for( i=0; i<count; i++ ){
+		streams[ i ]->SetDataLength( MAX_DATAGRAM_SIZE );
+		vectors[ i ].iov_base = streams[ i ]->GetBuffer();
+		vectors[ i ].iov_len = MAX_DATAGRAM_SIZE;
+		
+		messages[ i ].msg_hdr.msg_name = sources + i;
+		messages[ i ].msg_hdr.msg_namelen = sizeof( struct sockaddr_in );
+		messages[ i ].msg_hdr.msg_iov = vectors + i;
+		messages[ i ].msg_hdr.msg_iovlen = 1;
+	}
+	
+	const int received = recvmmsg( pSocket, messages, count, MSG_DONTWAIT, NULL );
+	if( received < 1 ){
+		return 0;
+	}
+	
+	// drop empty datagrams moving the filled streams to the front
+	int filled = 0;
+	for( i=0; i<received; i++ ){
+		if( messages[ i ].msg_len == 0 ){
+			continue;
+		}
+		
+		if( i != filled ){
+			deNetworkMessage * const exchange = streams[ filled ];
+			streams[ filled ] = streams[ i ];
+			streams[ i ] = exchange;
+		}
+		
+		streams[ filled ]->SetDataLength( ( int )messages[ i ].msg_len );
+		addresses[ filled ].SetIPv4FromSocket( sources[ i ] );
+		filled++;
+	}
+	
+	return filled;
+	
+#else
+	int received = 0;
+	while( received < count && ReceiveDatagram( streams[ received ], addresses + received ) ){
+		received++;
+	}
+	return received;
+#endif
+}
+
+void debnSocket::SendDatagram( const deNetworkMessage *stream, const debnAddress *address ){
+	if( ! stream || ! address ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pSendTo( stream->GetBuffer(), stream->GetDataLength(), *address );
 	
 // 	pNetBasic->LogInfoFormat( "Send datagram with length %d to %d.%d.%d.%d:%d command code %d",
 // 		stream->GetDataLength(), address->GetValueAt( 0 ), address->GetValueAt( 1 ),
@@ -215,6 +292,55 @@ void debnSocket::SendDatagram( const deNetworkMessage *stream, const debnAddress
 }
 
 
+void debnSocket::QueueDatagram( const deNetworkMessage *stream, const debnAddress *address ){
+	if( ! stream ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	QueueDatagram( stream->GetBuffer(), stream->GetDataLength(), address );
+}
+
+void debnSocket::QueueDatagram( const uint8_t *data, int length, const debnAddress *address ){
+	if( ( ! data && length > 0 ) || length < 0 || ! address ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const deMutexGuard lock( pQueueMutex );
+	
+	if( pQueueCount == QUEUE_SIZE ){
+		pFlushDatagrams();
+	}
+	
+	if( pQueueDataUsed + length > pQueueDataSize ){
+		int newSize = pQueueDataSize > 0 ? pQueueDataSize * 2 : 4096;
+		while( newSize < pQueueDataUsed + length ){
+			newSize *= 2;
+		}
+		
+		uint8_t * const newData = new uint8_t[ newSize ];
+		if( pQueueData ){
+			memcpy( newData, pQueueData, pQueueDataUsed );
+			delete [] pQueueData;
+		}
+		pQueueData = newData;
+		pQueueDataSize = newSize;
+	}
+	
+	if( length > 0 ){
+		memcpy( pQueueData + pQueueDataUsed, data, length );
+	}
+	pQueueOffsets[ pQueueCount ] = pQueueDataUsed;
+	pQueueLengths[ pQueueCount ] = length;
+	pQueueAddresses[ pQueueCount ] = *address;
+	pQueueDataUsed += length;
+	pQueueCount++;
+}
+
+void debnSocket::FlushDatagrams(){
+	const deMutexGuard lock( pQueueMutex );
+	pFlushDatagrams();
+}
+
 
 // Linked List
 ////////////////
@@ -242,9 +368,85 @@ void debnSocket::pCleanUp(){
 	}
 	
 	if( pSocket != -1 ){
+		if( pQueueAddresses ){
+			FlushDatagrams();
+		}
 		close( pSocket );
 	}
+	
+	if( pQueueAddresses ){
+		delete [] pQueueAddresses;
+	}
+	if( pQueueLengths ){
+		delete [] pQueueLengths;
+	}
+	if( pQueueOffsets ){
+		delete [] pQueueOffsets;
+	}
+	if( pQueueData ){
+		delete [] pQueueData;
+	}
 	if( pAddress ){
 		delete pAddress;
 	}
 }
+
+void debnSocket::pFlushDatagrams(){
+	if( pQueueCount == 0 ){
+		return;
+	}
+	
+#ifdef BN_USE_MMSG
+	struct mmsghdr messages[ QUEUE_SIZE ];
+	struct iovec vectors[ QUEUE_SIZE ];
+	struct sockaddr_in targets[ QUEUE_SIZE ];
+	int i;
+	
+	memset( messages, 0, sizeof( struct mmsghdr ) * pQueueCount );
+	memset( targets, 0, sizeof( struct sockaddr_in ) * pQueueCount );
+	
+	for( i=0; i<pQueueCount; i++ ){
+		targets[ i ].sin_family = AF_INET;
+		pQueueAddresses[ i ].SetSocketIPv4( targets[ i ] );
+		
+		vectors[ i ].iov_base = pQueueData + pQueueOffsets[ i ];
+		vectors[ i ].iov_len = pQueueLengths[ i ];
+		
+		messages[ i ].msg_hdr.msg_name = targets + i;
+		messages[ i ].msg_hdr.msg_namelen = sizeof( struct sockaddr_in );
+		messages[ i ].msg_hdr.msg_iov = vectors + i;
+		messages[ i ].msg_hdr.msg_iovlen = 1;
+	}
+	
+	// sendmmsg stops at the first failing datagram. skip it like failed sendto calls
+	// are ignored and continue with the rest
+	int sent = 0;
+	while( sent < pQueueCount ){
+		const int result = sendmmsg( pSocket, messages + sent, pQueueCount - sent, 0 );
+		sent += result > 0 ? result : 1;
+	}
+	
+#else
+	int i;
+	for( i=0; i<pQueueCount; i++ ){
+		pSendTo( pQueueData + pQueueOffsets[ i ], pQueueLengths[ i ], pQueueAddresses[ i ] );
+	}
+#endif
+	
+	pQueueCount = 0;
+	pQueueDataUsed = 0;
+}
+
+void debnSocket::pSendTo( const uint8_t *data, int length, const debnAddress &address ){
+	struct sockaddr_in sa;
+	
+	memset( &sa, '\0', sizeof( sa ) );
+	sa.sin_family = AF_INET;
+	address.SetSocketIPv4( sa );
+	
+	#ifdef OS_W32
+	sendto( pSocket, ( const char* )data, length, 0, ( struct sockaddr * )&sa, sizeof( sockaddr ) );
+	#else
+	sendto( pSocket, data, length, 0, ( struct sockaddr * )&sa, sizeof( sockaddr ) );
+	#endif
+}
@@ -22,7 +22,10 @@
 #ifndef _DEBNSOCKET_H_
 #define _DEBNSOCKET_H_
 
+#include <stdint.h>
+
 #include "dragengine/deObject.h"
+#include "dragengine/threading/deMutex.h"
 
 class debnAddress;
 class deNetworkBasic;
@@ -34,12 +37,27 @@ class deNetworkMessage;
  * \brief Socket class.
  */
 class debnSocket : public deObject{
+public:
+	/** \brief Maximum number of datagrams received by a single ReceiveDatagrams call. */
+	static const int RECEIVE_BATCH_SIZE = 32;
+	
+	
+	
 private:
 	deNetworkBasic *pNetBasic;
 	debnAddress *pAddress;
 	
 	int pSocket;
 	
+	uint8_t *pQueueData;
+	int pQueueDataSize;
+	int pQueueDataUsed;
+	int *pQueueOffsets;
+	int *pQueueLengths;
+	debnAddress *pQueueAddresses;
+	int pQueueCount;
+	deMutex pQueueMutex;
+	
 	debnSocket *pPreviousSocket;
 	debnSocket *pNextSocket;
 	bool pIsRegistered;
@@ -63,6 +81,9 @@ public:
 	/** \brief Address. */
 	inline debnAddress *GetAddress() const{ return pAddress; }
 	
+	/** \brief Operating system socket handle or -1. */
+	inline int GetSocketHandle() const{ return pSocket; }
+	
 	/** \brief Bind socket to stored address. */
 	void Bind();
 	
@@ -72,10 +93,47 @@ public:
 	 */
 	bool ReceiveDatagram( deNetworkMessage *stream, debnAddress *address );
 	
+	/**
+	 * \brief Receive up to count datagrams from socket.
+	 * 
+	 * On linux all datagrams are received using a single recvmmsg call. On other
+	 * platforms ReceiveDatagram is called repeatedly. Received datagrams are stored
+	 * in the first entries of streams and addresses. Streams can be reordered.
+	 * 
+	 * \param[in,out] streams Array of count streams to receive into.
+	 * \param[out] addresses Array of count addresses to store the senders in.
+	 * \param[in] count Size of arrays. Clamped to RECEIVE_BATCH_SIZE.
+	 * \returns Number of received datagrams.
+	 */
+	int ReceiveDatagrams( deNetworkMessage **streams, debnAddress *addresses, int count );
+	
 	/**
 	 * \brief Send datagram.
 	 */
 	void SendDatagram( const deNetworkMessage *stream, const debnAddress *address );
+	
+	/**
+	 * \brief Queue datagram for sending with the next FlushDatagrams call.
+	 * 
+	 * The content of stream is copied. If the queue is full it is flushed first.
+	 * Datagrams are send in the order they are queued. Queueing and flushing is
+	 * thread safe to allow the I/O thread and the main thread to send.
+	 */
+	void QueueDatagram( const deNetworkMessage *stream, const debnAddress *address );
+	
+	/** \brief Queue datagram data for sending with the next FlushDatagrams call. */
+	void QueueDatagram( const uint8_t *data, int length, const debnAddress *address );
+	
+	/** \brief Number of queued datagrams. */
+	inline int GetQueuedDatagramCount() const{ return pQueueCount; }
+	
+	/**
+	 * \brief Send all queued datagrams.
+	 * 
+	 * On linux all datagrams are send using a single sendmmsg call. On other
+	 * platforms one sendto call is used per datagram.
+	 */
+	void FlushDatagrams();
 	/*@}*/
 	
 	
@@ -105,6 +163,8 @@ public:
 	
 private:
 	void pCleanUp();
+	void pFlushDatagrams();
+	void pSendTo( const uint8_t *data, int length, const debnAddress &address );
 };
 
 #endif
@@ -0,0 +1,128 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debnBitReader.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class debnBitReader
+////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debnBitReader::debnBitReader( const uint8_t *data, int length ) :
+pData( data ),
+pLength( length ),
+pPosition( 0 ),
+pBits( 0 ),
+pBitCount( 0 )
+{
+	if( length < 0 || ( length > 0 && ! data ) ){
+		DETHROW( deeInvalidParam );
+	}
+}
+
+debnBitReader::~debnBitReader(){
+}
+
+
+
+// Management
+///////////////
+
+uint32_t debnBitReader::ReadBits( int count ){
+	if( count < 1 ){
+		return 0;
+	}
+	if( count > 32 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	while( pBitCount < count ){
+		if( pPosition == pLength ){
+			DETHROW( deeInvalidFileFormat );
+		}
+		pBits |= ( uint64_t )pData[ pPosition++ ] << pBitCount;
+		pBitCount += 8;
+	}
+	
+	const uint32_t bits = ( uint32_t )( pBits & ( ( ( uint64_t )1 << count ) - 1 ) );
+	pBits >>= count;
+	pBitCount -= count;
+	return bits;
+}
+
+int64_t debnBitReader::ReadDelta( int64_t baseline ){
+	if( ! ReadBit() ){
+		return baseline;
+	}
+	
+	const int bitCount = ( int )ReadBits( 6 ) + 1;
+	const int lowCount = bitCount - 1;
+	uint64_t zigzag;
+	
+	if( lowCount > 32 ){
+		zigzag = ReadBits( 32 );
+		zigzag |= ( uint64_t )ReadBits( lowCount - 32 ) << 32;
+		
+	}else{
+		zigzag = ReadBits( lowCount );
+	}
+	zigzag |= ( uint64_t )1 << lowCount;
+	
+	const uint64_t difference = ( zigzag >> 1 ) ^ ( ~( zigzag & 1 ) + 1 );
+	return ( int64_t )( ( uint64_t )baseline + difference );
+}
+
+uint32_t debnBitReader::ReadVarUInt(){
+	uint32_t value = 0;
+	int shift = 0;
+	
+	while( true ){
+		const uint32_t byte = ReadBits( 8 );
+		if( shift > 28 ){
+			DETHROW( deeInvalidFileFormat );
+		}
+		value |= ( byte & 0x7f ) << shift;
+		if( ( byte & 0x80 ) == 0 ){
+			return value;
+		}
+		shift += 7;
+	}
+}
+
+void debnBitReader::ReadBytes( void *data, int length ){
+	if( length < 0 || ( length > 0 && ! data ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	uint8_t * const bytes = ( uint8_t* )data;
+	int i;
+	for( i=0; i<length; i++ ){
+		bytes[ i ] = ( uint8_t )ReadBits( 8 );
+	}
+}
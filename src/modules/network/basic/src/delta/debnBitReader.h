@@ -0,0 +1,79 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNBITREADER_H_
+#define _DEBNBITREADER_H_
+
+#include <stdint.h>
+
+
+
+/**
+ * \brief Bit level reader.
+ * 
+ * Reads bits written by debnBitWriter from a memory buffer not owned by the reader.
+ * Reading past the end of the buffer throws deeInvalidFileFormat.
+ */
+class debnBitReader{
+private:
+	const uint8_t *pData;
+	int pLength;
+	int pPosition;
+	uint64_t pBits;
+	int pBitCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create bit reader. */
+	debnBitReader( const uint8_t *data, int length );
+	
+	/** \brief Clean up bit reader. */
+	~debnBitReader();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of bits left to read. */
+	inline int GetRemainingBits() const{ return ( pLength - pPosition ) * 8 + pBitCount; }
+	
+	/** \brief Read up to 32 bits. */
+	uint32_t ReadBits( int count );
+	
+	/** \brief Read single bit. */
+	inline bool ReadBit(){ return ReadBits( 1 ) == 1; }
+	
+	/** \brief Read difference written by debnBitWriter::WriteDelta and add it to baseline. */
+	int64_t ReadDelta( int64_t baseline );
+	
+	/** \brief Read unsigned variable length integer. */
+	uint32_t ReadVarUInt();
+	
+	/** \brief Read bytes. */
+	void ReadBytes( void *data, int length );
+	/*@}*/
+};
+
+#endif
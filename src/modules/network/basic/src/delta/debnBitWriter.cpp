@@ -0,0 +1,158 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debnBitWriter.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class debnBitWriter
+////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debnBitWriter::debnBitWriter() :
+pData( NULL ),
+pSize( 0 ),
+pLength( 0 ),
+pBits( 0 ),
+pBitCount( 0 ){
+}
+
+debnBitWriter::~debnBitWriter(){
+	if( pData ){
+		delete [] pData;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void debnBitWriter::Reset(){
+	pLength = 0;
+	pBits = 0;
+	pBitCount = 0;
+}
+
+void debnBitWriter::WriteBits( uint32_t bits, int count ){
+	if( count < 1 ){
+		return;
+	}
+	if( count > 32 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	if( count < 32 ){
+		bits &= ( 1u << count ) - 1u;
+	}
+	pBits |= ( uint64_t )bits << pBitCount;
+	pBitCount += count;
+	
+	while( pBitCount >= 8 ){
+		pWriteByte( ( uint8_t )( pBits & 0xff ) );
+		pBits >>= 8;
+		pBitCount -= 8;
+	}
+}
+
+void debnBitWriter::WriteDelta( int64_t value, int64_t baseline ){
+	// difference calculated unsigned to wrap instead of overflowing
+	const int64_t difference = ( int64_t )( ( uint64_t )value - ( uint64_t )baseline );
+	const uint64_t zigzag = ( ( uint64_t )difference << 1 ) ^ ( uint64_t )( difference >> 63 );
+	
+	if( zigzag == 0 ){
+		WriteBit( false );
+		return;
+	}
+	
+	int bitCount = 64;
+	while( ( zigzag & ( ( uint64_t )1 << ( bitCount - 1 ) ) ) == 0 ){
+		bitCount--;
+	}
+	
+	WriteBit( true );
+	WriteBits( ( uint32_t )( bitCount - 1 ), 6 );
+	
+	// most significant bit is implicit
+	const int lowCount = bitCount - 1;
+	if( lowCount > 32 ){
+		WriteBits( ( uint32_t )( zigzag & 0xffffffff ), 32 );
+		WriteBits( ( uint32_t )( zigzag >> 32 ), lowCount - 32 );
+		
+	}else{
+		WriteBits( ( uint32_t )( zigzag & 0xffffffff ), lowCount );
+	}
+}
+
+void debnBitWriter::WriteVarUInt( uint32_t value ){
+	while( value >= 0x80 ){
+		WriteBits( ( value & 0x7f ) | 0x80, 8 );
+		value >>= 7;
+	}
+	WriteBits( value, 8 );
+}
+
+void debnBitWriter::WriteBytes( const void *data, int length ){
+	if( length < 0 || ( length > 0 && ! data ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const uint8_t * const bytes = ( const uint8_t* )data;
+	int i;
+	for( i=0; i<length; i++ ){
+		WriteBits( bytes[ i ], 8 );
+	}
+}
+
+void debnBitWriter::Flush(){
+	if( pBitCount > 0 ){
+		pWriteByte( ( uint8_t )( pBits & 0xff ) );
+		pBits = 0;
+		pBitCount = 0;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void debnBitWriter::pWriteByte( uint8_t byte ){
+	if( pLength == pSize ){
+		const int newSize = pSize > 0 ? pSize * 2 : 256;
+		uint8_t * const newData = new uint8_t[ newSize ];
+		if( pData ){
+			memcpy( newData, pData, pLength );
+			delete [] pData;
+		}
+		pData = newData;
+		pSize = newSize;
+	}
+	
+	pData[ pLength++ ] = byte;
+}
@@ -0,0 +1,102 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNBITWRITER_H_
+#define _DEBNBITWRITER_H_
+
+#include <stdint.h>
+
+
+
+/**
+ * \brief Bit level writer.
+ * 
+ * Writes bits into a growable memory buffer. Bits are filled into bytes starting with
+ * the least significant bit. Provides zig-zag encoded variable length deltas used for
+ * quantized state values. The buffer is reused across Reset calls.
+ */
+class debnBitWriter{
+private:
+	uint8_t *pData;
+	int pSize;
+	int pLength;
+	uint64_t pBits;
+	int pBitCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create bit writer. */
+	debnBitWriter();
+	
+	/** \brief Clean up bit writer. */
+	~debnBitWriter();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Written data. Valid after Flush. */
+	inline const uint8_t *GetData() const{ return pData; }
+	
+	/** \brief Length of written data in bytes. Valid after Flush. */
+	inline int GetLength() const{ return pLength; }
+	
+	/** \brief Number of written bits including not flushed bits. */
+	inline int GetBitLength() const{ return pLength * 8 + pBitCount; }
+	
+	/** \brief Clear written data. */
+	void Reset();
+	
+	/** \brief Write up to 32 bits. */
+	void WriteBits( uint32_t bits, int count );
+	
+	/** \brief Write single bit. */
+	inline void WriteBit( bool bit ){ WriteBits( bit ? 1 : 0, 1 ); }
+	
+	/**
+	 * \brief Write difference between value and baseline.
+	 * 
+	 * Zero differences use 1 bit. Other differences are zig-zag encoded and written
+	 * as 6 bit length followed by the bits below the most significant set bit.
+	 */
+	void WriteDelta( int64_t value, int64_t baseline );
+	
+	/** \brief Write unsigned variable length integer. */
+	void WriteVarUInt( uint32_t value );
+	
+	/** \brief Write bytes. */
+	void WriteBytes( const void *data, int length );
+	
+	/** \brief Pad last byte with zero bits and write it. */
+	void Flush();
+	/*@}*/
+	
+	
+	
+private:
+	void pWriteByte( uint8_t byte );
+};
+
+#endif
@@ -0,0 +1,151 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debnDeltaSnapshots.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class debnDeltaSnapshots
+/////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debnDeltaSnapshots::debnDeltaSnapshots( int componentCount ) :
+pComponentCount( componentCount ),
+pComponents( NULL ),
+pNext( 0 ),
+pBaseline( -1 )
+{
+	if( componentCount < 0 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	if( componentCount > 0 ){
+		pComponents = new int64_t[ componentCount * SNAPSHOT_COUNT ];
+	}
+	
+	Clear();
+}
+
+debnDeltaSnapshots::~debnDeltaSnapshots(){
+	if( pComponents ){
+		delete [] pComponents;
+	}
+}
+
+
+
+// Management
+///////////////
+
+void debnDeltaSnapshots::Clear(){
+	int i;
+	for( i=0; i<SNAPSHOT_COUNT; i++ ){
+		pSequences[ i ] = -1;
+	}
+	pNext = 0;
+	pBaseline = -1;
+}
+
+int64_t *debnDeltaSnapshots::Add( int sequence ){
+	if( sequence < 0 || sequence > 0xffff ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int index = pNext;
+	pNext = ( pNext + 1 ) % SNAPSHOT_COUNT;
+	
+	if( index == pBaseline ){
+		pBaseline = -1;
+	}
+	
+	pSequences[ index ] = sequence;
+	return pComponents + index * pComponentCount;
+}
+
+int debnDeltaSnapshots::IndexOfSequence( int sequence ) const{
+	int i;
+	for( i=0; i<SNAPSHOT_COUNT; i++ ){
+		if( pSequences[ i ] == sequence ){
+			return i;
+		}
+	}
+	return -1;
+}
+
+const int64_t *debnDeltaSnapshots::GetComponentsAt( int index ) const{
+	if( index < 0 || index >= SNAPSHOT_COUNT || pSequences[ index ] == -1 ){
+		DETHROW( deeInvalidParam );
+	}
+	return pComponents + index * pComponentCount;
+}
+
+int debnDeltaSnapshots::GetBaselineSequence() const{
+	if( pBaseline == -1 ){
+		DETHROW( deeInvalidParam );
+	}
+	return pSequences[ pBaseline ];
+}
+
+bool debnDeltaSnapshots::AcknowledgeSequence( int sequence ){
+	const int index = IndexOfSequence( sequence );
+	if( index == -1 || index == pBaseline ){
+		return false;
+	}
+	if( pBaseline != -1 && ! IsNewer( sequence, pSequences[ pBaseline ] ) ){
+		return false;
+	}
+	
+	pBaseline = index;
+	return true;
+}
+
+bool debnDeltaSnapshots::Differs( const int64_t *components, int first, int count ) const{
+	if( pBaseline == -1 ){
+		return true;
+	}
+	
+	const int baselineSequence = pSequences[ pBaseline ];
+	int i;
+	
+	for( i=0; i<SNAPSHOT_COUNT; i++ ){
+		if( pSequences[ i ] == -1 || ( i != pBaseline && ! IsNewer( pSequences[ i ], baselineSequence ) ) ){
+			continue;
+		}
+		
+		if( memcmp( pComponents + i * pComponentCount + first,
+		components + first, sizeof( int64_t ) * count ) != 0 ){
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+bool debnDeltaSnapshots::IsNewer( int a, int b ){
+	return ( int16_t )( uint16_t )( a - b ) > 0;
+}
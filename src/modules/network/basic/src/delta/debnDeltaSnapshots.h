@@ -0,0 +1,113 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNDELTASNAPSHOTS_H_
+#define _DEBNDELTASNAPSHOTS_H_
+
+#include <stdint.h>
+
+
+
+/**
+ * \brief Ring of quantized state snapshots used for delta compression.
+ * 
+ * Stores the quantized components of the last SNAPSHOT_COUNT link updates together with
+ * the sequence number of the datagram they have been send or received with. The sending
+ * side marks the snapshot acknowledged by the remote side as baseline. The receiving
+ * side looks up the baseline snapshot the sender used to decode deltas against.
+ */
+class debnDeltaSnapshots{
+public:
+	/** \brief Number of snapshots kept. */
+	static const int SNAPSHOT_COUNT = 32;
+	
+	
+	
+private:
+	int pComponentCount;
+	int64_t *pComponents;
+	int pSequences[ SNAPSHOT_COUNT ];
+	int pNext;
+	int pBaseline;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create snapshot ring. */
+	debnDeltaSnapshots( int componentCount );
+	
+	/** \brief Clean up snapshot ring. */
+	~debnDeltaSnapshots();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of components per snapshot. */
+	inline int GetComponentCount() const{ return pComponentCount; }
+	
+	/** \brief Remove all snapshots and the baseline. */
+	void Clear();
+	
+	/**
+	 * \brief Add snapshot replacing the oldest one.
+	 * 
+	 * If the oldest snapshot is the baseline the baseline is cleared.
+	 * \returns Components of the new snapshot to fill in.
+	 */
+	int64_t *Add( int sequence );
+	
+	/** \brief Index of snapshot with sequence or -1 if absent. */
+	int IndexOfSequence( int sequence ) const;
+	
+	/** \brief Components of snapshot at index. */
+	const int64_t *GetComponentsAt( int index ) const;
+	
+	/** \brief Baseline snapshot index or -1 if not set. */
+	inline int GetBaseline() const{ return pBaseline; }
+	
+	/** \brief Sequence of baseline snapshot. Baseline has to be set. */
+	int GetBaselineSequence() const;
+	
+	/**
+	 * \brief Set baseline to snapshot with sequence if present and newer than the current baseline.
+	 * \returns true if the baseline changed.
+	 */
+	bool AcknowledgeSequence( int sequence );
+	
+	/**
+	 * \brief Component range differs from baseline or any snapshot newer than the baseline.
+	 * 
+	 * Used by the sending side to decide if values have to be written. Values equal to
+	 * the baseline still have to be written if a newer snapshot not yet acknowledged
+	 * carried a different value since the remote side could have applied it.
+	 */
+	bool Differs( const int64_t *components, int first, int count ) const;
+	
+	/** \brief Sequence a is newer than sequence b taking wrapping into account. */
+	static bool IsNewer( int a, int b );
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,98 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <string.h>
+
+#include "debnIOEvent.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/resources/network/deNetworkMessage.h>
+
+
+
+// Class debnIOEvent
+//////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debnIOEvent::debnIOEvent() :
+pType( eetDatagram ),
+pSocket( NULL ),
+pNumber( 0 )
+{
+	next = NULL;
+	pMessage.TakeOver( new deNetworkMessage );
+}
+
+debnIOEvent::~debnIOEvent(){
+}
+
+
+
+// Management
+///////////////
+
+void debnIOEvent::SetSocket( debnSocket *bnSocket ){
+	pSocket = bnSocket;
+}
+
+void debnIOEvent::Set( eEventTypes type, debnSocket *bnSocket, const debnAddress &address,
+int number, const uint8_t *data, int length ){
+	if( length < 0 || ( length > 0 && ! data ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	pType = type;
+	pSocket = bnSocket;
+	pAddress = address;
+	pNumber = number;
+	
+	pMessage->SetDataLength( length );
+	if( length > 0 ){
+		memcpy( pMessage->GetBuffer(), data, length );
+	}
+}
+
+void debnIOEvent::Set( eEventTypes type, debnSocket *bnSocket, const debnAddress &address,
+int number, decBaseFileReader &reader ){
+	const int length = reader.GetLength() - reader.GetPosition();
+	
+	pType = type;
+	pSocket = bnSocket;
+	pAddress = address;
+	pNumber = number;
+	
+	pMessage->SetDataLength( length );
+	if( length > 0 ){
+		reader.Read( pMessage->GetBuffer(), length );
+	}
+}
+
+
+
+// Linked List
+////////////////
+
+void debnIOEvent::SetNextEvent( debnIOEvent *event ){
+	next = event;
+}
@@ -0,0 +1,139 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNIOEVENT_H_
+#define _DEBNIOEVENT_H_
+
+#include <stdint.h>
+
+#include "../debnAddress.h"
+
+#include <dragengine/resources/network/deNetworkMessageReference.h>
+#include <dragengine/threading/deLockFreeQueue.h>
+
+class debnSocket;
+class decBaseFileReader;
+
+
+
+/**
+ * \brief I/O thread event.
+ *
+ * Event handed over from the I/O thread to the main thread. Events are pooled by the
+ * I/O thread and reused. The message is kept between uses to avoid allocations. Events
+ * are linked using the deLockFreeQueue entry.
+ */
+class debnIOEvent : public deLockFreeQueue::sEntry{
+public:
+	/** \brief Event types. */
+	enum eEventTypes{
+		/** \brief Datagram to process. Message contains the entire datagram. */
+		eetDatagram,
+		
+		/** \brief Reliable message in order. Message contains the message data. */
+		eetReliableMessage,
+		
+		/** \brief Reliable link state in order. Message contains the link state data. */
+		eetReliableLinkState,
+		
+		/** \brief Connection ack processed. Number is 1 if accepted or 0 if rejected. */
+		eetConnectionAck
+	};
+	
+	
+	
+private:
+	eEventTypes pType;
+	debnSocket *pSocket;
+	debnAddress pAddress;
+	int pNumber;
+	deNetworkMessageReference pMessage;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create event. */
+	debnIOEvent();
+	
+	/** \brief Clean up event. */
+	~debnIOEvent();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Type. */
+	inline eEventTypes GetType() const{ return pType; }
+	
+	/** \brief Socket or NULL if the socket has been released. */
+	inline debnSocket *GetSocket() const{ return pSocket; }
+	
+	/** \brief Set socket or NULL if the socket has been released. */
+	void SetSocket( debnSocket *bnSocket );
+	
+	/** \brief Remote address. */
+	inline debnAddress &GetAddress(){ return pAddress; }
+	inline const debnAddress &GetAddress() const{ return pAddress; }
+	
+	/** \brief Reliable number or connection ack result. */
+	inline int GetNumber() const{ return pNumber; }
+	
+	/** \brief Message. */
+	inline deNetworkMessage *GetMessage() const{ return pMessage; }
+	
+	/**
+	 * \brief Set event.
+	 * \param[in] type Event type.
+	 * \param[in] bnSocket Socket the event has been received on.
+	 * \param[in] address Remote address.
+	 * \param[in] number Reliable number or connection ack result.
+	 * \param[in] data Data to copy into the message. Can be NULL if length is 0.
+	 * \param[in] length Length of data in bytes.
+	 */
+	void Set( eEventTypes type, debnSocket *bnSocket, const debnAddress &address,
+		int number, const uint8_t *data, int length );
+	
+	/**
+	 * \brief Set event.
+	 * 
+	 * Same as Set( eEventTypes, debnSocket*, const debnAddress&, int, const uint8_t*, int )
+	 * but copies the remaining content of reader into the message.
+	 */
+	void Set( eEventTypes type, debnSocket *bnSocket, const debnAddress &address,
+		int number, decBaseFileReader &reader );
+	/*@}*/
+	
+	
+	
+	/** \name Linked List */
+	/*@{*/
+	/** \brief Next event. */
+	inline debnIOEvent *GetNextEvent() const{ return ( debnIOEvent* )next; }
+	
+	/** \brief Set next event. */
+	void SetNextEvent( debnIOEvent *event );
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,412 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef OS_UNIX
+#	include <sys/poll.h>
+#endif
+
+#ifdef OS_W32
+#	include <dragengine/app/include_windows.h>
+#endif
+
+#include "debnIOThread.h"
+#include "../debnSocket.h"
+#include "../debnAddress.h"
+#include "../debnConnection.h"
+#include "../deNetworkBasic.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReaderReference.h>
+#include <dragengine/resources/network/deNetworkMessage.h>
+#include <dragengine/resources/network/deNetworkMessageReader.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Definitions
+////////////////
+
+// maximum time in milliseconds to wait for datagrams. also the resolution of resend timeouts
+#define WAIT_TIMEOUT 10
+
+// maximum number of sockets to wait for
+#define MAX_WAIT_SOCKETS 64
+
+
+
+// Class debnIOThread
+///////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debnIOThread::debnIOThread( deNetworkBasic &netBasic ) :
+pNetBasic( netBasic ),
+pShutDown( false ),
+pFreeEvents( NULL ),
+pDatagrams( NULL ),
+pAddresses( NULL ),
+pHandles( NULL ),
+pHandleSize( 0 )
+{
+	int i;
+	
+	try{
+		pDatagrams = new deNetworkMessage*[ debnSocket::RECEIVE_BATCH_SIZE ];
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			pDatagrams[ i ] = NULL;
+		}
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			pDatagrams[ i ] = new deNetworkMessage;
+			pDatagrams[ i ]->SetDataLength( 1024 );
+		}
+		
+		pAddresses = new debnAddress[ debnSocket::RECEIVE_BATCH_SIZE ];
+		
+	}catch( const deException & ){
+		pCleanUp();
+		throw;
+	}
+}
+
+debnIOThread::~debnIOThread(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void debnIOThread::RequestShutDown(){
+	pShutDown = true;
+}
+
+void debnIOThread::Run(){
+	pTimer.Reset();
+	
+	while( true ){
+		pWaitForDatagrams();
+		
+		const deMutexGuard guard( pNetBasic.GetMutex() );
+		if( pShutDown ){
+			break;
+		}
+		
+		try{
+			pReceiveDatagrams();
+			pProcessConnections( pTimer.GetElapsedTime() );
+			pFlushSockets();
+			
+		}catch( const deException &e ){
+			pNetBasic.LogException( e );
+		}
+	}
+}
+
+void debnIOThread::QueueEvent( debnIOEvent::eEventTypes type, debnSocket *bnSocket,
+const debnAddress &address, int number, const uint8_t *data, int length ){
+	debnIOEvent * const event = pNewEvent();
+	
+	try{
+		event->Set( type, bnSocket, address, number, data, length );
+		
+	}catch( const deException & ){
+		ReturnEvents( event );
+		throw;
+	}
+	
+	pQueueEvent( event );
+}
+
+void debnIOThread::QueueEvent( debnIOEvent::eEventTypes type, debnSocket *bnSocket,
+const debnAddress &address, int number, decBaseFileReader &reader ){
+	debnIOEvent * const event = pNewEvent();
+	
+	try{
+		event->Set( type, bnSocket, address, number, reader );
+		
+	}catch( const deException & ){
+		ReturnEvents( event );
+		throw;
+	}
+	
+	pQueueEvent( event );
+}
+
+debnIOEvent *debnIOThread::TakeEvents(){
+	return ( debnIOEvent* )pEvents.TakeAll();
+}
+
+void debnIOThread::ReturnEvents( debnIOEvent *events ){
+	if( ! events ){
+		return;
+	}
+	
+	debnIOEvent *last = events;
+	while( last->GetNextEvent() ){
+		last->SetSocket( NULL );
+		last = last->GetNextEvent();
+	}
+	last->SetSocket( NULL );
+	
+	pReturnedEvents.PushList( events, last );
+}
+
+void debnIOThread::RemoveSocketEvents( const debnSocket *bnSocket ){
+	// the I/O thread queues events only while holding the module mutex. no events
+	// are queued while walking the queued events
+	debnIOEvent *event = ( debnIOEvent* )pEvents.GetHead();
+	while( event ){
+		if( event->GetSocket() == bnSocket ){
+			event->SetSocket( NULL );
+		}
+		event = event->GetNextEvent();
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void debnIOThread::pCleanUp(){
+	debnIOEvent *event = ( debnIOEvent* )pEvents.TakeAll();
+	while( event ){
+		debnIOEvent * const next = event->GetNextEvent();
+		delete event;
+		event = next;
+	}
+	
+	event = ( debnIOEvent* )pReturnedEvents.TakeAll();
+	while( event ){
+		debnIOEvent * const next = event->GetNextEvent();
+		delete event;
+		event = next;
+	}
+	
+	while( pFreeEvents ){
+		event = pFreeEvents;
+		pFreeEvents = event->GetNextEvent();
+		delete event;
+	}
+	
+	if( pHandles ){
+		delete [] pHandles;
+	}
+	if( pAddresses ){
+		delete [] pAddresses;
+	}
+	if( pDatagrams ){
+		int i;
+		for( i=0; i<debnSocket::RECEIVE_BATCH_SIZE; i++ ){
+			if( pDatagrams[ i ] ){
+				pDatagrams[ i ]->FreeReference();
+			}
+		}
+		delete [] pDatagrams;
+	}
+}
+
+debnIOEvent *debnIOThread::pNewEvent(){
+	// free events are only used by the I/O thread. events returned by the main thread
+	// are moved over once no free events are left
+	if( ! pFreeEvents ){
+		pFreeEvents = ( debnIOEvent* )pReturnedEvents.TakeAll();
+		if( ! pFreeEvents ){
+			return new debnIOEvent;
+		}
+	}
+	
+	debnIOEvent * const event = pFreeEvents;
+	pFreeEvents = event->GetNextEvent();
+	event->SetNextEvent( NULL );
+	return event;
+}
+
+void debnIOThread::pQueueEvent( debnIOEvent *event ){
+	pEvents.Push( event );
+}
+
+int debnIOThread::pCollectSocketHandles(){
+	const deMutexGuard guard( pNetBasic.GetMutex() );
+	debnSocket *bnSocket = pNetBasic.GetHeadSocket();
+	int count = 0;
+	
+	while( bnSocket ){
+		if( count == pHandleSize ){
+			const int newSize = pHandleSize * 3 / 2 + 4;
+			int * const newArray = new int[ newSize ];
+			if( pHandles ){
+				memcpy( newArray, pHandles, sizeof( int ) * pHandleSize );
+				delete [] pHandles;
+			}
+			pHandles = newArray;
+			pHandleSize = newSize;
+		}
+		
+		pHandles[ count++ ] = bnSocket->GetSocketHandle();
+		bnSocket = bnSocket->GetNextSocket();
+	}
+	
+	return count;
+}
+
+void debnIOThread::pWaitForDatagrams(){
+	// sockets can be released while waiting. this is harmless since datagrams are
+	// only received from sockets still registered after waiting
+	int count = pCollectSocketHandles();
+	
+#ifdef OS_UNIX
+	struct pollfd ufds[ MAX_WAIT_SOCKETS ];
+	int i;
+	
+	if( count > MAX_WAIT_SOCKETS ){
+		count = MAX_WAIT_SOCKETS; // remaining sockets are received from after the timeout
+	}
+	
+	for( i=0; i<count; i++ ){
+		ufds[ i ].fd = pHandles[ i ];
+		ufds[ i ].events = POLLIN;
+		ufds[ i ].revents = 0;
+	}
+	
+	poll( ufds, count, WAIT_TIMEOUT );
+#endif
+	
+#ifdef OS_W32
+	if( count == 0 ){
+		Sleep( WAIT_TIMEOUT );
+		return;
+	}
+	
+	fd_set fds;
+	int i;
+	
+	FD_ZERO( &fds );
+	for( i=0; i<count && i<MAX_WAIT_SOCKETS; i++ ){
+		FD_SET( pHandles[ i ], &fds );
+	}
+	
+	TIMEVAL tv;
+	tv.tv_sec = 0;
+	tv.tv_usec = WAIT_TIMEOUT * 1000;
+	select( 0, &fds, NULL, NULL, &tv );
+#endif
+}
+
+void debnIOThread::pReceiveDatagrams(){
+	debnSocket *bnSocket = pNetBasic.GetHeadSocket();
+	int i;
+	
+	while( bnSocket ){
+		while( true ){
+			const int count = bnSocket->ReceiveDatagrams( pDatagrams,
+				pAddresses, debnSocket::RECEIVE_BATCH_SIZE );
+			
+			for( i=0; i<count; i++ ){
+				pProcessDatagram( bnSocket, pDatagrams[ i ], pAddresses[ i ] );
+			}
+			
+			if( count < debnSocket::RECEIVE_BATCH_SIZE ){
+				break;
+			}
+		}
+		
+		bnSocket = bnSocket->GetNextSocket();
+	}
+}
+
+void debnIOThread::pProcessDatagram( debnSocket *bnSocket,
+deNetworkMessage *datagram, const debnAddress &address ){
+	if( datagram->GetDataLength() == 0 ){
+		return;
+	}
+	
+	const eCommandCodes command = ( eCommandCodes )datagram->GetBuffer()[ 0 ];
+	
+	switch( command ){
+	case eccConnectionAck:
+	case eccReliableMessage:
+	case eccReliableLinkState:
+	case eccReliableAck:
+		break;
+		
+	default:
+		// everything else is processed by the main thread
+		QueueEvent( debnIOEvent::eetDatagram, bnSocket, address, 0,
+			datagram->GetBuffer(), datagram->GetDataLength() );
+		return;
+	}
+	
+	debnConnection * const connection = pNetBasic.GetConnectionMap().Find( bnSocket, address );
+	if( ! connection ){
+		pNetBasic.LogWarn( "Invalid datagram: Sender does not match any connection!\n" );
+		return;
+	}
+	
+	decBaseFileReaderReference reader;
+	reader.TakeOver( new deNetworkMessageReader( datagram ) );
+	reader->ReadByte(); // command
+	
+	switch( command ){
+	case eccConnectionAck:
+		connection->ProcessConnectionAck( reader );
+		break;
+		
+	case eccReliableMessage:
+		connection->ProcessReliableMessage( reader );
+		break;
+		
+	case eccReliableLinkState:
+		connection->ProcessReliableLinkState( reader );
+		break;
+		
+	case eccReliableAck:
+		connection->ProcessReliableAck( reader );
+		break;
+		
+	default:
+		break;
+	}
+}
+
+void debnIOThread::pProcessConnections( float elapsedTime ){
+	debnConnection *connection = pNetBasic.GetHeadConnection();
+	
+	while( connection ){
+		connection->ProcessReliables( elapsedTime );
+		connection = connection->GetNextConnection();
+	}
+}
+
+void debnIOThread::pFlushSockets(){
+	debnSocket *bnSocket = pNetBasic.GetHeadSocket();
+	
+	while( bnSocket ){
+		bnSocket->FlushDatagrams();
+		bnSocket = bnSocket->GetNextSocket();
+	}
+}
@@ -0,0 +1,155 @@
+/* 
+ * Drag[en]gine Basic Network Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBNIOTHREAD_H_
+#define _DEBNIOTHREAD_H_
+
+#include <stdint.h>
+
+#include "debnIOEvent.h"
+
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/threading/deLockFreeQueue.h>
+#include <dragengine/threading/deThread.h>
+
+class deNetworkBasic;
+class debnSocket;
+class debnAddress;
+class deNetworkMessage;
+class decBaseFileReader;
+
+
+
+/**
+ * \brief Network I/O thread.
+ *
+ * Receives datagrams on all registered sockets, acknowledges reliable messages and resends
+ * timed out reliable messages independent of the game loop. Reliable messages and link
+ * states are handed over to the main thread in order once all previous ones have been
+ * received. All other datagrams are handed over unprocessed. The main thread processes
+ * the events during deNetworkBasic::ProcessNetwork.
+ *
+ * The thread holds the module mutex while processing received datagrams and connections.
+ * Events are handed over using a deLockFreeQueue so neither thread waits for the other
+ * while queuing or taking events. Processed events are handed back using a second queue.
+ * The I/O thread moves them to its own free list once it runs out of free events.
+ */
+class debnIOThread : public deThread{
+private:
+	deNetworkBasic &pNetBasic;
+	bool pShutDown;
+	
+	deLockFreeQueue pEvents;
+	deLockFreeQueue pReturnedEvents;
+	debnIOEvent *pFreeEvents;
+	
+	deNetworkMessage **pDatagrams;
+	debnAddress *pAddresses;
+	int *pHandles;
+	int pHandleSize;
+	decTimer pTimer;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create I/O thread. */
+	debnIOThread( deNetworkBasic &netBasic );
+	
+	/** \brief Clean up I/O thread. */
+	virtual ~debnIOThread();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Request thread to shut down.
+	 * \warning Caller has to hold the module mutex.
+	 */
+	void RequestShutDown();
+	
+	/** \brief Run thread. */
+	virtual void Run();
+	
+	/**
+	 * \brief Queue event for the main thread.
+	 * \param[in] type Event type.
+	 * \param[in] bnSocket Socket the event has been received on.
+	 * \param[in] address Remote address.
+	 * \param[in] number Reliable number or connection ack result.
+	 * \param[in] data Data to copy into the event. Can be NULL if length is 0.
+	 * \param[in] length Length of data in bytes.
+	 * \warning Call only from the I/O thread.
+	 */
+	void QueueEvent( debnIOEvent::eEventTypes type, debnSocket *bnSocket,
+		const debnAddress &address, int number, const uint8_t *data, int length );
+	
+	/**
+	 * \brief Queue event for the main thread.
+	 * 
+	 * Same as QueueEvent( debnIOEvent::eEventTypes, debnSocket*, const debnAddress&, int,
+	 * const uint8_t*, int ) but copies the remaining content of reader into the event.
+	 * 
+	 * \warning Call only from the I/O thread.
+	 */
+	void QueueEvent( debnIOEvent::eEventTypes type, debnSocket *bnSocket,
+		const debnAddress &address, int number, decBaseFileReader &reader );
+	
+	/**
+	 * \brief Take all queued events.
+	 *
+	 * Returns the first event of the linked list of events in the order they have been
+	 * queued or NULL if no events are queued. Hand back the events using ReturnEvents
+	 * once processed.
+	 */
+	debnIOEvent *TakeEvents();
+	
+	/** \brief Return linked list of processed events for reuse. */
+	void ReturnEvents( debnIOEvent *events );
+	
+	/**
+	 * \brief Clear socket of all queued events using socket.
+	 *
+	 * Called if the socket is unregistered. Events with a cleared socket are skipped.
+	 * 
+	 * \warning Call only from the main thread while holding the module mutex.
+	 */
+	void RemoveSocketEvents( const debnSocket *bnSocket );
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+	debnIOEvent *pNewEvent();
+	void pQueueEvent( debnIOEvent *event );
+	int pCollectSocketHandles();
+	void pWaitForDatagrams();
+	void pReceiveDatagrams();
+	void pProcessDatagram( debnSocket *bnSocket, deNetworkMessage *datagram, const debnAddress &address );
+	void pProcessConnections( float elapsedTime );
+	void pFlushSockets();
+};
+
+#endif
@@ -29,6 +29,9 @@
 #include "debnStateLinkList.h"
 #include "../debnConnection.h"
 #include "../deNetworkBasic.h"
+#include "../delta/debnBitReader.h"
+#include "../delta/debnBitWriter.h"
+#include "../delta/debnDeltaSnapshots.h"
 #include "../values/debnValue.h"
 #include "../visitors/debnVisitorValueCreate.h"
 
@@ -204,6 +207,237 @@ void debnState::LinkWriteValues( decBaseFileWriter &writer, debnStateLink &link
 	link.SetChanged( link.HasChangedValues() );
 }
 
+int debnState::GetComponentCount() const{
+	int i, count = 0;
+	for( i=0; i<pValueCount; i++ ){
+		count += pValues[ i ]->GetComponentCount();
+	}
+	return count;
+}
+
+bool debnState::LinkWriteDelta( debnBitWriter &writer, debnStateLink &link ){
+	if( pValueCount == 0 ){
+		return false;
+	}
+	
+	link.PrepareDelta( GetComponentCount() );
+	
+	debnDeltaSnapshots &snapshots = link.GetSendSnapshots();
+	int64_t * const components = link.GetComponents();
+	float * const steps = link.GetSendSteps();
+	bool stepsChanged = false;
+	int i, offset;
+	
+	for( i=0, offset=0; i<pValueCount; i++ ){
+		debnValue &value = *pValues[ i ];
+		
+		// steps are transmitted as float. use the rounded value on both sides
+		const float step = ( float )value.GetQuantizationStep();
+		if( step != steps[ i ] ){
+			steps[ i ] = step;
+			stepsChanged = true;
+		}
+		
+		value.Quantize( components + offset, step );
+		offset += value.GetComponentCount();
+	}
+	
+	if( stepsChanged ){
+		// deltas quantized with different steps can not be combined
+		snapshots.Clear();
+	}
+	
+	// full update
+	if( snapshots.GetBaseline() == -1 ){
+		for( i=0; i<pValueCount; i++ ){
+			if( ! pValues[ i ]->IsRaw() ){
+				uint32_t bits;
+				memcpy( &bits, steps + i, sizeof( bits ) );
+				writer.WriteBits( bits, 32 );
+			}
+		}
+		
+		for( i=0, offset=0; i<pValueCount; i++ ){
+			debnValue &value = *pValues[ i ];
+			const int count = value.GetComponentCount();
+			int j;
+			
+			if( value.IsRaw() ){
+				writer.WriteVarUInt( ( uint32_t )value.GetRawLength() );
+				writer.WriteBytes( value.GetRawData(), value.GetRawLength() );
+				
+			}else{
+				for( j=0; j<count; j++ ){
+					writer.WriteDelta( components[ offset + j ], 0 );
+				}
+			}
+			
+			offset += count;
+		}
+		
+		return true;
+	}
+	
+	// delta update against baseline
+	const int64_t * const baseline = snapshots.GetComponentsAt( snapshots.GetBaseline() );
+	bool changed = false;
+	
+	for( i=0, offset=0; i<pValueCount; i++ ){
+		const int count = pValues[ i ]->GetComponentCount();
+		if( snapshots.Differs( components, offset, count ) ){
+			changed = true;
+			break;
+		}
+		offset += count;
+	}
+	
+	if( ! changed ){
+		return false;
+	}
+	
+	for( i=0, offset=0; i<pValueCount; i++ ){
+		debnValue &value = *pValues[ i ];
+		const int count = value.GetComponentCount();
+		
+		if( snapshots.Differs( components, offset, count ) ){
+			writer.WriteBit( true );
+			
+			if( value.IsRaw() ){
+				writer.WriteVarUInt( ( uint32_t )value.GetRawLength() );
+				writer.WriteBytes( value.GetRawData(), value.GetRawLength() );
+				
+			}else{
+				int j;
+				for( j=0; j<count; j++ ){
+					writer.WriteDelta( components[ offset + j ], baseline[ offset + j ] );
+				}
+			}
+			
+		}else{
+			writer.WriteBit( false );
+		}
+		
+		offset += count;
+	}
+	
+	return true;
+}
+
+bool debnState::LinkReadDelta( debnBitReader &reader, debnStateLink &link, int sequence, int baselineSequence ){
+	if( pValueCount == 0 ){
+		return true;
+	}
+	
+	link.PrepareDelta( GetComponentCount() );
+	
+	debnDeltaSnapshots &snapshots = link.GetReceiveSnapshots();
+	const int64_t *baseline = NULL;
+	int i, offset;
+	
+	float * const steps = link.GetReceiveSteps();
+	
+	if( baselineSequence == -1 ){
+		for( i=0; i<pValueCount; i++ ){
+			if( ! pValues[ i ]->IsRaw() ){
+				const uint32_t bits = reader.ReadBits( 32 );
+				memcpy( steps + i, &bits, sizeof( bits ) );
+			}
+		}
+		
+	}else{
+		const int index = snapshots.IndexOfSequence( baselineSequence );
+		if( index == -1 ){
+			return false;
+		}
+		baseline = snapshots.GetComponentsAt( index );
+	}
+	
+	deBaseScriptingNetworkState * const scrState = pState.GetPeerScripting();
+	const bool apply = link.GetLastReceiveSequence() == -1
+		|| debnDeltaSnapshots::IsNewer( sequence, link.GetLastReceiveSequence() );
+	int64_t * const components = link.GetComponents();
+	uint8_t *raw = NULL;
+	int rawSize = 0;
+	
+	try{
+		for( i=0, offset=0; i<pValueCount; i++ ){
+			debnValue &value = *pValues[ i ];
+			const int count = value.GetComponentCount();
+			int j;
+			
+			if( baseline && ! reader.ReadBit() ){
+				for( j=0; j<count; j++ ){
+					components[ offset + j ] = baseline[ offset + j ];
+				}
+				offset += count;
+				continue;
+			}
+			
+			if( value.IsRaw() ){
+				const int length = ( int )reader.ReadVarUInt();
+				if( length > reader.GetRemainingBits() / 8 ){
+					DETHROW( deeInvalidFileFormat );
+				}
+				
+				if( length > rawSize ){
+					if( raw ){
+						delete [] raw;
+						raw = NULL;
+					}
+					raw = new uint8_t[ length ];
+					rawSize = length;
+				}
+				
+				reader.ReadBytes( raw, length );
+				components[ offset ] = debnValue::HashBytes( raw, length );
+				
+				if( apply ){
+					value.SetRaw( raw, length );
+				}
+				
+			}else{
+				for( j=0; j<count; j++ ){
+					components[ offset + j ] = reader.ReadDelta( baseline ? baseline[ offset + j ] : 0 );
+				}
+				
+				if( apply ){
+					value.Dequantize( components + offset, steps[ i ] );
+				}
+			}
+			
+			if( apply ){
+				InvalidateValueExcept( i, link );
+				
+				if( scrState ){
+					scrState->StateValueChanged( i );
+				}
+			}
+			
+			offset += count;
+		}
+		
+	}catch( const deException & ){
+		if( raw ){
+			delete [] raw;
+		}
+		throw;
+	}
+	
+	if( raw ){
+		delete [] raw;
+	}
+	
+	// baseline pointer becomes invalid after adding the snapshot
+	memcpy( snapshots.Add( sequence ), components, sizeof( int64_t ) * link.GetComponentCount() );
+	
+	if( apply ){
+		link.SetLastReceiveSequence( sequence );
+		link.SetChanged( link.HasChangedValues() );
+	}
+	
+	return true;
+}
+
 void debnState::InvalidateValue( int index ){
 	const int count = pLinks->GetLinkCount();
 	int i;
@@ -33,6 +33,8 @@ class debnValue;
 class debnStateLink;
 class debnConnection;
 class debnStateLinkList;
+class debnBitReader;
+class debnBitWriter;
 class decBaseFileReader;
 class decBaseFileWriter;
 
@@ -113,6 +115,35 @@ public:
 	 */
 	void LinkWriteValues( decBaseFileWriter &writer, debnStateLink &link );
 	
+	/** \brief Number of delta compression components of all values. */
+	int GetComponentCount() const;
+	
+	/**
+	 * \brief Write delta compressed values for link.
+	 * 
+	 * Quantizes all values into the link components. If the link has no baseline all
+	 * values are written together with the quantization steps. Otherwise a changed bit
+	 * is written for each value followed by the deltas against the baseline if the value
+	 * differs from the baseline or any snapshot not acknowledged yet.
+	 * 
+	 * The components have to be stored using debnStateLink::StoreSendSnapshot with the
+	 * sequence of the datagram the data is send with.
+	 * 
+	 * \returns false if nothing has to be written.
+	 */
+	bool LinkWriteDelta( debnBitWriter &writer, debnStateLink &link );
+	
+	/**
+	 * \brief Read delta compressed values for link.
+	 * 
+	 * Values are applied only if \em sequence is newer than the last applied update.
+	 * The reconstructed components are stored as received snapshot in all cases.
+	 * 
+	 * \param[in] baselineSequence Sequence of baseline or -1 for full update.
+	 * \returns false if the baseline snapshot is not present.
+	 */
+	bool LinkReadDelta( debnBitReader &reader, debnStateLink &link, int sequence, int baselineSequence );
+	
 	/** \brief Invalid value in all state links. */
 	void InvalidateValue( int index );
 	
@@ -27,8 +27,10 @@
 #include "debnStateLink.h"
 #include "debnStateLinkList.h"
 #include "../debnConnection.h"
+#include "../delta/debnDeltaSnapshots.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decMath.h>
 #include <dragengine/resources/network/deNetworkState.h>
 
 
@@ -47,6 +49,13 @@ pConnection( connection ),
 pChanged( false ),
 pValueChanged( NULL ),
 pValueCount( 0 ),
+pSendSnapshots( NULL ),
+pReceiveSnapshots( NULL ),
+pSendSteps( NULL ),
+pReceiveSteps( NULL ),
+pComponents( NULL ),
+pComponentCount( 0 ),
+pLastReceiveSequence( -1 ),
 pPreviousLink( NULL ),
 pNextLink( NULL )
 {
@@ -86,7 +95,15 @@ void debnStateLink::SetIdentifier( int identifier ){
 }
 
 void debnStateLink::SetLinkState( int linkState ){
+	if( linkState == pLinkState ){
+		return;
+	}
+	
 	pLinkState = linkState;
+	
+	if( pComponentCount > 0 ){
+		ResetDelta();
+	}
 }
 
 void debnStateLink::SetChanged( bool changed ){
@@ -147,6 +164,59 @@ void debnStateLink::ResetChanged(){
 
 
 
+// Delta Compression
+//////////////////////
+
+void debnStateLink::PrepareDelta( int componentCount ){
+	if( pComponentCount > 0 ){
+		if( componentCount != pComponentCount ){
+			DETHROW( deeInvalidParam );
+		}
+		return;
+	}
+	if( componentCount < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int stepCount = decMath::max( pValueCount, 1 );
+	
+	pSendSnapshots = new debnDeltaSnapshots( componentCount );
+	pReceiveSnapshots = new debnDeltaSnapshots( componentCount );
+	pSendSteps = new float[ stepCount ];
+	pReceiveSteps = new float[ stepCount ];
+	pComponents = new int64_t[ componentCount ];
+	pComponentCount = componentCount;
+	
+	ResetDelta();
+}
+
+void debnStateLink::ResetDelta(){
+	if( pComponentCount == 0 ){
+		return;
+	}
+	
+	pSendSnapshots->Clear();
+	pReceiveSnapshots->Clear();
+	
+	int i;
+	for( i=0; i<pValueCount; i++ ){
+		pSendSteps[ i ] = -1.0f;
+		pReceiveSteps[ i ] = 0.0f;
+	}
+	
+	pLastReceiveSequence = -1;
+}
+
+void debnStateLink::StoreSendSnapshot( int sequence ){
+	memcpy( pSendSnapshots->Add( sequence ), pComponents, sizeof( int64_t ) * pComponentCount );
+}
+
+void debnStateLink::SetLastReceiveSequence( int sequence ){
+	pLastReceiveSequence = sequence;
+}
+
+
+
 // Linked List
 ////////////////
 
@@ -164,6 +234,21 @@ void debnStateLink::SetNextLink( debnStateLink *link ){
 //////////////////////
 
 void debnStateLink::pCleanUp(){
+	if( pComponents ){
+		delete [] pComponents;
+	}
+	if( pReceiveSteps ){
+		delete [] pReceiveSteps;
+	}
+	if( pSendSteps ){
+		delete [] pSendSteps;
+	}
+	if( pReceiveSnapshots ){
+		delete pReceiveSnapshots;
+	}
+	if( pSendSnapshots ){
+		delete pSendSnapshots;
+	}
 	if( pValueChanged ){
 		delete [] pValueChanged;
 	}
@@ -22,7 +22,10 @@
 #ifndef _DEBNSTATELINK_H_
 #define _DEBNSTATELINK_H_
 
+#include <stdint.h>
+
 class debnState;
+class debnDeltaSnapshots;
 class debnConnection;
 
 
@@ -52,6 +55,14 @@ private:
 	bool *pValueChanged;
 	int pValueCount;
 	
+	debnDeltaSnapshots *pSendSnapshots;
+	debnDeltaSnapshots *pReceiveSnapshots;
+	float *pSendSteps;
+	float *pReceiveSteps;
+	int64_t *pComponents;
+	int pComponentCount;
+	int pLastReceiveSequence;
+	
 	debnStateLink *pPreviousLink;
 	debnStateLink *pNextLink;
 	
@@ -113,6 +124,44 @@ public:
 	
 	
 	
+	/** \name Delta Compression */
+	/*@{*/
+	/** \brief Create delta compression data if absent. */
+	void PrepareDelta( int componentCount );
+	
+	/** \brief Clear snapshots forcing the next update to be a full update. */
+	void ResetDelta();
+	
+	/** \brief Number of components or 0 if not prepared. */
+	inline int GetComponentCount() const{ return pComponentCount; }
+	
+	/** \brief Sent snapshots. */
+	inline debnDeltaSnapshots &GetSendSnapshots() const{ return *pSendSnapshots; }
+	
+	/** \brief Received snapshots. */
+	inline debnDeltaSnapshots &GetReceiveSnapshots() const{ return *pReceiveSnapshots; }
+	
+	/** \brief Quantization steps used for sending per value. */
+	inline float *GetSendSteps() const{ return pSendSteps; }
+	
+	/** \brief Quantization steps received with the last full update per value. */
+	inline float *GetReceiveSteps() const{ return pReceiveSteps; }
+	
+	/** \brief Components of the update written or read last. */
+	inline int64_t *GetComponents() const{ return pComponents; }
+	
+	/** \brief Store components as sent snapshot. */
+	void StoreSendSnapshot( int sequence );
+	
+	/** \brief Sequence of last applied update or -1. */
+	inline int GetLastReceiveSequence() const{ return pLastReceiveSequence; }
+	
+	/** \brief Set sequence of last applied update or -1. */
+	void SetLastReceiveSequence( int sequence );
+	/*@}*/
+	
+	
+	
 	/** \name Linked List ( for debnLinkQueue only ) */
 	/*@{*/
 	inline debnStateLink *GetPreviousLink() const{ return pPreviousLink; }
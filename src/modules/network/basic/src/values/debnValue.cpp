@@ -19,17 +19,27 @@
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "debnValue.h"
 #include "../deNetworkBasic.h"
+#include "../half/half.h"
 
 #include <dragengine/common/exceptions.h>
 
 
 
+// Definitions
+////////////////
+
+// largest quantized magnitude. keeps differences of quantized values inside 64 bit
+#define MAX_QUANTIZED 4611686018427387904.0
+
+
+
 // Class debnValue
 ////////////////////
 
@@ -55,3 +65,91 @@ void debnValue::SetDataType( eValueTypes dataType ){
 	
 	pDataType = dataType;
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+double debnValue::GetQuantizationStep() const{
+	return 0.0;
+}
+
+void debnValue::Dequantize( const int64_t*, double ){
+}
+
+bool debnValue::IsRaw() const{
+	return false;
+}
+
+const void *debnValue::GetRawData() const{
+	return NULL;
+}
+
+int debnValue::GetRawLength() const{
+	return 0;
+}
+
+void debnValue::SetRaw( const void*, int ){
+	DETHROW( deeInvalidAction );
+}
+
+int64_t debnValue::HashBytes( const void *data, int length ){
+	// FNV-1a
+	const uint8_t * const bytes = ( const uint8_t* )data;
+	uint64_t hash = 14695981039346656037ULL;
+	int i;
+	for( i=0; i<length; i++ ){
+		hash = ( hash ^ bytes[ i ] ) * 1099511628211ULL;
+	}
+	return ( int64_t )hash;
+}
+
+
+
+// Protected Functions
+////////////////////////
+
+double debnValue::QuantizationStep( double precision, int floatBits ){
+	double smallestStep;
+	
+	switch( floatBits ){
+	case 16:
+		return 0.0; // half float bits are exact
+		
+	case 32:
+		smallestStep = 1e-6;
+		break;
+		
+	default:
+		smallestStep = 1e-12;
+	}
+	
+	return precision > smallestStep ? precision : smallestStep;
+}
+
+int64_t debnValue::QuantizeFloat( double value, double step ){
+	if( step <= 0.0 ){
+		return floatToHalf( ( float )value );
+	}
+	
+	const double quantized = floor( value / step + 0.5 );
+	
+	if( quantized != quantized ){
+		return 0; // NaN
+	}
+	if( quantized >= MAX_QUANTIZED ){
+		return ( int64_t )MAX_QUANTIZED;
+	}
+	if( quantized <= -MAX_QUANTIZED ){
+		return -( int64_t )MAX_QUANTIZED;
+	}
+	return ( int64_t )quantized;
+}
+
+double debnValue::DequantizeFloat( int64_t quantized, double step ){
+	if( step <= 0.0 ){
+		return halfToFloat( ( uint16_t )quantized );
+	}
+	return ( double )quantized * step;
+}
@@ -22,6 +22,8 @@
 #ifndef _DEBNVALUE_H_
 #define _DEBNVALUE_H_
 
+#include <stdint.h>
+
 #include "../deNetworkBasic.h"
 
 class deNetworkMessage;
@@ -70,6 +72,67 @@ public:
 	/** \brief Write value to message. */
 	virtual void WriteValue( decBaseFileWriter &writer ) = 0;
 	/*@}*/
+	
+	
+	
+	/** \name Delta Compression */
+	/*@{*/
+	/** \brief Number of quantized components. */
+	virtual int GetComponentCount() const = 0;
+	
+	/**
+	 * \brief Quantization step of floating point components.
+	 * 
+	 * Returns 0 if components are exact. Half float values use 0 too since their bits
+	 * are quantized already.
+	 * 
+	 * Derived from the value precision. The remote side uses the step transmitted with
+	 * full updates since the precision is not shared between both sides.
+	 */
+	virtual double GetQuantizationStep() const;
+	
+	/**
+	 * \brief Quantize network value into components.
+	 * 
+	 * Raw values store a hash of their content to detect changes.
+	 */
+	virtual void Quantize( int64_t *components, double step ) const = 0;
+	
+	/** \brief Set network value from quantized components. Does nothing for raw values. */
+	virtual void Dequantize( const int64_t *components, double step );
+	
+	/** \brief Value is written raw instead of as delta compressed components. */
+	virtual bool IsRaw() const;
+	
+	/** \brief Raw value data. */
+	virtual const void *GetRawData() const;
+	
+	/** \brief Raw value length in bytes. */
+	virtual int GetRawLength() const;
+	
+	/** \brief Set network value from raw data. */
+	virtual void SetRaw( const void *data, int length );
+	
+	/** \brief Hash of raw content. */
+	static int64_t HashBytes( const void *data, int length );
+	/*@}*/
+	
+	
+	
+protected:
+	/**
+	 * \brief Quantization step for precision.
+	 * \param[in] precision Value precision.
+	 * \param[in] floatBits Size of floating point format (16, 32 or 64) limiting the smallest step.
+	 *                      Half floats return 0 to use the half float bits.
+	 */
+	static double QuantizationStep( double precision, int floatBits );
+	
+	/** \brief Quantize floating point value. If step is 0 the half float bits are used. */
+	static int64_t QuantizeFloat( double value, double step );
+	
+	/** \brief Dequantize floating point value. If step is 0 the half float bits are used. */
+	static double DequantizeFloat( int64_t quantized, double step );
 };
 
 #endif
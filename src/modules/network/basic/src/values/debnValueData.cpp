@@ -111,3 +111,36 @@ void debnValueData::WriteValue( decBaseFileWriter &writer ){
 	writer.WriteUShort( ( uint16_t )pValueData.GetLength() );
 	writer.Write( pValueData.GetData(), pValueData.GetLength() );
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueData::GetComponentCount() const{
+	return 1;
+}
+
+void debnValueData::Quantize( int64_t *components, double ) const{
+	components[ 0 ] = HashBytes( GetRawData(), GetRawLength() );
+}
+
+bool debnValueData::IsRaw() const{
+	return true;
+}
+
+const void *debnValueData::GetRawData() const{
+	return pValueData.GetData();
+}
+
+int debnValueData::GetRawLength() const{
+	return pValueData.GetLength();
+}
+
+void debnValueData::SetRaw( const void *data, int length ){
+	pValueData.SetLength( length );
+	if( length > 0 ){
+		memcpy( pValueData.GetData(), data, length );
+	}
+	SetLastValueFromNetworkValue();
+}
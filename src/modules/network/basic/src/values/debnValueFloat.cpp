@@ -119,3 +119,34 @@ void debnValueFloat::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueFloat::GetComponentCount() const{
+	return 1;
+}
+
+double debnValueFloat::GetQuantizationStep() const{
+	switch( GetDataType() ){
+	case evtFloat32:
+		return QuantizationStep( pValueFloat.GetPrecision(), 32 );
+		
+	case evtFloat64:
+		return QuantizationStep( pValueFloat.GetPrecision(), 64 );
+		
+	default:
+		return QuantizationStep( pValueFloat.GetPrecision(), 16 );
+	}
+}
+
+void debnValueFloat::Quantize( int64_t *components, double step ) const{
+	components[ 0 ] = QuantizeFloat( pValueFloat.GetFloat(), step );
+}
+
+void debnValueFloat::Dequantize( const int64_t *components, double step ){
+	pLastValue = DequantizeFloat( components[ 0 ], step );
+	pValueFloat.SetFloat( pLastValue );
+}
@@ -177,3 +177,21 @@ void debnValueInteger::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueInteger::GetComponentCount() const{
+	return 1;
+}
+
+void debnValueInteger::Quantize( int64_t *components, double ) const{
+	components[ 0 ] = pValueInt.GetInt();
+}
+
+void debnValueInteger::Dequantize( const int64_t *components, double ){
+	pLastValue = components[ 0 ];
+	pValueInt.SetInt( pLastValue );
+}
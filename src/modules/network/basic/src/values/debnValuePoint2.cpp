@@ -195,3 +195,24 @@ void debnValuePoint2::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValuePoint2::GetComponentCount() const{
+	return 2;
+}
+
+void debnValuePoint2::Quantize( int64_t *components, double ) const{
+	const decPoint &point = pValuePoint2.GetPoint();
+	components[ 0 ] = point.x;
+	components[ 1 ] = point.y;
+}
+
+void debnValuePoint2::Dequantize( const int64_t *components, double ){
+	pLastValue.x = ( int )components[ 0 ];
+	pLastValue.y = ( int )components[ 1 ];
+	pValuePoint2.SetPoint( pLastValue );
+}
@@ -68,6 +68,20 @@ public:
 	/** \brief Write value to message. */
 	virtual void WriteValue( decBaseFileWriter &writer );
 	/*@}*/
+	
+	
+	
+	/** \name Delta Compression */
+	/*@{*/
+	/** \brief Number of quantized components. */
+	virtual int GetComponentCount() const;
+	
+	/** \brief Quantize network value into components. */
+	virtual void Quantize( int64_t *components, double step ) const;
+	
+	/** \brief Set network value from quantized components. */
+	virtual void Dequantize( const int64_t *components, double step );
+	/*@}*/
 };
 
 #endif
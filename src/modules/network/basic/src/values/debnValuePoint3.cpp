@@ -211,3 +211,26 @@ void debnValuePoint3::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValuePoint3::GetComponentCount() const{
+	return 3;
+}
+
+void debnValuePoint3::Quantize( int64_t *components, double ) const{
+	const decPoint3 &point = pValuePoint3.GetPoint();
+	components[ 0 ] = point.x;
+	components[ 1 ] = point.y;
+	components[ 2 ] = point.z;
+}
+
+void debnValuePoint3::Dequantize( const int64_t *components, double ){
+	pLastValue.x = ( int )components[ 0 ];
+	pLastValue.y = ( int )components[ 1 ];
+	pLastValue.z = ( int )components[ 2 ];
+	pValuePoint3.SetPoint( pLastValue );
+}
@@ -19,6 +19,7 @@
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -138,3 +139,70 @@ void debnValueQuaternion::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueQuaternion::GetComponentCount() const{
+	return 4;
+}
+
+double debnValueQuaternion::GetQuantizationStep() const{
+	switch( GetDataType() ){
+	case evtQuaternionF32:
+		return QuantizationStep( pValueQuat.GetPrecision(), 32 );
+		
+	case evtQuaternionF64:
+		return QuantizationStep( pValueQuat.GetPrecision(), 64 );
+		
+	default:
+		return QuantizationStep( pValueQuat.GetPrecision(), 16 );
+	}
+}
+
+void debnValueQuaternion::Quantize( int64_t *components, double step ) const{
+	// smallest three. the largest component is dropped and restored from the unit length.
+	// the quaternion is negated if required to make the largest component positive since
+	// q and -q are the same rotation
+	const decQuaternion &quaternion = pValueQuat.GetQuaternion();
+	const double values[ 4 ] = { quaternion.x, quaternion.y, quaternion.z, quaternion.w };
+	int i, largest = 0;
+	
+	for( i=1; i<4; i++ ){
+		if( fabs( values[ i ] ) > fabs( values[ largest ] ) ){
+			largest = i;
+		}
+	}
+	
+	const double sign = values[ largest ] < 0.0 ? -1.0 : 1.0;
+	int next = 1;
+	
+	components[ 0 ] = largest;
+	for( i=0; i<4; i++ ){
+		if( i != largest ){
+			components[ next++ ] = QuantizeFloat( values[ i ] * sign, step );
+		}
+	}
+}
+
+void debnValueQuaternion::Dequantize( const int64_t *components, double step ){
+	const int largest = ( int )( components[ 0 ] & 3 );
+	double values[ 4 ], squareSum = 0.0;
+	int i, next = 1;
+	
+	for( i=0; i<4; i++ ){
+		if( i != largest ){
+			values[ i ] = DequantizeFloat( components[ next++ ], step );
+			squareSum += values[ i ] * values[ i ];
+		}
+	}
+	values[ largest ] = squareSum < 1.0 ? sqrt( 1.0 - squareSum ) : 0.0;
+	
+	pLastValue.x = ( float )values[ 0 ];
+	pLastValue.y = ( float )values[ 1 ];
+	pLastValue.z = ( float )values[ 2 ];
+	pLastValue.w = ( float )values[ 3 ];
+	pValueQuat.SetQuaternion( pLastValue );
+}
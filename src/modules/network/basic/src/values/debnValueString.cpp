@@ -72,3 +72,39 @@ void debnValueString::ReadValue( decBaseFileReader &reader ){
 void debnValueString::WriteValue( decBaseFileWriter &writer ){
 	writer.WriteString16( pValueString.GetString() );
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueString::GetComponentCount() const{
+	return 1;
+}
+
+void debnValueString::Quantize( int64_t *components, double ) const{
+	components[ 0 ] = HashBytes( GetRawData(), GetRawLength() );
+}
+
+bool debnValueString::IsRaw() const{
+	return true;
+}
+
+const void *debnValueString::GetRawData() const{
+	return pValueString.GetString().GetString();
+}
+
+int debnValueString::GetRawLength() const{
+	return pValueString.GetString().GetLength();
+}
+
+void debnValueString::SetRaw( const void *data, int length ){
+	if( length > 0 ){
+		pLastValue.Set( ' ', length );
+		memcpy( &pLastValue[ 0 ], data, length );
+		
+	}else{
+		pLastValue.Empty();
+	}
+	pValueString.SetString( pLastValue );
+}
@@ -65,6 +65,29 @@ public:
 	/** \brief Write value to message. */
 	virtual void WriteValue( decBaseFileWriter &writer );
 	/*@}*/
+	
+	
+	
+	/** \name Delta Compression */
+	/*@{*/
+	/** \brief Number of quantized components. */
+	virtual int GetComponentCount() const;
+	
+	/** \brief Quantize network value into content hash. */
+	virtual void Quantize( int64_t *components, double step ) const;
+	
+	/** \brief Value is written raw. */
+	virtual bool IsRaw() const;
+	
+	/** \brief Raw value data. */
+	virtual const void *GetRawData() const;
+	
+	/** \brief Raw value length in bytes. */
+	virtual int GetRawLength() const;
+	
+	/** \brief Set network value from raw data. */
+	virtual void SetRaw( const void *data, int length );
+	/*@}*/
 };
 
 #endif
@@ -126,3 +126,37 @@ void debnValueVector2::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueVector2::GetComponentCount() const{
+	return 2;
+}
+
+double debnValueVector2::GetQuantizationStep() const{
+	switch( GetDataType() ){
+	case evtVector2F32:
+		return QuantizationStep( pValueVector2.GetPrecision(), 32 );
+		
+	case evtVector2F64:
+		return QuantizationStep( pValueVector2.GetPrecision(), 64 );
+		
+	default:
+		return QuantizationStep( pValueVector2.GetPrecision(), 16 );
+	}
+}
+
+void debnValueVector2::Quantize( int64_t *components, double step ) const{
+	const decVector2 &vector = pValueVector2.GetVector();
+	components[ 0 ] = QuantizeFloat( vector.x, step );
+	components[ 1 ] = QuantizeFloat( vector.y, step );
+}
+
+void debnValueVector2::Dequantize( const int64_t *components, double step ){
+	pLastValue.x = ( float )DequantizeFloat( components[ 0 ], step );
+	pLastValue.y = ( float )DequantizeFloat( components[ 1 ], step );
+	pValueVector2.SetVector( pLastValue );
+}
@@ -132,3 +132,39 @@ void debnValueVector3::WriteValue( decBaseFileWriter &writer ){
 		break;
 	}
 }
+
+
+
+// Delta Compression
+//////////////////////
+
+int debnValueVector3::GetComponentCount() const{
+	return 3;
+}
+
+double debnValueVector3::GetQuantizationStep() const{
+	switch( GetDataType() ){
+	case evtVector3F32:
+		return QuantizationStep( pValueVector3.GetPrecision(), 32 );
+		
+	case evtVector3F64:
+		return QuantizationStep( pValueVector3.GetPrecision(), 64 );
+		
+	default:
+		return QuantizationStep( pValueVector3.GetPrecision(), 16 );
+	}
+}
+
+void debnValueVector3::Quantize( int64_t *components, double step ) const{
+	const decDVector &vector = pValueVector3.GetVector();
+	components[ 0 ] = QuantizeFloat( vector.x, step );
+	components[ 1 ] = QuantizeFloat( vector.y, step );
+	components[ 2 ] = QuantizeFloat( vector.z, step );
+}
+
+void debnValueVector3::Dequantize( const int64_t *components, double step ){
+	pLastValue.x = DequantizeFloat( components[ 0 ], step );
+	pLastValue.y = DequantizeFloat( components[ 1 ], step );
+	pLastValue.z = DequantizeFloat( components[ 2 ], step );
+	pValueVector3.SetVector( pLastValue );
+}
@@ -30,7 +30,6 @@
 #include "../collider/debpColliderVolume.h"
 #include "../component/debpComponent.h"
 #include "../component/debpModel.h"
-#include "../component/debpModelOctree.h"
 #include "../shape/debpShape.h"
 #include "../shape/debpShapeList.h"
 
@@ -106,41 +105,38 @@ void debpCDVHitModelFace::SetTestCollider( debpCollider *collider ){
 // Visiting
 /////////////
 
-void debpCDVHitModelFace::VisitNode( debpDOctree *node, int intersection ){
-	if( ! pHasCollision ){
-		const debpModelOctree &rnode = *( ( debpModelOctree* )node );
-		int f, faceIndex, faceCount = rnode.GetFaceCount();
+void debpCDVHitModelFace::VisitFaces( const int *faces, int count ){
+	if( pHasCollision ){
+		return;
+	}
+	
+	int f;
+	
+	if( pShape ){
+		for( f=0; f<count; f++ ){
+			if( pColDet->ShapeHitsModelFace( *pShape, *pComponent, faces[ f ] ) ){
+				pResult.shape1 = 0;
+				pResult.face = faces[ f ];
+				pHasCollision = true;
+				break;
+			}
+		}
+		
+	}else if( pColliderVolume ){
+		const debpShapeList &shapes = pColliderVolume->GetShapes();
+		int s, shapeCount = shapes.GetShapeCount();
 		
-		if( pShape ){
-			for( f=0; f<faceCount; f++ ){
-				faceIndex = rnode.GetFaceAt( f );
-				
-				if( pColDet->ShapeHitsModelFace( *pShape, *pComponent, faceIndex ) ){
-					pResult.shape1 = 0;
-					pResult.face = faceIndex;
+		for( s=0; s<shapeCount; s++ ){
+			debpShape &shape = *shapes.GetShapeAt( s );
+			
+			for( f=0; f<count; f++ ){
+				if( pColDet->ShapeHitsModelFace( shape, *pComponent, faces[ f ] ) ){
+					pResult.shape1 = s;
+					pResult.face = faces[ f ];
 					pHasCollision = true;
 					break;
 				}
 			}
-			
-		}else if( pColliderVolume ){
-			const debpShapeList &shapes = pColliderVolume->GetShapes();
-			int s, shapeCount = shapes.GetShapeCount();
-			
-			for( s=0; s<shapeCount; s++ ){
-				debpShape &shape = *shapes.GetShapeAt( s );
-				
-				for( f=0; f<faceCount; f++ ){
-					faceIndex = rnode.GetFaceAt( f );
-					
-					if( pColDet->ShapeHitsModelFace( shape, *pComponent, faceIndex ) ){
-						pResult.shape1 = s;
-						pResult.face = faceIndex;
-						pHasCollision = true;
-						break;
-					}
-				}
-			}
 		}
 	}
 }
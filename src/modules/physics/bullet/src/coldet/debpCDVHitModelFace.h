@@ -26,7 +26,7 @@
 // includes
 #include <dragengine/common/math/decMath.h>
 #include "debpCollisionDetection.h"
-#include "octree/debpDOctreeVisitor.h"
+#include "../component/debpModelBVHVisitor.h"
 
 // predefinitions
 class debpShape;
@@ -42,7 +42,7 @@ class debpColliderComponent;
  * Visitor for the collision detection class to test for collision of
  * one or more shapes with faces of a model.
  */
-class debpCDVHitModelFace : public debpDOctreeVisitor{
+class debpCDVHitModelFace : public debpModelBVHVisitor{
 private:
 	debpCollisionDetection *pColDet;
 	
@@ -83,8 +83,8 @@ public:
 	
 	/** @name Visiting */
 	/*@{*/
-	/** Visit a node. */
-	virtual void VisitNode( debpDOctree *node, int intersection );
+	/** Visit faces of a BVH leaf node. */
+	virtual void VisitFaces( const int *faces, int count );
 	/*@}*/
 };
 
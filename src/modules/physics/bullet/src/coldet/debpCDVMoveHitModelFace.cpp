@@ -29,7 +29,6 @@
 #include "../collider/debpCollider.h"
 #include "../component/debpComponent.h"
 #include "../component/debpModel.h"
-#include "../component/debpModelOctree.h"
 #include "../shape/debpShape.h"
 #include "../shape/debpShapeList.h"
 
@@ -92,13 +91,12 @@ void debpCDVMoveHitModelFace::SetTestCollider( debpCollider *collider, const dec
 // Visiting
 /////////////
 
-void debpCDVMoveHitModelFace::VisitNode( debpDOctree *node, int intersection ){
-	const debpModelOctree &rnode = *( ( debpModelOctree* )node );
-	int f, faceIndex, faceCount = rnode.GetFaceCount();
+void debpCDVMoveHitModelFace::VisitFaces( const int *faces, int count ){
+	int f, faceIndex;
 	
 	if( pShape ){
-		for( f=0; f<faceCount; f++ ){
-			faceIndex = rnode.GetFaceAt( f );
+		for( f=0; f<count; f++ ){
+			faceIndex = faces[ f ];
 			
 			if( pColDet->ShapeMoveHitsModelFace( *pShape, pDirection, *pComponent, faceIndex, pResultTest ) ){
 				if( ! pHasCollision || pResultTest.distance < pResultFinal.distance ){
@@ -114,8 +112,8 @@ void debpCDVMoveHitModelFace::VisitNode( debpDOctree *node, int intersection ){
 		}
 		
 	}else if( pCollider ){
-		for( f=0; f<faceCount; f++ ){
-			faceIndex = rnode.GetFaceAt( f );
+		for( f=0; f<count; f++ ){
+			faceIndex = faces[ f ];
 			
 			if( pColDet->ColliderMoveHitsModelFace( pCollider, pDirection, *pComponent, faceIndex, pResultTest ) ){
 				if( ! pHasCollision || pResultTest.distance < pResultFinal.distance ){
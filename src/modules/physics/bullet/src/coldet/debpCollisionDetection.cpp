@@ -43,7 +43,7 @@
 #include "../collider/debpColliderRig.h"
 #include "../component/debpModel.h"
 #include "../component/debpComponent.h"
-#include "../component/debpModelOctree.h"
+#include "../component/debpModelBVH.h"
 #include "../terrain/heightmap/debpHeightTerrain.h"
 #include "../terrain/heightmap/debpHTSector.h"
 #include "../shape/debpShape.h"
@@ -1653,7 +1653,8 @@ bool debpCollisionDetection::ShapeHitsColliderComponent( debpShape &shape, debpC
 		visitor.SetTestShape( shape );
 		
 		shape->GetCollisionVolume()->GetEnclosingBox( &box );
-		( ( debpModel* )component->GetModel()->GetPeerPhysics() )->GetOctree()->VisitNodesColliding( &visitor, &box );
+		( ( debpModel* )component->GetModel()->GetPeerPhysics() )->GetBVH()->VisitFaces( visitor,
+			decVector( box.GetCenter() - box.GetHalfSize() ), decVector( box.GetCenter() + box.GetHalfSize() ) );
 		
 		if( visitor.HasCollision() ){
 			result.face = visitor.GetResult().face;
@@ -1892,7 +1893,6 @@ debpColliderComponent &collider2, debpCollisionResult &result ){
 			collider1.GetParentWorld(), &collider1, collider2.GetColliderComponent()->GetComponent()->GetModel()
 				? collider2.GetColliderComponent()->GetComponent()->GetModel()->GetFilename() : "-" ) );
 		debpCDVHitModelFace visitor( this );
-		debpDCollisionBox box;
 		
 		component.PrepareMesh();
 		
@@ -1901,8 +1901,8 @@ debpColliderComponent &collider2, debpCollisionResult &result ){
 		visitor.SetComponent( &component );
 		visitor.SetTestCollider( &collider1 );
 		
-		box.SetFromExtends( collider1.GetShapeMinimumExtend(), collider1.GetShapeMaximumExtend() );
-		component.GetModel()->GetOctree()->VisitNodesColliding( &visitor, &box );
+		component.GetModel()->GetBVH()->VisitFaces( visitor,
+			decVector( collider1.GetShapeMinimumExtend() ), decVector( collider1.GetShapeMaximumExtend() ) );
 		
 		if( visitor.HasCollision() ){
 			debpCollisionResult &vresult = visitor.GetResult();
@@ -2194,7 +2194,8 @@ const decDVector &displacement, debpColliderComponent &collider2, debpCollisionR
 		visitor.SetTestCollider( &collider1, localdisp );
 		
 		GetColliderMoveBoundingBox( collider1, localdisp, box );
-		( ( debpModel* )engComponent.GetModel()->GetPeerPhysics() )->GetOctree()->VisitNodesColliding( &visitor, &box );
+		( ( debpModel* )engComponent.GetModel()->GetPeerPhysics() )->GetBVH()->VisitFaces( visitor,
+			decVector( box.GetCenter() - box.GetHalfSize() ), decVector( box.GetCenter() + box.GetHalfSize() ) );
 		
 		if( visitor.HasCollision() ){
 			const debpCollisionResult &vresult = visitor.GetResult();
@@ -2476,7 +2477,8 @@ debpColliderComponent &collider2, debpCollisionResult &result ){
 			visitor.SetTestCollider( &collider1, displacement );
 			
 			GetColliderMoveBoundingBox( collider1, displacement, box );
-			( ( debpModel* )engComponent.GetModel()->GetPeerPhysics() )->GetOctree()->VisitNodesColliding( &visitor, &box );
+			( ( debpModel* )engComponent.GetModel()->GetPeerPhysics() )->GetBVH()->VisitFaces( visitor,
+				decVector( box.GetCenter() - box.GetHalfSize() ), decVector( box.GetCenter() + box.GetHalfSize() ) );
 			
 			collider1.UpdateShapes();
 			
@@ -2464,10 +2464,10 @@ void debpColliderComponent::pUpdateBones(){
 		}
 	}
 	
-	// prepare model octree if required
+	// prepare model BVH if required
 	if( pTestMode == etmModelStatic || pTestMode == etmModelDynamic ){
 		if( model ){
-			model->PrepareOctree();
+			model->PrepareBVH();
 		}
 	}
 	
@@ -24,6 +24,7 @@
 
 #include "debpModel.h"
 #include "debpComponent.h"
+#include "debpComponentSkinningTask.h"
 #include "../dePhysicsBullet.h"
 #include "../coldet/collision/debpDCollisionVolume.h"
 #include "../decal/debpDecal.h"
@@ -33,6 +34,8 @@
 
 #include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
+#include <dragengine/common/math/decSkinning.h>
 #include <dragengine/common/shape/decShape.h>
 #include <dragengine/parallel/deParallelProcessing.h>
 #include <dragengine/resources/component/deComponent.h>
@@ -46,6 +49,15 @@
 #include <dragengine/resources/model/deModelWeight.h>
 #include <dragengine/resources/rig/deRig.h>
 #include <dragengine/resources/rig/deRigBone.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+
+
+
+// Definitions
+////////////////
+
+// minimum number of vertices before skinning is split into parallel tasks
+#define PARALLEL_SKINNING_VERTEX_COUNT 4096
 
 
 
@@ -262,18 +274,65 @@ void debpComponent::PrepareMesh(){
 	
 	PrepareWeights();
 	
-	const deModelLOD &lod = *pComponent->GetModel()->GetLODAt( 0 );
-	int i;
+	if( pVertexCount == 0 ){
+		pDirtyMesh = false;
+		return;
+	}
+	
+	pModel->PrepareSkinning();
+	const decSkinning &skinning = *pModel->GetSkinning();
+	const float * const weights = pWeights ? &pWeights[ 0 ].a11 : NULL;
+	const int weightStride = sizeof( decMatrix ) / sizeof( float );
+	float * const vertices = &pVertices[ 0 ].x;
+	const int vertexStride = sizeof( decVector ) / sizeof( float );
+	
+	// large meshes are split into chunks of sorted vertices skinned using parallel tasks.
+	// chunks write to disjoint vertices. failed chunks are skinned again afterwards
+	deParallelProcessing &parallelProcessing = pBullet.GetGameEngine()->GetParallelProcessing();
+	
+	if( pVertexCount < PARALLEL_SKINNING_VERTEX_COUNT
+	|| parallelProcessing.GetCoreCount() < 2 || parallelProcessing.GetPaused() ){
+		skinning.Transform( weights, weightStride, vertices, vertexStride );
+		pDirtyMesh = false;
+		return;
+	}
 	
-	for( i=0; i<pVertexCount; i++ ){
-		const deModelVertex &vertex = lod.GetVertexAt( i );
-		const int weightSet = vertex.GetWeightSet();
+	const int chunkCount = decMath::min( parallelProcessing.GetCoreCount(),
+		pVertexCount / PARALLEL_SKINNING_VERTEX_COUNT + 1 );
+	const int chunkSize = ( pVertexCount - 1 ) / chunkCount + 1;
+	decThreadSafeObjectOrderedSet tasks;
+	deThreadSafeObjectReference task;
+	int i, first;
+	
+	try{
+		// the last chunk is skinned on the calling thread while the tasks run
+		for( first=0; first+chunkSize<pVertexCount; first+=chunkSize ){
+			task.TakeOver( new debpComponentSkinningTask( pBullet, skinning,
+				pWeights, pVertices, first, chunkSize ) );
+			tasks.Add( task );
+			parallelProcessing.AddTask( ( debpComponentSkinningTask* )( deThreadSafeObject* )task );
+		}
 		
-		if( weightSet == -1 ){
-			pVertices[ i ] = vertex.GetPosition();
-			
-		}else{
-			pVertices[ i ] = pWeights[ weightSet ] * vertex.GetPosition();
+		skinning.Transform( weights, weightStride, vertices, vertexStride, first, pVertexCount - first );
+		
+	}catch( const deException & ){
+		const int count = tasks.GetCount();
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( debpComponentSkinningTask* )tasks.GetAt( i ) );
+		}
+		throw;
+	}
+	
+	const int count = tasks.GetCount();
+	for( i=0; i<count; i++ ){
+		parallelProcessing.WaitForTask( ( debpComponentSkinningTask* )tasks.GetAt( i ) );
+	}
+	
+	for( i=0; i<count; i++ ){
+		const debpComponentSkinningTask &skinningTask = *( ( debpComponentSkinningTask* )tasks.GetAt( i ) );
+		if( skinningTask.GetFailed() ){
+			skinning.Transform( weights, weightStride, vertices, vertexStride,
+				skinningTask.GetFirst(), skinningTask.GetCount() );
 		}
 	}
 	
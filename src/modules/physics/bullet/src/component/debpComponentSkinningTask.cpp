@@ -0,0 +1,83 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "debpComponentSkinningTask.h"
+#include "../dePhysicsBullet.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decSkinning.h>
+
+
+
+// Class debpComponentSkinningTask
+////////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+debpComponentSkinningTask::debpComponentSkinningTask( dePhysicsBullet &bullet,
+const decSkinning &skinning, const decMatrix *weights, decVector *vertices, int first, int count ) :
+deParallelTask( &bullet ),
+pSkinning( skinning ),
+pWeights( weights ),
+pVertices( vertices ),
+pFirst( first ),
+pCount( count ),
+pFailed( false ){
+}
+
+debpComponentSkinningTask::~debpComponentSkinningTask(){
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void debpComponentSkinningTask::Run(){
+	try{
+		pSkinning.Transform( pWeights ? &pWeights[ 0 ].a11 : NULL, sizeof( decMatrix ) / sizeof( float ),
+			&pVertices[ 0 ].x, sizeof( decVector ) / sizeof( float ), pFirst, pCount );
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void debpComponentSkinningTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString debpComponentSkinningTask::GetDebugName() const{
+	return "Bullet:ComponentSkinning";
+}
+
+decString debpComponentSkinningTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "first=%d count=%d", pFirst, pCount );
+	return details;
+}
@@ -0,0 +1,108 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBPCOMPONENTSKINNINGTASK_H_
+#define _DEBPCOMPONENTSKINNINGTASK_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/parallel/deParallelTask.h>
+
+class dePhysicsBullet;
+class decSkinning;
+
+
+
+/**
+ * \brief Parallel task skinning a chunk of component vertices.
+ * 
+ * Transforms a range of sorted vertices of the model skinning kernel. Chunks write to
+ * disjoint vertices hence tasks of the same component can run concurrently. If an
+ * exception is thrown the task is marked failed and the caller has to skin the chunk.
+ */
+class debpComponentSkinningTask : public deParallelTask{
+private:
+	const decSkinning &pSkinning;
+	const decMatrix *pWeights;
+	decVector *pVertices;
+	int pFirst;
+	int pCount;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create task.
+	 * \param[in] skinning Skinning kernel. Has to stay valid until the task finished.
+	 * \param[in] weights Weight matrices. Have to stay valid until the task finished.
+	 * \param[out] vertices Vertices to write. Have to stay valid until the task finished.
+	 * \param[in] first Index of first sorted vertex.
+	 * \param[in] count Number of sorted vertices.
+	 */
+	debpComponentSkinningTask( dePhysicsBullet &bullet, const decSkinning &skinning,
+		const decMatrix *weights, decVector *vertices, int first, int count );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~debpComponentSkinningTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Index of first sorted vertex. */
+	inline int GetFirst() const{ return pFirst; }
+	
+	/** \brief Number of sorted vertices. */
+	inline int GetCount() const{ return pCount; }
+	
+	/** \brief Skinning failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
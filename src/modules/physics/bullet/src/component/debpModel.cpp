@@ -24,11 +24,17 @@
 
 #include "debpBulletShapeModel.h"
 #include "debpModel.h"
-#include "debpModelOctree.h"
+#include "debpModelBVH.h"
 #include "../dePhysicsBullet.h"
-#include "../coldet/octree/debpDefaultDOctree.h"
 
+#include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/common/file/decBaseFileWriter.h>
+#include <dragengine/common/file/decPath.h>
+#include <dragengine/common/math/decSkinning.h>
+#include <dragengine/filesystem/deCacheHelper.h>
+#include <dragengine/filesystem/deVirtualFileSystem.h>
 #include <dragengine/resources/model/deModel.h>
 #include <dragengine/resources/model/deModelBone.h>
 #include <dragengine/resources/model/deModelFace.h>
@@ -42,6 +48,14 @@
 
 
 
+// Definitions
+////////////////
+
+// version of the cached face BVH. increment if the file format changes
+#define CACHE_VERSION 1
+
+
+
 // Class debpModel
 ////////////////////
 
@@ -52,11 +66,12 @@ debpModel::debpModel( dePhysicsBullet &bullet, deModel &model ) :
 pBullet( bullet ),
 pModel( model ),
 
-pOctree( NULL ),
+pBVH( NULL ),
 pCanDeform( false ),
 
 pWeightSets( NULL ),
 pWeightSetCount( 0 ),
+pSkinning( NULL ),
 pHasWeightlessExtends( false ),
 pBoneExtends( NULL ),
 pBoneCount( 0 ),
@@ -65,8 +80,6 @@ pFaceProbabilities( NULL ),
 
 pBulletShape( NULL )
 {
-	(void)pBullet;
-	
 	try{
 		pCheckCanDeform();
 		pCalculateExtends();
@@ -86,37 +99,98 @@ debpModel::~debpModel(){
 // Management
 ///////////////
 
-void debpModel::PrepareOctree(){
-	if( pOctree ){
+void debpModel::PrepareBVH(){
+	if( pBVH ){
 		return;
 	}
 	
 	// NOTE if model data has been released RetainModelData() is required to be called first
 	
-	const deModelLOD &lod = *pModel.GetLODAt( 0 );
-	const decVector offset( 0.01f, 0.01f, 0.01f );
-	const decVector minExtend( pExtends.minimum - offset );
-	const decVector maxExtend( pExtends.maximum + offset );
-	const int faceCount = lod.GetFaceCount();
-	int i;
+	pBVH = new debpModelBVH;
 	
-	pOctree = new debpModelOctree( ( minExtend + maxExtend ) * 0.5f, ( maxExtend - minExtend ) * 0.5f );
-	
-	for( i=0; i<faceCount; i++ ){
-		const deModelFace &face = lod.GetFaceAt( i );
+	try{
+		if( pLoadCachedBVH() ){
+			return;
+		}
 		
-		const deModelVertex &v1 = lod.GetVertexAt( face.GetVertex1() );
-		const deModelVertex &v2 = lod.GetVertexAt( face.GetVertex2() );
-		const deModelVertex &v3 = lod.GetVertexAt( face.GetVertex3() );
+		const deModelLOD &lod = *pModel.GetLODAt( 0 );
+		const int vertexCount = lod.GetVertexCount();
+		const int faceCount = lod.GetFaceCount();
+		decVector *vertices = NULL;
+		int *faces = NULL;
+		int i, j;
 		
-		const decVector &posV1 = v1.GetPosition();
-		const decVector &posV2 = v2.GetPosition();
-		const decVector &posV3 = v3.GetPosition();
+		try{
+			if( vertexCount > 0 ){
+				vertices = new decVector[ vertexCount ];
+				for( i=0; i<vertexCount; i++ ){
+					vertices[ i ] = lod.GetVertexAt( i ).GetPosition();
+				}
+			}
+			
+			if( faceCount > 0 ){
+				faces = new int[ faceCount * 3 ];
+				for( j=0, i=0; i<faceCount; i++ ){
+					const deModelFace &face = lod.GetFaceAt( i );
+					faces[ j++ ] = face.GetVertex1();
+					faces[ j++ ] = face.GetVertex2();
+					faces[ j++ ] = face.GetVertex3();
+				}
+			}
+			
+			pBVH->Build( vertices, vertexCount, faces, faceCount );
+			
+			if( faces ){
+				delete [] faces;
+			}
+			if( vertices ){
+				delete [] vertices;
+			}
+			
+		}catch( const deException & ){
+			if( faces ){
+				delete [] faces;
+			}
+			if( vertices ){
+				delete [] vertices;
+			}
+			throw;
+		}
+		
+		pSaveCachedBVH();
 		
-		const decVector faceMinExtend( posV1.Smallest( posV2 ).Smallest( posV3 ) );
-		const decVector faceMaxExtend( posV1.Largest( posV2 ).Largest( posV3 ) );
+	}catch( const deException & ){
+		delete pBVH;
+		pBVH = NULL;
+		throw;
+	}
+}
+
+void debpModel::PrepareSkinning(){
+	if( pSkinning ){
+		return;
+	}
+	
+	// NOTE if model data has been released RetainModelData() is required to be called first
+	
+	const deModelLOD &lod = *pModel.GetLODAt( 0 );
+	const int vertexCount = lod.GetVertexCount();
+	int i;
+	
+	pSkinning = new decSkinning;
+	
+	try{
+		pSkinning->SetVertexCount( vertexCount );
+		for( i=0; i<vertexCount; i++ ){
+			const deModelVertex &vertex = lod.GetVertexAt( i );
+			pSkinning->SetVertexAt( i, vertex.GetPosition(), vertex.GetWeightSet() );
+		}
+		pSkinning->Prepare();
 		
-		pOctree->InsertFaceIntoTree( i, ( faceMinExtend + faceMaxExtend ) * 0.5f, ( faceMaxExtend - faceMinExtend ) * 0.5f );
+	}catch( const deException & ){
+		delete pSkinning;
+		pSkinning = NULL;
+		throw;
 	}
 }
 
@@ -297,11 +371,14 @@ void debpModel::pCleanUp(){
 	if( pNormals ){
 		delete [] pNormals;
 	}
+	if( pSkinning ){
+		delete pSkinning;
+	}
 	if( pWeightSets ){
 		delete [] pWeightSets;
 	}
-	if( pOctree ){
-		delete pOctree;
+	if( pBVH ){
+		delete pBVH;
 	}
 }
 
@@ -435,3 +512,97 @@ void debpModel::pCalculateExtends(){
 	delete [] boneHasExtends;
 	delete [] dominatingBones;
 }
+
+bool debpModel::pLoadCachedBVH(){
+	const decString &filename = pModel.GetFilename();
+	if( filename.IsEmpty() ){
+		return false;
+	}
+	
+	deVirtualFileSystem &vfs = *pBullet.GetGameEngine()->GetVirtualFileSystem();
+	const decPath path( decPath::CreatePathUnix( filename ) );
+	if( ! vfs.CanReadFile( path ) ){
+		return false; // without a source file no cache since it is no more unique
+	}
+	
+	deCacheHelper &cacheModels = pBullet.GetCacheModels();
+	decBaseFileReader *reader = NULL;
+	
+	try{
+		reader = cacheModels.Read( filename );
+		if( ! reader ){
+			return false;
+		}
+		
+		// check cache version in case we upgraded
+		if( reader->ReadByte() != CACHE_VERSION ){
+			reader->FreeReference();
+			reader = NULL;
+			cacheModels.Delete( filename );
+			pBullet.LogInfoFormat( "Model '%s': Cache version changed. Cache discarded", filename.GetString() );
+			return false;
+		}
+		
+		// check file modification times to reject the cached file if the source model changed
+		const TIME_SYSTEM checkTime = ( TIME_SYSTEM )reader->ReadUInt();
+		if( vfs.GetFileModificationTime( path ) != checkTime ){
+			reader->FreeReference();
+			reader = NULL;
+			cacheModels.Delete( filename );
+			pBullet.LogInfoFormat( "Model '%s': Modification time changed. Cache discarded", filename.GetString() );
+			return false;
+		}
+		
+		pBVH->Load( *reader, pModel.GetLODAt( 0 )->GetFaceCount() );
+		
+		reader->FreeReference();
+		reader = NULL;
+		
+	}catch( const deException &e ){
+		if( reader ){
+			reader->FreeReference();
+		}
+		cacheModels.Delete( filename );
+		pBullet.LogErrorFormat( "Model '%s': Loading cache failed. Cache discarded", filename.GetString() );
+		pBullet.LogException( e );
+		pBVH->Clear();
+		return false;
+	}
+	
+	return true;
+}
+
+void debpModel::pSaveCachedBVH(){
+	const decString &filename = pModel.GetFilename();
+	if( filename.IsEmpty() ){
+		return;
+	}
+	
+	deVirtualFileSystem &vfs = *pBullet.GetGameEngine()->GetVirtualFileSystem();
+	const decPath path( decPath::CreatePathUnix( filename ) );
+	if( ! vfs.CanReadFile( path ) ){
+		return; // without a source file no cache since it is no more unique
+	}
+	
+	deCacheHelper &cacheModels = pBullet.GetCacheModels();
+	decBaseFileWriter *writer = NULL;
+	
+	try{
+		writer = cacheModels.Write( filename );
+		
+		writer->WriteByte( CACHE_VERSION );
+		writer->WriteUInt( ( unsigned int )vfs.GetFileModificationTime( path ) );
+		pBVH->Save( *writer );
+		
+		writer->FreeReference();
+		writer = NULL;
+		
+	}catch( const deException &e ){
+		if( writer ){
+			writer->FreeReference();
+		}
+		cacheModels.Delete( filename );
+		pBullet.LogErrorFormat( "Model '%s': Writing cache failed", filename.GetString() );
+		pBullet.LogException( e );
+	}
+}
@@ -28,7 +28,8 @@
 
 class deModel;
 class deModelWeight;
-class debpModelOctree;
+class decSkinning;
+class debpModelBVH;
 class dePhysicsBullet;
 class debpBulletShapeModel;
 
@@ -37,7 +38,7 @@ class debpBulletShapeModel;
  * \brief Bullet Physics Model Peer
  * 
  * The peer for model resources in the ODE Physics Module. The main
- * purpose of this class is to provide an octree of faces for quick
+ * purpose of this class is to provide a BVH of faces for quick
  * collision detection if the model is a simple model. Complex models
  * have to be stored inside the Component Peer. Simple models are
  * much quicker as they do not change over time. A model is considered
@@ -61,11 +62,12 @@ private:
 	dePhysicsBullet &pBullet;
 	deModel &pModel;
 	
-	debpModelOctree *pOctree;
+	debpModelBVH *pBVH;
 	bool pCanDeform;
 	
 	sWeightSet *pWeightSets;
 	int pWeightSetCount;
+	decSkinning *pSkinning;
 	sExtends pExtends;
 	sExtends pWeightlessExtends;
 	bool pHasWeightlessExtends;
@@ -98,11 +100,11 @@ public:
 	
 	
 	
-	/** \brief Octree or \em NULL if not prepared. */
-	inline debpModelOctree *GetOctree() const{ return pOctree; }
+	/** \brief Face BVH or \em NULL if not prepared. */
+	inline debpModelBVH *GetBVH() const{ return pBVH; }
 	
-	/** \brief Prepare octree if not ready yet. */
-	void PrepareOctree();
+	/** \brief Prepare face BVH if not ready yet loading it from the cache if possible. */
+	void PrepareBVH();
 	
 	
 	
@@ -112,6 +114,12 @@ public:
 	/** \brief Weight set count. */
 	inline int GetWeightSetCount() const{ return pWeightSetCount; }
 	
+	/** \brief Skinning kernel for LOD 0 vertices or \em NULL if not prepared. */
+	inline const decSkinning *GetSkinning() const{ return pSkinning; }
+	
+	/** \brief Prepare skinning kernel if not prepared. */
+	void PrepareSkinning();
+	
 	/** \brief Extends. */
 	inline const sExtends &GetExtends() const{ return pExtends; }
 	
@@ -164,6 +172,8 @@ private:
 	void pCleanUp();
 	void pCheckCanDeform();
 	void pCalculateExtends();
+	bool pLoadCachedBVH();
+	void pSaveCachedBVH();
 };
 
 #endif
@@ -0,0 +1,490 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "debpModelBVH.h"
+#include "debpModelBVHVisitor.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decBaseFileReader.h>
+#include <dragengine/common/file/decBaseFileWriter.h>
+
+
+
+// Definitions
+////////////////
+
+// maximum number of faces in a leaf node unless the maximum depth is reached
+#define LEAF_FACE_COUNT 4
+
+// maximum depth of the tree. guards against degenerated splits
+#define MAX_DEPTH 32
+
+// largest quantized value
+#define QUANTIZE_RANGE 65535.0f
+
+
+
+// Helper functions
+/////////////////////
+
+static inline float bvhAxis( const decVector &vector, int axis ){
+	return axis == 0 ? vector.x : ( axis == 1 ? vector.y : vector.z );
+}
+
+static inline unsigned short bvhQuantizeFloor( float value ){
+	value = floorf( value ) - 1.0f;
+	return ( unsigned short )( value < 0.0f ? 0.0f : ( value > QUANTIZE_RANGE ? QUANTIZE_RANGE : value ) );
+}
+
+static inline unsigned short bvhQuantizeCeil( float value ){
+	value = ceilf( value ) + 1.0f;
+	return ( unsigned short )( value < 0.0f ? 0.0f : ( value > QUANTIZE_RANGE ? QUANTIZE_RANGE : value ) );
+}
+
+static inline bool bvhRaySlab( float origin, float invDisplacement, bool parallel,
+float minimum, float maximum, float &nearest, float &farthest ){
+	if( parallel ){
+		return origin >= minimum && origin <= maximum;
+	}
+	
+	float t1 = ( minimum - origin ) * invDisplacement;
+	float t2 = ( maximum - origin ) * invDisplacement;
+	if( t1 > t2 ){
+		const float swap = t1;
+		t1 = t2;
+		t2 = swap;
+	}
+	
+	if( t1 > nearest ){
+		nearest = t1;
+	}
+	if( t2 < farthest ){
+		farthest = t2;
+	}
+	return nearest <= farthest;
+}
+
+
+
+// Class debpModelBVH
+///////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debpModelBVH::debpModelBVH() :
+pNodes( NULL ),
+pNodeCount( 0 ),
+pFaces( NULL ),
+pFaceCount( 0 )
+{
+}
+
+debpModelBVH::~debpModelBVH(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void debpModelBVH::Build( const decVector *vertices, int vertexCount, const int *faces, int faceCount ){
+	if( vertexCount < 0 || faceCount < 0 || ( faceCount > 0 && ( ! vertices || ! faces ) ) ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	Clear();
+	
+	if( faceCount == 0 ){
+		return;
+	}
+	
+	sBuildFace * const buildFaces = new sBuildFace[ faceCount ];
+	int i;
+	
+	try{
+		for( i=0; i<faceCount; i++ ){
+			const int * const indices = faces + i * 3;
+			if( indices[ 0 ] < 0 || indices[ 0 ] >= vertexCount
+			|| indices[ 1 ] < 0 || indices[ 1 ] >= vertexCount
+			|| indices[ 2 ] < 0 || indices[ 2 ] >= vertexCount ){
+				DETHROW( deeInvalidParam );
+			}
+			
+			const decVector &v1 = vertices[ indices[ 0 ] ];
+			const decVector &v2 = vertices[ indices[ 1 ] ];
+			const decVector &v3 = vertices[ indices[ 2 ] ];
+			sBuildFace &buildFace = buildFaces[ i ];
+			
+			buildFace.minimum = v1.Smallest( v2 ).Smallest( v3 );
+			buildFace.maximum = v1.Largest( v2 ).Largest( v3 );
+			buildFace.center = ( buildFace.minimum + buildFace.maximum ) * 0.5f;
+			buildFace.index = i;
+			
+			if( i == 0 ){
+				pMinExtend = buildFace.minimum;
+				pMaxExtend = buildFace.maximum;
+				
+			}else{
+				pMinExtend.SetSmallest( buildFace.minimum );
+				pMaxExtend.SetLargest( buildFace.maximum );
+			}
+		}
+		
+		pUpdateScales();
+		
+		pNodes = new sNode[ faceCount * 2 ];
+		pFaces = new int[ faceCount ];
+		pBuildNode( buildFaces, 0, faceCount, 0 );
+		
+		delete [] buildFaces;
+		
+	}catch( const deException & ){
+		delete [] buildFaces;
+		Clear();
+		throw;
+	}
+}
+
+void debpModelBVH::Clear(){
+	pCleanUp();
+	
+	pNodes = NULL;
+	pNodeCount = 0;
+	pFaces = NULL;
+	pFaceCount = 0;
+	
+	pMinExtend.SetZero();
+	pMaxExtend.SetZero();
+	pQuantizeScale.SetZero();
+	pDequantizeScale.SetZero();
+}
+
+
+
+void debpModelBVH::VisitFaces( debpModelBVHVisitor &visitor, const decVector &minExtend,
+const decVector &maxExtend ) const{
+	if( pNodeCount == 0
+	|| maxExtend.x < pMinExtend.x || maxExtend.y < pMinExtend.y || maxExtend.z < pMinExtend.z
+	|| minExtend.x > pMaxExtend.x || minExtend.y > pMaxExtend.y || minExtend.z > pMaxExtend.z ){
+		return;
+	}
+	
+	unsigned short qmin[ 3 ], qmax[ 3 ];
+	pQuantize( minExtend, maxExtend, qmin, qmax );
+	
+	int index = 0;
+	while( index < pNodeCount ){
+		const sNode &node = pNodes[ index ];
+		
+		if( qmax[ 0 ] < node.minimum[ 0 ] || qmin[ 0 ] > node.maximum[ 0 ]
+		|| qmax[ 1 ] < node.minimum[ 1 ] || qmin[ 1 ] > node.maximum[ 1 ]
+		|| qmax[ 2 ] < node.minimum[ 2 ] || qmin[ 2 ] > node.maximum[ 2 ] ){
+			index = node.faceCount > 0 ? index + 1 : node.index;
+			continue;
+		}
+		
+		if( node.faceCount > 0 ){
+			visitor.VisitFaces( pFaces + node.index, node.faceCount );
+		}
+		index++;
+	}
+}
+
+void debpModelBVH::VisitFacesRay( debpModelBVHVisitor &visitor, const decVector &origin,
+const decVector &displacement ) const{
+	if( pNodeCount == 0 ){
+		return;
+	}
+	
+	const float rayOrigin[ 3 ] = { origin.x, origin.y, origin.z };
+	const float rayDisplacement[ 3 ] = { displacement.x, displacement.y, displacement.z };
+	float invDisplacement[ 3 ];
+	bool parallel[ 3 ];
+	int i;
+	
+	for( i=0; i<3; i++ ){
+		parallel[ i ] = fabsf( rayDisplacement[ i ] ) < FLOAT_SAFE_EPSILON;
+		invDisplacement[ i ] = parallel[ i ] ? 0.0f : 1.0f / rayDisplacement[ i ];
+	}
+	
+	decVector minExtend, maxExtend;
+	int index = 0;
+	
+	while( index < pNodeCount ){
+		const sNode &node = pNodes[ index ];
+		float nearest = 0.0f;
+		float farthest = 1.0f;
+		
+		pDequantize( node, minExtend, maxExtend );
+		
+		if( ! bvhRaySlab( rayOrigin[ 0 ], invDisplacement[ 0 ], parallel[ 0 ], minExtend.x, maxExtend.x, nearest, farthest )
+		|| ! bvhRaySlab( rayOrigin[ 1 ], invDisplacement[ 1 ], parallel[ 1 ], minExtend.y, maxExtend.y, nearest, farthest )
+		|| ! bvhRaySlab( rayOrigin[ 2 ], invDisplacement[ 2 ], parallel[ 2 ], minExtend.z, maxExtend.z, nearest, farthest ) ){
+			index = node.faceCount > 0 ? index + 1 : node.index;
+			continue;
+		}
+		
+		if( node.faceCount > 0 ){
+			visitor.VisitFaces( pFaces + node.index, node.faceCount );
+		}
+		index++;
+	}
+}
+
+void debpModelBVH::VisitFacesSphere( debpModelBVHVisitor &visitor, const decVector &center, float radius ) const{
+	const decVector radiusVector( radius, radius, radius );
+	const decVector sphereMinExtend( center - radiusVector );
+	const decVector sphereMaxExtend( center + radiusVector );
+	
+	if( pNodeCount == 0
+	|| sphereMaxExtend.x < pMinExtend.x || sphereMaxExtend.y < pMinExtend.y || sphereMaxExtend.z < pMinExtend.z
+	|| sphereMinExtend.x > pMaxExtend.x || sphereMinExtend.y > pMaxExtend.y || sphereMinExtend.z > pMaxExtend.z ){
+		return;
+	}
+	
+	const float squareRadius = radius * radius;
+	decVector minExtend, maxExtend;
+	int index = 0;
+	
+	while( index < pNodeCount ){
+		const sNode &node = pNodes[ index ];
+		
+		pDequantize( node, minExtend, maxExtend );
+		
+		const decVector closest( center.Largest( minExtend ).Smallest( maxExtend ) );
+		if( ( closest - center ).LengthSquared() > squareRadius ){
+			index = node.faceCount > 0 ? index + 1 : node.index;
+			continue;
+		}
+		
+		if( node.faceCount > 0 ){
+			visitor.VisitFaces( pFaces + node.index, node.faceCount );
+		}
+		index++;
+	}
+}
+
+
+
+void debpModelBVH::Load( decBaseFileReader &reader, int modelFaceCount ){
+	Clear();
+	
+	try{
+		pMinExtend = reader.ReadVector();
+		pMaxExtend = reader.ReadVector();
+		
+		const int nodeCount = reader.ReadInt();
+		const int faceCount = reader.ReadInt();
+		if( nodeCount < 0 || faceCount < 0 || nodeCount > faceCount * 2 ){
+			DETHROW( deeInvalidFileFormat );
+		}
+		
+		int i;
+		
+		if( nodeCount > 0 ){
+			pNodes = new sNode[ nodeCount ];
+			for( pNodeCount=0; pNodeCount<nodeCount; pNodeCount++ ){
+				sNode &node = pNodes[ pNodeCount ];
+				for( i=0; i<3; i++ ){
+					node.minimum[ i ] = reader.ReadUShort();
+				}
+				for( i=0; i<3; i++ ){
+					node.maximum[ i ] = reader.ReadUShort();
+				}
+				node.index = reader.ReadInt();
+				node.faceCount = reader.ReadInt();
+				
+				if( node.faceCount < 0 ){
+					DETHROW( deeInvalidFileFormat );
+				}
+				if( node.faceCount > 0 ){
+					if( node.index < 0 || node.index > faceCount - node.faceCount ){
+						DETHROW( deeInvalidFileFormat );
+					}
+					
+				}else if( node.index <= pNodeCount || node.index > nodeCount ){
+					DETHROW( deeInvalidFileFormat );
+				}
+			}
+		}
+		
+		if( faceCount > 0 ){
+			pFaces = new int[ faceCount ];
+			for( pFaceCount=0; pFaceCount<faceCount; pFaceCount++ ){
+				pFaces[ pFaceCount ] = reader.ReadInt();
+				if( pFaces[ pFaceCount ] < 0 || pFaces[ pFaceCount ] >= modelFaceCount ){
+					DETHROW( deeInvalidFileFormat );
+				}
+			}
+		}
+		
+		pUpdateScales();
+		
+	}catch( const deException & ){
+		Clear();
+		throw;
+	}
+}
+
+void debpModelBVH::Save( decBaseFileWriter &writer ) const{
+	int i, j;
+	
+	writer.WriteVector( pMinExtend );
+	writer.WriteVector( pMaxExtend );
+	writer.WriteInt( pNodeCount );
+	writer.WriteInt( pFaceCount );
+	
+	for( i=0; i<pNodeCount; i++ ){
+		const sNode &node = pNodes[ i ];
+		for( j=0; j<3; j++ ){
+			writer.WriteUShort( node.minimum[ j ] );
+		}
+		for( j=0; j<3; j++ ){
+			writer.WriteUShort( node.maximum[ j ] );
+		}
+		writer.WriteInt( node.index );
+		writer.WriteInt( node.faceCount );
+	}
+	
+	for( i=0; i<pFaceCount; i++ ){
+		writer.WriteInt( pFaces[ i ] );
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void debpModelBVH::pCleanUp(){
+	if( pFaces ){
+		delete [] pFaces;
+	}
+	if( pNodes ){
+		delete [] pNodes;
+	}
+}
+
+void debpModelBVH::pUpdateScales(){
+	const decVector size( pMaxExtend - pMinExtend );
+	
+	pQuantizeScale.x = size.x > FLOAT_SAFE_EPSILON ? QUANTIZE_RANGE / size.x : 0.0f;
+	pQuantizeScale.y = size.y > FLOAT_SAFE_EPSILON ? QUANTIZE_RANGE / size.y : 0.0f;
+	pQuantizeScale.z = size.z > FLOAT_SAFE_EPSILON ? QUANTIZE_RANGE / size.z : 0.0f;
+	
+	pDequantizeScale.x = size.x > FLOAT_SAFE_EPSILON ? size.x / QUANTIZE_RANGE : 0.0f;
+	pDequantizeScale.y = size.y > FLOAT_SAFE_EPSILON ? size.y / QUANTIZE_RANGE : 0.0f;
+	pDequantizeScale.z = size.z > FLOAT_SAFE_EPSILON ? size.z / QUANTIZE_RANGE : 0.0f;
+}
+
+void debpModelBVH::pBuildNode( sBuildFace *faces, int first, int count, int depth ){
+	const int nodeIndex = pNodeCount++;
+	decVector minExtend( faces[ first ].minimum );
+	decVector maxExtend( faces[ first ].maximum );
+	decVector minCenter( faces[ first ].center );
+	decVector maxCenter( minCenter );
+	int i;
+	
+	for( i=1; i<count; i++ ){
+		const sBuildFace &face = faces[ first + i ];
+		minExtend.SetSmallest( face.minimum );
+		maxExtend.SetLargest( face.maximum );
+		minCenter.SetSmallest( face.center );
+		maxCenter.SetLargest( face.center );
+	}
+	
+	pQuantize( minExtend, maxExtend, pNodes[ nodeIndex ].minimum, pNodes[ nodeIndex ].maximum );
+	
+	// leaf node
+	if( count <= LEAF_FACE_COUNT || depth >= MAX_DEPTH ){
+		pNodes[ nodeIndex ].index = pFaceCount;
+		pNodes[ nodeIndex ].faceCount = count;
+		
+		for( i=0; i<count; i++ ){
+			pFaces[ pFaceCount++ ] = faces[ first + i ].index;
+		}
+		return;
+	}
+	
+	// inner node. split face centers at the middle of the longest axis. if all faces end
+	// up on one side split the faces in half instead
+	const decVector centerSize( maxCenter - minCenter );
+	int axis = 0;
+	if( centerSize.y > centerSize.x ){
+		axis = 1;
+	}
+	if( centerSize.z > bvhAxis( centerSize, axis ) ){
+		axis = 2;
+	}
+	
+	const float split = ( bvhAxis( minCenter, axis ) + bvhAxis( maxCenter, axis ) ) * 0.5f;
+	int left = first;
+	int right = first + count - 1;
+	
+	while( left <= right ){
+		if( bvhAxis( faces[ left ].center, axis ) < split ){
+			left++;
+			
+		}else{
+			const sBuildFace swap( faces[ left ] );
+			faces[ left ] = faces[ right ];
+			faces[ right ] = swap;
+			right--;
+		}
+	}
+	
+	int leftCount = left - first;
+	if( leftCount == 0 || leftCount == count ){
+		leftCount = count / 2;
+	}
+	
+	pNodes[ nodeIndex ].faceCount = 0;
+	pBuildNode( faces, first, leftCount, depth + 1 );
+	pBuildNode( faces, first + leftCount, count - leftCount, depth + 1 );
+	pNodes[ nodeIndex ].index = pNodeCount;
+}
+
+void debpModelBVH::pQuantize( const decVector &minExtend, const decVector &maxExtend,
+unsigned short *qmin, unsigned short *qmax ) const{
+	// rounded outwards by one step to stay conservative despite float rounding
+	qmin[ 0 ] = bvhQuantizeFloor( ( minExtend.x - pMinExtend.x ) * pQuantizeScale.x );
+	qmin[ 1 ] = bvhQuantizeFloor( ( minExtend.y - pMinExtend.y ) * pQuantizeScale.y );
+	qmin[ 2 ] = bvhQuantizeFloor( ( minExtend.z - pMinExtend.z ) * pQuantizeScale.z );
+	
+	qmax[ 0 ] = bvhQuantizeCeil( ( maxExtend.x - pMinExtend.x ) * pQuantizeScale.x );
+	qmax[ 1 ] = bvhQuantizeCeil( ( maxExtend.y - pMinExtend.y ) * pQuantizeScale.y );
+	qmax[ 2 ] = bvhQuantizeCeil( ( maxExtend.z - pMinExtend.z ) * pQuantizeScale.z );
+}
+
+void debpModelBVH::pDequantize( const sNode &node, decVector &minExtend, decVector &maxExtend ) const{
+	minExtend.x = pMinExtend.x + ( float )node.minimum[ 0 ] * pDequantizeScale.x;
+	minExtend.y = pMinExtend.y + ( float )node.minimum[ 1 ] * pDequantizeScale.y;
+	minExtend.z = pMinExtend.z + ( float )node.minimum[ 2 ] * pDequantizeScale.z;
+	
+	maxExtend.x = pMinExtend.x + ( float )node.maximum[ 0 ] * pDequantizeScale.x;
+	maxExtend.y = pMinExtend.y + ( float )node.maximum[ 1 ] * pDequantizeScale.y;
+	maxExtend.z = pMinExtend.z + ( float )node.maximum[ 2 ] * pDequantizeScale.z;
+}
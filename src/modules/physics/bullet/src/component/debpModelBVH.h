@@ -0,0 +1,166 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBPMODELBVH_H_
+#define _DEBPMODELBVH_H_
+
+#include <dragengine/common/math/decMath.h>
+
+class debpModelBVHVisitor;
+class decBaseFileReader;
+class decBaseFileWriter;
+
+
+
+/**
+ * \brief Flattened model face bounding volume hierarchy.
+ *
+ * Binary BVH over the faces of a model LOD stored in two linear arrays. Nodes are stored
+ * in depth first order with the left child directly following its parent. Inner nodes
+ * store the index of the node following their subtree which allows traversing the tree
+ * without a stack. Node bounds are quantized to 16 bit relative to the model extends and
+ * rounded outwards hence they are conservative. Leaf nodes reference a contiguous run of
+ * face indices.
+ *
+ * The BVH is built once per model and shared by all colliders using the model. It can be
+ * saved to and loaded from the module cache.
+ */
+class debpModelBVH{
+public:
+	/** \brief Node. */
+	struct sNode{
+		/** \brief Quantized minimum extend. */
+		unsigned short minimum[ 3 ];
+		
+		/** \brief Quantized maximum extend. */
+		unsigned short maximum[ 3 ];
+		
+		/** \brief Index of first face for leaf nodes or index of node after subtree. */
+		int index;
+		
+		/** \brief Number of faces for leaf nodes or 0 for inner nodes. */
+		int faceCount;
+	};
+	
+	
+	
+private:
+	struct sBuildFace{
+		decVector minimum;
+		decVector maximum;
+		decVector center;
+		int index;
+	};
+	
+	decVector pMinExtend;
+	decVector pMaxExtend;
+	decVector pQuantizeScale;
+	decVector pDequantizeScale;
+	
+	sNode *pNodes;
+	int pNodeCount;
+	
+	int *pFaces;
+	int pFaceCount;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create empty BVH. */
+	debpModelBVH();
+	
+	/** \brief Clean up BVH. */
+	~debpModelBVH();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Minimum extend. */
+	inline const decVector &GetMinimumExtend() const{ return pMinExtend; }
+	
+	/** \brief Maximum extend. */
+	inline const decVector &GetMaximumExtend() const{ return pMaxExtend; }
+	
+	/** \brief Number of nodes. */
+	inline int GetNodeCount() const{ return pNodeCount; }
+	
+	/** \brief Nodes. */
+	inline const sNode *GetNodes() const{ return pNodes; }
+	
+	/** \brief Number of face indices. */
+	inline int GetFaceCount() const{ return pFaceCount; }
+	
+	/** \brief Face indices. */
+	inline const int *GetFaces() const{ return pFaces; }
+	
+	/**
+	 * \brief Build BVH.
+	 * \param[in] vertices Vertex positions.
+	 * \param[in] vertexCount Number of vertices.
+	 * \param[in] faces Vertex indices with three entries per face.
+	 * \param[in] faceCount Number of faces.
+	 */
+	void Build( const decVector *vertices, int vertexCount, const int *faces, int faceCount );
+	
+	/** \brief Remove all nodes and faces. */
+	void Clear();
+	
+	
+	
+	/** \brief Visit faces in leaf nodes overlapping box. */
+	void VisitFaces( debpModelBVHVisitor &visitor, const decVector &minExtend,
+		const decVector &maxExtend ) const;
+	
+	/** \brief Visit faces in leaf nodes hit by ray segment from origin to origin plus displacement. */
+	void VisitFacesRay( debpModelBVHVisitor &visitor, const decVector &origin,
+		const decVector &displacement ) const;
+	
+	/** \brief Visit faces in leaf nodes overlapping sphere. */
+	void VisitFacesSphere( debpModelBVHVisitor &visitor, const decVector &center, float radius ) const;
+	
+	
+	
+	/**
+	 * \brief Load BVH from file.
+	 * \throws deeInvalidFileFormat Node or face indices are out of range.
+	 */
+	void Load( decBaseFileReader &reader, int modelFaceCount );
+	
+	/** \brief Save BVH to file. */
+	void Save( decBaseFileWriter &writer ) const;
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+	void pUpdateScales();
+	void pBuildNode( sBuildFace *faces, int first, int count, int depth );
+	void pQuantize( const decVector &minExtend, const decVector &maxExtend,
+		unsigned short *qmin, unsigned short *qmax ) const;
+	void pDequantize( const sNode &node, decVector &minExtend, decVector &maxExtend ) const;
+};
+
+#endif
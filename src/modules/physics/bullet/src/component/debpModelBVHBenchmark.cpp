@@ -0,0 +1,300 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "debpModelBVH.h"
+#include "debpModelBVHBenchmark.h"
+#include "debpModelBVHVisitor.h"
+#include "debpModelOctree.h"
+#include "../dePhysicsBullet.h"
+#include "../coldet/collision/debpDCollisionSphere.h"
+#include "../coldet/octree/debpDOctreeVisitor.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/utils/decTimer.h>
+
+
+
+// Definitions
+////////////////
+
+#define GRID_HEIGHT		2.0f
+#define RAY_LENGTH		10.0f
+#define SPHERE_RADIUS	1.5f
+#define BOX_HALF_SIZE	0.5f
+#define SWEEP_LENGTH	3.0f
+
+
+
+// Visitors
+/////////////
+
+class cBVHFaceCounter : public debpModelBVHVisitor{
+public:
+	int faceCount;
+	int checksum;
+	
+	cBVHFaceCounter() : faceCount( 0 ), checksum( 0 ){
+	}
+	
+	virtual void VisitFaces( const int *faces, int count ){
+		int i;
+		for( i=0; i<count; i++ ){
+			checksum += faces[ i ];
+		}
+		faceCount += count;
+	}
+};
+
+class cOctreeFaceCounter : public debpDOctreeVisitor{
+public:
+	int faceCount;
+	int checksum;
+	
+	cOctreeFaceCounter() : faceCount( 0 ), checksum( 0 ){
+	}
+	
+	virtual void VisitNode( debpDOctree *node, int ){
+		const debpModelOctree &octree = *( ( debpModelOctree* )node );
+		const int count = octree.GetFaceCount();
+		int i;
+		for( i=0; i<count; i++ ){
+			checksum += octree.GetFaceAt( i );
+		}
+		faceCount += count;
+	}
+};
+
+
+
+// Class debpModelBVHBenchmark
+////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+debpModelBVHBenchmark::debpModelBVHBenchmark( dePhysicsBullet &bullet ) :
+pBullet( bullet ),
+pRandomSeed( 0x5eed1234 )
+{
+	(void)pBullet;
+}
+
+debpModelBVHBenchmark::~debpModelBVHBenchmark(){
+}
+
+
+
+// Management
+///////////////
+
+void debpModelBVHBenchmark::Run( int queryCount, int gridSize, decString &result ){
+	if( queryCount < 1 || gridSize < 1 ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	const int vertexStride = gridSize + 1;
+	const int vertexCount = vertexStride * vertexStride;
+	const int faceCount = gridSize * gridSize * 2;
+	decVector *vertices = NULL;
+	int *faces = NULL;
+	decVector *queryPositions = NULL;
+	decVector *queryDirections = NULL;
+	debpModelOctree *octree = NULL;
+	debpModelBVH bvh;
+	decTimer timer;
+	int i, x, z;
+	
+	pRandomSeed = 0x5eed1234;
+	
+	try{
+		// height field mesh
+		vertices = new decVector[ vertexCount ];
+		for( z=0; z<=gridSize; z++ ){
+			for( x=0; x<=gridSize; x++ ){
+				vertices[ z * vertexStride + x ].Set( ( float )x, pRandomFloat( GRID_HEIGHT ), ( float )z );
+			}
+		}
+		
+		faces = new int[ faceCount * 3 ];
+		for( i=0, z=0; z<gridSize; z++ ){
+			for( x=0; x<gridSize; x++ ){
+				const int base = z * vertexStride + x;
+				faces[ i++ ] = base;
+				faces[ i++ ] = base + vertexStride;
+				faces[ i++ ] = base + vertexStride + 1;
+				faces[ i++ ] = base;
+				faces[ i++ ] = base + vertexStride + 1;
+				faces[ i++ ] = base + 1;
+			}
+		}
+		
+		// build octree the same way debpModel did
+		const decVector offset( 0.01f, 0.01f, 0.01f );
+		const decVector minExtend( decVector( 0.0f, 0.0f, 0.0f ) - offset );
+		const decVector maxExtend( decVector( ( float )gridSize, GRID_HEIGHT, ( float )gridSize ) + offset );
+		
+		timer.Reset();
+		octree = new debpModelOctree( ( minExtend + maxExtend ) * 0.5f, ( maxExtend - minExtend ) * 0.5f );
+		for( i=0; i<faceCount; i++ ){
+			const decVector &v1 = vertices[ faces[ i * 3 ] ];
+			const decVector &v2 = vertices[ faces[ i * 3 + 1 ] ];
+			const decVector &v3 = vertices[ faces[ i * 3 + 2 ] ];
+			const decVector faceMinExtend( v1.Smallest( v2 ).Smallest( v3 ) );
+			const decVector faceMaxExtend( v1.Largest( v2 ).Largest( v3 ) );
+			octree->InsertFaceIntoTree( i, ( faceMinExtend + faceMaxExtend ) * 0.5f,
+				( faceMaxExtend - faceMinExtend ) * 0.5f );
+		}
+		const float timeBuildOctree = timer.GetElapsedTime();
+		
+		timer.Reset();
+		bvh.Build( vertices, vertexCount, faces, faceCount );
+		const float timeBuildBVH = timer.GetElapsedTime();
+		
+		// queries. positions are above the mesh with directions pointing mostly downwards
+		queryPositions = new decVector[ queryCount ];
+		queryDirections = new decVector[ queryCount ];
+		for( i=0; i<queryCount; i++ ){
+			queryPositions[ i ] = pRandomPosition( gridSize );
+			queryDirections[ i ].Set( pRandomFloat( 2.0f ) - 1.0f, -1.0f, pRandomFloat( 2.0f ) - 1.0f );
+			queryDirections[ i ].Normalize();
+		}
+		
+		// rays
+		cOctreeFaceCounter octreeRay;
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const decVector end( queryPositions[ i ] + queryDirections[ i ] * RAY_LENGTH );
+			octree->VisitNodesColliding( &octreeRay, decDVector( queryPositions[ i ].Smallest( end ) ),
+				decDVector( queryPositions[ i ].Largest( end ) ) );
+		}
+		const float timeRayOctree = timer.GetElapsedTime();
+		
+		cBVHFaceCounter bvhRay;
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			bvh.VisitFacesRay( bvhRay, queryPositions[ i ], queryDirections[ i ] * RAY_LENGTH );
+		}
+		const float timeRayBVH = timer.GetElapsedTime();
+		
+		// spheres placed on the mesh surface
+		cOctreeFaceCounter octreeSphere;
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const decVector &position = queryPositions[ i ];
+			debpDCollisionSphere sphere( decDVector( position.x, 0.5 * GRID_HEIGHT, position.z ), SPHERE_RADIUS );
+			octree->VisitNodesColliding( &octreeSphere, &sphere );
+		}
+		const float timeSphereOctree = timer.GetElapsedTime();
+		
+		cBVHFaceCounter bvhSphere;
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const decVector &position = queryPositions[ i ];
+			bvh.VisitFacesSphere( bvhSphere, decVector( position.x, 0.5f * GRID_HEIGHT, position.z ), SPHERE_RADIUS );
+		}
+		const float timeSphereBVH = timer.GetElapsedTime();
+		
+		// box sweeps using the box enclosing the moving box like the collision detection does
+		const decVector boxHalfSize( BOX_HALF_SIZE, BOX_HALF_SIZE, BOX_HALF_SIZE );
+		
+		cOctreeFaceCounter octreeSweep;
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const decVector &position = queryPositions[ i ];
+			const decVector end( position + queryDirections[ i ] * SWEEP_LENGTH );
+			octree->VisitNodesColliding( &octreeSweep, decDVector( position.Smallest( end ) - boxHalfSize ),
+				decDVector( position.Largest( end ) + boxHalfSize ) );
+		}
+		const float timeSweepOctree = timer.GetElapsedTime();
+		
+		cBVHFaceCounter bvhSweep;
+		timer.Reset();
+		for( i=0; i<queryCount; i++ ){
+			const decVector &position = queryPositions[ i ];
+			const decVector end( position + queryDirections[ i ] * SWEEP_LENGTH );
+			bvh.VisitFaces( bvhSweep, position.Smallest( end ) - boxHalfSize, position.Largest( end ) + boxHalfSize );
+		}
+		const float timeSweepBVH = timer.GetElapsedTime();
+		
+		const int bvhMemory = bvh.GetNodeCount() * ( int )sizeof( debpModelBVH::sNode )
+			+ bvh.GetFaceCount() * ( int )sizeof( int );
+		const float queryFactor = 1e6f / ( float )queryCount;
+		
+		result.Format( "Model BVH benchmark: queries=%d grid=%dx%d faces=%d\n"
+			"  Build: octree %.3fms, bvh %.3fms (nodes=%d, memory=%dKB)\n"
+			"  Ray: octree %.3fms (%.2fus/query, faces=%d), bvh %.3fms (%.2fus/query, faces=%d)\n"
+			"  Sphere: octree %.3fms (%.2fus/query, faces=%d), bvh %.3fms (%.2fus/query, faces=%d)\n"
+			"  Box sweep: octree %.3fms (%.2fus/query, faces=%d), bvh %.3fms (%.2fus/query, faces=%d)\n"
+			"  Checksum: %d\n",
+			queryCount, gridSize, gridSize, faceCount,
+			timeBuildOctree * 1e3f, timeBuildBVH * 1e3f, bvh.GetNodeCount(), bvhMemory / 1024,
+			timeRayOctree * 1e3f, timeRayOctree * queryFactor, octreeRay.faceCount,
+			timeRayBVH * 1e3f, timeRayBVH * queryFactor, bvhRay.faceCount,
+			timeSphereOctree * 1e3f, timeSphereOctree * queryFactor, octreeSphere.faceCount,
+			timeSphereBVH * 1e3f, timeSphereBVH * queryFactor, bvhSphere.faceCount,
+			timeSweepOctree * 1e3f, timeSweepOctree * queryFactor, octreeSweep.faceCount,
+			timeSweepBVH * 1e3f, timeSweepBVH * queryFactor, bvhSweep.faceCount,
+			octreeRay.checksum + octreeSphere.checksum + octreeSweep.checksum
+				+ bvhRay.checksum + bvhSphere.checksum + bvhSweep.checksum );
+		
+		delete octree;
+		delete [] queryDirections;
+		delete [] queryPositions;
+		delete [] faces;
+		delete [] vertices;
+		
+	}catch( const deException & ){
+		if( octree ){
+			delete octree;
+		}
+		if( queryDirections ){
+			delete [] queryDirections;
+		}
+		if( queryPositions ){
+			delete [] queryPositions;
+		}
+		if( faces ){
+			delete [] faces;
+		}
+		if( vertices ){
+			delete [] vertices;
+		}
+		throw;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+decVector debpModelBVHBenchmark::pRandomPosition( int gridSize ){
+	return decVector( pRandomFloat( ( float )gridSize ), GRID_HEIGHT + 1.0f, pRandomFloat( ( float )gridSize ) );
+}
+
+float debpModelBVHBenchmark::pRandomFloat( float range ){
+	// fixed seed linear congruential generator. results are reproducible across runs
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return ( float )( ( pRandomSeed >> 8 ) % 10000u ) * 1e-4f * range;
+}
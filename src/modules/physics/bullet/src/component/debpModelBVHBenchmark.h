@@ -0,0 +1,80 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBPMODELBVHBENCHMARK_H_
+#define _DEBPMODELBVHBENCHMARK_H_
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/common/string/decString.h>
+
+class dePhysicsBullet;
+
+
+
+/**
+ * \brief Model BVH benchmark.
+ * 
+ * Developer mode benchmark comparing debpModelBVH against debpModelOctree. Builds a
+ * synthetic height field mesh with random heights and fires ray, sphere and box sweep
+ * queries at both structures. Reports build and query times as well as the number of
+ * candidate faces handed to the visitors.
+ * 
+ * The octree has no ray query. Rays are tested using the box enclosing the ray segment
+ * which is what the collision detection did for the octree.
+ */
+class debpModelBVHBenchmark{
+private:
+	dePhysicsBullet &pBullet;
+	unsigned int pRandomSeed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create benchmark. */
+	debpModelBVHBenchmark( dePhysicsBullet &bullet );
+	
+	/** \brief Clean up benchmark. */
+	~debpModelBVHBenchmark();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Run benchmark.
+	 * \param[in] queryCount Number of queries to run of each type.
+	 * \param[in] gridSize Number of grid cells along each side of the mesh.
+	 * \param[out] result Benchmark results in human readable form.
+	 */
+	void Run( int queryCount, int gridSize, decString &result );
+	/*@}*/
+	
+	
+	
+private:
+	decVector pRandomPosition( int gridSize );
+	float pRandomFloat( float range );
+};
+
+#endif
@@ -0,0 +1,58 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBPMODELBVHVISITOR_H_
+#define _DEBPMODELBVHVISITOR_H_
+
+
+
+/**
+ * \brief Model BVH face visitor.
+ * 
+ * Receives the face indices stored in the leaf nodes of debpModelBVH hit by a query.
+ * Faces are handed over in runs of contiguous indices. Leaf bounds are conservative
+ * hence visitors have to test the faces themselves.
+ */
+class debpModelBVHVisitor{
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create visitor. */
+	debpModelBVHVisitor();
+	
+	/** \brief Clean up visitor. */
+	virtual ~debpModelBVHVisitor();
+	/*@}*/
+	
+	
+	
+	/** \name Visiting */
+	/*@{*/
+	/**
+	 * \brief Visit faces of leaf node.
+	 * \param[in] faces Indices of faces in the model LOD 0.
+	 * \param[in] count Number of faces.
+	 */
+	virtual void VisitFaces( const int *faces, int count );
+	/*@}*/
+};
+
+#endif
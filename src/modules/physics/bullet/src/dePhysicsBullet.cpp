@@ -56,6 +56,7 @@
 #include <dragengine/resources/collider/deCollisionInfo.h>
 #include <dragengine/common/string/unicode/decUnicodeString.h>
 #include <dragengine/common/file/decPath.h>
+#include <dragengine/filesystem/deCacheHelper.h>
 #include <dragengine/common/exceptions.h>
 
 
@@ -154,6 +155,7 @@ pCommandExecuter( NULL ),
 pParameters( NULL ),
 pColInfo( NULL ),
 pCollisionDetection( NULL ),
+pCacheModels( NULL ),
 pDebug( *this )
 {
 	gContactAddedCallback = debpCollisionObject::CallbackAddContact;
@@ -182,6 +184,7 @@ dePhysicsBullet::~dePhysicsBullet(){
 bool dePhysicsBullet::Init(){
 	pCollisionDetection = new debpCollisionDetection( *this );
 	pColInfo = new deCollisionInfo;
+	pCacheModels = new deCacheHelper( &GetVFS(), decPath::CreatePathUnix( "/cache/local/models" ) );
 	
 	pConfiguration->LoadConfig();
 	
@@ -203,6 +206,11 @@ void dePhysicsBullet::CleanUp(){
 		delete pCollisionDetection;
 		pCollisionDetection = NULL;
 	}
+	
+	if( pCacheModels ){
+		delete pCacheModels;
+		pCacheModels = NULL;
+	}
 }
 
 
@@ -32,6 +32,7 @@ class debpCommandExecuter;
 class debpParameterList;
 class deCollisionInfo;
 class debpCollisionDetection;
+class deCacheHelper;
 
 
 
@@ -45,6 +46,7 @@ private:
 	
 	deCollisionInfo *pColInfo;
 	debpCollisionDetection *pCollisionDetection;
+	deCacheHelper *pCacheModels;
 	
 	debpDebug pDebug;
 	
@@ -102,6 +104,9 @@ public:
 	/** \brief Collision detection. */
 	inline debpCollisionDetection &GetCollisionDetection() const{ return *pCollisionDetection; }
 	
+	/** \brief Model cache. */
+	inline deCacheHelper &GetCacheModels() const{ return *pCacheModels; }
+	
 	/** Creates a peer for the given component object. */
 	virtual deBasePhysicsComponent *CreateComponent( deComponent *comp );
 	/** Creates a peer for the given model object. */
@@ -24,6 +24,7 @@
 
 #include "debpDeveloperMode.h"
 #include "../dePhysicsBullet.h"
+#include "../component/debpModelBVHBenchmark.h"
 #include "../debug/debpDebug.h"
 #include "../world/debpWorld.h"
 
@@ -97,6 +98,10 @@ bool debpDeveloperMode::ExecuteCommand( const decUnicodeArgumentList &command, d
 	}else if( command.MatchesArgumentAt( 0, "dm_debug" ) ){
 		pCmdDebugEnable( command, answer );
 		return true;
+		
+	}else if( command.MatchesArgumentAt( 0, "dm_model_bvh_benchmark" ) ){
+		pCmdModelBVHBenchmark( command, answer );
+		return true;
 	}
 	
 	return false;
@@ -142,6 +147,7 @@ void debpDeveloperMode::pCmdHelp( const decUnicodeArgumentList &command, decUnic
 	answer.AppendFromUTF8( "dm_show_category => Show collision objects with collision category (comma-separated list of bit-numbers or 'off').\n" );
 	answer.AppendFromUTF8( "dm_highlight_response_type => Highlight response type if dm_show_category is used.\n" );
 	answer.AppendFromUTF8( "dm_debug {enable | disable} => Enable performance debugging.\n" );
+	answer.AppendFromUTF8( "dm_model_bvh_benchmark [queries] [gridSize] => Benchmark model BVH against octree.\n" );
 }
 
 void debpDeveloperMode::pCmdEnable( const decUnicodeArgumentList &command, decUnicodeString &answer ){
@@ -243,3 +249,21 @@ void debpDeveloperMode::pCmdDebugEnable( const decUnicodeArgumentList &command,
 	text.Format( "dm_debug = %s\n", pBullet.GetDebug().GetEnabled() ? "enabled" : "disabled" );
 	answer.AppendFromUTF8( text );
 }
+
+void debpDeveloperMode::pCmdModelBVHBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	int queryCount = 10000;
+	int gridSize = 100;
+	
+	if( command.GetArgumentCount() > 1 ){
+		queryCount = decMath::max( command.GetArgumentAt( 1 )->ToInt(), 1 );
+	}
+	if( command.GetArgumentCount() > 2 ){
+		gridSize = decMath::max( command.GetArgumentAt( 2 )->ToInt(), 1 );
+	}
+	
+	debpModelBVHBenchmark benchmark( pBullet );
+	decString text;
+	benchmark.Run( queryCount, gridSize, text );
+	pBullet.LogInfo( text.GetString() );
+	answer.AppendFromUTF8( text );
+}
@@ -102,6 +102,7 @@ private:
 	void pCmdShowCategory( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	void pCmdHighlightResponseType( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	void pCmdDebugEnable( const decUnicodeArgumentList &command, decUnicodeString &answer );
+	void pCmdModelBVHBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer );
 };
 
 #endif
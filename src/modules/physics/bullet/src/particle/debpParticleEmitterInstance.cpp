@@ -197,8 +197,6 @@ void debpParticleEmitterInstance::PrepareParticles( float elapsed ){
 	
 	pLastPosition = pInstance->GetPosition();
 	
-	ApplyForceFields( elapsed );
-	
 	//CheckForLastParticle(); // too early. StepParticles can also trigger a check which we would cancel the next time PrepareParticle is called
 }
 
@@ -224,15 +222,38 @@ void debpParticleEmitterInstance::ApplyForceFields( float elapsed ){
 }
 
 void debpParticleEmitterInstance::StepParticles( float elapsed ){
+	IntegrateParticles( elapsed );
+	MoveParticles( elapsed );
+}
+
+void debpParticleEmitterInstance::IntegrateParticles( float elapsed ){
+	int i;
+	
+	for( i=0; i<pTypeCount; i++ ){
+		pTypes[ i ].IntegrateParticles( elapsed );
+	}
+}
+
+void debpParticleEmitterInstance::MoveParticles( float elapsed ){
 	int i;
 	
 	for( i=0; i<pTypeCount; i++ ){
 //timer.Reset();
-		pTypes[ i ].StepParticles( elapsed );
+		pTypes[ i ].MoveParticles( elapsed );
 //pBullet->LogInfoFormat( "StepParticle (%i) = %iys", pTypes[ t ].GetParticlesCount(), ( int )( timer.GetElapsedTime() * 1000000.0f ) );
 	}
 	
-	CheckForLastParticle(); // StepParticles is called last so the check has to be done here not in PrepareParticles
+	CheckForLastParticle(); // MoveParticles is called last so the check has to be done here not in PrepareParticles
+}
+
+int debpParticleEmitterInstance::GetParticleCount() const{
+	int i, count = 0;
+	
+	for( i=0; i<pTypeCount; i++ ){
+		count += pTypes[ i ].GetParticlesCount();
+	}
+	
+	return count;
 }
 
 void debpParticleEmitterInstance::FinishStepping(){
@@ -396,6 +417,7 @@ void debpParticleEmitterInstance::pSimulateWarpUp(){
 		}
 		
 		PrepareParticles( simulationStep );
+		ApplyForceFields( simulationStep );
 		StepParticles( simulationStep );
 		
 		remainingTime -= timeStep;
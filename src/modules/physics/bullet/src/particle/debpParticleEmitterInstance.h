@@ -108,11 +108,30 @@ public:
 	/** \brief Prepare particles for simulation. */
 	void PrepareParticles( float elapsed );
 	
-	/** \brief Apply forces caused by a force field. */
+	/**
+	 * \brief Apply forces caused by a force field.
+	 * \details Call after PrepareParticles. Can be called in parallel for different instances.
+	 */
 	void ApplyForceFields( float elapsed );
 	
 	/** Steps the particles. */
 	void StepParticles( float elapsed );
+	
+	/**
+	 * \brief Integrate particle velocities and rotations.
+	 * \details Touches only particle states. Can be called in parallel for different instances.
+	 */
+	void IntegrateParticles( float elapsed );
+	
+	/**
+	 * \brief Move particles testing for collisions.
+	 * \details Can trigger collision responses. Call only from the main thread.
+	 */
+	void MoveParticles( float elapsed );
+	
+	/** \brief Number of particles of all types. */
+	int GetParticleCount() const;
+	
 	/** Finish stepping. */
 	void FinishStepping();
 	
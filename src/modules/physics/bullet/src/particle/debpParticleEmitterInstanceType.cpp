@@ -42,6 +42,7 @@
 #include "../world/debpWorld.h"
 
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
 #include "BulletCollision/CollisionShapes/btSphereShape.h"
 
 #include <dragengine/deEngine.h>
@@ -68,6 +69,9 @@
 #define random rand
 #endif
 
+// maximum number of active particles per type
+#define MAX_PARTICLE_COUNT 100000
+
 const btScalar vRandomFactor = 1.0 / ( btScalar )RAND_MAX;
 
 // Class debpParticleEmitterInstanceType
@@ -136,7 +140,7 @@ void debpParticleEmitterInstanceType::PrepareParticles( float elapsed, float tra
 			if( particle.timeToLive > 0.0f ){
 				if( updateProgress ){
 					particle.lifetime = 1.0f - particle.lifetimeFactor * particle.timeToLive;
-					ParticleSetProgressParams( particle );
+					ParticleSetProgressParams( p );
 				}
 				
 			}else{
@@ -314,112 +318,77 @@ void debpParticleEmitterInstanceType::ApplyForceField( const debpForceField &for
 	const deForceField &engForceField = forceField.GetForceField();
 	const float fluctStrength = pInstance->GetForceFieldFluctuation().GetStrength();
 	const float fluctDirection = pInstance->GetForceFieldFluctuation().GetDirection();
-	const float ffFluctuationDirection = engForceField.GetFluctuationDirection();
-	const float ffFluctuationForce = engForceField.GetFluctuationForce();
-	const float ffExponent = engForceField.GetExponent();
-	const decDVector &ffpos = engForceField.GetPosition();
-	const decVector &ffDir = forceField.GetDirection();
-	const float ffRadius = engForceField.GetRadius();
-	const float ffRadiusSquared = ffRadius * ffRadius;
-	//const float elapsedSquared = elapsed * elapsed;
-	const float ffForce = engForceField.GetForce();
-	//const float ffVelocity = engForceField.GetForce() * 4.5f / 15.0f; // 15N => 4.5 m/s
-	const deForceField::eFieldTypes ffFieldType = engForceField.GetFieldType();
-	const deForceField::eApplicationTypes ffApplyType = engForceField.GetApplicationType();
 	const float flucAngle = DEG2RAD * 180.0f;
-	float distance, distanceSquared;
-	float /*velocity,*/ addForce;
-	//const float volumeFactor = 4.0f * PI / 3.0f;
-	decVector direction;
-	float forceFactor;
-	decMatrix flucmat;
-	int p;
-	
-	for( p=0; p<pParticleCount; p++ ){
-		sParticle &particle = pParticles[ p ];
-		
-		direction.x = ( float )( particle.position.x() - ffpos.x );
-		direction.y = ( float )( particle.position.y() - ffpos.y );
-		direction.z = ( float )( particle.position.z() - ffpos.z );
-		
-		distanceSquared = direction * direction;
-		
-		if( distanceSquared >= ffRadiusSquared ) continue;
-		
-		if( ffFieldType == deForceField::eftLinear ){
-			distance = sqrtf( distanceSquared );
-			direction = ffDir;
-			
-		}else{
-			if( distanceSquared < 1e-6f ) continue;
-			
-			distance = sqrtf( distanceSquared );
-			direction *= 1.0f - distance / ffRadius;
-		}
-		
-		switch( ffApplyType ){
-		case deForceField::eatDirect:
-			//forceFactor = 1.0f;
-			forceFactor = particle.forceFieldDirect;
-			break;
-			
-		case deForceField::eatSurface:
-			//forceFactor = particle.size * particle.size * PI;
-			forceFactor = particle.forceFieldSurface;
-			break;
-			
-		case deForceField::eatMass:
-			//forceFactor = particle.size * particle.size * particle.size * volumeFactor;
-			forceFactor = particle.forceFieldMass * particle.mass;
-			break;
-			
-		case deForceField::eatSpeed:
-			forceFactor = particle.forceFieldSpeed * ( float )particle.linearVelocity.length();
-			break;
-			
-		default:
-			DETHROW( deeInvalidParam );
-		}
-		
-		//printf( "particle %i: velocity=%g dist=%g radius=%g exp=%g elapsed=%g\n", p, velocity, distance, ffRadius, ffExponent, elapsed );
-		
-		addForce = ( ffForce + ffFluctuationForce * fluctStrength )
-			* powf( 1.0f - distance / ffRadius, ffExponent ) * forceFactor;
-		
-		/*if( particle.gravity.y() < 1e-5f ){
-			addvelo = force * 0.02f;
-			//addtorque = 0.0f; //force * ( DEG2RAD * 45.0f );
-			
-		}else{
-			addvelo = force * 0.2f;
-			//addtorque = 0.0f;
-		}*/
-		//addvelo = force * 0.2f; // need a way to influende this parameter
-		
-		flucmat.SetRotationY( ffFluctuationDirection * fluctDirection * flucAngle );
-		
-		direction = flucmat.TransformNormal( direction ) * addForce;
-		particle.force.setX( particle.force.x() + direction.x );
-		particle.force.setY( particle.force.y() + direction.y );
-		particle.force.setZ( particle.force.z() + direction.z );
-		//particle.angularVelocity += addtorque; // += direction * addtorque;
-	}
+	debpParticleStates::sForceField stateForceField;
+	
+	stateForceField.position = engForceField.GetPosition();
+	stateForceField.direction = forceField.GetDirection();
+	stateForceField.fluctuation.SetRotationY( engForceField.GetFluctuationDirection() * fluctDirection * flucAngle );
+	stateForceField.radius = engForceField.GetRadius();
+	stateForceField.exponent = engForceField.GetExponent();
+	stateForceField.force = engForceField.GetForce() + engForceField.GetFluctuationForce() * fluctStrength;
+	stateForceField.fieldType = engForceField.GetFieldType();
+	stateForceField.applicationType = engForceField.GetApplicationType();
+	
+	pStates.ApplyForceField( pParticleCount, stateForceField );
 }
 
 void debpParticleEmitterInstanceType::StepParticles( float elapsed ){
+	IntegrateParticles( elapsed );
+	MoveParticles( elapsed );
+}
+
+void debpParticleEmitterInstanceType::IntegrateParticles( float elapsed ){
 	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
+	if( engType.GetSimulationType() == deParticleEmitterType::estBeam ){
+		return;
+	}
+	
+	pStates.Integrate( 0, pParticleCount, elapsed );
+}
+
+void debpParticleEmitterInstanceType::MoveParticles( float elapsed ){
+	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
+	if( engType.GetSimulationType() == deParticleEmitterType::estBeam || pParticleCount == 0 ){
+		return;
+	}
+	
+	if( ! pInstance->GetCanCollide() ){
+		pStates.Advance( 0, pParticleCount, elapsed );
+		return;
+	}
+	
+	// test the box enclosing the movement of all particles against the broadphase first.
+	// if no collision object can be hit all particles can be moved without sweep tests
+	const btScalar radius = ( btScalar )decMath::max( engType.GetPhysicsSize(), 0.01f ) + ( btScalar )0.01;
+	const btScalar btElapsed = ( btScalar )elapsed;
+	btVector3 boxMin( pStates.GetPosition( 0 ) );
+	btVector3 boxMax( boxMin );
 	int i;
 	
-	if( engType.GetSimulationType() != deParticleEmitterType::estBeam ){
-		//pInstance->GetBullet()->LogInfoFormat( "StepParticles: pParticleCount=%i pParticleSize=%i elapsed=%f\n", pParticleCount, pParticleSize, elapsed );
+	for( i=0; i<pParticleCount; i++ ){
+		const btVector3 position( pStates.GetPosition( i ) );
+		const btVector3 target( position + pStates.GetLinearVelocity( i ) * btElapsed );
 		
-		for( i=0; i<pParticleCount; i++ ){
-			sParticle &particle = pParticles[ i ];
-			
-			if( ! ParticleSimulate( particle, elapsed ) ){
-				KillParticle( i );
-				i--;
-			}
+		boxMin.setMin( position );
+		boxMin.setMin( target );
+		boxMax.setMax( position );
+		boxMax.setMax( target );
+	}
+	
+	const btVector3 expand( radius, radius, radius );
+	if( ! pCanCollideAny( boxMin - expand, boxMax + expand ) ){
+		pStates.Advance( 0, pParticleCount, elapsed );
+		return;
+	}
+	
+	// sweep test particles sharing the same shape
+	btSphereShape sphereShape( ( btScalar )decMath::max( engType.GetPhysicsSize(), 0.01f ) );
+	
+	for( i=0; i<pParticleCount; i++ ){
+		if( ! pTestCollision( i, elapsed, sphereShape ) ){
+			KillParticle( i );
+			i--;
 		}
 	}
 }
@@ -428,7 +397,7 @@ void debpParticleEmitterInstanceType::FinishStepping(){
 	int i;
 	
 	for( i=0; i<pParticleCount; i++ ){
-		ParticleUpdateTrailEmitter( pParticles[ i ] );
+		ParticleUpdateTrailEmitter( i );
 	}
 	
 	UpdateGraphicParticles();
@@ -459,27 +428,29 @@ void debpParticleEmitterInstanceType::UpdateGraphicParticles(){
 		for( p=0; p<pParticleCount; p++ ){
 			deParticleEmitterInstanceType::sParticle &destParticle = pGraParticles[ p ];
 			const sParticle &srcParticle = pParticles[ p ];
+			const btVector3 srcPosition( pStates.GetPosition( p ) );
+			const btVector3 srcLinearVelocity( pStates.GetLinearVelocity( p ) );
 			
 			destParticle.lifetime = srcParticle.lifetime;
-			destParticle.positionX = ( float )( srcParticle.position.x() - position.x );
-			destParticle.positionY = ( float )( srcParticle.position.y() - position.y );
-			destParticle.positionZ = ( float )( srcParticle.position.z() - position.z );
+			destParticle.positionX = ( float )( srcPosition.x() - position.x );
+			destParticle.positionY = ( float )( srcPosition.y() - position.y );
+			destParticle.positionZ = ( float )( srcPosition.z() - position.z );
 			
-			velocity = srcParticle.linearVelocity.length();
+			velocity = srcLinearVelocity.length();
 			if( velocity > 1e-5 ){
 				factor = 127.0 / velocity;
-				destParticle.linearDirectionX = ( signed char )decMath::clamp( ( int )( srcParticle.linearVelocity.x() * factor ), -127, 127 );
-				destParticle.linearDirectionY = ( signed char )decMath::clamp( ( int )( srcParticle.linearVelocity.y() * factor ), -127, 127 );
-				destParticle.linearDirectionZ = ( signed char )decMath::clamp( ( int )( srcParticle.linearVelocity.z() * factor ), -127, 127 );
+				destParticle.linearDirectionX = ( signed char )decMath::clamp( ( int )( srcLinearVelocity.x() * factor ), -127, 127 );
+				destParticle.linearDirectionY = ( signed char )decMath::clamp( ( int )( srcLinearVelocity.y() * factor ), -127, 127 );
+				destParticle.linearDirectionZ = ( signed char )decMath::clamp( ( int )( srcLinearVelocity.z() * factor ), -127, 127 );
 				
 			}else{ // dummy direction along z axis
 				destParticle.linearDirectionX = 0;
 				destParticle.linearDirectionY = 0;
 				destParticle.linearDirectionZ = 127;
 			}
-			destParticle.angularVelocity = ( signed char )decMath::clamp( ( int )( srcParticle.angularVelocity * factorAngVelo ), -127, 127 );
+			destParticle.angularVelocity = ( signed char )decMath::clamp( ( int )( pStates.GetAngularVelocity( p ) * factorAngVelo ), -127, 127 );
 			destParticle.linearVelocity = ( unsigned char )decMath::min( ( unsigned int )( velocity * factorLinVelo ), 255 );
-			destParticle.rotation = ( unsigned char )decMath::min( ( unsigned int )( srcParticle.rotation * rotationFactor ), 255 );
+			destParticle.rotation = ( unsigned char )decMath::min( ( unsigned int )( pStates.GetRotation( p ) * rotationFactor ), 255 );
 			
 			destParticle.castSize = srcParticle.castSize;
 			destParticle.castEmissivity = srcParticle.castEmissivity;
@@ -576,7 +547,7 @@ void debpParticleEmitterInstanceType::OnTypeChanged(){
 void debpParticleEmitterInstanceType::CastParticle( float distance, float timeOffset ){
 	const debpParticleEmitter * const emitter = pInstance->GetParticleEmitter();
 	
-	if( emitter && pParticleCount < 10000 ){ // currently hard-coded... not more than 10k active particles
+	if( emitter && pParticleCount < MAX_PARTICLE_COUNT ){
 		const deParticleEmitterType &engType = emitter->GetEmitter()->GetTypeAt( pType );
 		
 		if( engType.GetSimulationType() == deParticleEmitterType::estBeam ){
@@ -609,11 +580,13 @@ void debpParticleEmitterInstanceType::KillParticle( int index ){
 	if( simtype == deParticleEmitterType::estParticle ){
 		if( index < pParticleCount - 1 ){
 			memcpy( pParticles + index, pParticles + ( pParticleCount - 1 ), sizeof( sParticle ) );
+			pStates.Copy( index, pParticleCount - 1 );
 		}
 		
 	}else{ // ribbon or beam
 		if( index < pParticleCount - 1 ){
 			memmove( pParticles + index, pParticles + ( index + 1 ), sizeof( sParticle ) * ( pParticleCount - 1 - index ) );
+			pStates.Move( index, index + 1, pParticleCount - 1 - index );
 		}
 	}
 	
@@ -649,23 +622,15 @@ void debpParticleEmitterInstanceType::KillAllParticles(){
 void debpParticleEmitterInstanceType::CastSingleParticle( float distance, float timeOffset ){
 	// enlarge the particles array if required 
 	if( pParticleCount == pParticleSize ){
-		const int newSize = pParticleSize + 10;
-		sParticle * const newArray = new sParticle[ newSize ];
-		
-		if( pParticles ){
-			memcpy( newArray, pParticles, sizeof( sParticle ) * pParticleSize );
-			delete [] pParticles;
-		}
-		pParticles = newArray;
-		pParticleSize = newSize;
+		pEnlargeParticles( pParticleSize * 3 / 2 + 10 );
 	}
 	
 	// set up new particle
-	sParticle &particle = pParticles[ pParticleCount++ ];
+	const int index = pParticleCount++;
 	
-	ParticleSetCastParams( particle, distance, timeOffset );
-	ParticleSetProgressParams( particle );
-	ParticleCreateTrailEmitter( particle );
+	ParticleSetCastParams( index, distance, timeOffset );
+	ParticleSetProgressParams( index );
+	ParticleCreateTrailEmitter( index );
 	
 	//printf( "cast: size=%g emi=%g color=(%i,%i,%i,%i)\n", particle.castSize, particle.castEmissivity, particle.castRed, particle.castGreen, particle.castBlue, particle.castTransparency );
 	//pBullet->LogInfoFormat( "cast particle: i=%i p(%.3g,%.3g,%.3g) v=(%.3g,%.3g,%.3g) s=%.1f ttl=%.1f", pParticleCount-1, P.position.x, P.position.y, P.position.z, P.velocity.x, P.velocity.y, P.velocity.z, P.size, P.timeToLive );
@@ -690,38 +655,31 @@ void debpParticleEmitterInstanceType::CastBeamParticle( float distance ){
 		// enlarge the particles array if required. we enlarge by the maximum particle count even
 		// if we should use less later on
 		if( pParticleCount + particleCount > pParticleSize ){
-			const int newSize = pParticleCount + particleCount + 10;
-			sParticle * const newArray = new sParticle[ newSize ];
-			
-			if( pParticles ){
-				memcpy( newArray, pParticles, sizeof( sParticle ) * pParticleSize );
-				delete [] pParticles;
-			}
-			pParticles = newArray;
-			pParticleSize = newSize;
+			pEnlargeParticles( ( int )( pParticleCount + particleCount + 10 ) );
 		}
 		
 		// set up new particle
-		sParticle &particleCast = pParticles[ pParticleCount++ ];
+		const int indexCast = pParticleCount++;
 		
-		ParticleSetCastParams( particleCast, distance, 0.0f );
-		ParticleSetProgressParams( particleCast );
+		ParticleSetCastParams( indexCast, distance, 0.0f );
+		ParticleSetProgressParams( indexCast );
 		
 		// simulate the particle all the way to the end if there is more than one particle. if a kill particle
 		// is found the end of the beam is assumed
 		if( particleCount > 1 ){
 			const float lifetimeStep = 1.0f / ( float )( particleCount - 1 );
-			const float simTimeStep = particleCast.timeToLive * lifetimeStep;
+			const float simTimeStep = pParticles[ indexCast ].timeToLive * lifetimeStep;
 			
 			for( i=1; i<particleCount; i++ ){
 				memcpy( pParticles + pParticleCount, pParticles + ( pParticleCount - 1 ), sizeof( sParticle ) );
+				pStates.Copy( pParticleCount, pParticleCount - 1 );
 				
-				sParticle &particleProgress = pParticles[ pParticleCount++ ];
-				particleProgress.lifetime += lifetimeStep;
+				const int indexProgress = pParticleCount++;
+				pParticles[ indexProgress ].lifetime += lifetimeStep;
 				
-				ParticleSetProgressParams( particleProgress );
-				//ParticleCreateTrailEmitter( particleProgress ); // does this make sense? it would be possible
-				if( ! ParticleSimulate( particleProgress, simTimeStep ) ){
+				ParticleSetProgressParams( indexProgress );
+				//ParticleCreateTrailEmitter( indexProgress ); // does this make sense? it would be possible
+				if( ! ParticleSimulate( indexProgress, simTimeStep ) ){
 					break;
 				}
 			}
@@ -740,13 +698,15 @@ void debpParticleEmitterInstanceType::CastBeamParticle( float distance ){
 		// been cast since the first particle is used as blue print and copied over to all other particles
 		// then modified. if the trail emitter exists already it is multiplied across the beam which is not
 		// only looking wrong it trashes the reference count of the trail emitter.
-		ParticleCreateTrailEmitter( particleCast );
+		ParticleCreateTrailEmitter( indexCast );
 	}
 }
 
 
 
-void debpParticleEmitterInstanceType::ParticleSetCastParams( sParticle &particle, float distance, float timeOffset ){
+void debpParticleEmitterInstanceType::ParticleSetCastParams( int index, float distance, float timeOffset ){
+	sParticle &particle = pParticles[ index ];
+	
 	// important to avoid problems later on in bad cases
 	particle.trailEmitter = NULL;
 	
@@ -830,14 +790,15 @@ void debpParticleEmitterInstanceType::ParticleSetCastParams( sParticle &particle
 	particle.lifetimeFactor = 1.0f / particle.timeToLive;
 	particle.lifetime = timeOffset;
 	
-	particle.position.setValue( ( btScalar )castMatrix.a14, ( btScalar )castMatrix.a24, ( btScalar )castMatrix.a34 );
-	particle.rotation = particle.castRotation;
+	pStates.SetPosition( index, btVector3( ( btScalar )castMatrix.a14,
+		( btScalar )castMatrix.a24, ( btScalar )castMatrix.a34 ) );
+	pStates.SetRotation( index, particle.castRotation );
 	
 	view = castMatrix.TransformView() * particle.castLinearVelocity;
-	particle.linearVelocity.setValue( ( btScalar )view.x, ( btScalar )view.y, ( btScalar )view.z );
+	pStates.SetLinearVelocity( index, btVector3( ( btScalar )view.x, ( btScalar )view.y, ( btScalar )view.z ) );
 	
-	particle.angularVelocity = particle.castAngularVelocity
-		* type.EvaluateProgressParameter( debpParticleEmitterType::escAngularVelocity, 0.0f );
+	pStates.SetAngularVelocity( index, particle.castAngularVelocity
+		* type.EvaluateProgressParameter( debpParticleEmitterType::escAngularVelocity, 0.0f ) );
 }
 
 void debpParticleEmitterInstanceType::ParticleCastMatrix( decDMatrix &matrix ){
@@ -1043,7 +1004,7 @@ void debpParticleEmitterInstanceType::ParticleCastMatrix( decDMatrix &matrix ){
 	}
 }
 
-void debpParticleEmitterInstanceType::ParticleCreateTrailEmitter( sParticle &particle ){
+void debpParticleEmitterInstanceType::ParticleCreateTrailEmitter( int index ){
 	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
 	if( ! engType.GetTrailEmitter() ){
 		return;
@@ -1051,7 +1012,9 @@ void debpParticleEmitterInstanceType::ParticleCreateTrailEmitter( sParticle &par
 	
 	deWorld &engWorld = pInstance->GetParentWorld()->GetWorld();
 	const deEngine &engine = *pInstance->GetBullet()->GetGameEngine();
-	const btVector3 direction = -particle.linearVelocity;
+	sParticle &particle = pParticles[ index ];
+	const btVector3 position( pStates.GetPosition( index ) );
+	const btVector3 direction = -pStates.GetLinearVelocity( index );
 	
 	try{
 		particle.trailEmitter = engine.GetParticleEmitterInstanceManager()->CreateInstance();
@@ -1061,7 +1024,7 @@ void debpParticleEmitterInstanceType::ParticleCreateTrailEmitter( sParticle &par
 		particle.trailEmitter->SetTimeScale( 1.0f );
 		particle.trailEmitter->SetEnableCasting( true );
 		
-		particle.trailEmitter->SetPosition( decDVector( particle.position.getX(), particle.position.getY(), particle.position.getZ() ) );
+		particle.trailEmitter->SetPosition( decDVector( position.getX(), position.getY(), position.getZ() ) );
 		particle.trailEmitter->SetReferencePosition( particle.trailEmitter->GetPosition() );
 		
 		if( direction.getY() > 1.0 - DVECTOR_THRESHOLD ){
@@ -1086,35 +1049,38 @@ void debpParticleEmitterInstanceType::ParticleCreateTrailEmitter( sParticle &par
 	}
 }
 
-void debpParticleEmitterInstanceType::ParticleSetProgressParams( sParticle &particle ){
+void debpParticleEmitterInstanceType::ParticleSetProgressParams( int index ){
 	const debpParticleEmitter &emitter = *pInstance->GetParticleEmitter();
 	const debpParticleEmitterType &type = emitter.GetTypeAt( pType );
 	const debpWorld * const world = pInstance->GetParentWorld();
+	sParticle &particle = pParticles[ index ];
 	
 	particle.size = particle.castSize *
 		type.EvaluateProgressParameter( debpParticleEmitterType::escSize, particle.lifetime );
-	particle.mass = decMath::max( 1e-5f, particle.castMass *
+	const float mass = decMath::max( 1e-5f, particle.castMass *
 		type.EvaluateProgressParameter( debpParticleEmitterType::escMass, particle.lifetime ) );
+	pStates.SetMass( index, mass );
 	
 	particle.brown = particle.castBrown *
 		type.EvaluateProgressParameter( debpParticleEmitterType::escBrown, particle.lifetime );
-	particle.damp = particle.castDamp *
-		type.EvaluateProgressParameter( debpParticleEmitterType::escDamp, particle.lifetime );
-	particle.drag = particle.castDrag *
-		type.EvaluateProgressParameter( debpParticleEmitterType::escDrag, particle.lifetime );
+	pStates.SetDamp( index, particle.castDamp *
+		type.EvaluateProgressParameter( debpParticleEmitterType::escDamp, particle.lifetime ) );
+	pStates.SetDrag( index, particle.castDrag *
+		type.EvaluateProgressParameter( debpParticleEmitterType::escDrag, particle.lifetime ) );
 	particle.elasticity = particle.castElasticity *
 		type.EvaluateProgressParameter( debpParticleEmitterType::escElasticity, particle.lifetime );
 	particle.roughness = particle.castRoughness *
 		type.EvaluateProgressParameter( debpParticleEmitterType::escRoughness, particle.lifetime );
 	
-	particle.forceFieldDirect = particle.castForceFieldDirect *
-		type.EvaluateProgressParameter( debpParticleEmitterType::escForceFieldDirect, particle.lifetime );
-	particle.forceFieldSurface = particle.castForceFieldSurface *
-		type.EvaluateProgressParameter( debpParticleEmitterType::escForceFieldSurface, particle.lifetime );
-	particle.forceFieldMass = particle.castForceFieldMass *
-		type.EvaluateProgressParameter( debpParticleEmitterType::escForceFieldVolume, particle.lifetime );
-	particle.forceFieldSpeed = particle.castForceFieldSpeed *
-		type.EvaluateProgressParameter( debpParticleEmitterType::escForceFieldSpeed, particle.lifetime );
+	pStates.SetForceFieldFactors( index,
+		particle.castForceFieldDirect * type.EvaluateProgressParameter(
+			debpParticleEmitterType::escForceFieldDirect, particle.lifetime ),
+		particle.castForceFieldSurface * type.EvaluateProgressParameter(
+			debpParticleEmitterType::escForceFieldSurface, particle.lifetime ),
+		particle.castForceFieldMass * type.EvaluateProgressParameter(
+			debpParticleEmitterType::escForceFieldVolume, particle.lifetime ),
+		particle.castForceFieldSpeed * type.EvaluateProgressParameter(
+			debpParticleEmitterType::escForceFieldSpeed, particle.lifetime ) );
 	
 	// calculate gravity. it is a bit convoluted to avoid calculating not used stuff
 	const btScalar localGravity = ( btScalar )( particle.castLocalGravity
@@ -1158,7 +1124,7 @@ void debpParticleEmitterInstanceType::ParticleSetProgressParams( sParticle &part
 	}
 	
 	// apply gravity
-	particle.force = particle.gravity * particle.mass;
+	btVector3 force( particle.gravity * ( btScalar )mass );
 	
 	// apply brown motion
 	if( particle.brown > 1e-5f ){
@@ -1168,50 +1134,21 @@ void debpParticleEmitterInstanceType::ParticleSetProgressParams( sParticle &part
 		brownMotion.setY( ( btScalar )random() * vRandomFactor * 2.0 - 1.0 );
 		brownMotion.setZ( ( btScalar )random() * vRandomFactor * 2.0 - 1.0 );
 		
-		particle.force += brownMotion * ( btScalar )( particle.brown * particle.mass );
+		force += brownMotion * ( btScalar )( particle.brown * mass );
 	}
+	
+	pStates.SetForce( index, force );
 }
 
-bool debpParticleEmitterInstanceType::ParticleSimulate( sParticle &particle, float elapsed ){
-	// apply force
-	particle.linearVelocity += particle.force * ( btScalar )( elapsed / particle.mass );
-	
-	// apply air drag
-	if( particle.drag > 1e-10f ){
-		const btScalar factor1 = 1.0 - ( btScalar )( particle.drag * 
-			particle.linearVelocity.dot( particle.linearVelocity ) * elapsed / particle.mass );
-		
-		if( factor1 > 0.0 ){
-			particle.linearVelocity *= factor1;
-			
-		}else{
-			particle.linearVelocity.setZero();
-		}
-	}
-	
-	// damp velocities
-	if( particle.damp > 1e-5f ){
-		const btScalar factor1 = 1.0 - ( btScalar )particle.damp;// * btElapsed;
-		
-		if( factor1 > 0.0 ){
-			particle.linearVelocity *= factor1;
-			particle.angularVelocity *= factor1;
-			
-		}else{
-			particle.linearVelocity.setZero();
-			particle.angularVelocity = 0.0f;
-		}
-	}
-	
-	// apply angular rotation
-	particle.rotation = fmodf( particle.rotation + particle.angularVelocity * elapsed, PI * 2.0f );
+bool debpParticleEmitterInstanceType::ParticleSimulate( int index, float elapsed ){
+	pStates.Integrate( index, 1, elapsed );
 	
 	// step linear motion
 	if( pInstance->GetCanCollide() ){
-		return ParticleTestCollision( particle, elapsed );
+		return ParticleTestCollision( index, elapsed );
 		
 	}else{
-		particle.position += particle.linearVelocity * ( btScalar )elapsed;
+		pStates.Advance( index, 1, elapsed );
 	}
 	
 	return true;
@@ -1248,51 +1185,96 @@ public:
 	}
 };
 
-bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle, float elapsed ){
-	// pBullet->LogInfoFormat( "step particle %i: elapsed=%g displacement=(%g,%g,%g)", p, elapsed, displacement.getX(), displacement.getY(), displacement.getZ() );
+class cParticleAabbCallback : public btBroadphaseAabbCallback{
+private:
+	const decCollisionFilter &pCollisionFilter;
+	bool pHasHit;
+	
+public:
+	cParticleAabbCallback( const decCollisionFilter &collisionFilter ) :
+	pCollisionFilter( collisionFilter ),
+	pHasHit( false ){
+	}
+	
+	inline bool HasHit() const{ return pHasHit; }
+	
+	virtual bool process( const btBroadphaseProxy *proxy ){
+		if( pHasHit ){
+			return false;
+		}
+		
+		const btCollisionObject &collisionObject = *( ( btCollisionObject* )proxy->m_clientObject );
+		const debpCollisionObject * const colObj = ( debpCollisionObject* )collisionObject.getUserPointer();
+		if( ! colObj ){
+			return true;
+		}
+		
+		if( colObj->IsOwnerCollider() ){
+			pHasHit = pCollisionFilter.Collides( colObj->GetOwnerCollider()->GetCollider().GetCollisionFilter() );
+			
+		}else if( colObj->IsOwnerHTSector() ){
+			pHasHit = pCollisionFilter.Collides( colObj->GetOwnerHTSector()->GetHeightTerrain()
+				->GetHeightTerrain()->GetCollisionFilter() );
+		}
+		
+		return ! pHasHit;
+	}
+};
+
+bool debpParticleEmitterInstanceType::ParticleTestCollision( int index, float elapsed ){
 	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
-	debpCollisionWorld &dynamicsWorld = *pInstance->GetParentWorld()->GetDynamicsWorld();
-	const decCollisionFilter &collisionFilter = pInstance->GetInstance()->GetCollisionFilter();
-	btVector3 displacement = particle.linearVelocity * elapsed;
-	int loop;
 	
 	// the bullet shpere-box test is quite error-prone. particles keep on falling through
 	// no matter what you do. what is the problem here?
 	//btSphereShape sphereShape( ( btScalar )decMath::max( engType.GetPhysicsSize(), 0.001f ) );
 	btSphereShape sphereShape( ( btScalar )decMath::max( engType.GetPhysicsSize(), 0.01f ) );
 	
+	return pTestCollision( index, elapsed, sphereShape );
+}
+
+bool debpParticleEmitterInstanceType::pTestCollision( int index, float elapsed, btSphereShape &sphereShape ){
+	// pBullet->LogInfoFormat( "step particle %i: elapsed=%g displacement=(%g,%g,%g)", p, elapsed, displacement.getX(), displacement.getY(), displacement.getZ() );
+	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
+	debpCollisionWorld &dynamicsWorld = *pInstance->GetParentWorld()->GetDynamicsWorld();
+	const decCollisionFilter &collisionFilter = pInstance->GetInstance()->GetCollisionFilter();
+	const sParticle &particle = pParticles[ index ];
+	btVector3 position( pStates.GetPosition( index ) );
+	btVector3 linearVelocity( pStates.GetLinearVelocity( index ) );
+	btVector3 displacement = linearVelocity * elapsed;
+	int loop;
+	
 	for( loop=0; loop<5; loop++ ){
 		if( displacement.length2() < 1e-8 ){
-			particle.linearVelocity.setZero();
+			linearVelocity.setZero();
 			break;
 		}
 		
-		const btVector3 rayToWorld = particle.position + displacement;
+		const btVector3 rayToWorld = position + displacement;
 		
 		// TODO use size of particle to do a sphere collision test instead of a ray test
 		
 		// WARNING bullet has a broken ray-box test implementation using Gjk which has a tendency
 		// to miss collisions half of the time. as a quick fix a sweep test is done with
 		// a tiny sphere which yields a comparable result but is not prone to the problem
-		//debpClosestRayResultCallback rayResult( particle.position, rayToWorld, &collisionFilter );
-		//dynamicsWorld.rayTest( particle.position, rayToWorld, rayResult );
+		//debpClosestRayResultCallback rayResult( position, rayToWorld, &collisionFilter );
+		//dynamicsWorld.rayTest( position, rayToWorld, rayResult );
 		
-		//pBullet->LogInfoFormat( "rayTest: pos=(%g,%g,%g) to(%g,%g,%g) time=%g", particle.position.getX(), particle.position.getY(),
-		//	particle.position.getZ(), rayToWorld.getX(), rayToWorld.getY(), rayToWorld.getZ(), elapsed );
+		//pBullet->LogInfoFormat( "rayTest: pos=(%g,%g,%g) to(%g,%g,%g) time=%g", position.getX(), position.getY(),
+		//	position.getZ(), rayToWorld.getX(), rayToWorld.getY(), rayToWorld.getZ(), elapsed );
 		
-		cClosestParticleCallback rayResult( particle.position, rayToWorld, collisionFilter );
+		cClosestParticleCallback rayResult( position, rayToWorld, collisionFilter );
 		{
 		//sphereShape.setUnscaledRadius( ... );
 		const btQuaternion btQuaterion( ( btScalar )0.0, ( btScalar )0.0, ( btScalar )0.0, ( btScalar )1.0 );
-		const btTransform btTransformFrom( btQuaterion, particle.position );
+		const btTransform btTransformFrom( btQuaterion, position );
 		const btTransform btTransformTo( btQuaterion, rayToWorld );
 		
 		dynamicsWorld.convexSweepTest( &sphereShape, btTransformFrom, btTransformTo, rayResult, BT_ZERO );
 		}
 		
 		if( ! rayResult.hasHit() ){
-			particle.position += displacement;
-			//pBullet->LogInfoFormat( "no hit: pos=(%g,%g,%g)", particle.position.getX(), particle.position.getY(), particle.position.getZ() );
+			position += displacement;
+			//pBullet->LogInfoFormat( "no hit: pos=(%g,%g,%g)", position.getX(), position.getY(), position.getZ() );
 			break;
 		}
 		
@@ -1302,10 +1284,10 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 		bool doEmitParticles = false;
 		
 		if( engType.GetCollisionEmitter() ){
-			particleLinearVelocity = ( float )particle.linearVelocity.length();
+			particleLinearVelocity = ( float )linearVelocity.length();
 			particleLinearVelocity *= particle.elasticity;
 			
-			if( particleLinearVelocity * particle.mass > engType.GetEmitMinImpulse() ){
+			if( particleLinearVelocity * pStates.GetMass( index ) > engType.GetEmitMinImpulse() ){
 				// sanity check to avoid dead-loops due to an emitter without emit-burst set as these would live forever
 				if( engType.GetCollisionEmitter()->GetEmitBurst() ){
 					doEmitParticles = true;
@@ -1317,8 +1299,8 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 		deParticleEmitterType::eCollisionResponses collisionResponse = engType.GetCollisionResponse();
 		
 		if( collisionResponse != deParticleEmitterType::ecrDestroy || doEmitParticles ){
-			particle.position += displacement * rayResult.m_closestHitFraction;
-			particle.position += rayResult.m_hitNormalWorld * 0.0001; // prevent falling through
+			position += displacement * rayResult.m_closestHitFraction;
+			position += rayResult.m_hitNormalWorld * 0.0001; // prevent falling through
 			displacement *= 1.0 - rayResult.m_closestHitFraction;
 		}
 		
@@ -1349,18 +1331,18 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 				( float )rayResult.m_hitNormalWorld.getY(),
 				( float )rayResult.m_hitNormalWorld.getZ() );
 			const decDVector ciposition(
-				( double )particle.position.getX(),
-				( double )particle.position.getY(),
-				( double )particle.position.getZ() );
+				( double )position.getX(),
+				( double )position.getY(),
+				( double )position.getZ() );
 			const decVector civelocity(
-				( float )particle.linearVelocity.getX(),
-				( float )particle.linearVelocity.getY(),
-				( float )particle.linearVelocity.getZ() );
+				( float )linearVelocity.getX(),
+				( float )linearVelocity.getY(),
+				( float )linearVelocity.getZ() );
 			
 			cinfo.SetNormal( cinormal );
 			cinfo.SetDistance( ( float )( elapsed * ( ( btScalar )1.0 - rayResult.m_closestHitFraction ) ) );
 			cinfo.SetParticleLifetime( particle.lifetime );
-			cinfo.SetParticleMass( particle.mass );
+			cinfo.SetParticleMass( pStates.GetMass( index ) );
 			cinfo.SetParticlePosition( ciposition );
 			cinfo.SetParticleVelocity( civelocity );
 			cinfo.SetParticleResponse( deParticleEmitterType::ecrDestroy );
@@ -1426,7 +1408,7 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 				}
 				
 				// set controller values
-				ParticleSetEmitterControllers( particle, *emitInstance, particleLinearVelocity );
+				ParticleSetEmitterControllers( index, *emitInstance, particleLinearVelocity );
 				
 				// add to the world. this has to come before casting just to be safe
 				pInstance->GetParentWorld()->GetWorld().AddParticleEmitter( emitInstance );
@@ -1445,7 +1427,7 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 		// apply collision response
 		switch( collisionResponse ){
 		case deParticleEmitterType::ecrPhysical:
-			particle.linearVelocity = displacement / elapsed;
+			linearVelocity = displacement / elapsed;
 			elapsed *= 1.0f - ( float )rayResult.m_closestHitFraction;
 			break;
 			
@@ -1454,8 +1436,8 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 			const decDVector &ciposition = cinfo.GetParticlePosition();
 			const decVector &civelocity = cinfo.GetParticleVelocity();
 			
-			particle.position.setValue( ( btScalar )ciposition.x, ( btScalar )ciposition.y, ( btScalar )ciposition.z );
-			particle.linearVelocity.setValue( ( btScalar )civelocity.x, ( btScalar )civelocity.y, ( btScalar )civelocity.z );
+			position.setValue( ( btScalar )ciposition.x, ( btScalar )ciposition.y, ( btScalar )ciposition.z );
+			linearVelocity.setValue( ( btScalar )civelocity.x, ( btScalar )civelocity.y, ( btScalar )civelocity.z );
 			elapsed *= 1.0f - ( float )rayResult.m_closestHitFraction;
 			}break;
 			
@@ -1464,23 +1446,25 @@ bool debpParticleEmitterInstanceType::ParticleTestCollision( sParticle &particle
 		}
 	}
 	
+	pStates.SetPosition( index, position );
+	pStates.SetLinearVelocity( index, linearVelocity );
 	return true;
 }
 
-void debpParticleEmitterInstanceType::ParticleSetEmitterControllers( const sParticle &particle,
+void debpParticleEmitterInstanceType::ParticleSetEmitterControllers( int index,
 deParticleEmitterInstance &instance, float linearVelocity ){
 	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
 	int controllerIndex;
 	
 	controllerIndex = engType.GetEmitController( deParticleEmitterType::eecLifetime );
 	if( controllerIndex != -1 ){
-		instance.GetControllerAt( controllerIndex ).SetValue( particle.lifetime );
+		instance.GetControllerAt( controllerIndex ).SetValue( pParticles[ index ].lifetime );
 		instance.NotifyControllerChangedAt( controllerIndex );
 	}
 	
 	controllerIndex = engType.GetEmitController( deParticleEmitterType::eecMass );
 	if( controllerIndex != -1 ){
-		instance.GetControllerAt( controllerIndex ).SetValue( particle.mass );
+		instance.GetControllerAt( controllerIndex ).SetValue( pStates.GetMass( index ) );
 		instance.NotifyControllerChangedAt( controllerIndex );
 	}
 	
@@ -1492,20 +1476,22 @@ deParticleEmitterInstance &instance, float linearVelocity ){
 	
 	controllerIndex = engType.GetEmitController( deParticleEmitterType::eecAngularVelocity );
 	if( controllerIndex != -1 ){
-		instance.GetControllerAt( controllerIndex ).SetValue( particle.angularVelocity );
+		instance.GetControllerAt( controllerIndex ).SetValue( pStates.GetAngularVelocity( index ) );
 		instance.NotifyControllerChangedAt( controllerIndex );
 	}
 }
 
-void debpParticleEmitterInstanceType::ParticleUpdateTrailEmitter( const sParticle &particle ){
+void debpParticleEmitterInstanceType::ParticleUpdateTrailEmitter( int index ){
+	const sParticle &particle = pParticles[ index ];
 	if( ! particle.trailEmitter ){
 		return;
 	}
 	
-	btVector3 direction( -particle.linearVelocity );
+	const btVector3 position( pStates.GetPosition( index ) );
+	btVector3 direction( -pStates.GetLinearVelocity( index ) );
 	
 	// set position and orientation
-	particle.trailEmitter->SetPosition( decDVector( particle.position.getX(), particle.position.getY(), particle.position.getZ() ) );
+	particle.trailEmitter->SetPosition( decDVector( position.getX(), position.getY(), position.getZ() ) );
 	
 	// set orientation only if the linear velocity is not zero. otherwise keep the old orientation
 	if( direction.length() > 0.001 ){
@@ -1524,23 +1510,23 @@ void debpParticleEmitterInstanceType::ParticleUpdateTrailEmitter( const sParticl
 	}
 	
 	// set controller values
-	ParticleSetTrailEmitterControllers( particle, *particle.trailEmitter, particle.linearVelocity.length() );
+	ParticleSetTrailEmitterControllers( index, *particle.trailEmitter, pStates.GetLinearSpeed( index ) );
 }
 
-void debpParticleEmitterInstanceType::ParticleSetTrailEmitterControllers( const sParticle &particle,
+void debpParticleEmitterInstanceType::ParticleSetTrailEmitterControllers( int index,
 deParticleEmitterInstance &instance, float linearVelocity ){
 	const deParticleEmitterType &engType = pInstance->GetParticleEmitter()->GetEmitter()->GetTypeAt( pType );
 	int controllerIndex;
 	
 	controllerIndex = engType.GetTrailController( deParticleEmitterType::eecLifetime );
 	if( controllerIndex != -1 ){
-		instance.GetControllerAt( controllerIndex ).SetValue( particle.lifetime );
+		instance.GetControllerAt( controllerIndex ).SetValue( pParticles[ index ].lifetime );
 		instance.NotifyControllerChangedAt( controllerIndex );
 	}
 	
 	controllerIndex = engType.GetTrailController( deParticleEmitterType::eecMass );
 	if( controllerIndex != -1 ){
-		instance.GetControllerAt( controllerIndex ).SetValue( particle.mass );
+		instance.GetControllerAt( controllerIndex ).SetValue( pStates.GetMass( index ) );
 		instance.NotifyControllerChangedAt( controllerIndex );
 	}
 	
@@ -1552,7 +1538,7 @@ deParticleEmitterInstance &instance, float linearVelocity ){
 	
 	controllerIndex = engType.GetTrailController( deParticleEmitterType::eecAngularVelocity );
 	if( controllerIndex != -1 ){
-		instance.GetControllerAt( controllerIndex ).SetValue( particle.angularVelocity );
+		instance.GetControllerAt( controllerIndex ).SetValue( pStates.GetAngularVelocity( index ) );
 		instance.NotifyControllerChangedAt( controllerIndex );
 	}
 }
@@ -1572,3 +1558,30 @@ void debpParticleEmitterInstanceType::pCleanUp(){
 		delete [] pParticles;
 	}
 }
+
+void debpParticleEmitterInstanceType::pEnlargeParticles( int size ){
+	sParticle * const newArray = new sParticle[ size ];
+	
+	try{
+		pStates.Resize( size, pParticleCount );
+		
+	}catch( const deException & ){
+		delete [] newArray;
+		throw;
+	}
+	
+	if( pParticles ){
+		memcpy( newArray, pParticles, sizeof( sParticle ) * pParticleSize );
+		delete [] pParticles;
+	}
+	pParticles = newArray;
+	pParticleSize = size;
+}
+
+bool debpParticleEmitterInstanceType::pCanCollideAny( const btVector3 &boxMin, const btVector3 &boxMax ) const{
+	debpCollisionWorld &dynamicsWorld = *pInstance->GetParentWorld()->GetDynamicsWorld();
+	cParticleAabbCallback callback( pInstance->GetInstance()->GetCollisionFilter() );
+	
+	dynamicsWorld.getBroadphase()->aabbTest( boxMin, boxMax, callback );
+	return callback.HasHit();
+}
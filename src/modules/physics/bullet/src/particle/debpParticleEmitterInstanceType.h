@@ -22,6 +22,8 @@
 #ifndef _DEBPPROPPARTICLEEMITTERINSTANCETYPE_H_
 #define _DEBPPROPPARTICLEEMITTERINSTANCETYPE_H_
 
+#include "debpParticleStates.h"
+
 #include "LinearMath/btVector3.h"
 
 #include <dragengine/resources/particle/deParticleEmitterInstanceType.h>
@@ -30,33 +32,26 @@ class debpForceField;
 class debpParticleEmitterInstance;
 class debpComponent;
 class deParticleEmitterInstance;
+class btSphereShape;
 
 
 
 /**
  * @brief Particle Emitter Instance Type.
+ * 
+ * Particle states touched by every simulation step are stored in debpParticleStates as
+ * structure of arrays. Parameters only touched while casting or updating progress
+ * parameters are stored in sParticle. Both use the same index.
  */
 class debpParticleEmitterInstanceType{
 public:
 	struct sParticle{
-		btVector3 position;
-		btVector3 linearVelocity;
-		btVector3 force;
-		float rotation;
-		float angularVelocity;
 		btVector3 gravity;
-		float forceFieldDirect;
-		float forceFieldSurface;
-		float forceFieldMass;
-		float forceFieldSpeed;
 		float timeToLive;
 		float lifetimeFactor;
 		float lifetime;
 		float size;
-		float mass;
 		float brown;
-		float damp;
-		float drag;
 		float elasticity;
 		float roughness;
 		
@@ -95,6 +90,7 @@ private:
 	debpComponent *pComponent;
 	
 	sParticle *pParticles;
+	debpParticleStates pStates;
 	int pParticleCount;
 	int pParticleSize;
 	
@@ -130,6 +126,9 @@ public:
 	
 	/** Retrieves the particles. */
 	inline sParticle *GetParticles() const{ return pParticles; }
+	/** \brief Particle simulation states. */
+	inline debpParticleStates &GetStates(){ return pStates; }
+	inline const debpParticleStates &GetStates() const{ return pStates; }
 	/** Retrieves the number of particles. */
 	inline int GetParticlesCount() const{ return pParticleCount; }
 	
@@ -139,6 +138,16 @@ public:
 	void ApplyForceField( const debpForceField &forceField, float elapsed );
 	/** Steps the particles. */
 	void StepParticles( float elapsed );
+	/**
+	 * \brief Integrate particle velocities and rotations.
+	 * \details Touches only particle states. Can be called in parallel for different types.
+	 */
+	void IntegrateParticles( float elapsed );
+	/**
+	 * \brief Move particles testing for collisions.
+	 * \details Can trigger collision responses. Call only from the main thread.
+	 */
+	void MoveParticles( float elapsed );
 	/** Finish stepping. */
 	void FinishStepping();
 	/** Update graphic particles. */
@@ -165,30 +174,33 @@ public:
 	void CastBeamParticle( float distance );
 	
 	/** Set the cast values of a particle. */
-	void ParticleSetCastParams( sParticle &particle, float distance, float timeOffset );
+	void ParticleSetCastParams( int index, float distance, float timeOffset );
 	/** Calculate for a particle the cast matrix. */
 	void ParticleCastMatrix( decDMatrix &matrix );
 	/** Create trail emitter for a particle. */
-	void ParticleCreateTrailEmitter( sParticle &particle );
+	void ParticleCreateTrailEmitter( int index );
 	/** Set particle progress parameters for a point in time from cast parameters using the particle lifetime value. */
-	void ParticleSetProgressParams( sParticle &particle );
+	void ParticleSetProgressParams( int index );
 	
 	/** Simulate particle. Returns false if the particle has to be killed due to a collision or true to keep it alive. */
-	bool ParticleSimulate( sParticle &particle, float elapsed );
+	bool ParticleSimulate( int index, float elapsed );
 	/** Test for particle collision. Returns false if the particle has to be killed due to a collision or true to keep it alive. */
-	bool ParticleTestCollision( sParticle &particle, float elapsed );
+	bool ParticleTestCollision( int index, float elapsed );
 	/** Set controllers of a trail or impact emitter. */
-	void ParticleSetEmitterControllers( const sParticle &particle,
+	void ParticleSetEmitterControllers( int index,
 		deParticleEmitterInstance &instance, float linearVelocity );
 	/** Update particle trail emitter if existing. */
-	void ParticleUpdateTrailEmitter( const sParticle &particle );
+	void ParticleUpdateTrailEmitter( int index );
 	/** Set controllers of a trail or impact emitter. */
-	void ParticleSetTrailEmitterControllers( const sParticle &particle,
+	void ParticleSetTrailEmitterControllers( int index,
 		deParticleEmitterInstance &instance, float linearVelocity );
 	/*@}*/
 	
 private:
 	void pCleanUp();
+	void pEnlargeParticles( int size );
+	bool pTestCollision( int index, float elapsed, btSphereShape &shape );
+	bool pCanCollideAny( const btVector3 &boxMin, const btVector3 &boxMax ) const;
 };
 
 #endif
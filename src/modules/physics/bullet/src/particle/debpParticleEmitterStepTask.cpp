@@ -0,0 +1,83 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+
+#include "debpParticleEmitterInstance.h"
+#include "debpParticleEmitterStepTask.h"
+#include "../dePhysicsBullet.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class debpParticleEmitterStepTask
+//////////////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+debpParticleEmitterStepTask::debpParticleEmitterStepTask( dePhysicsBullet &bullet,
+debpParticleEmitterInstance &instance, float elapsed, bool applyForceFields ) :
+deParallelTask( &bullet ),
+pInstance( instance ),
+pElapsed( elapsed ),
+pApplyForceFields( applyForceFields ),
+pFailed( false ){
+}
+
+debpParticleEmitterStepTask::~debpParticleEmitterStepTask(){
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void debpParticleEmitterStepTask::Run(){
+	try{
+		if( pApplyForceFields ){
+			pInstance.ApplyForceFields( pElapsed );
+		}
+		pInstance.IntegrateParticles( pElapsed );
+		
+	}catch( const deException & ){
+		pFailed = true;
+	}
+}
+
+void debpParticleEmitterStepTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString debpParticleEmitterStepTask::GetDebugName() const{
+	return "Bullet:ParticleStep";
+}
+
+decString debpParticleEmitterStepTask::GetDebugDetails() const{
+	decString details;
+	details.Format( "particles=%d elapsed=%g", pInstance.GetParticleCount(), pElapsed );
+	return details;
+}
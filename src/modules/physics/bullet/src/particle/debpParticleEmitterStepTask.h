@@ -0,0 +1,104 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBPPARTICLEEMITTERSTEPTASK_H_
+#define _DEBPPARTICLEEMITTERSTEPTASK_H_
+
+#include <dragengine/parallel/deParallelTask.h>
+
+class dePhysicsBullet;
+class debpParticleEmitterInstance;
+
+
+
+/**
+ * \brief Parallel task integrating particles of an emitter instance.
+ * 
+ * Applies force fields if requested then integrates the particle velocities and rotations
+ * of one emitter instance. Moving particles is done by the caller on the main thread after
+ * the task finished since collision responses can call into the script module. If an
+ * exception is thrown the task is marked failed and the caller has to step the instance.
+ */
+class debpParticleEmitterStepTask : public deParallelTask{
+private:
+	debpParticleEmitterInstance &pInstance;
+	float pElapsed;
+	bool pApplyForceFields;
+	bool pFailed;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/**
+	 * \brief Create task.
+	 * \param[in] instance Emitter instance to integrate. Has to stay valid until the task finished.
+	 * \param[in] elapsed Elapsed time in seconds.
+	 * \param[in] applyForceFields Apply force fields before integrating.
+	 */
+	debpParticleEmitterStepTask( dePhysicsBullet &bullet,
+		debpParticleEmitterInstance &instance, float elapsed, bool applyForceFields );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~debpParticleEmitterStepTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Emitter instance. */
+	inline debpParticleEmitterInstance &GetInstance() const{ return pInstance; }
+	
+	/** \brief Apply force fields before integrating. */
+	inline bool GetApplyForceFields() const{ return pApplyForceFields; }
+	
+	/** \brief Integrating failed. */
+	inline bool GetFailed() const{ return pFailed; }
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	
+	/** \brief Task details for debugging. */
+	virtual decString GetDebugDetails() const;
+	/*@}*/
+};
+
+#endif
@@ -0,0 +1,379 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "debpParticleStates.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Definitions
+////////////////
+
+#define RESIZE_ARRAY(type,array) \
+	{ \
+		type * const newArray = new type[ size ]; \
+		if( array ){ \
+			memcpy( newArray, array, sizeof( type ) * count ); \
+			delete [] array; \
+		} \
+		array = newArray; \
+	}
+
+#define COPY_STATE(array) array[ to ] = array[ from ];
+
+#define MOVE_STATE(type,array) memmove( array + to, array + from, sizeof( type ) * count );
+
+#define FREE_ARRAY(array) if( array ){ delete [] array; }
+
+
+
+// Class debpParticleStates
+/////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+debpParticleStates::debpParticleStates() :
+pPositionX( NULL ),
+pPositionY( NULL ),
+pPositionZ( NULL ),
+pLinearVelocityX( NULL ),
+pLinearVelocityY( NULL ),
+pLinearVelocityZ( NULL ),
+pForceX( NULL ),
+pForceY( NULL ),
+pForceZ( NULL ),
+pRotation( NULL ),
+pAngularVelocity( NULL ),
+pMass( NULL ),
+pDrag( NULL ),
+pDamp( NULL ),
+pForceFieldDirect( NULL ),
+pForceFieldSurface( NULL ),
+pForceFieldMass( NULL ),
+pForceFieldSpeed( NULL ),
+pSize( 0 ){
+}
+
+debpParticleStates::~debpParticleStates(){
+	pCleanUp();
+}
+
+
+
+// Management
+///////////////
+
+void debpParticleStates::Resize( int size, int count ){
+	if( count < 0 || size < count ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	RESIZE_ARRAY( btScalar, pPositionX )
+	RESIZE_ARRAY( btScalar, pPositionY )
+	RESIZE_ARRAY( btScalar, pPositionZ )
+	RESIZE_ARRAY( float, pLinearVelocityX )
+	RESIZE_ARRAY( float, pLinearVelocityY )
+	RESIZE_ARRAY( float, pLinearVelocityZ )
+	RESIZE_ARRAY( float, pForceX )
+	RESIZE_ARRAY( float, pForceY )
+	RESIZE_ARRAY( float, pForceZ )
+	RESIZE_ARRAY( float, pRotation )
+	RESIZE_ARRAY( float, pAngularVelocity )
+	RESIZE_ARRAY( float, pMass )
+	RESIZE_ARRAY( float, pDrag )
+	RESIZE_ARRAY( float, pDamp )
+	RESIZE_ARRAY( float, pForceFieldDirect )
+	RESIZE_ARRAY( float, pForceFieldSurface )
+	RESIZE_ARRAY( float, pForceFieldMass )
+	RESIZE_ARRAY( float, pForceFieldSpeed )
+	
+	pSize = size;
+}
+
+void debpParticleStates::Copy( int to, int from ){
+	COPY_STATE( pPositionX )
+	COPY_STATE( pPositionY )
+	COPY_STATE( pPositionZ )
+	COPY_STATE( pLinearVelocityX )
+	COPY_STATE( pLinearVelocityY )
+	COPY_STATE( pLinearVelocityZ )
+	COPY_STATE( pForceX )
+	COPY_STATE( pForceY )
+	COPY_STATE( pForceZ )
+	COPY_STATE( pRotation )
+	COPY_STATE( pAngularVelocity )
+	COPY_STATE( pMass )
+	COPY_STATE( pDrag )
+	COPY_STATE( pDamp )
+	COPY_STATE( pForceFieldDirect )
+	COPY_STATE( pForceFieldSurface )
+	COPY_STATE( pForceFieldMass )
+	COPY_STATE( pForceFieldSpeed )
+}
+
+void debpParticleStates::Move( int to, int from, int count ){
+	if( count < 1 ){
+		return;
+	}
+	
+	MOVE_STATE( btScalar, pPositionX )
+	MOVE_STATE( btScalar, pPositionY )
+	MOVE_STATE( btScalar, pPositionZ )
+	MOVE_STATE( float, pLinearVelocityX )
+	MOVE_STATE( float, pLinearVelocityY )
+	MOVE_STATE( float, pLinearVelocityZ )
+	MOVE_STATE( float, pForceX )
+	MOVE_STATE( float, pForceY )
+	MOVE_STATE( float, pForceZ )
+	MOVE_STATE( float, pRotation )
+	MOVE_STATE( float, pAngularVelocity )
+	MOVE_STATE( float, pMass )
+	MOVE_STATE( float, pDrag )
+	MOVE_STATE( float, pDamp )
+	MOVE_STATE( float, pForceFieldDirect )
+	MOVE_STATE( float, pForceFieldSurface )
+	MOVE_STATE( float, pForceFieldMass )
+	MOVE_STATE( float, pForceFieldSpeed )
+}
+
+
+
+void debpParticleStates::Integrate( int first, int count, float elapsed ){
+	const int end = first + count;
+	int i = first;
+	
+#ifdef __SSE2__
+	const __m128 vElapsed = _mm_set1_ps( elapsed );
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vOne = _mm_set1_ps( 1.0f );
+	const __m128 vDragThreshold = _mm_set1_ps( 1e-10f );
+	const __m128 vDampThreshold = _mm_set1_ps( 1e-5f );
+	const __m128 vTwoPi = _mm_set1_ps( TWO_PI );
+	const __m128 vInvTwoPi = _mm_set1_ps( 1.0f / TWO_PI );
+	
+	for( ; i<end-3; i+=4 ){
+		// apply force
+		const __m128 elapsedMass = _mm_div_ps( vElapsed, _mm_loadu_ps( pMass + i ) );
+		__m128 vx = _mm_add_ps( _mm_loadu_ps( pLinearVelocityX + i ),
+			_mm_mul_ps( _mm_loadu_ps( pForceX + i ), elapsedMass ) );
+		__m128 vy = _mm_add_ps( _mm_loadu_ps( pLinearVelocityY + i ),
+			_mm_mul_ps( _mm_loadu_ps( pForceY + i ), elapsedMass ) );
+		__m128 vz = _mm_add_ps( _mm_loadu_ps( pLinearVelocityZ + i ),
+			_mm_mul_ps( _mm_loadu_ps( pForceZ + i ), elapsedMass ) );
+		
+		// air drag. factor is 1 for particles without drag
+		const __m128 drag = _mm_loadu_ps( pDrag + i );
+		const __m128 speedSquared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, vx ),
+			_mm_mul_ps( vy, vy ) ), _mm_mul_ps( vz, vz ) );
+		const __m128 maskDrag = _mm_cmpgt_ps( drag, vDragThreshold );
+		const __m128 factorDrag = _mm_or_ps( _mm_andnot_ps( maskDrag, vOne ), _mm_and_ps( maskDrag,
+			_mm_max_ps( _mm_sub_ps( vOne, _mm_mul_ps( _mm_mul_ps( drag, speedSquared ), elapsedMass ) ), vZero ) ) );
+		
+		// damping. factor is 1 for particles without damping
+		const __m128 damp = _mm_loadu_ps( pDamp + i );
+		const __m128 maskDamp = _mm_cmpgt_ps( damp, vDampThreshold );
+		const __m128 factorDamp = _mm_or_ps( _mm_andnot_ps( maskDamp, vOne ),
+			_mm_and_ps( maskDamp, _mm_max_ps( _mm_sub_ps( vOne, damp ), vZero ) ) );
+		
+		const __m128 factorLinear = _mm_mul_ps( factorDrag, factorDamp );
+		vx = _mm_mul_ps( vx, factorLinear );
+		vy = _mm_mul_ps( vy, factorLinear );
+		vz = _mm_mul_ps( vz, factorLinear );
+		_mm_storeu_ps( pLinearVelocityX + i, vx );
+		_mm_storeu_ps( pLinearVelocityY + i, vy );
+		_mm_storeu_ps( pLinearVelocityZ + i, vz );
+		
+		// apply angular rotation wrapping around the same way as fmodf does
+		const __m128 angularVelocity = _mm_mul_ps( _mm_loadu_ps( pAngularVelocity + i ), factorDamp );
+		_mm_storeu_ps( pAngularVelocity + i, angularVelocity );
+		
+		const __m128 rotation = _mm_add_ps( _mm_loadu_ps( pRotation + i ),
+			_mm_mul_ps( angularVelocity, vElapsed ) );
+		const __m128 turns = _mm_cvtepi32_ps( _mm_cvttps_epi32( _mm_mul_ps( rotation, vInvTwoPi ) ) );
+		_mm_storeu_ps( pRotation + i, _mm_sub_ps( rotation, _mm_mul_ps( turns, vTwoPi ) ) );
+	}
+#endif
+	
+	for( ; i<end; i++ ){
+		// apply force
+		const float elapsedMass = elapsed / pMass[ i ];
+		float vx = pLinearVelocityX[ i ] + pForceX[ i ] * elapsedMass;
+		float vy = pLinearVelocityY[ i ] + pForceY[ i ] * elapsedMass;
+		float vz = pLinearVelocityZ[ i ] + pForceZ[ i ] * elapsedMass;
+		
+		// apply air drag
+		float factorLinear = 1.0f;
+		if( pDrag[ i ] > 1e-10f ){
+			factorLinear = decMath::max( 1.0f - pDrag[ i ] * ( vx * vx + vy * vy + vz * vz ) * elapsedMass, 0.0f );
+		}
+		
+		// damp velocities
+		float factorDamp = 1.0f;
+		if( pDamp[ i ] > 1e-5f ){
+			factorDamp = decMath::max( 1.0f - pDamp[ i ], 0.0f );
+		}
+		factorLinear *= factorDamp;
+		
+		pLinearVelocityX[ i ] = vx * factorLinear;
+		pLinearVelocityY[ i ] = vy * factorLinear;
+		pLinearVelocityZ[ i ] = vz * factorLinear;
+		pAngularVelocity[ i ] *= factorDamp;
+		
+		// apply angular rotation
+		pRotation[ i ] = fmodf( pRotation[ i ] + pAngularVelocity[ i ] * elapsed, TWO_PI );
+	}
+}
+
+void debpParticleStates::Advance( int first, int count, float elapsed ){
+	const btScalar btElapsed = ( btScalar )elapsed;
+	const int end = first + count;
+	int i;
+	
+	for( i=first; i<end; i++ ){
+		pPositionX[ i ] += ( btScalar )pLinearVelocityX[ i ] * btElapsed;
+		pPositionY[ i ] += ( btScalar )pLinearVelocityY[ i ] * btElapsed;
+		pPositionZ[ i ] += ( btScalar )pLinearVelocityZ[ i ] * btElapsed;
+	}
+}
+
+void debpParticleStates::ApplyForceField( int count, const sForceField &forceField ){
+	if( forceField.radius < FLOAT_SAFE_EPSILON ){
+		return;
+	}
+	
+	switch( forceField.applicationType ){
+	case deForceField::eatDirect:
+	case deForceField::eatSurface:
+	case deForceField::eatMass:
+	case deForceField::eatSpeed:
+		break;
+		
+	default:
+		DETHROW( deeInvalidParam );
+	}
+	
+	const bool linear = forceField.fieldType == deForceField::eftLinear;
+	const deForceField::eApplicationTypes applicationType = forceField.applicationType;
+	const btScalar ffpx = ( btScalar )forceField.position.x;
+	const btScalar ffpy = ( btScalar )forceField.position.y;
+	const btScalar ffpz = ( btScalar )forceField.position.z;
+	const float radiusSquared = forceField.radius * forceField.radius;
+	const float invRadius = 1.0f / forceField.radius;
+	const float exponent = forceField.exponent;
+	const bool linearFalloff = fabsf( exponent - 1.0f ) < FLOAT_SAFE_EPSILON;
+	const float force = forceField.force;
+	const decMatrix &m = forceField.fluctuation;
+	
+	// rotating the linear direction is the same for all particles
+	const decVector linearDirection( m.TransformNormal( forceField.direction ) );
+	
+	float dx, dy, dz, distanceSquared, distance, falloff, forceFactor, strength;
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		dx = ( float )( pPositionX[ i ] - ffpx );
+		dy = ( float )( pPositionY[ i ] - ffpy );
+		dz = ( float )( pPositionZ[ i ] - ffpz );
+		
+		distanceSquared = dx * dx + dy * dy + dz * dz;
+		if( distanceSquared >= radiusSquared ){
+			continue;
+		}
+		
+		if( ! linear && distanceSquared < 1e-6f ){
+			continue;
+		}
+		
+		distance = sqrtf( distanceSquared );
+		falloff = 1.0f - distance * invRadius;
+		
+		switch( applicationType ){
+		case deForceField::eatDirect:
+			forceFactor = pForceFieldDirect[ i ];
+			break;
+			
+		case deForceField::eatSurface:
+			forceFactor = pForceFieldSurface[ i ];
+			break;
+			
+		case deForceField::eatMass:
+			forceFactor = pForceFieldMass[ i ] * pMass[ i ];
+			break;
+			
+		default: // eatSpeed
+			forceFactor = pForceFieldSpeed[ i ] * sqrtf( pLinearVelocityX[ i ] * pLinearVelocityX[ i ]
+				+ pLinearVelocityY[ i ] * pLinearVelocityY[ i ]
+				+ pLinearVelocityZ[ i ] * pLinearVelocityZ[ i ] );
+		}
+		
+		strength = force * ( linearFalloff ? falloff : powf( falloff, exponent ) ) * forceFactor;
+		
+		if( linear ){
+			pForceX[ i ] += linearDirection.x * strength;
+			pForceY[ i ] += linearDirection.y * strength;
+			pForceZ[ i ] += linearDirection.z * strength;
+			
+		}else{
+			// radial direction is scaled by the falloff before rotating
+			strength *= falloff;
+			pForceX[ i ] += ( m.a11 * dx + m.a12 * dy + m.a13 * dz ) * strength;
+			pForceY[ i ] += ( m.a21 * dx + m.a22 * dy + m.a23 * dz ) * strength;
+			pForceZ[ i ] += ( m.a31 * dx + m.a32 * dy + m.a33 * dz ) * strength;
+		}
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void debpParticleStates::pCleanUp(){
+	FREE_ARRAY( pPositionX )
+	FREE_ARRAY( pPositionY )
+	FREE_ARRAY( pPositionZ )
+	FREE_ARRAY( pLinearVelocityX )
+	FREE_ARRAY( pLinearVelocityY )
+	FREE_ARRAY( pLinearVelocityZ )
+	FREE_ARRAY( pForceX )
+	FREE_ARRAY( pForceY )
+	FREE_ARRAY( pForceZ )
+	FREE_ARRAY( pRotation )
+	FREE_ARRAY( pAngularVelocity )
+	FREE_ARRAY( pMass )
+	FREE_ARRAY( pDrag )
+	FREE_ARRAY( pDamp )
+	FREE_ARRAY( pForceFieldDirect )
+	FREE_ARRAY( pForceFieldSurface )
+	FREE_ARRAY( pForceFieldMass )
+	FREE_ARRAY( pForceFieldSpeed )
+}
@@ -0,0 +1,211 @@
+/* 
+ * Drag[en]gine Bullet Physics Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEBPPARTICLESTATES_H_
+#define _DEBPPARTICLESTATES_H_
+
+#include "LinearMath/btVector3.h"
+
+#include <dragengine/common/math/decMath.h>
+#include <dragengine/resources/forcefield/deForceField.h>
+
+
+
+/**
+ * \brief Particle simulation states.
+ *
+ * Stores the particle states touched by every simulation step as structure of arrays.
+ * Positions use btScalar to keep world precision. All other states use float which
+ * allows the kernels to process four particles at once if SSE2 is available. Kernels
+ * fall back to scalar code otherwise.
+ * 
+ * Index parameters of the accessors are not checked.
+ */
+class debpParticleStates{
+public:
+	/** \brief Force field parameters for ApplyForceField. */
+	struct sForceField{
+		/** \brief Position of force field. */
+		decDVector position;
+		
+		/** \brief Force direction of linear force fields. */
+		decVector direction;
+		
+		/** \brief Fluctuation rotation applied to the force direction. */
+		decMatrix fluctuation;
+		
+		/** \brief Radius of force field. */
+		float radius;
+		
+		/** \brief Falloff exponent. */
+		float exponent;
+		
+		/** \brief Force including fluctuation. */
+		float force;
+		
+		/** \brief Field type. */
+		deForceField::eFieldTypes fieldType;
+		
+		/** \brief Application type. */
+		deForceField::eApplicationTypes applicationType;
+	};
+	
+	
+	
+private:
+	btScalar *pPositionX;
+	btScalar *pPositionY;
+	btScalar *pPositionZ;
+	float *pLinearVelocityX;
+	float *pLinearVelocityY;
+	float *pLinearVelocityZ;
+	float *pForceX;
+	float *pForceY;
+	float *pForceZ;
+	float *pRotation;
+	float *pAngularVelocity;
+	float *pMass;
+	float *pDrag;
+	float *pDamp;
+	float *pForceFieldDirect;
+	float *pForceFieldSurface;
+	float *pForceFieldMass;
+	float *pForceFieldSpeed;
+	int pSize;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create particle states. */
+	debpParticleStates();
+	
+	/** \brief Clean up particle states. */
+	~debpParticleStates();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Number of particles the arrays can hold. */
+	inline int GetSize() const{ return pSize; }
+	
+	/** \brief Resize arrays keeping the states of the first count particles. */
+	void Resize( int size, int count );
+	
+	/** \brief Copy states of particle. */
+	void Copy( int to, int from );
+	
+	/** \brief Move states of range of particles. Ranges can overlap. */
+	void Move( int to, int from, int count );
+	
+	
+	
+	/** \brief Position. */
+	inline btVector3 GetPosition( int index ) const{
+		return btVector3( pPositionX[ index ], pPositionY[ index ], pPositionZ[ index ] ); }
+	
+	/** \brief Set position. */
+	inline void SetPosition( int index, const btVector3 &position ){
+		pPositionX[ index ] = position.getX();
+		pPositionY[ index ] = position.getY();
+		pPositionZ[ index ] = position.getZ(); }
+	
+	/** \brief Linear velocity. */
+	inline btVector3 GetLinearVelocity( int index ) const{
+		return btVector3( ( btScalar )pLinearVelocityX[ index ], ( btScalar )pLinearVelocityY[ index ],
+			( btScalar )pLinearVelocityZ[ index ] ); }
+	
+	/** \brief Set linear velocity. */
+	inline void SetLinearVelocity( int index, const btVector3 &velocity ){
+		pLinearVelocityX[ index ] = ( float )velocity.getX();
+		pLinearVelocityY[ index ] = ( float )velocity.getY();
+		pLinearVelocityZ[ index ] = ( float )velocity.getZ(); }
+	
+	/** \brief Length of linear velocity. */
+	inline float GetLinearSpeed( int index ) const{
+		return sqrtf( pLinearVelocityX[ index ] * pLinearVelocityX[ index ]
+			+ pLinearVelocityY[ index ] * pLinearVelocityY[ index ]
+			+ pLinearVelocityZ[ index ] * pLinearVelocityZ[ index ] ); }
+	
+	/** \brief Set force. */
+	inline void SetForce( int index, const btVector3 &force ){
+		pForceX[ index ] = ( float )force.getX();
+		pForceY[ index ] = ( float )force.getY();
+		pForceZ[ index ] = ( float )force.getZ(); }
+	
+	/** \brief Rotation. */
+	inline float GetRotation( int index ) const{ return pRotation[ index ]; }
+	
+	/** \brief Set rotation. */
+	inline void SetRotation( int index, float rotation ){ pRotation[ index ] = rotation; }
+	
+	/** \brief Angular velocity. */
+	inline float GetAngularVelocity( int index ) const{ return pAngularVelocity[ index ]; }
+	
+	/** \brief Set angular velocity. */
+	inline void SetAngularVelocity( int index, float velocity ){ pAngularVelocity[ index ] = velocity; }
+	
+	/** \brief Mass. */
+	inline float GetMass( int index ) const{ return pMass[ index ]; }
+	
+	/** \brief Set mass. */
+	inline void SetMass( int index, float mass ){ pMass[ index ] = mass; }
+	
+	/** \brief Set drag. */
+	inline void SetDrag( int index, float drag ){ pDrag[ index ] = drag; }
+	
+	/** \brief Set damping. */
+	inline void SetDamp( int index, float damp ){ pDamp[ index ] = damp; }
+	
+	/** \brief Set force field factors. */
+	inline void SetForceFieldFactors( int index, float direct, float surface, float mass, float speed ){
+		pForceFieldDirect[ index ] = direct;
+		pForceFieldSurface[ index ] = surface;
+		pForceFieldMass[ index ] = mass;
+		pForceFieldSpeed[ index ] = speed; }
+	
+	
+	
+	/**
+	 * \brief Integrate velocities and rotation of particles.
+	 * 
+	 * Applies force, air drag and damping to the velocities of count particles starting
+	 * at first then advances the rotation. Positions are not changed.
+	 */
+	void Integrate( int first, int count, float elapsed );
+	
+	/** \brief Advance positions of count particles starting at first by their linear velocity. */
+	void Advance( int first, int count, float elapsed );
+	
+	/** \brief Add force field force to particles. */
+	void ApplyForceField( int count, const sForceField &forceField );
+	/*@}*/
+	
+	
+	
+private:
+	void pCleanUp();
+};
+
+#endif
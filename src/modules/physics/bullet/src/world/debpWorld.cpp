@@ -47,6 +47,7 @@
 #include "../decal/debpDecal.h"
 #include "../forcefield/debpForceField.h"
 #include "../particle/debpParticleEmitterInstance.h"
+#include "../particle/debpParticleEmitterStepTask.h"
 #include "../propfield/debpPropField.h"
 #include "../propfield/debpPropFieldType.h"
 #include "../terrain/heightmap/debpHeightTerrain.h"
@@ -66,6 +67,8 @@
 #include "BulletSoftBody/btSoftBody.h"
 
 #include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/threading/deThreadSafeObjectReference.h>
+#include <dragengine/common/collection/decThreadSafeObjectOrderedSet.h>
 #include <dragengine/resources/collider/deCollider.h>
 #include <dragengine/resources/collider/deColliderVolume.h>
 #include <dragengine/resources/collider/deColliderVisitorIdentify.h>
@@ -90,6 +93,14 @@
 
 
 
+// Definitions
+////////////////
+
+// minimum number of particles of an emitter instance to integrate it using a parallel task
+#define PARALLEL_STEP_PARTICLE_COUNT 1000
+
+
+
 // Class debpWorld
 ////////////////////
 
@@ -1407,6 +1418,7 @@ void debpWorld::pStepForceFields( float elapsed ){
 	float minBendZ = DEG2RAD * -90.0f;
 	float maxBendZ = DEG2RAD * 90.0f;
 	float restitution;
+	bool changed;
 	
 	propField = pWorld.GetRootPropField();
 	while( propField ){
@@ -1418,6 +1430,7 @@ void debpWorld::pStepForceFields( float elapsed ){
 			pftBendStateCount = engPFType->GetBendStateCount();
 			engPFBendStates = engPFType->GetBendStates();
 			restitution = engPFType->GetRestitution() * elapsed;
+			changed = false;
 			
 			for( ptb=0; ptb<pftBendStateCount; ptb++ ){
 				dePropFieldBendState &engBState = engPFBendStates[ ptb ];
@@ -1427,18 +1440,34 @@ void debpWorld::pStepForceFields( float elapsed ){
 				bx = engBState.GetBendX();
 				bz = engBState.GetBendZ();
 				
+				// bend states at rest stay at rest. skip them to not notify unchanged types
+				if( bvx == 0.0f && bvz == 0.0f && bx == 0.0f && bz == 0.0f ){
+					continue;
+				}
+				
 				bvx = ( bvx - bx * restitution ) * damping;
 				bvz = ( bvz - bz * restitution ) * damping;
 				bx = decMath::clamp( bx + bvx * elapsed, minBendX, maxBendX );
 				bz = decMath::clamp( bz + bvz * elapsed, minBendZ, maxBendZ );
 				
+				// damping approaches rest only asymptotically. snap to rest once the values
+				// are too small to be visible
+				if( fabsf( bvx ) < 1e-5f && fabsf( bvz ) < 1e-5f && fabsf( bx ) < 1e-5f && fabsf( bz ) < 1e-5f ){
+					bvx = bvz = bx = bz = 0.0f;
+				}
+				
 				engBState.SetVelocityX( bvx );
 				engBState.SetVelocityZ( bvz );
 				engBState.SetBendX( bx );
 				engBState.SetBendZ( bz );
+				changed = true;
 			}
 			
-			propField->NotifyBendStatesChanged( pt );
+			// graphic modules update instance data only if notified. types without force
+			// field influence come to rest after a while and are then skipped
+			if( changed ){
+				propField->NotifyBendStatesChanged( pt );
+			}
 		}
 		
 		propField = propField->GetLLWorldNext();
@@ -1453,7 +1482,7 @@ void debpWorld::pPrepareParticleEmitters( float elapsed ){
 
 void debpWorld::pStepParticleEmitters( float elapsed ){
 // decTimer timer2;
-	// prepare particles. this applies also force fields if present
+	// prepare particles
 	deParticleEmitterInstance *engEmitterInstance = pWorld.GetRootParticleEmitter();
 	while( engEmitterInstance ){
 		debpParticleEmitterInstance &emitterInstance = *( ( debpParticleEmitterInstance* )engEmitterInstance->GetPeerPhysics() );
@@ -1461,21 +1490,76 @@ void debpWorld::pStepParticleEmitters( float elapsed ){
 		emitterInstance.PrepareParticles( elapsed );
 	}
 	
-	// stpe particles
+	// step particles. integrating particles touches only the particle states of the instance.
+	// large instances are integrated using parallel tasks while the small ones are integrated
+	// directly. force fields are applied during the first step. moving particles can trigger
+	// collision responses calling into the script module and is done after all tasks finished
+	deParallelProcessing &parallelProcessing = pBullet.GetGameEngine()->GetParallelProcessing();
+	const bool useTasks = parallelProcessing.GetCoreCount() > 1 && ! parallelProcessing.GetPaused();
 	const float maxStepSize = 1.0f / 30.0f;
+	decThreadSafeObjectOrderedSet tasks;
+	deThreadSafeObjectReference task;
+	bool firstStep = true;
+	int i;
+	
 	while( elapsed > FLOAT_SAFE_EPSILON ){
 		const float stepElapsed = decMath::min( elapsed, maxStepSize );
 		
 		//int debugCount = 0;
+		try{
+			engEmitterInstance = pWorld.GetRootParticleEmitter();
+			while( engEmitterInstance ){
+				debpParticleEmitterInstance &emitterInstance = *( ( debpParticleEmitterInstance* )engEmitterInstance->GetPeerPhysics() );
+				engEmitterInstance = engEmitterInstance->GetLLWorldNext();
+				
+				if( useTasks && emitterInstance.GetParticleCount() >= PARALLEL_STEP_PARTICLE_COUNT ){
+					task.TakeOver( new debpParticleEmitterStepTask( pBullet, emitterInstance, stepElapsed, firstStep ) );
+					tasks.Add( task );
+					parallelProcessing.AddTask( ( debpParticleEmitterStepTask* )( deThreadSafeObject* )task );
+					
+				}else{
+					if( firstStep ){
+						emitterInstance.ApplyForceFields( stepElapsed );
+					}
+					emitterInstance.IntegrateParticles( stepElapsed );
+				}
+				//debugCount++;
+			}
+			
+		}catch( const deException & ){
+			const int count = tasks.GetCount();
+			for( i=0; i<count; i++ ){
+				parallelProcessing.WaitForTask( ( debpParticleEmitterStepTask* )tasks.GetAt( i ) );
+			}
+			throw;
+		}
+		//pBullet.LogInfoFormat( "pParticleEmittersStep: processed instances %i\n", debugCount );
+		
+		const int count = tasks.GetCount();
+		for( i=0; i<count; i++ ){
+			parallelProcessing.WaitForTask( ( debpParticleEmitterStepTask* )tasks.GetAt( i ) );
+		}
+		
+		// integrate instances of failed tasks again. this time exceptions are thrown
+		for( i=0; i<count; i++ ){
+			const debpParticleEmitterStepTask &stepTask = *( ( debpParticleEmitterStepTask* )tasks.GetAt( i ) );
+			if( stepTask.GetFailed() ){
+				if( stepTask.GetApplyForceFields() ){
+					stepTask.GetInstance().ApplyForceFields( stepElapsed );
+				}
+				stepTask.GetInstance().IntegrateParticles( stepElapsed );
+			}
+		}
+		tasks.RemoveAll();
+		
 		engEmitterInstance = pWorld.GetRootParticleEmitter();
 		while( engEmitterInstance ){
 			debpParticleEmitterInstance &emitterInstance = *( ( debpParticleEmitterInstance* )engEmitterInstance->GetPeerPhysics() );
 			engEmitterInstance = engEmitterInstance->GetLLWorldNext();
-			emitterInstance.StepParticles( stepElapsed );
-			//debugCount++;
+			emitterInstance.MoveParticles( stepElapsed );
 		}
-		//pBullet.LogInfoFormat( "pParticleEmittersStep: processed instances %i\n", debugCount );
 		
+		firstStep = false;
 		elapsed -= stepElapsed;
 	}
 	
@@ -25,6 +25,7 @@
 
 #include "deClassNavigator.h"
 #include "deClassNavigatorPath.h"
+#include "deClassNavigatorPathQuery.h"
 #include "deClassNavigationInfo.h"
 #include "../math/deClassVector.h"
 #include "../math/deClassDVector.h"
@@ -38,6 +39,7 @@
 #include <dragengine/resources/navigation/navigator/deNavigator.h>
 #include <dragengine/resources/navigation/navigator/deNavigatorManager.h>
 #include <dragengine/resources/navigation/navigator/deNavigatorPath.h>
+#include <dragengine/resources/navigation/navigator/deNavigatorPathQuery.h>
 #include <dragengine/resources/navigation/navigator/deNavigatorType.h>
 #include <dragengine/resources/collider/deCollider.h>
 
@@ -356,6 +358,24 @@ void deClassNavigator::nfFindPath::RunFunction( dsRunTime *rt, dsValue *myself )
 	navigator.FindPath( path, start, goal );
 }
 
+// public func void findPathAsync( NavigatorPathQuery query )
+deClassNavigator::nfFindPathAsync::nfFindPathAsync( const sInitData &init ) : dsFunction( init.clsNavigator,
+"findPathAsync", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsVoid ){
+	p_AddParameter( init.clsNavPathQuery ); // query
+}
+void deClassNavigator::nfFindPathAsync::RunFunction( dsRunTime *rt, dsValue *myself ){
+	deNavigator &navigator = *( ( ( const sNavNatDat * )p_GetNativeData( myself ) )->navigator );
+	deScriptingDragonScript &ds = *( ( ( deClassNavigator* )GetOwnerClass() )->GetDS() );
+	
+	deNavigatorPathQuery * const query = ds.GetClassNavigatorPathQuery()->
+		GetNavigatorPathQuery( rt->GetValue( 0 )->GetRealObject() );
+	if( ! query ){
+		DSTHROW( dueNullPointer );
+	}
+	
+	navigator.FindPathAsync( query );
+}
+
 // public func NavigationInfo nearestPoint( DVector point, float radius )
 deClassNavigator::nfNearestPoint::nfNearestPoint( const sInitData &init ) : dsFunction( init.clsNavigator,
 "nearestPoint", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsNavInfo ){
@@ -699,6 +719,7 @@ void deClassNavigator::CreateClassMembers( dsEngine *engine ){
 	init.clsQuaternion = pDS->GetClassQuaternion();
 	init.clsVector = pDS->GetClassVector();
 	init.clsNavPath = pDS->GetClassNavigatorPath();
+	init.clsNavPathQuery = pDS->GetClassNavigatorPathQuery();
 	init.clsNavigationSpaceType = pClsNavigationSpaceType;
 	
 	AddFunction( new nfNew( init ) );
@@ -726,6 +747,7 @@ void deClassNavigator::CreateClassMembers( dsEngine *engine ){
 	AddFunction( new nfRemoveAllTypes( init ) );
 	
 	AddFunction( new nfFindPath( init ) );
+	AddFunction( new nfFindPathAsync( init ) );
 	
 	AddFunction( new nfNearestPoint( init ) );
 	AddFunction( new nfLineCollide( init ) );
@@ -79,6 +79,7 @@ private:
 		dsClass *clsQuaternion;
 		dsClass *clsVector;
 		dsClass *clsNavPath;
+		dsClass *clsNavPathQuery;
 		dsClass *clsNavigationSpaceType;
 	};
 #define DEF_NATFUNC(name) \
@@ -112,6 +113,7 @@ private:
 	DEF_NATFUNC( nfRemoveAllTypes );
 	
 	DEF_NATFUNC( nfFindPath );
+	DEF_NATFUNC( nfFindPathAsync );
 	
 	DEF_NATFUNC( nfNearestPoint );
 	DEF_NATFUNC( nfLineCollide );
@@ -0,0 +1,304 @@
+/* 
+ * Drag[en]gine DragonScript Script Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "deClassNavigatorPath.h"
+#include "deClassNavigatorPathQuery.h"
+#include "../math/deClassDVector.h"
+#include "../../deScriptingDragonScript.h"
+#include "../../deClassPathes.h"
+
+#include <dragengine/resources/navigation/navigator/deNavigatorPathQuery.h>
+
+#include <libdscript/exceptions.h>
+
+
+
+struct sNavPathQueryNatDat{
+	deNavigatorPathQuery *query;
+};
+
+
+
+// Constructors, Destructors
+//////////////////////////////
+
+// public func new( DVector start, DVector goal )
+deClassNavigatorPathQuery::nfNew::nfNew( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+DSFUNC_CONSTRUCTOR, DSFT_CONSTRUCTOR, DSTM_PUBLIC | DSTM_NATIVE, init.clsVoid ){
+	p_AddParameter( init.clsDVector ); // start
+	p_AddParameter( init.clsDVector ); // goal
+}
+void deClassNavigatorPathQuery::nfNew::RunFunction( dsRunTime *rt, dsValue *myself ){
+	sNavPathQueryNatDat &nd = *( ( sNavPathQueryNatDat* )p_GetNativeData( myself ) );
+	const deScriptingDragonScript &ds = ( ( deClassNavigatorPathQuery* )GetOwnerClass() )->GetDS();
+	
+	// clear ( important )
+	nd.query = NULL;
+	
+	// create query
+	const decDVector &start = ds.GetClassDVector()->GetDVector( rt->GetValue( 0 )->GetRealObject() );
+	const decDVector &goal = ds.GetClassDVector()->GetDVector( rt->GetValue( 1 )->GetRealObject() );
+	
+	nd.query = new deNavigatorPathQuery( start, goal );
+}
+
+// public func destructor()
+deClassNavigatorPathQuery::nfDestructor::nfDestructor( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+DSFUNC_DESTRUCTOR, DSFT_DESTRUCTOR, DSTM_PUBLIC | DSTM_NATIVE, init.clsVoid ){
+}
+void deClassNavigatorPathQuery::nfDestructor::RunFunction( dsRunTime *rt, dsValue *myself ){
+	if( myself->GetRealObject()->GetRefCount() != 1 ){
+		return; // protected against GC cleaning up leaking
+	}
+	
+	sNavPathQueryNatDat &nd = *( ( sNavPathQueryNatDat* )p_GetNativeData( myself ) );
+	
+	if( nd.query ){
+		nd.query->FreeReference();
+		nd.query = NULL;
+	}
+}
+
+
+
+// Management
+///////////////
+
+// public func DVector getStart()
+deClassNavigatorPathQuery::nfGetStart::nfGetStart( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"getStart", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsDVector ){
+}
+void deClassNavigatorPathQuery::nfGetStart::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	const deScriptingDragonScript &ds = ( ( deClassNavigatorPathQuery* )GetOwnerClass() )->GetDS();
+	
+	ds.GetClassDVector()->PushDVector( rt, query.GetStart() );
+}
+
+// public func void setStart( DVector start )
+deClassNavigatorPathQuery::nfSetStart::nfSetStart( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"setStart", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsVoid ){
+	p_AddParameter( init.clsDVector ); // start
+}
+void deClassNavigatorPathQuery::nfSetStart::RunFunction( dsRunTime *rt, dsValue *myself ){
+	deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	const deScriptingDragonScript &ds = ( ( deClassNavigatorPathQuery* )GetOwnerClass() )->GetDS();
+	
+	query.SetStart( ds.GetClassDVector()->GetDVector( rt->GetValue( 0 )->GetRealObject() ) );
+}
+
+// public func DVector getGoal()
+deClassNavigatorPathQuery::nfGetGoal::nfGetGoal( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"getGoal", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsDVector ){
+}
+void deClassNavigatorPathQuery::nfGetGoal::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	const deScriptingDragonScript &ds = ( ( deClassNavigatorPathQuery* )GetOwnerClass() )->GetDS();
+	
+	ds.GetClassDVector()->PushDVector( rt, query.GetGoal() );
+}
+
+// public func void setGoal( DVector goal )
+deClassNavigatorPathQuery::nfSetGoal::nfSetGoal( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"setGoal", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsVoid ){
+	p_AddParameter( init.clsDVector ); // goal
+}
+void deClassNavigatorPathQuery::nfSetGoal::RunFunction( dsRunTime *rt, dsValue *myself ){
+	deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	const deScriptingDragonScript &ds = ( ( deClassNavigatorPathQuery* )GetOwnerClass() )->GetDS();
+	
+	query.SetGoal( ds.GetClassDVector()->GetDVector( rt->GetValue( 0 )->GetRealObject() ) );
+}
+
+// public func NavigatorPath getPath()
+deClassNavigatorPathQuery::nfGetPath::nfGetPath( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"getPath", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsNavPath ){
+}
+void deClassNavigatorPathQuery::nfGetPath::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	const deScriptingDragonScript &ds = ( ( deClassNavigatorPathQuery* )GetOwnerClass() )->GetDS();
+	
+	if( query.GetState() != deNavigatorPathQuery::esFinished ){
+		DSTHROW_INFO( dueInvalidAction, "query not finished" );
+	}
+	
+	ds.GetClassNavigatorPath()->PushNavigatorPath( rt, query.GetPath() );
+}
+
+
+
+// public func bool isPending()
+deClassNavigatorPathQuery::nfIsPending::nfIsPending( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"isPending", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsBool ){
+}
+void deClassNavigatorPathQuery::nfIsPending::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	
+	rt->PushBool( query.GetState() == deNavigatorPathQuery::esPending );
+}
+
+// public func bool isFinished()
+deClassNavigatorPathQuery::nfIsFinished::nfIsFinished( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"isFinished", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsBool ){
+}
+void deClassNavigatorPathQuery::nfIsFinished::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	
+	rt->PushBool( query.GetState() == deNavigatorPathQuery::esFinished );
+}
+
+// public func bool isCancelled()
+deClassNavigatorPathQuery::nfIsCancelled::nfIsCancelled( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"isCancelled", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsBool ){
+}
+void deClassNavigatorPathQuery::nfIsCancelled::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	
+	rt->PushBool( query.GetState() == deNavigatorPathQuery::esCancelled );
+}
+
+// public func void cancel()
+deClassNavigatorPathQuery::nfCancel::nfCancel( const sInitData &init ) : dsFunction( init.clsNavPathQuery,
+"cancel", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsVoid ){
+}
+void deClassNavigatorPathQuery::nfCancel::RunFunction( dsRunTime *rt, dsValue *myself ){
+	deNavigatorPathQuery &query = *( ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query );
+	
+	query.Cancel();
+}
+
+
+
+// public func int hashCode()
+deClassNavigatorPathQuery::nfHashCode::nfHashCode( const sInitData &init ) :
+dsFunction( init.clsNavPathQuery, "hashCode", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsInteger ){
+}
+
+void deClassNavigatorPathQuery::nfHashCode::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery * const query = ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query;
+	
+	rt->PushInt( ( intptr_t )query );
+}
+
+// public func bool equals( Object object )
+deClassNavigatorPathQuery::nfEquals::nfEquals( const sInitData &init ) :
+dsFunction( init.clsNavPathQuery, "equals", DSFT_FUNCTION, DSTM_PUBLIC | DSTM_NATIVE, init.clsBool ){
+	p_AddParameter( init.clsObject ); // object
+}
+void deClassNavigatorPathQuery::nfEquals::RunFunction( dsRunTime *rt, dsValue *myself ){
+	const deNavigatorPathQuery * const query = ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself ) )->query;
+	deClassNavigatorPathQuery * const clsNavPathQuery = ( deClassNavigatorPathQuery* )GetOwnerClass();
+	dsValue * const object = rt->GetValue( 0 );
+	
+	if( ! p_IsObjOfType( object, clsNavPathQuery ) ){
+		rt->PushBool( false );
+		
+	}else{
+		const deNavigatorPathQuery * const otherQuery = ( ( const sNavPathQueryNatDat * )p_GetNativeData( object ) )->query;
+		rt->PushBool( query == otherQuery );
+	}
+}
+
+
+
+// Class deClassNavigatorPathQuery
+////////////////////////////////////
+
+// Constructor
+////////////////
+
+deClassNavigatorPathQuery::deClassNavigatorPathQuery( deScriptingDragonScript &ds ) :
+dsClass( "NavigatorPathQuery", DSCT_CLASS, DSTM_PUBLIC | DSTM_NATIVE | DSTM_FIXED ),
+pDS( ds )
+{
+	GetParserInfo()->SetParent( DENS_SCENERY );
+	GetParserInfo()->SetBase( "Object" );
+	
+	p_SetNativeDataSize( sizeof( sNavPathQueryNatDat ) );
+}
+
+deClassNavigatorPathQuery::~deClassNavigatorPathQuery(){
+}
+
+
+
+// Management
+///////////////
+
+void deClassNavigatorPathQuery::CreateClassMembers( dsEngine *engine ){
+	sInitData init;
+	
+	init.clsNavPathQuery = this;
+	
+	init.clsBool = engine->GetClassBool();
+	init.clsInteger = engine->GetClassInt();
+	init.clsObject = engine->GetClassObject();
+	init.clsVoid = engine->GetClassVoid();
+	
+	init.clsDVector = pDS.GetClassDVector();
+	init.clsNavPath = pDS.GetClassNavigatorPath();
+	
+	AddFunction( new nfNew( init ) );
+	AddFunction( new nfDestructor( init ) );
+	
+	AddFunction( new nfGetStart( init ) );
+	AddFunction( new nfSetStart( init ) );
+	AddFunction( new nfGetGoal( init ) );
+	AddFunction( new nfSetGoal( init ) );
+	AddFunction( new nfGetPath( init ) );
+	
+	AddFunction( new nfIsPending( init ) );
+	AddFunction( new nfIsFinished( init ) );
+	AddFunction( new nfIsCancelled( init ) );
+	AddFunction( new nfCancel( init ) );
+	
+	AddFunction( new nfHashCode( init ) );
+	AddFunction( new nfEquals( init ) );
+	
+	CalcMemberOffsets();
+}
+
+deNavigatorPathQuery *deClassNavigatorPathQuery::GetNavigatorPathQuery( dsRealObject *myself ) const{
+	if( ! myself ){
+		return NULL;
+	}
+	
+	return ( ( const sNavPathQueryNatDat * )p_GetNativeData( myself->GetBuffer() ) )->query;
+}
+
+void deClassNavigatorPathQuery::PushNavigatorPathQuery( dsRunTime *rt, deNavigatorPathQuery *query ){
+	if( ! rt ){
+		DSTHROW( dueInvalidParam );
+	}
+	
+	if( ! query ){
+		rt->PushObject( NULL, this );
+		return;
+	}
+	
+	rt->CreateObjectNakedOnStack( this );
+	( ( sNavPathQueryNatDat* )p_GetNativeData( rt->GetValue( 0 )->GetRealObject()->GetBuffer() ) )->query = query;
+	query->AddReference();
+}
@@ -0,0 +1,108 @@
+/* 
+ * Drag[en]gine DragonScript Script Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DEDSCLASSNAVIGATORPATHQUERY_H_
+#define _DEDSCLASSNAVIGATORPATHQUERY_H_
+
+#include <libdscript/libdscript.h>
+
+class deScriptingDragonScript;
+
+class deNavigatorPathQuery;
+
+
+
+/**
+ * \brief Navigator path query script class.
+ */
+class deClassNavigatorPathQuery : public dsClass{
+private:
+	deScriptingDragonScript &pDS;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create script class. */
+	deClassNavigatorPathQuery( deScriptingDragonScript &ds );
+	
+	/** \brief Clean up class. */
+	virtual ~deClassNavigatorPathQuery();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/** \brief Script module. */
+	inline deScriptingDragonScript &GetDS() const{ return pDS; }
+	
+	/** \brief Create class members. */
+	void CreateClassMembers( dsEngine *engine );
+	
+	/** \brief Navigator path query or \em NULL if myself is \em NULL. */
+	deNavigatorPathQuery *GetNavigatorPathQuery( dsRealObject *myself ) const;
+	
+	/** \brief Push navigator path query which can be \em NULL. */
+	void PushNavigatorPathQuery( dsRunTime *rt, deNavigatorPathQuery *query );
+	/*@}*/
+	
+	
+	
+private:
+	struct sInitData{
+		dsClass *clsNavPathQuery;
+		
+		dsClass *clsBool;
+		dsClass *clsInteger;
+		dsClass *clsObject;
+		dsClass *clsVoid;
+		
+		dsClass *clsDVector;
+		dsClass *clsNavPath;
+	};
+#define DEF_NATFUNC(name) \
+	class name : public dsFunction{ \
+	public: \
+		name(const sInitData &init); \
+		void RunFunction(dsRunTime *RT, dsValue *This); \
+	}
+	DEF_NATFUNC( nfNew );
+	DEF_NATFUNC( nfDestructor );
+	
+	DEF_NATFUNC( nfGetStart );
+	DEF_NATFUNC( nfSetStart );
+	DEF_NATFUNC( nfGetGoal );
+	DEF_NATFUNC( nfSetGoal );
+	DEF_NATFUNC( nfGetPath );
+	
+	DEF_NATFUNC( nfIsPending );
+	DEF_NATFUNC( nfIsFinished );
+	DEF_NATFUNC( nfIsCancelled );
+	DEF_NATFUNC( nfCancel );
+	
+	DEF_NATFUNC( nfHashCode );
+	DEF_NATFUNC( nfEquals );
+#undef DEF_NATFUNC
+};
+
+#endif
@@ -48,6 +48,7 @@
 #include "classes/ai/deClassNavigationSpace.h"
 #include "classes/ai/deClassNavigator.h"
 #include "classes/ai/deClassNavigatorPath.h"
+#include "classes/ai/deClassNavigatorPathQuery.h"
 #include "classes/ai/deClassNavigationInfo.h"
 #include "classes/ai/deClassNavigationBlocker.h"
 #include "classes/ai/deClassLocomotion.h"
@@ -420,6 +421,7 @@ deBaseScriptingModule( loadableModule ){
 	pClsNavBlocker = NULL;
 	pClsNavSpace = NULL;
 	pClsNavigator = NULL;
+	pClsNavigatorPathQuery = NULL;
 	pClsNM = NULL;
 	pClsNSL = NULL;
 	pClsNS = NULL;
@@ -1240,6 +1242,7 @@ void deScriptingDragonScript::pLoadBasicPackage(){
 		package->AddHostClass( pClsNavSpace = new deClassNavigationSpace( this ) );
 		package->AddHostClass( pClsNavigator = new deClassNavigator( this ) );
 		package->AddHostClass( pClsNavigatorPath = new deClassNavigatorPath( *this ) );
+		package->AddHostClass( pClsNavigatorPathQuery = new deClassNavigatorPathQuery( *this ) );
 		package->AddHostClass( pClsOccM = new deClassOcclusionMesh( this ) );
 		package->AddHostClass( pClsOccMBuilder = new deClassOcclusionMeshBuilder( *this ) );
 		package->AddHostClass( pClsShaList = new deClassShapeList( this ) );
@@ -138,6 +138,7 @@ class deClassNavigationSpace;
 class deClassNavigationBlocker;
 class deClassNavigator;
 class deClassNavigatorPath;
+class deClassNavigatorPathQuery;
 class deClassNetworkMessage;
 class deClassNetworkState;
 class deClassNetworkStateListener;
@@ -343,6 +344,7 @@ private:
 	deClassNavigationBlocker *pClsNavBlocker;
 	deClassNavigator *pClsNavigator;
 	deClassNavigatorPath *pClsNavigatorPath;
+	deClassNavigatorPathQuery *pClsNavigatorPathQuery;
 	deClassNetworkMessage *pClsNM;
 	deClassNetworkStateListener *pClsNSL;
 	deClassNetworkSystem *pClsNetSys;
@@ -639,6 +641,7 @@ public:
 	inline deClassNavigationSpace *GetClassNavigationSpace() const{ return pClsNavSpace; }
 	inline deClassNavigator *GetClassNavigator() const{ return pClsNavigator; }
 	inline deClassNavigatorPath *GetClassNavigatorPath() const{ return pClsNavigatorPath; }
+	inline deClassNavigatorPathQuery *GetClassNavigatorPathQuery() const{ return pClsNavigatorPathQuery; }
 	inline deClassNetworkMessage *GetClassNetworkMessage() const{ return pClsNM; }
 	inline deClassNetworkState *GetClassNetworkState() const{ return pClsNS; }
 	inline deClassNetworkStateListener *GetClassNetworkStateListener() const{ return pClsNSL; }
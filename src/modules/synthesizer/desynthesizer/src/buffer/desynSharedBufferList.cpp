@@ -26,6 +26,7 @@
 #include "desynSharedBufferList.h"
 
 #include <dragengine/common/exceptions.h>
+#include <dragengine/threading/deMutexGuard.h>
 
 
 
@@ -58,6 +59,7 @@ desynSharedBuffer *desynSharedBufferList::ClaimBuffer( int size ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	deMutexGuard guard( pMutex );
 	const int count = pBuffers.GetCount();
 	desynSharedBuffer *buffer = NULL;
 	int i;
@@ -94,5 +96,6 @@ void desynSharedBufferList::ReleaseBuffer( desynSharedBuffer *buffer ){
 		DETHROW( deeInvalidParam );
 	}
 	
+	deMutexGuard guard( pMutex );
 	buffer->SetInUse( false );
 }
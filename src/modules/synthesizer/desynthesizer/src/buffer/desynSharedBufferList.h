@@ -23,6 +23,7 @@
 #define _DESYNSHAREDBUFFERLIST_H_
 
 #include <dragengine/common/collection/decPointerList.h>
+#include <dragengine/threading/deMutex.h>
 
 class desynSharedBuffer;
 
@@ -30,10 +31,13 @@ class desynSharedBuffer;
 
 /**
  * \brief Shared buffer list.
+ * 
+ * Thread safe since synthesizer instances can be rendered in parallel.
  */
 class desynSharedBufferList{
 private:
 	decPointerList pBuffers;
+	deMutex pMutex;
 	
 	
 	
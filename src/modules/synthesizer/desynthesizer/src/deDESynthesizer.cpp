@@ -30,6 +30,7 @@
 #include "buffer/desynSharedBufferList.h"
 #include "parameters/desynParameter.h"
 #include "parameters/desynParameterList.h"
+#include "parameters/desynPLookAheadBuffers.h"
 #include "sound/desynDecodeBuffer.h"
 #include "sound/desynSound.h"
 #include "synthesizer/desynSynthesizer.h"
@@ -39,6 +40,7 @@
 #include <dragengine/common/exceptions.h>
 #include <dragengine/common/string/unicode/decUnicodeString.h>
 #include <dragengine/common/string/unicode/decUnicodeArgumentList.h>
+#include <dragengine/parallel/deParallelProcessing.h>
 #include <dragengine/systems/modules/deModuleParameter.h>
 
 #include <dragengine/dragengine_configuration.h>
@@ -89,6 +91,7 @@ pCaches( NULL )
 		pConfiguration = new desynConfiguration( *this );
 		
 		pParameterList = new desynParameterList;
+		pParameterList->AddParameter( new desynPLookAheadBuffers( *this ) );
 		
 	}catch( const deException &e ){
 		LogException( e );
@@ -143,6 +146,9 @@ bool deDESynthesizer::Init(){
 
 void deDESynthesizer::CleanUp(){
 	if( pSharedBufferList ){
+		// look-ahead tasks use the shared buffer list
+		GetGameEngine()->GetParallelProcessing().FinishAndRemoveTasksOwnedBy( this );
+		
 		delete pSharedBufferList;
 		pSharedBufferList = NULL;
 	}
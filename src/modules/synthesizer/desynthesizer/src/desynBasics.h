@@ -112,4 +112,13 @@ inline float sample16ToFloat( const Sample16 sample ){ return ( 1.0f / SAMPLE16_
 
 
 
+/**
+ * \brief Number of samples processed per block.
+ * \details Sources evaluate controller curves and generate samples in blocks of this size
+ *          using stack arrays. Multiple of 4 for SIMD processing.
+ */
+#define DESYN_BLOCK_SIZE	256
+
+
+
 #endif
@@ -27,9 +27,11 @@
 #include "desynBasics.h"
 #include "deDESynthesizer.h"
 #include "desynConfiguration.h"
+#include "desynRenderBenchmark.h"
 
 #include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/common/math/decMath.h>
 #include <dragengine/common/string/decString.h>
 #include <dragengine/common/string/unicode/decUnicodeString.h>
 #include <dragengine/common/string/unicode/decUnicodeArgumentList.h>
@@ -62,6 +64,9 @@ void desynCommandExecuter::ExecuteCommand( const decUnicodeArgumentList &command
 		if( command.MatchesArgumentAt( 0, "help" ) ){
 			CmdHelp( command, answer );
 			
+		}else if( command.MatchesArgumentAt( 0, "benchmark" ) ){
+			CmdBenchmark( command, answer );
+			
 		}else{
 			answer.SetFromUTF8( "Unknown command '" );
 			answer += *command.GetArgumentAt( 0 );
@@ -74,4 +79,23 @@ void desynCommandExecuter::ExecuteCommand( const decUnicodeArgumentList &command
 
 void desynCommandExecuter::CmdHelp( const decUnicodeArgumentList &command, decUnicodeString &answer ){
 	answer.SetFromUTF8( "help => Displays this help screen.\n" );
+	answer.AppendFromUTF8( "benchmark [instances] [seconds] => Benchmark offline rendering of synthesizer instances.\n" );
+}
+
+void desynCommandExecuter::CmdBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer ){
+	int instanceCount = 32;
+	float seconds = 10.0f;
+	
+	if( command.GetArgumentCount() > 1 ){
+		instanceCount = decMath::max( command.GetArgumentAt( 1 )->ToInt(), 1 );
+	}
+	if( command.GetArgumentCount() > 2 ){
+		seconds = decMath::max( command.GetArgumentAt( 2 )->ToFloat(), 0.1f );
+	}
+	
+	desynRenderBenchmark benchmark( pModule );
+	decString text;
+	benchmark.Run( instanceCount, seconds, text );
+	pModule.LogInfo( text.GetString() );
+	answer.AppendFromUTF8( text );
 }
@@ -61,6 +61,9 @@ public:
 	
 	/** \brief Display help message. */
 	void CmdHelp( const decUnicodeArgumentList &command, decUnicodeString &answer );
+	
+	/** \brief Benchmark offline rendering of synthesizer instances. */
+	void CmdBenchmark( const decUnicodeArgumentList &command, decUnicodeString &answer );
 	/*@}*/
 };
 
@@ -30,6 +30,7 @@
 #include <dragengine/filesystem/deVirtualFileSystem.h>
 #include <dragengine/common/exceptions.h>
 #include <dragengine/common/file/decPath.h>
+#include <dragengine/common/math/decMath.h>
 #include <dragengine/common/file/decBaseFileReader.h>
 #include <dragengine/common/file/decBaseFileReaderReference.h>
 #include <dragengine/common/xmlparser/decXmlElementTag.h>
@@ -49,7 +50,8 @@
 
 desynConfiguration::desynConfiguration( deDESynthesizer &module ) :
 pModule( module ),
-pStreamBufSizeThreshold( 700000 ) // see desynSound.cpp
+pStreamBufSizeThreshold( 700000 ), // see desynSound.cpp
+pLookAheadBuffers( 2 )
 {
 }
 
@@ -68,6 +70,10 @@ void desynConfiguration::SetStreamBufSizeThreshold( int threshold ){
 	pStreamBufSizeThreshold = threshold;
 }
 
+void desynConfiguration::SetLookAheadBuffers( int buffers ){
+	pLookAheadBuffers = decMath::clamp( buffers, 0, 8 );
+}
+
 
 
 void desynConfiguration::LoadConfig(){
@@ -227,6 +233,9 @@ void desynConfiguration::pLoadConfig( decBaseFileReader *file ){
 			if( strcmp( name, "streamBufSizeThreshold" ) == 0 ){
 				SetStreamBufSizeThreshold( pGetCDataInt( *tag, pStreamBufSizeThreshold ) );
 				
+			}else if( strcmp( name, "lookAheadBuffers" ) == 0 ){
+				SetLookAheadBuffers( pGetCDataInt( *tag, pLookAheadBuffers ) );
+				
 			}else{
 				pModule.LogWarnFormat( "desynthesizer.xml %s(%i:%i): Invalid property name %s.",
 					tag->GetName().GetString(), tag->GetLineNumber(),
@@ -39,6 +39,7 @@ private:
 	deDESynthesizer &pModule;
 	
 	int pStreamBufSizeThreshold;
+	int pLookAheadBuffers;
 	
 	
 	
@@ -62,6 +63,15 @@ public:
 	/** \brief Set buffer size threshold to stream sound samples. */
 	void SetStreamBufSizeThreshold( int threshold );
 	
+	/**
+	 * \brief Number of buffers to render ahead for playing synthesizer instances.
+	 * \details Look-ahead buffers are rendered using parallel tasks. 0 disables look-ahead.
+	 */
+	inline int GetLookAheadBuffers() const{ return pLookAheadBuffers; }
+	
+	/** \brief Set number of buffers to render ahead for playing synthesizer instances. */
+	void SetLookAheadBuffers( int buffers );
+	
 	
 	
 	/** \brief Load configuration. */
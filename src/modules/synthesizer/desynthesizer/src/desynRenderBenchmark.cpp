@@ -0,0 +1,227 @@
+/* 
+ * Drag[en]gine Synthesizer Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "desynRenderBenchmark.h"
+#include "deDESynthesizer.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/deObjectReference.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/curve/decCurveBezier.h>
+#include <dragengine/common/curve/decCurveBezierPoint.h>
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/resources/synthesizer/deSynthesizer.h>
+#include <dragengine/resources/synthesizer/deSynthesizerController.h>
+#include <dragengine/resources/synthesizer/deSynthesizerInstance.h>
+#include <dragengine/resources/synthesizer/deSynthesizerInstanceManager.h>
+#include <dragengine/resources/synthesizer/deSynthesizerInstanceReference.h>
+#include <dragengine/resources/synthesizer/deSynthesizerLink.h>
+#include <dragengine/resources/synthesizer/deSynthesizerManager.h>
+#include <dragengine/resources/synthesizer/deSynthesizerReference.h>
+#include <dragengine/resources/synthesizer/source/deSynthesizerSourceWave.h>
+
+
+
+// Definitions
+////////////////
+
+#define SAMPLE_RATE			44100
+#define CHANNEL_COUNT		2
+#define BYTES_PER_SAMPLE	2
+
+// number of samples rendered per call. similar to the streaming buffer size of audio modules
+#define BUFFER_SAMPLES		1024
+
+
+
+// Class desynRenderBenchmark
+///////////////////////////////
+
+// Constructors and Destructors
+/////////////////////////////////
+
+desynRenderBenchmark::desynRenderBenchmark( deDESynthesizer &module ) :
+pModule( module ){
+}
+
+desynRenderBenchmark::~desynRenderBenchmark(){
+}
+
+
+
+// Management
+///////////////
+
+void desynRenderBenchmark::Run( int instanceCount, float seconds, decString &result ){
+	if( instanceCount < 1 || seconds <= 0.0f ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	deSynthesizerInstanceManager &instanceManager = *pModule.GetGameEngine()->GetSynthesizerInstanceManager();
+	const int sampleCount = ( int )( seconds * ( float )SAMPLE_RATE );
+	const int bufferSize = BUFFER_SAMPLES * CHANNEL_COUNT * BYTES_PER_SAMPLE;
+	deSynthesizerInstanceReference *instances = NULL;
+	char *buffer = NULL;
+	decTimer timer;
+	int i, j;
+	
+	try{
+		deSynthesizerReference synthesizer;
+		synthesizer.TakeOver( pCreateSynthesizer( seconds ) );
+		
+		instances = new deSynthesizerInstanceReference[ instanceCount ];
+		buffer = new char[ bufferSize ];
+		
+		// every instance sweeps the controllers at a different rate to avoid identical output
+		for( i=0; i<instanceCount; i++ ){
+			deSynthesizerInstance * const instance = instanceManager.CreateSynthesizerInstance();
+			instances[ i ].TakeOver( instance );
+			instance->SetSynthesizer( synthesizer );
+			instance->SetSampleCount( sampleCount );
+			
+			const float factor = ( float )( i + 1 ) / ( float )instanceCount;
+			
+			for( j=0; j<instance->GetControllerCount(); j++ ){
+				decCurveBezier curve;
+				curve.SetInterpolationMode( decCurveBezier::eimLinear );
+				curve.AddPoint( decCurveBezierPoint( decVector2( 0.0f, j == 0 ? 0.0f : factor ) ) );
+				curve.AddPoint( decCurveBezierPoint( decVector2( seconds, j == 0 ? factor : 1.0f - factor ) ) );
+				instance->GetControllerAt( j )->SetCurve( curve );
+				instance->NotifyControllerChangedAt( j );
+			}
+		}
+		
+		// first buffer prepares the instances. not part of the measurement
+		for( i=0; i<instanceCount; i++ ){
+			instances[ i ]->GenerateSound( buffer, bufferSize, 0, BUFFER_SAMPLES );
+		}
+		
+		timer.Reset();
+		
+		int offset;
+		for( offset=0; offset<sampleCount; offset+=BUFFER_SAMPLES ){
+			const int samples = decMath::min( sampleCount - offset, BUFFER_SAMPLES );
+			const int size = samples * CHANNEL_COUNT * BYTES_PER_SAMPLE;
+			
+			for( i=0; i<instanceCount; i++ ){
+				instances[ i ]->GenerateSound( buffer, size, offset, samples );
+			}
+		}
+		
+		const float elapsed = timer.GetElapsedTime();
+		const float rendered = seconds * ( float )instanceCount;
+		const int bufferCount = ( sampleCount - 1 ) / BUFFER_SAMPLES + 1;
+		
+		result.Format( "Synthesizer render benchmark: instances=%d length=%.1fs sources=%d"
+#ifdef __SSE__
+			" simd=sse\n"
+#else
+			" simd=none\n"
+#endif
+			"  Render: %.3fms (%.2fus/buffer/instance, %.1fx real time)\n"
+			"  Real time budget: %.2f%% per instance, %.0f instances per core\n",
+			instanceCount, seconds, synthesizer->GetSourceCount(),
+			elapsed * 1e3f, elapsed * 1e6f / ( float )( bufferCount * instanceCount ),
+			rendered / elapsed, elapsed / rendered * 100.0f, rendered / elapsed );
+		
+		delete [] buffer;
+		delete [] instances;
+		
+	}catch( const deException & ){
+		if( buffer ){
+			delete [] buffer;
+		}
+		if( instances ){
+			delete [] instances;
+		}
+		throw;
+	}
+}
+
+
+
+// Private Functions
+//////////////////////
+
+deSynthesizer *desynRenderBenchmark::pCreateSynthesizer( float seconds ){
+	deSynthesizer * const synthesizer = pModule.GetGameEngine()->GetSynthesizerManager()->CreateSynthesizer();
+	deObjectReference object;
+	int i;
+	
+	try{
+		synthesizer->SetChannelCount( CHANNEL_COUNT );
+		synthesizer->SetSampleRate( SAMPLE_RATE );
+		synthesizer->SetBytesPerSample( BYTES_PER_SAMPLE );
+		synthesizer->SetSampleCount( ( int )( seconds * ( float )SAMPLE_RATE ) );
+		
+		// controllers: pitch and panning. the curves are replaced by the instances
+		const char * const controllerNames[ 2 ] = { "pitch", "panning" };
+		
+		for( i=0; i<2; i++ ){
+			deSynthesizerController * const controller = new deSynthesizerController;
+			object.TakeOver( controller );
+			controller->SetName( controllerNames[ i ] );
+			controller->SetValueRange( 0.0f, 1.0f );
+			synthesizer->AddController( controller );
+		}
+		
+		// links: pitch, panning and a tremolo repeating the pitch controller
+		for( i=0; i<3; i++ ){
+			deSynthesizerLink * const link = new deSynthesizerLink;
+			object.TakeOver( link );
+			link->SetController( i == 1 ? 1 : 0 );
+			if( i == 2 ){
+				link->SetRepeat( 8 );
+			}
+			synthesizer->AddLink( link );
+		}
+		
+		// one source per wave type
+		const deSynthesizerSourceWave::eWaveType types[ 4 ] = {
+			deSynthesizerSourceWave::ewtSine, deSynthesizerSourceWave::ewtSquare,
+			deSynthesizerSourceWave::ewtSawTooth, deSynthesizerSourceWave::ewtTriangle };
+		
+		for( i=0; i<4; i++ ){
+			deSynthesizerSourceWave * const source = new deSynthesizerSourceWave;
+			object.TakeOver( source );
+			source->SetType( types[ i ] );
+			source->SetMinFrequency( 110.0f * ( float )( i + 1 ) );
+			source->SetMaxFrequency( 880.0f * ( float )( i + 1 ) );
+			source->SetMinVolume( 0.1f );
+			source->SetMaxVolume( 0.2f );
+			source->SetMinPanning( -1.0f );
+			source->SetMaxPanning( 1.0f );
+			source->GetTargetFrequency().AddLink( 0 );
+			source->GetTargetPanning().AddLink( 1 );
+			source->GetTargetVolume().AddLink( 2 );
+			synthesizer->AddSource( source );
+		}
+		
+	}catch( const deException & ){
+		synthesizer->FreeReference();
+		throw;
+	}
+	
+	return synthesizer;
+}
@@ -0,0 +1,76 @@
+/* 
+ * Drag[en]gine Synthesizer Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DESYNRENDERBENCHMARK_H_
+#define _DESYNRENDERBENCHMARK_H_
+
+#include <dragengine/common/string/decString.h>
+
+class deDESynthesizer;
+class deSynthesizer;
+
+
+
+/**
+ * \brief Offline render benchmark.
+ * 
+ * Developer mode benchmark rendering a synthetic synthesizer definition offline. The
+ * definition contains one wave source per wave type with frequency, panning and volume
+ * linked to controllers. A number of synthesizer instances using the definition each
+ * with individual controller curves are rendered in streaming buffer sized chunks like
+ * the audio module does. Reports the render time relative to real time.
+ */
+class desynRenderBenchmark{
+private:
+	deDESynthesizer &pModule;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create benchmark. */
+	desynRenderBenchmark( deDESynthesizer &module );
+	
+	/** \brief Clean up benchmark. */
+	~desynRenderBenchmark();
+	/*@}*/
+	
+	
+	
+	/** \name Management */
+	/*@{*/
+	/**
+	 * \brief Run benchmark.
+	 * \param[in] instanceCount Number of synthesizer instances to render.
+	 * \param[in] seconds Length of sound to render per instance in seconds.
+	 * \param[out] result Benchmark results in human readable form.
+	 */
+	void Run( int instanceCount, float seconds, decString &result );
+	/*@}*/
+	
+	
+	
+private:
+	deSynthesizer *pCreateSynthesizer( float seconds );
+};
+
+#endif
@@ -0,0 +1,70 @@
+/* 
+ * Drag[en]gine Synthesizer Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "desynPLookAheadBuffers.h"
+#include "../deDESynthesizer.h"
+#include "../desynConfiguration.h"
+
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class desynPLookAheadBuffers
+/////////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+desynPLookAheadBuffers::desynPLookAheadBuffers( deDESynthesizer &synthesizer ) :
+desynParameterInt( synthesizer )
+{
+	SetName( "lookAheadBuffers" );
+	SetDescription( "Number of buffers to render ahead for playing synthesizer instances."
+		" Look-ahead buffers are rendered in parallel tasks reducing the time the audio module"
+		" waits for synthesizer output. Higher values increase the latency until controller"
+		" changes become audible. 0 disables look-ahead rendering. The default value is 2." );
+	SetType( deModuleParameter::eptRanged );
+	SetMinimumValue( 0.0f );
+	SetMaximumValue( 8.0f );
+	SetValueStepSize( 1.0f );
+	SetCategory( ecAdvanced );
+	SetDisplayName( "Look-Ahead Buffers" );
+}
+
+desynPLookAheadBuffers::~desynPLookAheadBuffers(){
+}
+
+
+
+// Management
+///////////////
+
+int desynPLookAheadBuffers::GetParameterInt(){
+	return pSynthesizer.GetConfiguration().GetLookAheadBuffers();
+}
+
+void desynPLookAheadBuffers::SetParameterInt( int value ){
+	pSynthesizer.GetConfiguration().SetLookAheadBuffers( value );
+}
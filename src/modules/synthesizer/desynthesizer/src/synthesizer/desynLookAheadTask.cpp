@@ -0,0 +1,92 @@
+/* 
+ * Drag[en]gine Synthesizer Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "desynLookAheadTask.h"
+#include "desynSynthesizerInstance.h"
+#include "../deDESynthesizer.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Class desynLookAheadTask
+/////////////////////////////
+
+// Constructor, destructor
+////////////////////////////
+
+desynLookAheadTask::desynLookAheadTask( deDESynthesizer &module, desynSynthesizerInstance *instance ) :
+deParallelTask( &module ),
+pInstance( instance )
+{
+	if( ! instance ){
+		DETHROW( deeInvalidParam );
+	}
+}
+
+desynLookAheadTask::~desynLookAheadTask(){
+}
+
+
+
+// Management
+///////////////
+
+void desynLookAheadTask::DropInstance(){
+	deMutexGuard guard( pMutex );
+	pInstance = NULL;
+}
+
+
+
+// Subclass Responsibility
+////////////////////////////
+
+void desynLookAheadTask::Run(){
+	deMutexGuard guard( pMutex );
+	if( ! pInstance || IsCancelled() ){
+		return;
+	}
+	
+	try{
+		pInstance->RenderLookAhead( *this );
+		
+	}catch( const deException &e ){
+		pInstance->GetModule().LogException( e );
+	}
+}
+
+void desynLookAheadTask::Finished(){
+}
+
+
+
+// Debugging
+//////////////
+
+decString desynLookAheadTask::GetDebugName() const{
+	return "DESynthesizer:LookAhead";
+}
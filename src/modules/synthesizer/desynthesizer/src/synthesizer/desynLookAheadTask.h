@@ -0,0 +1,87 @@
+/* 
+ * Drag[en]gine Synthesizer Module
+ *
+ * Copyright (C) 2020, Roland Plüss (roland@rptd.ch)
+ * 
+ * This program is free software; you can redistribute it and/or 
+ * modify it under the terms of the GNU General Public License 
+ * as published by the Free Software Foundation; either 
+ * version 2 of the License, or (at your option) any later 
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef _DESYNLOOKAHEADTASK_H_
+#define _DESYNLOOKAHEADTASK_H_
+
+#include <dragengine/parallel/deParallelTask.h>
+#include <dragengine/threading/deMutex.h>
+
+class deDESynthesizer;
+class desynSynthesizerInstance;
+
+
+
+/**
+ * \brief Parallel task rendering look-ahead buffers of a synthesizer instance.
+ * 
+ * Renders one chunk into the look-ahead ring buffer of the instance. The instance queues
+ * a new task if the ring buffer is not full yet. The instance is dropped by the instance
+ * before it is destroyed. Dropping waits for a running Run() to finish.
+ */
+class desynLookAheadTask : public deParallelTask{
+private:
+	desynSynthesizerInstance *pInstance;
+	deMutex pMutex;
+	
+	
+	
+public:
+	/** \name Constructors and Destructors */
+	/*@{*/
+	/** \brief Create task. */
+	desynLookAheadTask( deDESynthesizer &module, desynSynthesizerInstance *instance );
+	
+protected:
+	/** \brief Clean up task. */
+	virtual ~desynLookAheadTask();
+	/*@}*/
+	
+	
+	
+public:
+	/** \name Management */
+	/*@{*/
+	/** \brief Drop instance waiting for Run() to finish if running. */
+	void DropInstance();
+	/*@}*/
+	
+	
+	
+	/** \name Subclass Responsibility */
+	/*@{*/
+	/** \brief Parallel task implementation. */
+	virtual void Run();
+	
+	/** \brief Processing of task Run() finished. */
+	virtual void Finished();
+	/*@}*/
+	
+	
+	
+	/** \name Debugging */
+	/*@{*/
+	/** \brief Short task name for debugging. */
+	virtual decString GetDebugName() const;
+	/*@}*/
+};
+
+#endif
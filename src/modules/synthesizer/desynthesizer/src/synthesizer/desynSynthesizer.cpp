@@ -60,7 +60,10 @@ pSampleRate( synthesizer.GetSampleRate() ),
 pBytesPerSample( synthesizer.GetBytesPerSample() ),
 pSampleCount( synthesizer.GetSampleCount() ),
 
-pUpdateTracker( 0 ){
+pUpdateTracker( 0 ),
+
+pGenerateCount( 0 ),
+pPrepareWaitCount( 0 ){
 }
 
 desynSynthesizer::~desynSynthesizer(){
@@ -111,6 +114,19 @@ void desynSynthesizer::Prepare(){
 	}
 	
 	deMutexGuard guard( pMutex );
+	
+	// sources can not be replaced while other instances are generating sound with them
+	while( pGenerateCount > 0 ){
+		pPrepareWaitCount++;
+		guard.Unlock();
+		pSemaphorePrepare.Wait();
+		guard.Lock();
+	}
+	
+	if( ! pDirtyContent ){
+		return; // prepared by another instance while waiting
+	}
+	
 	pClearSources();
 	pClearLinks();
 	
@@ -138,15 +154,26 @@ void desynSynthesizer::CleanUpStateData( char *stateData ){
 
 void desynSynthesizer::GenerateSound( const desynSynthesizerInstance &instance,
 char *stateData, float *buffer, int samples ){
+	deMutexGuard guard( pMutex );
 	if( pSilent ){
 		return;
 	}
 	
-	deMutexGuard guard( pMutex );
-	int i;
-	for( i=0; i<pSourceCount; i++ ){
-		pSources[ i ]->GenerateSound( instance, stateData, buffer, samples, 0.0f, 1.0f );
+	pGenerateCount++;
+	guard.Unlock();
+	
+	try{
+		int i;
+		for( i=0; i<pSourceCount; i++ ){
+			pSources[ i ]->GenerateSound( instance, stateData, buffer, samples, 0.0f, 1.0f );
+		}
+		
+	}catch( const deException & ){
+		pEndGenerate();
+		throw;
 	}
+	
+	pEndGenerate();
 }
 
 
@@ -201,6 +228,22 @@ void desynSynthesizer::pCleanUp(){
 
 
 
+void desynSynthesizer::pEndGenerate(){
+	deMutexGuard guard( pMutex );
+	pGenerateCount--;
+	
+	if( pGenerateCount > 0 ){
+		return;
+	}
+	
+	while( pPrepareWaitCount > 0 ){
+		pSemaphorePrepare.Signal();
+		pPrepareWaitCount--;
+	}
+}
+
+
+
 void desynSynthesizer::pClearLinks(){
 	const int count = pLinks.GetCount();
 	int i;
@@ -28,6 +28,7 @@
 #include <dragengine/common/collection/decPointerList.h>
 #include <dragengine/systems/modules/synthesizer/deBaseSynthesizerSynthesizer.h>
 #include <dragengine/threading/deMutex.h>
+#include <dragengine/threading/deSemaphore.h>
 
 class desynSynthesizerInstance;
 class deDESynthesizer;
@@ -63,6 +64,10 @@ private:
 	unsigned int pUpdateTracker;
 	deMutex pMutex;
 	
+	int pGenerateCount;
+	int pPrepareWaitCount;
+	deSemaphore pSemaphorePrepare;
+	
 	
 	
 public:
@@ -136,7 +141,10 @@ public:
 	
 	
 	
-	/** \brief Prepare if required. */
+	/**
+	 * \brief Prepare if required.
+	 * \details Waits for all instances currently generating sound to finish.
+	 */
 	void Prepare();
 	
 	/** \brief Init state data. */
@@ -151,6 +159,9 @@ public:
 	 * \param[out] buffer Buffer to store samples in.
 	 * \param[in] offset Offset in samples to start producing sound at.
 	 * \param[in] samples Number of samples to produce.
+	 * 
+	 * Multiple instances can generate sound at the same time. The mutex is only held
+	 * while entering and leaving.
 	 */
 	void GenerateSound( const desynSynthesizerInstance &instance, char *stateData, float *buffer, int samples );
 	/*@}*/
@@ -176,6 +187,7 @@ public:
 	
 private:
 	void pCleanUp();
+	void pEndGenerate();
 	
 	void pClearLinks();
 	void pCreateLinks();
@@ -62,6 +62,17 @@ float desynSynthesizerController::GetValue( int sample ) const{
 	return pValues[ sample ];
 }
 
+void desynSynthesizerController::GetValues( const int *samples, float *values, int count ) const{
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		if( samples[ i ] < 0 || samples[ i ] >= pValueSize ){
+			DETHROW( deeInvalidParam );
+		}
+		values[ i ] = pValues[ samples[ i ] ];
+	}
+}
+
 void desynSynthesizerController::UpdateValues( int samples, float time, float range ){
 	if( samples < 1 ){
 		return;
@@ -81,8 +92,9 @@ void desynSynthesizerController::UpdateValues( int samples, float time, float ra
 	int i;
 	
 	for( i=0; i<samples; i++ ){
-		pValues[ i ] = pCurve.Evaluate( time + range * ( float )i );
+		pValues[ i ] = time + range * ( float )i;
 	}
+	pCurve.Evaluate( pValues, samples );
 }
 
 void desynSynthesizerController::SetDirty( bool dirty ){
@@ -75,6 +75,9 @@ public:
 	/** \brief Sampled controller values. */
 	float GetValue( int sample ) const;
 	
+	/** \brief Sampled controller values for block of samples. */
+	void GetValues( const int *samples, float *values, int count ) const;
+	
 	/**
 	 * \brief Update controller value for input time.
 	 * \details \em range is \em samples divided by sample rate.
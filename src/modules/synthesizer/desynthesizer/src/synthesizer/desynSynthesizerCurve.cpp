@@ -144,6 +144,22 @@ float desynSynthesizerCurve::Evaluate( float position ) const{
 	}
 }
 
+void desynSynthesizerCurve::Evaluate( float *values, int count ) const{
+	switch( pType ){
+	case eetConstant:
+		pEvaluateConstant( values, count );
+		break;
+		
+	case eetLinear:
+		pEvaluateLinear( values, count );
+		break;
+		
+	case eetSampled:
+	default:
+		pEvaluateSampled( values, count );
+	}
+}
+
 
 
 // Notifications
@@ -333,3 +349,88 @@ float desynSynthesizerCurve::pEvaluateSampled( float position ) const{
 		}
 	}
 }
+
+
+
+void desynSynthesizerCurve::pEvaluateConstant( float *values, int count ) const{
+	int i;
+	
+	if( pCount < 2 ){
+		const float value = pCount == 0 ? 0.0f : pPoints[ 0 ].y;
+		for( i=0; i<count; i++ ){
+			values[ i ] = value;
+		}
+		return;
+	}
+	
+	for( i=0; i<count; i++ ){
+		values[ i ] = pEvaluateConstant( values[ i ] );
+	}
+}
+
+void desynSynthesizerCurve::pEvaluateLinear( float *values, int count ) const{
+	int i;
+	
+	if( pCount < 2 ){
+		const float value = pCount == 0 ? 0.0f : pPoints[ 0 ].y;
+		for( i=0; i<count; i++ ){
+			values[ i ] = value;
+		}
+		return;
+	}
+	
+	// positions inside a block are usually close to each other. start searching the
+	// segment at the segment found for the previous position instead of the first one
+	int segment = 1;
+	
+	for( i=0; i<count; i++ ){
+		const float position = values[ i ];
+		
+		if( position <= pFirst ){
+			values[ i ] = pPoints[ 0 ].y;
+			
+		}else if( position >= pLast ){
+			values[ i ] = pPoints[ pCount - 1 ].y;
+			
+		}else{
+			while( segment > 1 && position < pPoints[ segment - 1 ].x ){
+				segment--;
+			}
+			while( segment < pCount - 1 && position >= pPoints[ segment ].x ){
+				segment++;
+			}
+			
+			const int index = segment - 1;
+			values[ i ] = pPoints[ index ].y + ( position - pPoints[ index ].x ) * pFactors[ index ];
+		}
+	}
+}
+
+void desynSynthesizerCurve::pEvaluateSampled( float *values, int count ) const{
+	int i;
+	
+	if( pCount < 2 ){
+		const float value = pCount == 0 ? 0.0f : pSamples[ 0 ];
+		for( i=0; i<count; i++ ){
+			values[ i ] = value;
+		}
+		return;
+	}
+	
+	const float lastPosition = ( float )( pCount - 1 );
+	
+	for( i=0; i<count; i++ ){
+		const float position = ( values[ i ] - pFirst ) * pStep;
+		
+		if( position < 0.0f ){
+			values[ i ] = pSamples[ 0 ];
+			
+		}else if( position >= lastPosition ){
+			values[ i ] = pSamples[ pCount - 1 ];
+			
+		}else{
+			const int segment = ( int )position;
+			values[ i ] = pSamples[ segment ] + pFactors[ segment ] * ( position - ( float )segment );
+		}
+	}
+}
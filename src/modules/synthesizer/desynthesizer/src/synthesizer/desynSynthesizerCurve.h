@@ -100,6 +100,13 @@ public:
 	
 	/** \brief Evluate curve. */
 	float Evaluate( float position ) const;
+	
+	/**
+	 * \brief Evaluate curve for block of positions.
+	 * \details Replaces each position in \em values with the curve value at the position.
+	 *          Evaluation type is only checked once for the entire block.
+	 */
+	void Evaluate( float *values, int count ) const;
 	/*@}*/
 	/*@}*/
 	
@@ -115,6 +122,10 @@ private:
 	float pEvaluateConstant( float position ) const;
 	float pEvaluateLinear( float position ) const;
 	float pEvaluateSampled( float position ) const;
+	
+	void pEvaluateConstant( float *values, int count ) const;
+	void pEvaluateLinear( float *values, int count ) const;
+	void pEvaluateSampled( float *values, int count ) const;
 };
 
 #endif
@@ -24,15 +24,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "desynLookAheadTask.h"
 #include "desynSynthesizerInstance.h"
 #include "desynSynthesizer.h"
 #include "desynSynthesizerController.h"
 #include "source/desynSynthesizerSource.h"
 #include "../deDESynthesizer.h"
+#include "../desynConfiguration.h"
 #include "../buffer/desynSharedBuffer.h"
 #include "../buffer/desynSharedBufferList.h"
 
+#include <dragengine/deEngine.h>
 #include <dragengine/common/exceptions.h>
+#include <dragengine/parallel/deParallelProcessing.h>
 #include <dragengine/resources/synthesizer/deSynthesizer.h>
 #include <dragengine/resources/synthesizer/deSynthesizerInstance.h>
 #include <dragengine/threading/deMutexGuard.h>
@@ -71,13 +75,23 @@ pDirtyControllers( false ),
 pDirtyFormat( true ),
 
 pStateData( NULL ),
-pStateDataSize( 0 )
+pStateDataSize( 0 ),
+
+pLookAheadBuffer( NULL ),
+pLookAheadSize( 0 ),
+pLookAheadStart( 0 ),
+pLookAheadCount( 0 ),
+pLookAheadOffset( -1 ),
+pLookAheadRenderOffset( -1 ),
+pLookAheadLoopEnd( 0 ),
+pLookAheadPending( false )
 {
 	SynthesizerChanged();
 }
 
 desynSynthesizerInstance::~desynSynthesizerInstance(){
 	deMutexGuard guard( pMutex );
+	pDropLookAheadTask( guard );
 	pCleanUp();
 }
 
@@ -121,6 +135,9 @@ void desynSynthesizerInstance::ControllerChanged( int index ){
 	}
 	GetControllerAt( index ).SetDirty( true );
 	pDirtyControllers = true;
+	
+	// rendered look-ahead samples use the old controller value
+	pDiscardLookAhead();
 }
 
 void desynSynthesizerInstance::PlayTimeChanged(){
@@ -136,6 +153,8 @@ void desynSynthesizerInstance::PlayTimeChanged(){
 
 void desynSynthesizerInstance::Reset(){
 	deMutexGuard guard( pMutex );
+	pDiscardLookAhead();
+	
 	pFreeStateData();
 	if( pSynthesizer ){
 		pCreateStateData();
@@ -160,23 +179,66 @@ void desynSynthesizerInstance::GenerateSound( void *buffer, int bufferSize, int
 	
 	if( pSilent || ! pSynthesizer ){
 		pGenerateSilence( buffer, samples );
+		return;
 	}
 	
-	desynSharedBuffer *sharedBuffer = NULL;
+	if( pLookAheadSize == 0 ){
+		pRenderSound( buffer, offset, samples );
+		return;
+	}
 	
-	try{
-		sharedBuffer = pModule.GetSharedBufferList().ClaimBuffer( samples * pChannelCount );
-		
-		pUpdateControllerValues( samples, offset );
-		pGenerateSound( sharedBuffer, buffer, samples );
+	char *nextBuffer = ( char* )buffer;
+	
+	if( offset == pLookAheadOffset ){
+		const int count = pReadLookAhead( nextBuffer, samples );
+		nextBuffer += pGenerateSampleSize * count;
+		offset += count;
+		samples -= count;
+	}
+	
+	if( samples > 0 ){
+		// look-ahead is missing or not rendered far enough yet. a request starting at 0
+		// while expecting a different offset is the speaker looping back
+		if( offset == 0 && pLookAheadOffset > 0 ){
+			pLookAheadLoopEnd = pLookAheadOffset;
+		}
 		
-		pModule.GetSharedBufferList().ReleaseBuffer( sharedBuffer );
+		pDiscardLookAhead();
+		pRenderSound( nextBuffer, offset, samples );
 		
-	}catch( const deException & ){
-		if( sharedBuffer ){
-			pModule.GetSharedBufferList().ReleaseBuffer( sharedBuffer );
+		pLookAheadOffset = offset + samples;
+		if( pLookAheadOffset >= pLookAheadLoopEnd ){
+			pLookAheadLoopEnd = pLookAheadOffset;
+			pLookAheadOffset = 0;
 		}
-		throw;
+		pLookAheadRenderOffset = pLookAheadOffset;
+	}
+	
+	if( ! pLookAheadPending && pLookAheadCount < pLookAheadSize ){
+		pStartLookAheadTask();
+	}
+}
+
+void desynSynthesizerInstance::RenderLookAhead( deParallelTask &task ){
+	deMutexGuard guard( pMutex );
+	
+	// task has been dropped by the destructor
+	if( pLookAheadTask != &task ){
+		return;
+	}
+	
+	pLookAheadPending = false;
+	
+	try{
+		// render one chunk per task. GenerateSound() calls waiting on the mutex get a
+		// chance to consume rendered samples between tasks
+		if( ! task.IsCancelled() && pRenderLookAheadChunk() && pLookAheadCount < pLookAheadSize ){
+			pStartLookAheadTask();
+		}
+		
+	}catch( const deException &e ){
+		pDiscardLookAhead();
+		pModule.LogException( e );
 	}
 }
 
@@ -186,6 +248,7 @@ void desynSynthesizerInstance::GenerateSound( void *buffer, int bufferSize, int
 //////////////////////
 
 void desynSynthesizerInstance::pCleanUp(){
+	pFreeLookAhead();
 	pClearControllers();
 }
 
@@ -231,6 +294,8 @@ void desynSynthesizerInstance::pPrepare(){
 		pUpdateFormat();
 		pDirtyFormat = false;
 	}
+	
+	pPrepareLookAhead();
 }
 
 void desynSynthesizerInstance::pUpdateFormat(){
@@ -264,6 +329,10 @@ void desynSynthesizerInstance::pUpdateFormat(){
 	// determine streaming parameters
 	pBufferSampleCount = pSampleRate / 20; // 50ms slices
 	pBufferCount = 2; // 100ms buffered
+	
+	// rendered look-ahead uses the old format
+	pFreeLookAhead();
+	pLookAheadLoopEnd = pSampleCount;
 }
 
 
@@ -347,6 +416,25 @@ void desynSynthesizerInstance::pGenerateSilence( void *buffer, int samples ){
 	}
 }
 
+void desynSynthesizerInstance::pRenderSound( void *buffer, int offset, int samples ){
+	desynSharedBuffer *sharedBuffer = NULL;
+	
+	try{
+		sharedBuffer = pModule.GetSharedBufferList().ClaimBuffer( samples * pChannelCount );
+		
+		pUpdateControllerValues( samples, offset );
+		pGenerateSound( sharedBuffer, buffer, samples );
+		
+		pModule.GetSharedBufferList().ReleaseBuffer( sharedBuffer );
+		
+	}catch( const deException & ){
+		if( sharedBuffer ){
+			pModule.GetSharedBufferList().ReleaseBuffer( sharedBuffer );
+		}
+		throw;
+	}
+}
+
 void desynSynthesizerInstance::pGenerateSound( desynSharedBuffer *sharedBuffer, void *buffer, int samples ){
 	// ensure generate buffer has enough size and clear it to 0
 	float * const sharedBufferData = sharedBuffer->GetBuffer();
@@ -412,6 +500,130 @@ void desynSynthesizerInstance::pGenerateSound( desynSharedBuffer *sharedBuffer,
 
 
 
+void desynSynthesizerInstance::pPrepareLookAhead(){
+	int size = 0;
+	if( ! pSilent && pSynthesizer ){
+		size = pBufferSampleCount * pModule.GetConfiguration().GetLookAheadBuffers();
+	}
+	
+	if( size == pLookAheadSize ){
+		return;
+	}
+	
+	pFreeLookAhead();
+	if( size == 0 ){
+		return;
+	}
+	
+	pLookAheadBuffer = new char[ pGenerateSampleSize * size ];
+	pLookAheadSize = size;
+}
+
+void desynSynthesizerInstance::pFreeLookAhead(){
+	if( pLookAheadBuffer ){
+		delete [] pLookAheadBuffer;
+		pLookAheadBuffer = NULL;
+	}
+	pLookAheadSize = 0;
+	pDiscardLookAhead();
+}
+
+void desynSynthesizerInstance::pDiscardLookAhead(){
+	pLookAheadStart = 0;
+	pLookAheadCount = 0;
+	pLookAheadOffset = -1;
+	pLookAheadRenderOffset = -1;
+}
+
+int desynSynthesizerInstance::pReadLookAhead( char *buffer, int samples ){
+	// requests never cross the loop end. if they do the loop end is wrong and the
+	// remaining samples are rendered synchronously
+	const int count = decMath::min( samples, pLookAheadCount, pLookAheadLoopEnd - pLookAheadOffset );
+	if( count <= 0 ){
+		return 0;
+	}
+	
+	const int firstCount = decMath::min( count, pLookAheadSize - pLookAheadStart );
+	memcpy( buffer, pLookAheadBuffer + pGenerateSampleSize * pLookAheadStart,
+		pGenerateSampleSize * firstCount );
+	if( count > firstCount ){
+		memcpy( buffer + pGenerateSampleSize * firstCount, pLookAheadBuffer,
+			pGenerateSampleSize * ( count - firstCount ) );
+	}
+	
+	pLookAheadStart = ( pLookAheadStart + count ) % pLookAheadSize;
+	pLookAheadCount -= count;
+	
+	pLookAheadOffset += count;
+	if( pLookAheadOffset == pLookAheadLoopEnd ){
+		pLookAheadOffset = 0;
+	}
+	
+	return count;
+}
+
+bool desynSynthesizerInstance::pRenderLookAheadChunk(){
+	pPrepare();
+	
+	if( pSilent || ! pSynthesizer || pLookAheadSize == 0 || pLookAheadRenderOffset == -1 ){
+		return false;
+	}
+	
+	const int writePosition = ( pLookAheadStart + pLookAheadCount ) % pLookAheadSize;
+	const int count = decMath::min( decMath::min( pBufferSampleCount,
+		pLookAheadSize - pLookAheadCount ), pLookAheadSize - writePosition,
+		pLookAheadLoopEnd - pLookAheadRenderOffset );
+	if( count <= 0 ){
+		return false;
+	}
+	
+	pRenderSound( pLookAheadBuffer + pGenerateSampleSize * writePosition,
+		pLookAheadRenderOffset, count );
+	
+	pLookAheadCount += count;
+	pLookAheadRenderOffset += count;
+	if( pLookAheadRenderOffset == pLookAheadLoopEnd ){
+		pLookAheadRenderOffset = 0;
+	}
+	
+	return true;
+}
+
+void desynSynthesizerInstance::pStartLookAheadTask(){
+	pLookAheadTask.TakeOver( new desynLookAheadTask( pModule, this ) );
+	pLookAheadPending = true;
+	
+	try{
+		pModule.GetGameEngine()->GetParallelProcessing().AddTaskAsync( pLookAheadTask );
+		
+	}catch( const deException & ){
+		pLookAheadPending = false;
+		throw;
+	}
+}
+
+void desynSynthesizerInstance::pDropLookAheadTask( deMutexGuard &guard ){
+	if( ! pLookAheadTask ){
+		return;
+	}
+	
+	// clearing the task while locked stops a running task from queuing the next one.
+	// unlock while dropping since a running task waits for the lock
+	const deParallelTaskReference taskReference( pLookAheadTask );
+	pLookAheadTask = NULL;
+	pLookAheadPending = false;
+	
+	guard.Unlock();
+	
+	desynLookAheadTask &task = ( desynLookAheadTask& )( deParallelTask& )taskReference;
+	task.DropInstance();
+	task.Cancel();
+	
+	guard.Lock();
+}
+
+
+
 void desynSynthesizerInstance::pUpdateControllerValues( int samples, int offset ){
 	const float time = pInverseSampleRate * ( float )offset;
 	const float range = pInverseSampleRate * ( float )1.0f;
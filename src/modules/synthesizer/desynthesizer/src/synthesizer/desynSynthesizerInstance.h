@@ -26,6 +26,7 @@
 
 #include <dragengine/common/math/decMath.h>
 #include <dragengine/common/collection/decPointerSet.h>
+#include <dragengine/parallel/deParallelTaskReference.h>
 #include <dragengine/systems/modules/synthesizer/deBaseSynthesizerSynthesizerInstance.h>
 #include <dragengine/threading/deMutex.h>
 
@@ -34,12 +35,32 @@ class desynSynthesizerController;
 class desynSharedBuffer;
 class deDESynthesizer;
 
+class deMutexGuard;
+class deParallelTask;
 class deSynthesizerInstance;
 
 
 
 /**
  * \brief SynthesizerInstance peer.
+ * 
+ * If look-ahead buffers are enabled in the configuration sound is rendered ahead into a
+ * ring buffer using parallel tasks while the audio module consumes it. The ring buffer
+ * holds the requested number of streaming buffers in the output format. Requests are
+ * expected to continue where the previous request ended. Requests starting at a
+ * different offset discard the ring buffer and are rendered synchronously. If a request
+ * starts at offset 0 the end of the previous request is used as loop end from then on.
+ * 
+ * Each parallel task renders one streaming buffer worth of samples and queues the next
+ * task if the ring buffer is not full yet. The mutex is thus held for at most one chunk
+ * while GenerateSound() waits.
+ * 
+ * Changing a controller discards the ring buffer since the rendered samples use the old
+ * controller value. The next request is rendered synchronously and look-ahead restarts
+ * after it. Controller changes are thus never delayed but look-ahead only reduces the
+ * latency of GenerateSound() while controllers are stable. If controllers change every
+ * frame the instance behaves nearly as if look-ahead is disabled while still paying for
+ * the discarded look-ahead rendering.
  */
 class desynSynthesizerInstance : public deBaseSynthesizerSynthesizerInstance{
 private:
@@ -71,6 +92,16 @@ private:
 	int pStateDataSize;
 	deMutex pMutex;
 	
+	char *pLookAheadBuffer;
+	int pLookAheadSize;
+	int pLookAheadStart;
+	int pLookAheadCount;
+	int pLookAheadOffset;
+	int pLookAheadRenderOffset;
+	int pLookAheadLoopEnd;
+	bool pLookAheadPending;
+	deParallelTaskReference pLookAheadTask;
+	
 	
 	
 public:
@@ -168,6 +199,12 @@ public:
 	 * \throws EInvalidParam Assigned synthesizer object changed while in use.
 	 */
 	virtual void GenerateSound( void *buffer, int bufferSize, int offset, int samples );
+	
+	/**
+	 * \brief Render next look-ahead chunk queuing the next task if the ring buffer is not full.
+	 * \details Called by desynLookAheadTask from a parallel thread.
+	 */
+	void RenderLookAhead( deParallelTask &task );
 	/*@}*/
 	
 	
@@ -182,8 +219,17 @@ private:
 	void pCreateControllers();
 	
 	void pGenerateSilence( void *buffer, int samples );
+	void pRenderSound( void *buffer, int offset, int samples );
 	void pGenerateSound( desynSharedBuffer *sharedBuffer, void *buffer, int samples );
 	
+	void pPrepareLookAhead();
+	void pFreeLookAhead();
+	void pDiscardLookAhead();
+	int pReadLookAhead( char *buffer, int samples );
+	bool pRenderLookAheadChunk();
+	void pStartLookAheadTask();
+	void pDropLookAheadTask( deMutexGuard &guard );
+	
 	void pUpdateControllerValues( int samples, int offset );
 	
 	void pCreateStateData();
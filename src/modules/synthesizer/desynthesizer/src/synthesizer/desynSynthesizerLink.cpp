@@ -83,3 +83,27 @@ float desynSynthesizerLink::GetValue( const desynSynthesizerInstance &instance,
 	
 	return pCurve.Evaluate( value );
 }
+
+void desynSynthesizerLink::GetValues( const desynSynthesizerInstance &instance,
+const int *samples, float *values, int count, float defaultValue ) const{
+	int i;
+	
+	if( pController == -1 ){
+		for( i=0; i<count; i++ ){
+			values[ i ] = defaultValue;
+		}
+		return;
+	}
+	
+	instance.GetControllerAt( pController ).GetValues( samples, values, count );
+	
+	if( pRepeat > 1 ){
+		const float repeat = ( float )pRepeat;
+		for( i=0; i<count; i++ ){
+			const float value = values[ i ] * repeat;
+			values[ i ] = value - floorf( value );
+		}
+	}
+	
+	pCurve.Evaluate( values, count );
+}
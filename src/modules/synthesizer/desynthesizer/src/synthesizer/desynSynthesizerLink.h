@@ -72,6 +72,15 @@ public:
 	
 	/** \brief Value of link. */
 	float GetValue( const desynSynthesizerInstance &instance, int sample, float defaultValue ) const;
+	
+	/**
+	 * \brief Values of link for block of samples.
+	 * \param[in] samples Controller sample index for each value.
+	 * \param[out] values Values of link.
+	 * \param[in] count Number of values. Has to be at most DESYN_BLOCK_SIZE.
+	 */
+	void GetValues( const desynSynthesizerInstance &instance, const int *samples,
+		float *values, int count, float defaultValue ) const;
 	/*@}*/
 };
 
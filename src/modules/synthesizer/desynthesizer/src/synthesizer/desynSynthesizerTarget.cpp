@@ -23,6 +23,7 @@
 #include <stdlib.h>
 
 #include "desynSynthesizerTarget.h"
+#include "../desynBasics.h"
 #include "desynSynthesizer.h"
 #include "desynSynthesizerInstance.h"
 #include "desynSynthesizerLink.h"
@@ -103,3 +104,43 @@ float desynSynthesizerTarget::GetValue( const desynSynthesizerInstance &instance
 	
 	return decMath::clamp( value, 0.0f, 1.0f );
 }
+
+void desynSynthesizerTarget::GetValues( const desynSynthesizerInstance &instance,
+const int *samples, float *values, int count, float defaultValue ) const{
+	if( count > DESYN_BLOCK_SIZE ){
+		DETHROW( deeInvalidParam );
+	}
+	
+	float linkValues[ DESYN_BLOCK_SIZE ];
+	bool firstValue = true;
+	int i, j;
+	
+	for( i=0; i<pLinkCount; i++ ){
+		const desynSynthesizerLink &link = *pLinks[ i ];
+		if( ! link.HasController() ){
+			continue;
+		}
+		
+		if( firstValue ){
+			link.GetValues( instance, samples, values, count, 1.0f );
+			firstValue = false;
+			
+		}else{
+			link.GetValues( instance, samples, linkValues, count, 1.0f );
+			for( j=0; j<count; j++ ){
+				values[ j ] *= linkValues[ j ];
+			}
+		}
+	}
+	
+	if( firstValue ){
+		for( j=0; j<count; j++ ){
+			values[ j ] = defaultValue;
+		}
+		return;
+	}
+	
+	for( j=0; j<count; j++ ){
+		values[ j ] = decMath::clamp( values[ j ], 0.0f, 1.0f );
+	}
+}
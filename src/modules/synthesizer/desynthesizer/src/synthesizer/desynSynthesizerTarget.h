@@ -66,6 +66,15 @@ public:
 	
 	/** \brief Value of target. */
 	float GetValue( const desynSynthesizerInstance &instance, int sample, float defaultValue ) const;
+	
+	/**
+	 * \brief Values of target for block of samples.
+	 * \param[in] samples Controller sample index for each value.
+	 * \param[out] values Values of target.
+	 * \param[in] count Number of values. Has to be at most DESYN_BLOCK_SIZE.
+	 */
+	void GetValues( const desynSynthesizerInstance &instance, const int *samples,
+		float *values, int count, float defaultValue ) const;
 	/*@}*/
 };
 
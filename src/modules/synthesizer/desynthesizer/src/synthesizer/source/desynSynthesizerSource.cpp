@@ -34,6 +34,131 @@
 #include <dragengine/common/exceptions.h>
 #include <dragengine/resources/synthesizer/source/deSynthesizerSource.h>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+
+
+// Definitions
+////////////////
+
+// mixing kernels. sample count of stereo kernels is the number of sample pairs
+
+static void sScaleMono( float *buffer, const float *factors, int count ){
+	int i = 0;
+	
+#ifdef __SSE__
+	for( ; i<=count-4; i+=4 ){
+		_mm_storeu_ps( buffer + i, _mm_mul_ps( _mm_loadu_ps( buffer + i ), _mm_loadu_ps( factors + i ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		buffer[ i ] *= factors[ i ];
+	}
+}
+
+static void sScaleStereo( float *buffer, const float *factors, int count ){
+	int i = 0;
+	
+#ifdef __SSE__
+	for( ; i<=count-4; i+=4 ){
+		float * const b = buffer + i * 2;
+		const __m128 f = _mm_loadu_ps( factors + i );
+		_mm_storeu_ps( b, _mm_mul_ps( _mm_loadu_ps( b ), _mm_unpacklo_ps( f, f ) ) );
+		_mm_storeu_ps( b + 4, _mm_mul_ps( _mm_loadu_ps( b + 4 ), _mm_unpackhi_ps( f, f ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		buffer[ i * 2 ] *= factors[ i ];
+		buffer[ i * 2 + 1 ] *= factors[ i ];
+	}
+}
+
+static void sMixAddMono( float *output, const float *generated, const float *volumes, int count ){
+	int i = 0;
+	
+#ifdef __SSE__
+	for( ; i<=count-4; i+=4 ){
+		_mm_storeu_ps( output + i, _mm_add_ps( _mm_loadu_ps( output + i ),
+			_mm_mul_ps( _mm_loadu_ps( generated + i ), _mm_loadu_ps( volumes + i ) ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		output[ i ] += generated[ i ] * volumes[ i ];
+	}
+}
+
+static void sMixAddStereo( float *output, const float *generated, const float *volumes, int count ){
+	int i = 0;
+	
+#ifdef __SSE__
+	for( ; i<=count-4; i+=4 ){
+		float * const o = output + i * 2;
+		const float * const g = generated + i * 2;
+		const __m128 v = _mm_loadu_ps( volumes + i );
+		
+		_mm_storeu_ps( o, _mm_add_ps( _mm_loadu_ps( o ),
+			_mm_mul_ps( _mm_loadu_ps( g ), _mm_unpacklo_ps( v, v ) ) ) );
+		_mm_storeu_ps( o + 4, _mm_add_ps( _mm_loadu_ps( o + 4 ),
+			_mm_mul_ps( _mm_loadu_ps( g + 4 ), _mm_unpackhi_ps( v, v ) ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		output[ i * 2 ] += generated[ i * 2 ] * volumes[ i ];
+		output[ i * 2 + 1 ] += generated[ i * 2 + 1 ] * volumes[ i ];
+	}
+}
+
+static void sMixBlendMono( float *output, const float *generated,
+const float *volumes, const float *blendFactors, int count ){
+	int i = 0;
+	
+#ifdef __SSE__
+	for( ; i<=count-4; i+=4 ){
+		const __m128 o = _mm_loadu_ps( output + i );
+		const __m128 g = _mm_mul_ps( _mm_loadu_ps( generated + i ), _mm_loadu_ps( volumes + i ) );
+		_mm_storeu_ps( output + i, _mm_add_ps( o,
+			_mm_mul_ps( _mm_sub_ps( g, o ), _mm_loadu_ps( blendFactors + i ) ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		output[ i ] = decMath::mix( output[ i ], generated[ i ] * volumes[ i ], blendFactors[ i ] );
+	}
+}
+
+static void sMixBlendStereo( float *output, const float *generated,
+const float *volumes, const float *blendFactors, int count ){
+	int i = 0;
+	
+#ifdef __SSE__
+	for( ; i<=count-4; i+=4 ){
+		float * const o = output + i * 2;
+		const float * const g = generated + i * 2;
+		const __m128 v = _mm_loadu_ps( volumes + i );
+		const __m128 b = _mm_loadu_ps( blendFactors + i );
+		
+		const __m128 o1 = _mm_loadu_ps( o );
+		const __m128 g1 = _mm_mul_ps( _mm_loadu_ps( g ), _mm_unpacklo_ps( v, v ) );
+		_mm_storeu_ps( o, _mm_add_ps( o1, _mm_mul_ps( _mm_sub_ps( g1, o1 ), _mm_unpacklo_ps( b, b ) ) ) );
+		
+		const __m128 o2 = _mm_loadu_ps( o + 4 );
+		const __m128 g2 = _mm_mul_ps( _mm_loadu_ps( g + 4 ), _mm_unpackhi_ps( v, v ) );
+		_mm_storeu_ps( o + 4, _mm_add_ps( o2, _mm_mul_ps( _mm_sub_ps( g2, o2 ), _mm_unpackhi_ps( b, b ) ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		output[ i * 2 ] = decMath::mix( output[ i * 2 ], generated[ i * 2 ] * volumes[ i ], blendFactors[ i ] );
+		output[ i * 2 + 1 ] = decMath::mix( output[ i * 2 + 1 ], generated[ i * 2 + 1 ] * volumes[ i ], blendFactors[ i ] );
+	}
+}
+
 
 
 // Class desynSynthesizerSource
@@ -111,6 +236,40 @@ float desynSynthesizerSource::GetPanning( const desynSynthesizerInstance &instan
 }
 
 
+void desynSynthesizerSource::CurveEvalPositions( int *positions, int firstSample, int count,
+float curveOffset, float curveFactor ) const{
+	int i;
+	for( i=0; i<count; i++ ){
+		positions[ i ] = NearestCurveEvalPosition( firstSample + i, curveOffset, curveFactor );
+	}
+}
+
+void desynSynthesizerSource::GetBlendFactors( const desynSynthesizerInstance &instance,
+const int *samples, float *values, int count ) const{
+	pTargetBlendFactor.GetValues( instance, samples, values, count, 1.0f );
+}
+
+void desynSynthesizerSource::GetVolumes( const desynSynthesizerInstance &instance,
+const int *samples, float *values, int count ) const{
+	pTargetVolume.GetValues( instance, samples, values, count, 0.0f );
+	
+	int i;
+	for( i=0; i<count; i++ ){
+		values[ i ] = pMinVolume + pVolumeRange * values[ i ];
+	}
+}
+
+void desynSynthesizerSource::GetPannings( const desynSynthesizerInstance &instance,
+const int *samples, float *values, int count ) const{
+	pTargetPanning.GetValues( instance, samples, values, count, 0.0f );
+	
+	int i;
+	for( i=0; i<count; i++ ){
+		values[ i ] = pMinPanning + pPanningRange * values[ i ];
+	}
+}
+
+
 
 int desynSynthesizerSource::StateDataSize( int offset ){
 	pStateDataOffset = offset;
@@ -220,23 +379,29 @@ float *buffer, int samples, float curveOffset, float curveFactor ){
 		return;
 	}
 	
-	// TODO optimize if blend factor is constant
-	
 	const int channelCount = instance.GetChannelCount();
-	int i;
+	if( channelCount != 1 && channelCount != 2 ){
+		return;
+	}
 	
-	if( channelCount == 1 ){
-		sGenerateBufferMono * const sbuf = ( sGenerateBufferMono* )buffer;
-		for( i=0; i<samples; i++ ){
-			sbuf[ i ].value *= 1.0f - GetBlendFactor( instance, i );
+	int positions[ DESYN_BLOCK_SIZE ];
+	float factors[ DESYN_BLOCK_SIZE ];
+	int first, i;
+	
+	for( first=0; first<samples; first+=DESYN_BLOCK_SIZE ){
+		const int count = decMath::min( samples - first, DESYN_BLOCK_SIZE );
+		
+		CurveEvalPositions( positions, first, count, curveOffset, curveFactor );
+		GetBlendFactors( instance, positions, factors, count );
+		for( i=0; i<count; i++ ){
+			factors[ i ] = 1.0f - factors[ i ];
 		}
 		
-	}else if( channelCount == 2 ){
-		sGenerateBufferStereo * const sbuf = ( sGenerateBufferStereo* )buffer;
-		for( i=0; i<samples; i++ ){
-			const float blendFactor = 1.0f - GetBlendFactor( instance, i );
-			sbuf[ i ].left *= blendFactor;
-			sbuf[ i ].right *= blendFactor;
+		if( channelCount == 1 ){
+			sScaleMono( buffer + first, factors, count );
+			
+		}else{
+			sScaleStereo( buffer + first * 2, factors, count );
 		}
 	}
 }
@@ -276,76 +441,69 @@ float *outputBuffer, const float *generatedBuffer, int samples, float curveOffse
 
 void desynSynthesizerSource::ApplyGeneratedSoundMonoAdd( const desynSynthesizerInstance &instance,
 float *outputBuffer, const float *generatedBuffer, int samples, float curveOffset, float curveFactor ){
-	const sGenerateBufferMono * const generatedSamples = ( const sGenerateBufferMono * )generatedBuffer;
-	sGenerateBufferMono * const outputSamples = ( sGenerateBufferMono* )outputBuffer;
-	int i;
-	
-	// TODO: optimize if volume is static
-	// TODO: optimize if volume is 1
+	int positions[ DESYN_BLOCK_SIZE ];
+	float volumes[ DESYN_BLOCK_SIZE ];
+	int first;
 	
-	for( i=0; i<samples; i++ ){
-		const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-		const float volume = GetVolume( instance, curveEvalPos );
+	for( first=0; first<samples; first+=DESYN_BLOCK_SIZE ){
+		const int count = decMath::min( samples - first, DESYN_BLOCK_SIZE );
 		
-		outputSamples[ i ].value += generatedSamples[ i ].value * volume;
+		CurveEvalPositions( positions, first, count, curveOffset, curveFactor );
+		GetVolumes( instance, positions, volumes, count );
+		
+		sMixAddMono( outputBuffer + first, generatedBuffer + first, volumes, count );
 	}
 }
 
 void desynSynthesizerSource::ApplyGeneratedSoundMonoBlend( const desynSynthesizerInstance &instance,
 float *outputBuffer, const float *generatedBuffer, int samples, float curveOffset, float curveFactor ){
-	const sGenerateBufferMono * const generatedSamples = ( const sGenerateBufferMono * )generatedBuffer;
-	sGenerateBufferMono * const outputSamples = ( sGenerateBufferMono* )outputBuffer;
-	int i;
-	
-	// TODO: optimize if blend-factor and/or volume is static
-	// TODO: optimize if blend-factor and/or volume is 1
+	int positions[ DESYN_BLOCK_SIZE ];
+	float volumes[ DESYN_BLOCK_SIZE ];
+	float blendFactors[ DESYN_BLOCK_SIZE ];
+	int first;
 	
-	for( i=0; i<samples; i++ ){
-		const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-		const float blendFactor = GetBlendFactor( instance, curveEvalPos );
-		const float volume = GetVolume( instance, curveEvalPos );
+	for( first=0; first<samples; first+=DESYN_BLOCK_SIZE ){
+		const int count = decMath::min( samples - first, DESYN_BLOCK_SIZE );
 		
-		outputSamples[ i ].value = decMath::mix( outputSamples[ i ].value,
-			generatedSamples[ i ].value * volume, blendFactor );
+		CurveEvalPositions( positions, first, count, curveOffset, curveFactor );
+		GetVolumes( instance, positions, volumes, count );
+		GetBlendFactors( instance, positions, blendFactors, count );
+		
+		sMixBlendMono( outputBuffer + first, generatedBuffer + first, volumes, blendFactors, count );
 	}
 }
 
 void desynSynthesizerSource::ApplyGeneratedSoundStereoAdd( const desynSynthesizerInstance &instance,
 float *outputBuffer, const float *generatedBuffer, int samples, float curveOffset, float curveFactor ){
-	const sGenerateBufferStereo * const generatedSamples = ( const sGenerateBufferStereo * )generatedBuffer;
-	sGenerateBufferStereo * const outputSamples = ( sGenerateBufferStereo* )outputBuffer;
-	int i;
+	int positions[ DESYN_BLOCK_SIZE ];
+	float volumes[ DESYN_BLOCK_SIZE ];
+	int first;
 	
-	// TODO: optimize if volume is static
-	// TODO: optimize if volume is 1
-	
-	for( i=0; i<samples; i++ ){
-		const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-		const float volume = GetVolume( instance, curveEvalPos );
+	for( first=0; first<samples; first+=DESYN_BLOCK_SIZE ){
+		const int count = decMath::min( samples - first, DESYN_BLOCK_SIZE );
+		
+		CurveEvalPositions( positions, first, count, curveOffset, curveFactor );
+		GetVolumes( instance, positions, volumes, count );
 		
-		outputSamples[ i ].left += generatedSamples[ i ].left * volume;
-		outputSamples[ i ].right += generatedSamples[ i ].right * volume;
+		sMixAddStereo( outputBuffer + first * 2, generatedBuffer + first * 2, volumes, count );
 	}
 }
 
 void desynSynthesizerSource::ApplyGeneratedSoundStereoBlend( const desynSynthesizerInstance &instance,
 float *outputBuffer, const float *generatedBuffer, int samples, float curveOffset, float curveFactor ){
-	const sGenerateBufferStereo * const generatedSamples = ( const sGenerateBufferStereo * )generatedBuffer;
-	sGenerateBufferStereo * const outputSamples = ( sGenerateBufferStereo* )outputBuffer;
-	int i;
+	int positions[ DESYN_BLOCK_SIZE ];
+	float volumes[ DESYN_BLOCK_SIZE ];
+	float blendFactors[ DESYN_BLOCK_SIZE ];
+	int first;
 	
-	// TODO: optimize if blend-factor and/or volume is static
-	// TODO: optimize if blend-factor and/or volume is 1
-	
-	for( i=0; i<samples; i++ ){
-		const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-		const float blendFactor = GetBlendFactor( instance, curveEvalPos );
-		const float volume = GetVolume( instance, curveEvalPos );
+	for( first=0; first<samples; first+=DESYN_BLOCK_SIZE ){
+		const int count = decMath::min( samples - first, DESYN_BLOCK_SIZE );
+		
+		CurveEvalPositions( positions, first, count, curveOffset, curveFactor );
+		GetVolumes( instance, positions, volumes, count );
+		GetBlendFactors( instance, positions, blendFactors, count );
 		
-		outputSamples[ i ].left = decMath::mix( outputSamples[ i ].left,
-			generatedSamples[ i ].left * volume, blendFactor );
-		outputSamples[ i ].right = decMath::mix( outputSamples[ i ].right,
-			generatedSamples[ i ].right * volume, blendFactor );
+		sMixBlendStereo( outputBuffer + first * 2, generatedBuffer + first * 2, volumes, blendFactors, count );
 	}
 }
 
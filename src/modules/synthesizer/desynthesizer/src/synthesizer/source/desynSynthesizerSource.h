@@ -23,6 +23,7 @@
 #define _DESYNSYNTHESIZERSOURCE_H_
 
 #include "../desynSynthesizerTarget.h"
+#include "../../desynBasics.h"
 
 #include <dragengine/resources/synthesizer/source/deSynthesizerSource.h>
 
@@ -147,6 +148,32 @@ public:
 	/** \brief Current panning. */
 	float GetPanning( const desynSynthesizerInstance &instance, int sample ) const;
 	
+	/**
+	 * \brief Nearest curve evaluate positions for block of samples.
+	 * \param[out] positions Curve evaluate position for each sample.
+	 * \param[in] firstSample Index of first sample in the buffer.
+	 * \param[in] count Number of samples.
+	 */
+	void CurveEvalPositions( int *positions, int firstSample, int count,
+		float curveOffset, float curveFactor ) const;
+	
+	/**
+	 * \brief Blend factors for block of samples.
+	 * \param[in] samples Curve evaluate positions as returned by CurveEvalPositions().
+	 * \param[out] values Blend factors.
+	 * \param[in] count Number of samples. Has to be at most DESYN_BLOCK_SIZE.
+	 */
+	void GetBlendFactors( const desynSynthesizerInstance &instance,
+		const int *samples, float *values, int count ) const;
+	
+	/** \brief Volumes for block of samples. Same as GetBlendFactors() but for volume. */
+	void GetVolumes( const desynSynthesizerInstance &instance,
+		const int *samples, float *values, int count ) const;
+	
+	/** \brief Pannings for block of samples. Same as GetBlendFactors() but for panning. */
+	void GetPannings( const desynSynthesizerInstance &instance,
+		const int *samples, float *values, int count ) const;
+	
 	
 	
 	/**
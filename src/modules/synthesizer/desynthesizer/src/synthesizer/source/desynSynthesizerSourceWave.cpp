@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "desynSynthesizerSourceWave.h"
 #include "../desynSynthesizerInstance.h"
@@ -31,6 +32,10 @@
 #include <dragengine/common/math/decMath.h>
 #include <dragengine/resources/synthesizer/source/deSynthesizerSourceWave.h>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 
 
 // Definitions
@@ -38,10 +43,54 @@
 
 #define PI2 ( PI * 2.0f )
 
+// taylor coefficients for sin(z) with z in the range [-pi/2..pi/2]. maximum error is below 1e-6
+#define SINE_C3 ( -1.0f / 6.0f )
+#define SINE_C5 ( 1.0f / 120.0f )
+#define SINE_C7 ( -1.0f / 5040.0f )
+#define SINE_C9 ( 1.0f / 362880.0f )
+#define SINE_C11 ( -1.0f / 39916800.0f )
+
 struct sStateData{
 	float phase;
 };
 
+// scalar version of the SIMD sine used for the remaining samples of a block
+static inline float sSine( float phase ){
+	float x = phase - 0.5f;
+	if( x > 0.25f ){
+		x = 0.5f - x;
+		
+	}else if( x < -0.25f ){
+		x = -0.5f - x;
+	}
+	
+	const float z = x * PI2;
+	const float z2 = z * z;
+	return -z * ( 1.0f + z2 * ( SINE_C3 + z2 * ( SINE_C5 + z2 * ( SINE_C7 + z2 * ( SINE_C9 + z2 * SINE_C11 ) ) ) ) );
+}
+
+// polynomial band-limited step correction for a discontinuity of height 2 at phase 0.
+// increment is the phase increment per sample
+static inline float sPolyBlep( float phase, float increment ){
+	if( phase < increment ){
+		const float t = phase / increment;
+		return t + t - t * t - 1.0f;
+		
+	}else if( phase > 1.0f - increment ){
+		const float t = ( phase - 1.0f ) / increment;
+		return t * t + t + t + 1.0f;
+		
+	}else{
+		return 0.0f;
+	}
+}
+
+// frequencies can be negative or above the nyquist frequency. the correction region
+// has to stay inside half a period on both sides of the discontinuity
+static inline float sBlepIncrement( float increment ){
+	return decMath::min( fabsf( increment ), 0.5f );
+}
+
 
 
 // Class desynSynthesizerSourceWave
@@ -77,6 +126,16 @@ float desynSynthesizerSourceWave::GetFrequency( const desynSynthesizerInstance &
 	return pMinFrequency + pFrequencyRange * pTargetFrequency.GetValue( instance, sample, 0.0f );
 }
 
+void desynSynthesizerSourceWave::GetFrequencies( const desynSynthesizerInstance &instance,
+const int *samples, float *values, int count ) const{
+	pTargetFrequency.GetValues( instance, samples, values, count, 0.0f );
+	
+	int i;
+	for( i=0; i<count; i++ ){
+		values[ i ] = pMinFrequency + pFrequencyRange * values[ i ];
+	}
+}
+
 
 
 int desynSynthesizerSourceWave::StateDataSizeSource( int offset ){
@@ -92,191 +151,157 @@ void desynSynthesizerSourceWave::InitStateDataSource( char *stateData ){
 
 void desynSynthesizerSourceWave::GenerateSourceSound( const desynSynthesizerInstance &instance,
 char *stateData, float *buffer, int samples, float curveOffset, float curveFactor ){
-	switch( pType ){
-	case deSynthesizerSourceWave::ewtSine:
-		GenerateSineWave( instance, stateData, buffer, samples, curveOffset, curveFactor );
-		break;
-		
-	case deSynthesizerSourceWave::ewtSquare:
-		GenerateSquareWave( instance, stateData, buffer, samples, curveOffset, curveFactor );
-		break;
-		
-	case deSynthesizerSourceWave::ewtSawTooth:
-		GenerateSawToothWave( instance, stateData, buffer, samples, curveOffset, curveFactor );
-		break;
-		
-	case deSynthesizerSourceWave::ewtTriangle:
-		GenerateTriangleWave( instance, stateData, buffer, samples, curveOffset, curveFactor );
-		break;
-	};
-}
-
-void desynSynthesizerSourceWave::GenerateSineWave( const desynSynthesizerInstance &instance,
-char *stateData, float *buffer, int samples, float curveOffset, float curveFactor ){
-	sStateData& sdata = *( ( sStateData* )( stateData + GetStateDataOffset() ) );
 	const int channelCount = instance.GetChannelCount();
+	if( channelCount != 1 && channelCount != 2 ){
+		return;
+	}
+	
+	sStateData& sdata = *( ( sStateData* )( stateData + GetStateDataOffset() ) );
 	const float invSampleRate = instance.GetInverseSampleRate();
-	int i;
+	int positions[ DESYN_BLOCK_SIZE ];
+	float phases[ DESYN_BLOCK_SIZE ];
+	float increments[ DESYN_BLOCK_SIZE ];
+	float values[ DESYN_BLOCK_SIZE ];
+	float pannings[ DESYN_BLOCK_SIZE ];
+	float phase = sdata.phase;
+	int first, i;
 	
-	if( channelCount == 1 ){
-		sGenerateBufferMono * const sbuf = ( sGenerateBufferMono* )buffer;
+	for( first=0; first<samples; first+=DESYN_BLOCK_SIZE ){
+		const int count = decMath::min( samples - first, DESYN_BLOCK_SIZE );
 		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			sbuf[ i ].value = sinf( sdata.phase * PI2 );
-			sdata.phase += GetFrequency( instance, curveEvalPos ) * invSampleRate;
+		CurveEvalPositions( positions, first, count, curveOffset, curveFactor );
+		GetFrequencies( instance, positions, increments, count );
+		
+		for( i=0; i<count; i++ ){
+			increments[ i ] *= invSampleRate;
+			phases[ i ] = phase;
+			phase += increments[ i ];
+			phase -= floorf( phase );
 		}
 		
-	}else if( channelCount == 2 ){
-		sGenerateBufferStereo * const sbuf = ( sGenerateBufferStereo* )buffer;
+		switch( pType ){
+		case deSynthesizerSourceWave::ewtSine:
+			GenerateSineWave( phases, values, count );
+			break;
+			
+		case deSynthesizerSourceWave::ewtSquare:
+			GenerateSquareWave( phases, increments, values, count );
+			break;
+			
+		case deSynthesizerSourceWave::ewtSawTooth:
+			GenerateSawToothWave( phases, increments, values, count );
+			break;
+			
+		case deSynthesizerSourceWave::ewtTriangle:
+			GenerateTriangleWave( phases, values, count );
+			break;
+		};
 		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			const float panning = GetPanning( instance, curveEvalPos );
-			const float value = sinf( sdata.phase * PI2 );
+		if( channelCount == 1 ){
+			sGenerateBufferMono * const sbuf = ( sGenerateBufferMono* )buffer + first;
+			for( i=0; i<count; i++ ){
+				sbuf[ i ].value = values[ i ];
+			}
 			
-			sbuf[ i ].left = decMath::min( 1.0f - panning, 1.0f ) * value;
-			sbuf[ i ].right = decMath::min( 1.0f + panning, 1.0f ) * value;
+		}else{
+			sGenerateBufferStereo * const sbuf = ( sGenerateBufferStereo* )buffer + first;
+			GetPannings( instance, positions, pannings, count );
 			
-			sdata.phase += GetFrequency( instance, curveEvalPos ) * invSampleRate;
+			for( i=0; i<count; i++ ){
+				sbuf[ i ].left = decMath::min( 1.0f - pannings[ i ], 1.0f ) * values[ i ];
+				sbuf[ i ].right = decMath::min( 1.0f + pannings[ i ], 1.0f ) * values[ i ];
+			}
 		}
 	}
 	
-	float intpart;
-	sdata.phase = modff( sdata.phase, &intpart );
+	sdata.phase = phase;
 }
 
-void desynSynthesizerSourceWave::GenerateSquareWave( const desynSynthesizerInstance &instance,
-char *stateData, float *buffer, int samples, float curveOffset, float curveFactor ){
-	sStateData& sdata = *( ( sStateData* )( stateData + GetStateDataOffset() ) );
-	const int channelCount = instance.GetChannelCount();
-	const float invSampleRate = instance.GetInverseSampleRate();
-	float intpart;
-	int i;
+void desynSynthesizerSourceWave::GenerateSineWave( const float *phases, float *values, int count ) const{
+	int i = 0;
+	
+#ifdef __SSE__
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 quarter = _mm_set1_ps( 0.25f );
+	const __m128 pi2 = _mm_set1_ps( PI2 );
+	const __m128 c3 = _mm_set1_ps( SINE_C3 );
+	const __m128 c5 = _mm_set1_ps( SINE_C5 );
+	const __m128 c7 = _mm_set1_ps( SINE_C7 );
+	const __m128 c9 = _mm_set1_ps( SINE_C9 );
+	const __m128 c11 = _mm_set1_ps( SINE_C11 );
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 zero = _mm_setzero_ps();
 	
-	if( channelCount == 1 ){
-		sGenerateBufferMono * const sbuf = ( sGenerateBufferMono* )buffer;
+	for( ; i<=count-4; i+=4 ){
+		// sin(2pi*phase) = -sin(2pi*x) with x = phase - 0.5 in the range [-0.5..0.5) .
+		// folding x into [-0.25..0.25] using sin(pi-a) = sin(a) keeps the polynomial accurate
+		__m128 x = _mm_sub_ps( _mm_loadu_ps( phases + i ), half );
 		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			
-			if( sdata.phase < 0.5f ){
-				sbuf[ i ].value = 1.0f;
-				
-			}else{
-				sbuf[ i ].value = -1.0f;
-			}
-			
-			sdata.phase = modff( sdata.phase + GetFrequency( instance, curveEvalPos ) * invSampleRate, &intpart );
-		}
+		const __m128 above = _mm_cmpgt_ps( x, quarter );
+		x = _mm_or_ps( _mm_and_ps( above, _mm_sub_ps( half, x ) ), _mm_andnot_ps( above, x ) );
 		
-	}else if( channelCount == 2 ){
-		sGenerateBufferStereo * const sbuf = ( sGenerateBufferStereo* )buffer;
+		const __m128 below = _mm_cmplt_ps( x, _mm_sub_ps( zero, quarter ) );
+		x = _mm_or_ps( _mm_and_ps( below, _mm_sub_ps( _mm_sub_ps( zero, half ), x ) ), _mm_andnot_ps( below, x ) );
 		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			const float panning = GetPanning( instance, curveEvalPos );
-			const float panLeft = decMath::min( 1.0f - panning, 1.0f );
-			const float panRight = decMath::min( 1.0f + panning, 1.0f );
-			
-			if( sdata.phase < 0.5f ){
-				sbuf[ i ].left = panLeft;
-				sbuf[ i ].right = panRight;
-				
-			}else{
-				sbuf[ i ].left = -panLeft;
-				sbuf[ i ].right = -panRight;
-			}
-			
-			sdata.phase = modff( sdata.phase + GetFrequency( instance, curveEvalPos ) * invSampleRate, &intpart );
-		}
+		const __m128 z = _mm_mul_ps( x, pi2 );
+		const __m128 z2 = _mm_mul_ps( z, z );
+		
+		__m128 poly = _mm_add_ps( c9, _mm_mul_ps( z2, c11 ) );
+		poly = _mm_add_ps( c7, _mm_mul_ps( z2, poly ) );
+		poly = _mm_add_ps( c5, _mm_mul_ps( z2, poly ) );
+		poly = _mm_add_ps( c3, _mm_mul_ps( z2, poly ) );
+		poly = _mm_add_ps( one, _mm_mul_ps( z2, poly ) );
+		
+		_mm_storeu_ps( values + i, _mm_sub_ps( zero, _mm_mul_ps( z, poly ) ) );
+	}
+#endif
+	
+	for( ; i<count; i++ ){
+		values[ i ] = sSine( phases[ i ] );
 	}
 }
 
-void desynSynthesizerSourceWave::GenerateSawToothWave( const desynSynthesizerInstance &instance,
-char *stateData, float *buffer, int samples, float curveOffset, float curveFactor ){
-	sStateData& sdata = *( ( sStateData* )( stateData + GetStateDataOffset() ) );
-	const int channelCount = instance.GetChannelCount();
-	const float invSampleRate = instance.GetInverseSampleRate();
-	float intpart;
+void desynSynthesizerSourceWave::GenerateSquareWave( const float *phases,
+const float *increments, float *values, int count ) const{
 	int i;
 	
-	if( channelCount == 1 ){
-		sGenerateBufferMono * const sbuf = ( sGenerateBufferMono* )buffer;
-		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			sbuf[ i ].value = sdata.phase - 1.0f;
-			sdata.phase = modff( sdata.phase + GetFrequency( instance, curveEvalPos ) * invSampleRate, &intpart );
+	for( i=0; i<count; i++ ){
+		const float phase = phases[ i ];
+		const float increment = sBlepIncrement( increments[ i ] );
+		float phaseFall = phase + 0.5f;
+		if( phaseFall >= 1.0f ){
+			phaseFall -= 1.0f;
 		}
 		
-	}else if( channelCount == 2 ){
-		sGenerateBufferStereo * const sbuf = ( sGenerateBufferStereo* )buffer;
-		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			const float panning = GetPanning( instance, curveEvalPos );
-			const float value = sdata.phase - 1.0f;
-			sbuf[ i ].left = decMath::min( 1.0f - panning, 1.0f ) * value;
-			sbuf[ i ].right = decMath::min( 1.0f + panning, 1.0f ) * value;
-			
-			sdata.phase = modff( sdata.phase + GetFrequency( instance, curveEvalPos ) * invSampleRate, &intpart );
-		}
+		values[ i ] = ( phase < 0.5f ? 1.0f : -1.0f )
+			+ sPolyBlep( phase, increment ) - sPolyBlep( phaseFall, increment );
 	}
 }
 
-void desynSynthesizerSourceWave::GenerateTriangleWave( const desynSynthesizerInstance &instance,
-char *stateData, float *buffer, int samples, float curveOffset, float curveFactor ){
-	sStateData& sdata = *( ( sStateData* )( stateData + GetStateDataOffset() ) );
-	const int channelCount = instance.GetChannelCount();
-	const float invSampleRate = instance.GetInverseSampleRate();
-	float intpart;
+void desynSynthesizerSourceWave::GenerateSawToothWave( const float *phases,
+const float *increments, float *values, int count ) const{
 	int i;
 	
-	if( channelCount == 1 ){
-		sGenerateBufferMono * const sbuf = ( sGenerateBufferMono* )buffer;
-		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			const float fract = sdata.phase * 4.0f;
-			
-			if( fract < 1.0f ){
-				sbuf[ i ].value = fract;
-				
-			}else if( fract > 3.0f ){
-				sbuf[ i ].value = fract - 4.0f;
-				
-			}else{
-				sbuf[ i ].value = 2.0f - fract;
-			}
-			
-			sdata.phase = modff( sdata.phase + GetFrequency( instance, curveEvalPos ) * invSampleRate, &intpart );
-		}
-		
-	}else if( channelCount == 2 ){
-		sGenerateBufferStereo * const sbuf = ( sGenerateBufferStereo* )buffer;
+	for( i=0; i<count; i++ ){
+		// saw tooth drops by 1 at the phase wrap-around hence half the correction
+		values[ i ] = phases[ i ] - 1.0f - 0.5f * sPolyBlep( phases[ i ], sBlepIncrement( increments[ i ] ) );
+	}
+}
+
+void desynSynthesizerSourceWave::GenerateTriangleWave( const float *phases, float *values, int count ) const{
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		const float fract = phases[ i ] * 4.0f;
 		
-		for( i=0; i<samples; i++ ){
-			const int curveEvalPos = NearestCurveEvalPosition( i, curveOffset, curveFactor );
-			const float panning = GetPanning( instance, curveEvalPos );
-			
-			const float fract = sdata.phase * 4.0f;
-			float value;
-			
-			if( fract < 1.0f ){
-				value = fract;
-				
-			}else if( fract > 3.0f ){
-				value = fract - 4.0f;
-				
-			}else{
-				value = 2.0f - fract;
-			}
+		if( fract < 1.0f ){
+			values[ i ] = fract;
 			
-			sbuf[ i ].left = decMath::min( 1.0f - panning, 1.0f ) * value;
-			sbuf[ i ].right = decMath::min( 1.0f + panning, 1.0f ) * value;
+		}else if( fract > 3.0f ){
+			values[ i ] = fract - 4.0f;
 			
-			sdata.phase = modff( sdata.phase + GetFrequency( instance, curveEvalPos ) * invSampleRate, &intpart );
+		}else{
+			values[ i ] = 2.0f - fract;
 		}
 	}
 }
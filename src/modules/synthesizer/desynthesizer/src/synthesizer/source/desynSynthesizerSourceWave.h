@@ -76,6 +76,10 @@ public:
 	/** \brief Current frequency. */
 	float GetFrequency( const desynSynthesizerInstance &instance, int sample ) const;
 	
+	/** \brief Frequencies for block of samples. Same as GetVolumes() but for frequency. */
+	void GetFrequencies( const desynSynthesizerInstance &instance,
+		const int *samples, float *values, int count ) const;
+	
 	
 	
 	/**
@@ -99,21 +103,29 @@ public:
 	virtual void GenerateSourceSound( const desynSynthesizerInstance &instance, char *stateData,
 		float *buffer, int samples, float curveOffset, float curveFactor );
 	
-	/** \brief Generate sine wave. */
-	void GenerateSineWave( const desynSynthesizerInstance &instance, char *stateData,
-		float *buffer, int samples, float curveOffset, float curveFactor );
+	/**
+	 * \brief Generate sine wave for block of samples.
+	 * \param[in] phases Phase in the range [0..1) for each sample.
+	 * \param[out] values Generated samples.
+	 * \param[in] count Number of samples.
+	 */
+	void GenerateSineWave( const float *phases, float *values, int count ) const;
 	
-	/** \brief Generate square wave. */
-	void GenerateSquareWave( const desynSynthesizerInstance &instance, char *stateData,
-		float *buffer, int samples, float curveOffset, float curveFactor );
+	/**
+	 * \brief Generate band-limited square wave for block of samples.
+	 * \details Uses polyBLEP to reduce aliasing at the discontinuities.
+	 * \param[in] phases Phase in the range [0..1) for each sample.
+	 * \param[in] increments Phase increment per sample.
+	 * \param[out] values Generated samples.
+	 * \param[in] count Number of samples.
+	 */
+	void GenerateSquareWave( const float *phases, const float *increments, float *values, int count ) const;
 	
-	/** \brief Generate saw tooth wave. */
-	void GenerateSawToothWave( const desynSynthesizerInstance &instance, char *stateData,
-		float *buffer, int samples, float curveOffset, float curveFactor );
+	/** \brief Generate band-limited saw tooth wave for block of samples. */
+	void GenerateSawToothWave( const float *phases, const float *increments, float *values, int count ) const;
 	
-	/** \brief Generate triangle wave. */
-	void GenerateTriangleWave( const desynSynthesizerInstance &instance, char *stateData,
-		float *buffer, int samples, float curveOffset, float curveFactor );
+	/** \brief Generate triangle wave for block of samples. */
+	void GenerateTriangleWave( const float *phases, float *values, int count ) const;
 	
 	/**
 	 * \brief Skip sound.
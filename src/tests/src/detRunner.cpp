@@ -18,10 +18,13 @@
 #include "math/detColorMatrix.h"
 #include "math/detConvexVolume.h"
 #include "math/detTexMatrix2.h"
+#include "math/detSkinning.h"
 #include "utils/detUniqueID.h"
 #include "utils/detPRNG.h"
 #include "utils/detUuid.h"
 #include "threading/detThreading.h"
+#include "logger/detLoggerAsync.h"
+#include "world/detWorldUpdate.h"
 #include "file/detZFile.h"
 
 #include <dragengine/common/exceptions.h>
@@ -190,6 +193,9 @@ detRunner::detRunner(){
 	pAddTest( new detConvexVolume );
 	pAddTest( new detColorMatrix );
 	pAddTest( new detTexMatrix2 );
+	pAddTest( new detSkinning );
+	pAddTest( new detLoggerAsync );
+	pAddTest( new detWorldUpdate );
 	pAddTest( new detUniqueID );
 	pAddTest( new detPRNG );
 	pAddTest( new detUuid );
@@ -0,0 +1,367 @@
+// includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "detLoggerAsync.h"
+
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/file/decMemoryFile.h>
+#include <dragengine/common/file/decMemoryFileWriter.h>
+#include <dragengine/common/string/decStringList.h>
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/logger/deLoggerAsync.h>
+#include <dragengine/logger/deLoggerFile.h>
+#include <dragengine/logger/deLoggerReference.h>
+#include <dragengine/threading/deMutex.h>
+#include <dragengine/threading/deMutexGuard.h>
+#include <dragengine/threading/deThread.h>
+
+
+
+// definitions
+#define DETLA_THREAD_COUNT 4
+#define DETLA_THREAD_MESSAGES 2000
+
+
+
+// Helpers
+////////////
+
+class cLoggerRecord : public deLogger{
+public:
+	deMutex mutex;
+	decStringList messages;
+	
+	cLoggerRecord(){ }
+	
+	virtual void LogInfo( const char *source, const char *message ){
+		deMutexGuard lock( mutex );
+		decString string;
+		string.Format( "II [%s] %s", source, message );
+		messages.Add( string );
+	}
+	
+	virtual void LogWarn( const char *source, const char *message ){
+		deMutexGuard lock( mutex );
+		decString string;
+		string.Format( "WW [%s] %s", source, message );
+		messages.Add( string );
+	}
+	
+	virtual void LogError( const char *source, const char *message ){
+		deMutexGuard lock( mutex );
+		decString string;
+		string.Format( "EE [%s] %s", source, message );
+		messages.Add( string );
+	}
+	
+	int GetCount(){
+		deMutexGuard lock( mutex );
+		return messages.GetCount();
+	}
+	
+protected:
+	virtual ~cLoggerRecord(){ }
+};
+
+class cThreadLog : public deThread{
+public:
+	deLogger *logger;
+	int number;
+	float *latencies;
+	
+	cThreadLog() : logger( NULL ), number( 0 ), latencies( NULL ){ }
+	virtual ~cThreadLog(){ }
+	
+	virtual void Run(){
+		decTimer timer;
+		int i;
+		
+		for( i=0; i<DETLA_THREAD_MESSAGES; i++ ){
+			timer.Reset();
+			logger->LogInfoFormat( "Test", "thread %d message %d", number, i );
+			if( latencies ){
+				latencies[ i ] = timer.GetElapsedTime();
+			}
+		}
+	}
+};
+
+static int fCompareFloat( const void *a, const void *b ){
+	const float fa = *( ( const float * )a );
+	const float fb = *( ( const float * )b );
+	return fa < fb ? -1 : ( fa > fb ? 1 : 0 );
+}
+
+
+
+// Class detLoggerAsync
+/////////////////////////
+
+// Constructors, destructor
+/////////////////////////////
+
+detLoggerAsync::detLoggerAsync(){
+}
+
+detLoggerAsync::~detLoggerAsync(){
+}
+
+
+
+// Testing
+////////////
+
+void detLoggerAsync::Prepare(){
+}
+
+void detLoggerAsync::Run(){
+	pTestOrder();
+	pTestErrorDrains();
+	pTestFormat();
+	pTestThreads();
+	pTestFileBatched();
+	pTestPerformance();
+}
+
+void detLoggerAsync::CleanUp(){
+}
+
+const char *detLoggerAsync::GetTestName(){
+	return "LoggerAsync";
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void detLoggerAsync::pTestOrder(){
+	SetSubTestNum( 0 );
+	cLoggerRecord * const record = new cLoggerRecord;
+	deLoggerReference refRecord;
+	refRecord.TakeOver( record );
+	
+	deLoggerReference refLogger;
+	refLogger.TakeOver( new deLoggerAsync( record ) );
+	deLoggerAsync &logger = ( deLoggerAsync& )( deLogger& )refLogger;
+	
+	int i;
+	for( i=0; i<100; i++ ){
+		logger.LogInfoFormat( "Test", "message %d", i );
+	}
+	logger.LogWarn( "Test", "warning" );
+	logger.Flush();
+	
+	ASSERT_EQUAL( record->GetCount(), 101 );
+	for( i=0; i<100; i++ ){
+		decString expected;
+		expected.Format( "II [Test] message %d", i );
+		ASSERT_TRUE( record->messages.GetAt( i ) == expected );
+	}
+	ASSERT_TRUE( record->messages.GetAt( 100 ) == "WW [Test] warning" );
+	
+	// pending messages are written if the logger is released
+	logger.LogInfo( "Test", "last" );
+	refLogger = NULL;
+	ASSERT_EQUAL( record->GetCount(), 102 );
+	ASSERT_TRUE( record->messages.GetAt( 101 ) == "II [Test] last" );
+}
+
+void detLoggerAsync::pTestErrorDrains(){
+	SetSubTestNum( 1 );
+	cLoggerRecord * const record = new cLoggerRecord;
+	deLoggerReference refRecord;
+	refRecord.TakeOver( record );
+	
+	deLoggerReference refLogger;
+	refLogger.TakeOver( new deLoggerAsync( record ) );
+	deLogger &logger = refLogger;
+	
+	logger.LogInfo( "Test", "info" );
+	logger.LogError( "Test", "error" );
+	ASSERT_EQUAL( record->GetCount(), 2 );
+	ASSERT_TRUE( record->messages.GetAt( 0 ) == "II [Test] info" );
+	ASSERT_TRUE( record->messages.GetAt( 1 ) == "EE [Test] error" );
+	
+	logger.LogException( "Test", deeInvalidParam( "file", 1 ) );
+	ASSERT_TRUE( record->GetCount() > 2 );
+}
+
+void detLoggerAsync::pTestFormat(){
+	SetSubTestNum( 2 );
+	cLoggerRecord * const record = new cLoggerRecord;
+	deLoggerReference refRecord;
+	refRecord.TakeOver( record );
+	
+	deLoggerReference refLogger;
+	refLogger.TakeOver( new deLoggerAsync( record ) );
+	deLoggerAsync &logger = ( deLoggerAsync& )( deLogger& )refLogger;
+	
+	// longer than the stack format buffer
+	decString text;
+	int i;
+	for( i=0; i<100; i++ ){
+		text.AppendFormat( "%d-abcdefghij ", i );
+	}
+	
+	logger.LogInfoFormat( "Test", "%s|%d", text.GetString(), 42 );
+	logger.Flush();
+	
+	decString expected;
+	expected.Format( "II [Test] %s|42", text.GetString() );
+	ASSERT_EQUAL( record->GetCount(), 1 );
+	ASSERT_TRUE( record->messages.GetAt( 0 ) == expected );
+}
+
+void detLoggerAsync::pTestThreads(){
+	SetSubTestNum( 3 );
+	cLoggerRecord * const record = new cLoggerRecord;
+	deLoggerReference refRecord;
+	refRecord.TakeOver( record );
+	
+	deLoggerReference refLogger;
+	refLogger.TakeOver( new deLoggerAsync( record ) );
+	deLoggerAsync &logger = ( deLoggerAsync& )( deLogger& )refLogger;
+	
+	cThreadLog threads[ DETLA_THREAD_COUNT ];
+	int i;
+	
+	for( i=0; i<DETLA_THREAD_COUNT; i++ ){
+		threads[ i ].logger = &logger;
+		threads[ i ].number = i;
+		threads[ i ].Start();
+	}
+	for( i=0; i<DETLA_THREAD_COUNT; i++ ){
+		threads[ i ].WaitForExit();
+	}
+	logger.Flush();
+	
+	ASSERT_EQUAL( record->GetCount(), DETLA_THREAD_COUNT * DETLA_THREAD_MESSAGES );
+	
+	// messages of each thread arrive in the order they have been logged
+	int next[ DETLA_THREAD_COUNT ];
+	for( i=0; i<DETLA_THREAD_COUNT; i++ ){
+		next[ i ] = 0;
+	}
+	
+	const int count = record->messages.GetCount();
+	for( i=0; i<count; i++ ){
+		int thread, message;
+		ASSERT_EQUAL( sscanf( record->messages.GetAt( i ).GetString(),
+			"II [Test] thread %d message %d", &thread, &message ), 2 );
+		ASSERT_TRUE( thread >= 0 && thread < DETLA_THREAD_COUNT );
+		ASSERT_EQUAL( message, next[ thread ] );
+		next[ thread ]++;
+	}
+}
+
+void detLoggerAsync::pTestFileBatched(){
+	SetSubTestNum( 4 );
+	decMemoryFile * const memoryFile = new decMemoryFile( "log" );
+	decMemoryFileWriter *writer = NULL;
+	deLoggerReference refLoggerFile;
+	
+	try{
+		writer = new decMemoryFileWriter( memoryFile, false );
+		refLoggerFile.TakeOver( new deLoggerFile( writer ) );
+		writer->FreeReference();
+		writer = NULL;
+		
+		deLoggerFile &loggerFile = ( deLoggerFile& )( deLogger& )refLoggerFile;
+		ASSERT_TRUE( loggerFile.GetFlushEachMessage() );
+		
+		// created through the generic logger type as launchers do
+		deLogger * const targetLogger = refLoggerFile;
+		deLoggerReference refLogger;
+		refLogger.TakeOver( new deLoggerAsync( targetLogger ) );
+		deLoggerAsync &logger = ( deLoggerAsync& )( deLogger& )refLogger;
+		ASSERT_FALSE( loggerFile.GetFlushEachMessage() );
+		
+		logger.LogInfo( "Test", "info" );
+		logger.LogWarn( "Test", "warning" );
+		logger.Flush();
+		logger.LogError( "Test", "error" );
+		
+		const decString expected( "II [Test] info\nWW [Test] warning\nEE [Test] error\n" );
+		ASSERT_EQUAL( memoryFile->GetLength(), expected.GetLength() );
+		ASSERT_TRUE( strncmp( memoryFile->GetPointer(), expected.GetString(), expected.GetLength() ) == 0 );
+		
+		refLogger = NULL;
+		ASSERT_TRUE( loggerFile.GetFlushEachMessage() );
+		
+	}catch( const deException & ){
+		if( writer ){
+			writer->FreeReference();
+		}
+		memoryFile->FreeReference();
+		throw;
+	}
+	
+	memoryFile->FreeReference();
+}
+
+void detLoggerAsync::pTestPerformance(){
+	SetSubTestNum( 5 );
+	decMemoryFile * const memoryFile = new decMemoryFile( "log" );
+	decMemoryFileWriter *writer = NULL;
+	deLoggerReference loggerFile;
+	deLoggerReference loggerAsync;
+	
+	try{
+		writer = new decMemoryFileWriter( memoryFile, false );
+		loggerFile.TakeOver( new deLoggerFile( writer ) );
+		writer->FreeReference();
+		writer = NULL;
+		
+		pBenchmark( "sync", loggerFile );
+		
+		loggerAsync.TakeOver( new deLoggerAsync( loggerFile ) );
+		pBenchmark( "async", loggerAsync );
+		
+	}catch( const deException & ){
+		if( writer ){
+			writer->FreeReference();
+		}
+		memoryFile->FreeReference();
+		throw;
+	}
+	
+	memoryFile->FreeReference();
+}
+
+void detLoggerAsync::pBenchmark( const char *name, deLogger &logger ){
+	const int count = DETLA_THREAD_COUNT * DETLA_THREAD_MESSAGES;
+	float * const latencies = new float[ count ];
+	cThreadLog threads[ DETLA_THREAD_COUNT ];
+	decTimer timer;
+	int i;
+	
+	for( i=0; i<DETLA_THREAD_COUNT; i++ ){
+		threads[ i ].logger = &logger;
+		threads[ i ].number = i;
+		threads[ i ].latencies = latencies + DETLA_THREAD_MESSAGES * i;
+		threads[ i ].Start();
+	}
+	for( i=0; i<DETLA_THREAD_COUNT; i++ ){
+		threads[ i ].WaitForExit();
+	}
+	const float elapsedLogging = timer.GetElapsedTime();
+	
+	deLoggerAsync * const loggerAsync = dynamic_cast<deLoggerAsync*>( &logger );
+	if( loggerAsync ){
+		loggerAsync->Flush();
+	}
+	const float elapsedFlush = timer.GetElapsedTime();
+	
+	qsort( latencies, count, sizeof( float ), fCompareFloat );
+	
+	printf( "LoggerAsync %s: %d messages, %.0f messages/s, flush %iys,"
+		" latency p50 %.1fys p99 %.1fys max %.1fys\n", name, count,
+		( float )count / ( elapsedLogging > 1e-6f ? elapsedLogging : 1e-6f ),
+		( int )( elapsedFlush * 1e6f ), latencies[ count / 2 ] * 1e6f,
+		latencies[ count * 99 / 100 ] * 1e6f, latencies[ count - 1 ] * 1e6f );
+	
+	delete [] latencies;
+}
@@ -0,0 +1,33 @@
+// include only once
+#ifndef _DETLOGGERASYNC_H_
+#define _DETLOGGERASYNC_H_
+
+// includes
+#include "../detCase.h"
+
+class deLogger;
+
+
+
+// class detLoggerAsync
+class detLoggerAsync : public detCase{
+public:
+	detLoggerAsync();
+	~detLoggerAsync();
+	void Prepare();
+	void Run();
+	void CleanUp();
+	const char *GetTestName();
+	
+private:
+	void pTestOrder();
+	void pTestErrorDrains();
+	void pTestFormat();
+	void pTestThreads();
+	void pTestFileBatched();
+	void pTestPerformance();
+	void pBenchmark( const char *name, deLogger &logger );
+};
+
+// end of include only once
+#endif
@@ -1,9 +1,11 @@
 // includes
 #include <stdio.h>
+#include <math.h>
 #include <stdlib.h>
 #include "detMath.h"
 #include "dragengine/common/math/decMath.h"
 #include "dragengine/common/exceptions.h"
+#include "dragengine/common/utils/decTimer.h"
 
 	
 
@@ -11,11 +13,11 @@
 /////////////////////////////
 
 // constructors, destructor
-detMath::detMath(){ }
+detMath::detMath() : pRandomSeed( 1 ){ }
 detMath::~detMath(){ }
 
 // testing
-void detMath::Prepare(){ }
+void detMath::Prepare(){ pRandomSeed = 1; }
 void detMath::Run(){
 	decVector pos, rot, scale, view, up;
 	decMatrix m1, m2, m3, m4;
@@ -107,12 +109,105 @@ void detMath::Run(){
 	ASSERT_TRUE( ( mat1 * tps ).IsEqualTo( mat2 * tps ) );
 	
 	TestQuaternion();
+	TestSIMD();
+	TestPerformance();
 }
 void detMath::CleanUp(){ }
 const char *detMath::GetTestName(){ return "Math"; }
 
 
 
+// scalar reference implementations to verify the SIMD implementations against
+static decMatrix detMathRefMultiply( const decMatrix &a, const decMatrix &m ){
+	decMatrix n;
+	n.a11 = a.a11 * m.a11 + a.a21 * m.a12 + a.a31 * m.a13 + a.a41 * m.a14;
+	n.a12 = a.a12 * m.a11 + a.a22 * m.a12 + a.a32 * m.a13 + a.a42 * m.a14;
+	n.a13 = a.a13 * m.a11 + a.a23 * m.a12 + a.a33 * m.a13 + a.a43 * m.a14;
+	n.a14 = a.a14 * m.a11 + a.a24 * m.a12 + a.a34 * m.a13 + a.a44 * m.a14;
+	n.a21 = a.a11 * m.a21 + a.a21 * m.a22 + a.a31 * m.a23 + a.a41 * m.a24;
+	n.a22 = a.a12 * m.a21 + a.a22 * m.a22 + a.a32 * m.a23 + a.a42 * m.a24;
+	n.a23 = a.a13 * m.a21 + a.a23 * m.a22 + a.a33 * m.a23 + a.a43 * m.a24;
+	n.a24 = a.a14 * m.a21 + a.a24 * m.a22 + a.a34 * m.a23 + a.a44 * m.a24;
+	n.a31 = a.a11 * m.a31 + a.a21 * m.a32 + a.a31 * m.a33 + a.a41 * m.a34;
+	n.a32 = a.a12 * m.a31 + a.a22 * m.a32 + a.a32 * m.a33 + a.a42 * m.a34;
+	n.a33 = a.a13 * m.a31 + a.a23 * m.a32 + a.a33 * m.a33 + a.a43 * m.a34;
+	n.a34 = a.a14 * m.a31 + a.a24 * m.a32 + a.a34 * m.a33 + a.a44 * m.a34;
+	n.a41 = a.a11 * m.a41 + a.a21 * m.a42 + a.a31 * m.a43 + a.a41 * m.a44;
+	n.a42 = a.a12 * m.a41 + a.a22 * m.a42 + a.a32 * m.a43 + a.a42 * m.a44;
+	n.a43 = a.a13 * m.a41 + a.a23 * m.a42 + a.a33 * m.a43 + a.a43 * m.a44;
+	n.a44 = a.a14 * m.a41 + a.a24 * m.a42 + a.a34 * m.a43 + a.a44 * m.a44;
+	return n;
+}
+
+static decMatrix detMathRefQuickMultiply( const decMatrix &a, const decMatrix &m ){
+	decMatrix n;
+	n.a11 = a.a11 * m.a11 + a.a21 * m.a12 + a.a31 * m.a13;
+	n.a12 = a.a12 * m.a11 + a.a22 * m.a12 + a.a32 * m.a13;
+	n.a13 = a.a13 * m.a11 + a.a23 * m.a12 + a.a33 * m.a13;
+	n.a14 = a.a14 * m.a11 + a.a24 * m.a12 + a.a34 * m.a13 + m.a14;
+	n.a21 = a.a11 * m.a21 + a.a21 * m.a22 + a.a31 * m.a23;
+	n.a22 = a.a12 * m.a21 + a.a22 * m.a22 + a.a32 * m.a23;
+	n.a23 = a.a13 * m.a21 + a.a23 * m.a22 + a.a33 * m.a23;
+	n.a24 = a.a14 * m.a21 + a.a24 * m.a22 + a.a34 * m.a23 + m.a24;
+	n.a31 = a.a11 * m.a31 + a.a21 * m.a32 + a.a31 * m.a33;
+	n.a32 = a.a12 * m.a31 + a.a22 * m.a32 + a.a32 * m.a33;
+	n.a33 = a.a13 * m.a31 + a.a23 * m.a32 + a.a33 * m.a33;
+	n.a34 = a.a14 * m.a31 + a.a24 * m.a32 + a.a34 * m.a33 + m.a34;
+	return n;
+}
+
+static decQuaternion detMathRefQuatMultiply( const decQuaternion &a, const decQuaternion &q ){
+	return decQuaternion(
+		q.x * a.w + q.y * a.z - q.z * a.y + q.w * a.x,
+		-q.x * a.z + q.y * a.w + q.z * a.x + q.w * a.y,
+		q.x * a.y - q.y * a.x + q.z * a.w + q.w * a.z,
+		-q.x * a.x - q.y * a.y - q.z * a.z + q.w * a.w );
+}
+
+static decMatrix detMathRefFromQuaternion( const decQuaternion &q ){
+	const decQuaternion qn( q.Normalized() );
+	const float sqnx = qn.x * qn.x;
+	const float sqny = qn.y * qn.y;
+	const float sqnz = qn.z * qn.z;
+	const float sqnw = qn.w * qn.w;
+	decMatrix m;
+	m.a11 =  sqnx - sqny - sqnz + sqnw;
+	m.a22 = -sqnx + sqny - sqnz + sqnw;
+	m.a33 = -sqnx - sqny + sqnz + sqnw;
+	m.a21 = 2.0f * ( qn.x * qn.y + qn.z * qn.w );
+	m.a12 = 2.0f * ( qn.x * qn.y - qn.z * qn.w );
+	m.a31 = 2.0f * ( qn.x * qn.z - qn.y * qn.w );
+	m.a13 = 2.0f * ( qn.x * qn.z + qn.y * qn.w );
+	m.a32 = 2.0f * ( qn.y * qn.z + qn.x * qn.w );
+	m.a23 = 2.0f * ( qn.y * qn.z - qn.x * qn.w );
+	return m;
+}
+
+static decVector detMathRefTransform( const decMatrix &m, const decVector &v ){
+	return decVector(
+		m.a11 * v.x + m.a12 * v.y + m.a13 * v.z + m.a14,
+		m.a21 * v.x + m.a22 * v.y + m.a23 * v.z + m.a24,
+		m.a31 * v.x + m.a32 * v.y + m.a33 * v.z + m.a34 );
+}
+
+float detMath::pRandom( float range ){
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return ( ( float )( ( pRandomSeed >> 8 ) & 0xffff ) / 65535.0f * 2.0f - 1.0f ) * range;
+}
+
+decMatrix detMath::pRandomMatrix(){
+	const decVector scale( 1.0f + pRandom( 0.5f ), 1.0f + pRandom( 0.5f ), 1.0f + pRandom( 0.5f ) );
+	const decVector rotation( pRandom( PI ), pRandom( PI ), pRandom( PI ) );
+	const decVector position( pRandom( 10.0f ), pRandom( 10.0f ), pRandom( 10.0f ) );
+	return decMatrix::CreateSRT( scale, rotation, position );
+}
+
+decQuaternion detMath::pRandomQuaternion(){
+	return decQuaternion( pRandom( 1.0f ), pRandom( 1.0f ), pRandom( 1.0f ), pRandom( 1.0f ) + 1.5f ).Normalized();
+}
+
+
+
 void detMath::TestQuaternion(){
 	SetSubTestNum( 5 );
 	
@@ -428,3 +523,233 @@ void detMath::TestQuaternion(){
 	dmrot3 = dmrot1 * decDMatrix::CreateRotationAxis( dmrot1.TransformView(), DEG2RAD * 30.0 );
 	ASSERT_TRUE( dmrot3.IsEqualTo( dmrot2 ) );
 }
+
+void detMath::TestSIMD(){
+	SetSubTestNum( 6 );
+	
+	const int vectorCount = 37;
+	decVector vectors[ vectorCount ];
+	decVector transformed[ vectorCount ];
+	int i, j;
+	
+	for( i=0; i<1000; i++ ){
+		const decMatrix m1( pRandomMatrix() );
+		decMatrix m2( pRandomMatrix() );
+		m2.a41 = pRandom( 1.0f ); // ensure full multiply uses the last row
+		m2.a44 = 1.0f + pRandom( 0.5f );
+		
+		// matrix multiply
+		ASSERT_TRUE( ( m1 * m2 ).IsEqualTo( detMathRefMultiply( m1, m2 ), 1e-5f ) );
+		
+		decMatrix m3( m1 );
+		m3 *= m2;
+		ASSERT_TRUE( m3.IsEqualTo( detMathRefMultiply( m1, m2 ), 1e-5f ) );
+		
+		m3 = m1;
+		m3 *= m3;
+		ASSERT_TRUE( m3.IsEqualTo( detMathRefMultiply( m1, m1 ), 1e-5f ) );
+		
+		ASSERT_TRUE( m1.QuickMultiply( m2 ).IsEqualTo( detMathRefQuickMultiply( m1, m2 ), 1e-5f ) );
+		
+		// quaternion
+		const decQuaternion q1( pRandomQuaternion() );
+		const decQuaternion q2( pRandomQuaternion() );
+		ASSERT_TRUE( ( q1 * q2 ).IsEqualTo( detMathRefQuatMultiply( q1, q2 ), 1e-6f ) );
+		
+		decQuaternion q3( q1 );
+		q3 *= q2;
+		ASSERT_TRUE( q3.IsEqualTo( detMathRefQuatMultiply( q1, q2 ), 1e-6f ) );
+		
+		ASSERT_TRUE( decMatrix::CreateFromQuaternion( q1 ).IsEqualTo( detMathRefFromQuaternion( q1 ), 1e-6f ) );
+		ASSERT_TRUE( decMatrix::CreateFromQuaternion( q1 ).ToQuaternion().SameRotation( q1, 1e-4f ) );
+		
+		const float factor = pRandom( 0.5f ) + 0.5f;
+		const decQuaternion slerp( q1.Slerp( q2, factor ) );
+		ASSERT_TRUE( fabsf( slerp.Length() - 1.0f ) < 1e-4f );
+		ASSERT_TRUE( q1.Slerp( q2, 0.0f ).IsEqualTo( q1, 1e-5f ) );
+		ASSERT_TRUE( q1.Slerp( q2, 1.0f ).SameRotation( q2, 1e-4f ) );
+		
+		// vector arrays
+		for( j=0; j<vectorCount; j++ ){
+			vectors[ j ].Set( pRandom( 5.0f ), pRandom( 5.0f ), pRandom( 5.0f ) );
+		}
+		
+		m1.Transform( vectors, transformed, vectorCount );
+		for( j=0; j<vectorCount; j++ ){
+			ASSERT_TRUE( transformed[ j ].IsEqualTo( detMathRefTransform( m1, vectors[ j ] ), 1e-5f ) );
+			ASSERT_TRUE( transformed[ j ].IsEqualTo( m1 * vectors[ j ], 1e-5f ) );
+		}
+		
+		// in place
+		m1.Transform( vectors, vectors, vectorCount );
+		for( j=0; j<vectorCount; j++ ){
+			ASSERT_TRUE( vectors[ j ].IsEqualTo( transformed[ j ] ) );
+		}
+	}
+	
+	// parameters
+	decMatrix().Transform( NULL, NULL, 0 );
+	ASSERT_DOES_FAIL( decMatrix().Transform( vectors, transformed, -1 ) );
+	ASSERT_DOES_FAIL( decMatrix().Transform( NULL, transformed, 1 ) );
+	ASSERT_DOES_FAIL( decMatrix().Transform( vectors, NULL, 1 ) );
+}
+
+void detMath::TestPerformance(){
+	SetSubTestNum( 7 );
+	
+	const int count = 4096;
+	const int iterations = 200;
+	decMatrix * const matrices = new decMatrix[ count ];
+	decMatrix * const results = new decMatrix[ count ];
+	decQuaternion * const quaternions = new decQuaternion[ count ];
+	decQuaternion * const resultQuaternions = new decQuaternion[ count ];
+	decVector * const vectors = new decVector[ count ];
+	decVector * const resultVectors = new decVector[ count ];
+	float checksum = 0.0f;
+	float elapsedReference, elapsedEngine;
+	decTimer timer;
+	int i, j;
+	
+	try{
+		for( i=0; i<count; i++ ){
+			matrices[ i ] = pRandomMatrix();
+			quaternions[ i ] = pRandomQuaternion();
+			vectors[ i ].Set( pRandom( 5.0f ), pRandom( 5.0f ), pRandom( 5.0f ) );
+		}
+		
+		// matrix * matrix
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				results[ j ] = detMathRefMultiply( matrices[ j - 1 ], matrices[ j ] );
+			}
+			checksum += results[ i + 1 ].a11;
+		}
+		elapsedReference = timer.GetElapsedTime();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				results[ j ] = matrices[ j - 1 ] * matrices[ j ];
+			}
+			checksum += results[ i + 1 ].a11;
+		}
+		elapsedEngine = timer.GetElapsedTime();
+		printf( "Math matrix*matrix: scalar %iys, engine %iys (%.1fx)\n",
+			( int )( elapsedReference / ( float )iterations * 1e6f ),
+			( int )( elapsedEngine / ( float )iterations * 1e6f ),
+			elapsedReference / decMath::max( elapsedEngine, 1e-6f ) );
+		
+		// matrix quick multiply
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				results[ j ] = detMathRefQuickMultiply( matrices[ j - 1 ], matrices[ j ] );
+			}
+			checksum += results[ i + 1 ].a11;
+		}
+		elapsedReference = timer.GetElapsedTime();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				results[ j ] = matrices[ j - 1 ].QuickMultiply( matrices[ j ] );
+			}
+			checksum += results[ i + 1 ].a11;
+		}
+		elapsedEngine = timer.GetElapsedTime();
+		printf( "Math matrix.QuickMultiply: scalar %iys, engine %iys (%.1fx)\n",
+			( int )( elapsedReference / ( float )iterations * 1e6f ),
+			( int )( elapsedEngine / ( float )iterations * 1e6f ),
+			elapsedReference / decMath::max( elapsedEngine, 1e-6f ) );
+		
+		// matrix * vector array
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			const decMatrix &matrix = matrices[ i ];
+			for( j=0; j<count; j++ ){
+				resultVectors[ j ] = detMathRefTransform( matrix, vectors[ j ] );
+			}
+			checksum += resultVectors[ i ].x;
+		}
+		elapsedReference = timer.GetElapsedTime();
+		for( i=0; i<iterations; i++ ){
+			matrices[ i ].Transform( vectors, resultVectors, count );
+			checksum += resultVectors[ i ].x;
+		}
+		elapsedEngine = timer.GetElapsedTime();
+		printf( "Math matrix.Transform(array): scalar %iys, engine %iys (%.1fx)\n",
+			( int )( elapsedReference / ( float )iterations * 1e6f ),
+			( int )( elapsedEngine / ( float )iterations * 1e6f ),
+			elapsedReference / decMath::max( elapsedEngine, 1e-6f ) );
+		
+		// quaternion * quaternion
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				resultQuaternions[ j ] = detMathRefQuatMultiply( quaternions[ j - 1 ], quaternions[ j ] );
+			}
+			checksum += resultQuaternions[ i + 1 ].x;
+		}
+		elapsedReference = timer.GetElapsedTime();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				resultQuaternions[ j ] = quaternions[ j - 1 ] * quaternions[ j ];
+			}
+			checksum += resultQuaternions[ i + 1 ].x;
+		}
+		elapsedEngine = timer.GetElapsedTime();
+		printf( "Math quaternion*quaternion: scalar %iys, engine %iys (%.1fx)\n",
+			( int )( elapsedReference / ( float )iterations * 1e6f ),
+			( int )( elapsedEngine / ( float )iterations * 1e6f ),
+			elapsedReference / decMath::max( elapsedEngine, 1e-6f ) );
+		
+		// quaternion to matrix
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			for( j=0; j<count; j++ ){
+				results[ j ] = detMathRefFromQuaternion( quaternions[ j ] );
+			}
+			checksum += results[ i ].a11;
+		}
+		elapsedReference = timer.GetElapsedTime();
+		for( i=0; i<iterations; i++ ){
+			for( j=0; j<count; j++ ){
+				results[ j ].SetFromQuaternion( quaternions[ j ] );
+			}
+			checksum += results[ i ].a11;
+		}
+		elapsedEngine = timer.GetElapsedTime();
+		printf( "Math matrix.SetFromQuaternion: scalar %iys, engine %iys (%.1fx)\n",
+			( int )( elapsedReference / ( float )iterations * 1e6f ),
+			( int )( elapsedEngine / ( float )iterations * 1e6f ),
+			elapsedReference / decMath::max( elapsedEngine, 1e-6f ) );
+		
+		// quaternion slerp. no scalar reference since the trigonometry dominates
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			for( j=1; j<count; j++ ){
+				resultQuaternions[ j ] = quaternions[ j - 1 ].Slerp( quaternions[ j ], 0.3f );
+			}
+			checksum += resultQuaternions[ i + 1 ].x;
+		}
+		elapsedEngine = timer.GetElapsedTime();
+		printf( "Math quaternion.Slerp: engine %iys\n",
+			( int )( elapsedEngine / ( float )iterations * 1e6f ) );
+		
+		// prevents the compiler from optimizing the loops away
+		ASSERT_TRUE( checksum == checksum );
+		
+	}catch( const deException & ){
+		delete [] resultVectors;
+		delete [] vectors;
+		delete [] resultQuaternions;
+		delete [] quaternions;
+		delete [] results;
+		delete [] matrices;
+		throw;
+	}
+	
+	delete [] resultVectors;
+	delete [] vectors;
+	delete [] resultQuaternions;
+	delete [] quaternions;
+	delete [] results;
+	delete [] matrices;
+}
@@ -5,8 +5,13 @@
 // includes
 #include "../detCase.h"
 
+#include <dragengine/common/math/decMath.h>
+
 // class detMath
 class detMath : public detCase{
+private:
+	unsigned int pRandomSeed;
+	
 public:
 	detMath();
 	~detMath();
@@ -16,6 +21,13 @@ public:
 	const char *GetTestName();
 	
 	void TestQuaternion();
+	void TestSIMD();
+	void TestPerformance();
+	
+private:
+	float pRandom( float range );
+	decMatrix pRandomMatrix();
+	decQuaternion pRandomQuaternion();
 };
 
 // end of include only once
@@ -0,0 +1,280 @@
+// includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "detSkinning.h"
+
+#include <dragengine/common/math/decSkinning.h>
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/common/exceptions.h>
+
+
+
+// Class detSkinning
+//////////////////////
+
+// Constructors, destructor
+/////////////////////////////
+
+detSkinning::detSkinning() :
+pRandomSeed( 1 ){
+}
+
+detSkinning::~detSkinning(){
+}
+
+
+
+// Testing
+////////////
+
+void detSkinning::Prepare(){
+	pRandomSeed = 1;
+}
+
+void detSkinning::Run(){
+	pTestEmpty();
+	pTestUnprepared();
+	pTestTransform();
+	pTestPackedMatrices();
+	pTestRanges();
+	pTestPerformance();
+}
+
+void detSkinning::CleanUp(){
+}
+
+const char *detSkinning::GetTestName(){
+	return "Skinning";
+}
+
+
+
+// Private Functions
+//////////////////////
+
+float detSkinning::pRandom( float range ){
+	pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+	return ( ( float )( ( pRandomSeed >> 8 ) & 0xffff ) / 65535.0f * 2.0f - 1.0f ) * range;
+}
+
+void detSkinning::pInitMesh( decSkinning &skinning, decVector *positions, int *weightSets,
+int vertexCount, int weightSetCount ){
+	int i;
+	
+	skinning.SetVertexCount( vertexCount );
+	for( i=0; i<vertexCount; i++ ){
+		positions[ i ].Set( pRandom( 2.0f ), pRandom( 2.0f ), pRandom( 2.0f ) );
+		pRandomSeed = pRandomSeed * 1103515245u + 12345u;
+		weightSets[ i ] = ( int )( ( pRandomSeed >> 8 ) % ( unsigned int )( weightSetCount + 1 ) ) - 1;
+		skinning.SetVertexAt( i, positions[ i ], weightSets[ i ] );
+	}
+	skinning.Prepare();
+}
+
+void detSkinning::pInitWeights( decMatrix *weights, int count ){
+	int i;
+	
+	for( i=0; i<count; i++ ){
+		weights[ i ] = decMatrix::CreateRT( decVector( pRandom( PI ), pRandom( PI ), pRandom( PI ) ),
+			decVector( pRandom( 5.0f ), pRandom( 5.0f ), pRandom( 5.0f ) ) );
+	}
+}
+
+void detSkinning::pTestEmpty(){
+	SetSubTestNum( 0 );
+	decSkinning skinning;
+	
+	ASSERT_EQUAL( skinning.GetVertexCount(), 0 );
+	ASSERT_FALSE( skinning.GetPrepared() );
+	
+	skinning.Prepare();
+	ASSERT_TRUE( skinning.GetPrepared() );
+	ASSERT_EQUAL( skinning.GetRunCount(), 0 );
+	ASSERT_EQUAL( skinning.GetWeightSetCount(), 0 );
+	
+	skinning.Transform( NULL, 16, NULL, 3 );
+}
+
+void detSkinning::pTestUnprepared(){
+	SetSubTestNum( 1 );
+	decSkinning skinning;
+	decMatrix weight;
+	decVector position;
+	
+	skinning.SetVertexCount( 1 );
+	skinning.SetVertexAt( 0, decVector( 1.0f, 2.0f, 3.0f ), 0 );
+	ASSERT_DOES_FAIL( skinning.Transform( &weight.a11, 16, &position.x, 3 ) );
+	ASSERT_DOES_FAIL( skinning.SetVertexAt( 1, decVector(), 0 ) );
+	ASSERT_DOES_FAIL( skinning.SetVertexAt( 0, decVector(), -2 ) );
+	
+	skinning.Prepare();
+	ASSERT_DOES_FAIL( skinning.SetVertexAt( 0, decVector(), 0 ) );
+	ASSERT_DOES_FAIL( skinning.Transform( &weight.a11, 8, &position.x, 3 ) );
+	ASSERT_DOES_FAIL( skinning.Transform( &weight.a11, 16, &position.x, 3, 0, 2 ) );
+}
+
+void detSkinning::pTestTransform(){
+	SetSubTestNum( 2 );
+	const int vertexCount = 1001;
+	const int weightSetCount = 13;
+	decVector positions[ vertexCount ];
+	decVector result[ vertexCount ];
+	int weightSets[ vertexCount ];
+	decMatrix weights[ weightSetCount ];
+	decSkinning skinning;
+	int i;
+	
+	pInitMesh( skinning, positions, weightSets, vertexCount, weightSetCount );
+	pInitWeights( weights, weightSetCount );
+	
+	ASSERT_TRUE( skinning.GetPrepared() );
+	ASSERT_EQUAL( skinning.GetVertexCount(), vertexCount );
+	ASSERT_EQUAL( skinning.GetWeightSetCount(), weightSetCount );
+	ASSERT_EQUAL( skinning.GetRunCount(), weightSetCount + 1 );
+	
+	for( i=1; i<skinning.GetRunCount(); i++ ){
+		const decSkinning::sRun &run = skinning.GetRunAt( i );
+		const decSkinning::sRun &prevRun = skinning.GetRunAt( i - 1 );
+		ASSERT_TRUE( run.weightSet > prevRun.weightSet );
+		ASSERT_EQUAL( run.first, prevRun.first + prevRun.count );
+	}
+	
+	skinning.Transform( &weights[ 0 ].a11, sizeof( decMatrix ) / sizeof( float ),
+		&result[ 0 ].x, sizeof( decVector ) / sizeof( float ) );
+	
+	for( i=0; i<vertexCount; i++ ){
+		if( weightSets[ i ] == -1 ){
+			ASSERT_TRUE( result[ i ].IsEqualTo( positions[ i ] ) );
+			
+		}else{
+			ASSERT_TRUE( result[ i ].IsEqualTo( weights[ weightSets[ i ] ] * positions[ i ], 1e-4f ) );
+		}
+	}
+}
+
+void detSkinning::pTestPackedMatrices(){
+	SetSubTestNum( 3 );
+	const int vertexCount = 257;
+	const int weightSetCount = 5;
+	decVector positions[ vertexCount ];
+	float result[ vertexCount * 4 ];
+	int weightSets[ vertexCount ];
+	decMatrix weights[ weightSetCount ];
+	float packed[ weightSetCount * 12 ];
+	decSkinning skinning;
+	int i;
+	
+	pInitMesh( skinning, positions, weightSets, vertexCount, weightSetCount );
+	pInitWeights( weights, weightSetCount );
+	
+	for( i=0; i<weightSetCount; i++ ){
+		memcpy( packed + i * 12, &weights[ i ].a11, sizeof( float ) * 12 );
+	}
+	
+	// output with padding to verify strides
+	for( i=0; i<vertexCount * 4; i++ ){
+		result[ i ] = 99.0f;
+	}
+	
+	skinning.Transform( packed, 12, result, 4 );
+	
+	for( i=0; i<vertexCount; i++ ){
+		const decVector position( result[ i * 4 ], result[ i * 4 + 1 ], result[ i * 4 + 2 ] );
+		
+		if( weightSets[ i ] == -1 ){
+			ASSERT_TRUE( position.IsEqualTo( positions[ i ] ) );
+			
+		}else{
+			ASSERT_TRUE( position.IsEqualTo( weights[ weightSets[ i ] ] * positions[ i ], 1e-4f ) );
+		}
+		ASSERT_FEQUAL( result[ i * 4 + 3 ], 99.0f );
+	}
+}
+
+void detSkinning::pTestRanges(){
+	SetSubTestNum( 4 );
+	const int vertexCount = 1000;
+	const int weightSetCount = 7;
+	const int chunkSizes[ 4 ] = { 1, 7, 64, 333 };
+	decVector positions[ vertexCount ];
+	decVector expected[ vertexCount ];
+	decVector result[ vertexCount ];
+	int weightSets[ vertexCount ];
+	decMatrix weights[ weightSetCount ];
+	decSkinning skinning;
+	int i, j, first;
+	
+	pInitMesh( skinning, positions, weightSets, vertexCount, weightSetCount );
+	pInitWeights( weights, weightSetCount );
+	
+	skinning.Transform( &weights[ 0 ].a11, 16, &expected[ 0 ].x, 3 );
+	
+	for( i=0; i<4; i++ ){
+		for( j=0; j<vertexCount; j++ ){
+			result[ j ].SetZero();
+		}
+		
+		for( first=0; first<vertexCount; first+=chunkSizes[ i ] ){
+			skinning.Transform( &weights[ 0 ].a11, 16, &result[ 0 ].x, 3,
+				first, decMath::min( chunkSizes[ i ], vertexCount - first ) );
+		}
+		
+		for( j=0; j<vertexCount; j++ ){
+			ASSERT_TRUE( result[ j ].IsEqualTo( expected[ j ] ) );
+		}
+	}
+}
+
+void detSkinning::pTestPerformance(){
+	SetSubTestNum( 5 );
+	const int vertexCount = 20000;
+	const int weightSetCount = 60;
+	const int iterations = 100;
+	decVector * const positions = new decVector[ vertexCount ];
+	decVector * const result = new decVector[ vertexCount ];
+	int * const weightSets = new int[ vertexCount ];
+	decMatrix weights[ weightSetCount ];
+	decSkinning skinning;
+	decTimer timer;
+	int i, j;
+	
+	try{
+		pInitMesh( skinning, positions, weightSets, vertexCount, weightSetCount );
+		pInitWeights( weights, weightSetCount );
+		
+		timer.Reset();
+		for( i=0; i<iterations; i++ ){
+			for( j=0; j<vertexCount; j++ ){
+				if( weightSets[ j ] == -1 ){
+					result[ j ] = positions[ j ];
+					
+				}else{
+					result[ j ] = weights[ weightSets[ j ] ] * positions[ j ];
+				}
+			}
+		}
+		const float elapsedNaive = timer.GetElapsedTime();
+		
+		for( i=0; i<iterations; i++ ){
+			skinning.Transform( &weights[ 0 ].a11, 16, &result[ 0 ].x, 3 );
+		}
+		const float elapsedKernel = timer.GetElapsedTime();
+		
+		printf( "Skinning %d vertices: per-vertex %iys, kernel %iys (%.1fx)\n", vertexCount,
+			( int )( elapsedNaive / ( float )iterations * 1e6f ),
+			( int )( elapsedKernel / ( float )iterations * 1e6f ),
+			elapsedNaive / decMath::max( elapsedKernel, 1e-6f ) );
+		
+	}catch( const deException & ){
+		delete [] weightSets;
+		delete [] result;
+		delete [] positions;
+		throw;
+	}
+	
+	delete [] weightSets;
+	delete [] result;
+	delete [] positions;
+}
@@ -0,0 +1,41 @@
+// include only once
+#ifndef _DETSKINNING_H_
+#define _DETSKINNING_H_
+
+// includes
+#include "../detCase.h"
+
+#include <dragengine/common/math/decMath.h>
+
+class decSkinning;
+
+
+
+// class detSkinning
+class detSkinning : public detCase{
+private:
+	unsigned int pRandomSeed;
+	
+public:
+	detSkinning();
+	~detSkinning();
+	void Prepare();
+	void Run();
+	void CleanUp();
+	const char *GetTestName();
+	
+private:
+	float pRandom( float range );
+	void pInitMesh( decSkinning &skinning, decVector *positions, int *weightSets,
+		int vertexCount, int weightSetCount );
+	void pInitWeights( decMatrix *weights, int count );
+	void pTestEmpty();
+	void pTestUnprepared();
+	void pTestTransform();
+	void pTestPackedMatrices();
+	void pTestRanges();
+	void pTestPerformance();
+};
+
+// end of include only once
+#endif
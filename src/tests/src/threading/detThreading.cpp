@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "detThreading.h"
+#include "dragengine/threading/deLockFreeQueue.h"
 #include "dragengine/threading/deMutex.h"
 #include "dragengine/threading/deSemaphore.h"
 #include "dragengine/threading/deThread.h"
@@ -39,6 +40,31 @@ public:
 
 
 
+struct sQueueTestEntry : public deLockFreeQueue::sEntry{
+	int thread;
+	int index;
+};
+
+class cThreadQueuePush : public deThread{
+private:
+	deLockFreeQueue &pQueue;
+	sQueueTestEntry *pEntries;
+	
+public:
+	cThreadQueuePush( deLockFreeQueue &queue, sQueueTestEntry *entries ) :
+	pQueue( queue ), pEntries( entries ){
+	}
+	virtual ~cThreadQueuePush(){ }
+	virtual void Run(){
+		int i;
+		for( i=0; i<DETT_QUEUE_ENTRY_COUNT; i++ ){
+			pQueue.Push( pEntries + i );
+		}
+	}
+};
+
+
+
 // Class detThreading
 ///////////////////////
 
@@ -71,6 +97,7 @@ void detThreading::Prepare(){
 
 void detThreading::Run(){
 	TestThread();
+	TestLockFreeQueue();
 }
 
 void detThreading::CleanUp(){
@@ -177,6 +204,99 @@ void detThreading::TestThread(){
 	mutex1 = NULL;
 }
 
+void detThreading::TestLockFreeQueue(){
+	SetSubTestNum( 1 );
+	
+	deLockFreeQueue queue;
+	sQueueTestEntry entry1, entry2, entry3;
+	
+	// single thread. entries are taken in push order
+	ASSERT_TRUE( queue.TakeAll() == NULL );
+	ASSERT_TRUE( queue.Push( &entry1 ) );
+	ASSERT_FALSE( queue.Push( &entry2 ) );
+	ASSERT_TRUE( queue.GetHead() == &entry2 );
+	
+	deLockFreeQueue::sEntry *taken = queue.TakeAll();
+	ASSERT_TRUE( taken == &entry1 );
+	ASSERT_TRUE( taken->next == &entry2 );
+	ASSERT_TRUE( entry2.next == NULL );
+	ASSERT_TRUE( queue.GetHead() == NULL );
+	
+	entry1.next = &entry2;
+	entry2.next = &entry3;
+	ASSERT_TRUE( queue.PushList( &entry1, &entry3 ) );
+	taken = queue.TakeAll();
+	ASSERT_TRUE( taken == &entry3 );
+	ASSERT_TRUE( entry3.next == &entry2 );
+	ASSERT_TRUE( entry2.next == &entry1 );
+	ASSERT_TRUE( entry1.next == NULL );
+	
+	// multiple threads pushing while taking. all entries arrive exactly once and the
+	// entries of each thread arrive in the order they have been pushed
+	sQueueTestEntry * const entries = new sQueueTestEntry[ DETT_THREAD_COUNT * DETT_QUEUE_ENTRY_COUNT ];
+	int nextIndex[ DETT_THREAD_COUNT ];
+	int takenCount = 0;
+	int i, j;
+	
+	try{
+		for( i=0; i<DETT_THREAD_COUNT; i++ ){
+			for( j=0; j<DETT_QUEUE_ENTRY_COUNT; j++ ){
+				sQueueTestEntry &entry = entries[ i * DETT_QUEUE_ENTRY_COUNT + j ];
+				entry.next = NULL;
+				entry.thread = i;
+				entry.index = j;
+			}
+			nextIndex[ i ] = 0;
+		}
+		
+		for( i=0; i<DETT_THREAD_COUNT; i++ ){
+			threads[ i ] = new cThreadQueuePush( queue, entries + i * DETT_QUEUE_ENTRY_COUNT );
+		}
+		for( i=0; i<DETT_THREAD_COUNT; i++ ){
+			threads[ i ]->Start();
+		}
+		
+		decTimer timer;
+		float elapsed = 0.0f;
+		
+		while( takenCount < DETT_THREAD_COUNT * DETT_QUEUE_ENTRY_COUNT && elapsed < 10.0f ){
+			taken = queue.TakeAll();
+			
+			while( taken ){
+				const sQueueTestEntry &entry = *( ( sQueueTestEntry* )taken );
+				ASSERT_TRUE( entry.index == nextIndex[ entry.thread ] );
+				nextIndex[ entry.thread ]++;
+				takenCount++;
+				taken = taken->next;
+			}
+			
+			elapsed += timer.GetElapsedTime();
+		}
+		
+		ASSERT_TRUE( takenCount == DETT_THREAD_COUNT * DETT_QUEUE_ENTRY_COUNT );
+		ASSERT_TRUE( queue.TakeAll() == NULL );
+		
+		for( i=0; i<DETT_THREAD_COUNT; i++ ){
+			threads[ i ]->WaitForExit();
+			delete threads[ i ];
+			threads[ i ] = NULL;
+		}
+		
+	}catch( const deException & ){
+		for( i=0; i<DETT_THREAD_COUNT; i++ ){
+			if( threads[ i ] ){
+				threads[ i ]->Stop();
+				delete threads[ i ];
+				threads[ i ] = NULL;
+			}
+		}
+		delete [] entries;
+		throw;
+	}
+	
+	delete [] entries;
+}
+
 void detThreading::Sleep( float seconds ){
 	decTimer timer;
 	
@@ -14,6 +14,7 @@ class deThread;
 
 // definitions
 #define DETT_THREAD_COUNT	5
+#define DETT_QUEUE_ENTRY_COUNT	10000
 
 // class detThreading
 class detThreading : public detCase{
@@ -34,6 +35,7 @@ public:
 	
 private:
 	void TestThread();
+	void TestLockFreeQueue();
 	void Sleep( float seconds );
 };
 
@@ -0,0 +1,187 @@
+// includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "detWorldUpdate.h"
+
+#include <dragengine/deEngine.h>
+#include <dragengine/app/deOSConsole.h>
+#include <dragengine/common/exceptions.h>
+#include <dragengine/common/utils/decTimer.h>
+#include <dragengine/parallel/deParallelProcessing.h>
+#include <dragengine/resources/world/deWorld.h>
+#include <dragengine/resources/world/deWorldManager.h>
+#include <dragengine/resources/world/deWorldReference.h>
+#include <dragengine/systems/modules/ai/deBaseAIWorld.h>
+#include <dragengine/systems/modules/graphic/deBaseGraphicWorld.h>
+#include <dragengine/threading/deMutex.h>
+#include <dragengine/threading/deMutexGuard.h>
+
+
+
+// Helpers
+////////////
+
+// records the order peers are updated in
+class cUpdateRecord{
+public:
+	deMutex mutex;
+	bool aiUpdated;
+	bool aiUpdatedDuringGraphic;
+	
+	cUpdateRecord() : aiUpdated( false ), aiUpdatedDuringGraphic( false ){ }
+	
+	bool GetAIUpdated(){
+		deMutexGuard lock( mutex );
+		return aiUpdated;
+	}
+};
+
+// AI peer opting in to parallel updates
+class cPeerAI : public deBaseAIWorld{
+public:
+	cUpdateRecord &record;
+	bool fail;
+	
+	cPeerAI( cUpdateRecord &arecord ) : record( arecord ), fail( false ){ }
+	
+	virtual void Update( float ){
+		if( fail ){
+			DETHROW( deeInvalidAction );
+		}
+		deMutexGuard lock( record.mutex );
+		record.aiUpdated = true;
+	}
+	
+	virtual bool SupportsParallelUpdate() const{
+		return true;
+	}
+};
+
+// graphic peer not opting in. waits a short time for the AI peer to be updated which
+// only happens if the AI peer is updated in parallel
+class cPeerGraphic : public deBaseGraphicWorld{
+public:
+	cUpdateRecord &record;
+	
+	cPeerGraphic( cUpdateRecord &arecord ) : record( arecord ){ }
+	
+	virtual void Update( float ){
+		decTimer timer;
+		float elapsed = 0.0f;
+		
+		while( elapsed < 0.5f ){
+			if( record.GetAIUpdated() ){
+				deMutexGuard lock( record.mutex );
+				record.aiUpdatedDuringGraphic = true;
+				return;
+			}
+			elapsed += timer.GetElapsedTime();
+		}
+	}
+};
+
+
+
+// Class detWorldUpdate
+/////////////////////////
+
+// Constructors, destructor
+/////////////////////////////
+
+detWorldUpdate::detWorldUpdate() :
+pEngine( NULL ){
+}
+
+detWorldUpdate::~detWorldUpdate(){
+	CleanUp();
+}
+
+
+
+// Testing
+////////////
+
+void detWorldUpdate::Prepare(){
+	pEngine = new deEngine( new deOSConsole );
+}
+
+void detWorldUpdate::Run(){
+	pTestSequential();
+	pTestParallel();
+	pTestParallelFailure();
+}
+
+void detWorldUpdate::CleanUp(){
+	if( pEngine ){
+		delete pEngine;
+		pEngine = NULL;
+	}
+}
+
+const char *detWorldUpdate::GetTestName(){
+	return "WorldUpdate";
+}
+
+
+
+// Private Functions
+//////////////////////
+
+void detWorldUpdate::pTestSequential(){
+	SetSubTestNum( 0 );
+	cUpdateRecord record;
+	deWorldReference world;
+	world.TakeOver( pEngine->GetWorldManager()->CreateWorld() );
+	world->SetPeerAI( new cPeerAI( record ) );
+	world->SetPeerGraphic( new cPeerGraphic( record ) );
+	
+	// parallel world update is disabled by default. the AI peer is updated after the
+	// graphic peer finished
+	ASSERT_FALSE( pEngine->GetParallelWorldUpdate() );
+	world->Update( 0.1f );
+	ASSERT_TRUE( record.aiUpdated );
+	ASSERT_FALSE( record.aiUpdatedDuringGraphic );
+	ASSERT_TRUE( world->GetPeerUpdateTime( deWorld::eptGraphic ) > 0.25f );
+}
+
+void detWorldUpdate::pTestParallel(){
+	SetSubTestNum( 1 );
+	cUpdateRecord record;
+	deWorldReference world;
+	world.TakeOver( pEngine->GetWorldManager()->CreateWorld() );
+	world->SetPeerAI( new cPeerAI( record ) );
+	world->SetPeerGraphic( new cPeerGraphic( record ) );
+	
+	pEngine->SetParallelWorldUpdate( true );
+	world->Update( 0.1f );
+	pEngine->SetParallelWorldUpdate( false );
+	
+	// on single core systems peers are always updated sequentially
+	ASSERT_TRUE( record.aiUpdated );
+	if( pEngine->GetParallelProcessing().GetCoreCount() > 1 ){
+		ASSERT_TRUE( record.aiUpdatedDuringGraphic );
+		ASSERT_TRUE( world->GetPeerUpdateTime( deWorld::eptGraphic ) < 0.25f );
+		
+	}else{
+		ASSERT_FALSE( record.aiUpdatedDuringGraphic );
+	}
+}
+
+void detWorldUpdate::pTestParallelFailure(){
+	SetSubTestNum( 2 );
+	cUpdateRecord record;
+	deWorldReference world;
+	world.TakeOver( pEngine->GetWorldManager()->CreateWorld() );
+	
+	cPeerAI * const peerAI = new cPeerAI( record );
+	peerAI->fail = true;
+	world->SetPeerAI( peerAI );
+	
+	// failure is thrown on the calling thread after all peers finished updating
+	pEngine->SetParallelWorldUpdate( true );
+	ASSERT_DOES_FAIL( world->Update( 0.1f ) );
+	pEngine->SetParallelWorldUpdate( false );
+	ASSERT_FALSE( record.aiUpdated );
+}
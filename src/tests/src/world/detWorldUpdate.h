@@ -0,0 +1,32 @@
+// include only once
+#ifndef _DETWORLDUPDATE_H_
+#define _DETWORLDUPDATE_H_
+
+// includes
+#include "../detCase.h"
+
+class deEngine;
+
+
+
+// class detWorldUpdate
+class detWorldUpdate : public detCase{
+private:
+	deEngine *pEngine;
+	
+public:
+	detWorldUpdate();
+	~detWorldUpdate();
+	void Prepare();
+	void Run();
+	void CleanUp();
+	const char *GetTestName();
+	
+private:
+	void pTestSequential();
+	void pTestParallel();
+	void pTestParallelFailure();
+};
+
+// end of include only once
+#endif